@@ -63,7 +63,8 @@ namespace ctran::algos::allreduce {
 AllReduceResourceImpl::AllReduceResourceImpl(
     ncclx::CommStateX* statex,
     CtranMapper* mapper,
-    CommLogData* logMetadata)
+    CommLogData* logMetadata,
+    ::ctran::algos::BufArena* arena)
     : statex_(statex), mapper_(mapper), logMetaData_(logMetadata) {
   // memory pool requires unique key for each memory region allocation
   auto memKey =
@@ -72,7 +73,7 @@ AllReduceResourceImpl::AllReduceResourceImpl(
   bufMngr_ = std::make_unique<::ctran::algos::BufManager<
       AllReduceResourceBufName,
       AllReduceResourceBufName::kNumBufsNames>>(
-      statex, mapper, logMetadata, memKey);
+      statex, mapper, logMetadata, memKey, arena);
 }
 
 commResult_t AllReduceResourceImpl::destroy() {
@@ -133,7 +134,7 @@ commResult_t AllReduceResourceImpl::initAllReduceDirectResourceAsync(
       buflen));
 
   // allocate memory
-  FB_COMMCHECK(bufMngr_->commit());
+  FB_COMMCHECK(bufMngr_->commit(peers));
   CLOGF_SUBSYS(
       INFO,
       INIT,
@@ -36,10 +36,12 @@ struct AllReduceResourceRef {
 
 class AllReduceResourceImpl {
  public:
+  // Temporary buffers are carved from arena if given, see BufManager
   AllReduceResourceImpl(
       ncclx::CommStateX* statex,
       CtranMapper* mapper,
-      CommLogData* logMetadata);
+      CommLogData* logMetadata,
+      ::ctran::algos::BufArena* arena = nullptr);
   ~AllReduceResourceImpl();
 
   commResult_t initAllReduceDirectResourceAsync(
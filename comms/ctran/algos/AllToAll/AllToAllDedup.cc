@@ -3,6 +3,7 @@
 #include <cuda_fp16.h>
 
 #include "comms/ctran/algos/AllToAll/AllToAllDedupImpl.h"
+#include "comms/ctran/algos/AllToAll/AllToAllDedupPlan.h"
 #include "comms/ctran/algos/CtranAlgo.h"
 #include "comms/ctran/gpe/CtranGpe.h"
 #include "comms/ctran/utils/Alloc.h"
@@ -75,23 +76,18 @@ inline commResult_t fwdCtrlExchange(CtranPersistentRequest* request) {
 
 inline commResult_t setupKernelConfig(
     const void* const sendbuff,
-    const size_t sendcounts[],
-    const size_t sdispls[],
     void* recvbuff,
-    const size_t recvcounts[],
-    const size_t rdispls[],
-    commDataType_t datatype,
+    const ctran::alltoalldedup::RouteCache& routeCache,
+    const ctran::alltoalldedup::RoutePlan& plan,
     CtranComm* comm,
     CtranPersistentRequest* const request,
     KernelConfig& config) {
   // TODO: just pass in recvbuffs as kernel arg and write to pinned memory
   // instead of using kernel elem post
-  std::vector<int> fwdPeers;
   const auto statex = comm->statex_.get();
   const auto numIbPeers = statex->nNodes();
   const auto nLocalRanks = statex->nLocalRanks();
   const auto localRank = statex->localRank();
-  const auto node = statex->node();
 
   config.numThreads = NCCL_CTRAN_ALLTOALL_DEDUP_THREAD_BLOCK_SIZE;
   int numBlocks =
@@ -100,11 +96,6 @@ inline commResult_t setupKernelConfig(
 
   config.args.devState_d = comm->ctran_->algo->getDevState();
 
-  for (int i = 1; i < nLocalRanks; i++) {
-    int peer = statex->localRankToRank((localRank + i) % nLocalRanks, node);
-    fwdPeers.push_back(peer);
-  }
-
   auto& remoteRecvBuffs = request->op->alltoall_dedup.remoteRecvBuffs;
   KernelElem* bcastElemList = nullptr;
   // alloc kernel elems for each exec since opElem destructor frees kernel elems
@@ -116,23 +107,22 @@ inline commResult_t setupKernelConfig(
   // each kernel elem is in charge of one broadcast, set information for the
   // kernel via kernel elem
   KernelElem* curElem = bcastElemList;
-  int curNode = statex->node();
+  int curNode = routeCache.myNode();
   for (int i = 0; i < numIbPeers; i++) {
+    const auto& route = plan.nodes[i];
     // after network puts of splits, kernel broadcasts the split associated with
     // its local rank to its local peers
     if (i == curNode) {
-      size_t disp = sdispls[i] * commTypeSize(datatype);
-      curElem->bcast.count = sendcounts[i];
-      curElem->bcast.src = (void*)((char*)sendbuff + disp);
+      curElem->bcast.count = route.sendCount;
+      curElem->bcast.src = (void*)((char*)sendbuff + route.sendOffset);
     } else {
-      size_t disp = rdispls[i] * commTypeSize(datatype);
-      curElem->bcast.count = recvcounts[i];
-      curElem->bcast.src = (void*)((char*)recvbuff + disp);
+      curElem->bcast.count = route.recvCount;
+      curElem->bcast.src = (void*)((char*)recvbuff + route.recvOffset);
     }
 
-    size_t displ = rdispls[i] * commTypeSize(datatype);
+    size_t displ = route.recvOffset;
     curElem->bcast.dsts[localRank] = (char*)recvbuff + displ;
-    for (auto fwdPeer : fwdPeers) {
+    for (auto fwdPeer : routeCache.fwdPeers()) {
       int p = fwdPeer % nLocalRanks;
       curElem->bcast.dsts[p] = (char*)remoteRecvBuffs[fwdPeer] + displ;
     }
@@ -173,6 +163,27 @@ inline commResult_t setupGpeOp(
     op->alltoall_dedup.rdispls = rdispls;
     op->alltoall_dedup.sendHdl = sendMemHdl;
     op->alltoall_dedup.recvHdl = regHdl;
+
+    const int myRank = statex->rank();
+    const int localRank = statex->localRank();
+    const int nLocalRanks = statex->nLocalRanks();
+    const int node = statex->node();
+    std::vector<int> peerRanks;
+    for (int n = 0; n < statex->nNodes(); n++) {
+      peerRanks.push_back(statex->localRankToRank(localRank, n));
+    }
+    std::vector<int> fwdPeers;
+    for (int i = 1; i < nLocalRanks; i++) {
+      fwdPeers.push_back(
+          statex->localRankToRank((localRank + i) % nLocalRanks, node));
+    }
+    op->alltoall_dedup.routeCache =
+        std::make_shared<ctran::alltoalldedup::RouteCache>(
+            myRank,
+            node,
+            std::move(peerRanks),
+            std::move(fwdPeers),
+            commTypeSize(datatype));
   }
   return commSuccess;
 }
@@ -311,20 +322,16 @@ commResult_t ctranAllToAllDedupExec(CtranPersistentRequest* request) {
       stream,
       kAllToAllDedupAlgoName,
       opCount);
+  // Resolve routing on the submitting thread so the GPE thread can start the
+  // ctrl exchange right away; unchanged counts reuse the previous plan.
+  auto& routeCache = *request->op->alltoall_dedup.routeCache;
+  auto plan = routeCache.update(sendcounts, sdispls, recvcounts, rdispls);
   FB_COMMCHECK(setupKernelConfig(
-      sendbuff,
-      sendcounts,
-      sdispls,
-      recvbuff,
-      recvcounts,
-      rdispls,
-      datatype,
-      comm,
-      request,
-      config));
+      sendbuff, recvbuff, routeCache, *plan, comm, request, config));
 
   std::vector<std::unique_ptr<struct OpElem>> opGroup;
   std::unique_ptr<struct OpElem> op(new OpElem(request->op.get()));
+  op->alltoall_dedup.routePlan = std::move(plan);
   opGroup.push_back(std::move(op));
 
   FB_COMMCHECK(comm->ctran_->gpe->submit(
@@ -4,6 +4,7 @@
 
 #include "comms/ctran/CtranComm.h"
 #include "comms/ctran/algos/AllToAll/AllToAllDedupImpl.h"
+#include "comms/ctran/algos/AllToAll/AllToAllDedupPlan.h"
 #include "comms/ctran/algos/CtranAlgo.h"
 
 namespace {
@@ -42,32 +43,33 @@ inline commResult_t ctrlExchange(
     CtranComm*& comm,
     std::vector<std::unique_ptr<CtranMapperRequest>>& ibSendCtrlReqs,
     std::vector<std::unique_ptr<CtranMapperRequest>>& ibRecvCtrlReqs,
-    std::vector<int>& ibSendPeers,
-    std::vector<int>& ibRecvPeers,
+    const ctran::alltoalldedup::RoutePlan& plan,
     std::vector<std::unique_ptr<CtranMapperNotify>>& ibNotifyVec,
-    std::vector<void*>& recvMemHdl,
-    std::vector<void*>& recvBuffs,
+    void* recvbuff,
+    void* recvMemHdl,
     std::vector<void*>& remoteRecvBuffs,
     std::vector<struct CtranMapperRemoteAccessKey>& remoteAccessKeys) {
-  ibSendCtrlReqs.reserve(ibRecvPeers.size());
-  ibRecvCtrlReqs.reserve(ibSendPeers.size());
-  ibNotifyVec.reserve(ibSendPeers.size());
+  ibSendCtrlReqs.reserve(plan.ibRecvPeers.size());
+  ibRecvCtrlReqs.reserve(plan.ibSendPeers.size());
+  ibNotifyVec.reserve(plan.ibSendPeers.size());
 
-  for (auto peer : ibRecvPeers) {
+  for (auto peer : plan.ibRecvPeers) {
     int peerNode = comm->statex_->node(peer);
+    void* peerRecvBuff =
+        static_cast<char*>(recvbuff) + plan.nodes[peerNode].recvOffset;
     CtranMapperRequest* req = nullptr;
     FB_COMMCHECK(comm->ctran_->mapper->isendCtrl(
-        recvBuffs[peerNode], recvMemHdl[peer], peer, &req));
+        peerRecvBuff, recvMemHdl, peer, &req));
     ibSendCtrlReqs.push_back(std::unique_ptr<CtranMapperRequest>(req));
 
     // Initialize notify flag to receive from peer
     auto notify = std::make_unique<CtranMapperNotify>();
     FB_COMMCHECK(
-        comm->ctran_->mapper->initNotify(peer, recvMemHdl[peer], notify.get()));
+        comm->ctran_->mapper->initNotify(peer, recvMemHdl, notify.get()));
     ibNotifyVec.push_back(std::move(notify));
   }
 
-  for (auto peer : ibSendPeers) {
+  for (auto peer : plan.ibSendPeers) {
     CtranMapperRequest* req = nullptr;
     FB_COMMCHECK(comm->ctran_->mapper->irecvCtrl(
         &remoteRecvBuffs[peer], &remoteAccessKeys[peer], peer, &req));
@@ -82,15 +84,7 @@ commResult_t ctranAllToAllDedupExecImpl(
   struct OpElem* op = opGroup.front().get();
   CtranComm* comm = opGroup.front()->comm_;
   const auto statex = comm->statex_.get();
-  const int myRank = statex->rank();
-  const int nRanks = statex->nRanks();
-  const int nNodes = statex->nNodes();
-  const int localRank = statex->localRank();
   const int nLocalRanks = statex->nLocalRanks();
-  auto sendCounts = op->alltoall_dedup.sendcounts;
-  auto recvCounts = op->alltoall_dedup.recvcounts;
-  auto sDispls = op->alltoall_dedup.sdispls;
-  auto rDispls = op->alltoall_dedup.rdispls;
   auto sendbuff = op->alltoall_dedup.sendbuff;
   auto recvbuff = op->alltoall_dedup.recvbuff;
   auto datatype = op->alltoall_dedup.datatype;
@@ -99,11 +93,8 @@ commResult_t ctranAllToAllDedupExecImpl(
   auto& remoteRecvBuffs = op->alltoall_dedup.remoteRecvBuffs;
   auto& remoteAccessKeys = op->alltoall_dedup.remoteAccessKeys;
 
-  std::vector<void*> recvMemHdls(nRanks);
-  std::vector<const void*> sendBuffs(nNodes);
-  std::vector<void*> recvBuffs(nNodes);
-  std::vector<int> ibRecvPeers, ibSendPeers;
-  std::unordered_set<int> ibPeers;
+  // Peer lists and per-node offsets were resolved when the exec was submitted
+  const auto& plan = *op->alltoall_dedup.routePlan;
   std::vector<std::unique_ptr<CtranMapperRequest>> ibPutReqs, ibSyncRecvReqs,
       ibSyncSendReqs;
   std::vector<std::unique_ptr<CtranMapperRequest>> ibSendCtrlReqs,
@@ -117,40 +108,14 @@ commResult_t ctranAllToAllDedupExecImpl(
 
   FB_COMMCHECK(intraNodeSync(comm));
 
-  // Prepare buffers shifted with displacement.
-  for (int peerNode = 0; peerNode < nNodes; peerNode++) {
-    int peerRank = statex->localRankToRank(localRank, peerNode);
-    if (sendCounts[peerNode]) {
-      sendBuffs[peerNode] = static_cast<const char*>(sendbuff) +
-          sDispls[peerNode] * commTypeSize(datatype);
-      if (myRank != peerRank) {
-        ibSendPeers.push_back(peerRank);
-        ibPeers.insert(peerRank);
-      }
-    }
-    if (recvCounts[peerNode]) {
-      recvBuffs[peerNode] = static_cast<char*>(recvbuff) +
-          rDispls[peerNode] * commTypeSize(datatype);
-      if (myRank != peerRank) {
-        ibRecvPeers.push_back(peerRank);
-        ibPeers.insert(peerRank);
-      }
-    }
-  }
-
-  for (int i = 0; i < nRanks; i++) {
-    recvMemHdls[i] = recvMemHdl;
-  }
-
   FB_COMMCHECK(ctrlExchange(
       comm,
       ibSendCtrlReqs,
       ibRecvCtrlReqs,
-      ibSendPeers,
-      ibRecvPeers,
+      plan,
       notifyVec,
-      recvMemHdls,
-      recvBuffs,
+      recvbuff,
+      recvMemHdl,
       remoteRecvBuffs,
       remoteAccessKeys));
 
@@ -162,18 +127,19 @@ commResult_t ctranAllToAllDedupExecImpl(
   // issue network puts:
   // - Sender puts data for peers
   // - Exit until all peers' put have been issued (putPeers becomes empty)
-  ibPutReqs.reserve(ibSendPeers.size());
-  for (auto peer : ibSendPeers) {
+  ibPutReqs.reserve(plan.ibSendPeers.size());
+  for (auto peer : plan.ibSendPeers) {
     int peerNode = peer / nLocalRanks;
+    const auto& route = plan.nodes[peerNode];
 
     if (useProfiler) {
       timestamp->recvCtrl.emplace_back(CtranMapperTimestampPoint(peer));
     }
     CtranMapperRequest* req = nullptr;
     FB_COMMCHECK(comm->ctran_->mapper->iput(
-        sendBuffs[peerNode],
+        static_cast<const char*>(sendbuff) + route.sendOffset,
         remoteRecvBuffs[peer],
-        sendCounts[peerNode] * commTypeSize(datatype),
+        route.sendCount * commTypeSize(datatype),
         peer,
         CtranMapperConfig{
             .memHdl_ = sendMemHdl,
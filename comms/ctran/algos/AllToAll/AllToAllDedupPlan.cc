@@ -0,0 +1,93 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "comms/ctran/algos/AllToAll/AllToAllDedupPlan.h"
+
+namespace ctran::alltoalldedup {
+
+RouteCache::RouteCache(
+    int myRank,
+    int myNode,
+    std::vector<int> peerRanks,
+    std::vector<int> fwdPeers,
+    size_t typeSize)
+    : myRank_(myRank),
+      myNode_(myNode),
+      peerRanks_(std::move(peerRanks)),
+      fwdPeers_(std::move(fwdPeers)),
+      typeSize_(typeSize) {
+  changed_.reserve(peerRanks_.size());
+}
+
+void RouteCache::rebuildPeers(RoutePlan& plan) const {
+  plan.ibSendPeers.clear();
+  plan.ibRecvPeers.clear();
+  for (int n = 0; n < nNodes(); n++) {
+    const int peer = peerRanks_[n];
+    if (peer == myRank_) {
+      continue;
+    }
+    if (plan.nodes[n].sendCount) {
+      plan.ibSendPeers.push_back(peer);
+    }
+    if (plan.nodes[n].recvCount) {
+      plan.ibRecvPeers.push_back(peer);
+    }
+  }
+}
+
+std::shared_ptr<const RoutePlan> RouteCache::update(
+    const size_t* sendcounts,
+    const size_t* sdispls,
+    const size_t* recvcounts,
+    const size_t* rdispls) {
+  const int nNodes = this->nNodes();
+
+  bool firstPlan = plan_ == nullptr;
+  changed_.clear();
+  if (firstPlan) {
+    inputs_.resize(nNodes);
+    for (int n = 0; n < nNodes; n++) {
+      changed_.push_back(n);
+    }
+  } else {
+    for (int n = 0; n < nNodes; n++) {
+      Inputs in{sendcounts[n], sdispls[n], recvcounts[n], rdispls[n]};
+      if (in != inputs_[n]) {
+        changed_.push_back(n);
+      }
+    }
+    if (changed_.empty()) {
+      hits_++;
+      return plan_;
+    }
+  }
+
+  if (firstPlan) {
+    plan_ = std::make_shared<RoutePlan>();
+    plan_->nodes.resize(nNodes);
+  } else if (plan_.use_count() > 1) {
+    // Still referenced by an in-flight op; leave that snapshot untouched.
+    plan_ = std::make_shared<RoutePlan>(*plan_);
+  }
+
+  bool peersChanged = firstPlan;
+  for (int n : changed_) {
+    Inputs in{sendcounts[n], sdispls[n], recvcounts[n], rdispls[n]};
+    NodeRoute& route = plan_->nodes[n];
+    peersChanged |= (route.sendCount == 0) != (in.sendcount == 0) ||
+        (route.recvCount == 0) != (in.recvcount == 0);
+    route.sendCount = in.sendcount;
+    route.sendOffset = in.sdispl * typeSize_;
+    route.recvCount = in.recvcount;
+    route.recvOffset = in.rdispl * typeSize_;
+    inputs_[n] = in;
+  }
+  nodesRecomputed_ += changed_.size();
+  if (peersChanged) {
+    rebuildPeers(*plan_);
+  }
+  plan_->version++;
+  return plan_;
+}
+
+} // namespace ctran::alltoalldedup
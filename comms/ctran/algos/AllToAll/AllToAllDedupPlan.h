@@ -0,0 +1,106 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ctran::alltoalldedup {
+
+// Per-node routing of one AllToAllDedup exec. Offsets are in bytes relative to
+// the persistent sendbuff/recvbuff.
+struct NodeRoute {
+  size_t sendCount{0};
+  size_t sendOffset{0};
+  size_t recvCount{0};
+  size_t recvOffset{0};
+};
+
+// Routing metadata derived from the per-node counts and displacements: what
+// the exec path builds before any data moves.
+struct RoutePlan {
+  std::vector<NodeRoute> nodes;
+  // Remote peers (same local rank on other nodes) to put to / get puts from,
+  // in node order.
+  std::vector<int> ibSendPeers;
+  std::vector<int> ibRecvPeers;
+  // Bumped every time the plan content changes.
+  uint64_t version{0};
+};
+
+// Caches the RoutePlan of a persistent AllToAllDedup request.
+//
+// MoE token dispatch typically calls exec with identical counts for many
+// consecutive steps. update() compares the routing arrays against the values
+// the current plan was built from and reuses the plan as is when nothing
+// changed, otherwise recomputes only the nodes whose entries changed. The
+// peer lists are only rebuilt when a node switches between empty and non-empty.
+//
+// Plans are handed out as immutable snapshots: a plan still referenced by an
+// in-flight GPE op is copied before being updated, so the exec path never
+// waits for the GPE thread.
+class RouteCache {
+ public:
+  // peerRanks[n]: rank with the same local rank on node n.
+  RouteCache(
+      int myRank,
+      int myNode,
+      std::vector<int> peerRanks,
+      std::vector<int> fwdPeers,
+      size_t typeSize);
+
+  std::shared_ptr<const RoutePlan> update(
+      const size_t* sendcounts,
+      const size_t* sdispls,
+      const size_t* recvcounts,
+      const size_t* rdispls);
+
+  // Local peers the kernel forwards received data to.
+  const std::vector<int>& fwdPeers() const {
+    return fwdPeers_;
+  }
+  int myNode() const {
+    return myNode_;
+  }
+  int nNodes() const {
+    return static_cast<int>(peerRanks_.size());
+  }
+
+  uint64_t hits() const {
+    return hits_;
+  }
+  uint64_t nodesRecomputed() const {
+    return nodesRecomputed_;
+  }
+
+ private:
+  struct Inputs {
+    size_t sendcount;
+    size_t sdispl;
+    size_t recvcount;
+    size_t rdispl;
+
+    bool operator!=(const Inputs& other) const {
+      return sendcount != other.sendcount || sdispl != other.sdispl ||
+          recvcount != other.recvcount || rdispl != other.rdispl;
+    }
+  };
+
+  void rebuildPeers(RoutePlan& plan) const;
+
+  const int myRank_;
+  const int myNode_;
+  const std::vector<int> peerRanks_;
+  const std::vector<int> fwdPeers_;
+  const size_t typeSize_;
+
+  std::vector<Inputs> inputs_;
+  std::vector<int> changed_;
+  std::shared_ptr<RoutePlan> plan_;
+  uint64_t hits_{0};
+  uint64_t nodesRecomputed_{0};
+};
+
+} // namespace ctran::alltoalldedup
@@ -0,0 +1,127 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include "comms/ctran/algos/AllToAll/AllToAllDedupPlan.h"
+
+using namespace ctran::alltoalldedup;
+
+// Host-side routing prep of one AllToAllDedup exec as the number of nodes and
+// tokens grows: rebuilding the per-node buffers and peer lists for every call
+// as the GPE thread used to, versus RouteCache when the routing is unchanged
+// across steps (the common MoE dispatch case) or when a few nodes change.
+// The per-exec bcast KernelElem fill is the same either way and not measured.
+
+namespace {
+
+constexpr int kLocalRanks = 8;
+constexpr size_t kTypeSize = 2;
+
+struct Routing {
+  std::vector<size_t> sendcounts, sdispls, recvcounts, rdispls;
+  std::vector<int> peerRanks;
+  std::vector<int> fwdPeers;
+
+  Routing(int nNodes, int tokensPerNode)
+      : sendcounts(nNodes),
+        sdispls(nNodes),
+        recvcounts(nNodes),
+        rdispls(nNodes) {
+    size_t off = 0;
+    for (int n = 0; n < nNodes; n++) {
+      sendcounts[n] = recvcounts[n] = tokensPerNode;
+      sdispls[n] = rdispls[n] = off;
+      off += tokensPerNode;
+      peerRanks.push_back(n * kLocalRanks);
+    }
+    for (int i = 1; i < kLocalRanks; i++) {
+      fwdPeers.push_back(i);
+    }
+  }
+};
+
+// Per-exec computation before the cache
+struct Uncached {
+  std::vector<const void*> sendBuffs;
+  std::vector<void*> recvBuffs;
+  std::vector<int> ibSendPeers, ibRecvPeers;
+};
+
+void prepUncached(const Routing& r, char* sendbuff, char* recvbuff) {
+  const int nNodes = r.sendcounts.size();
+  Uncached out;
+  out.sendBuffs.resize(nNodes);
+  out.recvBuffs.resize(nNodes);
+  for (int n = 0; n < nNodes; n++) {
+    if (r.sendcounts[n]) {
+      out.sendBuffs[n] = sendbuff + r.sdispls[n] * kTypeSize;
+      if (n != 0) {
+        out.ibSendPeers.push_back(r.peerRanks[n]);
+      }
+    }
+    if (r.recvcounts[n]) {
+      out.recvBuffs[n] = recvbuff + r.rdispls[n] * kTypeSize;
+      if (n != 0) {
+        out.ibRecvPeers.push_back(r.peerRanks[n]);
+      }
+    }
+  }
+  benchmark::DoNotOptimize(out);
+}
+
+void prepCached(RouteCache& cache, const Routing& r) {
+  auto plan = cache.update(
+      r.sendcounts.data(),
+      r.sdispls.data(),
+      r.recvcounts.data(),
+      r.rdispls.data());
+  benchmark::DoNotOptimize(plan);
+}
+
+} // namespace
+
+static void BM_PrepUncached(benchmark::State& state) {
+  Routing r(state.range(0), state.range(1));
+  std::vector<char> buf(1);
+  for (auto _ : state) {
+    prepUncached(r, buf.data(), buf.data());
+  }
+}
+
+static void BM_PrepCachedSteady(benchmark::State& state) {
+  Routing r(state.range(0), state.range(1));
+  RouteCache cache(0, 0, r.peerRanks, r.fwdPeers, kTypeSize);
+  for (auto _ : state) {
+    prepCached(cache, r);
+  }
+  state.counters["hits"] = cache.hits();
+}
+
+// Two nodes exchange a token every step.
+static void BM_PrepCachedChurn(benchmark::State& state) {
+  Routing r(state.range(0), state.range(1));
+  RouteCache cache(0, 0, r.peerRanks, r.fwdPeers, kTypeSize);
+  int step = 0;
+  for (auto _ : state) {
+    const int n = 1 + step++ % (r.sendcounts.size() - 2);
+    r.sendcounts[n]--;
+    r.sendcounts[n + 1]++;
+    r.sdispls[n + 1]--;
+    prepCached(cache, r);
+  }
+  state.counters["nodesRecomputed"] = cache.nodesRecomputed();
+}
+
+BENCHMARK(BM_PrepUncached)
+    ->ArgsProduct({{8, 32, 128, 512}, {128, 4096}});
+BENCHMARK(BM_PrepCachedSteady)
+    ->ArgsProduct({{8, 32, 128, 512}, {128, 4096}});
+BENCHMARK(BM_PrepCachedChurn)
+    ->ArgsProduct({{8, 32, 128, 512}, {128, 4096}});
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
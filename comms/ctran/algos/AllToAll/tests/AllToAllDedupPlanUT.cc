@@ -0,0 +1,233 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "comms/ctran/algos/AllToAll/AllToAllDedupPlan.h"
+
+namespace ctran::alltoalldedup {
+
+namespace {
+
+// Synthetic MoE dispatch routing table: per-node token counts with packed
+// displacements, as seen by one rank.
+struct RoutingTable {
+  std::vector<size_t> sendcounts;
+  std::vector<size_t> sdispls;
+  std::vector<size_t> recvcounts;
+  std::vector<size_t> rdispls;
+
+  explicit RoutingTable(int nNodes)
+      : sendcounts(nNodes),
+        sdispls(nNodes),
+        recvcounts(nNodes),
+        rdispls(nNodes) {}
+
+  void pack() {
+    size_t sOff = 0, rOff = 0;
+    for (size_t n = 0; n < sendcounts.size(); n++) {
+      sdispls[n] = sOff;
+      rdispls[n] = rOff;
+      sOff += sendcounts[n];
+      rOff += recvcounts[n];
+    }
+  }
+};
+
+// Rank 1 (local rank 1) of nNodes x 4 ranks.
+constexpr int kLocalRanks = 4;
+constexpr int kLocalRank = 1;
+constexpr size_t kTypeSize = 2;
+
+std::unique_ptr<RouteCache> makeCache(int nNodes, int myNode = 0) {
+  std::vector<int> peerRanks;
+  for (int n = 0; n < nNodes; n++) {
+    peerRanks.push_back(n * kLocalRanks + kLocalRank);
+  }
+  std::vector<int> fwdPeers;
+  for (int i = 1; i < kLocalRanks; i++) {
+    fwdPeers.push_back(
+        myNode * kLocalRanks + (kLocalRank + i) % kLocalRanks);
+  }
+  return std::make_unique<RouteCache>(
+      myNode * kLocalRanks + kLocalRank,
+      myNode,
+      std::move(peerRanks),
+      std::move(fwdPeers),
+      kTypeSize);
+}
+
+// What the exec path used to compute on the GPE thread for every call.
+void expectMatchesReference(
+    const RoutePlan& plan,
+    const RoutingTable& table,
+    int myNode) {
+  const int nNodes = table.sendcounts.size();
+  ASSERT_EQ(plan.nodes.size(), nNodes);
+  std::vector<int> ibSendPeers, ibRecvPeers;
+  for (int n = 0; n < nNodes; n++) {
+    EXPECT_EQ(plan.nodes[n].sendCount, table.sendcounts[n]);
+    EXPECT_EQ(plan.nodes[n].sendOffset, table.sdispls[n] * kTypeSize);
+    EXPECT_EQ(plan.nodes[n].recvCount, table.recvcounts[n]);
+    EXPECT_EQ(plan.nodes[n].recvOffset, table.rdispls[n] * kTypeSize);
+    if (n == myNode) {
+      continue;
+    }
+    if (table.sendcounts[n]) {
+      ibSendPeers.push_back(n * kLocalRanks + kLocalRank);
+    }
+    if (table.recvcounts[n]) {
+      ibRecvPeers.push_back(n * kLocalRanks + kLocalRank);
+    }
+  }
+  EXPECT_EQ(plan.ibSendPeers, ibSendPeers);
+  EXPECT_EQ(plan.ibRecvPeers, ibRecvPeers);
+}
+
+std::shared_ptr<const RoutePlan> update(
+    RouteCache& cache,
+    const RoutingTable& table) {
+  return cache.update(
+      table.sendcounts.data(),
+      table.sdispls.data(),
+      table.recvcounts.data(),
+      table.rdispls.data());
+}
+
+} // namespace
+
+TEST(AllToAllDedupPlanTest, FirstUpdateBuildsPlan) {
+  const int nNodes = 4;
+  auto cache = makeCache(nNodes);
+  RoutingTable table(nNodes);
+  table.sendcounts = {10, 0, 30, 40};
+  table.recvcounts = {5, 6, 0, 8};
+  table.pack();
+
+  auto plan = update(*cache, table);
+  expectMatchesReference(*plan, table, 0);
+  EXPECT_EQ(plan->ibSendPeers, std::vector<int>({9, 13}));
+  EXPECT_EQ(plan->ibRecvPeers, std::vector<int>({5, 13}));
+  EXPECT_EQ(cache->nodesRecomputed(), nNodes);
+  EXPECT_EQ(cache->hits(), 0);
+  EXPECT_EQ(cache->fwdPeers(), std::vector<int>({2, 3, 0}));
+}
+
+TEST(AllToAllDedupPlanTest, UnchangedRoutingReusesPlan) {
+  const int nNodes = 8;
+  auto cache = makeCache(nNodes);
+  RoutingTable table(nNodes);
+  for (int n = 0; n < nNodes; n++) {
+    table.sendcounts[n] = 100 + n;
+    table.recvcounts[n] = 200 + n;
+  }
+  table.pack();
+
+  auto first = update(*cache, table);
+  for (int i = 0; i < 10; i++) {
+    auto plan = update(*cache, table);
+    EXPECT_EQ(plan.get(), first.get());
+  }
+  EXPECT_EQ(cache->hits(), 10);
+  EXPECT_EQ(cache->nodesRecomputed(), nNodes);
+  EXPECT_EQ(first->version, 1);
+}
+
+TEST(AllToAllDedupPlanTest, OnlyChangedNodesRecomputed) {
+  const int nNodes = 16;
+  auto cache = makeCache(nNodes);
+  RoutingTable table(nNodes);
+  for (int n = 0; n < nNodes; n++) {
+    table.sendcounts[n] = 64;
+    table.recvcounts[n] = 64;
+  }
+  table.pack();
+  update(*cache, table);
+
+  // Tokens move from node 3 to node 4; displacements of later nodes are
+  // unchanged since the total is preserved.
+  table.sendcounts[3] -= 8;
+  table.sendcounts[4] += 8;
+  table.pack();
+  auto plan = update(*cache, table);
+  expectMatchesReference(*plan, table, 0);
+  EXPECT_EQ(cache->nodesRecomputed(), nNodes + 2);
+  EXPECT_EQ(plan->version, 2);
+}
+
+TEST(AllToAllDedupPlanTest, PeerListsFollowEmptyNodes) {
+  const int nNodes = 4;
+  auto cache = makeCache(nNodes, 2);
+  RoutingTable table(nNodes);
+  table.sendcounts = {1, 1, 1, 1};
+  table.recvcounts = {1, 1, 1, 1};
+  table.pack();
+  auto plan = update(*cache, table);
+  // Own node is never an IB peer
+  EXPECT_EQ(plan->ibSendPeers, std::vector<int>({1, 5, 13}));
+
+  table.sendcounts[1] = 0;
+  table.recvcounts[3] = 0;
+  table.pack();
+  plan = update(*cache, table);
+  expectMatchesReference(*plan, table, 2);
+  EXPECT_EQ(plan->ibSendPeers, std::vector<int>({1, 13}));
+  EXPECT_EQ(plan->ibRecvPeers, std::vector<int>({1, 5}));
+}
+
+TEST(AllToAllDedupPlanTest, InFlightPlanIsNotModified) {
+  const int nNodes = 4;
+  auto cache = makeCache(nNodes);
+  RoutingTable table(nNodes);
+  table.sendcounts = {10, 20, 30, 40};
+  table.recvcounts = {10, 20, 30, 40};
+  table.pack();
+  RoutingTable before = table;
+
+  // Held by a submitted op that the GPE thread has not run yet
+  auto inFlight = update(*cache, table);
+
+  table.sendcounts[2] = 0;
+  table.pack();
+  auto next = update(*cache, table);
+  EXPECT_NE(next.get(), inFlight.get());
+  expectMatchesReference(*inFlight, before, 0);
+  expectMatchesReference(*next, table, 0);
+
+  // Once nobody else holds the plan it is updated in place
+  const RoutePlan* nextPtr = next.get();
+  next.reset();
+  inFlight.reset();
+  table.sendcounts[2] = 5;
+  table.pack();
+  next = update(*cache, table);
+  EXPECT_EQ(next.get(), nextPtr);
+  expectMatchesReference(*next, table, 0);
+}
+
+TEST(AllToAllDedupPlanTest, RandomRoutingMatchesReference) {
+  const int nNodes = 32;
+  auto cache = makeCache(nNodes, 5);
+  RoutingTable table(nNodes);
+  std::mt19937 gen(2024);
+  std::uniform_int_distribution<int> tokens(0, 3);
+  std::uniform_int_distribution<int> node(0, nNodes - 1);
+
+  for (int step = 0; step < 200; step++) {
+    // Most steps keep the routing, some move a few tokens around
+    if (step % 4 == 0) {
+      for (int i = 0; i < 3; i++) {
+        table.sendcounts[node(gen)] = tokens(gen);
+        table.recvcounts[node(gen)] = tokens(gen);
+      }
+      table.pack();
+    }
+    auto plan = update(*cache, table);
+    expectMatchesReference(*plan, table, 5);
+  }
+  EXPECT_GE(cache->hits(), 150);
+}
+
+} // namespace ctran::alltoalldedup
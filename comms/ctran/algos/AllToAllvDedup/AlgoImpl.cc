@@ -1,6 +1,7 @@
 // Copyright (c) Meta Platforms, Inc. and affiliates.
 
 #include "comms/ctran/algos/AllToAllvDedup/AlgoImpl.h"
+#include "comms/ctran/algos/CtranAlgo.h"
 
 namespace ctran::alltoallvdedup {
 using namespace utils;
@@ -12,7 +13,10 @@ AlgoImpl::AlgoImpl(
     cudaStream_t stream)
     : comm_(comm), statex_(statex), ctran_(ctran), stream_(stream) {
   resource_ = std::make_unique<ResourceImpl>(
-      statex, ctran->mapper.get(), &comm->logMetaData_);
+      statex,
+      ctran->mapper.get(),
+      &comm->logMetaData_,
+      ctran->algo ? ctran->algo->getBufArena() : nullptr);
 }
 
 commResult_t AlgoImpl::initConfig() {
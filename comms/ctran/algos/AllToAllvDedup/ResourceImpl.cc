@@ -313,8 +313,9 @@ commResult_t ResourceImpl::initialize(
   FB_COMMCHECK(
       bufMngr_->insert(MemType::kDevice, ResourceBufName::kWorkerSync, buflen));
 
-  // allocate memory
-  FB_COMMCHECK(bufMngr_->commit());
+  // allocate memory, from arena chunks exchanged with the same peers if any
+  auto peers = prepareExchange(statex_);
+  FB_COMMCHECK(bufMngr_->commit(peers));
   CLOGF_SUBSYS(
       INFO,
       INIT,
@@ -322,7 +323,6 @@ commResult_t ResourceImpl::initialize(
       statex_->rank());
 
   // register and exchange memory handles
-  auto peers = prepareExchange(statex_);
   CLOGF_TRACE(
       INIT,
       "AllToAllvDedup::ResourceImpl: Rank {} exchanged with peers [{}]",
@@ -350,7 +350,8 @@ ResourceImpl::~ResourceImpl() {
 ResourceImpl::ResourceImpl(
     ncclx::CommStateX* statex,
     CtranMapper* mapper,
-    CommLogData* logMetadata)
+    CommLogData* logMetadata,
+    ::ctran::algos::BufArena* arena)
     : statex_(statex), mapper_(mapper), logMetaData_(logMetadata) {
   // memory pool requires unique key for each memory region allocation
   auto memKey = folly::sformat(
@@ -358,6 +359,7 @@ ResourceImpl::ResourceImpl(
 
   bufMngr_ = std::make_unique<::ctran::algos::BufManager<
       ResourceBufName,
-      ResourceBufName::kNumBufsNames>>(statex, mapper, logMetadata, memKey);
+      ResourceBufName::kNumBufsNames>>(
+      statex, mapper, logMetadata, memKey, arena);
 }
 } // namespace ctran::alltoallvdedup
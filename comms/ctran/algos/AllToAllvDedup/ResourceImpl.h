@@ -145,10 +145,12 @@ struct ResourceRef {
 
 class ResourceImpl {
  public:
+  // Temporary buffers are carved from arena if given, see BufManager
   ResourceImpl(
       ncclx::CommStateX* statex,
       CtranMapper* mapper,
-      CommLogData* logMetadata);
+      CommLogData* logMetadata,
+      ::ctran::algos::BufArena* arena = nullptr);
   ~ResourceImpl();
 
   // Initialize resources (e.g., temporary buffers) based on persistent
@@ -804,6 +804,26 @@ CtranAlgo::getAllReduceDirectRes() {
   return this->allReduceDirectResource->getRef();
 }
 
+ctran::algos::BufArena* CtranAlgo::getBufArena() {
+  if (!NCCL_CTRAN_SHARED_TMPBUF_ARENA) {
+    return nullptr;
+  }
+  if (!this->bufArena_) {
+    const auto statex = comm_->statex_.get();
+    // memory pool requires unique key for each memory region allocation
+    auto memKey =
+        folly::sformat("Ctran::BufArena-{:#x}", statex->commHash());
+    this->bufArena_ = std::make_unique<ctran::algos::BufArena>(
+        std::make_unique<ctran::algos::MapperBufArenaBackend>(
+            statex, comm_->ctran_->mapper.get(), &comm_->logMetaData_),
+        statex->rank(),
+        statex->nRanks(),
+        memKey,
+        NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE);
+  }
+  return this->bufArena_.get();
+}
+
 commResult_t CtranAlgo::initAllReduceDirectResource(
     int nBlocks,
     cudaStream_t stream) {
@@ -815,7 +835,8 @@ commResult_t CtranAlgo::initAllReduceDirectResource(
       std::make_unique<ctran::algos::allreduce::AllReduceResourceImpl>(
           comm_->statex_.get(),
           comm_->ctran_->mapper.get(),
-          &comm_->logMetaData_);
+          &comm_->logMetaData_,
+          getBufArena());
   this->allReduceDirectResource->initAllReduceDirectResourceAsync(
       nBlocks, stream);
   return commSuccess;
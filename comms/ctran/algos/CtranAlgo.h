@@ -62,6 +62,9 @@ class CtranAlgo {
   commResult_t initTmpBufs();
   commResult_t initAllReduceDirectResource(int nBlocks, cudaStream_t stream);
   ctran::algos::allreduce::AllReduceResourceRef& getAllReduceDirectRes();
+  // Arena of temporary buffers shared by the algorithms of the communicator,
+  // created on first use. nullptr if NCCL_CTRAN_SHARED_TMPBUF_ARENA is unset.
+  ctran::algos::BufArena* getBufArena();
   commResult_t exchangePeerTmpbuf(int peer);
   commResult_t exchangeInterNodeTmpbuf();
 
@@ -161,6 +164,8 @@ class CtranAlgo {
   std::optional<enum NCCL_ALLGATHER_ALGO> allGatherAlgo = std::nullopt;
   std::optional<enum NCCL_ALLREDUCE_ALGO> allReduceAlgo = std::nullopt;
   std::unordered_map<enum CollType, CtranIbConfig> collToVcConfigMap_;
+  // Declared before the resources carving buffers from it, to outlive them
+  std::unique_ptr<ctran::algos::BufArena> bufArena_{nullptr};
   std::unique_ptr<ctran::algos::allreduce::AllReduceResourceImpl>
       allReduceDirectResource{nullptr};
 };
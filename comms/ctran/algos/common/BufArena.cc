@@ -0,0 +1,208 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "comms/ctran/algos/common/BufArena.h"
+#include <unistd.h>
+#include <algorithm>
+#include <iterator>
+#include "comms/ctran/utils/Checks.h"
+
+namespace ctran::algos {
+
+using bufmanager::MemType;
+
+commResult_t MapperBufArenaBackend::commitBase(bufmanager::MemBase& base) {
+  return bufmanager::commitBase(base, statex_, logMetaData_);
+}
+
+commResult_t MapperBufArenaBackend::exchangeBase(
+    bufmanager::MemBase& base,
+    const std::vector<int>& peerRanks,
+    const int maxNumRanks) {
+  return bufmanager::exchangeBase(
+      base, peerRanks, maxNumRanks, statex_, mapper_);
+}
+
+commResult_t MapperBufArenaBackend::releaseBase(bufmanager::MemBase& base) {
+  return bufmanager::releaseBase(base, statex_, mapper_);
+}
+
+BufArena::BufArena(
+    std::unique_ptr<BufArenaBackend> backend,
+    const int rank,
+    const int nRanks,
+    const std::string& memKey,
+    const size_t minChunkSize)
+    : backend_(std::move(backend)),
+      rank_(rank),
+      nRanks_(nRanks),
+      memKey_(memKey),
+      minChunkSize_(minChunkSize),
+      alignment_(getpagesize()) {}
+
+BufArena::~BufArena() {
+  // It is recommended to call release() explicitly to catch any error
+  FB_COMMCHECKIGNORE(release());
+}
+
+BufArena::Segment BufArena::reserve(
+    const MemType type,
+    const size_t len_,
+    const std::vector<int>& peerRanks_) {
+  const size_t len =
+      ctran::utils::align(std::max(len_, (size_t)1), alignment_);
+  std::vector<int> peerRanks = peerRanks_;
+  std::sort(peerRanks.begin(), peerRanks.end());
+  peerRanks.erase(
+      std::unique(peerRanks.begin(), peerRanks.end()), peerRanks.end());
+  auto& chunks = chunks_[(size_t)type];
+
+  // Adds peerRanks to those chunk will be exchanged with
+  auto addPeers = [&](Chunk& chunk) {
+    std::vector<int> peers;
+    std::set_union(
+        chunk.peerRanks.begin(),
+        chunk.peerRanks.end(),
+        peerRanks.begin(),
+        peerRanks.end(),
+        std::back_inserter(peers));
+    chunk.peerRanks = std::move(peers);
+  };
+
+  // First fit in the space of existing chunks, exchanged with all of
+  // peerRanks or not exchanged yet
+  for (int i = 0; i < chunks.size(); i++) {
+    auto& chunk = chunks[i];
+    if (chunk.epoch > 0 &&
+        !std::includes(
+            chunk.peerRanks.begin(),
+            chunk.peerRanks.end(),
+            peerRanks.begin(),
+            peerRanks.end())) {
+      continue;
+    }
+    auto& freeRanges = chunk.freeRanges;
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); it++) {
+      const auto [offset, rangeLen] = *it;
+      if (rangeLen < len) {
+        continue;
+      }
+      freeRanges.erase(it);
+      if (rangeLen > len) {
+        freeRanges.emplace(offset + len, rangeLen - len);
+      }
+      if (chunk.epoch == 0) {
+        addPeers(chunk);
+      }
+      return Segment{type, i, offset, len};
+    }
+  }
+
+  // Otherwise append to the chunk pending commit, starting one if needed
+  if (chunks.empty() || chunks.back().base.ptr) {
+    auto& chunk = chunks.emplace_back();
+    chunk.base.type = type;
+  }
+  addPeers(chunks.back());
+  auto& base = chunks.back().base;
+  const Segment seg{type, (int)chunks.size() - 1, base.size, len};
+  base.size += len;
+  return seg;
+}
+
+void BufArena::free(const Segment& seg) {
+  if (!seg.valid()) {
+    return;
+  }
+  auto& freeRanges = chunks_[(size_t)seg.type].at(seg.chunk).freeRanges;
+  size_t offset = seg.offset;
+  size_t len = seg.len;
+
+  // Merge with the adjacent free ranges
+  auto next = freeRanges.lower_bound(offset);
+  if (next != freeRanges.end() && offset + len == next->first) {
+    len += next->second;
+    next = freeRanges.erase(next);
+  }
+  if (next != freeRanges.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      len += prev->second;
+      freeRanges.erase(prev);
+    }
+  }
+  freeRanges.emplace(offset, len);
+}
+
+commResult_t BufArena::commit() {
+  for (auto type = 0; type < chunks_.size(); type++) {
+    auto& chunks = chunks_[type];
+    if (chunks.empty() || chunks.back().base.ptr) {
+      continue;
+    }
+    auto& chunk = chunks.back();
+    auto& base = chunk.base;
+
+    // Leave room for the reservations of algorithms initialized later
+    const size_t used = base.size;
+    base.size = std::max(used, ctran::utils::align(minChunkSize_, alignment_));
+    if (base.size > used) {
+      free(Segment{
+          (MemType)type, (int)chunks.size() - 1, used, base.size - used});
+    }
+    // Add suffix to separate chunks of different memType and sizes
+    base.memKey = memKey_ + "_" + std::to_string(type) + "_" +
+        std::to_string(chunks.size() - 1) + "_" + std::to_string(base.size);
+    FB_COMMCHECK(backend_->commitBase(base));
+    CLOGF_SUBSYS(
+        INFO,
+        INIT,
+        "BufArena: Rank {} committed chunk {} {}",
+        rank_,
+        chunks.size() - 1,
+        base.toString());
+  }
+  return commSuccess;
+}
+
+commResult_t BufArena::exchange() {
+  const uint64_t epoch = epoch_ + 1;
+  bool exchanged = false;
+  for (auto& chunks : chunks_) {
+    for (auto& chunk : chunks) {
+      if (!chunk.base.ptr || chunk.epoch > 0) {
+        continue;
+      }
+      FB_COMMCHECK(
+          backend_->exchangeBase(chunk.base, chunk.peerRanks, nRanks_));
+      chunk.epoch = epoch;
+      exchanged = true;
+    }
+  }
+  if (exchanged) {
+    epoch_ = epoch;
+    CLOGF_SUBSYS(
+        INFO, INIT, "BufArena: Rank {} exchanged epoch {}", rank_, epoch_);
+  }
+  return commSuccess;
+}
+
+commResult_t BufArena::release() {
+  for (auto& chunks : chunks_) {
+    for (auto& chunk : chunks) {
+      FB_COMMCHECK(backend_->releaseBase(chunk.base));
+    }
+    chunks.clear();
+  }
+  return commSuccess;
+}
+
+size_t BufArena::totalSize(const MemType type) const {
+  size_t size = 0;
+  for (const auto& chunk : chunks_[(size_t)type]) {
+    size += chunk.base.size;
+  }
+  return size;
+}
+
+} // namespace ctran::algos
@@ -0,0 +1,212 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "comms/ctran/algos/common/MemBase.h"
+#include "comms/ctran/mapper/CtranMapper.h"
+#include "comms/ctran/mapper/CtranMapperTypes.h"
+#include "comms/ctran/utils/Utils.h"
+
+namespace ctran::algos {
+
+/* Allocates, registers and exchanges the memory bases of a BufArena. The
+ * communicator uses MapperBufArenaBackend; tests can back the arena with host
+ * memory and a mock mapper instead.
+ */
+class BufArenaBackend {
+ public:
+  virtual ~BufArenaBackend() = default;
+
+  // Allocate base.size bytes of base.type into base.ptr
+  virtual commResult_t commitBase(bufmanager::MemBase& base) = 0;
+  // Register base and fill its remotePtrs and remoteAccessKeys, indexed by
+  // rank, from all peerRanks. Collective over peerRanks.
+  virtual commResult_t exchangeBase(
+      bufmanager::MemBase& base,
+      const std::vector<int>& peerRanks,
+      const int maxNumRanks) = 0;
+  // Undo exchangeBase() and commitBase() of whatever was done
+  virtual commResult_t releaseBase(bufmanager::MemBase& base) = 0;
+};
+
+class MapperBufArenaBackend : public BufArenaBackend {
+ public:
+  MapperBufArenaBackend(
+      const ncclx::CommStateX* statex,
+      CtranMapper* mapper,
+      const CommLogData* logMetaData)
+      : statex_(statex), mapper_(mapper), logMetaData_(logMetaData) {}
+
+  commResult_t commitBase(bufmanager::MemBase& base) override;
+  commResult_t exchangeBase(
+      bufmanager::MemBase& base,
+      const std::vector<int>& peerRanks,
+      const int maxNumRanks) override;
+  commResult_t releaseBase(bufmanager::MemBase& base) override;
+
+ private:
+  const ncclx::CommStateX* statex_{nullptr};
+  CtranMapper* mapper_{nullptr};
+  const CommLogData* logMetaData_{nullptr};
+};
+
+/* Registered temporary memory shared by the algorithms of a communicator.
+ *
+ * Algorithms reserve segments instead of allocating, registering and
+ * exchanging memory bases of their own. Segments are carved from chunks, one
+ * list per memType, and each reservation names the peers which access it
+ * remotely. A reservation which fits in the free space of an existing chunk
+ * exchanged with all of its peers is usable right away; otherwise it goes
+ * into a new chunk of at least minChunkSize bytes, which commit() allocates
+ * and exchange() registers and exchanges with the union of the peers of the
+ * reservations in it, and no other rank. The spare space of that chunk serves
+ * the algorithms initialized later without further exchanges, as long as
+ * their peers are among those. Chunks are never moved, so segments handed out
+ * stay valid as the arena grows.
+ *
+ * Each exchange which added chunks advances the epoch, and chunks are tagged
+ * with the epoch their remote keys arrived in. Callers caching remote buffers
+ * can compare epoch() to know whether new remote keys became available.
+ *
+ * commit() and exchange() are collective over the peers of the chunks they
+ * handle, and the arena lays out segments the same way on every rank, so all
+ * ranks must reserve and free the same segments in the same order, with peers
+ * chosen the same way, as they already initialize algorithms in the same
+ * order. Not thread-safe; it is used from the thread issuing collectives.
+ */
+class BufArena {
+ public:
+  struct Segment {
+    bufmanager::MemType type{bufmanager::MemType::kDevice};
+    int chunk{-1};
+    size_t offset{0};
+    size_t len{0};
+
+    bool valid() const {
+      return chunk >= 0;
+    }
+  };
+
+  BufArena(
+      std::unique_ptr<BufArenaBackend> backend,
+      const int rank,
+      const int nRanks,
+      const std::string& memKey,
+      const size_t minChunkSize);
+  ~BufArena();
+
+  BufArena(const BufArena&) = delete;
+  BufArena& operator=(const BufArena&) = delete;
+
+  // Reserve a segment of at least len bytes, aligned to page size, accessed
+  // remotely from peerRanks. It can be accessed locally once isCommitted()
+  // and from peerRanks once isExchanged().
+  Segment reserve(
+      const bufmanager::MemType type,
+      const size_t len,
+      const std::vector<int>& peerRanks);
+
+  // Return a reserved segment to the arena. Its space may be handed out
+  // again by a later reserve(), without any exchange.
+  void free(const Segment& seg);
+
+  // Allocate the chunk holding reservations which did not fit in existing
+  // chunks, for each memType which has one.
+  commResult_t commit();
+
+  // Register the chunks committed since the last exchange and exchange each
+  // with the peers of its reservations, then advance the epoch. No-op without
+  // such chunks.
+  commResult_t exchange();
+
+  // Release all chunks. Segments must not be used afterwards.
+  commResult_t release();
+
+  bool isCommitted(const Segment& seg) const {
+    return getChunk(seg).base.ptr != nullptr;
+  }
+
+  bool isExchanged(const Segment& seg) const {
+    return getChunk(seg).epoch > 0;
+  }
+
+  void* getPtr(const Segment& seg) const {
+    return BUFOFFSET(getChunk(seg).base.ptr, seg.offset);
+  }
+
+  void* getRegHdl(const Segment& seg) const {
+    return getChunk(seg).base.regHdl;
+  }
+
+  // nullptr if seg's chunk was not exchanged with peerRank
+  void* getRemotePtr(const Segment& seg, const int peerRank) const {
+    void* chunkPtr = getChunk(seg).base.remotePtrs.at(peerRank);
+    return chunkPtr ? BUFOFFSET(chunkPtr, seg.offset) : nullptr;
+  }
+
+  const CtranMapperRemoteAccessKey& getRemoteAccessKey(
+      const Segment& seg,
+      const int peerRank) const {
+    return getChunk(seg).base.remoteAccessKeys.at(peerRank);
+  }
+
+  // Epoch the remote keys of seg were exchanged in, 0 if not yet
+  uint64_t getEpoch(const Segment& seg) const {
+    return getChunk(seg).epoch;
+  }
+
+  // Number of exchanges which added chunks so far
+  uint64_t epoch() const {
+    return epoch_;
+  }
+
+  size_t numChunks(const bufmanager::MemType type) const {
+    return chunks_[(size_t)type].size();
+  }
+
+  // Sorted peers chunk i of type is exchanged with, or will be
+  const std::vector<int>& getChunkPeers(
+      const bufmanager::MemType type,
+      const int chunk) const {
+    return chunks_[(size_t)type].at(chunk).peerRanks;
+  }
+
+  // Bytes of all chunks of type, allocated or pending commit
+  size_t totalSize(const bufmanager::MemType type) const;
+
+ private:
+  struct Chunk {
+    bufmanager::MemBase base;
+    // Unused ranges, offset to length. Only the last chunk of a memType may
+    // be uncommitted, and reservations grow it until commit().
+    std::map<size_t, size_t> freeRanges;
+    // Epoch of the exchange which registered it, 0 before
+    uint64_t epoch{0};
+    // Sorted union of the peers of the reservations in it until exchanged,
+    // the peers it was exchanged with after
+    std::vector<int> peerRanks;
+  };
+
+  const Chunk& getChunk(const Segment& seg) const {
+    return chunks_[(size_t)seg.type].at(seg.chunk);
+  }
+
+  std::unique_ptr<BufArenaBackend> backend_;
+  const int rank_{-1};
+  const int nRanks_{0};
+  const std::string memKey_;
+  const size_t minChunkSize_{0};
+  const size_t alignment_{0};
+  // Stable addresses as chunks are added, indexed by memType
+  std::array<std::deque<Chunk>, (size_t)bufmanager::MemType::kNumBufTypes>
+      chunks_;
+  uint64_t epoch_{0};
+};
+
+} // namespace ctran::algos
@@ -3,114 +3,14 @@
 #pragma once
 #include <sstream>
 #include <vector>
+#include "comms/ctran/algos/common/BufArena.h"
+#include "comms/ctran/algos/common/MemBase.h"
 #include "comms/ctran/mapper/CtranMapper.h"
 #include "comms/ctran/mapper/CtranMapperTypes.h"
 #include "comms/ctran/utils/TmpBufSegManager.h"
 
 using ::ctran::utils::TmpBufSegManager;
 
-/* Convenient types to manage temporary buffers used in algorithms */
-
-namespace ctran::algos::bufmanager {
-// FIXME: We should consolidate the enum with DevMemType. BufManager currently
-// uses the enum value as the array index: https://fburl.com/code/xrf2jnmu, so
-// we would need to remove the index dependency on enum value first.
-enum class MemType {
-  kDevice = 0,
-  kHostPinned,
-  kNumBufTypes,
-};
-
-inline std::string memTypeToStr(const MemType type) {
-  switch (type) {
-    case MemType::kDevice:
-      return "DEVICE";
-    case MemType::kHostPinned:
-      return "HOST_PINNED";
-    default:
-      return "UNKNOWN";
-  };
-}
-
-struct MemBase {
-  MemType type{MemType::kDevice};
-  void* ptr{nullptr};
-  size_t size{0};
-  void* segHdl{nullptr};
-  void* regHdl{nullptr};
-  std::string memKey;
-  const std::vector<int> peerRanks;
-
-  // indexed by peerRank
-  std::vector<void*> remotePtrs;
-  std::vector<struct CtranMapperRemoteAccessKey> remoteAccessKeys;
-
-  std::string toString() const {
-    std::stringstream ss;
-    ss << "[" << memTypeToStr(type) << "] ptr: " << ptr << ", size: " << size
-       << ", segHdl: " << segHdl << ", regHdl: " << regHdl;
-    return ss.str();
-  }
-};
-
-struct BasicBuf {
-  void* ptr{nullptr};
-  size_t size{0};
-
-  std::string toString() const {
-    std::stringstream ss;
-    ss << "[BASIC_BUF] ptr: " << ptr << ", size: " << size;
-    return ss.str();
-  }
-};
-
-struct RegBuf {
-  void* ptr{nullptr};
-  size_t size{0};
-  void* regHdl{nullptr};
-
-  std::string toString() const {
-    std::stringstream ss;
-    ss << "[REG_BUF] ptr: " << ptr << ", size: " << size
-       << ", regHdl: " << regHdl;
-    return ss.str();
-  }
-};
-
-struct RemRegBuf {
-  int peerRank{-1};
-  void* ptr{nullptr};
-  CtranMapperRemoteAccessKey rkey;
-
-  std::string toString() const {
-    std::stringstream ss;
-    ss << "[REM_REG_BUF] peerRank: " << peerRank << " ptr: " << ptr
-       << ", backend: " << CtranMapper::backendToStr(rkey.backend);
-    if (rkey.backend == CtranMapperBackend::IB) {
-      for (int i = 0; i < rkey.ibKey.nKeys; i++) {
-        ss << ", rkey: " << rkey.ibKey.rkeys[i];
-      }
-    }
-    return ss.str();
-  }
-};
-
-commResult_t commitBase(
-    MemBase& base,
-    const ncclx::CommStateX* statex,
-    const CommLogData* logMetaData);
-commResult_t releaseBase(
-    MemBase& base,
-    const ncclx::CommStateX* statex,
-    CtranMapper* mapper);
-commResult_t exchangeBase(
-    MemBase& base,
-    const std::vector<int>& peerRanks,
-    const int maxNumRanks,
-    const ncclx::CommStateX* statex,
-    CtranMapper* mapper);
-}; // namespace ctran::algos::bufmanager
-
 namespace ctran::algos {
 template <typename T, T MaxNumBufs>
 struct BufSnapshot {
@@ -136,15 +36,20 @@ struct BufSnapshot {
 template <typename T, T MaxNumBufs>
 class BufManager {
  public:
+  // If arena is given, the buffers are carved from it instead of separately
+  // allocated, registered and exchanged memory bases. The arena must outlive
+  // the BufManager.
   BufManager(
       const ncclx::CommStateX* statex,
       CtranMapper* mapper,
       const CommLogData* logMetaData,
-      const std::string& memKey)
+      const std::string& memKey,
+      BufArena* arena = nullptr)
       : mapper_(mapper),
         statex_(statex),
         logMetaData_(logMetaData),
-        memKey_(memKey) {};
+        memKey_(memKey),
+        arena_(arena) {};
   ~BufManager() {
     // It is recommended to call release() explicitly to catch any error
     FB_COMMCHECKIGNORE(release());
@@ -262,7 +167,13 @@ class BufManager {
   // Allocate the memory bases based on the inserted buffers. Each memType will
   // be allocated as separate base. After this call, callsite can assign
   // local buffers. See assignBuf().
-  inline commResult_t commit() {
+  // With an arena, peerRanks must be the ranks exchange() will be called
+  // with: the buffers are carved from arena chunks exchanged with them.
+  // Ignored otherwise.
+  inline commResult_t commit(const std::vector<int>& peerRanks = {}) {
+    if (arena_) {
+      return commitArena(peerRanks);
+    }
     for (auto type = 0; type < memBases_.size(); type++) {
       const auto totalLen = memSegMgrs_[type].totalLen;
       // Initialize base if any buffers inserted with this memType
@@ -289,6 +200,9 @@ class BufManager {
   inline commResult_t exchange(
       const std::vector<int>& peerRanks,
       const int maxNumRanks) {
+    if (arena_) {
+      return exchangeArena(peerRanks, maxNumRanks);
+    }
     for (auto& base : memBases_) {
       // zero-sized base is skipped internally
       FB_COMMCHECK(
@@ -301,6 +215,10 @@ class BufManager {
   // Release the memory bases. It is recommended to call release() explicitly to
   // catch any error.
   inline commResult_t release() {
+    if (arena_) {
+      releaseArena();
+      return commSuccess;
+    }
     for (auto& base : memBases_) {
       // zero-sized base is skipped internally
       FB_COMMCHECK(releaseBase(base, statex_, mapper_));
@@ -311,6 +229,81 @@ class BufManager {
   }
 
  private:
+  // Reserve one arena segment per memType and point the memory bases at them,
+  // so that the assign*() APIs work the same with and without arena.
+  inline commResult_t commitArena(const std::vector<int>& peerRanks) {
+    for (auto type = 0; type < memBases_.size(); type++) {
+      const auto totalLen = memSegMgrs_[type].totalLen;
+      if (totalLen > 0 && !arenaSegs_[type].valid()) {
+        arenaSegs_[type] =
+            arena_->reserve((bufmanager::MemType)type, totalLen, peerRanks);
+      }
+    }
+    arenaPeerRanks_ = peerRanks;
+    FB_COMMCHECK(arena_->commit());
+    for (auto type = 0; type < memBases_.size(); type++) {
+      const auto& seg = arenaSegs_[type];
+      if (seg.valid()) {
+        auto& base = memBases_[type];
+        base.type = (bufmanager::MemType)type;
+        base.ptr = arena_->getPtr(seg);
+        base.size = seg.len;
+      }
+    }
+    isCommitted_ = true;
+    return commSuccess;
+  }
+
+  // The arena exchanges the segments with the peers given to commit()
+  inline commResult_t exchangeArena(
+      const std::vector<int>& peerRanks,
+      const int maxNumRanks) {
+    if (peerRanks != arenaPeerRanks_) {
+      CLOGF(
+          ERR,
+          "BufManager {}: exchange() with other peers than commit()",
+          memKey_);
+      return commInvalidUsage;
+    }
+    FB_COMMCHECK(arena_->exchange());
+    for (auto type = 0; type < memBases_.size(); type++) {
+      const auto& seg = arenaSegs_[type];
+      if (!seg.valid()) {
+        continue;
+      }
+      auto& base = memBases_[type];
+      base.regHdl = arena_->getRegHdl(seg);
+      base.remotePtrs.resize(maxNumRanks, nullptr);
+      base.remoteAccessKeys.resize(maxNumRanks, CtranMapperRemoteAccessKey{});
+      for (int peer = 0; peer < maxNumRanks; peer++) {
+        base.remotePtrs[peer] = arena_->getRemotePtr(seg, peer);
+        base.remoteAccessKeys[peer] = arena_->getRemoteAccessKey(seg, peer);
+      }
+    }
+    isExchanged_ = true;
+    return commSuccess;
+  }
+
+  // Registration and memory belong to the arena; only hand the segments back
+  inline void releaseArena() {
+    for (auto type = 0; type < memBases_.size(); type++) {
+      auto& seg = arenaSegs_[type];
+      if (seg.valid()) {
+        arena_->free(seg);
+        seg = BufArena::Segment{};
+      }
+      auto& base = memBases_[type];
+      base.ptr = nullptr;
+      base.size = 0;
+      base.regHdl = nullptr;
+      base.remotePtrs.clear();
+      base.remoteAccessKeys.clear();
+    }
+    arenaPeerRanks_.clear();
+    isCommitted_ = false;
+    isExchanged_ = false;
+  }
+
   // Actual allocated memory bases, each element is a different memtype
   std::array<bufmanager::MemBase, (size_t)bufmanager::MemType::kNumBufTypes>
       memBases_;
@@ -328,6 +321,12 @@ class BufManager {
   const ncclx::CommStateX* statex_{nullptr};
   const CommLogData* logMetaData_;
   const std::string memKey_;
+  BufArena* arena_{nullptr};
+  // Segments backing memBases_ when arena_ is set, indexed by memType, and
+  // the peers they were reserved for
+  std::array<BufArena::Segment, (size_t)bufmanager::MemType::kNumBufTypes>
+      arenaSegs_;
+  std::vector<int> arenaPeerRanks_;
 };
 
 } // namespace ctran::algos
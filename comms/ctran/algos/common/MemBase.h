@@ -0,0 +1,110 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+#include <sstream>
+#include <string>
+#include <vector>
+#include "comms/ctran/mapper/CtranMapper.h"
+#include "comms/ctran/mapper/CtranMapperTypes.h"
+
+/* Convenient types to manage temporary buffers used in algorithms */
+
+namespace ctran::algos::bufmanager {
+// FIXME: We should consolidate the enum with DevMemType. BufManager currently
+// uses the enum value as the array index: https://fburl.com/code/xrf2jnmu, so
+// we would need to remove the index dependency on enum value first.
+enum class MemType {
+  kDevice = 0,
+  kHostPinned,
+  kNumBufTypes,
+};
+
+inline std::string memTypeToStr(const MemType type) {
+  switch (type) {
+    case MemType::kDevice:
+      return "DEVICE";
+    case MemType::kHostPinned:
+      return "HOST_PINNED";
+    default:
+      return "UNKNOWN";
+  };
+}
+
+struct MemBase {
+  MemType type{MemType::kDevice};
+  void* ptr{nullptr};
+  size_t size{0};
+  void* segHdl{nullptr};
+  void* regHdl{nullptr};
+  std::string memKey;
+  const std::vector<int> peerRanks;
+
+  // indexed by peerRank
+  std::vector<void*> remotePtrs;
+  std::vector<struct CtranMapperRemoteAccessKey> remoteAccessKeys;
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << "[" << memTypeToStr(type) << "] ptr: " << ptr << ", size: " << size
+       << ", segHdl: " << segHdl << ", regHdl: " << regHdl;
+    return ss.str();
+  }
+};
+
+struct BasicBuf {
+  void* ptr{nullptr};
+  size_t size{0};
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << "[BASIC_BUF] ptr: " << ptr << ", size: " << size;
+    return ss.str();
+  }
+};
+
+struct RegBuf {
+  void* ptr{nullptr};
+  size_t size{0};
+  void* regHdl{nullptr};
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << "[REG_BUF] ptr: " << ptr << ", size: " << size
+       << ", regHdl: " << regHdl;
+    return ss.str();
+  }
+};
+
+struct RemRegBuf {
+  int peerRank{-1};
+  void* ptr{nullptr};
+  CtranMapperRemoteAccessKey rkey;
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << "[REM_REG_BUF] peerRank: " << peerRank << " ptr: " << ptr
+       << ", backend: " << CtranMapper::backendToStr(rkey.backend);
+    if (rkey.backend == CtranMapperBackend::IB) {
+      for (int i = 0; i < rkey.ibKey.nKeys; i++) {
+        ss << ", rkey: " << rkey.ibKey.rkeys[i];
+      }
+    }
+    return ss.str();
+  }
+};
+
+commResult_t commitBase(
+    MemBase& base,
+    const ncclx::CommStateX* statex,
+    const CommLogData* logMetaData);
+commResult_t releaseBase(
+    MemBase& base,
+    const ncclx::CommStateX* statex,
+    CtranMapper* mapper);
+commResult_t exchangeBase(
+    MemBase& base,
+    const std::vector<int>& peerRanks,
+    const int maxNumRanks,
+    const ncclx::CommStateX* statex,
+    CtranMapper* mapper);
+}; // namespace ctran::algos::bufmanager
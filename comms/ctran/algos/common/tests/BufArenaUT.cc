@@ -0,0 +1,449 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "comms/ctran/algos/common/BufArena.h"
+#include "comms/ctran/algos/common/BufManager.h"
+
+using ctran::algos::BufArena;
+using ctran::algos::BufArenaBackend;
+using ctran::algos::BufManager;
+using ctran::algos::bufmanager::MemBase;
+using ctran::algos::bufmanager::MemType;
+using ctran::algos::bufmanager::RemRegBuf;
+
+namespace {
+
+const size_t kPage = getpagesize();
+
+// Ranks of a communicator simulated by threads of this process. Exchanges go
+// through a shared table instead of the mapper's control messages.
+class MockComm {
+ public:
+  explicit MockComm(int nRanks)
+      : nRanks_(nRanks),
+        barrier_(nRanks),
+        numExchanges_(nRanks),
+        exchangedWith_(nRanks) {}
+
+  int nRanks() const {
+    return nRanks_;
+  }
+
+  std::vector<int> ranks() const {
+    std::vector<int> ranks(nRanks_);
+    for (int r = 0; r < nRanks_; r++) {
+      ranks[r] = r;
+    }
+    return ranks;
+  }
+
+  // Run fn(rank) on every rank at once
+  void run(const std::function<void(int)>& fn) {
+    std::vector<std::thread> threads;
+    for (int r = 0; r < nRanks_; r++) {
+      threads.emplace_back(fn, r);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // Exchange of ptr with peerRanks, as CtranMapper::allGatherCtrl(). Ranks
+  // outside of peerRanks are not waited for and left nullptr.
+  std::vector<void*> allGather(
+      int rank,
+      const std::string& key,
+      void* ptr,
+      const std::vector<int>& peerRanks) {
+    std::unique_lock lock(mutex_);
+    auto& published = published_[key];
+    published.resize(nRanks_, nullptr);
+    published[rank] = ptr;
+    publishedCv_.notify_all();
+    publishedCv_.wait(lock, [&]() {
+      for (auto peer : peerRanks) {
+        if (!published[peer]) {
+          return false;
+        }
+      }
+      return true;
+    });
+    std::vector<void*> ptrs(nRanks_, nullptr);
+    for (auto peer : peerRanks) {
+      ptrs[peer] = published[peer];
+    }
+    return ptrs;
+  }
+
+  void barrier() {
+    barrier_.arrive_and_wait();
+  }
+
+  std::atomic<int>& numExchanges(int rank) {
+    return numExchanges_[rank];
+  }
+
+  // Peers of each exchange of rank, in order. Only rank touches its own.
+  std::vector<std::vector<int>>& exchangedWith(int rank) {
+    return exchangedWith_[rank];
+  }
+
+ private:
+  const int nRanks_;
+  std::barrier<> barrier_;
+  std::mutex mutex_;
+  std::condition_variable publishedCv_;
+  std::map<std::string, std::vector<void*>> published_;
+  std::vector<std::atomic<int>> numExchanges_;
+  std::vector<std::vector<std::vector<int>>> exchangedWith_;
+};
+
+// Host memory in place of device and pinned memory, and a mock mapper
+class MockBackend : public BufArenaBackend {
+ public:
+  MockBackend(MockComm& comm, int rank) : comm_(comm), rank_(rank) {}
+
+  commResult_t commitBase(MemBase& base) override {
+    base.ptr = std::aligned_alloc(kPage, base.size);
+    return base.ptr ? commSuccess : commSystemError;
+  }
+
+  commResult_t exchangeBase(
+      MemBase& base,
+      const std::vector<int>& peerRanks,
+      const int maxNumRanks) override {
+    comm_.numExchanges(rank_)++;
+    comm_.exchangedWith(rank_).push_back(peerRanks);
+    base.regHdl = base.ptr;
+    const auto ptrs =
+        comm_.allGather(rank_, base.memKey, base.ptr, peerRanks);
+    base.remotePtrs.resize(maxNumRanks, nullptr);
+    base.remoteAccessKeys.resize(maxNumRanks, CtranMapperRemoteAccessKey{});
+    for (auto peer : peerRanks) {
+      base.remotePtrs[peer] = ptrs[peer];
+      if (peer != rank_) {
+        base.remoteAccessKeys[peer].backend = CtranMapperBackend::NVL;
+      }
+    }
+    return commSuccess;
+  }
+
+  commResult_t releaseBase(MemBase& base) override {
+    base.remoteAccessKeys.clear();
+    base.regHdl = nullptr;
+    std::free(base.ptr);
+    base.ptr = nullptr;
+    return commSuccess;
+  }
+
+ private:
+  MockComm& comm_;
+  const int rank_;
+};
+
+std::unique_ptr<BufArena>
+makeArena(MockComm& comm, int rank, size_t minChunkSize) {
+  return std::make_unique<BufArena>(
+      std::make_unique<MockBackend>(comm, rank),
+      rank,
+      comm.nRanks(),
+      "test-arena",
+      minChunkSize);
+}
+
+// Every rank sees the segment of each peer where that peer has it
+void checkRemote(
+    MockComm& comm,
+    int rank,
+    const BufArena& arena,
+    const BufArena::Segment& seg,
+    std::vector<void*>& localPtrs) {
+  localPtrs[rank] = arena.getPtr(seg);
+  comm.barrier();
+  for (int peer = 0; peer < comm.nRanks(); peer++) {
+    EXPECT_EQ(arena.getRemotePtr(seg, peer), localPtrs[peer])
+        << "rank " << rank << " peer " << peer;
+    EXPECT_EQ(
+        arena.getRemoteAccessKey(seg, peer).backend,
+        peer == rank ? CtranMapperBackend::UNSET : CtranMapperBackend::NVL);
+  }
+  comm.barrier();
+}
+
+} // namespace
+
+TEST(BufArenaTest, LaterAlgorithmsNeedNoExchange) {
+  MockComm comm(4);
+  std::vector<void*> localPtrs(comm.nRanks());
+  comm.run([&](int rank) {
+    auto arena = makeArena(comm, rank, 64 * kPage);
+
+    // First algorithm initialized on the communicator
+    auto segA = arena->reserve(MemType::kDevice, 3 * kPage, comm.ranks());
+    auto segAH = arena->reserve(MemType::kHostPinned, 100, comm.ranks());
+    EXPECT_FALSE(arena->isCommitted(segA));
+    ASSERT_EQ(arena->commit(), commSuccess);
+    EXPECT_TRUE(arena->isCommitted(segA));
+    EXPECT_FALSE(arena->isExchanged(segA));
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_TRUE(arena->isExchanged(segA));
+    EXPECT_TRUE(arena->isExchanged(segAH));
+    EXPECT_EQ(arena->epoch(), 1);
+    EXPECT_EQ(comm.numExchanges(rank), 2);
+    EXPECT_EQ(segAH.len, kPage);
+    EXPECT_EQ(arena->totalSize(MemType::kDevice), 64 * kPage);
+
+    // The next ones fit in the spare space of the chunks
+    auto segB = arena->reserve(MemType::kDevice, 10 * kPage, comm.ranks());
+    auto segC = arena->reserve(MemType::kDevice, 1, comm.ranks());
+    EXPECT_TRUE(arena->isExchanged(segB));
+    EXPECT_TRUE(arena->isExchanged(segC));
+    ASSERT_EQ(arena->commit(), commSuccess);
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_EQ(arena->epoch(), 1);
+    EXPECT_EQ(comm.numExchanges(rank), 2);
+    EXPECT_EQ(arena->numChunks(MemType::kDevice), 1);
+    EXPECT_EQ(arena->getPtr(segB), BUFOFFSET(arena->getPtr(segA), 3 * kPage));
+
+    checkRemote(comm, rank, *arena, segA, localPtrs);
+    checkRemote(comm, rank, *arena, segB, localPtrs);
+    checkRemote(comm, rank, *arena, segC, localPtrs);
+    ASSERT_EQ(arena->release(), commSuccess);
+  });
+}
+
+TEST(BufArenaTest, GrowsWithNewEpoch) {
+  MockComm comm(3);
+  std::vector<void*> localPtrs(comm.nRanks());
+  comm.run([&](int rank) {
+    auto arena = makeArena(comm, rank, 4 * kPage);
+    auto segA = arena->reserve(MemType::kDevice, 4 * kPage, comm.ranks());
+    ASSERT_EQ(arena->commit(), commSuccess);
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    void* ptrA = arena->getPtr(segA);
+    std::vector<void*> remoteA;
+    for (int peer = 0; peer < comm.nRanks(); peer++) {
+      remoteA.push_back(arena->getRemotePtr(segA, peer));
+    }
+
+    // Does not fit, so it waits for a new chunk
+    auto segB = arena->reserve(MemType::kDevice, 6 * kPage, comm.ranks());
+    EXPECT_NE(segB.chunk, segA.chunk);
+    EXPECT_FALSE(arena->isCommitted(segB));
+    ASSERT_EQ(arena->commit(), commSuccess);
+    EXPECT_TRUE(arena->isCommitted(segB));
+    EXPECT_FALSE(arena->isExchanged(segB));
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_EQ(arena->epoch(), 2);
+    EXPECT_EQ(arena->getEpoch(segA), 1);
+    EXPECT_EQ(arena->getEpoch(segB), 2);
+    EXPECT_EQ(comm.numExchanges(rank), 2);
+    EXPECT_EQ(arena->numChunks(MemType::kDevice), 2);
+    EXPECT_EQ(arena->totalSize(MemType::kDevice), 10 * kPage);
+
+    // Growing left the earlier segment where it was, here and remotely
+    EXPECT_EQ(arena->getPtr(segA), ptrA);
+    for (int peer = 0; peer < comm.nRanks(); peer++) {
+      EXPECT_EQ(arena->getRemotePtr(segA, peer), remoteA[peer]);
+    }
+    checkRemote(comm, rank, *arena, segB, localPtrs);
+    ASSERT_EQ(arena->release(), commSuccess);
+  });
+}
+
+TEST(BufArenaTest, ReusesFreedSpace) {
+  MockComm comm(1);
+  auto arena = makeArena(comm, 0, 0);
+  auto segA = arena->reserve(MemType::kDevice, 2 * kPage, comm.ranks());
+  auto segB = arena->reserve(MemType::kDevice, 3 * kPage, comm.ranks());
+  auto segC = arena->reserve(MemType::kDevice, kPage, comm.ranks());
+  ASSERT_EQ(arena->commit(), commSuccess);
+  ASSERT_EQ(arena->exchange(), commSuccess);
+  EXPECT_EQ(arena->totalSize(MemType::kDevice), 6 * kPage);
+
+  // Adjacent free ranges merge, out of order too
+  arena->free(segB);
+  arena->free(segA);
+  auto segD = arena->reserve(MemType::kDevice, 5 * kPage, comm.ranks());
+  EXPECT_EQ(segD.chunk, 0);
+  EXPECT_EQ(segD.offset, 0);
+  EXPECT_TRUE(arena->isExchanged(segD));
+
+  arena->free(segC);
+  arena->free(segD);
+  auto segE = arena->reserve(MemType::kDevice, kPage, comm.ranks());
+  auto segF = arena->reserve(MemType::kDevice, 5 * kPage, comm.ranks());
+  EXPECT_EQ(segE.offset, 0);
+  EXPECT_EQ(segF.offset, kPage);
+  ASSERT_EQ(arena->exchange(), commSuccess);
+  EXPECT_EQ(comm.numExchanges(0), 1);
+  EXPECT_EQ(arena->numChunks(MemType::kDevice), 1);
+}
+
+TEST(BufArenaTest, BufManagersShareOneExchange) {
+  enum class AlgoABufs { kTmp, kSync, kNumBufs };
+  enum class AlgoBBufs { kTmp, kNumBufs };
+
+  MockComm comm(2);
+  comm.run([&](int rank) {
+    auto arena = makeArena(comm, rank, 32 * kPage);
+    void* firstPtr = nullptr;
+    for (int iter = 0; iter < 3; iter++) {
+      BufManager<AlgoABufs, AlgoABufs::kNumBufs> bufMngrA(
+          nullptr, nullptr, nullptr, "algoA", arena.get());
+      BufManager<AlgoBBufs, AlgoBBufs::kNumBufs> bufMngrB(
+          nullptr, nullptr, nullptr, "algoB", arena.get());
+      ASSERT_EQ(
+          bufMngrA.insert(MemType::kDevice, AlgoABufs::kTmp, 4 * kPage),
+          commSuccess);
+      ASSERT_EQ(
+          bufMngrA.insert(MemType::kDevice, AlgoABufs::kSync, 64),
+          commSuccess);
+      ASSERT_EQ(bufMngrA.commit({0, 1}), commSuccess);
+      ASSERT_EQ(bufMngrA.exchange({0, 1}, comm.nRanks()), commSuccess);
+
+      ASSERT_EQ(
+          bufMngrB.insert(MemType::kDevice, AlgoBBufs::kTmp, 8 * kPage),
+          commSuccess);
+      ASSERT_EQ(bufMngrB.commit({0, 1}), commSuccess);
+      ASSERT_EQ(bufMngrB.exchange({0, 1}, comm.nRanks()), commSuccess);
+
+      ctran::algos::bufmanager::RegBuf tmpA, syncA, tmpB;
+      ASSERT_TRUE(
+          bufMngrA.assignRegBuf(MemType::kDevice, AlgoABufs::kTmp, tmpA));
+      ASSERT_TRUE(
+          bufMngrA.assignRegBuf(MemType::kDevice, AlgoABufs::kSync, syncA));
+      ASSERT_TRUE(
+          bufMngrB.assignRegBuf(MemType::kDevice, AlgoBBufs::kTmp, tmpB));
+      EXPECT_EQ(syncA.ptr, BUFOFFSET(tmpA.ptr, 4 * kPage));
+      EXPECT_EQ(tmpB.ptr, BUFOFFSET(tmpA.ptr, 5 * kPage));
+      EXPECT_NE(tmpA.regHdl, nullptr);
+      EXPECT_EQ(tmpA.regHdl, tmpB.regHdl);
+      // Released buffers are handed out again
+      if (iter == 0) {
+        firstPtr = tmpA.ptr;
+      }
+      EXPECT_EQ(tmpA.ptr, firstPtr);
+
+      std::vector<int> peers{1 - rank};
+      std::vector<RemRegBuf> remB;
+      ASSERT_TRUE(bufMngrB.assignRemRegBuf(
+          MemType::kDevice, AlgoBBufs::kTmp, peers, remB));
+      ASSERT_EQ(remB.size(), 1);
+      EXPECT_EQ(remB[0].peerRank, 1 - rank);
+      EXPECT_EQ(remB[0].rkey.backend, CtranMapperBackend::NVL);
+
+      // Both algorithms are destroyed and initialized again
+      ASSERT_EQ(bufMngrA.release(), commSuccess);
+      ASSERT_EQ(bufMngrB.release(), commSuccess);
+      EXPECT_FALSE(bufMngrA.isCommitted());
+    }
+    // One chunk, exchanged once, for all of it
+    EXPECT_EQ(comm.numExchanges(rank), 1);
+    EXPECT_EQ(arena->numChunks(MemType::kDevice), 1);
+  });
+}
+
+TEST(BufArenaTest, ExchangesOnlyWithRequestedPeers) {
+  // 2 nodes of 2 ranks. Like AllToAllvDedup, an algorithm exchanges with the
+  // ranks of its node and its rail peer on the other node.
+  MockComm comm(4);
+  comm.run([&](int rank) {
+    const int node = rank / 2;
+    std::vector<int> railPeers = {2 * node, 2 * node + 1, 2 * (1 - node)};
+    railPeers.back() += rank % 2;
+    std::vector<int> sortedRailPeers = railPeers;
+    std::sort(sortedRailPeers.begin(), sortedRailPeers.end());
+    auto arena = makeArena(comm, rank, 16 * kPage);
+
+    auto segA = arena->reserve(MemType::kDevice, kPage, railPeers);
+    ASSERT_EQ(arena->commit(), commSuccess);
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_EQ(
+        comm.exchangedWith(rank),
+        std::vector<std::vector<int>>({sortedRailPeers}));
+    for (int peer = 0; peer < comm.nRanks(); peer++) {
+      const bool isPeer =
+          std::count(railPeers.begin(), railPeers.end(), peer) > 0;
+      EXPECT_EQ(arena->getRemotePtr(segA, peer) != nullptr, isPeer)
+          << "rank " << rank << " peer " << peer;
+    }
+
+    // The spare space of the first chunk is not exchanged with all ranks
+    auto segB = arena->reserve(MemType::kDevice, kPage, comm.ranks());
+    EXPECT_NE(segB.chunk, segA.chunk);
+    EXPECT_FALSE(arena->isCommitted(segB));
+    ASSERT_EQ(arena->commit(), commSuccess);
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_EQ(comm.exchangedWith(rank).back(), comm.ranks());
+
+    // Fewer peers fit in either chunk without an exchange
+    auto segC = arena->reserve(MemType::kDevice, 15 * kPage, railPeers);
+    auto segD = arena->reserve(MemType::kDevice, kPage, railPeers);
+    EXPECT_EQ(segC.chunk, segA.chunk);
+    EXPECT_EQ(segD.chunk, segB.chunk);
+    EXPECT_TRUE(arena->isExchanged(segC));
+    EXPECT_TRUE(arena->isExchanged(segD));
+    EXPECT_EQ(comm.numExchanges(rank), 2);
+    ASSERT_EQ(arena->release(), commSuccess);
+  });
+}
+
+TEST(BufArenaTest, ChunkExchangesWithUnionOfPeers) {
+  MockComm comm(4);
+  comm.run([&](int rank) {
+    const int next = (rank + 1) % comm.nRanks();
+    const int prev = (rank + comm.nRanks() - 1) % comm.nRanks();
+    std::vector<int> peers = {prev, rank, next};
+    std::sort(peers.begin(), peers.end());
+    auto arena = makeArena(comm, rank, 16 * kPage);
+
+    // Two algorithms share the pending chunk, one sending to the next rank
+    // and one to the previous
+    auto segA = arena->reserve(MemType::kDevice, kPage, {rank, next});
+    auto segB = arena->reserve(MemType::kDevice, kPage, {rank, prev});
+    EXPECT_EQ(segA.chunk, segB.chunk);
+    EXPECT_EQ(arena->getChunkPeers(MemType::kDevice, segA.chunk), peers);
+    ASSERT_EQ(arena->commit(), commSuccess);
+    ASSERT_EQ(arena->exchange(), commSuccess);
+    EXPECT_EQ(comm.exchangedWith(rank), std::vector<std::vector<int>>({peers}));
+    EXPECT_NE(arena->getRemotePtr(segA, next), nullptr);
+    EXPECT_NE(arena->getRemotePtr(segB, prev), nullptr);
+    EXPECT_EQ(arena->getRemotePtr(segA, (rank + 2) % comm.nRanks()), nullptr);
+    ASSERT_EQ(arena->release(), commSuccess);
+  });
+}
+
+TEST(BufArenaTest, BufManagerExchangesWithCommitPeers) {
+  enum class AlgoBufs { kTmp, kNumBufs };
+
+  MockComm comm(2);
+  comm.run([&](int rank) {
+    auto arena = makeArena(comm, rank, 4 * kPage);
+    BufManager<AlgoBufs, AlgoBufs::kNumBufs> bufMngr(
+        nullptr, nullptr, nullptr, "algo", arena.get());
+    ASSERT_EQ(
+        bufMngr.insert(MemType::kDevice, AlgoBufs::kTmp, kPage), commSuccess);
+    ASSERT_EQ(bufMngr.commit({rank}), commSuccess);
+    EXPECT_EQ(bufMngr.exchange({0, 1}, comm.nRanks()), commInvalidUsage);
+    EXPECT_EQ(comm.numExchanges(rank), 0);
+    ASSERT_EQ(bufMngr.exchange({rank}, comm.nRanks()), commSuccess);
+    EXPECT_EQ(
+        comm.exchangedWith(rank), std::vector<std::vector<int>>({{rank}}));
+    ASSERT_EQ(bufMngr.release(), commSuccess);
+  });
+}
@@ -595,25 +595,42 @@ void CtranIb::bootstrapStart(
     ifnamePtr = const_cast<std::string*>(&qpServerAddrPtr->ifName);
   }
 
-  FB_SYSCHECKTHROW(this->listenSocket.bindAndListen(addrSockAddr, *ifnamePtr));
+  // Peers of a communicator reach us by the exchanged address, so that can be
+  // a listener shared with other communicators
+  folly::SocketAddress listenAddr;
+  if (comm && this->bootstrapMode == BootstrapMode::kDefaultServer) {
+    this->sharedListener = ctran::bootstrap::SharedListener::acquire(
+        addrSockAddr,
+        *ifnamePtr,
+        {commHash, ctran::bootstrap::SharedListener::Backend::kIb, rank},
+        [this](ctran::bootstrap::Socket socket, int peerRank) {
+          return acceptPeer(socket, peerRank);
+        });
+    listenAddr = this->sharedListener->getListenAddress();
+  } else {
+    FB_SYSCHECKTHROW(
+        this->listenSocket.bindAndListen(addrSockAddr, *ifnamePtr));
+    auto maybeListenAddr = this->listenSocket.getListenAddress();
+    if (maybeListenAddr.hasError()) {
+      FB_SYSCHECKTHROW(maybeListenAddr.error());
+    }
+    listenAddr = maybeListenAddr.value();
+  }
   CLOGF_SUBSYS(
       INFO,
       INIT,
-      "CTRAN-IB: Rank {} created listen socket with {} listenAddr {} ifname {}",
+      "CTRAN-IB: Rank {} created {}listen socket with {} listenAddr {} ifname {}",
       rank,
+      this->sharedListener ? "shared " : "",
       bootstrapMode == BootstrapMode::kSpecifiedServer ? "specified"
                                                        : "self-finding",
-      this->listenSocket.getListenAddress()->describe().c_str(),
+      listenAddr.describe().c_str(),
       *ifnamePtr);
 
   // Exchange listen sock address among all ranks
   if (comm) {
     allListenSocketAddrs.resize(comm->statex_->nRanks());
-    auto maybeListenAddr = this->listenSocket.getListenAddress();
-    if (maybeListenAddr.hasError()) {
-      FB_SYSCHECKTHROW(maybeListenAddr.error());
-    }
-    maybeListenAddr->getAddress(&allListenSocketAddrs[rank]);
+    listenAddr.getAddress(&allListenSocketAddrs[rank]);
 
     auto resFuture = comm->bootstrap_->allGather(
         allListenSocketAddrs.data(),
@@ -623,7 +640,9 @@ void CtranIb::bootstrapStart(
     FB_COMMCHECKTHROW(static_cast<commResult_t>(std::move(resFuture).get()));
   }
 
-  this->listenThread = std::thread{bootstrapAccept, this};
+  if (!this->sharedListener) {
+    this->listenThread = std::thread{bootstrapAccept, this};
+  }
 }
 
 void CtranIb::regCtrlCb(std::unique_ptr<CtranCtrlManager>& ctrlMgr) {
@@ -641,7 +660,11 @@ int CtranIb::getIbDevPort(int device) const {
 CtranIb::~CtranIb(void) {
   CtranIbSingleton& s = CtranIbSingleton::getInstance();
 
-  if (bootstrapMode != BootstrapMode::kExternal) {
+  if (sharedListener) {
+    sharedListener->unregisterHandler(
+        {commHash, ctran::bootstrap::SharedListener::Backend::kIb, rank});
+    sharedListener.reset();
+  } else if (bootstrapMode != BootstrapMode::kExternal) {
     listenSocket.shutdown();
     listenThread.join();
   }
@@ -936,9 +959,7 @@ commResult_t CtranIb::preConnect(const std::unordered_set<int>& peerRanks) {
   // Actively connect to peers with larger rank number, if not already connected
   for (int peerRank : peerRanks) {
     FB_COMMCHECK(checkValidPeer(peerRank));
-    if (rank < peerRank && getVcImpl(peerRank) == nullptr) {
-      FB_COMMCHECK(bootstrapConnect(peerRank));
-    }
+    FB_COMMCHECK(connectPeer(peerRank));
   }
   // check if all requested peers are connected
   for (int peerRank : peerRanks) {
@@ -964,6 +985,36 @@ commResult_t CtranIb::preConnect(const std::unordered_set<int>& peerRanks) {
   return commSuccess;
 }
 
+commResult_t CtranIb::connectPeer(
+    int peerRank,
+    std::optional<const SocketServerAddr*> peerAddr) {
+  FB_COMMCHECK(checkValidPeer(peerRank));
+  // Not through getVcImpl(), which reads connectedPeerMap and is meant for
+  // the thread holding the epoch lock
+  auto isConnected = [&]() {
+    return vcStateMaps.rlock()->rankToVcMap.contains(peerRank);
+  };
+  if (rank >= peerRank || isConnected()) {
+    return commSuccess;
+  }
+
+  std::mutex* connectMutex = nullptr;
+  {
+    auto locked = connectMutexes_.wlock();
+    auto& mutex = (*locked)[peerRank];
+    if (!mutex) {
+      mutex = std::make_unique<std::mutex>();
+    }
+    connectMutex = mutex.get();
+  }
+  std::lock_guard<std::mutex> lock(*connectMutex);
+  // Connected by another thread while we waited
+  if (isConnected()) {
+    return commSuccess;
+  }
+  return bootstrapConnect(peerRank, peerAddr);
+}
+
 commResult_t CtranIb::connectVc(
     ctran::bootstrap::Socket& sock,
     const bool isServer,
@@ -1039,7 +1090,10 @@ commResult_t CtranIb::connectVcDirect(
   FB_COMMCHECKTHROW(updateVcState(vc, peerRank));
 
   // Remove from pendingVcs_ since the VC is now established
-  pendingVcs_.erase(peerRank);
+  {
+    std::lock_guard<std::mutex> lock(cqMutex);
+    pendingVcs_.erase(peerRank);
+  }
 
   CLOGF_SUBSYS(
       INFO,
@@ -1107,6 +1161,14 @@ void CtranIb::bootstrapAccept(CtranIb* ib) {
   return;
 }
 
+commResult_t CtranIb::acceptPeer(
+    ctran::bootstrap::Socket& socket,
+    int peerRank) {
+  // Set cudaDev for logging, the shared listen thread serves all devices
+  FB_CUDACHECK(cudaSetDevice(cudaDev));
+  return connectVc(socket, true, peerRank);
+}
+
 commResult_t CtranIb::bootstrapConnect(
     int peerRank,
     std::optional<const SocketServerAddr*> peerAddr) {
@@ -1147,6 +1209,18 @@ commResult_t CtranIb::bootstrapConnect(
 
   // Send SETUP command to remote listenThread
   ctran::bootstrap::Socket sock;
+  if (sharedListener && !peerAddr.has_value()) {
+    // Peers of the communicator accept on a SharedListener as well
+    FB_SYSCHECKRETURN(
+        ctran::bootstrap::SharedListener::connect(
+            sock,
+            peerSockAddr,
+            *clientIfName,
+            {commHash, ctran::bootstrap::SharedListener::Backend::kIb, peerRank},
+            rank),
+        commRemoteError);
+    return connectVc(sock, false, peerRank);
+  }
   FB_SYSCHECKRETURN(
       sock.connect(
           peerSockAddr,
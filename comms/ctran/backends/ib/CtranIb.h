@@ -13,6 +13,7 @@
 #include "comms/ctran/backends/ib/CtranIbImpl.h"
 #include "comms/ctran/backends/ib/CtranIbLocalVc.h"
 #include "comms/ctran/backends/ib/CtranIbVc.h"
+#include "comms/ctran/bootstrap/SharedListener.h"
 #include "comms/ctran/bootstrap/Socket.h"
 #include "comms/ctran/ibverbx/Ibverbx.h"
 #include "comms/ctran/utils/Abort.h"
@@ -439,6 +440,15 @@ class CtranIb {
   // Pre-connect specified peer ranks
   commResult_t preConnect(const std::unordered_set<int>& peerRanks);
 
+  // Connect to peerRank if this rank is the one to connect (the smaller rank
+  // of the two) and no VC is established yet. Unlike preConnect(), safe to
+  // call from any thread without the epoch lock, e.g. a background warm-up;
+  // a connect to the same peer in progress on another thread is waited for
+  // instead of repeated.
+  commResult_t connectPeer(
+      int peerRank,
+      std::optional<const SocketServerAddr*> peerAddr = std::nullopt);
+
   CtranComm* comm{nullptr};
 
   // Setup virtual connection with a connected peer.
@@ -492,6 +502,7 @@ class CtranIb {
           ::ctran::utils::createAbort(/*enabled=*/false));
   void bootstrapStart(std::optional<const SocketServerAddr*> qpServerAddr);
   static void bootstrapAccept(CtranIb* ib);
+  commResult_t acceptPeer(ctran::bootstrap::Socket& socket, int peerRank);
   commResult_t bootstrapConnect(
       int peerRank,
       std::optional<const SocketServerAddr*> peerAddr = std::nullopt);
@@ -749,7 +760,7 @@ class CtranIb {
     // progress.
     if (!PerfConfig::skipVcConnectionCheck && rank < peerRank &&
         vc == nullptr) {
-      FB_COMMCHECK(bootstrapConnect(peerRank, peerServerAddr));
+      FB_COMMCHECK(connectPeer(peerRank, peerServerAddr));
       // Get VC again after connection is established
       vc = getVcImpl<PerfConfig>(peerRank);
     }
@@ -790,7 +801,7 @@ class CtranIb {
     // progress.
     if (!PerfConfig::skipVcConnectionCheck && rank < peerRank &&
         vc == nullptr) {
-      FB_COMMCHECK(bootstrapConnect(peerRank, peerServerAddr));
+      FB_COMMCHECK(connectPeer(peerRank, peerServerAddr));
       // Get VC again after connection is established
       vc = getVcImpl<PerfConfig>(peerRank);
     }
@@ -1078,10 +1089,13 @@ class CtranIb {
   // needs to be acquired.
   std::vector<bool> connectedPeerMap;
 
+  // With comm and kDefaultServer, connections are accepted by a
+  // SharedListener. Otherwise by a listen socket and thread of our own.
   ctran::bootstrap::ServerSocket listenSocket{
       static_cast<int>(NCCL_SOCKET_RETRY_CNT)};
   std::vector<sockaddr_storage> allListenSocketAddrs{};
   std::thread listenThread;
+  std::shared_ptr<ctran::bootstrap::SharedListener> sharedListener;
 
   // Virtual connection status for all peers.
   // NOTE: when using a VC, additional per-VC lock is required.
@@ -1090,9 +1104,13 @@ class CtranIb {
         qpToVcMap;
     folly::F14FastMap<int, std::shared_ptr<CtranIbVirtualConn>> rankToVcMap;
   };
-  // VCs that are created but not yet connected
+  // VCs that are created but not yet connected, guarded by cqMutex
   std::unordered_map<int, std::shared_ptr<CtranIbVirtualConn>> pendingVcs_;
 
+  // Serializes connectPeer() per peer
+  folly::Synchronized<folly::F14FastMap<int, std::unique_ptr<std::mutex>>>
+      connectMutexes_;
+
   folly::Synchronized<VcStateMaps> vcStateMaps;
   // Lock-free struct to be used in eager connect mode which gurantees
   // single-threaded access
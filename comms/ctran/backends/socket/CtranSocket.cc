@@ -56,8 +56,14 @@ CtranSocket::CtranSocket(
 }
 
 CtranSocket::~CtranSocket(void) {
-  listenSocket_.shutdown();
-  listenThread_.join();
+  if (sharedListener_) {
+    sharedListener_->unregisterHandler(
+        {commHash_, ctran::bootstrap::SharedListener::Backend::kSocket, rank_});
+    sharedListener_.reset();
+  } else {
+    listenSocket_.shutdown();
+    listenThread_.join();
+  }
   {
     auto locked = socketMaps_.wlock();
     for (auto it = locked->rankToSocket.begin();
@@ -86,9 +92,7 @@ commResult_t CtranSocket::preConnect(const std::unordered_set<int>& peerRanks) {
   // Actively connect to peers with larger rank number, if not already connected
   for (int peerRank : peerRanks) {
     FB_COMMCHECK(checkValidPeer(peerRank));
-    if (rank_ < peerRank && getSocket(peerRank) == nullptr) {
-      FB_COMMCHECK(bootstrapConnect(peerRank, SocketServerAddr()));
-    }
+    FB_COMMCHECK(connectPeer(peerRank));
   }
   // check if all requested peers are connected
   for (int peerRank : peerRanks) {
@@ -114,6 +118,31 @@ commResult_t CtranSocket::preConnect(const std::unordered_set<int>& peerRanks) {
   return commSuccess;
 }
 
+commResult_t CtranSocket::connectPeer(
+    int peerRank,
+    const SocketServerAddr& peerServerAddr) {
+  FB_COMMCHECK(checkValidPeer(peerRank));
+  if (rank_ >= peerRank || getSocket(peerRank) != nullptr) {
+    return commSuccess;
+  }
+
+  std::mutex* connectMutex = nullptr;
+  {
+    auto locked = connectMutexes_.wlock();
+    auto& mutex = (*locked)[peerRank];
+    if (!mutex) {
+      mutex = std::make_unique<std::mutex>();
+    }
+    connectMutex = mutex.get();
+  }
+  std::lock_guard<std::mutex> lock(*connectMutex);
+  // Connected by another thread while we waited
+  if (getSocket(peerRank) != nullptr) {
+    return commSuccess;
+  }
+  return bootstrapConnect(peerRank, peerServerAddr);
+}
+
 void CtranSocket::init(const SocketServerAddr& serverAddr) {
   ncclLogData_ = CommLogData{
       .commId = comm ? comm->logMetaData_.commId : 0,
@@ -142,21 +171,23 @@ void CtranSocket::init(const SocketServerAddr& serverAddr) {
     }
 
     folly::SocketAddress ifAddrSockAddr(maybeAddr.value(), 0 /* port */);
-    FB_SYSCHECKTHROW(
-        listenSocket_.bindAndListen(ifAddrSockAddr, NCCL_SOCKET_IFNAME));
+    sharedListener_ = ctran::bootstrap::SharedListener::acquire(
+        ifAddrSockAddr,
+        NCCL_SOCKET_IFNAME,
+        {commHash_, ctran::bootstrap::SharedListener::Backend::kSocket, rank_},
+        [this](ctran::bootstrap::Socket socket, int peerRank) {
+          return acceptPeer(std::move(socket), peerRank);
+        });
     CLOGF_SUBSYS(
         INFO,
         INIT,
-        "CTRAN-IB: Rank {} created listen socket based on a self-finding address {}",
+        "CTRAN-SOCKET: Rank {} accepts connections on listener {} based on a self-finding address",
         rank_,
-        listenSocket_.getListenAddress()->describe());
+        sharedListener_->getListenAddress().describe());
 
     allListenSocketAddrs_.resize(comm->statex_->nRanks());
-    auto maybeListenAddr = listenSocket_.getListenAddress();
-    if (maybeListenAddr.hasError()) {
-      FB_SYSCHECKTHROW(maybeListenAddr.error());
-    }
-    maybeListenAddr->getAddress(&allListenSocketAddrs_[rank_]);
+    sharedListener_->getListenAddress().getAddress(
+        &allListenSocketAddrs_[rank_]);
 
     // exchange listen socket addresses with peers
     auto resFuture = comm->bootstrap_->allGather(
@@ -177,8 +208,8 @@ void CtranSocket::init(const SocketServerAddr& serverAddr) {
         rank_,
         serverAddrSockAddr.describe(),
         serverAddr.ifName);
+    listenThread_ = std::thread{[this]() { bootstrapAccept(); }};
   }
-  listenThread_ = std::thread{[this]() { bootstrapAccept(); }};
   CLOGF_SUBSYS(
       INFO,
       INIT,
@@ -203,24 +234,9 @@ void CtranSocket::bootstrapAccept() {
       }
       FB_SYSCHECKTHROW(maybeSocket.error());
     }
-    auto socket = std::make_unique<ctran::bootstrap::Socket>(
-        std::move(maybeSocket.value()));
-    FB_SYSCHECKTHROW(socket->recv(&peerRank, sizeof(int)));
-
-    CLOGF_SUBSYS(
-        INFO,
-        INIT,
-        "CTRAN-SOCKET: Established connection: commHash {:x}, commDesc {}, "
-        "socket {}, rank {}, peer {}",
-        commHash_,
-        commDesc_,
-        (void*)socket.get(),
-        rank_,
-        peerRank);
-
-    // Store the nccl socket
-    FB_COMMCHECKTHROW(checkValidPeer(peerRank));
-    FB_COMMCHECKTHROW(updateSocket(std::move(socket), peerRank));
+    auto& socket = maybeSocket.value();
+    FB_SYSCHECKTHROW(socket.recv(&peerRank, sizeof(int)));
+    FB_COMMCHECKTHROW(acceptPeer(std::move(socket), peerRank));
   }
 
   CLOGF_SUBSYS(
@@ -234,6 +250,32 @@ void CtranSocket::bootstrapAccept() {
   return;
 }
 
+commResult_t CtranSocket::acceptPeer(
+    ctran::bootstrap::Socket socket,
+    int peerRank) {
+  if (sharedListener_) {
+    // Set cudaDev for logging, the shared listen thread serves all devices
+    FB_CUDACHECK(cudaSetDevice(cudaDev_));
+    FB_SYSCHECKRETURN(socket.setAsync(true), commSystemError);
+  }
+  auto sock = std::make_unique<ctran::bootstrap::Socket>(std::move(socket));
+
+  CLOGF_SUBSYS(
+      INFO,
+      INIT,
+      "CTRAN-SOCKET: Established connection: commHash {:x}, commDesc {}, "
+      "socket {}, rank {}, peer {}",
+      commHash_,
+      commDesc_,
+      (void*)sock.get(),
+      rank_,
+      peerRank);
+
+  // Store the nccl socket
+  FB_COMMCHECK(checkValidPeer(peerRank));
+  return updateSocket(std::move(sock), peerRank);
+}
+
 commResult_t CtranSocket::bootstrapConnect(
     int peerRank,
     const SocketServerAddr& peerAddr) {
@@ -255,14 +297,28 @@ commResult_t CtranSocket::bootstrapConnect(
   commResult_t res = commSuccess;
 
   auto socket = std::make_unique<ctran::bootstrap::Socket>();
-  FB_SYSCHECKRETURN(
-      socket->connect(
-          peerSockAddr,
-          NCCL_CLIENT_SOCKET_IFNAME,
-          std::chrono::milliseconds(NCCL_SOCKET_RETRY_SLEEP_MSEC),
-          NCCL_SOCKET_RETRY_CNT),
-      commInternalError);
-  FB_SYSCHECKRETURN(socket->send(&rank_, sizeof(int)), commInternalError);
+  if (comm) {
+    // Peers accept on a SharedListener
+    FB_SYSCHECKRETURN(
+        ctran::bootstrap::SharedListener::connect(
+            *socket,
+            peerSockAddr,
+            NCCL_CLIENT_SOCKET_IFNAME,
+            {commHash_,
+             ctran::bootstrap::SharedListener::Backend::kSocket,
+             peerRank},
+            rank_),
+        commInternalError);
+  } else {
+    FB_SYSCHECKRETURN(
+        socket->connect(
+            peerSockAddr,
+            NCCL_CLIENT_SOCKET_IFNAME,
+            std::chrono::milliseconds(NCCL_SOCKET_RETRY_SLEEP_MSEC),
+            NCCL_SOCKET_RETRY_CNT),
+        commInternalError);
+    FB_SYSCHECKRETURN(socket->send(&rank_, sizeof(int)), commInternalError);
+  }
 
   if (peerRank == rank_) {
     // if send command to self, close the socket and return
@@ -502,7 +558,7 @@ commResult_t CtranSocket::isendCtrlMsgImpl(
   // The ctrlMsg will be enqueued to pendingOps and sent out
   // when polling progress.
   if (rank_ < peerRank && sock == nullptr) {
-    FB_COMMCHECK(bootstrapConnect(peerRank, peerServerAddr));
+    FB_COMMCHECK(connectPeer(peerRank, peerServerAddr));
     // Get socket again after connection is established
     sock = getSocket(peerRank);
   }
@@ -538,7 +594,7 @@ commResult_t CtranSocket::irecvCtrlMsgImpl(
   // The ctrlMsg will be enqueued to pendingOps and sent out when polling
   // progress.
   if (rank_ < peerRank && sock == nullptr) {
-    FB_COMMCHECK(bootstrapConnect(peerRank, peerServerAddr));
+    FB_COMMCHECK(connectPeer(peerRank, peerServerAddr));
     // Get socket again after connection is established
     sock = getSocket(peerRank);
   }
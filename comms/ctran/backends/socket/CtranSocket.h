@@ -6,9 +6,11 @@
 #include <folly/SocketAddress.h>
 #include <folly/Synchronized.h>
 #include <memory>
+#include <mutex>
 #include "comms/ctran/CtranComm.h"
 #include "comms/ctran/backends/CtranCtrl.h"
 #include "comms/ctran/backends/socket/CtranSocketBase.h"
+#include "comms/ctran/bootstrap/SharedListener.h"
 #include "comms/ctran/bootstrap/Socket.h"
 #include "comms/ctran/utils/ExtUtils.h"
 #include "comms/utils/commSpecs.h"
@@ -41,6 +43,14 @@ class CtranSocket {
 
   commResult_t preConnect(const std::unordered_set<int>& peerRanks);
 
+  // Connect to peerRank if this rank is the one to connect (the smaller rank
+  // of the two) and it is not connected yet. Safe to call from any thread,
+  // e.g. a background warm-up; a connect to the same peer in progress on
+  // another thread is waited for instead of repeated.
+  commResult_t connectPeer(
+      int peerRank,
+      const SocketServerAddr& peerServerAddr = SocketServerAddr());
+
   // Finish all pending ops
   inline commResult_t progress(void) {
     return progressInternal();
@@ -100,6 +110,7 @@ class CtranSocket {
 
   void init(const SocketServerAddr& serverAddr);
   void bootstrapAccept();
+  commResult_t acceptPeer(ctran::bootstrap::Socket socket, int peerRank);
   commResult_t bootstrapConnect(int peerRank, const SocketServerAddr& peerAddr);
   commResult_t bootstrapConnect(
       int peerRank,
@@ -186,10 +197,13 @@ class CtranSocket {
   CommLogData ncclLogData_;
   std::vector<bool> preConnectPeerMap_;
 
+  // Without comm, a listen socket and thread of our own at the provided
+  // address. With comm, connections are accepted by a SharedListener.
   ctran::bootstrap::ServerSocket listenSocket_{
       static_cast<int>(NCCL_SOCKET_RETRY_CNT)};
   std::vector<sockaddr_storage> allListenSocketAddrs_{};
   std::thread listenThread_;
+  std::shared_ptr<ctran::bootstrap::SharedListener> sharedListener_;
 
   struct SocketMaps {
     folly::F14FastMap<int, std::unique_ptr<ctran::bootstrap::Socket>>
@@ -202,6 +216,10 @@ class CtranSocket {
       folly::F14FastMap<int, std::deque<std::unique_ptr<SockPendingOp>>>>
       rankToPendingOpsMap_;
 
+  // Serializes connectPeer() per peer
+  folly::Synchronized<folly::F14FastMap<int, std::unique_ptr<std::mutex>>>
+      connectMutexes_;
+
   // every rank maintains a postedrecv queue and unexpected msg queue
   folly::F14FastMap<int, recvCtrlQueue> rankToRecvCtrlMap_;
 };
@@ -0,0 +1,159 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "comms/ctran/backends/CtranCtrl.h"
+#include "comms/ctran/backends/socket/CtranSocket.h"
+#include "comms/ctran/bootstrap/Socket.h"
+#include "comms/ctran/mapper/CtranWarmup.h"
+#include "comms/utils/cvars/nccl_cvars.h"
+
+using ctran::CtranWarmup;
+
+// Latency of the first collective after communicator creation, on the socket
+// backend over loopback: nRanks CtranSocket instances in one process, each
+// exchanging a control message with every other rank from a thread of its
+// own, like the handshake of an AllToAll. Cold, every connect happens inside
+// the exchange; with warm-up, CtranWarmup connected the peers beforehand,
+// inflight at a time. warmupUs is how long the slowest rank's warm-up took.
+
+namespace {
+
+constexpr uint64_t kCommHash = 0xbe4c;
+
+void check(commResult_t res) {
+  if (res != commSuccess) {
+    abort();
+  }
+}
+
+struct LoopbackRanks {
+  explicit LoopbackRanks(int nRanks) {
+    for (int rank = 0; rank < nRanks; rank++) {
+      // Reserve a port, the listen socket binds to it with the port reused
+      auto& reserved = reservedPorts.emplace_back(
+          std::make_unique<ctran::bootstrap::ServerSocket>(1));
+      reserved->bind(folly::SocketAddress("127.0.0.1", 0), "lo", true);
+      addrs.push_back(
+          SocketServerAddr{
+              .port = reserved->getListenAddress()->getPort(),
+              .ipv4 = "127.0.0.1",
+              .ifName = "lo"});
+      socks.push_back(
+          std::make_unique<CtranSocket>(
+              rank, 0, kCommHash, "warmupBench", &ctrlMgr, addrs.back()));
+    }
+  }
+
+  // Connects every rank to its peers like CtranMapper::warmup() does, and
+  // returns the longest time a rank took
+  std::chrono::microseconds warmup(int maxInflight) {
+    const int nRanks = socks.size();
+    std::vector<std::unique_ptr<CtranWarmup>> warmups;
+    for (int rank = 0; rank < nRanks; rank++) {
+      std::vector<int> peers;
+      for (int peer = rank + 1; peer < nRanks; peer++) {
+        peers.push_back(peer);
+      }
+      auto& warmup = warmups.emplace_back(
+          std::make_unique<CtranWarmup>(
+              rank,
+              kCommHash,
+              "warmupBench",
+              [this, rank](int peer) {
+                return socks[rank]->connectPeer(peer, addrs[peer]);
+              },
+              maxInflight));
+      warmup->start(CtranWarmup::order(
+          rank, nRanks, peers, [](int) { return CtranWarmup::Tier::kRack; }));
+    }
+    std::chrono::microseconds longest{0};
+    for (auto& warmup : warmups) {
+      check(warmup->wait());
+      longest = std::max(longest, warmup->duration());
+    }
+    return longest;
+  }
+
+  // Every rank sends a control message to every other rank and receives one
+  // from each, then waits for all of them
+  void exchange() {
+    const int nRanks = socks.size();
+    std::vector<std::thread> threads;
+    for (int rank = 0; rank < nRanks; rank++) {
+      threads.emplace_back([this, rank, nRanks]() {
+        std::vector<ControlMsg> smsgs(nRanks), rmsgs(nRanks);
+        std::vector<CtranSocketRequest> sreqs(nRanks), rreqs(nRanks);
+        auto& sock = socks[rank];
+        for (int i = 1; i < nRanks; i++) {
+          const int peer = (rank + i) % nRanks;
+          smsgs[peer].setType(ControlMsgType::IB_EXPORT_MEM);
+          check(
+              sock->irecvCtrlMsg(rmsgs[peer], peer, addrs[peer], rreqs[peer]));
+          check(
+              sock->isendCtrlMsg(smsgs[peer], peer, addrs[peer], sreqs[peer]));
+        }
+        for (int peer = 0; peer < nRanks; peer++) {
+          if (peer == rank) {
+            continue;
+          }
+          while (!sreqs[peer].isComplete() || !rreqs[peer].isComplete()) {
+            check(sock->progress());
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  CtranCtrlManager ctrlMgr;
+  std::vector<std::unique_ptr<ctran::bootstrap::ServerSocket>> reservedPorts;
+  std::vector<SocketServerAddr> addrs;
+  std::vector<std::unique_ptr<CtranSocket>> socks;
+};
+
+} // namespace
+
+// range(0): nRanks; range(1): warm-up connects in flight, 0 for none
+static void BM_FirstExchange(benchmark::State& state) {
+  const int nRanks = state.range(0);
+  const int maxInflight = state.range(1);
+  std::chrono::microseconds warmupTime{0};
+  for (auto _ : state) {
+    LoopbackRanks ranks(nRanks);
+    if (maxInflight > 0) {
+      warmupTime = ranks.warmup(maxInflight);
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    ranks.exchange();
+    state.SetIterationTime(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)
+            .count());
+  }
+  state.counters["warmupUs"] = warmupTime.count();
+}
+
+BENCHMARK(BM_FirstExchange)
+    ->ArgsProduct({{8, 32, 64}, {0, 1, 8}})
+    ->UseManualTime()
+    ->Iterations(5)
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv) {
+  setenv("NCCL_CLIENT_SOCKET_IFNAME", "lo", 1);
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -43,7 +43,13 @@ void CtranTcpDm::bootstrapPrepare(ctran::bootstrap::IBootstrap* bootstrap) {
   sin6.sin6_family = AF_INET6;
   sin6.sin6_addr = netdev_->addr;
   ifAddrSockAddr.setFromSockaddr(&sin6);
-  FB_SYSCHECKTHROW(listenSocket_.bindAndListen(ifAddrSockAddr, *netdev_->name));
+  listener_ = ctran::bootstrap::SharedListener::acquire(
+      ifAddrSockAddr,
+      *netdev_->name,
+      {commHash_, ctran::bootstrap::SharedListener::Backend::kTcpDm, rank_},
+      [this](ctran::bootstrap::Socket socket, int peerRank) {
+        return bootstrapAccept(socket, peerRank);
+      });
 
   std::string line =
       ::comms::tcp_devmem::addrToString(&netdev_->addr, 0, *netdev_->name);
@@ -56,11 +62,7 @@ void CtranTcpDm::bootstrapPrepare(ctran::bootstrap::IBootstrap* bootstrap) {
       cudaDev_);
 
   allListenSocketAddrs_.resize(nRanks_);
-  auto maybeListenAddr = listenSocket_.getListenAddress();
-  if (maybeListenAddr.hasError()) {
-    FB_SYSCHECKTHROW(maybeListenAddr.error());
-  }
-  maybeListenAddr->getAddress(&allListenSocketAddrs_[rank_]);
+  listener_->getListenAddress().getAddress(&allListenSocketAddrs_[rank_]);
 
   auto resFuture = bootstrap->allGather(
       allListenSocketAddrs_.data(),
@@ -78,74 +80,48 @@ void CtranTcpDm::bootstrapPrepare(ctran::bootstrap::IBootstrap* bootstrap) {
     CLOGF_SUBSYS(
         INFO, INIT, "CTRAN-TCPDM: Rank {} bootstrap address {}", i, line);
   }
-
-  listenThread_ = std::thread([this]() { bootstrapAccept(); });
 }
 
 void CtranTcpDm::bootstrapAddRecvPeer(
     int peerRank,
     ::comms::tcp_devmem::Communicator* comm) {
-  std::lock_guard lock(mutex_);
-  recvComms_[peerRank] = comm;
+  peers_->setRecvComm(peerRank, comm);
 }
 
-void CtranTcpDm::bootstrapAccept() {
-  // Set cudaDev for logging
-  FB_CUDACHECKTHROW(cudaSetDevice(cudaDev_));
-  commNamedThreadStart(
-      "CTranTcpListen", rank_, commHash_, commDesc_.c_str(), __func__);
-
-  while (1) {
-    int peerRank;
-
-    // Accept a connection from a peer. Socket will automatically closed when
-    // it'll go out of scope (part of its destructor)
-    auto maybeSocket = listenSocket_.accept();
-    if (maybeSocket.hasError()) {
-      if (maybeSocket.error() == EBADF || maybeSocket.error() == EINVAL) {
-        break; // listen socket is closed
-      }
-      FB_SYSCHECKTHROW(maybeSocket.error());
-    }
-    auto& socket = maybeSocket.value();
-    FB_SYSCHECKTHROW(socket.recv(&peerRank, sizeof(int)));
-
-    ::comms::tcp_devmem::Handle handle{};
-    ::comms::tcp_devmem::CommunicatorListener* listenComm{};
-    COMMCHECKTHROW(transport_->listen(netdev_, &handle, &listenComm));
+commResult_t CtranTcpDm::bootstrapAccept(
+    ctran::bootstrap::Socket& socket,
+    int peerRank) {
+  // Set cudaDev for logging, the shared listen thread serves all devices
+  FB_CUDACHECK(cudaSetDevice(cudaDev_));
 
-    FB_SYSCHECKTHROW(socket.send(&handle, sizeof(handle)));
+  ::comms::tcp_devmem::Handle handle{};
+  ::comms::tcp_devmem::CommunicatorListener* listenComm{};
+  COMMCHECK_TCP(transport_->listen(netdev_, &handle, &listenComm));
 
-    ::comms::tcp_devmem::Communicator* recvComm;
-    COMMCHECKTHROW(transport_->accept(listenComm, &recvComm));
-    COMMCHECKTHROW(transport_->closeListen(listenComm));
+  FB_SYSCHECKRETURN(socket.send(&handle, sizeof(handle)), commInternalError);
 
-    bootstrapAddRecvPeer(peerRank, recvComm);
+  ::comms::tcp_devmem::Communicator* recvComm;
+  COMMCHECK_TCP(transport_->accept(listenComm, &recvComm));
+  COMMCHECK_TCP(transport_->closeListen(listenComm));
 
-    CLOGF_SUBSYS(
-        INFO,
-        INIT,
-        "CTRAN-TC: Established connection: commHash {:x}, commDesc {}, "
-        "rank {}, peer {}",
-        commHash_,
-        commDesc_,
-        rank_,
-        peerRank);
-  }
+  bootstrapAddRecvPeer(peerRank, recvComm);
 
   CLOGF_SUBSYS(
       INFO,
       INIT,
-      "CTRAN-TCPDM: Accept thread terminating for commHash {:x}, commDesc {}, rank {}",
+      "CTRAN-TC: Established connection: commHash {:x}, commDesc {}, "
+      "rank {}, peer {}",
       commHash_,
       commDesc_,
-      rank_);
+      rank_,
+      peerRank);
+  return commSuccess;
 }
 
 void CtranTcpDm::bootstrapAddSendPeer(
     int peerRank,
     ::comms::tcp_devmem::Communicator* comm) {
-  sendComms_[peerRank] = comm;
+  peers_->setSendComm(peerRank, comm);
 }
 
 commResult_t CtranTcpDm::bootstrapConnect(
@@ -155,13 +131,15 @@ commResult_t CtranTcpDm::bootstrapConnect(
 
   ctran::bootstrap::Socket sock;
   FB_SYSCHECKRETURN(
-      sock.connect(
+      ctran::bootstrap::SharedListener::connect(
+          sock,
           peerSockAddr,
           NCCL_CLIENT_SOCKET_IFNAME,
-          std::chrono::milliseconds(NCCL_SOCKET_RETRY_SLEEP_MSEC),
-          NCCL_SOCKET_RETRY_CNT),
+          {commHash_,
+           ctran::bootstrap::SharedListener::Backend::kTcpDm,
+           peerRank},
+          rank_),
       commInternalError);
-  FB_SYSCHECKRETURN(sock.send(&rank_, sizeof(int)), commInternalError);
 
   ::comms::tcp_devmem::Handle handle{};
   FB_SYSCHECKRETURN(sock.recv(&handle, sizeof(handle)), commInternalError);
@@ -196,6 +174,7 @@ CtranTcpDm::CtranTcpDm(
   commHash_ = comm->statex_->commHash();
   commDesc_ = comm->statex_->commDesc();
   netdev_ = transport_->getDeviceFor(cudaDev_);
+  peers_ = std::make_unique<CtranTcpDmPeers>(nRanks_);
 
   bootstrapPrepare(comm->bootstrap_.get());
 
@@ -209,14 +188,17 @@ CtranTcpDm::CtranTcpDm(
 }
 
 CtranTcpDm::~CtranTcpDm() {
-  listenSocket_.shutdown();
-  listenThread_.join();
+  listener_->unregisterHandler(
+      {commHash_, ctran::bootstrap::SharedListener::Backend::kTcpDm, rank_});
+  listener_.reset();
 
-  for (auto comm : sendComms_) {
-    transport_->closeSend(comm.second);
-  }
-  for (auto comm : recvComms_) {
-    transport_->closeRecv(comm.second);
+  for (int peerRank = 0; peerRank < nRanks_; peerRank++) {
+    if (auto comm = peers_->sendComm(peerRank)) {
+      transport_->closeSend(comm);
+    }
+    if (auto comm = peers_->recvComm(peerRank)) {
+      transport_->closeRecv(comm);
+    }
   }
 
   transport_.reset();
@@ -269,7 +251,7 @@ commResult_t CtranTcpDm::isend(
     CtranTcpDmRequest& req) {
   FB_COMMCHECK(connectPeer(peerRank));
 
-  ::comms::tcp_devmem::Communicator* comm = sendComms_.at(peerRank);
+  ::comms::tcp_devmem::Communicator* comm = peers_->sendComm(peerRank);
 
   ::comms::tcp_devmem::Request* request{nullptr};
   COMMCHECK_TCP(transport_->queueRequest(
@@ -285,7 +267,10 @@ commResult_t CtranTcpDm::isend(
 }
 
 commResult_t CtranTcpDm::connectPeer(int peerRank) {
-  if (sendComms_.find(peerRank) != sendComms_.end()) {
+  if (peerRank < 0 || peerRank >= nRanks_) {
+    return commInvalidArgument;
+  }
+  if (peers_->sendComm(peerRank) != nullptr) {
     return commSuccess;
   }
 
@@ -296,25 +281,11 @@ commResult_t CtranTcpDm::connectPeer(int peerRank) {
 }
 
 commResult_t CtranTcpDm::progress() {
-  std::unique_lock lock(mutex_);
-
-  for (auto it = queuedRecv_.begin(); it != queuedRecv_.end();) {
-    auto& recvReq = *it;
-
-    if (recvComms_.find(recvReq->peerRank) == recvComms_.end()) {
-      ++it;
-      continue;
-    }
-
-    FB_COMMCHECK(irecvConnected(
-        recvReq->peerRank,
-        recvReq->handle,
-        recvReq->data,
-        recvReq->size,
-        *recvReq->req));
-
-    it = queuedRecv_.erase(it);
-  }
+  FB_COMMCHECK(peers_->postConnectedRecvs(
+      [this](int peerRank, CtranTcpDmPeers::PendingRecv& recv) {
+        return irecvConnected(
+            peerRank, recv.handle, recv.data, recv.size, *recv.req);
+      }));
 
   return commSuccess;
 }
@@ -325,22 +296,26 @@ commResult_t CtranTcpDm::irecv(
     void* data,
     size_t size,
     CtranTcpDmRequest& req) {
-  {
-    std::unique_lock lock(mutex_);
-
-    // Peer is not connected, queue this operation. We can't block
-    // the irecv callers. progress() should be called periodically to
-    // attempt to post these requests again.
-    if (recvComms_.find(peerRank) == recvComms_.end()) {
-      auto recvReq = std::make_unique<RecvRequest>();
-      recvReq->peerRank = peerRank;
-      recvReq->handle = handle;
-      recvReq->data = data;
-      recvReq->size = size;
-      recvReq->req = &req;
-      queuedRecv_.push_back(std::move(recvReq));
-      return commSuccess;
-    }
+  if (peerRank < 0 || peerRank >= nRanks_) {
+    return commInvalidArgument;
+  }
+
+  // Peer is not connected, queue this operation. We can't block
+  // the irecv callers. progress() should be called periodically to
+  // attempt to post these requests again.
+  if (peers_->recvComm(peerRank) == nullptr) {
+    peers_->pushPendingRecv(peerRank, handle, data, size, &req);
+    return commSuccess;
+  }
+
+  // Receives queued before the peer connected go first, so that they match
+  // the sends in order
+  if (peers_->hasPendingRecvs(peerRank)) {
+    FB_COMMCHECK(peers_->postPendingRecvs(
+        peerRank, [this](int peer, CtranTcpDmPeers::PendingRecv& recv) {
+          return irecvConnected(
+              peer, recv.handle, recv.data, recv.size, *recv.req);
+        }));
   }
 
   return irecvConnected(peerRank, handle, data, size, req);
@@ -352,7 +327,7 @@ commResult_t CtranTcpDm::irecvConnected(
     void* data,
     size_t size,
     CtranTcpDmRequest& req) {
-  ::comms::tcp_devmem::Communicator* comm = recvComms_.at(peerRank);
+  ::comms::tcp_devmem::Communicator* comm = peers_->recvComm(peerRank);
   if (!comm) {
     return commInternalError;
   }
@@ -2,11 +2,13 @@
 
 #pragma once
 
-#include <unordered_map>
+#include <memory>
 
 #include "comms/ctran/CtranComm.h"
 #include "comms/ctran/backends/CtranCtrl.h"
 #include "comms/ctran/backends/tcpdevmem/CtranTcpDmBase.h"
+#include "comms/ctran/backends/tcpdevmem/CtranTcpDmPeers.h"
+#include "comms/ctran/bootstrap/SharedListener.h"
 #include "comms/ctran/bootstrap/Socket.h"
 #include "comms/ctran/mapper/CtranMapperTypes.h"
 #include "comms/tcp_devmem/transport.h"
@@ -86,10 +88,9 @@ class CtranTcpDm {
 
  private:
   std::shared_ptr<::comms::tcp_devmem::Transport> transport_{nullptr};
-  ctran::bootstrap::ServerSocket listenSocket_{
-      static_cast<int>(NCCL_SOCKET_RETRY_CNT)};
+  // Listener on the address of netdev_, shared by the communicators using it
+  std::shared_ptr<ctran::bootstrap::SharedListener> listener_;
   std::vector<sockaddr_storage> allListenSocketAddrs_{};
-  std::thread listenThread_;
 
   int cudaDev_{-1};
   int rank_{-1};
@@ -98,18 +99,7 @@ class CtranTcpDm {
   std::string commDesc_;
   ::comms::tcp_devmem::NetDev* netdev_{nullptr};
 
-  std::mutex mutex_;
-  std::unordered_map<int, ::comms::tcp_devmem::Communicator*> recvComms_;
-  std::unordered_map<int, ::comms::tcp_devmem::Communicator*> sendComms_;
-
-  struct RecvRequest {
-    int peerRank{-1};
-    void* handle{nullptr};
-    void* data{nullptr};
-    size_t size{0};
-    CtranTcpDmRequest* req{nullptr};
-  };
-  std::list<std::unique_ptr<RecvRequest>> queuedRecv_;
+  std::unique_ptr<CtranTcpDmPeers> peers_;
 
   commResult_t connectPeer(int peerRank);
 
@@ -117,7 +107,7 @@ class CtranTcpDm {
   void bootstrapAddRecvPeer(
       int peerRank,
       ::comms::tcp_devmem::Communicator* comm);
-  void bootstrapAccept();
+  commResult_t bootstrapAccept(ctran::bootstrap::Socket& socket, int peerRank);
   void bootstrapAddSendPeer(
       int peerRank,
       ::comms::tcp_devmem::Communicator* comm);
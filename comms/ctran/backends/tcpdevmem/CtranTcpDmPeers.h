@@ -0,0 +1,157 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "comms/ctran/backends/tcpdevmem/CtranTcpDmBase.h"
+#include "comms/tcp_devmem/transport.h"
+#include "comms/utils/commSpecs.h"
+
+namespace ctran {
+
+/**
+ * Per-peer state of CtranTcpDm: the send and receive communicators, and the
+ * receives posted before the peer connected to us.
+ *
+ * Everything but setRecvComm() is called from the thread issuing operations,
+ * which the mapper serializes with its epoch lock. Receive communicators are
+ * published by the listen thread, so reading them needs no lock either.
+ */
+class CtranTcpDmPeers {
+ public:
+  struct PendingRecv {
+    void* handle{nullptr};
+    void* data{nullptr};
+    size_t size{0};
+    CtranTcpDmRequest* req{nullptr};
+    PendingRecv* next{nullptr};
+  };
+
+  using Communicator = ::comms::tcp_devmem::Communicator;
+
+  explicit CtranTcpDmPeers(int nRanks)
+      : sendComms_(nRanks, nullptr),
+        recvComms_(std::make_unique<std::atomic<Communicator*>[]>(nRanks)),
+        pending_(nRanks),
+        nRanks_(nRanks) {}
+
+  ~CtranTcpDmPeers() = default;
+
+  CtranTcpDmPeers(const CtranTcpDmPeers&) = delete;
+  CtranTcpDmPeers& operator=(const CtranTcpDmPeers&) = delete;
+
+  int nRanks() const {
+    return nRanks_;
+  }
+
+  Communicator* sendComm(int peerRank) const {
+    return sendComms_[peerRank];
+  }
+
+  void setSendComm(int peerRank, Communicator* comm) {
+    sendComms_[peerRank] = comm;
+  }
+
+  Communicator* recvComm(int peerRank) const {
+    return recvComms_[peerRank].load(std::memory_order_acquire);
+  }
+
+  // Called by the listen thread once the peer connected
+  void setRecvComm(int peerRank, Communicator* comm) {
+    recvComms_[peerRank].store(comm, std::memory_order_release);
+  }
+
+  bool hasPendingRecvs(int peerRank) const {
+    return pending_[peerRank].head != nullptr;
+  }
+
+  // Queue a receive behind the others of peerRank. Entries come from a pool
+  // which only grows to the most receives ever queued at once.
+  void pushPendingRecv(
+      int peerRank,
+      void* handle,
+      void* data,
+      size_t size,
+      CtranTcpDmRequest* req) {
+    PendingRecv* recv = freeRecvs_;
+    if (recv) {
+      freeRecvs_ = recv->next;
+    } else {
+      recv = &recvPool_.emplace_back();
+    }
+    *recv = PendingRecv{handle, data, size, req, nullptr};
+
+    auto& queue = pending_[peerRank];
+    if (queue.tail) {
+      queue.tail->next = recv;
+    } else {
+      queue.head = recv;
+      pendingPeers_.push_back(peerRank);
+    }
+    queue.tail = recv;
+  }
+
+  // Post the queued receives of peerRank in order with
+  // post(peerRank, PendingRecv&).
+  // A receive which fails to post stays at the head of the queue.
+  template <typename PostFn>
+  commResult_t postPendingRecvs(int peerRank, PostFn&& post) {
+    auto& queue = pending_[peerRank];
+    while (queue.head) {
+      PendingRecv* recv = queue.head;
+      commResult_t res = post(peerRank, *recv);
+      if (res != commSuccess) {
+        return res;
+      }
+      queue.head = recv->next;
+      recv->next = freeRecvs_;
+      freeRecvs_ = recv;
+    }
+    queue.tail = nullptr;
+    return commSuccess;
+  }
+
+  // postPendingRecvs() for every peer which has some and connected since.
+  // Only peers with queued receives are visited.
+  template <typename PostFn>
+  commResult_t postConnectedRecvs(PostFn&& post) {
+    for (size_t i = 0; i < pendingPeers_.size();) {
+      const int peerRank = pendingPeers_[i];
+      if (hasPendingRecvs(peerRank) && recvComm(peerRank) == nullptr) {
+        i++;
+        continue;
+      }
+      commResult_t res = postPendingRecvs(peerRank, post);
+      if (res != commSuccess) {
+        return res;
+      }
+      pendingPeers_[i] = pendingPeers_.back();
+      pendingPeers_.pop_back();
+    }
+    return commSuccess;
+  }
+
+ private:
+  struct RecvQueue {
+    PendingRecv* head{nullptr};
+    PendingRecv* tail{nullptr};
+  };
+
+  std::vector<Communicator*> sendComms_;
+  std::unique_ptr<std::atomic<Communicator*>[]> recvComms_;
+  std::vector<RecvQueue> pending_;
+  // Peers which queued receives, until postConnectedRecvs() finds their
+  // queue empty or posts it
+  std::vector<int> pendingPeers_;
+  // Stable addresses, entries are recycled through freeRecvs_
+  std::deque<PendingRecv> recvPool_;
+  PendingRecv* freeRecvs_{nullptr};
+  const int nRanks_;
+};
+
+} // namespace ctran
@@ -0,0 +1,209 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "comms/ctran/backends/tcpdevmem/CtranTcpDmPeers.h"
+
+using ctran::CtranTcpDmPeers;
+using ctran::CtranTcpDmRequest;
+using Communicator = ::comms::tcp_devmem::Communicator;
+
+// Host-side cost of issuing isend/irecv in CtranTcpDm as the number of peers
+// grows, without the transport: looking up the peer's communicator, and
+// queueing receives posted before the peer connected then posting them from
+// progress(). The per-peer maps behind one mutex with a list of heap
+// allocated queued receives CtranTcpDm used to keep, versus CtranTcpDmPeers.
+
+namespace {
+
+constexpr int kRecvsPerPeer = 4;
+
+Communicator* fakeComm(int peerRank) {
+  return reinterpret_cast<Communicator*>(
+      static_cast<uintptr_t>(peerRank + 1) << 4);
+}
+
+// The bookkeeping CtranTcpDm used to do
+class MapPeers {
+ public:
+  Communicator* sendComm(int peerRank) {
+    return sendComms_.at(peerRank);
+  }
+
+  void setSendComm(int peerRank, Communicator* comm) {
+    sendComms_[peerRank] = comm;
+  }
+
+  void setRecvComm(int peerRank, Communicator* comm) {
+    std::lock_guard lock(mutex_);
+    recvComms_[peerRank] = comm;
+  }
+
+  Communicator* irecv(int peerRank, CtranTcpDmRequest& req) {
+    std::unique_lock lock(mutex_);
+    auto it = recvComms_.find(peerRank);
+    if (it == recvComms_.end()) {
+      auto recvReq = std::make_unique<RecvRequest>();
+      recvReq->peerRank = peerRank;
+      recvReq->req = &req;
+      queuedRecv_.push_back(std::move(recvReq));
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  int progress() {
+    std::unique_lock lock(mutex_);
+    int posted = 0;
+    for (auto it = queuedRecv_.begin(); it != queuedRecv_.end();) {
+      if (recvComms_.find((*it)->peerRank) == recvComms_.end()) {
+        ++it;
+        continue;
+      }
+      benchmark::DoNotOptimize(recvComms_.at((*it)->peerRank));
+      posted++;
+      it = queuedRecv_.erase(it);
+    }
+    return posted;
+  }
+
+  void disconnectRecvs() {
+    recvComms_.clear();
+  }
+
+ private:
+  struct RecvRequest {
+    int peerRank{-1};
+    void* handle{nullptr};
+    void* data{nullptr};
+    size_t size{0};
+    CtranTcpDmRequest* req{nullptr};
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<int, Communicator*> recvComms_;
+  std::unordered_map<int, Communicator*> sendComms_;
+  std::list<std::unique_ptr<RecvRequest>> queuedRecv_;
+};
+
+commResult_t postRecv(int peerRank, CtranTcpDmPeers::PendingRecv& recv) {
+  benchmark::DoNotOptimize(recv.req);
+  return commSuccess;
+}
+
+} // namespace
+
+// One isend and one irecv to every connected peer
+static void BM_IssueMap(benchmark::State& state) {
+  const int nPeers = state.range(0);
+  MapPeers peers;
+  std::vector<CtranTcpDmRequest> reqs(nPeers);
+  for (int p = 0; p < nPeers; p++) {
+    peers.setSendComm(p, fakeComm(p));
+    peers.setRecvComm(p, fakeComm(p));
+  }
+  for (auto _ : state) {
+    for (int p = 0; p < nPeers; p++) {
+      benchmark::DoNotOptimize(peers.sendComm(p));
+      benchmark::DoNotOptimize(peers.irecv(p, reqs[p]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nPeers * 2);
+}
+
+static void BM_IssuePeers(benchmark::State& state) {
+  const int nPeers = state.range(0);
+  CtranTcpDmPeers peers(nPeers);
+  std::vector<CtranTcpDmRequest> reqs(nPeers);
+  for (int p = 0; p < nPeers; p++) {
+    peers.setSendComm(p, fakeComm(p));
+    peers.setRecvComm(p, fakeComm(p));
+  }
+  for (auto _ : state) {
+    for (int p = 0; p < nPeers; p++) {
+      benchmark::DoNotOptimize(peers.sendComm(p));
+      if (peers.hasPendingRecvs(p)) {
+        peers.postPendingRecvs(p, postRecv);
+      }
+      benchmark::DoNotOptimize(peers.recvComm(p));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nPeers * 2);
+}
+
+// kRecvsPerPeer irecvs to every peer before they connect, progress() while
+// half of them connected, then once all did
+static void BM_EarlyRecvsMap(benchmark::State& state) {
+  const int nPeers = state.range(0);
+  MapPeers peers;
+  std::vector<CtranTcpDmRequest> reqs(nPeers * kRecvsPerPeer);
+  for (auto _ : state) {
+    for (int i = 0; i < kRecvsPerPeer; i++) {
+      for (int p = 0; p < nPeers; p++) {
+        peers.irecv(p, reqs[p * kRecvsPerPeer + i]);
+      }
+    }
+    for (int p = 0; p < nPeers; p += 2) {
+      peers.setRecvComm(p, fakeComm(p));
+    }
+    int posted = peers.progress();
+    for (int p = 1; p < nPeers; p += 2) {
+      peers.setRecvComm(p, fakeComm(p));
+    }
+    posted += peers.progress();
+    benchmark::DoNotOptimize(posted);
+
+    state.PauseTiming();
+    peers.disconnectRecvs();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * nPeers * kRecvsPerPeer);
+}
+
+static void BM_EarlyRecvsPeers(benchmark::State& state) {
+  const int nPeers = state.range(0);
+  std::vector<CtranTcpDmRequest> reqs(nPeers * kRecvsPerPeer);
+  auto peers = std::make_unique<CtranTcpDmPeers>(nPeers);
+  for (auto _ : state) {
+    for (int i = 0; i < kRecvsPerPeer; i++) {
+      for (int p = 0; p < nPeers; p++) {
+        peers->pushPendingRecv(
+            p, nullptr, nullptr, 0, &reqs[p * kRecvsPerPeer + i]);
+      }
+    }
+    for (int p = 0; p < nPeers; p += 2) {
+      peers->setRecvComm(p, fakeComm(p));
+    }
+    peers->postConnectedRecvs(postRecv);
+    for (int p = 1; p < nPeers; p += 2) {
+      peers->setRecvComm(p, fakeComm(p));
+    }
+    peers->postConnectedRecvs(postRecv);
+
+    // Disconnect for the next iteration, keeping the pool warm as it is
+    // across the collectives of a communicator
+    state.PauseTiming();
+    for (int p = 0; p < nPeers; p++) {
+      peers->setRecvComm(p, nullptr);
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * nPeers * kRecvsPerPeer);
+}
+
+BENCHMARK(BM_IssueMap)->RangeMultiplier(4)->Range(8, 2048);
+BENCHMARK(BM_IssuePeers)->RangeMultiplier(4)->Range(8, 2048);
+BENCHMARK(BM_EarlyRecvsMap)->RangeMultiplier(4)->Range(8, 2048);
+BENCHMARK(BM_EarlyRecvsPeers)->RangeMultiplier(4)->Range(8, 2048);
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
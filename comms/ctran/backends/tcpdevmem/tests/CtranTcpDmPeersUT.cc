@@ -0,0 +1,152 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "comms/ctran/backends/tcpdevmem/CtranTcpDmPeers.h"
+
+using ctran::CtranTcpDmPeers;
+using ctran::CtranTcpDmRequest;
+using Communicator = ::comms::tcp_devmem::Communicator;
+
+namespace {
+
+constexpr int kNumRanks = 8;
+
+Communicator* fakeComm(int peerRank) {
+  return reinterpret_cast<Communicator*>(
+      static_cast<uintptr_t>(peerRank + 1) << 4);
+}
+
+// Records the order receives are posted in
+struct Poster {
+  std::vector<std::pair<int, CtranTcpDmRequest*>> posted;
+  CtranTcpDmRequest* failOn{nullptr};
+
+  commResult_t operator()(int peerRank, CtranTcpDmPeers::PendingRecv& recv) {
+    if (recv.req == failOn) {
+      return commInternalError;
+    }
+    posted.emplace_back(peerRank, recv.req);
+    return commSuccess;
+  }
+};
+
+} // namespace
+
+TEST(CtranTcpDmPeersTest, Communicators) {
+  CtranTcpDmPeers peers(kNumRanks);
+  for (int p = 0; p < kNumRanks; p++) {
+    EXPECT_EQ(peers.sendComm(p), nullptr);
+    EXPECT_EQ(peers.recvComm(p), nullptr);
+  }
+  peers.setSendComm(3, fakeComm(3));
+  // Receive communicators come from the listen thread
+  std::thread([&]() { peers.setRecvComm(5, fakeComm(5)); }).join();
+  EXPECT_EQ(peers.sendComm(3), fakeComm(3));
+  EXPECT_EQ(peers.recvComm(3), nullptr);
+  EXPECT_EQ(peers.recvComm(5), fakeComm(5));
+}
+
+TEST(CtranTcpDmPeersTest, PostsConnectedPeersInOrder) {
+  CtranTcpDmPeers peers(kNumRanks);
+  std::vector<CtranTcpDmRequest> reqs(6);
+  peers.pushPendingRecv(1, nullptr, nullptr, 0, &reqs[0]);
+  peers.pushPendingRecv(2, nullptr, nullptr, 0, &reqs[1]);
+  peers.pushPendingRecv(1, nullptr, nullptr, 0, &reqs[2]);
+  peers.pushPendingRecv(2, nullptr, nullptr, 0, &reqs[3]);
+  peers.pushPendingRecv(1, nullptr, nullptr, 0, &reqs[4]);
+  EXPECT_TRUE(peers.hasPendingRecvs(1));
+  EXPECT_TRUE(peers.hasPendingRecvs(2));
+  EXPECT_FALSE(peers.hasPendingRecvs(0));
+
+  // Nobody connected yet
+  Poster poster;
+  ASSERT_EQ(peers.postConnectedRecvs(std::ref(poster)), commSuccess);
+  EXPECT_TRUE(poster.posted.empty());
+
+  peers.setRecvComm(1, fakeComm(1));
+  ASSERT_EQ(peers.postConnectedRecvs(std::ref(poster)), commSuccess);
+  EXPECT_EQ(
+      poster.posted,
+      (std::vector<std::pair<int, CtranTcpDmRequest*>>{
+          {1, &reqs[0]}, {1, &reqs[2]}, {1, &reqs[4]}}));
+  EXPECT_FALSE(peers.hasPendingRecvs(1));
+  EXPECT_TRUE(peers.hasPendingRecvs(2));
+
+  // Queued again after a direct post, as irecv() does once connected
+  peers.pushPendingRecv(2, nullptr, nullptr, 0, &reqs[5]);
+  peers.setRecvComm(2, fakeComm(2));
+  poster.posted.clear();
+  ASSERT_EQ(peers.postPendingRecvs(2, std::ref(poster)), commSuccess);
+  EXPECT_EQ(
+      poster.posted,
+      (std::vector<std::pair<int, CtranTcpDmRequest*>>{
+          {2, &reqs[1]}, {2, &reqs[3]}, {2, &reqs[5]}}));
+  poster.posted.clear();
+  ASSERT_EQ(peers.postConnectedRecvs(std::ref(poster)), commSuccess);
+  EXPECT_TRUE(poster.posted.empty());
+}
+
+TEST(CtranTcpDmPeersTest, FailedPostStaysQueued) {
+  CtranTcpDmPeers peers(kNumRanks);
+  std::vector<CtranTcpDmRequest> reqs(3);
+  for (auto& req : reqs) {
+    peers.pushPendingRecv(4, nullptr, nullptr, 0, &req);
+  }
+  peers.setRecvComm(4, fakeComm(4));
+
+  Poster poster;
+  poster.failOn = &reqs[1];
+  EXPECT_EQ(peers.postConnectedRecvs(std::ref(poster)), commInternalError);
+  EXPECT_EQ(poster.posted.size(), 1);
+  EXPECT_TRUE(peers.hasPendingRecvs(4));
+
+  poster.failOn = nullptr;
+  ASSERT_EQ(peers.postConnectedRecvs(std::ref(poster)), commSuccess);
+  EXPECT_EQ(
+      poster.posted,
+      (std::vector<std::pair<int, CtranTcpDmRequest*>>{
+          {4, &reqs[0]}, {4, &reqs[1]}, {4, &reqs[2]}}));
+  EXPECT_FALSE(peers.hasPendingRecvs(4));
+}
+
+TEST(CtranTcpDmPeersTest, ReusesPendingRecvs) {
+  CtranTcpDmPeers peers(kNumRanks);
+  CtranTcpDmRequest req;
+  std::vector<CtranTcpDmPeers::PendingRecv*> first;
+  auto record = [&](int, CtranTcpDmPeers::PendingRecv& recv) {
+    first.push_back(&recv);
+    return commSuccess;
+  };
+  for (int p = 0; p < kNumRanks; p++) {
+    peers.pushPendingRecv(p, nullptr, nullptr, 0, &req);
+    peers.setRecvComm(p, fakeComm(p));
+  }
+  ASSERT_EQ(peers.postConnectedRecvs(record), commSuccess);
+  ASSERT_EQ(first.size(), kNumRanks);
+
+  // The same entries serve the next round of early receives
+  for (int p = 0; p < kNumRanks; p++) {
+    peers.setRecvComm(p, nullptr);
+    peers.pushPendingRecv(p, nullptr, nullptr, 0, &req);
+    peers.setRecvComm(p, fakeComm(p));
+  }
+  std::vector<CtranTcpDmPeers::PendingRecv*> second;
+  ASSERT_EQ(
+      peers.postConnectedRecvs(
+          [&](int, CtranTcpDmPeers::PendingRecv& recv) {
+            second.push_back(&recv);
+            return commSuccess;
+          }),
+      commSuccess);
+  std::sort(first.begin(), first.end());
+  std::sort(second.begin(), second.end());
+  EXPECT_EQ(first, second);
+}
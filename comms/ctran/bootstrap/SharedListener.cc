@@ -0,0 +1,367 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "comms/ctran/bootstrap/SharedListener.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+
+#include "comms/ctran/utils/Checks.h"
+#include "comms/ctran/utils/Debug.h"
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "comms/utils/logger/LogUtils.h"
+
+namespace ctran::bootstrap {
+
+namespace {
+
+const uint64_t kPreambleMagic = 0xfaceb00c5ea7ed00;
+
+struct Preamble {
+  uint64_t magic;
+  uint64_t commHash;
+  int32_t backend;
+  int32_t rank; // Of the listener side
+  int32_t peerRank; // Of the connecting side
+};
+
+// Accepted connection whose preamble has not all arrived yet
+struct Incoming {
+  Socket socket;
+  Preamble preamble{};
+  size_t received{0};
+  std::chrono::steady_clock::time_point deadline;
+  // Dispatched or closed
+  bool done{false};
+};
+
+std::string listenerName(
+    const folly::SocketAddress& addr,
+    const std::string& ifName) {
+  return addr.getAddressStr() + "%" + ifName;
+}
+
+// Listeners of the process by address and interface. Only weak references,
+// the communicators using a listener own it.
+folly::Synchronized<
+    folly::F14FastMap<std::string, std::weak_ptr<SharedListener>>>&
+sharedListeners() {
+  static folly::Synchronized<
+      folly::F14FastMap<std::string, std::weak_ptr<SharedListener>>>
+      listeners;
+  return listeners;
+}
+
+} // namespace
+
+std::shared_ptr<SharedListener> SharedListener::get(
+    const folly::SocketAddress& addr,
+    const std::string& ifName) {
+  auto locked = sharedListeners().wlock();
+  auto& weak = (*locked)[listenerName(addr, ifName)];
+  auto listener = weak.lock();
+  if (!listener) {
+    listener = std::make_shared<SharedListener>(addr, ifName);
+    weak = listener;
+  }
+  return listener;
+}
+
+std::shared_ptr<SharedListener> SharedListener::create(
+    const folly::SocketAddress& addr,
+    const std::string& ifName) {
+  return std::make_shared<SharedListener>(addr, ifName);
+}
+
+std::shared_ptr<SharedListener> SharedListener::acquire(
+    const folly::SocketAddress& addr,
+    const std::string& ifName,
+    const Key& key,
+    Handler handler) {
+  if (NCCL_CTRAN_SHARED_LISTENER) {
+    auto listener = get(addr, ifName);
+    if (listener->registerHandler(key, handler)) {
+      return listener;
+    }
+    CLOGF(
+        WARN,
+        "CTRAN-BOOTSTRAP: commHash {:x} backend {} rank {} is already registered "
+        "on listener {}, using a separate one",
+        key.commHash,
+        static_cast<int32_t>(key.backend),
+        key.rank,
+        listener->getListenAddress().describe());
+  }
+  auto listener = create(addr, ifName);
+  listener->registerHandler(key, std::move(handler));
+  return listener;
+}
+
+int SharedListener::connect(
+    Socket& sock,
+    const folly::SocketAddress& addr,
+    const std::string& ifName,
+    const Key& key,
+    int peerRank) {
+  int err = sock.connect(
+      addr,
+      ifName,
+      std::chrono::milliseconds(NCCL_SOCKET_RETRY_SLEEP_MSEC),
+      NCCL_SOCKET_RETRY_CNT);
+  if (err != 0) {
+    return err;
+  }
+  const Preamble preamble{
+      .magic = kPreambleMagic,
+      .commHash = key.commHash,
+      .backend = static_cast<int32_t>(key.backend),
+      .rank = key.rank,
+      .peerRank = peerRank};
+  return sock.send(&preamble, sizeof(preamble));
+}
+
+SharedListener::SharedListener(
+    const folly::SocketAddress& addr,
+    const std::string& ifName)
+    : listenSocket_(static_cast<int>(NCCL_SOCKET_RETRY_CNT)) {
+  FB_SYSCHECKTHROW(listenSocket_.bindAndListen(addr, ifName));
+  auto maybeListenAddr = listenSocket_.getListenAddress();
+  if (maybeListenAddr.hasError()) {
+    FB_SYSCHECKTHROW(maybeListenAddr.error());
+  }
+  listenAddr_ = maybeListenAddr.value();
+  // shutdown() resets the fd of listenSocket_, but wakes up poll() on it
+  listenThread_ = std::thread{
+      [this, listenFd = listenSocket_.getFd()]() { acceptLoop(listenFd); }};
+  CLOGF_SUBSYS(
+      INFO,
+      INIT,
+      "CTRAN-BOOTSTRAP: Started listener {} on {} ifname {}",
+      (void*)this,
+      listenAddr_.describe(),
+      ifName);
+}
+
+SharedListener::~SharedListener() {
+  listenSocket_.shutdown();
+  listenThread_.join();
+  for (auto& [key, entry] : *entries_.wlock()) {
+    stop(entry);
+  }
+  CLOGF_SUBSYS(
+      INFO,
+      INIT,
+      "CTRAN-BOOTSTRAP: Stopped listener {} on {}",
+      (void*)this,
+      listenAddr_.describe());
+}
+
+bool SharedListener::registerHandler(const Key& key, Handler handler) {
+  auto entry = std::make_shared<Entry>();
+  entry->handler = std::move(handler);
+  return entries_.wlock()->emplace(key, std::move(entry)).second;
+}
+
+void SharedListener::unregisterHandler(const Key& key) {
+  std::shared_ptr<Entry> entry;
+  {
+    auto locked = entries_.wlock();
+    auto it = locked->find(key);
+    if (it == locked->end()) {
+      return;
+    }
+    entry = std::move(it->second);
+    locked->erase(it);
+  }
+  // The accept thread may have looked the entry up right before it was
+  // erased, it finds it inactive
+  stop(entry);
+}
+
+void SharedListener::stop(const std::shared_ptr<Entry>& entry) {
+  std::deque<Pending> pending;
+  std::thread worker;
+  {
+    std::lock_guard lock(entry->mutex);
+    entry->active = false;
+    pending.swap(entry->pending);
+    worker = std::move(entry->worker);
+  }
+  // Wait for a running handler
+  if (worker.joinable()) {
+    worker.join();
+  }
+}
+
+void SharedListener::acceptLoop(const int listenFd) {
+  commNamedThreadStart("CTranListen");
+  const auto preambleTimeout =
+      std::chrono::milliseconds(NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT);
+  std::vector<Incoming> incoming;
+  std::vector<struct pollfd> pfds;
+  while (1) {
+    // Wait for a new connection, more of a preamble, or the first deadline
+    pfds.assign(1, {.fd = listenFd, .events = POLLIN, .revents = 0});
+    auto now = std::chrono::steady_clock::now();
+    int timeoutMs = -1;
+    for (const auto& conn : incoming) {
+      pfds.push_back(
+          {.fd = conn.socket.getFd(), .events = POLLIN, .revents = 0});
+      const auto left = std::chrono::ceil<std::chrono::milliseconds>(
+          conn.deadline - now);
+      const int leftMs = std::max<int>(left.count(), 0);
+      timeoutMs = timeoutMs < 0 ? leftMs : std::min(timeoutMs, leftMs);
+    }
+    if (::poll(pfds.data(), pfds.size(), timeoutMs) < 0 && errno != EINTR) {
+      FB_SYSCHECKTHROW(errno);
+    }
+    if (listenSocket_.hasShutDown()) {
+      break; // listen socket is closed
+    }
+
+    // Peers send the preamble right after connecting. Read what has arrived
+    // of each without blocking, and give up on those past their deadline.
+    now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < incoming.size(); i++) {
+      auto& conn = incoming[i];
+      int err = 0;
+      if (pfds[i + 1].revents) {
+        const ssize_t n = ::recv(
+            conn.socket.getFd(),
+            reinterpret_cast<char*>(&conn.preamble) + conn.received,
+            sizeof(conn.preamble) - conn.received,
+            MSG_DONTWAIT);
+        if (n > 0) {
+          conn.received += n;
+        } else if (n == 0) {
+          err = ECONNRESET;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+          err = errno;
+        }
+      }
+      const bool complete = conn.received == sizeof(conn.preamble);
+      if (!err && !complete && now >= conn.deadline) {
+        err = ETIMEDOUT;
+      }
+      if (!err && !complete) {
+        continue;
+      }
+      conn.done = true;
+      if (err || conn.preamble.magic != kPreambleMagic) {
+        CLOGF(
+            WARN,
+            "CTRAN-BOOTSTRAP: Invalid preamble from {} on {} (err {}, magic {:x}). "
+            "Likely unexpected connection attempt. Ignoring.",
+            conn.socket.getPeerAddress().describe(),
+            listenAddr_.describe(),
+            err,
+            conn.preamble.magic);
+      } else {
+        dispatch(
+            std::move(conn.socket),
+            Key{.commHash = conn.preamble.commHash,
+                .backend = static_cast<Backend>(conn.preamble.backend),
+                .rank = conn.preamble.rank},
+            conn.preamble.peerRank);
+      }
+    }
+    std::erase_if(incoming, [](const Incoming& conn) { return conn.done; });
+
+    if (pfds[0].revents) {
+      auto maybeSocket = listenSocket_.accept();
+      if (maybeSocket.hasError()) {
+        if (listenSocket_.hasShutDown()) {
+          break; // listen socket is closed
+        }
+        FB_SYSCHECKTHROW(maybeSocket.error());
+      }
+      incoming.push_back(
+          Incoming{
+              .socket = std::move(maybeSocket.value()),
+              .deadline = std::chrono::steady_clock::now() + preambleTimeout});
+    }
+  }
+  CLOGF_SUBSYS(
+      INFO,
+      INIT,
+      "CTRAN-BOOTSTRAP: Listen thread terminating for {}",
+      listenAddr_.describe());
+}
+
+void SharedListener::dispatch(Socket socket, const Key& key, int peerRank) {
+  std::shared_ptr<Entry> entry;
+  {
+    auto locked = entries_.rlock();
+    auto it = locked->find(key);
+    if (it != locked->end()) {
+      entry = it->second;
+    }
+  }
+  std::unique_lock<std::mutex> lock;
+  if (entry) {
+    lock = std::unique_lock(entry->mutex);
+  }
+  if (!entry || !entry->active) {
+    CLOGF(
+        WARN,
+        "CTRAN-BOOTSTRAP: No handler for commHash {:x} backend {} rank {}, "
+        "closing connection from peer {} at {}",
+        key.commHash,
+        static_cast<int32_t>(key.backend),
+        key.rank,
+        peerRank,
+        socket.getPeerAddress().describe());
+    return;
+  }
+
+  entry->pending.push_back(Pending{std::move(socket), peerRank});
+  if (entry->workerRunning) {
+    return;
+  }
+  // A previous worker has handled its last connection and is exiting
+  std::thread previous = std::move(entry->worker);
+  entry->workerRunning = true;
+  entry->worker = std::thread{[key, entry]() { runHandlers(key, entry); }};
+  lock.unlock();
+  if (previous.joinable()) {
+    previous.join();
+  }
+}
+
+void SharedListener::runHandlers(Key key, std::shared_ptr<Entry> entry) {
+  commNamedThreadStart("CTranListenHandler");
+  std::unique_lock lock(entry->mutex);
+  while (entry->active && !entry->pending.empty()) {
+    Pending pending = std::move(entry->pending.front());
+    entry->pending.pop_front();
+    lock.unlock();
+
+    // A failing handshake fails the communicator it is for, as its own listen
+    // thread did, but must not take down the listener of the others
+    commResult_t res;
+    try {
+      res = entry->handler(std::move(pending.socket), pending.peerRank);
+    } catch (const std::exception& e) {
+      CLOGF(ERR, "CTRAN-BOOTSTRAP: Handler threw: {}", e.what());
+      res = commInternalError;
+    }
+    if (res != commSuccess) {
+      CLOGF(
+          ERR,
+          "CTRAN-BOOTSTRAP: Failed to accept connection for commHash {:x} "
+          "backend {} rank {} from peer {}: {}",
+          key.commHash,
+          static_cast<int32_t>(key.backend),
+          key.rank,
+          pending.peerRank,
+          res);
+    }
+    lock.lock();
+  }
+  entry->workerRunning = false;
+}
+
+} // namespace ctran::bootstrap
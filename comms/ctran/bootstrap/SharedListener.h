@@ -0,0 +1,152 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+
+#include <folly/SocketAddress.h>
+#include <folly/Synchronized.h>
+
+#include "comms/ctran/bootstrap/Socket.h"
+#include "comms/utils/commSpecs.h"
+
+namespace ctran::bootstrap {
+
+/**
+ * Listening socket and accept thread shared by the backends of all
+ * communicators of a process, instead of one of each per backend and
+ * communicator. Connections start with a preamble naming the communicator,
+ * backend and rank they are for, and are handed to the handler registered
+ * for those. The accept thread polls the listening socket together with
+ * the connections whose preamble has not all arrived, so it never waits on a
+ * peer; connections still without one after
+ * NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT are closed. Handlers run on a
+ * worker thread of their key.
+ */
+class SharedListener {
+ public:
+  enum class Backend : int32_t { kIb = 0, kSocket = 1, kTcpDm = 2 };
+
+  struct Key {
+    uint64_t commHash;
+    Backend backend;
+    int rank;
+
+    bool operator<(const Key& other) const {
+      return std::tie(commHash, backend, rank) <
+          std::tie(other.commHash, other.backend, other.rank);
+    }
+  };
+
+  /*
+   * Called with a connection from peerRank, blocking and past the preamble.
+   * The connections of a key are handled one at a time, in the order they
+   * arrived, on a worker thread started for them that exits once they are
+   * all handled. Handlers of different keys run concurrently.
+   */
+  using Handler = std::function<commResult_t(Socket socket, int peerRank)>;
+
+  /*
+   * Listener of the process on addr (with port 0) and ifName, started on
+   * first use and stopped once the last owner releases it.
+   */
+  static std::shared_ptr<SharedListener> get(
+      const folly::SocketAddress& addr,
+      const std::string& ifName);
+
+  /*
+   * Listener owned by the caller alone, for when the key is already
+   * registered on the shared one or sharing is disabled.
+   */
+  static std::shared_ptr<SharedListener> create(
+      const folly::SocketAddress& addr,
+      const std::string& ifName);
+
+  /*
+   * Listener on addr and ifName with handler registered for key: the shared
+   * one if NCCL_CTRAN_SHARED_LISTENER is set and key is free on it, else one
+   * owned by the caller. Call unregisterHandler(key) before releasing it.
+   */
+  static std::shared_ptr<SharedListener> acquire(
+      const folly::SocketAddress& addr,
+      const std::string& ifName,
+      const Key& key,
+      Handler handler);
+
+  /*
+   * Connect to a listener and send the preamble for key, from peerRank.
+   * Returns 0 on success or errno, as Socket does.
+   */
+  static int connect(
+      Socket& sock,
+      const folly::SocketAddress& addr,
+      const std::string& ifName,
+      const Key& key,
+      int peerRank);
+
+  SharedListener(const folly::SocketAddress& addr, const std::string& ifName);
+  ~SharedListener();
+
+  SharedListener(const SharedListener&) = delete;
+  SharedListener& operator=(const SharedListener&) = delete;
+
+  folly::SocketAddress getListenAddress() const {
+    return listenAddr_;
+  }
+
+  /*
+   * Returns false if key already has a handler, e.g. when two communicators
+   * of the process have the same hash.
+   */
+  bool registerHandler(const Key& key, Handler handler);
+
+  /*
+   * Once this returns, the handler of key is not running and will not run
+   * again. Connections for it are closed. Must not be called from the
+   * handler.
+   */
+  void unregisterHandler(const Key& key);
+
+  size_t numHandlers() const {
+    return entries_.rlock()->size();
+  }
+
+ private:
+  struct Pending {
+    Socket socket;
+    int peerRank;
+  };
+
+  struct Entry {
+    std::mutex mutex;
+    Handler handler;
+    bool active{true};
+    // Connections not handled yet, and the worker handling them if running
+    std::deque<Pending> pending;
+    bool workerRunning{false};
+    std::thread worker;
+  };
+
+  void acceptLoop(const int listenFd);
+  // Hand a connection past its preamble to the worker of key
+  void dispatch(Socket socket, const Key& key, int peerRank);
+  // Worker of key: handles its pending connections until there are none
+  static void runHandlers(Key key, std::shared_ptr<Entry> entry);
+  // Deactivates entry, closes its pending connections and joins its worker
+  static void stop(const std::shared_ptr<Entry>& entry);
+
+  ServerSocket listenSocket_;
+  folly::SocketAddress listenAddr_;
+  std::thread listenThread_;
+  folly::Synchronized<std::map<Key, std::shared_ptr<Entry>>> entries_;
+};
+
+} // namespace ctran::bootstrap
@@ -232,6 +232,18 @@ void Socket::prepareSocket(bool async) {
   }
 }
 
+int Socket::setAsync(bool async) {
+  int flags = ::fcntl(fd_, F_GETFL, 0);
+  if (flags < 0) {
+    return errno;
+  }
+  flags = async ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+  if (::fcntl(fd_, F_SETFL, flags) < 0) {
+    return errno;
+  }
+  return 0;
+}
+
 int Socket::close() {
   if (fd_ >= 0) {
     if (::close(fd_) < 0) {
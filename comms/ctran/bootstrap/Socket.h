@@ -88,6 +88,12 @@ class Socket {
 
   int close();
 
+  /**
+   * Switch a connected socket to async or blocking mode. Returns 0 on success
+   * or errno
+   */
+  int setAsync(bool async);
+
   int getFd() const {
     return fd_;
   }
@@ -0,0 +1,328 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include <gtest/gtest.h>
+
+#include <folly/logging/xlog.h>
+#include <folly/synchronization/Baton.h>
+
+#include "comms/ctran/bootstrap/SharedListener.h"
+#include "comms/ctran/bootstrap/Socket.h"
+#include "comms/testinfra/TestUtils.h"
+#include "comms/utils/cvars/nccl_cvars.h"
+
+using namespace ::testing;
+using ctran::bootstrap::SharedListener;
+using ctran::bootstrap::Socket;
+
+namespace {
+
+constexpr int kNumComms = 64;
+constexpr int kNumRanks = 4;
+
+const folly::SocketAddress kLoAddr("::1", 0);
+const std::string kLoIfName = "lo";
+
+size_t numThreads() {
+  return std::distance(
+      std::filesystem::directory_iterator("/proc/self/task"),
+      std::filesystem::directory_iterator{});
+}
+
+SharedListener::Key commKey(int comm, int rank) {
+  return {0x1000 + static_cast<uint64_t>(comm),
+          SharedListener::Backend::kSocket,
+          rank};
+}
+
+// Every rank of every communicator in this process. Rank r accepts a
+// connection from each lower rank, as the backends do for peers connecting
+// to them, and records who connected.
+struct Comms {
+  std::vector<std::shared_ptr<SharedListener>> listeners;
+  std::vector<std::atomic<int>> connectedFrom =
+      std::vector<std::atomic<int>>(kNumComms * kNumRanks);
+
+  void init() {
+    for (int c = 0; c < kNumComms; c++) {
+      for (int r = 0; r < kNumRanks; r++) {
+        listeners.push_back(SharedListener::acquire(
+            kLoAddr,
+            kLoIfName,
+            commKey(c, r),
+            [this, c, r](Socket socket, int peerRank) {
+              // Handshake with the peer, as the backends exchange their
+              // connection details
+              int key = 0;
+              EXPECT_EQ(socket.recv(&key, sizeof(key)), 0);
+              EXPECT_EQ(key, c * kNumRanks + peerRank);
+              connectedFrom[c * kNumRanks + r] |= 1 << peerRank;
+              EXPECT_EQ(socket.send(&r, sizeof(r)), 0);
+              return commSuccess;
+            }));
+      }
+    }
+  }
+
+  void connectAll() {
+    std::vector<std::thread> threads;
+    for (int c = 0; c < kNumComms; c++) {
+      threads.emplace_back([this, c]() {
+        for (int r = 0; r < kNumRanks; r++) {
+          for (int peer = r + 1; peer < kNumRanks; peer++) {
+            Socket sock;
+            ASSERT_EQ(
+                SharedListener::connect(
+                    sock,
+                    listeners[c * kNumRanks + peer]->getListenAddress(),
+                    kLoIfName,
+                    commKey(c, peer),
+                    r),
+                0);
+            const int key = c * kNumRanks + r;
+            ASSERT_EQ(sock.send(&key, sizeof(key)), 0);
+            int peerRank = -1;
+            ASSERT_EQ(sock.recv(&peerRank, sizeof(peerRank)), 0);
+            EXPECT_EQ(peerRank, peer);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void destroy() {
+    for (int c = 0; c < kNumComms; c++) {
+      for (int r = 0; r < kNumRanks; r++) {
+        listeners[c * kNumRanks + r]->unregisterHandler(commKey(c, r));
+      }
+    }
+    listeners.clear();
+  }
+};
+
+} // namespace
+
+class SharedListenerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ncclCvarInit();
+  }
+};
+
+TEST_F(SharedListenerTest, ManyCommunicatorsOneThread) {
+  for (bool shared : {false, true}) {
+    EnvRAII sharedGuard(NCCL_CTRAN_SHARED_LISTENER, shared);
+    const size_t threadsBefore = numThreads();
+    const auto start = std::chrono::steady_clock::now();
+    Comms comms;
+    comms.init();
+    const auto initTime = std::chrono::steady_clock::now() - start;
+    const size_t listenThreads = numThreads() - threadsBefore;
+    EXPECT_EQ(listenThreads, shared ? 1 : kNumComms * kNumRanks);
+    if (shared) {
+      EXPECT_EQ(comms.listeners[0]->numHandlers(), kNumComms * kNumRanks);
+    }
+
+    comms.connectAll();
+    for (int c = 0; c < kNumComms; c++) {
+      for (int r = 0; r < kNumRanks; r++) {
+        EXPECT_EQ(comms.connectedFrom[c * kNumRanks + r], (1 << r) - 1)
+            << "comm " << c << " rank " << r;
+      }
+    }
+    XLOG(INFO) << (shared ? "Shared" : "Per-communicator") << " listeners for "
+               << kNumComms << " communicators x " << kNumRanks << " ranks: "
+               << listenThreads << " threads, init "
+               << std::chrono::duration_cast<std::chrono::microseconds>(
+                      initTime)
+                      .count()
+               << " us";
+
+    comms.destroy();
+    EXPECT_EQ(numThreads(), threadsBefore);
+  }
+}
+
+TEST_F(SharedListenerTest, DuplicateKeyGetsOwnListener) {
+  EnvRAII sharedGuard(NCCL_CTRAN_SHARED_LISTENER, true);
+  auto handler = [](Socket, int) { return commSuccess; };
+  auto first =
+      SharedListener::acquire(kLoAddr, kLoIfName, commKey(0, 0), handler);
+  auto second =
+      SharedListener::acquire(kLoAddr, kLoIfName, commKey(0, 0), handler);
+  auto other =
+      SharedListener::acquire(kLoAddr, kLoIfName, commKey(0, 1), handler);
+  EXPECT_NE(first, second);
+  EXPECT_NE(first->getListenAddress(), second->getListenAddress());
+  EXPECT_EQ(first, other);
+  first->unregisterHandler(commKey(0, 0));
+  second->unregisterHandler(commKey(0, 0));
+  other->unregisterHandler(commKey(0, 1));
+}
+
+TEST_F(SharedListenerTest, ClosesConnectionsWithoutHandler) {
+  std::atomic<int> handled{0};
+  auto listener = SharedListener::create(kLoAddr, kLoIfName);
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(0, 0), [&](Socket socket, int) {
+        handled++;
+        return commSuccess;
+      }));
+
+  // Unknown communicator, and a connection which is not ours at all
+  Socket unknown;
+  ASSERT_EQ(
+      SharedListener::connect(
+          unknown,
+          listener->getListenAddress(),
+          kLoIfName,
+          commKey(1, 0),
+          1),
+      0);
+  char buf;
+  EXPECT_EQ(::recv(unknown.getFd(), &buf, sizeof(buf), 0), 0);
+
+  Socket stranger;
+  ASSERT_EQ(stranger.connect(listener->getListenAddress(), kLoIfName), 0);
+  const uint64_t garbage[4] = {};
+  ASSERT_EQ(stranger.send(garbage, sizeof(garbage)), 0);
+  EXPECT_EQ(::recv(stranger.getFd(), &buf, sizeof(buf), 0), 0);
+
+  // The listener still serves its communicators
+  Socket sock;
+  ASSERT_EQ(
+      SharedListener::connect(
+          sock, listener->getListenAddress(), kLoIfName, commKey(0, 0), 1),
+      0);
+  EXPECT_EQ(::recv(sock.getFd(), &buf, sizeof(buf), 0), 0);
+  EXPECT_EQ(handled, 1);
+  listener->unregisterHandler(commKey(0, 0));
+}
+
+TEST_F(SharedListenerTest, UnregisterWaitsForHandler) {
+  folly::Baton<> inHandler, release;
+  std::atomic<bool> handlerDone{false};
+  auto listener = SharedListener::create(kLoAddr, kLoIfName);
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(0, 0), [&](Socket socket, int) {
+        inHandler.post();
+        release.wait();
+        handlerDone = true;
+        return commSuccess;
+      }));
+
+  Socket sock;
+  ASSERT_EQ(
+      SharedListener::connect(
+          sock, listener->getListenAddress(), kLoIfName, commKey(0, 0), 1),
+      0);
+  inHandler.wait();
+
+  std::atomic<bool> unregistered{false};
+  std::thread destroyer([&]() {
+    listener->unregisterHandler(commKey(0, 0));
+    unregistered = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(unregistered);
+  release.post();
+  destroyer.join();
+  EXPECT_TRUE(handlerDone);
+  EXPECT_EQ(listener->numHandlers(), 0);
+}
+
+TEST_F(SharedListenerTest, SilentConnectionTimesOut) {
+  EnvRAII timeoutGuard(NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT, 200);
+  folly::Baton<> handled;
+  auto listener = SharedListener::create(kLoAddr, kLoIfName);
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(0, 0), [&](Socket socket, int) {
+        handled.post();
+        return commSuccess;
+      }));
+
+  // Never sends a preamble, the listener gives up on it
+  Socket silent;
+  ASSERT_EQ(silent.connect(listener->getListenAddress(), kLoIfName), 0);
+  Socket sock;
+  ASSERT_EQ(
+      SharedListener::connect(
+          sock, listener->getListenAddress(), kLoIfName, commKey(0, 0), 1),
+      0);
+  EXPECT_TRUE(handled.try_wait_for(std::chrono::seconds(10)));
+  char buf;
+  EXPECT_EQ(::recv(silent.getFd(), &buf, sizeof(buf), 0), 0);
+  listener->unregisterHandler(commKey(0, 0));
+}
+
+TEST_F(SharedListenerTest, SilentConnectionsDoNotDelayAccepts) {
+  EnvRAII timeoutGuard(NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT, 60000);
+  folly::Baton<> handled;
+  auto listener = SharedListener::create(kLoAddr, kLoIfName);
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(0, 0), [&](Socket socket, int) {
+        handled.post();
+        return commSuccess;
+      }));
+
+  // Connections which never send a preamble, or only part of it, are waited
+  // for while the listener keeps accepting
+  std::vector<Socket> silent(4);
+  for (auto& sock : silent) {
+    ASSERT_EQ(sock.connect(listener->getListenAddress(), kLoIfName), 0);
+  }
+  const uint32_t partial = 0;
+  ASSERT_EQ(silent.back().send(&partial, sizeof(partial)), 0);
+
+  Socket sock;
+  ASSERT_EQ(
+      SharedListener::connect(
+          sock, listener->getListenAddress(), kLoIfName, commKey(0, 0), 1),
+      0);
+  EXPECT_TRUE(handled.try_wait_for(std::chrono::seconds(10)));
+  listener->unregisterHandler(commKey(0, 0));
+}
+
+TEST_F(SharedListenerTest, BlockedHandlerDoesNotBlockOtherKeys) {
+  folly::Baton<> inHandler, release, otherHandled;
+  auto listener = SharedListener::create(kLoAddr, kLoIfName);
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(0, 0), [&](Socket socket, int) {
+        inHandler.post();
+        release.wait();
+        return commSuccess;
+      }));
+  ASSERT_TRUE(
+      listener->registerHandler(commKey(1, 0), [&](Socket socket, int) {
+        otherHandled.post();
+        return commSuccess;
+      }));
+
+  Socket blocked;
+  ASSERT_EQ(
+      SharedListener::connect(
+          blocked, listener->getListenAddress(), kLoIfName, commKey(0, 0), 1),
+      0);
+  inHandler.wait();
+
+  Socket other;
+  ASSERT_EQ(
+      SharedListener::connect(
+          other, listener->getListenAddress(), kLoIfName, commKey(1, 0), 1),
+      0);
+  EXPECT_TRUE(otherHandled.try_wait_for(std::chrono::seconds(10)));
+
+  release.post();
+  listener->unregisterHandler(commKey(0, 0));
+  listener->unregisterHandler(commKey(1, 0));
+}
@@ -64,6 +64,12 @@ OpElem::OpElem(OpElem* op) {
     this->alltoall_dedup.sdispls = op->alltoall_dedup.sdispls;
     this->alltoall_dedup.recvcounts = op->alltoall_dedup.recvcounts;
     this->alltoall_dedup.rdispls = op->alltoall_dedup.rdispls;
+    new (&this->alltoall_dedup.routeCache)
+        std::shared_ptr<ctran::alltoalldedup::RouteCache>(
+            op->alltoall_dedup.routeCache);
+    new (&this->alltoall_dedup.routePlan)
+        std::shared_ptr<const ctran::alltoalldedup::RoutePlan>(
+            op->alltoall_dedup.routePlan);
   } else if (op->type == ALLTOALLV_DYNAMIC_SPLIT_NON_CONTIG) {
     this->alltoallv_dynamic.sendbuffs = op->alltoallv_dynamic.sendbuffs;
     this->alltoallv_dynamic.recvbuffs = op->alltoallv_dynamic.recvbuffs;
@@ -116,6 +122,10 @@ OpElem::OpElem(
       this->alltoall_dedup.remoteAccessKeys.resize(comm_->statex_->nRanks());
       new (&this->alltoall_dedup.bcastElemMap)
           std::unordered_map<int, KernelElem*>;
+      new (&this->alltoall_dedup.routeCache)
+          std::shared_ptr<ctran::alltoalldedup::RouteCache>;
+      new (&this->alltoall_dedup.routePlan)
+          std::shared_ptr<const ctran::alltoalldedup::RoutePlan>;
       break;
     case ALLGATHER:
       this->allgather.bcastElem = nullptr;
@@ -163,6 +173,8 @@ OpElem::~OpElem() {
         }
       }
       this->alltoall_dedup.bcastElemMap.~unordered_map();
+      this->alltoall_dedup.routeCache.~shared_ptr();
+      this->alltoall_dedup.routePlan.~shared_ptr();
       break;
     case ALLGATHER:
       if (this->allgather.bcastElem) {
@@ -22,6 +22,11 @@ typedef commResult_t (*opFunc)(
     const std::vector<std::unique_ptr<struct OpElem>>& opGroup);
 
 namespace ctran {
+namespace alltoalldedup {
+class RouteCache;
+struct RoutePlan;
+} // namespace alltoalldedup
+
 using PersistentObj = std::variant<
     std::monostate,
     std::unique_ptr<alltoallp::AlgoImpl>,
@@ -170,6 +175,10 @@ struct OpElem {
       void* recvHdl;
       std::vector<void*> remoteRecvBuffs;
       std::vector<struct CtranMapperRemoteAccessKey> remoteAccessKeys;
+      // Routing metadata cache owned by the persistent request, and the plan
+      // snapshot a submitted exec runs with.
+      std::shared_ptr<ctran::alltoalldedup::RouteCache> routeCache;
+      std::shared_ptr<const ctran::alltoalldedup::RoutePlan> routePlan;
     } alltoall_dedup;
     struct {
       // reference to pre-initialized algo resource
@@ -163,6 +163,16 @@ CtranMapper::CtranMapper(CtranComm* comm) {
 
   this->rank = statex->rank();
 
+  if (NCCL_CTRAN_PRECONNECT_WARMUP) {
+    std::unordered_set<int> remotePeers;
+    for (int peer = 0; peer < statex->nRanks(); peer++) {
+      if (!statex->isSameNode(this->rank, peer)) {
+        remotePeers.insert(peer);
+      }
+    }
+    FB_COMMCHECKTHROW(warmup(remotePeers));
+  }
+
   return;
 }
 
@@ -358,6 +368,9 @@ CtranMapper::~CtranMapper() {
   // Mark again for sure
   setAtDestruction();
 
+  // Stop connecting before tearing anything down
+  this->warmup_.reset();
+
   this->reportProfiling(true);
 
   // Release any pending CB_CTRL requests;
@@ -724,6 +737,55 @@ commResult_t CtranMapper::preConnect(const std::unordered_set<int>& peerRanks) {
   return commSuccess;
 }
 
+commResult_t CtranMapper::warmup(const std::unordered_set<int>& peerRanks) {
+  // TCPDM connects only through preConnect()
+  if (this->warmup_ != nullptr ||
+      (this->ctranIb == nullptr && this->ctranSock == nullptr)) {
+    return commSuccess;
+  }
+
+  const auto statex = comm->statex_.get();
+  const int myRank = statex->rank();
+  // Backends connect to larger ranks; smaller ranks connect to us
+  std::vector<int> activePeers;
+  for (int peer : peerRanks) {
+    if (peer < 0 || peer >= statex->nRanks()) {
+      CLOGF(
+          ERR,
+          "CTRAN-MAPPER: invalid warm-up peer {} in communicator of {} ranks",
+          peer,
+          statex->nRanks());
+      return commInvalidArgument;
+    }
+    if (peer > myRank) {
+      activePeers.push_back(peer);
+    }
+  }
+
+  using Tier = ctran::CtranWarmup::Tier;
+  auto orderedPeers = ctran::CtranWarmup::order(
+      myRank, statex->nRanks(), activePeers, [&](int peer) {
+        if (statex->isSameRack(myRank, peer)) {
+          return Tier::kRack;
+        }
+        return statex->isSameZone(myRank, peer) ? Tier::kZone : Tier::kRemote;
+      });
+
+  this->warmup_ = std::make_unique<ctran::CtranWarmup>(
+      myRank,
+      statex->commHash(),
+      statex->commDesc(),
+      [this](int peer) {
+        if (this->ctranIb != nullptr) {
+          return this->ctranIb->connectPeer(peer);
+        }
+        return this->ctranSock->connectPeer(peer);
+      },
+      NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT);
+  this->warmup_->start(std::move(orderedPeers));
+  return commSuccess;
+}
+
 CtranMapperBackend CtranMapper::getBackend(int rank) {
   if (this->ctranNvl && this->ctranNvl->isSupported(rank)) {
     return CtranMapperBackend::NVL;
@@ -17,6 +17,7 @@
 #include "comms/ctran/mapper/CtranMapperImpl.h"
 #include "comms/ctran/mapper/CtranMapperRegMem.h"
 #include "comms/ctran/mapper/CtranMapperTypes.h"
+#include "comms/ctran/mapper/CtranWarmup.h"
 #include "comms/ctran/profiler/Profiler.h"
 #include "comms/ctran/tracing/MapperTrace.h"
 #include "comms/ctran/utils/Checks.h"
@@ -160,6 +161,16 @@ class CtranMapper {
    */
   commResult_t preConnect(const std::unordered_set<int>& peerRanks);
 
+  /* Connect to peers on the associated backend in the background, nearest
+   * peers first, so that the collectives using them later do not wait for
+   * the connections. Only the first call per communicator starts a warm-up.
+   * preConnect() and collectives may run meanwhile; a peer being connected in
+   * the background is waited for, not connected twice.
+   * Input arguments:
+   *   - peerRanks: the ranks of the peers expected to be communicated with
+   */
+  commResult_t warmup(const std::unordered_set<int>& peerRanks);
+
   /* Post a send control op to associated backend.
    * Input arguments:
    *   - buf: the local buffer to be remotely accessed by future iput from the
@@ -1895,6 +1906,8 @@ class CtranMapper {
   std::unique_ptr<class CtranSocket> ctranSock{nullptr};
   std::unique_ptr<class ctran::CtranTcpDm> ctranTcpDm{nullptr};
   std::unique_ptr<class CtranCtrlManager> ctrlMgr{nullptr};
+  // Background connects started by warmup()
+  std::unique_ptr<ctran::CtranWarmup> warmup_{nullptr};
   std::vector<enum CtranMapperBackend> rankBackendMap;
   std::vector<enum CtranMapperBackend> backends;
 
@@ -0,0 +1,123 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "comms/ctran/mapper/CtranWarmup.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "comms/ctran/utils/Debug.h"
+#include "comms/utils/Conversion.h"
+#include "comms/utils/logger/LogUtils.h"
+
+namespace ctran {
+
+std::vector<int> CtranWarmup::order(
+    int rank,
+    int nRanks,
+    const std::vector<int>& peerRanks,
+    const std::function<Tier(int peerRank)>& tier) {
+  std::vector<std::tuple<Tier, int, int>> keyed;
+  keyed.reserve(peerRanks.size());
+  for (int peer : peerRanks) {
+    keyed.emplace_back(tier(peer), (peer - rank + nRanks) % nRanks, peer);
+  }
+  std::sort(keyed.begin(), keyed.end());
+
+  std::vector<int> ordered;
+  ordered.reserve(keyed.size());
+  for (const auto& [_, distance, peer] : keyed) {
+    ordered.push_back(peer);
+  }
+  return ordered;
+}
+
+CtranWarmup::CtranWarmup(
+    int rank,
+    uint64_t commHash,
+    const std::string& commDesc,
+    ConnectFn connect,
+    int maxInflight)
+    : rank_(rank),
+      commHash_(commHash),
+      commDesc_(commDesc),
+      connect_(std::move(connect)),
+      maxInflight_(std::max(maxInflight, 1)) {}
+
+CtranWarmup::~CtranWarmup() {
+  stop_ = true;
+  wait();
+}
+
+void CtranWarmup::start(std::vector<int> peerRanks) {
+  peerRanks_ = std::move(peerRanks);
+  startTime_ = std::chrono::steady_clock::now();
+  const int nThreads =
+      std::min(maxInflight_, static_cast<int>(peerRanks_.size()));
+  nRunning_ = nThreads;
+  for (int i = 0; i < nThreads; i++) {
+    threads_.emplace_back([this]() { worker(); });
+  }
+  CLOGF_SUBSYS(
+      INFO,
+      INIT,
+      "CTRAN-WARMUP: rank {} connecting to {} peers, {} at a time",
+      rank_,
+      peerRanks_.size(),
+      nThreads);
+}
+
+commResult_t CtranWarmup::wait() {
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  std::lock_guard<std::mutex> lock(resultMutex_);
+  return result_;
+}
+
+void CtranWarmup::worker() {
+  commNamedThreadStart("CTranWarmup", rank_, commHash_, commDesc_, __func__);
+  while (!stop_) {
+    const size_t idx = next_++;
+    if (idx >= peerRanks_.size()) {
+      break;
+    }
+    const int peer = peerRanks_[idx];
+    const commResult_t res = connect_(peer);
+    if (res != commSuccess) {
+      CLOGF(
+          WARN,
+          "CTRAN-WARMUP: rank {} failed to connect to peer {}: {}, skipping the remaining peers",
+          rank_,
+          peer,
+          ::meta::comms::commCodeToString(res));
+      {
+        std::lock_guard<std::mutex> lock(resultMutex_);
+        if (result_ == commSuccess) {
+          result_ = res;
+        }
+      }
+      stop_ = true;
+      break;
+    }
+    nConnected_++;
+  }
+
+  // The last worker out records how long the warm-up took
+  if (--nRunning_ == 0) {
+    durationUs_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - startTime_)
+                      .count();
+    CLOGF_SUBSYS(
+        INFO,
+        INIT,
+        "CTRAN-WARMUP: rank {} connected to {} of {} peers in {} us",
+        rank_,
+        nConnected_.load(),
+        peerRanks_.size(),
+        durationUs_.load());
+  }
+}
+
+} // namespace ctran
@@ -0,0 +1,95 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "comms/utils/commSpecs.h"
+
+namespace ctran {
+
+/**
+ * Connects to a set of peers in the background, ahead of the collectives
+ * that need them, so that the first collective finds its connections ready
+ * instead of establishing them one handshake at a time. Up to maxInflight
+ * connects are in flight at once.
+ *
+ * connect(peer) is called from the warm-up threads, concurrently for
+ * different peers. It must be safe to call while the communicator connects
+ * to the same peer on its own, e.g. in preConnect() or for a control message;
+ * CtranIb::connectPeer() and CtranSocket::connectPeer() serialize connects
+ * per peer for that.
+ */
+class CtranWarmup {
+ public:
+  using ConnectFn = std::function<commResult_t(int peerRank)>;
+
+  // Where a peer is relative to this rank, nearest first
+  enum class Tier { kRack = 0, kZone = 1, kRemote = 2 };
+
+  /* Order to connect to peers in: the ones in the same rack first, then the
+   * same zone, then the rest. Within a tier, by distance (peer - rank) mod
+   * nRanks, the order ring and AllToAll algorithms reach peers in; it also
+   * keeps ranks from all connecting to the same peer first.
+   */
+  static std::vector<int> order(
+      int rank,
+      int nRanks,
+      const std::vector<int>& peerRanks,
+      const std::function<Tier(int peerRank)>& tier);
+
+  CtranWarmup(
+      int rank,
+      uint64_t commHash,
+      const std::string& commDesc,
+      ConnectFn connect,
+      int maxInflight);
+  // Skips the peers not connected yet and waits for the connects in flight
+  ~CtranWarmup();
+
+  // Starts connecting to peerRanks, in that order. Called once.
+  void start(std::vector<int> peerRanks);
+
+  // Waits for all connects and returns the first error, if any
+  commResult_t wait();
+
+  size_t nConnected() const {
+    return nConnected_.load();
+  }
+
+  // From start() until the last connect finished; zero until then
+  std::chrono::microseconds duration() const {
+    return std::chrono::microseconds(durationUs_.load());
+  }
+
+ private:
+  void worker();
+
+  const int rank_;
+  const uint64_t commHash_;
+  const std::string commDesc_;
+  const ConnectFn connect_;
+  const int maxInflight_;
+
+  std::vector<int> peerRanks_;
+  // Index in peerRanks_ of the next peer to connect to
+  std::atomic<size_t> next_{0};
+  std::atomic<size_t> nConnected_{0};
+  std::atomic<int> nRunning_{0};
+  std::atomic<bool> stop_{false};
+  std::chrono::steady_clock::time_point startTime_;
+  std::atomic<int64_t> durationUs_{0};
+
+  std::mutex resultMutex_;
+  commResult_t result_{commSuccess};
+  std::vector<std::thread> threads_;
+};
+
+} // namespace ctran
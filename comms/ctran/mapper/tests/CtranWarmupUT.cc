@@ -0,0 +1,154 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "comms/ctran/mapper/CtranWarmup.h"
+#include "comms/utils/cvars/nccl_cvars.h"
+
+using ctran::CtranWarmup;
+using Tier = CtranWarmup::Tier;
+
+namespace {
+
+constexpr uint64_t kCommHash = 0xfeed;
+
+// Records the connects the warm-up makes
+struct FakeBackend {
+  commResult_t connect(int peer) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      maxInflight = std::max(maxInflight, ++inflight);
+    }
+    std::this_thread::sleep_for(delay);
+    std::lock_guard<std::mutex> lock(mutex);
+    inflight--;
+    connected.push_back(peer);
+    return peer == failingPeer ? commRemoteError : commSuccess;
+  }
+
+  CtranWarmup::ConnectFn connectFn() {
+    return [this](int peer) { return connect(peer); };
+  }
+
+  std::chrono::milliseconds delay{0};
+  int failingPeer{-1};
+  std::mutex mutex;
+  int inflight{0};
+  int maxInflight{0};
+  std::vector<int> connected;
+};
+
+std::vector<int> range(int begin, int end) {
+  std::vector<int> peers;
+  for (int peer = begin; peer < end; peer++) {
+    peers.push_back(peer);
+  }
+  return peers;
+}
+
+} // namespace
+
+class CtranWarmupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ncclCvarInit();
+  }
+};
+
+TEST_F(CtranWarmupTest, OrderByDistance) {
+  auto sameRack = [](int) { return Tier::kRack; };
+  EXPECT_EQ(
+      CtranWarmup::order(5, 8, {0, 1, 2, 3, 4, 6, 7}, sameRack),
+      std::vector<int>({6, 7, 0, 1, 2, 3, 4}));
+  EXPECT_EQ(
+      CtranWarmup::order(0, 8, {7, 3, 1}, sameRack),
+      std::vector<int>({1, 3, 7}));
+}
+
+TEST_F(CtranWarmupTest, OrderNearestTierFirst) {
+  // Racks of 4 ranks, zones of 2 racks
+  constexpr int kRank = 9;
+  auto tier = [](int peer) {
+    if (peer / 4 == kRank / 4) {
+      return Tier::kRack;
+    }
+    return peer / 8 == kRank / 8 ? Tier::kZone : Tier::kRemote;
+  };
+  EXPECT_EQ(
+      CtranWarmup::order(kRank, 16, range(10, 16), tier),
+      std::vector<int>({10, 11, 12, 13, 14, 15}));
+  EXPECT_EQ(
+      CtranWarmup::order(kRank, 16, {0, 3, 6, 8, 10, 14, 15}, tier),
+      std::vector<int>({10, 8, 14, 15, 0, 3, 6}));
+}
+
+TEST_F(CtranWarmupTest, ConnectsEveryPeerOnce) {
+  FakeBackend backend;
+  backend.delay = std::chrono::milliseconds(1);
+  const auto peers = range(1, 64);
+  CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 8);
+  warmup.start(peers);
+  EXPECT_EQ(warmup.wait(), commSuccess);
+
+  EXPECT_EQ(warmup.nConnected(), peers.size());
+  EXPECT_EQ(
+      std::multiset<int>(backend.connected.begin(), backend.connected.end()),
+      std::multiset<int>(peers.begin(), peers.end()));
+  EXPECT_GT(warmup.duration().count(), 0);
+}
+
+TEST_F(CtranWarmupTest, BoundedInflight) {
+  FakeBackend backend;
+  backend.delay = std::chrono::milliseconds(5);
+  CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 4);
+  warmup.start(range(1, 33));
+  EXPECT_EQ(warmup.wait(), commSuccess);
+
+  EXPECT_EQ(backend.connected.size(), 32);
+  EXPECT_LE(backend.maxInflight, 4);
+  EXPECT_GT(backend.maxInflight, 1);
+}
+
+TEST_F(CtranWarmupTest, InOrderWithOneInflight) {
+  FakeBackend backend;
+  const std::vector<int> peers = {7, 3, 5, 1};
+  CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 1);
+  warmup.start(peers);
+  EXPECT_EQ(warmup.wait(), commSuccess);
+  EXPECT_EQ(backend.connected, peers);
+}
+
+TEST_F(CtranWarmupTest, StopsOnError) {
+  FakeBackend backend;
+  backend.failingPeer = 3;
+  CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 1);
+  warmup.start(range(1, 8));
+  EXPECT_EQ(warmup.wait(), commRemoteError);
+  EXPECT_EQ(backend.connected, std::vector<int>({1, 2, 3}));
+  EXPECT_EQ(warmup.nConnected(), 2);
+}
+
+TEST_F(CtranWarmupTest, DestroyWhileConnecting) {
+  FakeBackend backend;
+  backend.delay = std::chrono::milliseconds(20);
+  {
+    CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 2);
+    warmup.start(range(1, 101));
+  }
+  // Only the connects in flight were finished
+  EXPECT_LT(backend.connected.size(), 100);
+}
+
+TEST_F(CtranWarmupTest, NoPeers) {
+  FakeBackend backend;
+  CtranWarmup warmup(0, kCommHash, "test", backend.connectFn(), 8);
+  warmup.start({});
+  EXPECT_EQ(warmup.wait(), commSuccess);
+  EXPECT_EQ(warmup.nConnected(), 0);
+}
@@ -0,0 +1,220 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/group/AsyncJobPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <system_error>
+#include <thread>
+
+#include "debug.h"
+
+#include "comms/utils/cvars/nccl_cvars.h"
+
+namespace ncclx::group {
+
+namespace {
+// Upper bound on how long the launching thread sleeps before re-checking the
+// group abort flag, which is raised by another thread without notification.
+constexpr std::chrono::microseconds kAbortPollInterval{1000};
+} // namespace
+
+void AsyncJobBatch::add(size_t numJobs) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_ += numJobs;
+}
+
+void AsyncJobBatch::markDone() {
+  // Notify while holding the lock: the waiter may destroy the batch as soon
+  // as it observes pending_ == 0.
+  std::lock_guard<std::mutex> lock(mutex_);
+  assert(pending_ > 0);
+  pending_--;
+  completions_++;
+  cv_.notify_all();
+}
+
+size_t AsyncJobBatch::waitForCompletion(std::chrono::microseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait_for(lock, timeout, [&] { return completions_ != observed_; });
+  observed_ = completions_;
+  return pending_;
+}
+
+AsyncJobPool::AsyncJobPool(size_t maxIdleWorkers)
+    : maxIdleWorkers_(maxIdleWorkers) {}
+
+AsyncJobPool::~AsyncJobPool() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stop_ = true;
+  cv_.notify_all();
+  exitCv_.wait(lock, [&] { return numWorkers_ == 0; });
+}
+
+AsyncJobPool& AsyncJobPool::getInstance() {
+  // Intentionally leaked: jobs may still be running from other static
+  // destructors at process exit.
+  static AsyncJobPool* pool = new AsyncJobPool(static_cast<size_t>(
+      std::max<int64_t>(NCCL_GROUP_ASYNC_JOB_POOL_SIZE, 0)));
+  return *pool;
+}
+
+ncclResult_t AsyncJobPool::submit(ncclAsyncJob* job, AsyncJobBatch* batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queue_.push_back(Task{job, batch});
+  // Every queued task must have a worker that can pick it up right away.
+  // Idle workers that were already notified but have not dequeued yet are
+  // still counted in numIdleWorkers_, and so are their tasks in queue_.
+  if (numIdleWorkers_ >= queue_.size()) {
+    cv_.notify_one();
+    return ncclSuccess;
+  }
+  numWorkers_++;
+  try {
+    startWorker();
+  } catch (const std::system_error& e) {
+    WARN("Failed to start async job worker: %s", e.what());
+    numWorkers_--;
+    queue_.pop_back();
+    return ncclSystemError;
+  }
+  return ncclSuccess;
+}
+
+void AsyncJobPool::startWorker() {
+  std::thread(&AsyncJobPool::workerFn, this).detach();
+}
+
+size_t AsyncJobPool::numWorkers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numWorkers_;
+}
+
+size_t AsyncJobPool::numIdleWorkers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return numIdleWorkers_;
+}
+
+void AsyncJobPool::workerFn() {
+  NCCL_NAMED_THREAD_START("AsyncJob");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    while (queue_.empty() && !stop_) {
+      if (numIdleWorkers_ >= maxIdleWorkers_) {
+        break;
+      }
+      numIdleWorkers_++;
+      cv_.wait(lock);
+      numIdleWorkers_--;
+    }
+    if (queue_.empty()) {
+      break;
+    }
+
+    Task task = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+
+    ncclAsyncJob* job = task.job;
+    job->result = job->func(job);
+    if (job->result != ncclSuccess) {
+      INFO(
+          NCCL_INIT,
+          "%s:%d -> %d [Async thread]",
+          __FILE__,
+          __LINE__,
+          job->result);
+    }
+    __atomic_store_n(&job->state, ncclGroupJobDone, __ATOMIC_RELEASE);
+    task.batch->markDone();
+
+    lock.lock();
+  }
+  numWorkers_--;
+  if (numWorkers_ == 0) {
+    exitCv_.notify_all();
+  }
+}
+
+bool asyncJobPoolEnabled() {
+  return NCCL_GROUP_ASYNC_JOB_POOL_SIZE > 0;
+}
+
+ncclResult_t asyncJobPoolLaunch(
+    AsyncJobPool& pool,
+    AsyncJobQueue* asyncJobs,
+    volatile bool* groupAbortFlag) {
+  ncclResult_t ret = ncclSuccess;
+  bool errorJobAbortFlag = false;
+
+  if (ncclIntruQueueEmpty(asyncJobs)) {
+    return ncclSuccess;
+  }
+
+  AsyncJobBatch batch;
+  size_t numJobs = 0;
+  for (auto job = ncclIntruQueueHead(asyncJobs); job != nullptr;
+       job = job->next) {
+    numJobs++;
+  }
+  batch.add(numJobs);
+  for (auto job = ncclIntruQueueHead(asyncJobs); job != nullptr;
+       job = job->next) {
+    if (pool.submit(job, &batch) == ncclSuccess) {
+      continue;
+    }
+    // Fail this job and skip the rest. The loop below then aborts the jobs
+    // already running and waits for them, which also keeps the batch alive
+    // until no worker references it.
+    for (; job != nullptr; job = job->next) {
+      job->result = ncclSystemError;
+      __atomic_store_n(&job->state, ncclGroupJobDone, __ATOMIC_RELEASE);
+      batch.markDone();
+    }
+    break;
+  }
+
+  size_t running = numJobs;
+  while (true) {
+    bool jobsDone = true;
+    for (auto job = ncclIntruQueueHead(asyncJobs); job != nullptr;
+         job = job->next) {
+      ncclGroupJobState_t state =
+          __atomic_load_n(&job->state, __ATOMIC_ACQUIRE);
+      if (state == ncclGroupJobRunning) {
+        jobsDone = false;
+      } else if (state == ncclGroupJobDone) {
+        job->state = ncclGroupJobJoined;
+        if (job->result != ncclSuccess && ret == ncclSuccess) {
+          ret = job->result;
+          errorJobAbortFlag = true;
+        }
+      } else {
+        /* safety check */
+        assert(state == ncclGroupJobJoined);
+      }
+
+      if (!job->destroyFlag &&
+          (__atomic_load_n(groupAbortFlag, __ATOMIC_ACQUIRE) ||
+           errorJobAbortFlag == true)) {
+        __atomic_store_n(job->abortFlag, 1, __ATOMIC_RELEASE);
+        __atomic_store_n(job->abortFlagDev, 1, __ATOMIC_RELEASE);
+        if (job->childAbortFlag) {
+          __atomic_store_n(job->childAbortFlag, 1, __ATOMIC_RELEASE);
+          __atomic_store_n(job->childAbortFlagDev, 1, __ATOMIC_RELEASE);
+        }
+      }
+    }
+
+    // A worker publishes the job state before signaling the batch, so keep
+    // waiting until every worker is done with the batch as well.
+    if (jobsDone && running == 0) {
+      break;
+    }
+    running = batch.waitForCompletion(kAbortPollInterval);
+  }
+
+  return ret;
+}
+
+} // namespace ncclx::group
@@ -0,0 +1,110 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+#include "group.h"
+#include "nccl.h"
+
+namespace ncclx::group {
+
+using AsyncJobQueue = ncclIntruQueue<ncclAsyncJob, &ncclAsyncJob::next>;
+
+// Completion tracker for a set of ncclAsyncJobs launched together. Workers
+// signal it after every job so the launching thread can collect results and
+// propagate aborts without busy polling.
+class AsyncJobBatch {
+ public:
+  AsyncJobBatch() = default;
+  AsyncJobBatch(const AsyncJobBatch&) = delete;
+  AsyncJobBatch& operator=(const AsyncJobBatch&) = delete;
+
+  void add(size_t numJobs);
+  // Called by a worker once the job state has been set to ncclGroupJobDone.
+  // The batch must not be accessed by the worker afterwards.
+  void markDone();
+  // Block until a job completes that has not been observed by a previous
+  // call, or until timeout expires. Returns the number of jobs still running.
+  size_t waitForCompletion(std::chrono::microseconds timeout);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  size_t pending_{0};
+  uint64_t completions_{0};
+  uint64_t observed_{0};
+};
+
+// Process-wide executor for group async jobs. It replaces the per-job
+// pthread_create/pthread_join in the group launch path with long-lived
+// workers.
+//
+// Jobs of the same group may block on each other (e.g., the bootstrap of
+// several ranks initialized by one thread), so a submitted job is never
+// queued behind another: if no idle worker is available a new one is
+// started. The bound only applies to the number of idle workers retained
+// after a burst, the remaining ones exit once they run out of work.
+class AsyncJobPool {
+ public:
+  explicit AsyncJobPool(size_t maxIdleWorkers);
+  virtual ~AsyncJobPool();
+  AsyncJobPool(const AsyncJobPool&) = delete;
+  AsyncJobPool& operator=(const AsyncJobPool&) = delete;
+
+  // Returns the shared pool sized by NCCL_GROUP_ASYNC_JOB_POOL_SIZE.
+  static AsyncJobPool& getInstance();
+
+  // Returns ncclSystemError, with the job not queued, if a worker was needed
+  // and could not be started.
+  ncclResult_t submit(ncclAsyncJob* job, AsyncJobBatch* batch);
+
+  size_t numWorkers() const;
+  size_t numIdleWorkers() const;
+
+ protected:
+  // Starts a detached thread running workerFn(); throws std::system_error
+  // if the thread cannot be created. Overridden by tests to inject failures.
+  virtual void startWorker();
+  void workerFn();
+
+ private:
+  struct Task {
+    ncclAsyncJob* job{nullptr};
+    AsyncJobBatch* batch{nullptr};
+  };
+
+  const size_t maxIdleWorkers_;
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable exitCv_;
+  std::deque<Task> queue_;
+  size_t numWorkers_{0};
+  size_t numIdleWorkers_{0};
+  bool stop_{false};
+};
+
+// Whether group async jobs should be dispatched to AsyncJobPool instead of
+// a dedicated thread per job.
+bool asyncJobPoolEnabled();
+
+// Run every job of asyncJobs on the given pool and wait for all of them to
+// finish. Mirrors the thread-per-job launch in group.cc: job states go
+// through Running -> Done -> Joined, the first failing job result is
+// returned, and once a job fails or groupAbortFlag is raised the abort flags
+// of all non-destroying jobs (and their children) are set so that blocked
+// jobs can bail out. A job that cannot be submitted fails with
+// ncclSystemError, like a failed pthread_create, and neither it nor the
+// following jobs are run; the jobs already submitted are aborted and waited
+// for before returning.
+ncclResult_t asyncJobPoolLaunch(
+    AsyncJobPool& pool,
+    AsyncJobQueue* asyncJobs,
+    volatile bool* groupAbortFlag);
+
+} // namespace ncclx::group
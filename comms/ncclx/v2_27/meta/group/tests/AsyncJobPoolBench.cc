@@ -0,0 +1,127 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/group/AsyncJobPool.h"
+
+using namespace ncclx::group;
+
+// Measures the launch-to-joined latency of a group of trivial async jobs, i.e.
+// the overhead the group launch path adds on top of the job bodies, for the
+// legacy thread-per-job launch and for AsyncJobPool.
+
+namespace {
+
+struct BenchJob {
+  ncclAsyncJob base{};
+  uint32_t abortFlag{0};
+  uint32_t abortFlagDev{0};
+};
+
+ncclResult_t emptyJobFunc(ncclAsyncJob*) {
+  return ncclSuccess;
+}
+
+void* threadPerJobMain(void* arg) {
+  auto job = reinterpret_cast<ncclAsyncJob*>(arg);
+  job->result = job->func(job);
+  __atomic_store_n(&job->state, ncclGroupJobDone, __ATOMIC_RELEASE);
+  return arg;
+}
+
+// Same control flow as the thread-per-job launch in group.cc.
+ncclResult_t threadPerJobLaunch(AsyncJobQueue* asyncJobs) {
+  ncclResult_t ret = ncclSuccess;
+  for (auto job = ncclIntruQueueHead(asyncJobs); job != nullptr;
+       job = job->next) {
+    if (pthread_create(&job->thread, nullptr, threadPerJobMain, job) != 0) {
+      return ncclSystemError;
+    }
+  }
+  bool jobsDone = false;
+  do {
+    jobsDone = true;
+    for (auto job = ncclIntruQueueHead(asyncJobs); job != nullptr;
+         job = job->next) {
+      auto state = __atomic_load_n(&job->state, __ATOMIC_ACQUIRE);
+      if (state == ncclGroupJobRunning) {
+        jobsDone = false;
+      } else if (state == ncclGroupJobDone) {
+        pthread_join(job->thread, nullptr);
+        job->state = ncclGroupJobJoined;
+        if (job->result != ncclSuccess && ret == ncclSuccess) {
+          ret = job->result;
+        }
+      }
+    }
+    if (!jobsDone) {
+      usleep(1);
+    }
+  } while (!jobsDone);
+  return ret;
+}
+
+void resetJobs(std::vector<BenchJob>& jobs, AsyncJobQueue* queue) {
+  ncclIntruQueueConstruct(queue);
+  for (auto& job : jobs) {
+    job.base.func = emptyJobFunc;
+    job.base.state = ncclGroupJobRunning;
+    job.base.abortFlag = &job.abortFlag;
+    job.base.abortFlagDev = &job.abortFlagDev;
+    ncclIntruQueueEnqueue(queue, &job.base);
+  }
+}
+
+} // namespace
+
+static void BM_ThreadPerJob(benchmark::State& state) {
+  std::vector<BenchJob> jobs(state.range(0));
+  AsyncJobQueue queue;
+  for (auto _ : state) {
+    state.PauseTiming();
+    resetJobs(jobs, &queue);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(threadPerJobLaunch(&queue));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AsyncJobPool(benchmark::State& state) {
+  std::vector<BenchJob> jobs(state.range(0));
+  AsyncJobQueue queue;
+  AsyncJobPool pool(state.range(0));
+  volatile bool groupAbortFlag = false;
+  for (auto _ : state) {
+    state.PauseTiming();
+    resetJobs(jobs, &queue);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(
+        asyncJobPoolLaunch(pool, &queue, &groupAbortFlag));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ThreadPerJob)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AsyncJobPool)
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
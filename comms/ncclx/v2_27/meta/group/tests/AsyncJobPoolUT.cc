@@ -0,0 +1,298 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/group/AsyncJobPool.h"
+
+using namespace ncclx::group;
+
+namespace {
+
+constexpr auto kTestTimeout = std::chrono::seconds(10);
+
+// Synthetic CPU-only job. ncclAsyncJob must be the first member so that the
+// job function can recover the test job from the base pointer.
+struct TestJob {
+  ncclAsyncJob base{};
+  uint32_t abortFlag{0};
+  uint32_t abortFlagDev{0};
+  uint32_t childAbortFlag{0};
+  uint32_t childAbortFlagDev{0};
+  ncclResult_t retVal{ncclSuccess};
+  std::chrono::milliseconds delay{0};
+  bool waitForAbort{false};
+  std::atomic<int>* started{nullptr};
+  int waitForStarted{0};
+  std::atomic<int>* completionOrder{nullptr};
+  int order{-1};
+};
+
+ncclResult_t testJobFunc(ncclAsyncJob* job_) {
+  auto job = reinterpret_cast<TestJob*>(job_);
+  if (job->started) {
+    job->started->fetch_add(1);
+    // Rendezvous with the other jobs of the batch, which can only succeed if
+    // all of them run concurrently.
+    auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+    while (job->started->load() < job->waitForStarted) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return ncclInternalError;
+      }
+      std::this_thread::yield();
+    }
+  }
+  if (job->delay.count() > 0) {
+    std::this_thread::sleep_for(job->delay);
+  }
+  if (job->waitForAbort) {
+    auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+    while (!__atomic_load_n(job->base.abortFlag, __ATOMIC_ACQUIRE)) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return ncclInternalError;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  if (job->completionOrder) {
+    job->order = job->completionOrder->fetch_add(1);
+  }
+  return job->retVal;
+}
+
+// Fails to start any worker after the first numWorkers ones, like
+// std::thread does when the process runs out of threads.
+class FailingAsyncJobPool : public AsyncJobPool {
+ public:
+  FailingAsyncJobPool(size_t maxIdleWorkers, int numWorkers)
+      : AsyncJobPool(maxIdleWorkers), workersLeft_(numWorkers) {}
+
+ protected:
+  void startWorker() override {
+    if (workersLeft_-- <= 0) {
+      throw std::system_error(
+          std::make_error_code(std::errc::resource_unavailable_try_again));
+    }
+    AsyncJobPool::startWorker();
+  }
+
+ private:
+  int workersLeft_;
+};
+
+} // namespace
+
+class AsyncJobPoolTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+    ncclIntruQueueConstruct(&queue_);
+  }
+
+  void TearDown() override {
+    jobs_.clear();
+  }
+
+ protected:
+  std::vector<std::unique_ptr<TestJob>>& createJobs(int numJobs) {
+    for (int i = 0; i < numJobs; i++) {
+      auto job = std::make_unique<TestJob>();
+      job->base.func = testJobFunc;
+      job->base.state = ncclGroupJobRunning;
+      job->base.abortFlag = &job->abortFlag;
+      job->base.abortFlagDev = &job->abortFlagDev;
+      job->base.childAbortFlag = &job->childAbortFlag;
+      job->base.childAbortFlagDev = &job->childAbortFlagDev;
+      ncclIntruQueueEnqueue(&queue_, &job->base);
+      jobs_.push_back(std::move(job));
+    }
+    return jobs_;
+  }
+
+  AsyncJobQueue queue_;
+  std::vector<std::unique_ptr<TestJob>> jobs_;
+  volatile bool groupAbortFlag_{false};
+};
+
+TEST_F(AsyncJobPoolTest, AllJobsJoined) {
+  AsyncJobPool pool(4);
+  constexpr int kNumJobs = 32;
+  auto& jobs = createJobs(kNumJobs);
+
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  for (auto& job : jobs) {
+    EXPECT_EQ(job->base.state, ncclGroupJobJoined);
+    EXPECT_EQ(job->base.result, ncclSuccess);
+    EXPECT_EQ(job->abortFlag, 0);
+    EXPECT_EQ(job->childAbortFlag, 0);
+  }
+}
+
+TEST_F(AsyncJobPoolTest, OutOfOrderCompletion) {
+  AsyncJobPool pool(2);
+  constexpr int kNumJobs = 8;
+  std::atomic<int> completionOrder{0};
+  auto& jobs = createJobs(kNumJobs);
+  // Later jobs finish first; launch must still wait for the slow head jobs.
+  for (int i = 0; i < kNumJobs; i++) {
+    jobs[i]->delay = std::chrono::milliseconds(5 * (kNumJobs - i));
+    jobs[i]->completionOrder = &completionOrder;
+  }
+
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  EXPECT_EQ(completionOrder.load(), kNumJobs);
+  for (int i = 0; i < kNumJobs; i++) {
+    EXPECT_EQ(jobs[i]->base.state, ncclGroupJobJoined);
+    EXPECT_GE(jobs[i]->order, 0);
+  }
+  EXPECT_GT(jobs[0]->order, jobs[kNumJobs - 1]->order);
+}
+
+TEST_F(AsyncJobPoolTest, JobsNeverQueueBehindEachOther) {
+  // Jobs of one group may depend on each other, so all of them have to run
+  // at the same time even if there are more jobs than retained workers.
+  constexpr size_t kMaxIdleWorkers = 2;
+  constexpr int kNumJobs = 16;
+  AsyncJobPool pool(kMaxIdleWorkers);
+  std::atomic<int> started{0};
+  auto& jobs = createJobs(kNumJobs);
+  for (auto& job : jobs) {
+    job->started = &started;
+    job->waitForStarted = kNumJobs;
+  }
+
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  EXPECT_EQ(started.load(), kNumJobs);
+
+  // Surplus workers retire once they run out of work.
+  auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+  while (pool.numWorkers() > kMaxIdleWorkers &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_LE(pool.numWorkers(), kMaxIdleWorkers);
+}
+
+TEST_F(AsyncJobPoolTest, WorkersReused) {
+  constexpr size_t kMaxIdleWorkers = 4;
+  AsyncJobPool pool(kMaxIdleWorkers);
+  for (int iter = 0; iter < 100; iter++) {
+    jobs_.clear();
+    ncclIntruQueueConstruct(&queue_);
+    createJobs(kMaxIdleWorkers);
+    ASSERT_EQ(
+        asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  }
+  EXPECT_LE(pool.numWorkers(), kMaxIdleWorkers);
+}
+
+TEST_F(AsyncJobPoolTest, ErrorAbortsOtherJobs) {
+  AsyncJobPool pool(4);
+  constexpr int kNumJobs = 6;
+  auto& jobs = createJobs(kNumJobs);
+  jobs[2]->retVal = ncclSystemError;
+  for (int i = 0; i < kNumJobs; i++) {
+    if (i != 2) {
+      jobs[i]->waitForAbort = true;
+    }
+  }
+
+  EXPECT_EQ(
+      asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSystemError);
+  for (int i = 0; i < kNumJobs; i++) {
+    EXPECT_EQ(jobs[i]->base.state, ncclGroupJobJoined);
+    EXPECT_EQ(jobs[i]->abortFlag, 1);
+    EXPECT_EQ(jobs[i]->abortFlagDev, 1);
+    EXPECT_EQ(jobs[i]->childAbortFlag, 1);
+    EXPECT_EQ(jobs[i]->childAbortFlagDev, 1);
+    if (i != 2) {
+      // Waiting jobs were released by the abort, not by the timeout.
+      EXPECT_EQ(jobs[i]->base.result, ncclSuccess);
+    }
+  }
+}
+
+TEST_F(AsyncJobPoolTest, GroupAbortFlag) {
+  AsyncJobPool pool(4);
+  constexpr int kNumJobs = 4;
+  auto& jobs = createJobs(kNumJobs);
+  for (auto& job : jobs) {
+    job->waitForAbort = true;
+  }
+  // No child communicator for the last job.
+  jobs.back()->base.childAbortFlag = nullptr;
+  jobs.back()->base.childAbortFlagDev = nullptr;
+
+  std::thread aborter([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    __atomic_store_n(&groupAbortFlag_, true, __ATOMIC_RELEASE);
+  });
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  aborter.join();
+
+  for (auto& job : jobs) {
+    EXPECT_EQ(job->base.state, ncclGroupJobJoined);
+    EXPECT_EQ(job->base.result, ncclSuccess);
+    EXPECT_EQ(job->abortFlag, 1);
+  }
+  EXPECT_EQ(jobs.back()->childAbortFlag, 0);
+}
+
+TEST_F(AsyncJobPoolTest, DestroyingJobsNotAborted) {
+  AsyncJobPool pool(4);
+  auto& jobs = createJobs(2);
+  jobs[0]->retVal = ncclInternalError;
+  jobs[1]->base.destroyFlag = 1;
+
+  EXPECT_EQ(
+      asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclInternalError);
+  EXPECT_EQ(jobs[0]->abortFlag, 1);
+  EXPECT_EQ(jobs[1]->abortFlag, 0);
+  EXPECT_EQ(jobs[1]->childAbortFlag, 0);
+}
+
+TEST_F(AsyncJobPoolTest, WorkerStartFailure) {
+  FailingAsyncJobPool pool(4, 2);
+  constexpr int kNumJobs = 5;
+  auto& jobs = createJobs(kNumJobs);
+  std::atomic<int> started{0};
+  for (auto& job : jobs) {
+    job->started = &started;
+    job->waitForAbort = true;
+  }
+
+  EXPECT_EQ(
+      asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSystemError);
+  // The two submitted jobs ran and were released by the abort, the others
+  // never ran.
+  EXPECT_EQ(started.load(), 2);
+  for (int i = 0; i < kNumJobs; i++) {
+    EXPECT_EQ(jobs[i]->base.state, ncclGroupJobJoined);
+    EXPECT_EQ(jobs[i]->abortFlag, 1);
+    EXPECT_EQ(jobs[i]->base.result, i < 2 ? ncclSuccess : ncclSystemError);
+  }
+  EXPECT_EQ(pool.numWorkers(), 2);
+
+  // Workers left over from the failed launch still serve later ones.
+  auto deadline = std::chrono::steady_clock::now() + kTestTimeout;
+  while (pool.numIdleWorkers() < 2 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  jobs_.clear();
+  ncclIntruQueueConstruct(&queue_);
+  createJobs(2);
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+}
+
+TEST_F(AsyncJobPoolTest, EmptyQueue) {
+  AsyncJobPool pool(4);
+  EXPECT_EQ(asyncJobPoolLaunch(pool, &queue_, &groupAbortFlag_), ncclSuccess);
+  EXPECT_EQ(pool.numWorkers(), 0);
+}
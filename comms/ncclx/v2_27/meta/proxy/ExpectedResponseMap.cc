@@ -0,0 +1,187 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/proxy/ExpectedResponseMap.h"
+
+#include <string.h>
+
+#include "debug.h"
+
+namespace ncclx::proxy {
+
+namespace {
+
+uint32_t roundUpPow2(uint32_t v) {
+  uint32_t p = 1;
+  while (p < v) {
+    p <<= 1;
+  }
+  return p;
+}
+
+} // namespace
+
+ExpectedResponseMap::ExpectedResponseMap(uint32_t initialCapacity)
+    : table_(roundUpPow2(initialCapacity < 8 ? 8 : initialCapacity), kEmpty) {
+  slots_.reserve(table_.size() / 2);
+}
+
+uint32_t ExpectedResponseMap::bucketOf(void* opId) const {
+  // opIds are heap or object addresses, so the low bits carry little entropy.
+  uint64_t h = reinterpret_cast<uintptr_t>(opId);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<uint32_t>(h) & (table_.size() - 1);
+}
+
+uint32_t ExpectedResponseMap::find(void* opId) const {
+  const uint32_t mask = table_.size() - 1;
+  for (uint32_t pos = bucketOf(opId);; pos = (pos + 1) & mask) {
+    uint32_t idx = table_[pos];
+    if (idx == kEmpty) {
+      return kEmpty;
+    }
+    if (slots_[idx].opId == opId) {
+      return pos;
+    }
+  }
+}
+
+void ExpectedResponseMap::erase(uint32_t pos) {
+  const uint32_t mask = table_.size() - 1;
+  freeSlots_.push_back(table_[pos]);
+  slots_[table_[pos]].opId = nullptr;
+  size_--;
+
+  // Backward shift deletion: move later entries of the probe sequence into
+  // the hole so that lookups never need tombstones.
+  uint32_t hole = pos;
+  for (uint32_t next = (hole + 1) & mask;; next = (next + 1) & mask) {
+    uint32_t idx = table_[next];
+    if (idx == kEmpty) {
+      break;
+    }
+    uint32_t home = bucketOf(slots_[idx].opId);
+    // Move the entry unless its home bucket lies cyclically in (hole, next].
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      table_[hole] = idx;
+      hole = next;
+    }
+  }
+  table_[hole] = kEmpty;
+}
+
+void ExpectedResponseMap::grow() {
+  std::vector<uint32_t> old(table_.size() * 2, kEmpty);
+  old.swap(table_);
+  const uint32_t mask = table_.size() - 1;
+  for (uint32_t idx : old) {
+    if (idx == kEmpty) {
+      continue;
+    }
+    uint32_t pos = bucketOf(slots_[idx].opId);
+    while (table_[pos] != kEmpty) {
+      pos = (pos + 1) & mask;
+    }
+    table_[pos] = idx;
+  }
+}
+
+ncclResult_t ExpectedResponseMap::enqueue(void* opId, int respSize) {
+  if (opId == nullptr || respSize < 0) {
+    WARN("Invalid expected proxy response opId=%p respSize=%d", opId, respSize);
+    return ncclInternalError;
+  }
+  // Keep the load factor at or below 1/2.
+  if ((size_ + 1) * 2 > table_.size()) {
+    grow();
+  }
+
+  const uint32_t mask = table_.size() - 1;
+  uint32_t pos = bucketOf(opId);
+  for (; table_[pos] != kEmpty; pos = (pos + 1) & mask) {
+    if (slots_[table_[pos]].opId == opId) {
+      WARN("Proxy response for opId=%p is already expected", opId);
+      return ncclInternalError;
+    }
+  }
+
+  uint32_t idx;
+  if (!freeSlots_.empty()) {
+    idx = freeSlots_.back();
+    freeSlots_.pop_back();
+  } else {
+    idx = slots_.size();
+    slots_.emplace_back();
+  }
+  Slot& slot = slots_[idx];
+  slot.opId = opId;
+  slot.respSize = respSize;
+  slot.done = false;
+  slot.res = ncclInternalError;
+  if (slot.respBuff.size() < static_cast<size_t>(respSize)) {
+    slot.respBuff.resize(respSize);
+  }
+  table_[pos] = idx;
+  size_++;
+  return ncclSuccess;
+}
+
+ncclResult_t ExpectedResponseMap::store(
+    void* opId,
+    int respSize,
+    ncclResult_t res,
+    void** respBuff) {
+  uint32_t pos = find(opId);
+  if (pos == kEmpty) {
+    WARN(
+        "Proxy response for opId=%p doesn't match any expected response",
+        opId);
+    return ncclInternalError;
+  }
+  Slot& slot = slots_[table_[pos]];
+  if (respSize != slot.respSize) {
+    WARN("Mismatched response size for opId=%p", opId);
+    return ncclInternalError;
+  }
+  if (slot.done) {
+    WARN("Storing response for already completed opId=%p", opId);
+    return ncclInternalError;
+  }
+  slot.done = true;
+  slot.res = res;
+  *respBuff = respSize > 0 ? slot.respBuff.data() : nullptr;
+  return ncclSuccess;
+}
+
+ncclResult_t
+ExpectedResponseMap::dequeue(void* opId, void* respBuff, int* found) {
+  *found = 0;
+  uint32_t pos = find(opId);
+  if (pos == kEmpty) {
+    return ncclSuccess;
+  }
+  Slot& slot = slots_[table_[pos]];
+  if (!slot.done) {
+    return ncclSuccess;
+  }
+  if (slot.respSize > 0) {
+    memcpy(respBuff, slot.respBuff.data(), slot.respSize);
+  }
+  ncclResult_t res = slot.res;
+  erase(pos);
+  *found = 1;
+  return res;
+}
+
+ncclResult_t ExpectedResponseMap::remove(void* opId) {
+  uint32_t pos = find(opId);
+  if (pos == kEmpty) {
+    WARN("Couldn't find opId=%p", opId);
+    return ncclInternalError;
+  }
+  erase(pos);
+  return ncclSuccess;
+}
+
+} // namespace ncclx::proxy
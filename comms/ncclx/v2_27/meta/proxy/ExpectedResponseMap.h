@@ -0,0 +1,81 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "nccl.h"
+
+namespace ncclx::proxy {
+
+// Responses the proxy client is waiting for, keyed by the opId passed to
+// ncclProxyCallAsync().
+//
+// The proxy thread replies to async ops in completion order, so a poller may
+// receive the response of another op first and has to stash it until its
+// owner polls for it. Entries live in a slab of slots indexed by an
+// open-addressed (linear probing) hash table, so that every operation is O(1)
+// regardless of the number of in-flight ops, and slots and their response
+// buffers are recycled instead of being allocated per op.
+//
+// Not thread-safe; used only by the thread driving the connection setup.
+class ExpectedResponseMap {
+ public:
+  explicit ExpectedResponseMap(uint32_t initialCapacity = 64);
+  ExpectedResponseMap(const ExpectedResponseMap&) = delete;
+  ExpectedResponseMap& operator=(const ExpectedResponseMap&) = delete;
+
+  // Start expecting a response of respSize bytes for opId. opId must not be
+  // already outstanding.
+  ncclResult_t enqueue(void* opId, int respSize);
+
+  // Record the result of an expected op whose response was received while
+  // polling for another op. On success *respBuff points to the buffer the
+  // caller must fill with the respSize response bytes, or is nullptr when
+  // respSize is 0. The buffer stays valid until the entry is dequeued or
+  // removed.
+  ncclResult_t store(
+      void* opId,
+      int respSize,
+      ncclResult_t res,
+      void** respBuff);
+
+  // If the response of opId has been stored, copy it to respBuff, drop the
+  // entry, set *found to 1 and return the stored result. Otherwise set
+  // *found to 0 and return ncclSuccess.
+  ncclResult_t dequeue(void* opId, void* respBuff, int* found);
+
+  // Drop the entry of opId, whether or not its response was stored.
+  ncclResult_t remove(void* opId);
+
+  uint32_t size() const {
+    return size_;
+  }
+
+ private:
+  struct Slot {
+    void* opId{nullptr};
+    int respSize{0};
+    bool done{false};
+    ncclResult_t res{ncclSuccess};
+    // Kept across reuse of the slot so that steady state does not allocate.
+    std::vector<char> respBuff;
+  };
+
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+
+  uint32_t bucketOf(void* opId) const;
+  // Returns the table position holding opId, or kEmpty.
+  uint32_t find(void* opId) const;
+  void erase(uint32_t pos);
+  void grow();
+
+  // Slot index per bucket, kEmpty if unused. Size is a power of two.
+  std::vector<uint32_t> table_;
+  std::vector<Slot> slots_;
+  std::vector<uint32_t> freeSlots_;
+  uint32_t size_{0};
+};
+
+} // namespace ncclx::proxy
@@ -0,0 +1,62 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdint>
+
+namespace ncclx::proxy {
+
+// Upper bound of a single futex sleep. Bounds the cost of a missed wakeup,
+// e.g. from a peer process running an older library without the wake call.
+constexpr long kFreeOpsWaitTimeoutNs = 1000000;
+
+// Wait for the progress thread to return ops to a ncclProxyOpsPool free list
+// slot. freeOps and waiters live in shared memory and may be updated by
+// another process, hence the non-private futex ops. Spins for spinCount
+// iterations before sleeping on the futex. Returns the observed head of the
+// free list, which is never -1.
+inline int waitFreeOps(
+    volatile int* freeOps,
+    volatile int* waiters,
+    int64_t spinCount) {
+  int freeOp;
+  for (int64_t i = 0; i < spinCount; i++) {
+    if ((freeOp = __atomic_load_n(freeOps, __ATOMIC_ACQUIRE)) != -1) {
+      return freeOp;
+    }
+#if defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+  }
+  while ((freeOp = __atomic_load_n(freeOps, __ATOMIC_SEQ_CST)) == -1) {
+    __atomic_add_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+    // The kernel re-checks *freeOps == -1 atomically before sleeping, so a
+    // return of ops racing with this call cannot be lost.
+    struct timespec timeout = {0, kFreeOpsWaitTimeoutNs};
+    syscall(
+        SYS_futex,
+        (int*)freeOps,
+        FUTEX_WAIT,
+        -1,
+        &timeout,
+        nullptr,
+        0);
+    __atomic_sub_fetch(waiters, 1, __ATOMIC_SEQ_CST);
+  }
+  return freeOp;
+}
+
+// Wake threads blocked in waitFreeOps() after *freeOps has been updated.
+inline void wakeFreeOpsWaiters(volatile int* freeOps, volatile int* waiters) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+    syscall(SYS_futex, (int*)freeOps, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+  }
+}
+
+} // namespace ncclx::proxy
@@ -0,0 +1,198 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/proxy/ProxyServicePoller.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "debug.h"
+
+namespace ncclx::proxy {
+
+ProxyServicePoller::ProxyServicePoller(
+    int maxPeers,
+    int64_t spinCount,
+    int asyncTimeoutMs,
+    int idleTimeoutMs)
+    : maxPeers_(maxPeers),
+      spinCount_(spinCount),
+      asyncTimeoutMs_(asyncTimeoutMs),
+      idleTimeoutMs_(idleTimeoutMs),
+      fds_(maxPeers, -1),
+      events_(maxPeers, 0),
+      activePos_(maxPeers, -1),
+      // one extra for each of listen and wakeup fds
+      epollEvents_(maxPeers + 2) {
+  active_.reserve(maxPeers);
+  signaled_.reserve(maxPeers);
+}
+
+ProxyServicePoller::~ProxyServicePoller() {
+  if (epollFd_ >= 0) {
+    close(epollFd_);
+  }
+}
+
+ncclResult_t ProxyServicePoller::init(int listenFd, int wakeupFd) {
+  epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd_ < 0) {
+    WARN("[Proxy Service] epoll_create1 failed: %s", strerror(errno));
+    return ncclSystemError;
+  }
+
+  // Peers use their slot as epoll data, listen and wakeup fds use the two
+  // values right after the last slot.
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.u32 = maxPeers_;
+  if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd, &ev) != 0) {
+    WARN(
+        "[Proxy Service] epoll_ctl add listenSock failed: %s",
+        strerror(errno));
+    return ncclSystemError;
+  }
+  listenFd_ = listenFd;
+
+  if (wakeupFd >= 0) {
+    ev.events = EPOLLIN;
+    ev.data.u32 = maxPeers_ + 1;
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd, &ev) != 0) {
+      WARN(
+          "[Proxy Service] epoll_ctl add wakeup fd failed: %s",
+          strerror(errno));
+      return ncclSystemError;
+    }
+    wakeupFd_ = wakeupFd;
+  }
+  return ncclSuccess;
+}
+
+int ProxyServicePoller::freeSlot() const {
+  if (numPeers() == maxPeers_) {
+    return -1;
+  }
+  for (int s = 0; s < maxPeers_; s++) {
+    if (fds_[s] < 0) {
+      return s;
+    }
+  }
+  return -1;
+}
+
+ncclResult_t ProxyServicePoller::addPeer(int slot, int fd) {
+  if (slot < 0 || slot >= maxPeers_ || fds_[slot] >= 0) {
+    WARN("[Proxy Service] Invalid peer slot %d", slot);
+    return ncclInternalError;
+  }
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.u32 = slot;
+  if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    WARN(
+        "[Proxy Service] epoll_ctl add peer fd %d failed: %s",
+        fd,
+        strerror(errno));
+    return ncclSystemError;
+  }
+  fds_[slot] = fd;
+  events_[slot] = 0;
+  activePos_[slot] = active_.size();
+  active_.push_back(slot);
+  return ncclSuccess;
+}
+
+ncclResult_t ProxyServicePoller::removePeer(int slot) {
+  if (slot < 0 || slot >= maxPeers_ || fds_[slot] < 0) {
+    WARN("[Proxy Service] Invalid peer slot %d", slot);
+    return ncclInternalError;
+  }
+  // The fd may already have been closed by the caller, in which case the
+  // kernel has dropped it from the epoll set already.
+  (void)epoll_ctl(epollFd_, EPOLL_CTL_DEL, fds_[slot], nullptr);
+  fds_[slot] = -1;
+  events_[slot] = 0;
+
+  int pos = activePos_[slot];
+  int last = active_.back();
+  active_[pos] = last;
+  activePos_[last] = pos;
+  active_.pop_back();
+  activePos_[slot] = -1;
+  return ncclSuccess;
+}
+
+ncclResult_t ProxyServicePoller::wait(bool hasAsyncOps) {
+  for (int slot : signaled_) {
+    events_[slot] = 0;
+  }
+  signaled_.clear();
+  listenReady_ = false;
+
+  int timeoutMs = idleTimeoutMs_;
+  if (hasAsyncOps) {
+    timeoutMs = (idleSpins_ < spinCount_) ? 0 : asyncTimeoutMs_;
+    idleSpins_++;
+  } else {
+    idleSpins_ = 0;
+  }
+
+  int nEvents;
+  do {
+    nEvents = epoll_wait(
+        epollFd_, epollEvents_.data(), epollEvents_.size(), timeoutMs);
+  } while (nEvents < 0 && errno == EINTR);
+  if (nEvents < 0) {
+    WARN("[Proxy Service] epoll_wait failed: %s", strerror(errno));
+    return ncclSystemError;
+  }
+
+  for (int i = 0; i < nEvents; i++) {
+    uint32_t id = epollEvents_[i].data.u32;
+    uint32_t ev = epollEvents_[i].events;
+    if (id == static_cast<uint32_t>(maxPeers_)) {
+      listenReady_ = true;
+    } else if (id == static_cast<uint32_t>(maxPeers_ + 1)) {
+      uint64_t count;
+      while (read(wakeupFd_, &count, sizeof(count)) > 0) {
+      }
+    } else {
+      uint32_t peerEv = 0;
+      if (ev & EPOLLIN) {
+        peerEv |= kPeerIn;
+      }
+      if (ev & (EPOLLHUP | EPOLLERR)) {
+        peerEv |= kPeerHup;
+      }
+      if (peerEv && events_[id] == 0) {
+        signaled_.push_back(id);
+      }
+      events_[id] |= peerEv;
+    }
+  }
+  if (nEvents > 0) {
+    idleSpins_ = 0;
+  }
+  return ncclSuccess;
+}
+
+ncclResult_t ProxyServicePoller::createWakeupFd(int* fd) {
+  *fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (*fd < 0) {
+    WARN("[Proxy Service] eventfd failed: %s", strerror(errno));
+    return ncclSystemError;
+  }
+  return ncclSuccess;
+}
+
+void ProxyServicePoller::wakeup(int wakeupFd) {
+  if (wakeupFd < 0) {
+    return;
+  }
+  uint64_t one = 1;
+  // EAGAIN means the counter is saturated, i.e. a wakeup is pending anyway.
+  (void)!write(wakeupFd, &one, sizeof(one));
+}
+
+} // namespace ncclx::proxy
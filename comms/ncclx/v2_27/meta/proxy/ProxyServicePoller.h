@@ -0,0 +1,98 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <sys/epoll.h>
+#include <cstdint>
+#include <vector>
+
+#include "nccl.h"
+
+namespace ncclx::proxy {
+
+// Event loop backend of the proxy service thread.
+//
+// Tracks the listen socket, the connected local peers and an eventfd used to
+// wake the service thread up from other threads, all registered in a single
+// epoll set, so that an iteration only costs the number of ready or busy
+// peers instead of rescanning every slot. While async proxy ops are
+// outstanding the loop keeps polling with a zero timeout for spinCount
+// consecutive iterations without events, then falls back to sleeping up to
+// asyncTimeoutMs between progress attempts instead of busy spinning for the
+// whole connection setup. Any event ends the sleep and restores the spin
+// budget, including a wakeup() when an async op is queued or completes; the
+// timeout only bounds how long an op whose progress raises no event waits
+// for its next attempt.
+class ProxyServicePoller {
+ public:
+  // Events reported for a peer, matching the poll() bits the service loop
+  // used to check.
+  static constexpr uint32_t kPeerIn = 0x1;
+  static constexpr uint32_t kPeerHup = 0x2;
+
+  ProxyServicePoller(
+      int maxPeers,
+      int64_t spinCount,
+      int asyncTimeoutMs,
+      int idleTimeoutMs);
+  ~ProxyServicePoller();
+  ProxyServicePoller(const ProxyServicePoller&) = delete;
+  ProxyServicePoller& operator=(const ProxyServicePoller&) = delete;
+
+  // Register the listen socket and the wakeup eventfd (owned by the caller,
+  // see createWakeupFd()). wakeupFd may be -1 if no external wakeups are
+  // needed.
+  ncclResult_t init(int listenFd, int wakeupFd);
+
+  // Returns the lowest free peer slot, or -1 if all maxPeers slots are used.
+  int freeSlot() const;
+  ncclResult_t addPeer(int slot, int fd);
+  ncclResult_t removePeer(int slot);
+
+  // Wait for the next batch of events. hasAsyncOps tells whether any peer
+  // has outstanding async ops that need to be progressed.
+  ncclResult_t wait(bool hasAsyncOps);
+
+  bool listenReady() const {
+    return listenReady_;
+  }
+  uint32_t peerEvents(int slot) const {
+    return events_[slot];
+  }
+  // Dense list of connected peer slots. removePeer() moves the last entry
+  // into the removed position, so iterate it backwards when removing peers
+  // during the iteration.
+  const std::vector<int>& activePeers() const {
+    return active_;
+  }
+  int numPeers() const {
+    return static_cast<int>(active_.size());
+  }
+
+  // Creates a non-blocking eventfd suitable for init().
+  static ncclResult_t createWakeupFd(int* fd);
+  // Wake up the poller from any thread. Safe to call concurrently.
+  static void wakeup(int wakeupFd);
+
+ private:
+  const int maxPeers_;
+  const int64_t spinCount_;
+  const int asyncTimeoutMs_;
+  const int idleTimeoutMs_;
+
+  int epollFd_{-1};
+  int listenFd_{-1};
+  int wakeupFd_{-1};
+  bool listenReady_{false};
+  int64_t idleSpins_{0};
+
+  std::vector<int> fds_;
+  std::vector<uint32_t> events_;
+  std::vector<int> active_;
+  std::vector<int> activePos_;
+  // Slots whose events_ entry must be cleared before the next wait.
+  std::vector<int> signaled_;
+  std::vector<struct epoll_event> epollEvents_;
+};
+
+} // namespace ncclx::proxy
@@ -0,0 +1,158 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/proxy/ExpectedResponseMap.h"
+
+using namespace ncclx::proxy;
+
+// Measures the client-side bookkeeping cost of the expected proxy responses
+// when many ops are in flight and their responses come back in random order,
+// for the legacy linked list and for ExpectedResponseMap. Each op is enqueued,
+// its response stored by another poller and then dequeued by its owner.
+
+namespace {
+
+constexpr int kRespSize = 64;
+
+// Same algorithm as the linked list formerly used in proxy.cc.
+struct ListEntry {
+  void* opId;
+  int respSize;
+  bool done;
+  void* respBuff;
+  ncclResult_t res;
+  ListEntry* next;
+};
+
+struct LegacyList {
+  ListEntry* head{nullptr};
+
+  void enqueue(void* opId, int respSize) {
+    auto ex = static_cast<ListEntry*>(calloc(1, sizeof(ListEntry)));
+    ex->opId = opId;
+    ex->respBuff = malloc(respSize);
+    ex->respSize = respSize;
+    ex->res = ncclInternalError;
+    if (head == nullptr) {
+      head = ex;
+      return;
+    }
+    ListEntry* list = head;
+    while (list->next) {
+      list = list->next;
+    }
+    list->next = ex;
+  }
+
+  void store(void* opId, void* respBuff, ncclResult_t res) {
+    for (ListEntry* elem = head; elem; elem = elem->next) {
+      if (elem->opId == opId) {
+        memcpy(elem->respBuff, respBuff, elem->respSize);
+        free(respBuff);
+        elem->done = true;
+        elem->res = res;
+        return;
+      }
+    }
+  }
+
+  ncclResult_t dequeue(void* opId, void* respBuff, int* found) {
+    ListEntry* prev = nullptr;
+    *found = 0;
+    for (ListEntry* elem = head; elem; prev = elem, elem = elem->next) {
+      if (elem->opId == opId && elem->done) {
+        (prev ? prev->next : head) = elem->next;
+        memcpy(respBuff, elem->respBuff, elem->respSize);
+        ncclResult_t res = elem->res;
+        free(elem->respBuff);
+        free(elem);
+        *found = 1;
+        return res;
+      }
+    }
+    return ncclSuccess;
+  }
+};
+
+std::vector<int> shuffledOrder(int n, uint32_t seed) {
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+  return order;
+}
+
+} // namespace
+
+static void BM_LegacyList(benchmark::State& state) {
+  const int nOps = state.range(0);
+  std::vector<char> opIds(nOps);
+  auto storeOrder = shuffledOrder(nOps, 1);
+  auto pollOrder = shuffledOrder(nOps, 2);
+  char resp[kRespSize];
+  LegacyList list;
+  for (auto _ : state) {
+    for (int i = 0; i < nOps; i++) {
+      list.enqueue(&opIds[i], kRespSize);
+    }
+    for (int i : storeOrder) {
+      list.store(&opIds[i], malloc(kRespSize), ncclSuccess);
+    }
+    for (int i : pollOrder) {
+      int found;
+      benchmark::DoNotOptimize(list.dequeue(&opIds[i], resp, &found));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nOps);
+}
+
+static void BM_ExpectedResponseMap(benchmark::State& state) {
+  const int nOps = state.range(0);
+  std::vector<char> opIds(nOps);
+  auto storeOrder = shuffledOrder(nOps, 1);
+  auto pollOrder = shuffledOrder(nOps, 2);
+  char resp[kRespSize] = {};
+  ExpectedResponseMap map;
+  for (auto _ : state) {
+    for (int i = 0; i < nOps; i++) {
+      map.enqueue(&opIds[i], kRespSize);
+    }
+    for (int i : storeOrder) {
+      void* buff;
+      map.store(&opIds[i], kRespSize, ncclSuccess, &buff);
+      memcpy(buff, resp, kRespSize);
+    }
+    for (int i : pollOrder) {
+      int found;
+      benchmark::DoNotOptimize(map.dequeue(&opIds[i], resp, &found));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nOps);
+}
+
+BENCHMARK(BM_LegacyList)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExpectedResponseMap)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
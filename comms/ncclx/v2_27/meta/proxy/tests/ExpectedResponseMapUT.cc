@@ -0,0 +1,199 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/proxy/ExpectedResponseMap.h"
+
+using namespace ncclx::proxy;
+
+class ExpectedResponseMapTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+  }
+};
+
+TEST_F(ExpectedResponseMapTest, InOrderResponse) {
+  ExpectedResponseMap map;
+  int op;
+  ASSERT_EQ(map.enqueue(&op, sizeof(int)), ncclSuccess);
+  EXPECT_EQ(map.size(), 1);
+
+  // Not stored yet: polling does not find it
+  int resp = 0;
+  int found = -1;
+  EXPECT_EQ(map.dequeue(&op, &resp, &found), ncclSuccess);
+  EXPECT_EQ(found, 0);
+  EXPECT_EQ(map.size(), 1);
+
+  // Response received by its owner directly
+  EXPECT_EQ(map.remove(&op), ncclSuccess);
+  EXPECT_EQ(map.size(), 0);
+  EXPECT_EQ(map.remove(&op), ncclInternalError);
+}
+
+TEST_F(ExpectedResponseMapTest, OutOfOrderResponse) {
+  ExpectedResponseMap map;
+  int ops[2];
+  ASSERT_EQ(map.enqueue(&ops[0], sizeof(int)), ncclSuccess);
+  ASSERT_EQ(map.enqueue(&ops[1], sizeof(int)), ncclSuccess);
+
+  // Response of ops[1] arrives while polling for ops[0]
+  void* buff = nullptr;
+  ASSERT_EQ(
+      map.store(&ops[1], sizeof(int), ncclSystemError, &buff), ncclSuccess);
+  ASSERT_NE(buff, nullptr);
+  int value = 42;
+  memcpy(buff, &value, sizeof(value));
+
+  int resp = 0;
+  int found = 0;
+  EXPECT_EQ(map.dequeue(&ops[0], &resp, &found), ncclSuccess);
+  EXPECT_EQ(found, 0);
+  EXPECT_EQ(map.dequeue(&ops[1], &resp, &found), ncclSystemError);
+  EXPECT_EQ(found, 1);
+  EXPECT_EQ(resp, 42);
+  EXPECT_EQ(map.size(), 1);
+
+  // Dequeued entries are gone
+  EXPECT_EQ(map.dequeue(&ops[1], &resp, &found), ncclSuccess);
+  EXPECT_EQ(found, 0);
+}
+
+TEST_F(ExpectedResponseMapTest, ZeroSizeResponse) {
+  ExpectedResponseMap map;
+  int op;
+  ASSERT_EQ(map.enqueue(&op, 0), ncclSuccess);
+  void* buff = &op;
+  ASSERT_EQ(map.store(&op, 0, ncclSuccess, &buff), ncclSuccess);
+  EXPECT_EQ(buff, nullptr);
+  int found = 0;
+  EXPECT_EQ(map.dequeue(&op, nullptr, &found), ncclSuccess);
+  EXPECT_EQ(found, 1);
+}
+
+TEST_F(ExpectedResponseMapTest, InvalidOperations) {
+  ExpectedResponseMap map;
+  int ops[3];
+  void* buff;
+  ASSERT_EQ(map.enqueue(&ops[0], 8), ncclSuccess);
+  EXPECT_EQ(map.enqueue(&ops[0], 8), ncclInternalError);
+  EXPECT_EQ(map.enqueue(nullptr, 8), ncclInternalError);
+  EXPECT_EQ(map.store(&ops[1], 8, ncclSuccess, &buff), ncclInternalError);
+  EXPECT_EQ(map.store(&ops[0], 4, ncclSuccess, &buff), ncclInternalError);
+  EXPECT_EQ(map.store(&ops[0], 8, ncclSuccess, &buff), ncclSuccess);
+  EXPECT_EQ(map.store(&ops[0], 8, ncclSuccess, &buff), ncclInternalError);
+  EXPECT_EQ(map.remove(&ops[2]), ncclInternalError);
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST_F(ExpectedResponseMapTest, SlotReuseWithLargerResponse) {
+  ExpectedResponseMap map;
+  int op;
+  ASSERT_EQ(map.enqueue(&op, 4), ncclSuccess);
+  ASSERT_EQ(map.remove(&op), ncclSuccess);
+
+  // The recycled slot must fit the larger response
+  std::vector<char> expected(4096, 'x');
+  ASSERT_EQ(map.enqueue(&op, expected.size()), ncclSuccess);
+  void* buff = nullptr;
+  ASSERT_EQ(
+      map.store(&op, expected.size(), ncclSuccess, &buff), ncclSuccess);
+  memcpy(buff, expected.data(), expected.size());
+  std::vector<char> resp(expected.size());
+  int found = 0;
+  EXPECT_EQ(map.dequeue(&op, resp.data(), &found), ncclSuccess);
+  EXPECT_EQ(found, 1);
+  EXPECT_EQ(resp, expected);
+}
+
+// Mirrors many connections being set up in parallel: thousands of ops are in
+// flight, responses arrive in random order and each op is either polled by
+// its owner after another poller stashed its response, or received directly
+// by its owner. Checked against a reference map after every step.
+TEST_F(ExpectedResponseMapTest, OutOfOrderStress) {
+  constexpr int kOps = 20000;
+  constexpr int kMaxInFlight = 4096;
+  ExpectedResponseMap map(16);
+  std::mt19937 rng(1234);
+
+  struct RefEntry {
+    int respSize;
+    bool stored;
+    uint64_t value;
+  };
+  // Distinct addresses used as opIds
+  std::vector<char> opIds(kOps);
+  std::unordered_map<void*, RefEntry> ref;
+  std::vector<void*> inFlight;
+
+  int issued = 0;
+  while (issued < kOps || !inFlight.empty()) {
+    bool issue = issued < kOps &&
+        (inFlight.empty() ||
+         (inFlight.size() < kMaxInFlight && rng() % 2 == 0));
+    if (issue) {
+      void* opId = &opIds[issued];
+      int respSize = (rng() % 4) * sizeof(uint64_t);
+      ASSERT_EQ(map.enqueue(opId, respSize), ncclSuccess);
+      ref[opId] = {respSize, false, rng()};
+      inFlight.push_back(opId);
+      issued++;
+    } else {
+      size_t i = rng() % inFlight.size();
+      void* opId = inFlight[i];
+      RefEntry& entry = ref[opId];
+      uint64_t resp[3] = {};
+      int found = 0;
+      if (!entry.stored && rng() % 3 != 0) {
+        // Response received while polling for another op
+        void* buff = nullptr;
+        ASSERT_EQ(
+            map.store(
+                opId,
+                entry.respSize,
+                static_cast<ncclResult_t>(entry.value % 2),
+                &buff),
+            ncclSuccess);
+        for (int w = 0; w < entry.respSize / 8; w++) {
+          uint64_t v = entry.value + w;
+          memcpy(static_cast<char*>(buff) + w * 8, &v, 8);
+        }
+        entry.stored = true;
+      } else if (entry.stored) {
+        ASSERT_EQ(
+            map.dequeue(opId, resp, &found),
+            static_cast<ncclResult_t>(entry.value % 2));
+        ASSERT_EQ(found, 1);
+        for (int w = 0; w < entry.respSize / 8; w++) {
+          ASSERT_EQ(resp[w], entry.value + w);
+        }
+        ref.erase(opId);
+        inFlight[i] = inFlight.back();
+        inFlight.pop_back();
+      } else {
+        // Owner polls before its response arrived, then receives it directly
+        ASSERT_EQ(map.dequeue(opId, resp, &found), ncclSuccess);
+        ASSERT_EQ(found, 0);
+        ASSERT_EQ(map.remove(opId), ncclSuccess);
+        ref.erase(opId);
+        inFlight[i] = inFlight.back();
+        inFlight.pop_back();
+      }
+    }
+    ASSERT_EQ(map.size(), ref.size());
+  }
+
+  // Every opId must be gone once all responses were consumed
+  for (auto& opId : opIds) {
+    int found = 0;
+    EXPECT_EQ(map.dequeue(&opId, nullptr, &found), ncclSuccess);
+    EXPECT_EQ(found, 0);
+  }
+}
@@ -0,0 +1,414 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "alloc.h"
+#include "checks.h"
+#include "proxy.h"
+#include "socket.h"
+#include "transport.h"
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/proxy/ProxyOpsPoolWait.h"
+#include "meta/proxy/ProxyServicePoller.h"
+
+using namespace ncclx::proxy;
+
+namespace {
+
+constexpr uint64_t kMagic = 0x70726f7879746573;
+constexpr int kMaxPeers = 128;
+constexpr auto kTestTimeout = std::chrono::seconds(10);
+
+// Request of the fake transport's proxySetup: it completes after being
+// polled polls more times, and only once released if waitForRelease is set,
+// then responds value + 1.
+struct FakeSetupReq {
+  int value;
+  int polls;
+  int waitForRelease;
+};
+
+std::atomic<bool> fakeSetupReleased{false};
+std::atomic<int64_t> fakeSetupCalls{0};
+
+ncclResult_t fakeProxySetup(
+    struct ncclProxyConnection* /* connection */,
+    struct ncclProxyState* /* proxyState */,
+    void* reqBuff,
+    int /* reqSize */,
+    void* respBuff,
+    int /* respSize */,
+    int* done) {
+  fakeSetupCalls++;
+  // The service keeps the request buffer until the op completes
+  auto req = static_cast<FakeSetupReq*>(reqBuff);
+  if (req->polls > 0) {
+    req->polls--;
+    *done = 0;
+    return ncclSuccess;
+  }
+  if (req->waitForRelease && !fakeSetupReleased.load()) {
+    *done = 0;
+    return ncclSuccess;
+  }
+  *static_cast<int*>(respBuff) = req->value + 1;
+  *done = 1;
+  return ncclSuccess;
+}
+
+// A local rank talking to the proxy service the way ncclProxyConnect and
+// ncclProxyCallAsync do
+class ProxyClient {
+ public:
+  ProxyClient() {
+    (void)ncclSocketInit(&sock_);
+  }
+  ~ProxyClient() {
+    (void)ncclSocketClose(&sock_);
+  }
+
+  ncclResult_t connect(union ncclSocketAddress* addr) {
+    NCCLCHECK(ncclSocketInit(&sock_, addr, kMagic, ncclSocketTypeProxy));
+    NCCLCHECK(ncclSocketConnect(&sock_));
+    return ncclSuccess;
+  }
+
+  // Creates the proxy connection of the fake transport
+  ncclResult_t init(int rank) {
+    struct ncclProxyInitReq req = {};
+    req.transport = TRANSPORT_P2P;
+    req.send = 1;
+    req.tpLocalRank = rank;
+    req.tpRank = rank;
+    req.sameProcess = 1;
+    struct ncclProxyInitResp resp = {};
+    NCCLCHECK(call(ncclProxyMsgInit, &req, sizeof(req), &resp, sizeof(resp)));
+    connection_ = resp.connection;
+    return ncclSuccess;
+  }
+
+  ncclResult_t send(int type, void* req, int reqSize, int respSize, void* opId) {
+    NCCLCHECK(ncclSocketSend(&sock_, &type, sizeof(int)));
+    NCCLCHECK(ncclSocketSend(&sock_, &connection_, sizeof(void*)));
+    NCCLCHECK(ncclSocketSend(&sock_, &reqSize, sizeof(int)));
+    NCCLCHECK(ncclSocketSend(&sock_, &respSize, sizeof(int)));
+    if (reqSize) {
+      NCCLCHECK(ncclSocketSend(&sock_, req, reqSize));
+    }
+    NCCLCHECK(ncclSocketSend(&sock_, &opId, sizeof(opId)));
+    return ncclSuccess;
+  }
+
+  ncclResult_t recvResponse(void* opId, void* resp, int respSize) {
+    struct ncclProxyRpcResponseHeader header;
+    NCCLCHECK(ncclSocketRecv(&sock_, &header, sizeof(header)));
+    if (header.opId != opId || header.respSize != respSize) {
+      return ncclInternalError;
+    }
+    if (respSize) {
+      NCCLCHECK(ncclSocketRecv(&sock_, resp, respSize));
+    }
+    return header.res;
+  }
+
+  ncclResult_t
+  call(int type, void* req, int reqSize, void* resp, int respSize) {
+    void* opId = this;
+    NCCLCHECK(send(type, req, reqSize, respSize, opId));
+    return recvResponse(opId, resp, respSize);
+  }
+
+  ncclResult_t setup(FakeSetupReq req, int* resp) {
+    return call(ncclProxyMsgSetup, &req, sizeof(req), resp, sizeof(int));
+  }
+
+  ncclResult_t sendType(int type) {
+    return ncclSocketSend(&sock_, &type, sizeof(int));
+  }
+
+ private:
+  struct ncclSocket sock_;
+  struct ncclProxyConnection* connection_{nullptr};
+};
+
+} // namespace
+
+// Runs ncclProxyService on loopback sockets, with the proxy connections on a
+// fake P2P transport whose proxySetup completes after a given number of
+// polls or an external event, so the service loop can be exercised on CPU.
+class ProxyServiceTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+    fakeSetupReleased = false;
+    fakeSetupCalls = 0;
+    savedTransport_ = ncclTransports[TRANSPORT_P2P];
+    fakeTransport_.send.proxySetup = fakeProxySetup;
+    ncclTransports[TRANSPORT_P2P] = &fakeTransport_;
+
+    ASSERT_EQ(ncclCalloc(&proxyState_, 1), ncclSuccess);
+    proxyState_->abortFlag = &abortFlag_;
+    ASSERT_EQ(
+        ProxyServicePoller::createWakeupFd(&proxyState_->serviceWakeupFd),
+        ncclSuccess);
+    // Freed by the service thread on exit
+    ASSERT_EQ(ncclCalloc(&proxyState_->listenSock, 1), ncclSuccess);
+    ASSERT_EQ(ncclSocketGetAddrFromString(&addr_, "127.0.0.1:0"), ncclSuccess);
+    ASSERT_EQ(
+        ncclSocketInit(
+            proxyState_->listenSock,
+            &addr_,
+            kMagic,
+            ncclSocketTypeProxy,
+            &abortFlag_),
+        ncclSuccess);
+    ASSERT_EQ(ncclSocketListen(proxyState_->listenSock), ncclSuccess);
+    ASSERT_EQ(ncclSocketGetAddr(proxyState_->listenSock, &addr_), ncclSuccess);
+  }
+
+  void TearDown() override {
+    if (service_.joinable()) {
+      stopService();
+    }
+    close(proxyState_->serviceWakeupFd);
+    free(proxyState_);
+    ncclTransports[TRANSPORT_P2P] = savedTransport_;
+  }
+
+ protected:
+  // The service reads its cvars when it starts
+  void startService(int64_t spinCount, int64_t asyncTimeoutMs) {
+    NCCL_PROXY_SERVICE_SPIN_COUNT = spinCount;
+    NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS = asyncTimeoutMs;
+    service_ = std::thread([this]() { ncclProxyService(proxyState_); });
+  }
+
+  // Returns once the service thread exited; every client must be closed
+  void stopService() {
+    {
+      ProxyClient client;
+      ASSERT_EQ(client.connect(&addr_), ncclSuccess);
+      ASSERT_EQ(client.sendType(ncclProxyMsgStop), ncclSuccess);
+    }
+    service_.join();
+  }
+
+  struct ncclTransport fakeTransport_ = {};
+  struct ncclTransport* savedTransport_{nullptr};
+  struct ncclProxyState* proxyState_{nullptr};
+  uint32_t abortFlag_{0};
+  union ncclSocketAddress addr_;
+  std::thread service_;
+};
+
+TEST_F(ProxyServiceTest, ManyPeers) {
+  constexpr int kNumPeers = 64;
+  constexpr int kNumRequests = 50;
+  startService(16, 1);
+
+  std::atomic<int> numErrors{0};
+  std::atomic<int> numConnected{0};
+  std::vector<std::thread> clients;
+  for (int p = 0; p < kNumPeers; p++) {
+    clients.emplace_back([&, p]() {
+      ProxyClient client;
+      if (client.connect(&addr_) != ncclSuccess ||
+          client.init(p) != ncclSuccess) {
+        numErrors++;
+        numConnected++;
+        return;
+      }
+      // Keep all peers connected at once before issuing requests
+      numConnected++;
+      while (numConnected.load() < kNumPeers) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < kNumRequests; i++) {
+        FakeSetupReq req{p * 1000 + i, i % 3, 0};
+        int resp = -1;
+        if (client.setup(req, &resp) != ncclSuccess || resp != req.value + 1) {
+          numErrors++;
+          break;
+        }
+      }
+    });
+  }
+  for (auto& t : clients) {
+    t.join();
+  }
+  stopService();
+  EXPECT_EQ(numErrors.load(), 0);
+}
+
+TEST_F(ProxyServiceTest, AsyncOpsDoNotBusySpin) {
+  constexpr int kSpinCount = 64;
+  constexpr int kReleaseDelayMs = 100;
+  startService(kSpinCount, 1);
+
+  ProxyClient client;
+  ASSERT_EQ(client.connect(&addr_), ncclSuccess);
+  ASSERT_EQ(client.init(0), ncclSuccess);
+  std::thread releaser([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kReleaseDelayMs));
+    fakeSetupReleased = true;
+    ncclProxyServiceWakeup(proxyState_);
+  });
+  int resp = -1;
+  ASSERT_EQ(client.setup(FakeSetupReq{41, 0, 1}, &resp), ncclSuccess);
+  EXPECT_EQ(resp, 42);
+  releaser.join();
+
+  // A zero-timeout loop would poll the op millions of times while it is
+  // pending; with the spin budget exhausted every poll sleeps ~1ms.
+  EXPECT_LT(fakeSetupCalls.load(), kSpinCount + 4 * kReleaseDelayMs);
+}
+
+TEST_F(ProxyServiceTest, AsyncOpsWakeTheLoop) {
+  // Without a wakeup, a pending op would only be retried after 100s
+  startService(0, 100000);
+
+  ProxyClient client;
+  ASSERT_EQ(client.connect(&addr_), ncclSuccess);
+  ASSERT_EQ(client.init(0), ncclSuccess);
+
+  // Queuing the op wakes the loop for its next attempt
+  auto start = std::chrono::steady_clock::now();
+  int resp = -1;
+  ASSERT_EQ(client.setup(FakeSetupReq{1, 1, 0}, &resp), ncclSuccess);
+  EXPECT_EQ(resp, 2);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kTestTimeout);
+
+  // So does a completion signaled by another thread
+  std::thread releaser([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    fakeSetupReleased = true;
+    ncclProxyServiceWakeup(proxyState_);
+  });
+  start = std::chrono::steady_clock::now();
+  ASSERT_EQ(client.setup(FakeSetupReq{2, 0, 1}, &resp), ncclSuccess);
+  EXPECT_EQ(resp, 3);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, kTestTimeout);
+  releaser.join();
+}
+
+// Unit tests of the poller on its own
+class ProxyServicePollerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    listenFd_ = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listenFd_, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(
+        bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_EQ(listen(listenFd_, kMaxPeers), 0);
+    ASSERT_EQ(ProxyServicePoller::createWakeupFd(&wakeupFd_), ncclSuccess);
+  }
+
+  void TearDown() override {
+    close(listenFd_);
+    close(wakeupFd_);
+  }
+
+ protected:
+  int listenFd_{-1};
+  int wakeupFd_{-1};
+};
+
+TEST_F(ProxyServicePollerTest, WakeupInterruptsIdleWait) {
+  ProxyServicePoller poller(kMaxPeers, 0, 1, 10000);
+  ASSERT_EQ(poller.init(listenFd_, wakeupFd_), ncclSuccess);
+
+  std::thread waker([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ProxyServicePoller::wakeup(wakeupFd_);
+    ProxyServicePoller::wakeup(wakeupFd_);
+  });
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(poller.wait(false), ncclSuccess);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  waker.join();
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+  EXPECT_FALSE(poller.listenReady());
+
+  // Both wakeups were drained by a single wait, the next one times out.
+  ProxyServicePoller shortPoller(kMaxPeers, 0, 1, 10);
+  ASSERT_EQ(shortPoller.init(listenFd_, wakeupFd_), ncclSuccess);
+  ASSERT_EQ(shortPoller.wait(false), ncclSuccess);
+  EXPECT_FALSE(shortPoller.listenReady());
+}
+
+TEST_F(ProxyServicePollerTest, SlotBookkeeping) {
+  constexpr int kPeers = 4;
+  ProxyServicePoller poller(kPeers, 0, 1, 0);
+  ASSERT_EQ(poller.init(listenFd_, -1), ncclSuccess);
+
+  int sv[kPeers][2];
+  for (int i = 0; i < kPeers; i++) {
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv[i]), 0);
+    int s = poller.freeSlot();
+    EXPECT_EQ(s, i);
+    ASSERT_EQ(poller.addPeer(s, sv[i][0]), ncclSuccess);
+  }
+  EXPECT_EQ(poller.freeSlot(), -1);
+  EXPECT_NE(poller.addPeer(0, sv[0][0]), ncclSuccess);
+
+  ASSERT_EQ(poller.removePeer(1), ncclSuccess);
+  EXPECT_EQ(poller.numPeers(), kPeers - 1);
+  EXPECT_EQ(poller.freeSlot(), 1);
+  for (int s : poller.activePeers()) {
+    EXPECT_NE(s, 1);
+  }
+
+  // Only the slot with pending data and the one whose peer hung up report
+  // events.
+  int value = 7;
+  ASSERT_EQ(write(sv[2][1], &value, sizeof(value)), sizeof(value));
+  close(sv[3][1]);
+  ASSERT_EQ(poller.wait(false), ncclSuccess);
+  EXPECT_EQ(poller.peerEvents(0), 0);
+  EXPECT_TRUE(poller.peerEvents(2) & ProxyServicePoller::kPeerIn);
+  EXPECT_NE(poller.peerEvents(3), 0);
+
+  for (int i = 0; i < kPeers; i++) {
+    close(sv[i][0]);
+    if (i != 3) {
+      close(sv[i][1]);
+    }
+  }
+}
+
+TEST(ProxyOpsPoolWaitTest, WaitForFreeOps) {
+  volatile int freeOps = -1;
+  volatile int waiters = 0;
+  std::thread producer([&]() {
+    // Wait for the consumer to go to sleep before returning ops
+    while (__atomic_load_n(&waiters, __ATOMIC_SEQ_CST) == 0) {
+      std::this_thread::yield();
+    }
+    __atomic_store_n(&freeOps, 5, __ATOMIC_SEQ_CST);
+    wakeFreeOpsWaiters(&freeOps, &waiters);
+  });
+  EXPECT_EQ(waitFreeOps(&freeOps, &waiters, 0), 5);
+  producer.join();
+  EXPECT_EQ(waiters, 0);
+}
+
+TEST(ProxyOpsPoolWaitTest, SpinFastPath) {
+  volatile int freeOps = 3;
+  volatile int waiters = 0;
+  EXPECT_EQ(waitFreeOps(&freeOps, &waiters, 16), 3);
+  EXPECT_EQ(waiters, 0);
+}
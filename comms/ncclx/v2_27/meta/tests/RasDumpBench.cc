@@ -0,0 +1,185 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "nccl.h"
+#include "ras_internal.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+
+// Cost of answering a RAS client as the job grows: formatting the STATUS
+// text report on the RAS thread, versus streaming the binary dump in
+// fixed-size messages, and rendering the text from the dump on the client
+// side. outputBytes is what is sent to the client; peakBufferBytes is the
+// most of the dump the RAS thread holds on to at any time.
+
+namespace {
+
+constexpr int kGpusPerNode = 8;
+// Size of the messages the RAS client support code packs dump records into
+constexpr size_t kDumpMsgSize = 64 * 1024;
+
+ncclSocketAddress peerAddr(int peer) {
+  ncclSocketAddress addr{};
+  addr.sin.sin_family = AF_INET;
+  addr.sin.sin_addr.s_addr = htonl(0x0a000000 | (peer / kGpusPerNode + 1));
+  addr.sin.sin_port = htons(29000 + peer % kGpusPerNode);
+  return addr;
+}
+
+// The RAS state after a RAS_COLL_COMMS collective over nRanks simulated
+// processes, one per GPU: a world communicator and one per node. All
+// processes respond.
+struct SimulatedJob {
+  explicit SimulatedJob(int nRanks) {
+    const int nNodes = nRanks / kGpusPerNode;
+    for (int peer = 0; peer < nRanks; peer++) {
+      rasPeerInfo info{};
+      info.addr = peerAddr(peer);
+      info.pid = 1000 + peer;
+      info.cudaDevs = info.nvmlDevs = 1UL << (peer % kGpusPerNode);
+      info.hostHash = 0xa000 + peer / kGpusPerNode;
+      info.pidHash = 0xb000 + peer;
+      peers.push_back(info);
+      collPeers.push_back(info.addr);
+    }
+
+    const size_t size = sizeof(rasCollComms) +
+        (1 + nNodes) * sizeof(rasCollComms::comm) +
+        2 * nRanks * sizeof(rasCollComms::comm::rank);
+    commsBuf.assign(size / sizeof(uint64_t) + 1, 0);
+    auto* commsData = reinterpret_cast<rasCollComms*>(commsBuf.data());
+    commsData->nComms = 1 + nNodes;
+    rasCollComms::comm* comm = commsData->comms;
+    for (int commIdx = 0; commIdx < 1 + nNodes; commIdx++) {
+      const int firstPeer = (commIdx == 0 ? 0 : (commIdx - 1) * kGpusPerNode);
+      const int commNRanks = (commIdx == 0 ? nRanks : kGpusPerNode);
+      comm->commId.commHash = 0x1000 + commIdx;
+      comm->commId.hostHash = peers[firstPeer].hostHash;
+      comm->commId.pidHash = peers[firstPeer].pidHash;
+      comm->commNRanks = comm->nRanks = commNRanks;
+      comm->nMissingRanks = 0;
+      for (int commRank = 0; commRank < commNRanks; commRank++) {
+        auto* rank = comm->ranks + commRank;
+        rank->commRank = commRank;
+        rank->peerIdx = firstPeer + commRank;
+        for (auto& count : rank->collOpCounts) {
+          count = 1000;
+        }
+        rank->cudaDev = rank->nvmlDev = rank->peerIdx % kGpusPerNode;
+      }
+      comm = reinterpret_cast<rasCollComms::comm*>(comm->ranks + commNRanks);
+    }
+
+    data.ncclMajor = NCCL_MAJOR;
+    data.ncclMinor = NCCL_MINOR;
+    data.ncclPatch = NCCL_PATCH;
+    data.ncclSuffix = NCCL_SUFFIX;
+    data.peers = peers.data();
+    data.nPeers = peers.size();
+    data.collPeers = collPeers.data();
+    data.nCollPeers = collPeers.size();
+    data.comms = commsData;
+  }
+
+  std::vector<rasPeerInfo> peers;
+  std::vector<ncclSocketAddress> collPeers;
+  std::vector<uint64_t> commsBuf;
+  rasReportData data{};
+};
+
+// Packs the records into messages like the RAS client support code does;
+// a full message is handed off to the socket and forgotten.
+struct MsgSink {
+  std::vector<char> msg = std::vector<char>(kDumpMsgSize);
+  size_t nMsg{0};
+  size_t totalBytes{0};
+  std::string* keep{nullptr};
+};
+
+ncclResult_t msgAppend(void* arg, const void* record, int length) {
+  auto* sink = static_cast<MsgSink*>(arg);
+  if (sink->nMsg + length > sink->msg.size()) {
+    benchmark::DoNotOptimize(sink->msg.data());
+    sink->nMsg = 0;
+  }
+  memcpy(sink->msg.data() + sink->nMsg, record, length);
+  sink->nMsg += length;
+  sink->totalBytes += length;
+  if (sink->keep) {
+    sink->keep->append(static_cast<const char*>(record), length);
+  }
+  return ncclSuccess;
+}
+
+} // namespace
+
+static void BM_StatusReport(benchmark::State& state) {
+  SimulatedJob job(state.range(0));
+  int textLen = 0;
+  for (auto _ : state) {
+    char* text;
+    rasReportRender(&job.data, false, &text, &textLen);
+    benchmark::DoNotOptimize(text);
+    free(text);
+  }
+  state.counters["outputBytes"] = textLen;
+}
+
+static void BM_BinaryDump(benchmark::State& state) {
+  SimulatedJob job(state.range(0));
+  size_t totalBytes = 0;
+  for (auto _ : state) {
+    MsgSink sink;
+    rasDumpWritePeers(&job.data, msgAppend, &sink);
+    rasDumpWriteComms(&job.data, msgAppend, &sink);
+    totalBytes = sink.totalBytes;
+  }
+  state.counters["outputBytes"] = totalBytes;
+  state.counters["peakBufferBytes"] = std::min(totalBytes, kDumpMsgSize);
+}
+
+static void BM_DumpRender(benchmark::State& state) {
+  SimulatedJob job(state.range(0));
+  std::string dump;
+  MsgSink sink;
+  sink.keep = &dump;
+  rasDumpWritePeers(&job.data, msgAppend, &sink);
+  rasDumpWriteComms(&job.data, msgAppend, &sink);
+  int textLen = 0;
+  for (auto _ : state) {
+    char* text;
+    rasDumpRender(dump.data(), dump.size(), false, &text, &textLen);
+    benchmark::DoNotOptimize(text);
+    free(text);
+  }
+  state.counters["outputBytes"] = textLen;
+}
+
+BENCHMARK(BM_StatusReport)
+    ->RangeMultiplier(4)
+    ->Range(1024, 64 * 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BinaryDump)
+    ->RangeMultiplier(4)
+    ->Range(1024, 64 * 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DumpRender)
+    ->RangeMultiplier(4)
+    ->Range(1024, 64 * 1024)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,380 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nccl.h"
+#include "ras_internal.h" // @manual
+
+namespace {
+
+constexpr int kGpusPerNode = 8;
+
+// One process per GPU; processes of a node share the IP address and differ
+// by port, so the peers come out sorted by index, like rasPeers.
+ncclSocketAddress peerAddr(int peer) {
+  ncclSocketAddress addr{};
+  addr.sin.sin_family = AF_INET;
+  addr.sin.sin_addr.s_addr = htonl(0x0a000000 | (peer / kGpusPerNode + 1));
+  addr.sin.sin_port = htons(29000 + peer % kGpusPerNode);
+  return addr;
+}
+
+struct SimRank {
+  int peer;
+  ncclResult_t initState{ncclSuccess};
+  ncclResult_t asyncError{ncclSuccess};
+  bool abortFlag{false};
+  uint64_t opCount{100};
+};
+
+// What the RAS thread of the process a client connects to would hold after
+// a RAS_COLL_COMMS collective with in-process simulated peers: the rasPeers
+// and rasDeadPeers arrays, and the merged responses of the live peers. Ranks
+// of dead peers show up as missing ranks.
+class SimulatedJob {
+ public:
+  SimulatedJob(int nPeers, const std::vector<int>& deadPeers) {
+    dead_.assign(nPeers, false);
+    for (int peer : deadPeers) {
+      dead_[peer] = true;
+      deadPeers_.push_back(peerAddr(peer));
+    }
+    collPeerIdx_.assign(nPeers, -1);
+    for (int peer = 0; peer < nPeers; peer++) {
+      rasPeerInfo info{};
+      info.addr = peerAddr(peer);
+      info.pid = 1000 + peer;
+      info.cudaDevs = info.nvmlDevs = 1UL << (peer % kGpusPerNode);
+      info.hostHash = 0xa000 + peer / kGpusPerNode;
+      info.pidHash = 0xb000 + peer;
+      peers_.push_back(info);
+      if (!dead_[peer]) {
+        collPeerIdx_[peer] = collPeers_.size();
+        collPeers_.push_back(info.addr);
+      }
+    }
+  }
+
+  // Adds a communicator whose commRank i is managed by ranks[i].peer.
+  void addComm(uint64_t commHash, const std::vector<SimRank>& ranks) {
+    comms_.push_back({commHash, ranks});
+  }
+
+  // Lays out the communicators like rasCollCommsMerge does and points the
+  // report data at the simulated state.
+  rasReportData data() {
+    size_t size = sizeof(rasCollComms);
+    for (const auto& comm : comms_) {
+      size += sizeof(rasCollComms::comm) +
+          comm.ranks.size() *
+              std::max(
+                  sizeof(rasCollComms::comm::rank),
+                  sizeof(rasCollCommsMissingRank));
+    }
+    commsBuf_.assign(size / sizeof(uint64_t) + 1, 0);
+    auto* commsData = reinterpret_cast<rasCollComms*>(commsBuf_.data());
+    commsData->nComms = comms_.size();
+    rasCollComms::comm* comm = commsData->comms;
+    for (const auto& simComm : comms_) {
+      comm->commId.commHash = simComm.commHash;
+      comm->commId.hostHash = peers_[simComm.ranks[0].peer].hostHash;
+      comm->commId.pidHash = peers_[simComm.ranks[0].peer].pidHash;
+      comm->commNRanks = simComm.ranks.size();
+      comm->nRanks = comm->nMissingRanks = 0;
+      for (int commRank = 0; commRank < simComm.ranks.size(); commRank++) {
+        const SimRank& simRank = simComm.ranks[commRank];
+        if (dead_[simRank.peer]) {
+          continue;
+        }
+        auto* rank = comm->ranks + comm->nRanks++;
+        rank->commRank = commRank;
+        rank->peerIdx = collPeerIdx_[simRank.peer];
+        for (auto& count : rank->collOpCounts) {
+          count = simRank.opCount;
+        }
+        rank->status.initState = simRank.initState;
+        rank->status.asyncError = simRank.asyncError;
+        rank->status.abortFlag = simRank.abortFlag;
+        rank->cudaDev = rank->nvmlDev = simRank.peer % kGpusPerNode;
+      }
+      auto* missingRanks = reinterpret_cast<rasCollCommsMissingRank*>(
+          comm->ranks + comm->nRanks);
+      for (int commRank = 0; commRank < simComm.ranks.size(); commRank++) {
+        const SimRank& simRank = simComm.ranks[commRank];
+        if (!dead_[simRank.peer]) {
+          continue;
+        }
+        auto* missingRank = missingRanks + comm->nMissingRanks++;
+        missingRank->commRank = commRank;
+        missingRank->addr = peerAddr(simRank.peer);
+        missingRank->cudaDev = missingRank->nvmlDev =
+            simRank.peer % kGpusPerNode;
+      }
+      comm = reinterpret_cast<rasCollComms::comm*>(
+          missingRanks + comm->nMissingRanks);
+    }
+
+    rasReportData data{};
+    data.ncclMajor = NCCL_MAJOR;
+    data.ncclMinor = NCCL_MINOR;
+    data.ncclPatch = NCCL_PATCH;
+    data.ncclSuffix = NCCL_SUFFIX;
+    data.cudaMajor = 12;
+    data.cudaMinor = 4;
+    data.cudaRuntime = 12040;
+    data.cudaDriver = 12080;
+    data.peers = peers_.data();
+    data.nPeers = peers_.size();
+    data.deadPeers = deadPeers_.data();
+    data.nDeadPeers = deadPeers_.size();
+    data.elapsed = 42000000;
+    data.collPeers = collPeers_.data();
+    data.nCollPeers = collPeers_.size();
+    data.comms = commsData;
+    return data;
+  }
+
+ private:
+  struct SimComm {
+    uint64_t commHash;
+    std::vector<SimRank> ranks;
+  };
+  std::vector<bool> dead_;
+  std::vector<int> collPeerIdx_;
+  std::vector<rasPeerInfo> peers_;
+  std::vector<ncclSocketAddress> deadPeers_;
+  std::vector<ncclSocketAddress> collPeers_;
+  std::vector<SimComm> comms_;
+  std::vector<uint64_t> commsBuf_;
+};
+
+struct DumpSink {
+  std::string bytes;
+  std::vector<size_t> recordOffsets;
+  std::vector<uint32_t> recordTypes;
+};
+
+ncclResult_t sinkAppend(void* arg, const void* record, int length) {
+  auto* sink = static_cast<DumpSink*>(arg);
+  sink->recordOffsets.push_back(sink->bytes.size());
+  sink->recordTypes.push_back(
+      static_cast<const rasDumpRecordHeader*>(record)->type);
+  sink->bytes.append(static_cast<const char*>(record), length);
+  return ncclSuccess;
+}
+
+std::string render(rasReportData* data, bool verbose) {
+  char* text;
+  int textLen;
+  EXPECT_EQ(rasReportRender(data, verbose, &text, &textLen), ncclSuccess);
+  std::string result(text, textLen);
+  free(text);
+  return result;
+}
+
+std::string renderDump(const std::string& dump, bool verbose) {
+  char* text;
+  int textLen;
+  EXPECT_EQ(
+      rasDumpRender(dump.data(), dump.size(), verbose, &text, &textLen),
+      ncclSuccess);
+  std::string result(text, textLen);
+  free(text);
+  return result;
+}
+
+} // namespace
+
+class RasDumpTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // 4 nodes, with one dead process on the last one
+    std::vector<SimRank> world;
+    for (int peer = 0; peer < kNPeers; peer++) {
+      world.push_back({peer});
+    }
+    world[1].asyncError = ncclRemoteError;
+    world[2].opCount = 99;
+    job_.addComm(0x1000, world);
+    for (int node = 0; node < kNPeers / kGpusPerNode; node++) {
+      std::vector<SimRank> local;
+      for (int i = 0; i < kGpusPerNode; i++) {
+        local.push_back({node * kGpusPerNode + i});
+      }
+      if (node == 1) {
+        local[3].initState = ncclSystemError;
+      }
+      if (node == 2) {
+        local[5].abortFlag = true;
+      }
+      job_.addComm(0x2000 + node, local);
+    }
+  }
+
+  DumpSink dump(rasReportData* data) {
+    DumpSink sink;
+    EXPECT_EQ(rasDumpWritePeers(data, sinkAppend, &sink), ncclSuccess);
+    EXPECT_EQ(rasDumpWriteComms(data, sinkAppend, &sink), ncclSuccess);
+    return sink;
+  }
+
+  static constexpr int kNPeers = 4 * kGpusPerNode;
+  static constexpr int kDeadPeer = kNPeers - 3;
+  SimulatedJob job_{kNPeers, {kDeadPeer}};
+};
+
+TEST_F(RasDumpTest, RenderMatchesStatusReport) {
+  for (bool verbose : {false, true}) {
+    // The status report sorts collPeers, so dump the data first
+    rasReportData data = job_.data();
+    const DumpSink sink = dump(&data);
+    const std::string expected = render(&data, verbose);
+
+    EXPECT_EQ(renderDump(sink.bytes, verbose), expected);
+    EXPECT_NE(expected.find("Communicators..."), std::string::npos);
+    EXPECT_NE(expected.find("ERROR"), std::string::npos);
+  }
+}
+
+TEST_F(RasDumpTest, StreamsFixedLayoutRecords) {
+  rasReportData data = job_.data();
+  const DumpSink sink = dump(&data);
+
+  const size_t nWorldRanks = kNPeers - 1;
+  const size_t nLocalRanks = kNPeers - 1;
+  // header, peers, dead peer, comms, coll peers, comm records, ranks,
+  // missing ranks, end
+  EXPECT_EQ(
+      sink.recordTypes.size(),
+      1 + kNPeers + 1 + 1 + (kNPeers - 1) + 5 + nWorldRanks + nLocalRanks + 2 +
+          1);
+  EXPECT_EQ(sink.recordTypes.front(), RAS_DUMP_HEADER);
+  EXPECT_EQ(sink.recordTypes[1], RAS_DUMP_PEER);
+  EXPECT_EQ(sink.recordTypes[kNPeers + 1], RAS_DUMP_DEAD_PEER);
+  EXPECT_EQ(sink.recordTypes[kNPeers + 2], RAS_DUMP_COMMS);
+  EXPECT_EQ(sink.recordTypes.back(), RAS_DUMP_END);
+  for (size_t offset : sink.recordOffsets) {
+    EXPECT_EQ(offset % 8, 0);
+  }
+
+  rasDumpHeader header;
+  memcpy(&header, sink.bytes.data(), sizeof(header));
+  EXPECT_EQ(header.magic, RAS_DUMP_MAGIC);
+  EXPECT_EQ(header.version, RAS_DUMP_VERSION);
+  EXPECT_EQ(header.nPeers, kNPeers);
+  EXPECT_EQ(header.nDeadPeers, 1);
+}
+
+TEST_F(RasDumpTest, DecodesSimulatedPeers) {
+  rasReportData data = job_.data();
+  const DumpSink sink = dump(&data);
+
+  rasReportData decoded;
+  ASSERT_EQ(
+      rasDumpDecode(sink.bytes.data(), sink.bytes.size(), &decoded),
+      ncclSuccess);
+  EXPECT_STREQ(decoded.ncclSuffix, NCCL_SUFFIX);
+  ASSERT_EQ(decoded.nPeers, kNPeers);
+  for (int peer = 0; peer < kNPeers; peer++) {
+    EXPECT_EQ(
+        ncclSocketsCompare(&decoded.peers[peer].addr, &data.peers[peer].addr),
+        0);
+    EXPECT_EQ(decoded.peers[peer].pid, data.peers[peer].pid);
+    EXPECT_EQ(decoded.peers[peer].pidHash, data.peers[peer].pidHash);
+  }
+  ASSERT_EQ(decoded.nDeadPeers, 1);
+  EXPECT_EQ(
+      ncclSocketsCompare(decoded.deadPeers, &data.peers[kDeadPeer].addr), 0);
+  EXPECT_EQ(decoded.nCollPeers, kNPeers - 1);
+  EXPECT_EQ(decoded.elapsed, data.elapsed);
+  EXPECT_EQ(decoded.comms->nComms, data.comms->nComms);
+  EXPECT_EQ(decoded.comms->comms[0].nRanks, kNPeers - 1);
+  EXPECT_EQ(decoded.comms->comms[0].nMissingRanks, 1);
+  EXPECT_EQ(
+      decoded.comms->comms[0].ranks[1].status.asyncError, ncclRemoteError);
+  rasDumpDataFree(&decoded);
+}
+
+TEST_F(RasDumpTest, RejectsIncompleteDump) {
+  rasReportData data = job_.data();
+  const DumpSink sink = dump(&data);
+
+  // A dump cut at any record, as when the connection is interrupted
+  for (size_t i = 0; i < sink.recordOffsets.size(); i++) {
+    const size_t offset = sink.recordOffsets[i];
+    rasReportData decoded;
+    EXPECT_EQ(
+        rasDumpDecode(sink.bytes.data(), offset, &decoded), ncclInvalidArgument)
+        << "record " << i;
+    EXPECT_EQ(
+        rasDumpDecode(sink.bytes.data(), offset + 4, &decoded),
+        ncclInvalidArgument)
+        << "record " << i;
+  }
+}
+
+TEST_F(RasDumpTest, RejectsCorruptDump) {
+  rasReportData data = job_.data();
+  const DumpSink sink = dump(&data);
+  rasReportData decoded;
+
+  std::string badMagic = sink.bytes;
+  badMagic[offsetof(rasDumpHeader, magic)] ^= 0xff;
+  EXPECT_EQ(
+      rasDumpDecode(badMagic.data(), badMagic.size(), &decoded),
+      ncclInvalidArgument);
+
+  // A rank pointing past the peers the data was collected from
+  std::string badRank = sink.bytes;
+  for (size_t i = 0; i < sink.recordTypes.size(); i++) {
+    if (sink.recordTypes[i] == RAS_DUMP_RANK) {
+      const int32_t collPeerIdx = kNPeers;
+      memcpy(
+          badRank.data() + sink.recordOffsets[i] +
+              offsetof(rasDumpRank, collPeerIdx),
+          &collPeerIdx,
+          sizeof(collPeerIdx));
+      break;
+    }
+  }
+  EXPECT_EQ(
+      rasDumpDecode(badRank.data(), badRank.size(), &decoded),
+      ncclInvalidArgument);
+
+  // Records out of order
+  std::string reordered = sink.bytes;
+  reordered.erase(sink.recordOffsets[kNPeers + 1], sizeof(rasDumpAddr));
+  EXPECT_EQ(
+      rasDumpDecode(reordered.data(), reordered.size(), &decoded),
+      ncclInvalidArgument);
+}
+
+TEST_F(RasDumpTest, SkipsUnknownRecords) {
+  rasReportData data = job_.data();
+  const DumpSink sink = dump(&data);
+  const std::string expected = render(&data, false);
+
+  // A record type from a newer NCCL, and a longer header
+  struct {
+    rasDumpRecordHeader hdr;
+    uint64_t payload[3];
+  } unknown{{100, 32}, {1, 2, 3}};
+  std::string extended = sink.bytes;
+  extended.insert(
+      sink.recordOffsets[kNPeers + 2],
+      reinterpret_cast<const char*>(&unknown),
+      sizeof(unknown));
+  rasDumpHeader header;
+  memcpy(&header, extended.data(), sizeof(header));
+  header.hdr.length += 16;
+  extended.replace(
+      0, sizeof(header), reinterpret_cast<char*>(&header), sizeof(header));
+  extended.insert(sizeof(header), 16, '\0');
+
+  EXPECT_EQ(renderDump(extended, false), expected);
+}
@@ -0,0 +1,149 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "comms/testinfra/TestUtils.h"
+#include "nccl.h"
+#include "socket.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kNumSockets = 64;
+constexpr auto kListenDelay = std::chrono::milliseconds(300);
+
+double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+// Connects to a loopback port whose listener only shows up later, as when
+// ranks start before the bootstrap root or their peers.
+class SocketRetryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ncclCvarInit();
+    // Pick a free port, and leave nothing listening on it
+    addr_.sin.sin_family = AF_INET;
+    addr_.sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr_.sin.sin_port = 0;
+    ncclSocket sock;
+    ASSERT_EQ(ncclSocketInit(&sock, &addr_), ncclSuccess);
+    ASSERT_EQ(ncclSocketListen(&sock), ncclSuccess);
+    ASSERT_EQ(ncclSocketGetAddr(&sock, &addr_), ncclSuccess);
+    ASSERT_EQ(ncclSocketClose(&sock), ncclSuccess);
+  }
+
+  void listen(ncclSocket* sock) {
+    ASSERT_EQ(ncclSocketInit(sock, &addr_), ncclSuccess);
+    ASSERT_EQ(ncclSocketListen(sock), ncclSuccess);
+  }
+
+  ncclSocketAddress addr_{};
+};
+
+TEST_F(SocketRetryTest, AsyncConnectRetriesWithoutSleeping) {
+  EnvRAII sleepGuard(NCCL_SOCKET_RETRY_SLEEP_MSEC, (int64_t)20);
+  EnvRAII maxSleepGuard(NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC, (int64_t)160);
+  std::vector<ncclSocket> socks(kNumSockets);
+  for (auto& sock : socks) {
+    ASSERT_EQ(
+        ncclSocketInit(
+            &sock,
+            &addr_,
+            NCCL_SOCKET_MAGIC,
+            ncclSocketTypeBootstrap,
+            nullptr,
+            1 /* asyncFlag */),
+        ncclSuccess);
+    ASSERT_EQ(ncclSocketConnect(&sock), ncclSuccess);
+  }
+
+  // Progress all sockets from this thread, as the bootstrap and proxy do
+  const auto start = Clock::now();
+  ncclSocket listenSock;
+  bool listening = false;
+  std::vector<double> readyMs(kNumSockets, -1);
+  double maxCallMs = 0;
+  int nReady = 0;
+  while (nReady < kNumSockets) {
+    if (!listening && Clock::now() - start >= kListenDelay) {
+      listen(&listenSock);
+      listening = true;
+    }
+    for (int i = 0; i < kNumSockets; i++) {
+      if (readyMs[i] >= 0) {
+        continue;
+      }
+      const auto callStart = Clock::now();
+      int ready = 0;
+      ASSERT_EQ(ncclSocketReady(&socks[i], &ready), ncclSuccess);
+      maxCallMs = std::max(maxCallMs, msSince(callStart));
+      if (ready) {
+        readyMs[i] = msSince(start);
+        nReady++;
+      }
+    }
+    ASSERT_LT(msSince(start), 10000) << nReady << " sockets connected";
+  }
+
+  // Waiting for a retry never blocks the thread, only polling for the
+  // connection to complete does, for up to 1 ms
+  EXPECT_LT(maxCallMs, NCCL_SOCKET_RETRY_SLEEP_MSEC);
+  // Jittered retries spread the connections instead of all of them landing
+  // on the listener at once
+  const auto [first, last] =
+      std::minmax_element(readyMs.begin(), readyMs.end());
+  EXPECT_GE(*first, kListenDelay.count());
+  EXPECT_GT(*last - *first, 20) << "sockets connected between " << *first
+                                << " and " << *last << " ms";
+
+  for (auto& sock : socks) {
+    EXPECT_EQ(ncclSocketClose(&sock), ncclSuccess);
+  }
+  EXPECT_EQ(ncclSocketClose(&listenSock), ncclSuccess);
+}
+
+TEST_F(SocketRetryTest, BlockingConnectWaitsForListener) {
+  EnvRAII sleepGuard(NCCL_SOCKET_RETRY_SLEEP_MSEC, (int64_t)20);
+  ncclSocket listenSock;
+  std::thread listener([&]() {
+    std::this_thread::sleep_for(kListenDelay);
+    listen(&listenSock);
+  });
+
+  ncclSocket sock;
+  ASSERT_EQ(
+      ncclSocketInit(&sock, &addr_, NCCL_SOCKET_MAGIC, ncclSocketTypeBootstrap),
+      ncclSuccess);
+  const auto start = Clock::now();
+  EXPECT_EQ(ncclSocketConnect(&sock), ncclSuccess);
+  listener.join();
+  EXPECT_GE(msSince(start), kListenDelay.count());
+  EXPECT_GT(sock.errorRetries, 0);
+  EXPECT_EQ(sock.state, ncclSocketStateReady);
+
+  EXPECT_EQ(ncclSocketClose(&sock), ncclSuccess);
+  EXPECT_EQ(ncclSocketClose(&listenSock), ncclSuccess);
+}
+
+TEST_F(SocketRetryTest, GivesUpAfterRetryCount) {
+  EnvRAII countGuard(NCCL_SOCKET_RETRY_CNT, (int64_t)3);
+  EnvRAII sleepGuard(NCCL_SOCKET_RETRY_SLEEP_MSEC, (int64_t)1);
+  ncclSocket sock;
+  ASSERT_EQ(
+      ncclSocketInit(&sock, &addr_, NCCL_SOCKET_MAGIC, ncclSocketTypeBootstrap),
+      ncclSuccess);
+  EXPECT_EQ(ncclSocketConnect(&sock), ncclRemoteError);
+  EXPECT_EQ(sock.state, ncclSocketStateError);
+  EXPECT_EQ(ncclSocketClose(&sock), ncclSuccess);
+}
@@ -0,0 +1,160 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "topo.h" // @manual
+#include "xml.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+
+// Topology fusion in ncclTopoGetSystem as the number of local ranks grows, up
+// to an MNNVL clique: the full-size exchange of NCCL_TOPO_XML_MAX_NODES nodes
+// per rank fused with xmlFindNode, versus the compact exchange fused through
+// an index. The bytesExchanged counter is what each rank receives.
+
+namespace {
+
+constexpr int kGpusPerNode = 4;
+
+// One rank of an MNNVL clique: the GPUs of its node, each with NVLinks to
+// the NVSwitches, and the NICs of its node.
+ncclXml* rankXml(int rank) {
+  ncclXml* xml;
+  xmlAlloc(&xml, NCCL_TOPO_XML_MAX_NODES);
+  const int node = rank / kGpusPerNode;
+  ncclXmlNode* system;
+  xmlAddNode(xml, nullptr, "system", &system);
+  xmlSetAttrInt(system, "version", NCCL_TOPO_XML_VERSION);
+  ncclXmlNode* cpu;
+  xmlAddNode(xml, system, "cpu", &cpu);
+  xmlSetAttr(cpu, "host_hash", ("0x" + std::to_string(node)).c_str());
+  xmlSetAttrInt(cpu, "numaid", 0);
+  for (int g = 0; g < kGpusPerNode; g++) {
+    const int gpuRank = node * kGpusPerNode + g;
+    ncclXmlNode* pci;
+    xmlAddNode(xml, cpu, "pci", &pci);
+    xmlSetAttr(pci, "busid", ("0000:" + std::to_string(g) + "1:00.0").c_str());
+    ncclXmlNode* gpu;
+    xmlAddNode(xml, pci, "gpu", &gpu);
+    xmlSetAttrInt(gpu, "dev", g);
+    xmlSetAttrInt(gpu, "rank", gpuRank);
+    ncclXmlNode* nvlink;
+    xmlAddNode(xml, gpu, "nvlink", &nvlink);
+    xmlSetAttr(nvlink, "target", "0000:00:00.0");
+    xmlSetAttrInt(nvlink, "count", 18);
+    ncclXmlNode* nic;
+    xmlAddNode(xml, pci, "nic", &nic);
+    ncclXmlNode* net;
+    xmlAddNode(xml, nic, "net", &net);
+    xmlSetAttr(net, "name", ("mlx5_" + std::to_string(g)).c_str());
+    xmlSetAttrInt(net, "dev", g);
+  }
+  return xml;
+}
+
+struct RankXmls {
+  explicit RankXmls(int nRanks) {
+    for (int r = 0; r < nRanks; r++) {
+      xmls.push_back(rankXml(r));
+    }
+  }
+  ~RankXmls() {
+    for (auto* xml : xmls) {
+      free(xml);
+    }
+  }
+  std::vector<ncclXml*> xmls;
+};
+
+} // namespace
+
+static void BM_FullSizeExchange(benchmark::State& state) {
+  RankXmls ranks(state.range(0));
+  const int nRanks = ranks.xmls.size();
+  const size_t size = xmlMemSize(NCCL_TOPO_XML_MAX_NODES);
+  // As received from the allgather
+  std::vector<char> mem(nRanks * size);
+  for (int r = 0; r < nRanks; r++) {
+    memcpy(mem.data() + r * size, ranks.xmls[r], size);
+    ncclTopoConvertXml(
+        reinterpret_cast<ncclXml*>(mem.data() + r * size),
+        (uintptr_t)ranks.xmls[r]->nodes,
+        1);
+  }
+  std::vector<char> received(mem.size());
+  for (auto _ : state) {
+    memcpy(received.data(), mem.data(), mem.size());
+    ncclXml* xml;
+    xmlAlloc(&xml, nRanks * NCCL_TOPO_XML_MAX_NODES);
+    for (int r = 0; r < nRanks; r++) {
+      auto* peerXml = reinterpret_cast<ncclXml*>(received.data() + r * size);
+      ncclTopoConvertXml(peerXml, (uintptr_t)peerXml->nodes, 0);
+      ncclTopoFuseXml(xml, peerXml);
+    }
+    benchmark::DoNotOptimize(xml->maxIndex);
+    free(xml);
+  }
+  state.counters["bytesExchanged"] = mem.size();
+}
+
+static void BM_CompactExchange(benchmark::State& state) {
+  RankXmls ranks(state.range(0));
+  const int nRanks = ranks.xmls.size();
+  std::vector<size_t> sizes(nRanks);
+  size_t maxSize = 0;
+  for (int r = 0; r < nRanks; r++) {
+    ncclTopoPackXml(ranks.xmls[r], nullptr, &sizes[r]);
+    maxSize = std::max(maxSize, sizes[r]);
+  }
+  std::vector<char> packed(nRanks * maxSize);
+  for (int r = 0; r < nRanks; r++) {
+    ncclTopoPackXml(ranks.xmls[r], packed.data() + r * maxSize, &sizes[r]);
+  }
+  for (auto _ : state) {
+    int totalNodes = 0, maxNodes = 0;
+    for (int r = 0; r < nRanks; r++) {
+      int nNodes;
+      ncclTopoPackedXmlNodes(packed.data() + r * maxSize, sizes[r], &nNodes);
+      totalNodes += nNodes;
+      maxNodes = std::max(maxNodes, nNodes);
+    }
+    ncclXml* xml;
+    xmlAlloc(&xml, std::max(totalNodes, NCCL_TOPO_XML_MAX_NODES));
+    ncclXml* peerXml;
+    xmlAlloc(&peerXml, maxNodes);
+    ncclTopoXmlIndex* index;
+    ncclTopoXmlIndexCreate(&index);
+    for (int r = 0; r < nRanks; r++) {
+      ncclTopoUnpackXml(packed.data() + r * maxSize, sizes[r], peerXml);
+      ncclTopoFuseXmlIndexed(xml, peerXml, index);
+    }
+    benchmark::DoNotOptimize(xml->maxIndex);
+    ncclTopoXmlIndexFree(index);
+    free(peerXml);
+    free(xml);
+  }
+  state.counters["bytesExchanged"] = nRanks * maxSize;
+}
+
+BENCHMARK(BM_FullSizeExchange)
+    ->RangeMultiplier(2)
+    ->Range(8, 64)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CompactExchange)
+    ->RangeMultiplier(2)
+    ->Range(8, 64)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
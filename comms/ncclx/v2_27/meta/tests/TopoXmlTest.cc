@@ -0,0 +1,231 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "topo.h" // @manual
+#include "xml.h" // @manual
+
+namespace {
+
+// XML as one rank of a node would see it: the shared CPUs, switches and NICs,
+// and the GPUs of the ranks it was told about, including its own. Like
+// autodetected ones, the system and CPU nodes are left with NODE_TYPE_NONE.
+ncclXml* rankXml(int rank, int nRanks, int gpusPerCpu = 4) {
+  ncclXml* xml;
+  EXPECT_EQ(xmlAlloc(&xml, NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+  ncclXmlNode* system;
+  xmlAddNode(xml, nullptr, "system", &system);
+  xmlSetAttrInt(system, "version", NCCL_TOPO_XML_VERSION);
+  const int nCpus = (nRanks + gpusPerCpu - 1) / gpusPerCpu;
+  for (int c = 0; c < nCpus; c++) {
+    ncclXmlNode* cpu;
+    xmlAddNode(xml, system, "cpu", &cpu);
+    xmlSetAttrInt(cpu, "numaid", c);
+    xmlSetAttr(cpu, "arch", "x86_64");
+    ncclXmlNode* sw;
+    xmlAddNode(xml, cpu, "pci", &sw);
+    sw->type = NODE_TYPE_OPEN;
+    xmlSetAttr(sw, "busid", ("0000:" + std::to_string(c) + "0:00.0").c_str());
+    for (int g = c * gpusPerCpu; g < (c + 1) * gpusPerCpu && g < nRanks; g++) {
+      // Each rank only knows about itself and its neighbors
+      if (g != rank && g != (rank + 1) % nRanks) {
+        continue;
+      }
+      ncclXmlNode* pci;
+      xmlAddNode(xml, sw, "pci", &pci);
+      pci->type = NODE_TYPE_OPEN;
+      // Attributes set in a different order on different ranks
+      if (rank % 2) {
+        xmlSetAttr(pci, "link_width", "16");
+        xmlSetAttr(
+            pci, "busid", ("0000:" + std::to_string(g) + "1:00.0").c_str());
+      } else {
+        xmlSetAttr(
+            pci, "busid", ("0000:" + std::to_string(g) + "1:00.0").c_str());
+        xmlSetAttr(pci, "link_width", "16");
+      }
+      ncclXmlNode* gpu;
+      xmlAddNode(xml, pci, "gpu", &gpu);
+      gpu->type = NODE_TYPE_OPEN;
+      xmlSetAttrInt(gpu, "dev", g);
+      xmlSetAttrInt(gpu, "rank", g);
+      for (int l = 0; l < 3; l++) {
+        ncclXmlNode* nvlink;
+        xmlAddNode(xml, gpu, "nvlink", &nvlink);
+        nvlink->type = NODE_TYPE_SINGLE;
+        xmlSetAttrInt(nvlink, "target", (g + l + 1) % nRanks);
+        xmlSetAttrInt(nvlink, "count", 2);
+      }
+    }
+    ncclXmlNode* nic;
+    xmlAddNode(xml, sw, "nic", &nic);
+    nic->type = NODE_TYPE_OPEN;
+    ncclXmlNode* net;
+    xmlAddNode(xml, nic, "net", &net);
+    net->type = NODE_TYPE_SINGLE;
+    xmlSetAttr(net, "name", ("mlx5_" + std::to_string(c)).c_str());
+    xmlSetAttrInt(net, "dev", c);
+  }
+  // Trimmed branches stay in nodes, but aren't linked to the tree anymore
+  ncclXmlNode* trimmed;
+  xmlAddNode(xml, system, "pci", &trimmed);
+  trimmed->type = NODE_TYPE_OPEN;
+  xmlSetAttr(trimmed, "busid", "0000:ff:00.0");
+  xmlRemoveNode(trimmed);
+  return xml;
+}
+
+std::vector<char> pack(ncclXml* xml) {
+  size_t size;
+  EXPECT_EQ(ncclTopoPackXml(xml, nullptr, &size), ncclSuccess);
+  std::vector<char> buf(size);
+  size_t packedSize;
+  EXPECT_EQ(ncclTopoPackXml(xml, buf.data(), &packedSize), ncclSuccess);
+  EXPECT_EQ(packedSize, size);
+  return buf;
+}
+
+// Same tree: nodes, attributes in order, and subnodes in order
+void expectSameTree(ncclXmlNode* a, ncclXmlNode* b) {
+  EXPECT_STREQ(a->name, b->name);
+  EXPECT_EQ(a->type, b->type);
+  ASSERT_EQ(a->nAttrs, b->nAttrs) << a->name;
+  for (int i = 0; i < a->nAttrs; i++) {
+    EXPECT_STREQ(a->attrs[i].key, b->attrs[i].key);
+    EXPECT_STREQ(a->attrs[i].value, b->attrs[i].value);
+  }
+  ASSERT_EQ(a->nSubs, b->nSubs) << a->name;
+  for (int i = 0; i < a->nSubs; i++) {
+    EXPECT_EQ(a->subs[i]->parent, a);
+    EXPECT_EQ(b->subs[i]->parent, b);
+    expectSameTree(a->subs[i], b->subs[i]);
+  }
+}
+
+// Fuses the rank XMLs as ncclTopoGetSystem does, through the full-size
+// exchange or the compact one
+ncclXml* fuse(const std::vector<ncclXml*>& xmls, bool compact) {
+  const int nRanks = xmls.size();
+  ncclXml* dst;
+  EXPECT_EQ(xmlAlloc(&dst, nRanks * NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+  if (!compact) {
+    const size_t size = xmlMemSize(NCCL_TOPO_XML_MAX_NODES);
+    std::vector<char> mem(size);
+    for (auto* xml : xmls) {
+      memcpy(mem.data(), xml, size);
+      auto* peerXml = reinterpret_cast<ncclXml*>(mem.data());
+      EXPECT_EQ(
+          ncclTopoConvertXml(peerXml, (uintptr_t)xml->nodes, 1), ncclSuccess);
+      EXPECT_EQ(
+          ncclTopoConvertXml(peerXml, (uintptr_t)peerXml->nodes, 0),
+          ncclSuccess);
+      EXPECT_EQ(ncclTopoFuseXml(dst, peerXml), ncclSuccess);
+    }
+    return dst;
+  }
+  ncclXml* peerXml;
+  EXPECT_EQ(xmlAlloc(&peerXml, NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+  ncclTopoXmlIndex* index;
+  EXPECT_EQ(ncclTopoXmlIndexCreate(&index), ncclSuccess);
+  for (auto* xml : xmls) {
+    auto buf = pack(xml);
+    EXPECT_EQ(
+        ncclTopoUnpackXml(buf.data(), buf.size(), peerXml), ncclSuccess);
+    EXPECT_EQ(ncclTopoFuseXmlIndexed(dst, peerXml, index), ncclSuccess);
+  }
+  ncclTopoXmlIndexFree(index);
+  free(peerXml);
+  return dst;
+}
+
+} // namespace
+
+TEST(TopoXmlTest, PackUnpackRoundTrip) {
+  ncclXml* xml = rankXml(3, 8);
+  auto buf = pack(xml);
+  // Much smaller than the full-size XML, and without the trimmed branch
+  EXPECT_LT(buf.size(), xmlMemSize(NCCL_TOPO_XML_MAX_NODES) / 100);
+  int nNodes;
+  ASSERT_EQ(
+      ncclTopoPackedXmlNodes(buf.data(), buf.size(), &nNodes), ncclSuccess);
+  EXPECT_EQ(nNodes, xml->maxIndex - 1);
+
+  ncclXml* unpacked;
+  ASSERT_EQ(xmlAlloc(&unpacked, nNodes), ncclSuccess);
+  ASSERT_EQ(
+      ncclTopoUnpackXml(buf.data(), buf.size(), unpacked), ncclSuccess);
+  EXPECT_EQ(unpacked->maxIndex, nNodes);
+  EXPECT_EQ(unpacked->nodes[0].parent, nullptr);
+  expectSameTree(xml->nodes, unpacked->nodes);
+  free(unpacked);
+  free(xml);
+}
+
+TEST(TopoXmlTest, UnpackRejectsBadBuffers) {
+  ncclXml* xml = rankXml(0, 4);
+  auto buf = pack(xml);
+  ncclXml* unpacked;
+  ASSERT_EQ(xmlAlloc(&unpacked, NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+  for (size_t size : {size_t(0), size_t(8), buf.size() / 2, buf.size() - 1}) {
+    EXPECT_NE(ncclTopoUnpackXml(buf.data(), size, unpacked), ncclSuccess)
+        << size;
+  }
+  auto corrupt = buf;
+  corrupt[0] ^= 1;
+  EXPECT_NE(
+      ncclTopoUnpackXml(corrupt.data(), corrupt.size(), unpacked),
+      ncclSuccess);
+  // Not enough room for the nodes
+  unpacked->maxNodes = 4;
+  EXPECT_NE(
+      ncclTopoUnpackXml(buf.data(), buf.size(), unpacked), ncclSuccess);
+  free(unpacked);
+  free(xml);
+}
+
+TEST(TopoXmlTest, CompactFuseMatchesFullSize) {
+  for (int nRanks : {1, 2, 3, 8, 16}) {
+    std::vector<ncclXml*> xmls;
+    for (int r = 0; r < nRanks; r++) {
+      xmls.push_back(rankXml(r, nRanks));
+    }
+    ncclXml* legacy = fuse(xmls, false);
+    ncclXml* compact = fuse(xmls, true);
+    EXPECT_EQ(legacy->maxIndex, compact->maxIndex) << nRanks;
+    expectSameTree(legacy->nodes, compact->nodes);
+    free(legacy);
+    free(compact);
+    for (auto* xml : xmls) {
+      free(xml);
+    }
+  }
+}
+
+TEST(TopoXmlTest, IndexedFuseHandlesDuplicateKeys) {
+  // Matched by xmlFindNode since both attributes look the same up
+  ncclXml* dst;
+  ncclXml* src;
+  ASSERT_EQ(xmlAlloc(&dst, 16), ncclSuccess);
+  ASSERT_EQ(xmlAlloc(&src, 16), ncclSuccess);
+  for (auto* xml : {dst, src}) {
+    ncclXmlNode* system;
+    xmlAddNode(xml, nullptr, "system", &system);
+    ncclXmlNode* node;
+    xmlAddNode(xml, system, "pci", &node);
+    node->nAttrs = 2;
+    strcpy(node->attrs[0].key, "busid");
+    strcpy(node->attrs[0].value, "0000:01:00.0");
+    strcpy(node->attrs[1].key, xml == dst ? "class" : "busid");
+    strcpy(node->attrs[1].value, xml == dst ? "0x0604" : "0000:01:00.0");
+  }
+  ncclTopoXmlIndex* index;
+  ASSERT_EQ(ncclTopoXmlIndexCreate(&index), ncclSuccess);
+  ASSERT_EQ(ncclTopoFuseXmlIndexed(dst, src, index), ncclSuccess);
+  EXPECT_EQ(dst->maxIndex, 2);
+  EXPECT_EQ(dst->nodes[0].nSubs, 1);
+  ncclTopoXmlIndexFree(index);
+  free(dst);
+  free(src);
+}
@@ -0,0 +1,169 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/topology/TopoPathCache.h"
+
+#include "debug.h"
+
+namespace ncclx::topology {
+
+void TopoBasePaths::resize(size_t nNodes) {
+  link.assign(nNodes, -1);
+  count.assign(nNodes, 0);
+  bw.assign(nNodes, 0);
+  type.assign(nNodes, 0);
+  relay.assign(nNodes, 0);
+  order.clear();
+}
+
+bool TopoPathCache::mapGraph(
+    const TopoGraph& graph,
+    std::vector<int32_t>* nodeMap,
+    std::vector<std::vector<int16_t>>* linkMap) const {
+  if (graph.ids.size() != graph_.ids.size()) {
+    return false;
+  }
+  // Removed nodes are moved out, so the others keep their order
+  nodeMap->assign(graph_.links.size(), -1);
+  int oldOffset = 0, newOffset = 0;
+  for (size_t t = 0; t < graph.ids.size(); t++) {
+    const auto& oldIds = graph_.ids[t];
+    const auto& newIds = graph.ids[t];
+    size_t o = 0;
+    for (size_t n = 0; n < newIds.size(); n++, o++) {
+      while (o < oldIds.size() && oldIds[o] != newIds[n]) {
+        o++;
+      }
+      if (o == oldIds.size()) {
+        return false;
+      }
+      (*nodeMap)[oldOffset + o] = newOffset + n;
+    }
+    oldOffset += oldIds.size();
+    newOffset += newIds.size();
+  }
+
+  // Links to removed nodes are moved out too, nothing else may change
+  linkMap->assign(graph_.links.size(), {});
+  for (size_t o = 0; o < graph_.links.size(); o++) {
+    const int n = (*nodeMap)[o];
+    if (n == -1) {
+      continue;
+    }
+    const auto& oldLinks = graph_.links[o];
+    const auto& newLinks = graph.links[n];
+    auto& map = (*linkMap)[o];
+    map.assign(oldLinks.size(), -1);
+    size_t k = 0;
+    for (size_t l = 0; l < oldLinks.size(); l++) {
+      TopoGraphLink link = oldLinks[l];
+      link.remNode = (*nodeMap)[link.remNode];
+      if (link.remNode == -1) {
+        continue;
+      }
+      if (k == newLinks.size() || !(newLinks[k] == link)) {
+        return false;
+      }
+      map[l] = k++;
+    }
+    if (k != newLinks.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TopoPathCache::update(TopoGraph graph, bool nvbDisable) {
+  std::vector<int32_t> nodeMap;
+  std::vector<std::vector<int16_t>> linkMap;
+  if (nvbDisable != nvbDisable_ || !mapGraph(graph, &nodeMap, &linkMap)) {
+    if (size()) {
+      INFO(
+          NCCL_GRAPH,
+          "TopoPathCache: topology changed, dropping paths of %zu nodes",
+          size());
+      invalidations_++;
+    }
+    clear();
+  } else {
+    std::vector<int32_t> removed;
+    for (size_t o = 0; o < nodeMap.size(); o++) {
+      if (nodeMap[o] == -1) {
+        removed.push_back(o);
+      }
+    }
+    for (size_t t = 0; t < paths_.size(); t++) {
+      std::unordered_map<int64_t, int32_t> oldIndex;
+      for (size_t i = 0; i < graph_.ids[t].size(); i++) {
+        oldIndex[graph_.ids[t][i]] = graph_.nodeIndex(t, i);
+      }
+      for (auto it = paths_[t].begin(); it != paths_[t].end();) {
+        const TopoBasePaths& old = it->second;
+        bool valid = nodeMap[oldIndex[it->first]] != -1;
+        for (int32_t r : removed) {
+          valid = valid && !old.relay[r];
+        }
+        TopoBasePaths renumbered;
+        renumbered.resize(graph.links.size());
+        for (size_t o = 0; valid && o < nodeMap.size(); o++) {
+          const int n = nodeMap[o];
+          if (n == -1) {
+            continue;
+          }
+          if (old.link[o] != -1) {
+            renumbered.link[n] = linkMap[o][old.link[o]];
+            // The node it leads to relayed the path, so it can't be removed
+            valid = renumbered.link[n] != -1;
+          }
+          renumbered.count[n] = old.count[o];
+          renumbered.bw[n] = old.bw[o];
+          renumbered.type[n] = old.type[o];
+          renumbered.relay[n] = old.relay[o];
+        }
+        if (!valid) {
+          it = paths_[t].erase(it);
+          continue;
+        }
+        for (int32_t o : old.order) {
+          if (nodeMap[o] != -1) {
+            renumbered.order.push_back(nodeMap[o]);
+          }
+        }
+        it->second = std::move(renumbered);
+        ++it;
+      }
+    }
+  }
+  graph_ = std::move(graph);
+  nvbDisable_ = nvbDisable;
+  paths_.resize(graph_.ids.size());
+}
+
+const TopoBasePaths* TopoPathCache::find(int type, int64_t id) const {
+  if (type < static_cast<int>(paths_.size())) {
+    auto it = paths_[type].find(id);
+    if (it != paths_[type].end()) {
+      hits_++;
+      return &it->second;
+    }
+  }
+  misses_++;
+  return nullptr;
+}
+
+void TopoPathCache::insert(int type, int64_t id, TopoBasePaths paths) {
+  paths_[type][id] = std::move(paths);
+}
+
+size_t TopoPathCache::size() const {
+  size_t size = 0;
+  for (const auto& paths : paths_) {
+    size += paths.size();
+  }
+  return size;
+}
+
+void TopoPathCache::clear() {
+  paths_.clear();
+}
+
+} // namespace ncclx::topology
@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace ncclx::topology {
+
+// Pointer-free copy of the topology graph paths were computed on. Nodes are
+// numbered type by type, in the order of ncclTopoSystem::nodes, and links
+// refer to that numbering.
+struct TopoGraphLink {
+  int32_t remNode{0};
+  int32_t type{0};
+  float bw{0};
+
+  bool operator==(const TopoGraphLink& other) const {
+    return remNode == other.remNode && type == other.type && bw == other.bw;
+  }
+};
+
+struct TopoGraph {
+  // Node ids, by type
+  std::vector<std::vector<int64_t>> ids;
+  // Links of each node, in the order of ncclTopoNode::links
+  std::vector<std::vector<TopoGraphLink>> links;
+
+  int nodeIndex(int type, int index) const {
+    int offset = 0;
+    for (int t = 0; t < type; t++) {
+      offset += ids[t].size();
+    }
+    return offset + index;
+  }
+};
+
+// Result of the breadth-first search of ncclTopoSetPaths() from one base
+// node, as arrays over all nodes. A path is its first link followed by the
+// path of the node that link leads to, so only the first link is kept.
+struct TopoBasePaths {
+  std::vector<int16_t> link; // Index of the first link, -1 if none
+  std::vector<int16_t> count;
+  std::vector<float> bw;
+  std::vector<int8_t> type;
+  // Whether the node set or improved the path of a neighbor during the
+  // search. Only such nodes can change the result when they are removed.
+  std::vector<uint8_t> relay;
+  // Nodes with a path, by increasing count
+  std::vector<int32_t> order;
+
+  void resize(size_t nNodes);
+};
+
+// Paths from every base node, kept across ncclTopoComputePaths() calls. When
+// the graph only lost nodes since the last call, e.g. after
+// ncclTopoTrimSystem(), the search from a base node gives the same paths as
+// before unless a removed node relayed one of them; those are reused instead
+// of searched again. Any other change to the graph drops everything.
+class TopoPathCache {
+ public:
+  // Compare graph to the one the cached paths were computed on, and keep the
+  // paths that are still valid, renumbered for graph.
+  void update(TopoGraph graph, bool nvbDisable);
+
+  const TopoBasePaths* find(int type, int64_t id) const;
+  void insert(int type, int64_t id, TopoBasePaths paths);
+
+  const TopoGraph& graph() const {
+    return graph_;
+  }
+  size_t size() const;
+  uint64_t hits() const {
+    return hits_;
+  }
+  uint64_t misses() const {
+    return misses_;
+  }
+  uint64_t invalidations() const {
+    return invalidations_;
+  }
+
+ private:
+  // Maps nodes and links of graph_ to those of graph, or returns false if
+  // graph isn't graph_ with some nodes removed.
+  bool mapGraph(
+      const TopoGraph& graph,
+      std::vector<int32_t>* nodeMap,
+      std::vector<std::vector<int16_t>>* linkMap) const;
+  void clear();
+
+  TopoGraph graph_;
+  bool nvbDisable_{false};
+  // By base node type, then id
+  std::vector<std::unordered_map<int64_t, TopoBasePaths>> paths_;
+  mutable uint64_t hits_{0};
+  mutable uint64_t misses_{0};
+  uint64_t invalidations_{0};
+};
+
+} // namespace ncclx::topology
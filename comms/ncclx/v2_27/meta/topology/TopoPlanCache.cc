@@ -0,0 +1,144 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/topology/TopoPlanCache.h"
+
+#include <cstring>
+
+#include "debug.h"
+
+namespace ncclx::topology {
+
+void TopoSignature::append(int64_t word) {
+  words_.push_back(word);
+  // FNV-1a, one byte at a time
+  for (int i = 0; i < 8; i++) {
+    hash_ ^= (static_cast<uint64_t>(word) >> (8 * i)) & 0xff;
+    hash_ *= 0x100000001b3ULL;
+  }
+}
+
+void TopoSignature::append(float value) {
+  int32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  append(static_cast<int64_t>(bits));
+}
+
+TopoPlanCache& TopoPlanCache::get() {
+  // Leaked, communicators may be destroyed during static destruction
+  static TopoPlanCache* cache = new TopoPlanCache();
+  return *cache;
+}
+
+TopoPlan* TopoPlanCache::find(const TopoSignature& signature) {
+  for (auto it = plans_.begin(); it != plans_.end(); ++it) {
+    if (it->first == signature) {
+      plans_.splice(plans_.begin(), plans_, it);
+      return &plans_.front().second;
+    }
+  }
+  return nullptr;
+}
+
+TopoPlan* TopoPlanCache::findOrInsert(const TopoSignature& signature) {
+  TopoPlan* plan = find(signature);
+  if (plan) {
+    return plan;
+  }
+  if (plans_.size() == kMaxPlans) {
+    INFO(
+        NCCL_GRAPH,
+        "TopoPlanCache: dropping plans of a topology of %zu words",
+        plans_.back().first.size());
+    plans_.pop_back();
+  }
+  plans_.emplace_front(signature, TopoPlan());
+  return &plans_.front().second;
+}
+
+std::optional<int> TopoPlanCache::findP2pMinChannels(
+    const TopoSignature& signature,
+    int nRanks,
+    int p2pnChannels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TopoPlan* plan = find(signature);
+  if (plan) {
+    auto it = plan->p2pMinChannels.find({nRanks, p2pnChannels});
+    if (it != plan->p2pMinChannels.end()) {
+      hits_++;
+      return it->second;
+    }
+  }
+  misses_++;
+  return std::nullopt;
+}
+
+void TopoPlanCache::insertP2pMinChannels(
+    const TopoSignature& signature,
+    int nRanks,
+    int p2pnChannels,
+    int minChannels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  findOrInsert(signature)->p2pMinChannels[{nRanks, p2pnChannels}] =
+      minChannels;
+}
+
+bool TopoPlanCache::findPxnProxies(
+    const TopoSignature& signature,
+    int gpu,
+    std::vector<int>* proxies) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TopoPlan* plan = find(signature);
+  if (plan && gpu < static_cast<int>(plan->pxnProxies.size()) &&
+      plan->pxnProxies[gpu].size() == proxies->size()) {
+    *proxies = plan->pxnProxies[gpu];
+    hits_++;
+    return true;
+  }
+  misses_++;
+  return false;
+}
+
+void TopoPlanCache::insertPxnProxies(
+    const TopoSignature& signature,
+    int gpu,
+    const std::vector<int>& proxies) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TopoPlan* plan = findOrInsert(signature);
+  if (gpu >= static_cast<int>(plan->pxnProxies.size())) {
+    plan->pxnProxies.resize(gpu + 1);
+  }
+  auto& known = plan->pxnProxies[gpu];
+  if (known.size() != proxies.size()) {
+    known = proxies;
+    return;
+  }
+  for (size_t p = 0; p < proxies.size(); p++) {
+    if (proxies[p] != kPxnProxyUnknown) {
+      known[p] = proxies[p];
+    }
+  }
+}
+
+size_t TopoPlanCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return plans_.size();
+}
+
+uint64_t TopoPlanCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t TopoPlanCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void TopoPlanCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  plans_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+} // namespace ncclx::topology
@@ -0,0 +1,103 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ncclx::topology {
+
+// Everything about the topology of a communicator the P2P channel and PXN
+// plans are computed from, except ranks: the graph, GPU and NIC attributes,
+// the paths from GPUs and NICs hop by hop, and the settings involved. Two
+// systems with the same signature give the same plans for the same GPUs.
+class TopoSignature {
+ public:
+  void append(int64_t word);
+  void append(float value);
+
+  bool operator==(const TopoSignature& other) const {
+    return hash_ == other.hash_ && words_ == other.words_;
+  }
+  uint64_t hash() const {
+    return hash_;
+  }
+  size_t size() const {
+    return words_.size();
+  }
+
+ private:
+  std::vector<int64_t> words_;
+  uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+// Local PXN proxy of a GPU not looked up yet, as opposed to -1 for none
+constexpr int kPxnProxyUnknown = -2;
+
+// Plans for one signature. GPUs are indices into the system's GPU nodes;
+// ranks only come in when a communicator applies a plan, so communicators
+// ranked differently on the same topology, e.g. splits, share them.
+struct TopoPlan {
+  // Fewest channels any peer needs in ncclTopoComputeP2pChannels(), by
+  // nRanks and p2pnChannels
+  std::map<std::pair<int, int>, int> p2pMinChannels;
+  // By GPU, then by the GPU peers' NVML device maps to: the GPU acting as
+  // PXN proxy for those peers in ncclTopoGetPxnRanks(), or -1 for none
+  std::vector<std::vector<int>> pxnProxies;
+};
+
+// Plans of the topologies communicators were created on, shared by all
+// communicators of the process. Communicators may be initialized from
+// several threads, so it is locked.
+class TopoPlanCache {
+ public:
+  static TopoPlanCache& get();
+
+  std::optional<int> findP2pMinChannels(
+      const TopoSignature& signature,
+      int nRanks,
+      int p2pnChannels);
+  void insertP2pMinChannels(
+      const TopoSignature& signature,
+      int nRanks,
+      int p2pnChannels,
+      int minChannels);
+
+  // Fills proxies with what is known for gpu, and returns whether anything
+  // was. proxies must be sized for all GPUs of the system.
+  bool findPxnProxies(
+      const TopoSignature& signature,
+      int gpu,
+      std::vector<int>* proxies);
+  // Merges proxies into what is known for gpu
+  void insertPxnProxies(
+      const TopoSignature& signature,
+      int gpu,
+      const std::vector<int>& proxies);
+
+  size_t size() const;
+  uint64_t hits() const;
+  uint64_t misses() const;
+  void clear();
+
+  // Signatures kept, least recently used ones are dropped first
+  static constexpr size_t kMaxPlans = 16;
+
+ private:
+  TopoPlan* find(const TopoSignature& signature);
+  TopoPlan* findOrInsert(const TopoSignature& signature);
+
+  mutable std::mutex mutex_;
+  // Most recently used first
+  std::list<std::pair<TopoSignature, TopoPlan>> plans_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+} // namespace ncclx::topology
@@ -0,0 +1,133 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+
+#include <folly/init/Init.h>
+
+#include "graph.h" // @manual
+#include "topo.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/topology/TopoPathCache.h"
+
+// Path computation of communicator init on an MNNVL clique as the number of
+// hosts grows: ncclTopoComputePaths() on the full system, then again once
+// ncclTopoTrimSystem() removed the NICs. The second search is done from
+// scratch, or mostly restored from the TopoPathCache of the first one.
+
+namespace {
+
+constexpr int kCpusPerHost = 2;
+constexpr int kGpusPerCpu = 2;
+
+void connect(ncclTopoNode* a, ncclTopoNode* b, int type, float bw) {
+  ncclTopoConnectNodes(a, b, type, bw);
+  ncclTopoConnectNodes(b, a, type, bw);
+}
+
+// Per CPU, one PCI switch with GPUs and NICs under it. All GPUs are connected
+// to the NVSwitch, and CPUs of a host to each other.
+ncclTopoSystem* cliqueSystem(int nHosts) {
+  auto* system =
+      static_cast<ncclTopoSystem*>(calloc(1, sizeof(ncclTopoSystem)));
+  ncclTopoNode* nvs;
+  ncclTopoCreateNode(system, &nvs, NVS, 0);
+  for (int h = 0; h < nHosts; h++) {
+    for (int c = 0; c < kCpusPerHost; c++) {
+      const int64_t cpuId = NCCL_TOPO_ID(h, c);
+      ncclTopoNode* cpu;
+      ncclTopoCreateNode(system, &cpu, CPU, cpuId);
+      cpu->cpu.arch = NCCL_TOPO_CPU_ARCH_X86;
+      ncclTopoNode* sw;
+      ncclTopoCreateNode(system, &sw, PCI, cpuId);
+      connect(cpu, sw, LINK_PCI, 24.0);
+      for (int g = 0; g < kGpusPerCpu; g++) {
+        const int64_t id = NCCL_TOPO_ID(h, (c + 1) * 0x100 + g);
+        ncclTopoNode* gpu;
+        ncclTopoCreateNode(system, &gpu, GPU, id);
+        gpu->gpu.dev = c * kGpusPerCpu + g;
+        gpu->gpu.rank = (h * kCpusPerHost + c) * kGpusPerCpu + g;
+        connect(sw, gpu, LINK_PCI, 24.0);
+        connect(gpu, nvs, LINK_NVL, 18 * SM90_NVLINK_BW);
+        ncclTopoNode* net;
+        ncclTopoCreateNode(system, &net, NET, id);
+        connect(sw, net, LINK_PCI, 24.0);
+      }
+    }
+    for (int c = 1; c < kCpusPerHost; c++) {
+      const int first = h * kCpusPerHost;
+      connect(
+          system->nodes[CPU].nodes + first,
+          system->nodes[CPU].nodes + first + c,
+          LINK_SYS,
+          SKL_QPI_BW);
+    }
+  }
+  return system;
+}
+
+void freePaths(ncclTopoSystem* system) {
+  for (int t = 0; t < NCCL_TOPO_NODE_TYPES; t++) {
+    for (int n = 0; n < system->nodes[t].count; n++) {
+      for (int p = 0; p < NCCL_TOPO_NODE_TYPES; p++) {
+        free(system->nodes[t].nodes[n].paths[p]);
+        system->nodes[t].nodes[n].paths[p] = nullptr;
+      }
+    }
+  }
+}
+
+void computeAndTrim(benchmark::State& state, bool pathCache) {
+  NCCL_TOPO_PATH_CACHE = pathCache;
+  uint64_t hits = 0, misses = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ncclTopoSystem* system = cliqueSystem(state.range(0));
+    ncclTopoSetAllPaths(system);
+    for (int n = system->nodes[NET].count - 1; n >= 0; n--) {
+      ncclTopoRemoveNode(system, NET, n);
+    }
+    freePaths(system);
+    state.ResumeTiming();
+    ncclTopoSetAllPaths(system);
+    state.PauseTiming();
+    if (system->pathCache) {
+      hits += system->pathCache->hits();
+      misses += system->pathCache->misses();
+    }
+    ncclTopoFree(system);
+    state.ResumeTiming();
+  }
+  state.counters["gpus"] = state.range(0) * kCpusPerHost * kGpusPerCpu;
+  if (pathCache) {
+    state.counters["hitRate"] = static_cast<double>(hits) / (hits + misses);
+  }
+}
+
+} // namespace
+
+static void BM_FullSearch(benchmark::State& state) {
+  computeAndTrim(state, false);
+}
+
+static void BM_PathCache(benchmark::State& state) {
+  computeAndTrim(state, true);
+}
+
+BENCHMARK(BM_FullSearch)
+    ->RangeMultiplier(2)
+    ->Range(2, 16)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathCache)
+    ->RangeMultiplier(2)
+    ->Range(2, 16)
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <folly/testing/TestUtil.h>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+
+#include "topo.h" // @manual
+#include "xml.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/topology/TopoPathCache.h"
+#include "meta/topology/tests/TopoTestUtil.h"
+
+namespace {
+
+class TopoPathCacheTest : public ::testing::TestWithParam<TopoShape> {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+    savedPathCache_ = NCCL_TOPO_PATH_CACHE;
+    std::ofstream(xmlFile_.path().string()) << topoXml(GetParam());
+  }
+  void TearDown() override {
+    NCCL_TOPO_PATH_CACHE = savedPathCache_;
+  }
+
+  ncclTopoSystem* loadSystem() {
+    ncclXml* xml;
+    EXPECT_EQ(xmlAlloc(&xml, NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+    EXPECT_EQ(
+        ncclTopoGetXmlFromFile(xmlFile_.path().c_str(), xml, 1), ncclSuccess);
+    ncclTopoSystem* system = nullptr;
+    EXPECT_EQ(ncclTopoGetSystemFromXml(xml, &system, kHostHash), ncclSuccess);
+    free(xml);
+    return system;
+  }
+
+  // Paths as computed from scratch, and through the cache
+  void setAllPaths(ncclTopoSystem* reference, ncclTopoSystem* cached) {
+    NCCL_TOPO_PATH_CACHE = false;
+    ASSERT_EQ(ncclTopoSetAllPaths(reference), ncclSuccess);
+    NCCL_TOPO_PATH_CACHE = true;
+    ASSERT_EQ(ncclTopoSetAllPaths(cached), ncclSuccess);
+  }
+
+  // As ncclTopoComputePaths() does before setting them again
+  static void freePaths(ncclTopoSystem* system) {
+    for (int t = 0; t < NCCL_TOPO_NODE_TYPES; t++) {
+      for (int n = 0; n < system->nodes[t].count; n++) {
+        for (int p = 0; p < NCCL_TOPO_NODE_TYPES; p++) {
+          free(system->nodes[t].nodes[n].paths[p]);
+          system->nodes[t].nodes[n].paths[p] = nullptr;
+        }
+      }
+    }
+  }
+
+  static void removeNode(ncclTopoSystem* system, int type, int index) {
+    ASSERT_EQ(ncclTopoRemoveNode(system, type, index), ncclSuccess);
+    freePaths(system);
+  }
+
+  // Same paths, down to the links they go through. Both systems were built
+  // the same way, so those are at the same offsets.
+  static void expectSamePaths(ncclTopoSystem* a, ncclTopoSystem* b) {
+    auto offset = [](ncclTopoSystem* system, ncclTopoLink* link) {
+      return reinterpret_cast<char*>(link) - reinterpret_cast<char*>(system);
+    };
+    for (int t = 0; t < NCCL_TOPO_NODE_TYPES; t++) {
+      ASSERT_EQ(a->nodes[t].count, b->nodes[t].count);
+      for (int n = 0; n < a->nodes[t].count; n++) {
+        ncclTopoNode* nodeA = a->nodes[t].nodes + n;
+        ncclTopoNode* nodeB = b->nodes[t].nodes + n;
+        for (int p = 0; p < NCCL_TOPO_NODE_TYPES; p++) {
+          ASSERT_EQ(nodeA->paths[p] == nullptr, nodeB->paths[p] == nullptr)
+              << "node " << t << "/" << n << " paths to " << p;
+          if (nodeA->paths[p] == nullptr) {
+            continue;
+          }
+          for (int i = 0; i < a->nodes[p].count; i++) {
+            ncclTopoLinkList* pathA = nodeA->paths[p] + i;
+            ncclTopoLinkList* pathB = nodeB->paths[p] + i;
+            ASSERT_EQ(pathA->count, pathB->count);
+            EXPECT_EQ(pathA->bw, pathB->bw);
+            EXPECT_EQ(pathA->type, pathB->type);
+            for (int h = 0; h < pathA->count; h++) {
+              EXPECT_EQ(offset(a, pathA->list[h]), offset(b, pathB->list[h]))
+                  << "node " << t << "/" << n << " path to " << p << "/" << i
+                  << " hop " << h;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  folly::test::TemporaryFile xmlFile_;
+  bool savedPathCache_{true};
+};
+
+} // namespace
+
+TEST_P(TopoPathCacheTest, SameAsFullSearch) {
+  ncclTopoSystem* reference = loadSystem();
+  ncclTopoSystem* cached = loadSystem();
+  setAllPaths(reference, cached);
+  expectSamePaths(reference, cached);
+  EXPECT_EQ(cached->pathCache->hits(), 0);
+
+  // Nothing changed: every path is restored from the cache
+  for (ncclTopoSystem* system : {reference, cached}) {
+    freePaths(system);
+  }
+  setAllPaths(reference, cached);
+  expectSamePaths(reference, cached);
+  EXPECT_EQ(cached->pathCache->hits(), cached->pathCache->misses());
+  ncclTopoFree(reference);
+  ncclTopoFree(cached);
+}
+
+TEST_P(TopoPathCacheTest, SameAfterTrimming) {
+  ncclTopoSystem* reference = loadSystem();
+  ncclTopoSystem* cached = loadSystem();
+  setAllPaths(reference, cached);
+  // Like ncclTopoTrimSystem(): GPUs of other domains, then all NICs
+  for (ncclTopoSystem* system : {reference, cached}) {
+    for (int g = system->nodes[GPU].count - 1; g >= 0; g -= 3) {
+      removeNode(system, GPU, g);
+    }
+  }
+  setAllPaths(reference, cached);
+  expectSamePaths(reference, cached);
+  // GPUs only relay paths over one NVLink hop to another GPU, so at least the
+  // paths to CPUs are unchanged
+  const uint64_t hits = cached->pathCache->hits();
+  EXPECT_GT(hits, 0);
+
+  for (ncclTopoSystem* system : {reference, cached}) {
+    for (int n = system->nodes[NET].count - 1; n >= 0; n--) {
+      removeNode(system, NET, n);
+    }
+  }
+  setAllPaths(reference, cached);
+  expectSamePaths(reference, cached);
+  // NICs are leaves, they relay nothing
+  EXPECT_GT(cached->pathCache->hits(), hits);
+  ncclTopoFree(reference);
+  ncclTopoFree(cached);
+}
+
+TEST_P(TopoPathCacheTest, OtherChangesDropTheCache) {
+  ncclTopoSystem* reference = loadSystem();
+  ncclTopoSystem* cached = loadSystem();
+  setAllPaths(reference, cached);
+  // As left by a search which didn't give all bandwidth back exactly
+  for (ncclTopoSystem* system : {reference, cached}) {
+    system->nodes[GPU].nodes[0].links[0].bw -= 1.0f;
+    freePaths(system);
+  }
+  setAllPaths(reference, cached);
+  expectSamePaths(reference, cached);
+  EXPECT_EQ(cached->pathCache->invalidations(), 1);
+  ncclTopoFree(reference);
+  ncclTopoFree(cached);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TopoPathCache,
+    TopoPathCacheTest,
+    ::testing::Values(
+        TopoShape{1, 2, 4, true},
+        TopoShape{1, 2, 4, false},
+        TopoShape{1, 1, 2, false},
+        TopoShape{4, 2, 2, true}),
+    [](const ::testing::TestParamInfo<TopoShape>& info) {
+      return std::to_string(info.param.nHosts) + "hosts_" +
+          std::to_string(info.param.nCpus * info.param.nGpus) + "gpus_" +
+          (info.param.nvSwitch ? "nvs" : "ring");
+    });
@@ -0,0 +1,236 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <folly/testing/TestUtil.h>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "comm.h" // @manual
+#include "graph.h" // @manual
+#include "topo.h" // @manual
+#include "xml.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/topology/TopoPlanCache.h"
+#include "meta/topology/tests/TopoTestUtil.h"
+
+using ncclx::topology::TopoPlanCache;
+using ncclx::topology::TopoSignature;
+
+namespace {
+
+constexpr int kNodes = 16;
+
+// How a communicator ranks the GPUs: its ranks are node after node, with
+// this node at position node. Within a node, local rank i is on GPU i, or
+// on the GPU with the reverse index.
+struct Ranking {
+  int nNodes;
+  int node;
+  bool reversed;
+};
+
+// A communicator on the local host of the system, as far as the P2P channel
+// and PXN computations are concerned
+struct FakeComm {
+  FakeComm(ncclTopoSystem* system, const Ranking& ranking, int gpu)
+      : comm(std::make_unique<ncclComm>()), system(system) {
+    const int nGpus = system->nodes[GPU].count;
+    auto nvmlDev = [&](int localRank) {
+      return ranking.reversed ? nGpus - 1 - localRank : localRank;
+    };
+    for (int g = 0; g < nGpus; g++) {
+      ncclTopoNode* node = system->nodes[GPU].nodes + g;
+      node->gpu.rank = ranking.node * nGpus + nvmlDev(node->gpu.dev);
+    }
+    peerInfo.resize(ranking.nNodes * nGpus);
+    for (int rank = 0; rank < static_cast<int>(peerInfo.size()); rank++) {
+      peerInfo[rank].nvmlDev = nvmlDev(rank % nGpus);
+    }
+    sharedRes.owner = comm.get();
+    comm->topo = system;
+    comm->rank = system->nodes[GPU].nodes[gpu].gpu.rank;
+    comm->nRanks = peerInfo.size();
+    comm->peerInfo = peerInfo.data();
+    comm->sharedRes = &sharedRes;
+    comm->nChannels = 16;
+    comm->lazySetupChannels = true;
+    comm->ncclNetVer = 10;
+  }
+
+  std::vector<int> pxnRanks() {
+    int* ranks = nullptr;
+    int nRanks = 0;
+    EXPECT_EQ(ncclTopoGetPxnRanks(comm.get(), &ranks, &nRanks), ncclSuccess);
+    std::vector<int> result(ranks, ranks + nRanks);
+    free(ranks);
+    return result;
+  }
+
+  std::pair<int, int> p2pChannels() {
+    EXPECT_EQ(ncclTopoComputeP2pChannels(comm.get()), ncclSuccess);
+    return {comm->p2pnChannels, comm->p2pnChannelsPerPeer};
+  }
+
+  std::unique_ptr<ncclComm> comm;
+  ncclTopoSystem* system;
+  std::vector<ncclPeerInfo> peerInfo;
+  ncclSharedResources sharedRes{};
+};
+
+class TopoPlanCacheTest : public ::testing::TestWithParam<TopoShape> {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+    savedPlanCache_ = NCCL_TOPO_PLAN_CACHE;
+    TopoPlanCache::get().clear();
+    std::ofstream(xmlFile_.path().string()) << topoXml(GetParam());
+  }
+  void TearDown() override {
+    NCCL_TOPO_PLAN_CACHE = savedPlanCache_;
+    TopoPlanCache::get().clear();
+  }
+
+  ncclTopoSystem* loadSystem() {
+    ncclXml* xml;
+    EXPECT_EQ(xmlAlloc(&xml, NCCL_TOPO_XML_MAX_NODES), ncclSuccess);
+    EXPECT_EQ(
+        ncclTopoGetXmlFromFile(xmlFile_.path().c_str(), xml, 1), ncclSuccess);
+    ncclTopoSystem* system = nullptr;
+    EXPECT_EQ(ncclTopoGetSystemFromXml(xml, &system, kHostHash), ncclSuccess);
+    free(xml);
+    EXPECT_EQ(ncclTopoSetAllPaths(system), ncclSuccess);
+    return system;
+  }
+
+  // Plans of every GPU's communicator, from scratch and through the cache
+  void expectSameAsRecomputed(ncclTopoSystem* system, const Ranking& ranking) {
+    for (int g = 0; g < system->nodes[GPU].count; g++) {
+      FakeComm comm(system, ranking, g);
+      NCCL_TOPO_PLAN_CACHE = false;
+      const auto pxnRanks = comm.pxnRanks();
+      const auto p2pChannels = comm.p2pChannels();
+      NCCL_TOPO_PLAN_CACHE = true;
+      EXPECT_EQ(comm.pxnRanks(), pxnRanks) << "GPU " << g;
+      EXPECT_EQ(comm.p2pChannels(), p2pChannels) << "GPU " << g;
+    }
+  }
+
+ private:
+  folly::test::TemporaryFile xmlFile_;
+  bool savedPlanCache_{true};
+};
+
+} // namespace
+
+TEST_P(TopoPlanCacheTest, SameAsRecomputed) {
+  ncclTopoSystem* system = loadSystem();
+  TopoPlanCache& cache = TopoPlanCache::get();
+  expectSameAsRecomputed(system, {kNodes, 0, false});
+  EXPECT_EQ(cache.size(), 1);
+  const uint64_t hits = cache.hits();
+
+  // Splits of the same nodes rank the GPUs differently; the plans still
+  // apply, as long as nRanks is the same
+  expectSameAsRecomputed(system, {kNodes, 3, false});
+  expectSameAsRecomputed(system, {kNodes, kNodes - 1, true});
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.hits(), hits + 4 * system->nodes[GPU].count);
+
+  // Only the PXN plans apply to other sizes
+  expectSameAsRecomputed(system, {kNodes / 2, 1, true});
+  expectSameAsRecomputed(system, {1, 0, false});
+  EXPECT_EQ(cache.size(), 1);
+  ncclTopoFree(system);
+}
+
+TEST_P(TopoPlanCacheTest, SameSignatureAcrossLoads) {
+  ncclTopoSystem* first = loadSystem();
+  ncclTopoSystem* second = loadSystem();
+  FakeComm firstComm(first, {kNodes, 0, false}, 0);
+  FakeComm secondComm(second, {kNodes, 5, true}, 0);
+  NCCL_TOPO_PLAN_CACHE = true;
+  firstComm.pxnRanks();
+  const uint64_t hits = TopoPlanCache::get().hits();
+  secondComm.pxnRanks();
+  EXPECT_EQ(TopoPlanCache::get().hits(), hits + 1);
+  EXPECT_EQ(TopoPlanCache::get().size(), 1);
+  ncclTopoFree(first);
+  ncclTopoFree(second);
+}
+
+TEST_P(TopoPlanCacheTest, OtherTopologyOtherPlans) {
+  ncclTopoSystem* system = loadSystem();
+  expectSameAsRecomputed(system, {kNodes, 0, false});
+  // A slower NIC changes the paths to it, and the plans may change with them
+  system->nodes[NET].nodes[0].net.bw /= 2;
+  for (int l = 0; l < system->nodes[NET].nodes[0].nlinks; l++) {
+    system->nodes[NET].nodes[0].links[l].bw /= 2;
+  }
+  for (int t = 0; t < NCCL_TOPO_NODE_TYPES; t++) {
+    for (int n = 0; n < system->nodes[t].count; n++) {
+      for (int p = 0; p < NCCL_TOPO_NODE_TYPES; p++) {
+        free(system->nodes[t].nodes[n].paths[p]);
+        system->nodes[t].nodes[n].paths[p] = nullptr;
+      }
+    }
+  }
+  ASSERT_EQ(ncclTopoSetAllPaths(system), ncclSuccess);
+  expectSameAsRecomputed(system, {kNodes, 0, false});
+  EXPECT_EQ(TopoPlanCache::get().size(), 2);
+  ncclTopoFree(system);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TopoPlanCache,
+    TopoPlanCacheTest,
+    ::testing::Values(
+        TopoShape{1, 2, 4, true},
+        TopoShape{1, 2, 4, false},
+        TopoShape{1, 1, 2, false}),
+    [](const ::testing::TestParamInfo<TopoShape>& info) {
+      return std::to_string(info.param.nCpus * info.param.nGpus) + "gpus_" +
+          (info.param.nvSwitch ? "nvs" : "ring");
+    });
+
+TEST(TopoPlanCache, DropsLeastRecentlyUsed) {
+  TopoPlanCache cache;
+  auto signature = [](int64_t id) {
+    TopoSignature signature;
+    signature.append(id);
+    signature.append(1.5f);
+    return signature;
+  };
+  for (size_t i = 0; i < TopoPlanCache::kMaxPlans; i++) {
+    cache.insertP2pMinChannels(signature(i), 8, 32, i);
+  }
+  // Signature 0 is used again, 1 is now the least recently used
+  EXPECT_EQ(cache.findP2pMinChannels(signature(0), 8, 32), 0);
+  cache.insertP2pMinChannels(signature(TopoPlanCache::kMaxPlans), 8, 32, 0);
+  EXPECT_EQ(cache.size(), TopoPlanCache::kMaxPlans);
+  EXPECT_EQ(cache.findP2pMinChannels(signature(0), 8, 32), 0);
+  EXPECT_FALSE(cache.findP2pMinChannels(signature(1), 8, 32).has_value());
+  EXPECT_EQ(cache.findP2pMinChannels(signature(2), 8, 32), 2);
+  EXPECT_FALSE(cache.findP2pMinChannels(signature(2), 16, 32).has_value());
+}
+
+TEST(TopoPlanCache, MergesPxnProxies) {
+  TopoPlanCache cache;
+  TopoSignature signature;
+  signature.append(int64_t{42});
+  const int unknown = ncclx::topology::kPxnProxyUnknown;
+  std::vector<int> proxies(4, unknown);
+  EXPECT_FALSE(cache.findPxnProxies(signature, 1, &proxies));
+
+  cache.insertPxnProxies(signature, 1, {unknown, -1, 3, unknown});
+  cache.insertPxnProxies(signature, 1, {0, unknown, unknown, unknown});
+  ASSERT_TRUE(cache.findPxnProxies(signature, 1, &proxies));
+  EXPECT_EQ(proxies, std::vector<int>({0, -1, 3, unknown}));
+  // Nothing known for the other GPUs yet
+  EXPECT_FALSE(cache.findPxnProxies(signature, 0, &proxies));
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 2);
+}
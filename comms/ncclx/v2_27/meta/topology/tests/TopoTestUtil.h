@@ -0,0 +1,73 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+constexpr uint64_t kHostHash = 0x1;
+
+struct TopoShape {
+  int nHosts;
+  int nCpus; // Per host
+  int nGpus; // Per CPU
+  bool nvSwitch; // Or GPUs connected to each other in a ring
+};
+
+// System XML in the format written by NCCL_TOPO_DUMP_FILE: per CPU, one PCI
+// switch with GPUs and NICs under it.
+inline std::string topoXml(const TopoShape& shape) {
+  std::ostringstream xml;
+  const int gpusPerHost = shape.nCpus * shape.nGpus;
+  auto gpuBusId = [](int cpu, int g) {
+    char busId[16];
+    snprintf(busId, sizeof(busId), "0000:%02x:00.0", 0x10 * (cpu + 1) + g + 1);
+    return std::string(busId);
+  };
+  xml << "<system version=\"1\">\n";
+  for (int h = 0; h < shape.nHosts; h++) {
+    for (int c = 0; c < shape.nCpus; c++) {
+      xml << "<cpu host_hash=\"0x" << std::hex << kHostHash + h << std::dec
+          << "\" numaid=\"" << c
+          << "\" affinity=\"ffffffff\" arch=\"x86_64\" vendor=\"GenuineIntel\""
+          << " familyid=\"6\" modelid=\"143\">\n";
+      xml << "<pci busid=\"0000:" << std::hex << 0x10 * (c + 1) << std::dec
+          << ":00.0\" class=\"0x060400\" vendor=\"0x1000\" device=\"0xc030\""
+          << " subsystem_vendor=\"0x1000\" subsystem_device=\"0x100b\""
+          << " link_speed=\"32.0 GT/s PCIe\" link_width=\"16\">\n";
+      for (int g = 0; g < shape.nGpus; g++) {
+        const int dev = c * shape.nGpus + g;
+        xml << "<pci busid=\"" << gpuBusId(c, g) << "\" class=\"0x030200\""
+            << " link_speed=\"32.0 GT/s PCIe\" link_width=\"16\">\n"
+            << "<gpu dev=\"" << dev << "\" sm=\"90\" rank=\""
+            << h * gpusPerHost + dev << "\" gdr=\"1\">\n";
+        if (shape.nvSwitch) {
+          xml << "<nvlink target=\"0000:00:00.0\" count=\"18\""
+              << " tclass=\"0x068000\"/>\n";
+        } else {
+          const int next = (dev + 1) % gpusPerHost;
+          xml << "<nvlink target=\""
+              << gpuBusId(next / shape.nGpus, next % shape.nGpus)
+              << "\" count=\"6\" tclass=\"0x030200\"/>\n";
+          const int prev = (dev + gpusPerHost - 1) % gpusPerHost;
+          xml << "<nvlink target=\""
+              << gpuBusId(prev / shape.nGpus, prev % shape.nGpus)
+              << "\" count=\"6\" tclass=\"0x030200\"/>\n";
+        }
+        xml << "</gpu>\n</pci>\n";
+        xml << "<pci busid=\"0000:" << std::hex << 0x10 * (c + 1) + g + 8
+            << std::dec << ":00.0\" class=\"0x020700\""
+            << " link_speed=\"32.0 GT/s PCIe\" link_width=\"16\">\n"
+            << "<nic>\n<net name=\"mlx5_" << dev << "\" dev=\"" << dev
+            << "\" speed=\"400000\" port=\"1\" guid=\"0x" << std::hex
+            << (h << 8) + dev + 1 << std::dec
+            << "\" maxconn=\"131072\" gdr=\"1\"/>\n</nic>\n</pci>\n";
+      }
+      xml << "</pci>\n</cpu>\n";
+    }
+  }
+  xml << "</system>\n";
+  return xml.str();
+}
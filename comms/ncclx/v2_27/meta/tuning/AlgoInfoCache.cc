@@ -0,0 +1,53 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "meta/tuning/AlgoInfoCache.h"
+
+#include "debug.h"
+
+namespace ncclx::tuning {
+
+AlgoInfoCache::AlgoInfoCache(size_t capacity) : capacity_(capacity) {
+  entries_.reserve(capacity);
+}
+
+void AlgoInfoCache::checkConfig(const AlgoInfoConfig& config) {
+  if (config == config_) {
+    return;
+  }
+  if (!entries_.empty()) {
+    INFO(
+        NCCL_TUNING,
+        "AlgoInfoCache: comm config changed, dropping %zu cached decisions",
+        entries_.size());
+    invalidations_++;
+  }
+  entries_.clear();
+  config_ = config;
+}
+
+bool AlgoInfoCache::lookup(
+    const AlgoInfoKey& key,
+    AlgoInfoDecision* decision) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    misses_++;
+    return false;
+  }
+  *decision = it->second;
+  hits_++;
+  return true;
+}
+
+void AlgoInfoCache::insert(
+    const AlgoInfoKey& key,
+    const AlgoInfoDecision& decision) {
+  if (capacity_ == 0) {
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    entries_.clear();
+  }
+  entries_[key] = decision;
+}
+
+} // namespace ncclx::tuning
@@ -0,0 +1,115 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ncclx::tuning {
+
+// Inputs of getAlgoInfo() that determine its decision for a given
+// communicator: the (func, op, type) bin, the aggregated element count and the
+// scheduling hints computed by ncclPrepareTasks().
+struct AlgoInfoKey {
+  size_t count{0};
+  int32_t numPipeOps{0};
+  uint8_t func{0};
+  uint8_t devRedOp{0};
+  uint8_t datatype{0};
+  uint8_t collNetSupport{0};
+  uint8_t nvlsSupport{0};
+
+  bool operator==(const AlgoInfoKey& other) const {
+    return count == other.count && numPipeOps == other.numPipeOps &&
+        func == other.func && devRedOp == other.devRedOp &&
+        datatype == other.datatype && collNetSupport == other.collNetSupport &&
+        nvlsSupport == other.nvlsSupport;
+  }
+};
+
+struct AlgoInfoKeyHash {
+  size_t operator()(const AlgoInfoKey& key) const {
+    uint64_t h = key.count * 0x9e3779b97f4a7c15ULL;
+    h ^= (static_cast<uint64_t>(key.numPipeOps) << 40) ^
+        (static_cast<uint64_t>(key.func) << 32) ^
+        (static_cast<uint64_t>(key.devRedOp) << 24) ^
+        (static_cast<uint64_t>(key.datatype) << 16) ^
+        (static_cast<uint64_t>(key.collNetSupport) << 8) ^ key.nvlsSupport;
+    h ^= h >> 29;
+    return static_cast<size_t>(h * 0xbf58476d1ce4e5b9ULL);
+  }
+};
+
+// Outputs of getAlgoInfo() reused on a hit.
+struct AlgoInfoDecision {
+  int algorithm{-1};
+  int protocol{-1};
+  int nMaxChannels{0};
+  int nWarps{0};
+};
+
+// Communicator state the cached decisions were computed against. A change,
+// e.g. a tuner plugin being loaded or collnet being disabled after a failed
+// setup, drops all cached decisions.
+struct AlgoInfoConfig {
+  const void* tuner{nullptr};
+  const void* tunerContext{nullptr};
+  int collnetEnable{0};
+  int ctaPolicy{0};
+  int nChannels{0};
+  int nvlsChannels{0};
+
+  bool operator==(const AlgoInfoConfig& other) const {
+    return tuner == other.tuner && tunerContext == other.tunerContext &&
+        collnetEnable == other.collnetEnable && ctaPolicy == other.ctaPolicy &&
+        nChannels == other.nChannels && nvlsChannels == other.nvlsChannels;
+  }
+  bool operator!=(const AlgoInfoConfig& other) const {
+    return !(*this == other);
+  }
+};
+
+// Per-communicator memoization of the algorithm, protocol, channel and warp
+// decisions made by getAlgoInfo() on every ncclGroupEnd. Training loops
+// submit the same collective shapes over and over, so the cost table
+// evaluation (one ncclTopoGetAlgoTime() per algorithm and protocol) is skipped
+// for shapes seen before.
+//
+// Holds at most capacity entries; once full, all entries are dropped and the
+// cache refills with the shapes currently in use. Not thread-safe; accessed
+// only from the thread preparing the communicator's tasks.
+class AlgoInfoCache {
+ public:
+  explicit AlgoInfoCache(size_t capacity);
+
+  // Drop all decisions if config differs from the one they were computed
+  // against. Call before lookups for a new group.
+  void checkConfig(const AlgoInfoConfig& config);
+
+  bool lookup(const AlgoInfoKey& key, AlgoInfoDecision* decision);
+  void insert(const AlgoInfoKey& key, const AlgoInfoDecision& decision);
+
+  size_t size() const {
+    return entries_.size();
+  }
+  uint64_t hits() const {
+    return hits_;
+  }
+  uint64_t misses() const {
+    return misses_;
+  }
+  uint64_t invalidations() const {
+    return invalidations_;
+  }
+
+ private:
+  const size_t capacity_;
+  AlgoInfoConfig config_;
+  std::unordered_map<AlgoInfoKey, AlgoInfoDecision, AlgoInfoKeyHash> entries_;
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+  uint64_t invalidations_{0};
+};
+
+} // namespace ncclx::tuning
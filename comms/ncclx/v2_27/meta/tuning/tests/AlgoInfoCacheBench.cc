@@ -0,0 +1,149 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+#include <folly/init/Init.h>
+
+#include "comm.h" // @manual
+#include "enqueue.h" // @manual
+#include "graph.h" // @manual
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/tuning/AlgoInfoCache.h"
+
+using namespace ncclx::tuning;
+
+// Host-side planning time of a repeated training-step group against a
+// synthetic multi-node communicator: evaluating the cost model for every
+// algorithm and protocol pair as getAlgoInfo() does on each ncclGroupEnd,
+// versus looking the decision up in AlgoInfoCache.
+
+namespace {
+
+struct Shape {
+  ncclFunc_t func;
+  ncclDataType_t datatype;
+  size_t count;
+};
+
+// A step with gradient buckets of decreasing size plus FSDP style gathers.
+std::vector<Shape> trainingStep(int nShapes) {
+  std::vector<Shape> shapes;
+  size_t count = 64UL << 20;
+  for (int i = 0; i < nShapes; i++) {
+    ncclFunc_t func = i % 3 == 0 ? ncclFuncAllReduce
+        : i % 3 == 1             ? ncclFuncAllGather
+                                 : ncclFuncReduceScatter;
+    shapes.push_back({func, ncclBfloat16, count});
+    count = count > 4096 ? count / 2 : 64UL << 20;
+  }
+  return shapes;
+}
+
+// 64 nodes of 8 GPUs with made-up but plausible bandwidths and latencies.
+void fillSyntheticComm(ncclComm& comm) {
+  comm.nRanks = 512;
+  comm.nNodes = 64;
+  comm.nChannels = 32;
+  comm.minCompCap = 90;
+  for (int c = 0; c < NCCL_NUM_FUNCTIONS; c++) {
+    for (int a = 0; a < NCCL_NUM_ALGORITHMS; a++) {
+      for (int p = 0; p < NCCL_NUM_PROTOCOLS; p++) {
+        bool supported = a == NCCL_ALGO_RING || a == NCCL_ALGO_TREE ||
+            (a == NCCL_ALGO_PAT && c != ncclFuncAllReduce);
+        comm.bandwidths[c][a][p] = supported ? 40.0f * (p + 1) : 0.0f;
+        comm.latencies[c][a][p] = 4.0f + 6.0f * a + 2.0f * p;
+      }
+    }
+  }
+}
+
+size_t shapeBytes(const ncclComm& comm, const Shape& shape) {
+  return ncclTypeSize(shape.datatype) *
+      ncclFuncMaxSendRecvCount(shape.func, comm.nRanks, shape.count);
+}
+
+// Cost table evaluation and argmin of getAlgoInfo().
+AlgoInfoDecision evalCostModel(ncclComm* comm, const Shape& shape) {
+  float table[NCCL_NUM_ALGORITHMS][NCCL_NUM_PROTOCOLS];
+  size_t nBytes = shapeBytes(*comm, shape);
+  for (int a = 0; a < NCCL_NUM_ALGORITHMS; a++) {
+    for (int p = 0; p < NCCL_NUM_PROTOCOLS; p++) {
+      table[a][p] = NCCL_ALGO_PROTO_IGNORE;
+      ncclTopoGetAlgoTime(comm, shape.func, a, p, nBytes, 1, &table[a][p]);
+    }
+  }
+  AlgoInfoDecision decision;
+  float minTime = 3600000000.0;
+  for (int a = 0; a < NCCL_NUM_ALGORITHMS; a++) {
+    for (int p = 0; p < NCCL_NUM_PROTOCOLS; p++) {
+      if (table[a][p] >= 0.0 && table[a][p] < minTime) {
+        decision.algorithm = a;
+        decision.protocol = p;
+        minTime = table[a][p];
+      }
+    }
+  }
+  decision.nMaxChannels = comm->nChannels;
+  decision.nWarps = 16;
+  return decision;
+}
+
+AlgoInfoKey shapeKey(const Shape& shape) {
+  AlgoInfoKey key;
+  key.count = shape.count;
+  key.numPipeOps = 1;
+  key.func = shape.func;
+  key.datatype = shape.datatype;
+  return key;
+}
+
+} // namespace
+
+static void BM_CostModel(benchmark::State& state) {
+  ncclComm comm;
+  fillSyntheticComm(comm);
+  auto shapes = trainingStep(state.range(0));
+  for (auto _ : state) {
+    for (const auto& shape : shapes) {
+      benchmark::DoNotOptimize(evalCostModel(&comm, shape));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.size());
+}
+
+static void BM_AlgoInfoCache(benchmark::State& state) {
+  ncclComm comm;
+  fillSyntheticComm(comm);
+  auto shapes = trainingStep(state.range(0));
+  AlgoInfoCache cache(NCCL_ENQUEUE_ALGO_CACHE_SIZE);
+  AlgoInfoConfig config;
+  config.nChannels = comm.nChannels;
+  for (auto _ : state) {
+    cache.checkConfig(config);
+    for (const auto& shape : shapes) {
+      AlgoInfoKey key = shapeKey(shape);
+      AlgoInfoDecision decision;
+      if (!cache.lookup(key, &decision)) {
+        decision = evalCostModel(&comm, shape);
+        cache.insert(key, decision);
+      }
+      benchmark::DoNotOptimize(decision);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.size());
+  state.counters["hitRate"] =
+      static_cast<double>(cache.hits()) / (cache.hits() + cache.misses());
+}
+
+BENCHMARK(BM_CostModel)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_AlgoInfoCache)->RangeMultiplier(4)->Range(4, 256);
+
+int main(int argc, char** argv) {
+  ncclCvarInit();
+  ::benchmark::Initialize(&argc, argv);
+  folly::init(&argc, &argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
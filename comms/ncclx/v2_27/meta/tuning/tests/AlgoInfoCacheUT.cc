@@ -0,0 +1,128 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/tuning/AlgoInfoCache.h"
+
+using namespace ncclx::tuning;
+
+class AlgoInfoCacheTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ncclCvarInit();
+  }
+
+  static AlgoInfoKey makeKey(size_t count, uint8_t func = 0) {
+    AlgoInfoKey key;
+    key.count = count;
+    key.numPipeOps = 1;
+    key.func = func;
+    key.devRedOp = 0;
+    key.datatype = 7;
+    key.collNetSupport = 0;
+    key.nvlsSupport = 1;
+    return key;
+  }
+
+  static AlgoInfoDecision makeDecision(int algorithm, int protocol) {
+    AlgoInfoDecision decision;
+    decision.algorithm = algorithm;
+    decision.protocol = protocol;
+    decision.nMaxChannels = 16;
+    decision.nWarps = 20;
+    return decision;
+  }
+};
+
+TEST_F(AlgoInfoCacheTest, HitAfterInsert) {
+  AlgoInfoCache cache(16);
+  cache.checkConfig(AlgoInfoConfig{});
+
+  AlgoInfoDecision decision;
+  EXPECT_FALSE(cache.lookup(makeKey(1024), &decision));
+  cache.insert(makeKey(1024), makeDecision(1, 2));
+
+  ASSERT_TRUE(cache.lookup(makeKey(1024), &decision));
+  EXPECT_EQ(decision.algorithm, 1);
+  EXPECT_EQ(decision.protocol, 2);
+  EXPECT_EQ(decision.nMaxChannels, 16);
+  EXPECT_EQ(decision.nWarps, 20);
+  EXPECT_EQ(cache.hits(), 1);
+  EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST_F(AlgoInfoCacheTest, EveryKeyFieldMatters) {
+  AlgoInfoCache cache(64);
+  const AlgoInfoKey base = makeKey(1024);
+  cache.insert(base, makeDecision(1, 2));
+
+  std::vector<AlgoInfoKey> variants(7, base);
+  variants[0].count++;
+  variants[1].numPipeOps++;
+  variants[2].func++;
+  variants[3].devRedOp++;
+  variants[4].datatype++;
+  variants[5].collNetSupport = 1;
+  variants[6].nvlsSupport = 0;
+  AlgoInfoDecision decision;
+  for (const auto& key : variants) {
+    EXPECT_FALSE(cache.lookup(key, &decision));
+  }
+  EXPECT_TRUE(cache.lookup(base, &decision));
+}
+
+TEST_F(AlgoInfoCacheTest, ConfigChangeInvalidates) {
+  AlgoInfoCache cache(16);
+  AlgoInfoConfig config;
+  config.nChannels = 32;
+  cache.checkConfig(config);
+  cache.insert(makeKey(1024), makeDecision(1, 2));
+
+  // Same config keeps the decisions
+  cache.checkConfig(config);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.invalidations(), 0);
+
+  // Tuner loaded
+  int tuner;
+  config.tuner = &tuner;
+  cache.checkConfig(config);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.invalidations(), 1);
+
+  // Collnet disabled after failed setup
+  cache.insert(makeKey(1024), makeDecision(1, 2));
+  config.collnetEnable = 0;
+  config.tuner = nullptr;
+  cache.checkConfig(config);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.invalidations(), 2);
+
+  AlgoInfoDecision decision;
+  EXPECT_FALSE(cache.lookup(makeKey(1024), &decision));
+}
+
+TEST_F(AlgoInfoCacheTest, CapacityBound) {
+  AlgoInfoCache cache(4);
+  for (size_t i = 0; i < 4; i++) {
+    cache.insert(makeKey(i), makeDecision(0, 0));
+  }
+  EXPECT_EQ(cache.size(), 4);
+
+  // Inserting past the bound restarts from the shapes currently in use
+  cache.insert(makeKey(100), makeDecision(0, 0));
+  EXPECT_EQ(cache.size(), 1);
+  AlgoInfoDecision decision;
+  EXPECT_TRUE(cache.lookup(makeKey(100), &decision));
+  EXPECT_FALSE(cache.lookup(makeKey(0), &decision));
+}
+
+TEST_F(AlgoInfoCacheTest, ZeroCapacityNeverStores) {
+  AlgoInfoCache cache(0);
+  cache.insert(makeKey(1024), makeDecision(1, 2));
+  AlgoInfoDecision decision;
+  EXPECT_FALSE(cache.lookup(makeKey(1024), &decision));
+  EXPECT_EQ(cache.size(), 0);
+}
@@ -22,6 +22,7 @@
 #include "meta/wrapper/MetaFactory.h"
 #include "meta/transport/transportConnect.h"
 #include "meta/transport/transportProxy.h"
+#include "meta/tuning/AlgoInfoCache.h"
 #include "comms/utils/cvars/nccl_cvars.h"
 #include "meta/colltrace/CollTraceFunc.h"
 #include "meta/colltrace/ProxyTraceFunc.h"
@@ -270,6 +271,7 @@ struct ncclKernelPlanBudget {
   ssize_t outArgsBytes; // Space available outside of args struct (fifo or persistent buf)
 };
 
+static ncclx::tuning::AlgoInfoCache* getAlgoInfoCache(struct ncclComm* comm, ncclSimInfo_t* simInfo);
 static bool testBudget(
     struct ncclKernelPlanBudget* budget, int nWorkBatches, ssize_t workBytes
   ) {
@@ -403,6 +405,8 @@ ncclResult_t ncclPrepareTasks(struct ncclComm* comm, bool* algoNeedConnect, bool
   // Walk (fn,op,ty) bins, compute algo and proto etc. Then bin them by their
   // scheduling constraints (collnet x nvls).
   struct ncclIntruQueue<struct ncclTaskColl, &ncclTaskColl::next> collBins[2][2] = {};
+  // NCCLX: reuse algo/proto/channel decisions of shapes seen in earlier groups
+  ncclx::tuning::AlgoInfoCache* algoCache = getAlgoInfoCache(comm, simInfo);
   for (int cursor=0; cursor < fnOpTyCount; cursor++) {
     struct ncclTaskColl* aggBeg = tasksByFnOpTy[fnOpTyIndices[cursor]];
     int collNetSupport = 0;
@@ -422,7 +426,32 @@ ncclResult_t ncclPrepareTasks(struct ncclComm* comm, bool* algoNeedConnect, bool
         aggEnd = aggEnd->next;
       }
 
-      NCCLCHECK(getAlgoInfo(comm, &agg, collNetSupport, nvlsSupport, nTasksPerChannel, simInfo));
+      ncclx::tuning::AlgoInfoKey algoKey;
+      ncclx::tuning::AlgoInfoDecision algoDecision;
+      if (algoCache) {
+        algoKey.count = agg.count;
+        algoKey.numPipeOps = nTasksPerChannel;
+        algoKey.func = agg.func;
+        algoKey.devRedOp = agg.opDev.op;
+        algoKey.datatype = agg.datatype;
+        algoKey.collNetSupport = collNetSupport;
+        algoKey.nvlsSupport = nvlsSupport;
+      }
+      if (algoCache && algoCache->lookup(algoKey, &algoDecision)) {
+        agg.algorithm = algoDecision.algorithm;
+        agg.protocol = algoDecision.protocol;
+        agg.nMaxChannels = algoDecision.nMaxChannels;
+        agg.nWarps = algoDecision.nWarps;
+      } else {
+        NCCLCHECK(getAlgoInfo(comm, &agg, collNetSupport, nvlsSupport, nTasksPerChannel, simInfo));
+        if (algoCache) {
+          algoDecision.algorithm = agg.algorithm;
+          algoDecision.protocol = agg.protocol;
+          algoDecision.nMaxChannels = agg.nMaxChannels;
+          algoDecision.nWarps = agg.nWarps;
+          algoCache->insert(algoKey, algoDecision);
+        }
+      }
       agg.devFuncId = ncclDevFuncId(agg.func, agg.opDev.op, agg.datatype, agg.algorithm, agg.protocol);
 
       int isCollnet=0, isNvls=0;
@@ -1983,6 +2012,31 @@ static ncclResult_t getAlgoInfo(
   return ncclSuccess;
 }
 
+// NCCLX: returns the communicator's memoized getAlgoInfo() decisions if they
+// can be used for the current group, nullptr otherwise. getAlgoInfo() only
+// depends on the task shape and on communicator state covered by
+// AlgoInfoConfig, except when a tuner plugin is loaded (plugins may keep state
+// across calls), when simulating (the estimated time is not memoized) and
+// under the CTA efficiency policy (depends on buffer registration).
+static ncclx::tuning::AlgoInfoCache* getAlgoInfoCache(struct ncclComm* comm, ncclSimInfo_t* simInfo) {
+  if (NCCL_ENQUEUE_ALGO_CACHE_SIZE <= 0 || simInfo != NULL) return nullptr;
+  if (comm->algoInfoCache == nullptr) {
+    comm->algoInfoCache = std::make_shared<ncclx::tuning::AlgoInfoCache>(NCCL_ENQUEUE_ALGO_CACHE_SIZE);
+  }
+  ncclx::tuning::AlgoInfoConfig config;
+  config.tuner = comm->tuner;
+  config.tunerContext = comm->tunerContext;
+  config.collnetEnable = comm->config.collnetEnable;
+  config.ctaPolicy = comm->config.CTAPolicy;
+  config.nChannels = comm->nChannels;
+  config.nvlsChannels = comm->nvlsChannels;
+  comm->algoInfoCache->checkConfig(config);
+
+  if (comm->tuner != NULL) return nullptr;
+  if (comm->config.CTAPolicy == NCCL_CTA_POLICY_EFFICIENCY && NCCL_ALGO.empty() && NCCL_PROTO.empty() && !comm->MNNVL) return nullptr;
+  return comm->algoInfoCache.get();
+}
+
 static ncclResult_t calcCollChunking(
     struct ncclComm* comm, struct ncclTaskColl* info, int nChannels, size_t nBytes,
     /*outputs*/uint32_t* outChunkSize, uint32_t* outDirectFlags, struct ncclProxyOp* proxyOp
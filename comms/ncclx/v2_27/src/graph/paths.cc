@@ -14,6 +14,8 @@
 #include "device.h"
 
 #include "comms/utils/cvars/nccl_cvars.h"
+#include "meta/topology/TopoPathCache.h"
+#include "meta/topology/TopoPlanCache.h"
 
 // Pre-compute GPU->NIC, GPU->GPU and NIC->GPU paths
 
@@ -33,7 +35,9 @@ static ncclResult_t getPath(struct ncclTopoSystem* system, struct ncclTopoNode*
   return ncclInternalError;
 }
 
-static ncclResult_t ncclTopoSetPaths(struct ncclTopoNode* baseNode, struct ncclTopoSystem* system) {
+// NCCLX: record, when given, gets the nodes which relayed a path
+static ncclResult_t ncclTopoSetPaths(struct ncclTopoNode* baseNode, struct ncclTopoSystem* system,
+    ncclx::topology::TopoBasePaths* record = NULL, const ncclx::topology::TopoGraph* graph = NULL) {
   if (baseNode->paths[baseNode->type] == NULL) {
     NCCLCHECK(ncclCalloc(baseNode->paths+baseNode->type, system->nodes[baseNode->type].count));
     for (int i=0; i<system->nodes[baseNode->type].count; i++) baseNode->paths[baseNode->type][i].type = PATH_DIS;
@@ -71,6 +75,7 @@ static ncclResult_t ncclTopoSetPaths(struct ncclTopoNode* baseNode, struct ncclT
             (NCCL_NVB_DISABLE || link->type != LINK_NVL || remNode->type != GPU || path->count > 1)) continue;
 
         if ((remPath->bw == 0 || remPath->count > path->count) && remPath->bw < bw) {
+          if (record) record->relay[graph->nodeIndex(node->type, node-system->nodes[node->type].nodes)] = 1;
           // Find reverse link
           for (int l=0; l<remNode->nlinks; l++) {
             if (remNode->links[l].remNode == node && remNode->links[l].type == link->type) {
@@ -576,11 +581,135 @@ int ncclPxnDisable(struct ncclComm* comm) {
   return pxnDisable;
 }
 
+// NCCLX: plans shared by communicators on the same topology. What
+// ncclTopoGetPxnRanks() and ncclTopoComputeP2pChannels() find going through
+// every peer only depends on the topology, on which local GPU each peer maps
+// to and on the number of ranks, so it is kept in the process-wide
+// TopoPlanCache under the signature of the topology, without ranks.
+
+static void ncclTopoAppendPaths(struct ncclTopoSystem* system, struct ncclTopoNode* node,
+    ncclx::topology::TopoSignature* signature) {
+  for (int t=0; t<NCCL_TOPO_NODE_TYPES; t++) {
+    if (node->paths[t] == NULL) {
+      signature->append((int64_t)-1);
+      continue;
+    }
+    for (int i=0; i<system->nodes[t].count; i++) {
+      struct ncclTopoLinkList* path = node->paths[t]+i;
+      signature->append((int64_t)path->type);
+      signature->append(path->bw);
+      signature->append((int64_t)path->count);
+      // Hop by hop, as the PXN intermediate GPU is taken from the path
+      for (int h=0; h<path->count; h++) {
+        struct ncclTopoNode* remNode = path->list[h]->remNode;
+        signature->append(((int64_t)remNode->type << 32) | (remNode-system->nodes[remNode->type].nodes));
+      }
+    }
+  }
+}
+
+static void ncclTopoGetPlanSignature(struct ncclComm* comm, ncclx::topology::TopoSignature* signature) {
+  struct ncclTopoSystem* system = comm->topo;
+  signature->append((int64_t)(ncclPxnDisable(comm) == 1 ? 0 : NCCL_P2P_PXN_LEVEL));
+  signature->append((int64_t)NCCL_CROSS_NIC);
+  signature->append((int64_t)NCCL_PXN_C2C);
+  signature->append((int64_t)NCCL_NCHANNELS_PER_NET_PEER);
+  signature->append((int64_t)NCCL_NET_GDR_READ);
+  signature->append((int64_t)NCCL_NET_GDR_C2C);
+  signature->append((int64_t)system->systemId);
+  for (int t=0; t<NCCL_TOPO_NODE_TYPES; t++) {
+    signature->append((int64_t)system->nodes[t].count);
+    for (int n=0; n<system->nodes[t].count; n++) {
+      struct ncclTopoNode* node = system->nodes[t].nodes+n;
+      signature->append(node->id);
+      if (t == GPU) {
+        signature->append((int64_t)node->gpu.dev);
+        signature->append((int64_t)node->gpu.cudaCompCap);
+        signature->append((int64_t)node->gpu.gdrSupport);
+      } else if (t == NET) {
+        signature->append((int64_t)node->net.dev);
+        signature->append((int64_t)node->net.asic);
+        signature->append((int64_t)node->net.port);
+        signature->append(node->net.bw);
+        signature->append((int64_t)node->net.gdrSupport);
+      }
+      signature->append((int64_t)node->nlinks);
+      for (int l=0; l<node->nlinks; l++) {
+        struct ncclTopoNode* remNode = node->links[l].remNode;
+        signature->append(((int64_t)remNode->type << 32) | (remNode-system->nodes[remNode->type].nodes));
+        signature->append((int64_t)node->links[l].type);
+        signature->append(node->links[l].bw);
+      }
+    }
+  }
+  for (int t : { GPU, NET }) {
+    for (int n=0; n<system->nodes[t].count; n++) ncclTopoAppendPaths(system, system->nodes[t].nodes+n, signature);
+  }
+}
+
+// Same as ncclTopoGetPxnRanks(), except that peers are only looked up once per
+// local GPU they map to, and only when no communicator did it already.
+static ncclResult_t ncclTopoGetPlannedPxnRanks(struct ncclComm* comm, int** intermediateRanks, int* nranks) {
+  struct ncclTopoSystem* system = comm->topo;
+  int ngpus = system->nodes[GPU].count;
+  int g;
+  NCCLCHECK(ncclTopoRankToIndex(system, comm->rank, &g, /*showWarn=*/true));
+
+  ncclx::topology::TopoSignature signature;
+  ncclTopoGetPlanSignature(comm, &signature);
+  ncclx::topology::TopoPlanCache& cache = ncclx::topology::TopoPlanCache::get();
+  std::vector<int> proxies(ngpus, ncclx::topology::kPxnProxyUnknown);
+  cache.findPxnProxies(signature, g, &proxies);
+  bool updated = false;
+
+  // Local GPU of each NVML device, the first one as in ncclTopoDevToRank()
+  std::vector<int> devGpus;
+  for (int p=0; p<ngpus; p++) {
+    struct ncclTopoNode* gpu = system->nodes[GPU].nodes+p;
+    if (NCCL_TOPO_ID_SYSTEM_ID(gpu->id) != system->systemId) continue;
+    if (gpu->gpu.dev >= (int)devGpus.size()) devGpus.resize(gpu->gpu.dev+1, -1);
+    if (devGpus[gpu->gpu.dev] == -1) devGpus[gpu->gpu.dev] = p;
+  }
+
+  int nr = 0;
+  int* ranks = NULL;
+  std::vector<bool> found(ngpus, false);
+  for (int rank=0; rank<comm->nRanks; rank++) {
+    int nvmlDev = comm->peerInfo[rank].nvmlDev;
+    // ncclTopoGetNetDev() keeps our own NIC and rank for peers on other GPUs
+    if (nvmlDev < 0 || nvmlDev >= (int)devGpus.size() || devGpus[nvmlDev] == -1) continue;
+    int p = devGpus[nvmlDev];
+    if (proxies[p] == ncclx::topology::kPxnProxyUnknown) {
+      int64_t netId;
+      int proxyRank;
+      proxies[p] = -1;
+      NCCLCHECK(ncclTopoGetNetDev(comm, comm->rank, NULL, 0, rank, &netId, NULL, &proxyRank));
+      if (proxyRank != comm->rank) {
+        enum ncclTopoGdrMode useGdr;
+        NCCLCHECK(ncclTopoCheckGdr(system, comm->rank, netId, 1, &useGdr));
+        if (useGdr != ncclTopoGdrModeDisable) {
+          NCCLCHECK(ncclTopoRankToIndex(system, proxyRank, proxies.data()+p, /*showWarn=*/true));
+        }
+      }
+      updated = true;
+    }
+    if (proxies[p] == -1 || found[proxies[p]]) continue;
+    found[proxies[p]] = true;
+    NCCLCHECK(ncclRealloc(&ranks, nr, nr+1));
+    ranks[nr++] = system->nodes[GPU].nodes[proxies[p]].gpu.rank;
+  }
+  if (updated) cache.insertPxnProxies(signature, g, proxies);
+  *nranks = nr;
+  *intermediateRanks = ranks;
+  return ncclSuccess;
+}
+
 ncclResult_t ncclTopoGetPxnRanks(struct ncclComm* comm, int** intermediateRanks, int* nranks) {
   struct ncclTopoSystem* system = comm->topo;
   *nranks = 0;
   *intermediateRanks = NULL;
   if (system->nodes[NET].count == 0) return ncclSuccess;
+  if (NCCL_TOPO_PLAN_CACHE) return ncclTopoGetPlannedPxnRanks(comm, intermediateRanks, nranks);
 
   int nr = 0;
   int* ranks = NULL;
@@ -606,31 +735,140 @@ ncclResult_t ncclTopoGetPxnRanks(struct ncclComm* comm, int** intermediateRanks,
   return ncclSuccess;
 }
 
-ncclResult_t ncclTopoComputePaths(struct ncclTopoSystem* system, struct ncclComm* comm) {
-  // Precompute paths between GPUs/NICs.
+// NCCLX: incremental path computation. The search from each base node is
+// kept in the system's TopoPathCache, and rebuilt from it when the nodes
+// removed since the previous ncclTopoComputePaths() didn't take part in it.
 
-  // Remove everything in case we're re-computing
-  ncclTopoRemovePaths(system);
+static ncclx::topology::TopoGraph ncclTopoGetGraph(struct ncclTopoSystem* system) {
+  ncclx::topology::TopoGraph graph;
+  graph.ids.resize(NCCL_TOPO_NODE_TYPES);
+  int offsets[NCCL_TOPO_NODE_TYPES];
+  int nNodes = 0;
+  for (int t=0; t<NCCL_TOPO_NODE_TYPES; t++) {
+    offsets[t] = nNodes;
+    nNodes += system->nodes[t].count;
+    for (int n=0; n<system->nodes[t].count; n++) graph.ids[t].push_back(system->nodes[t].nodes[n].id);
+  }
+  graph.links.resize(nNodes);
+  for (int t=0; t<NCCL_TOPO_NODE_TYPES; t++) {
+    for (int n=0; n<system->nodes[t].count; n++) {
+      struct ncclTopoNode* node = system->nodes[t].nodes+n;
+      for (int l=0; l<node->nlinks; l++) {
+        struct ncclTopoNode* remNode = node->links[l].remNode;
+        int remIndex = offsets[remNode->type] + (remNode-system->nodes[remNode->type].nodes);
+        graph.links[offsets[t]+n].push_back({ remIndex, node->links[l].type, node->links[l].bw });
+      }
+    }
+  }
+  return graph;
+}
+
+static ncclResult_t ncclTopoAllocPaths(struct ncclTopoSystem* system, struct ncclTopoNode* node, int t) {
+  if (node->paths[t] == NULL) {
+    NCCLCHECK(ncclCalloc(node->paths+t, system->nodes[t].count));
+    for (int i=0; i<system->nodes[t].count; i++) node->paths[t][i].type = PATH_DIS;
+  }
+  return ncclSuccess;
+}
+
+static void ncclTopoRecordPaths(struct ncclTopoSystem* system, struct ncclTopoNode* baseNode,
+    const std::vector<struct ncclTopoNode*>& nodes, ncclx::topology::TopoBasePaths* record) {
+  int t = baseNode->type;
+  int b = baseNode-system->nodes[t].nodes;
+  for (int i=0; i<(int)nodes.size(); i++) {
+    struct ncclTopoNode* node = nodes[i];
+    if (node->paths[t] == NULL) continue;
+    struct ncclTopoLinkList* path = node->paths[t]+b;
+    record->link[i] = path->count ? path->list[0]-node->links : -1;
+    record->count[i] = path->count;
+    record->bw[i] = path->bw;
+    record->type[i] = path->type;
+    // Every node which got a path relayed paths in turn
+    if (path->bw > 0) record->order.push_back(i);
+  }
+  std::stable_sort(record->order.begin(), record->order.end(),
+      [&](int32_t x, int32_t y) { return record->count[x] < record->count[y]; });
+}
+
+// Same paths as ncclTopoSetPaths(), including which nodes get paths to the
+// base node's type allocated: the neighbors of the nodes it went through.
+static ncclResult_t ncclTopoRestorePaths(struct ncclTopoSystem* system, struct ncclTopoNode* baseNode,
+    const std::vector<struct ncclTopoNode*>& nodes, const ncclx::topology::TopoBasePaths& cached) {
+  int t = baseNode->type;
+  int b = baseNode-system->nodes[t].nodes;
+  NCCLCHECK(ncclTopoAllocPaths(system, baseNode, t));
+  for (int i : cached.order) {
+    struct ncclTopoNode* node = nodes[i];
+    for (int l=0; l<node->nlinks; l++) NCCLCHECK(ncclTopoAllocPaths(system, node->links[l].remNode, t));
+    struct ncclTopoLinkList* path = node->paths[t]+b;
+    path->count = cached.count[i];
+    path->bw = cached.bw[i];
+    path->type = cached.type[i];
+    if (path->count == 0) continue;
+    path->list[0] = node->links+cached.link[i];
+    // The rest is the path of the next node, which is one hop shorter
+    struct ncclTopoLinkList* nextPath = path->list[0]->remNode->paths[t]+b;
+    memcpy(path->list+1, nextPath->list, (path->count-1)*sizeof(struct ncclTopoLink*));
+  }
+  return ncclSuccess;
+}
+
+static ncclResult_t ncclTopoSetBasePaths(struct ncclTopoSystem* system, struct ncclTopoNode* baseNode,
+    const std::vector<struct ncclTopoNode*>& nodes) {
+  ncclx::topology::TopoPathCache* cache = system->pathCache;
+  if (cache == NULL) return ncclTopoSetPaths(baseNode, system);
+  const ncclx::topology::TopoBasePaths* cached = cache->find(baseNode->type, baseNode->id);
+  if (cached) return ncclTopoRestorePaths(system, baseNode, nodes, *cached);
+  ncclx::topology::TopoBasePaths record;
+  record.resize(nodes.size());
+  NCCLCHECK(ncclTopoSetPaths(baseNode, system, &record, &cache->graph()));
+  ncclTopoRecordPaths(system, baseNode, nodes, &record);
+  cache->insert(baseNode->type, baseNode->id, std::move(record));
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoSetAllPaths(struct ncclTopoSystem* system) {
+  std::vector<struct ncclTopoNode*> nodes;
+  if (NCCL_TOPO_PATH_CACHE) {
+    if (system->pathCache == NULL) system->pathCache = new ncclx::topology::TopoPathCache();
+    system->pathCache->update(ncclTopoGetGraph(system), NCCL_NVB_DISABLE);
+    for (int t=0; t<NCCL_TOPO_NODE_TYPES; t++) {
+      for (int n=0; n<system->nodes[t].count; n++) nodes.push_back(system->nodes[t].nodes+n);
+    }
+  } else if (system->pathCache) {
+    delete system->pathCache;
+    system->pathCache = NULL;
+  }
 
   // Set direct paths to CPUs. We need them in many cases.
   for (int c=0; c<system->nodes[CPU].count; c++) {
-    NCCLCHECK(ncclTopoSetPaths(system->nodes[CPU].nodes+c, system));
+    NCCLCHECK(ncclTopoSetBasePaths(system, system->nodes[CPU].nodes+c, nodes));
   }
 
   // Set direct paths to GPUs.
   for (int g=0; g<system->nodes[GPU].count; g++) {
-    NCCLCHECK(ncclTopoSetPaths(system->nodes[GPU].nodes+g, system));
+    NCCLCHECK(ncclTopoSetBasePaths(system, system->nodes[GPU].nodes+g, nodes));
   }
 
   // Set direct paths to NICs.
   for (int n=0; n<system->nodes[NET].count; n++) {
-    NCCLCHECK(ncclTopoSetPaths(system->nodes[NET].nodes+n, system));
+    NCCLCHECK(ncclTopoSetBasePaths(system, system->nodes[NET].nodes+n, nodes));
   }
 
   // Set direct paths to NVSwitches.
   for (int n=0; n<system->nodes[NVS].count; n++) {
-    NCCLCHECK(ncclTopoSetPaths(system->nodes[NVS].nodes+n, system));
+    NCCLCHECK(ncclTopoSetBasePaths(system, system->nodes[NVS].nodes+n, nodes));
   }
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoComputePaths(struct ncclTopoSystem* system, struct ncclComm* comm) {
+  // Precompute paths between GPUs/NICs.
+
+  // Remove everything in case we're re-computing
+  ncclTopoRemovePaths(system);
+
+  NCCLCHECK(ncclTopoSetAllPaths(system));
 
   // Update path for GPUs when we don't want to / can't use GPU Direct P2P
   for (int g=0; g<system->nodes[GPU].count; g++) {
@@ -781,6 +1019,7 @@ fail:
 
 void ncclTopoFree(struct ncclTopoSystem* system) {
   ncclTopoRemovePaths(system);
+  delete system->pathCache;
   free(system);
 }
 
@@ -823,6 +1062,36 @@ static ncclResult_t ncclTopoGetNchannels(struct ncclComm* comm, int g /*local gp
   return ncclSuccess;
 }
 
+static ncclResult_t ncclTopoComputeP2pMinChannels(struct ncclComm* comm, int* minChannels) {
+  *minChannels = comm->p2pnChannels;
+  // We need to loop through all local GPUs to have a global picture
+  for (int g=0; g<comm->topo->nodes[GPU].count; g++) {
+    for (int r=0; r<comm->nRanks; r++) {
+      int nChannels;
+      NCCLCHECK(ncclTopoGetNchannels(comm, g, r, &nChannels));
+      if (nChannels >= 0) *minChannels = std::min(*minChannels, nChannels);
+    }
+  }
+  return ncclSuccess;
+}
+
+// NCCLX: peers are either one of the local GPUs, whichever their rank, or
+// remote, so the result only depends on the topology, nRanks and p2pnChannels.
+static ncclResult_t ncclTopoGetP2pMinChannels(struct ncclComm* comm, int* minChannels) {
+  if (!NCCL_TOPO_PLAN_CACHE) return ncclTopoComputeP2pMinChannels(comm, minChannels);
+  ncclx::topology::TopoSignature signature;
+  ncclTopoGetPlanSignature(comm, &signature);
+  ncclx::topology::TopoPlanCache& cache = ncclx::topology::TopoPlanCache::get();
+  std::optional<int> planned = cache.findP2pMinChannels(signature, comm->nRanks, comm->p2pnChannels);
+  if (planned) {
+    *minChannels = *planned;
+    return ncclSuccess;
+  }
+  NCCLCHECK(ncclTopoComputeP2pMinChannels(comm, minChannels));
+  cache.insertP2pMinChannels(signature, comm->nRanks, comm->p2pnChannels, *minChannels);
+  return ncclSuccess;
+}
+
 extern int64_t NCCL_WORK_ARGS_BYTES;
 
 ncclResult_t ncclTopoComputeP2pChannels(struct ncclComm* comm) {
@@ -835,15 +1104,8 @@ ncclResult_t ncclTopoComputeP2pChannels(struct ncclComm* comm) {
     comm->p2pnChannels = std::max(comm->p2pnChannels, (int)NCCL_MIN_P2P_NCHANNELS);
   }
 
-  int minChannels = comm->p2pnChannels;
-  // We need to loop through all local GPUs to have a global picture
-  for (int g=0; g<comm->topo->nodes[GPU].count; g++) {
-    for (int r=0; r<comm->nRanks; r++) {
-      int nChannels;
-      NCCLCHECK(ncclTopoGetNchannels(comm, g, r, &nChannels));
-      if (nChannels >= 0) minChannels = std::min(minChannels, nChannels);
-    }
-  }
+  int minChannels;
+  NCCLCHECK(ncclTopoGetP2pMinChannels(comm, &minChannels));
 
   // Make nChannelsPerPeer and nChannels powers of 2. This is relied on when
   // mapping p2p peers to channels.
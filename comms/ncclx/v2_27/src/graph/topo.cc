@@ -1317,6 +1317,67 @@ ncclResult_t ncclTopoGetSharedState(ncclTopoNetState** state, const char* name,
   return ncclInternalError;
 }
 
+// NCCLX: exchange the local XMLs in their compact form, sized by what each
+// rank actually has rather than NCCL_TOPO_XML_MAX_NODES, and fuse them through
+// an index of the fused XML. Gives the same XML as the full-size exchange in
+// ncclTopoGetSystem.
+static ncclResult_t ncclTopoFuseXmlCompact(struct ncclComm* comm, int* localRanks, int localRank, int nLocalRanks, struct ncclXml** xmlPtr) {
+  ncclResult_t ret = ncclSuccess;
+  struct ncclXml* xml = *xmlPtr;
+  struct ncclXml* peerXml = NULL;
+  struct ncclTopoXmlIndex* index = NULL;
+  int64_t* sizes = NULL;
+  char* packed = NULL;
+  size_t size, maxSize = 0;
+  int nNodes, maxNodes = 0, totalNodes = 0;
+
+  // Sizes first, so that the buffers can be exchanged in one allgather
+  NCCLCHECKGOTO(ncclTopoPackXml(xml, NULL, &size), ret, fail);
+  NCCLCHECKGOTO(ncclCalloc(&sizes, nLocalRanks), ret, fail);
+  sizes[localRank] = size;
+  NCCLCHECKGOTO(bootstrapIntraNodeAllGather(comm->bootstrap, localRanks, localRank, nLocalRanks, sizes, sizeof(int64_t)), ret, fail);
+  for (int i = 0; i < nLocalRanks; i++) maxSize = std::max(maxSize, (size_t)sizes[i]);
+  if (maxSize > INT_MAX) {
+    WARN("Topology XML of %zu bytes is too large to exchange", maxSize);
+    ret = ncclInternalError;
+    goto fail;
+  }
+  NCCLCHECKGOTO(ncclCalloc(&packed, nLocalRanks * maxSize), ret, fail);
+  NCCLCHECKGOTO(ncclTopoPackXml(xml, packed+maxSize*localRank, &size), ret, fail);
+  NCCLCHECKGOTO(bootstrapIntraNodeAllGather(comm->bootstrap, localRanks, localRank, nLocalRanks, packed, (int)maxSize), ret, fail);
+
+  for (int i = 0; i < nLocalRanks; i++) {
+    NCCLCHECKGOTO(ncclTopoPackedXmlNodes(packed+maxSize*i, sizes[i], &nNodes), ret, fail);
+    maxNodes = std::max(maxNodes, nNodes);
+    totalNodes += nNodes;
+  }
+  if (comm->MNNVL) {
+    // The fused XML can't have more nodes than all the peer XMLs together,
+    // rather than NCCL_TOPO_XML_MAX_NODES for every one of them
+    free(xml);
+    *xmlPtr = NULL;
+    NCCLCHECKGOTO(xmlAlloc(xmlPtr, std::max(totalNodes, NCCL_TOPO_XML_MAX_NODES)), ret, fail);
+    xml = *xmlPtr;
+  } else {
+    xml->maxIndex = 0;
+  }
+  NCCLCHECKGOTO(xmlAlloc(&peerXml, std::max(maxNodes, 1)), ret, fail);
+  NCCLCHECKGOTO(ncclTopoXmlIndexCreate(&index), ret, fail);
+  for (int i = 0; i < nLocalRanks; i++) {
+    NCCLCHECKGOTO(ncclTopoUnpackXml(packed+maxSize*i, sizes[i], peerXml), ret, fail);
+    NCCLCHECKGOTO(ncclTopoFuseXmlIndexed(xml, peerXml, index), ret, fail);
+  }
+
+exit:
+  if (index) ncclTopoXmlIndexFree(index);
+  free(peerXml);
+  free(packed);
+  free(sizes);
+  return ret;
+fail:
+  goto exit;
+}
+
 ncclResult_t ncclTopoGetSystem(struct ncclComm* comm, struct ncclTopoSystem** system, const char* dumpXmlFile) {
   ncclResult_t ret = ncclSuccess;
   struct ncclXml* xml;
@@ -1408,26 +1469,30 @@ ncclResult_t ncclTopoGetSystem(struct ncclComm* comm, struct ncclTopoSystem** sy
       }
     }
   }
-  NCCLCHECKGOTO(ncclCalloc(&mem, nLocalRanks * xmlMemSize(NCCL_TOPO_XML_MAX_NODES)), ret, fail);
-  rankXml = (struct ncclXml*)(mem+xmlMemSize(NCCL_TOPO_XML_MAX_NODES)*localRank);
-  memcpy(rankXml, xml, xmlMemSize(NCCL_TOPO_XML_MAX_NODES));
-  NCCLCHECKGOTO(ncclTopoConvertXml(rankXml, (uintptr_t)xml->nodes, 1), ret, fail);
-  // nLocalRanks can't actually be 0, or we wouldn't be running at all...
-  // coverity[divide_by_zero]
-  NCCLCHECKGOTO(bootstrapIntraNodeAllGather(comm->bootstrap, localRanks, localRank, nLocalRanks, mem, xmlMemSize(NCCL_TOPO_XML_MAX_NODES)), ret, fail);
-  if (comm->MNNVL) {
-    // Ensure that we have enough room when fusing topos from multiple nodes.
-    free(xml);
-    xml = NULL;
-    NCCLCHECKGOTO(xmlAlloc(&xml, nLocalRanks*NCCL_TOPO_XML_MAX_NODES), ret, fail);
+  if (NCCL_TOPO_XML_COMPACT_EXCHANGE) {
+    NCCLCHECKGOTO(ncclTopoFuseXmlCompact(comm, localRanks, localRank, nLocalRanks, &xml), ret, fail);
   } else {
-    // In the intra-node case there's no need to enlarge the topo xml.
-    xml->maxIndex = 0;
-  }
-  for (int i = 0; i < nLocalRanks; i++) {
-    struct ncclXml* peerXml = (struct ncclXml*)(mem+xmlMemSize(NCCL_TOPO_XML_MAX_NODES)*i);
-    NCCLCHECKGOTO(ncclTopoConvertXml(peerXml, (uintptr_t)peerXml->nodes, 0), ret, fail);
-    NCCLCHECKGOTO(ncclTopoFuseXml(xml, peerXml), ret, fail);
+    NCCLCHECKGOTO(ncclCalloc(&mem, nLocalRanks * xmlMemSize(NCCL_TOPO_XML_MAX_NODES)), ret, fail);
+    rankXml = (struct ncclXml*)(mem+xmlMemSize(NCCL_TOPO_XML_MAX_NODES)*localRank);
+    memcpy(rankXml, xml, xmlMemSize(NCCL_TOPO_XML_MAX_NODES));
+    NCCLCHECKGOTO(ncclTopoConvertXml(rankXml, (uintptr_t)xml->nodes, 1), ret, fail);
+    // nLocalRanks can't actually be 0, or we wouldn't be running at all...
+    // coverity[divide_by_zero]
+    NCCLCHECKGOTO(bootstrapIntraNodeAllGather(comm->bootstrap, localRanks, localRank, nLocalRanks, mem, xmlMemSize(NCCL_TOPO_XML_MAX_NODES)), ret, fail);
+    if (comm->MNNVL) {
+      // Ensure that we have enough room when fusing topos from multiple nodes.
+      free(xml);
+      xml = NULL;
+      NCCLCHECKGOTO(xmlAlloc(&xml, nLocalRanks*NCCL_TOPO_XML_MAX_NODES), ret, fail);
+    } else {
+      // In the intra-node case there's no need to enlarge the topo xml.
+      xml->maxIndex = 0;
+    }
+    for (int i = 0; i < nLocalRanks; i++) {
+      struct ncclXml* peerXml = (struct ncclXml*)(mem+xmlMemSize(NCCL_TOPO_XML_MAX_NODES)*i);
+      NCCLCHECKGOTO(ncclTopoConvertXml(peerXml, (uintptr_t)peerXml->nodes, 0), ret, fail);
+      NCCLCHECKGOTO(ncclTopoFuseXml(xml, peerXml), ret, fail);
+    }
   }
 
   if (dumpXmlFile && comm->rank == NCCL_TOPO_DUMP_FILE_RANK) {
@@ -170,6 +170,10 @@ struct ncclTopoNodeSet {
   struct ncclTopoNode nodes[NCCL_TOPO_MAX_NODES];
 };
 
+namespace ncclx::topology {
+class TopoPathCache;
+}
+
 struct ncclTopoSystem {
   int systemId;
   uint64_t hostHashes[NCCL_TOPO_MAX_NODES];
@@ -177,6 +181,8 @@ struct ncclTopoSystem {
   struct ncclTopoNodeSet nodes[NCCL_TOPO_NODE_TYPES];
   float maxBw;
   float totalBw;
+  // NCCLX: paths of the last ncclTopoComputePaths(), see ncclTopoSetAllPaths()
+  ncclx::topology::TopoPathCache* pathCache;
 };
 
 ncclResult_t ncclTopoGetNode(struct ncclTopoSystem* system, struct ncclTopoNode** node, int type, uint64_t id);
@@ -184,6 +190,10 @@ ncclResult_t ncclTopoCreateNode(struct ncclTopoSystem* system, struct ncclTopoNo
 ncclResult_t ncclTopoRemoveNode(struct ncclTopoSystem* system, int type, int id);
 ncclResult_t ncclTopoConnectNodes(struct ncclTopoNode* node, struct ncclTopoNode* remNode, int type, float bw);
 ncclResult_t ncclTopoPrintPaths(struct ncclTopoSystem* system);
+// NCCLX: paths to all CPUs, GPUs, NICs and NVSwitches, before the P2P, GDR and
+// PXN adjustments of ncclTopoComputePaths(). Paths of an earlier call are
+// reused when NCCL_TOPO_PATH_CACHE is set and only nodes were removed since.
+ncclResult_t ncclTopoSetAllPaths(struct ncclTopoSystem* system);
 ncclResult_t ncclTopoLoadSystem(const char* xmlTopoFile, struct ncclTopoSystem* system);
 ncclResult_t ncclTopoGetIntermediateRank(struct ncclTopoSystem* system, int rank, int64_t netId, int* intermediateRank);
 ncclResult_t ncclTopoGetGpuMinPath(struct ncclTopoSystem* system, int type, int* min);
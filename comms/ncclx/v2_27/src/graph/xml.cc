@@ -10,6 +10,8 @@
 #include <fcntl.h>
 #include <ctype.h>
 #include <float.h>
+#include <unordered_map>
+#include <vector>
 #include "core.h"
 #include "nvmlwrap.h"
 #include "xml.h"
@@ -319,6 +321,285 @@ ncclResult_t ncclTopoFuseXml(struct ncclXml* dst, struct ncclXml* src) {
   return ncclSuccess;
 }
 
+/*************************************/
+/* NCCLX: compact topology exchange  */
+/*************************************/
+
+// Only the nodes reachable from the roots are packed, in depth-first order so
+// that the tree is rebuilt without pointers:
+//   header : int32 magic, int32 nNodes, int32 nRoots
+//   node   : int32 type, str name, uint8 nAttrs, nAttrs * (str key, str value),
+//            int32 nSubs, followed by its nSubs subtrees
+//   str    : uint8 length, characters without terminator
+#define NCCL_TOPO_XML_PACK_MAGIC 0x4c4d5843
+#define NCCL_TOPO_XML_PACK_HEADER_SIZE (3*sizeof(int32_t))
+
+struct xmlPackBuf {
+  char* buf; // NULL to only compute the size
+  size_t offset;
+};
+
+static void xmlPackBytes(struct xmlPackBuf* pack, const void* data, size_t size) {
+  if (pack->buf) memcpy(pack->buf+pack->offset, data, size);
+  pack->offset += size;
+}
+
+static void xmlPackInt(struct xmlPackBuf* pack, int32_t value) {
+  xmlPackBytes(pack, &value, sizeof(value));
+}
+
+static void xmlPackStr(struct xmlPackBuf* pack, const char* str) {
+  uint8_t len = strnlen(str, MAX_STR_LEN);
+  xmlPackBytes(pack, &len, sizeof(len));
+  xmlPackBytes(pack, str, len);
+}
+
+static void xmlPackNode(struct xmlPackBuf* pack, struct ncclXmlNode* node, int* nNodes) {
+  (*nNodes)++;
+  xmlPackInt(pack, node->type);
+  xmlPackStr(pack, node->name);
+  uint8_t nAttrs = node->nAttrs;
+  xmlPackBytes(pack, &nAttrs, sizeof(nAttrs));
+  for (int a=0; a<node->nAttrs; a++) {
+    xmlPackStr(pack, node->attrs[a].key);
+    xmlPackStr(pack, node->attrs[a].value);
+  }
+  xmlPackInt(pack, node->nSubs);
+  for (int s=0; s<node->nSubs; s++) xmlPackNode(pack, node->subs[s], nNodes);
+}
+
+ncclResult_t ncclTopoPackXml(struct ncclXml* xml, char* buf, size_t* size) {
+  struct xmlPackBuf pack = { buf, NCCL_TOPO_XML_PACK_HEADER_SIZE };
+  int32_t header[3] = { NCCL_TOPO_XML_PACK_MAGIC, 0, 0 };
+  for (int n=0; n<xml->maxIndex; n++) {
+    struct ncclXmlNode* node = xml->nodes+n;
+    // Removed nodes keep their parent, they are only unlinked from it
+    if (node->parent) continue;
+    xmlPackNode(&pack, node, header+1);
+    header[2]++;
+  }
+  if (buf) memcpy(buf, header, sizeof(header));
+  *size = pack.offset;
+  return ncclSuccess;
+}
+
+struct xmlUnpackBuf {
+  const char* buf;
+  size_t size;
+  size_t offset;
+};
+
+static ncclResult_t xmlUnpackBytes(struct xmlUnpackBuf* unpack, void* data, size_t size) {
+  if (size > unpack->size-unpack->offset) {
+    WARN("XML Unpack : truncated buffer of %zu bytes", unpack->size);
+    return ncclInternalError;
+  }
+  memcpy(data, unpack->buf+unpack->offset, size);
+  unpack->offset += size;
+  return ncclSuccess;
+}
+
+static ncclResult_t xmlUnpackStr(struct xmlUnpackBuf* unpack, char* str) {
+  uint8_t len;
+  NCCLCHECK(xmlUnpackBytes(unpack, &len, sizeof(len)));
+  NCCLCHECK(xmlUnpackBytes(unpack, str, len));
+  str[len] = '\0';
+  return ncclSuccess;
+}
+
+static ncclResult_t xmlUnpackHeader(struct xmlUnpackBuf* unpack, int32_t header[3]) {
+  NCCLCHECK(xmlUnpackBytes(unpack, header, 3*sizeof(int32_t)));
+  if (header[0] != NCCL_TOPO_XML_PACK_MAGIC || header[1] < 0 || header[2] < 0) {
+    WARN("XML Unpack : invalid header");
+    return ncclInternalError;
+  }
+  return ncclSuccess;
+}
+
+static ncclResult_t xmlUnpackNode(struct xmlUnpackBuf* unpack, struct ncclXml* xml, struct ncclXmlNode* parent, int depth) {
+  if (xml->maxIndex == xml->maxNodes) {
+    WARN("Error : too many XML nodes (max %d)", xml->maxNodes);
+    return ncclInternalError;
+  }
+  if (depth == NCCL_MAX_XML_DEPTH) {
+    WARN("XML Unpack : tree deeper than %d", NCCL_MAX_XML_DEPTH);
+    return ncclInternalError;
+  }
+  struct ncclXmlNode* node = xml->nodes+xml->maxIndex++;
+  int32_t type, nSubs;
+  uint8_t nAttrs;
+  NCCLCHECK(xmlUnpackBytes(unpack, &type, sizeof(type)));
+  NCCLCHECK(xmlUnpackStr(unpack, node->name));
+  NCCLCHECK(xmlUnpackBytes(unpack, &nAttrs, sizeof(nAttrs)));
+  if (nAttrs > MAX_ATTR_COUNT) {
+    WARN("XML Unpack : too many attributes (%d) for node %s", nAttrs, node->name);
+    return ncclInternalError;
+  }
+  for (int a=0; a<nAttrs; a++) {
+    NCCLCHECK(xmlUnpackStr(unpack, node->attrs[a].key));
+    NCCLCHECK(xmlUnpackStr(unpack, node->attrs[a].value));
+  }
+  node->type = type;
+  node->nAttrs = nAttrs;
+  node->parent = parent;
+  node->nSubs = 0;
+  NCCLCHECK(xmlUnpackBytes(unpack, &nSubs, sizeof(nSubs)));
+  if (nSubs < 0 || nSubs > MAX_SUBS) {
+    WARN("XML Unpack : invalid number of subnodes (%d) for node %s", nSubs, node->name);
+    return ncclInternalError;
+  }
+  for (int s=0; s<nSubs; s++) {
+    node->subs[node->nSubs++] = xml->nodes+xml->maxIndex;
+    NCCLCHECK(xmlUnpackNode(unpack, xml, node, depth+1));
+  }
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoPackedXmlNodes(const char* buf, size_t size, int* nNodes) {
+  struct xmlUnpackBuf unpack = { buf, size, 0 };
+  int32_t header[3];
+  NCCLCHECK(xmlUnpackHeader(&unpack, header));
+  *nNodes = header[1];
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoUnpackXml(const char* buf, size_t size, struct ncclXml* xml) {
+  struct xmlUnpackBuf unpack = { buf, size, 0 };
+  int32_t header[3];
+  NCCLCHECK(xmlUnpackHeader(&unpack, header));
+  if (header[1] > xml->maxNodes) {
+    WARN("Error : too many XML nodes (%d, max %d)", header[1], xml->maxNodes);
+    return ncclInternalError;
+  }
+  xml->maxIndex = 0;
+  for (int r=0; r<header[2]; r++) NCCLCHECK(xmlUnpackNode(&unpack, xml, NULL, 0));
+  if (xml->maxIndex != header[1] || unpack.offset != size) {
+    WARN("XML Unpack : inconsistent buffer (%d nodes, expected %d)", xml->maxIndex, header[1]);
+    return ncclInternalError;
+  }
+  return ncclSuccess;
+}
+
+// Subnodes of fused nodes, bucketed by what xmlFindNode compares. Buckets keep
+// subs order, so the first match in a bucket is the one xmlFindNode returns.
+struct ncclTopoXmlSubIndex {
+  int nSubs; // parent->nSubs when indexed
+  std::unordered_map<uint64_t, std::vector<struct ncclXmlNode*>> buckets;
+};
+
+struct ncclTopoXmlIndex {
+  std::unordered_map<struct ncclXmlNode*, struct ncclTopoXmlSubIndex> parents;
+};
+
+#define XML_FNV_OFFSET 0xcbf29ce484222325ULL
+#define XML_FNV_PRIME 0x100000001b3ULL
+
+// FNV-1a, terminator included so that adjacent strings can't run together
+static uint64_t xmlHashStr(uint64_t h, const char* str) {
+  do { h = (h ^ (uint8_t)*str) * XML_FNV_PRIME; } while (*str++);
+  return h;
+}
+
+// Attributes are summed: xmlFindNode ignores their order
+static uint64_t xmlHashNode(struct ncclXmlNode* node) {
+  uint64_t h = xmlHashStr(XML_FNV_OFFSET, node->name);
+  h = (h ^ node->type) * XML_FNV_PRIME;
+  h = (h ^ node->nAttrs) * XML_FNV_PRIME;
+  uint64_t attrs = 0;
+  for (int a=0; a<node->nAttrs; a++) {
+    attrs += xmlHashStr(xmlHashStr(XML_FNV_OFFSET, node->attrs[a].key), node->attrs[a].value);
+  }
+  return (h ^ attrs) * XML_FNV_PRIME;
+}
+
+// With a repeated key, xmlFindNode can match nodes whose attributes differ
+static bool xmlHasDuplicateKeys(struct ncclXmlNode* node) {
+  for (int a=0; a<node->nAttrs; a++) {
+    for (int b=0; b<a; b++) {
+      if (strcmp(node->attrs[a].key, node->attrs[b].key) == 0) return true;
+    }
+  }
+  return false;
+}
+
+static struct ncclTopoXmlSubIndex* xmlGetSubIndex(struct ncclTopoXmlIndex* index, struct ncclXmlNode* parent) {
+  auto it = index->parents.find(parent);
+  if (it != index->parents.end() && it->second.nSubs == parent->nSubs) return &it->second;
+  // New, or changed since it was indexed
+  struct ncclTopoXmlSubIndex* subIndex = &index->parents[parent];
+  subIndex->buckets.clear();
+  for (int s=0; s<parent->nSubs; s++) {
+    subIndex->buckets[xmlHashNode(parent->subs[s])].push_back(parent->subs[s]);
+  }
+  subIndex->nSubs = parent->nSubs;
+  return subIndex;
+}
+
+static bool xmlNodeMatches(struct ncclXmlNode* n, struct ncclXmlNode* searchNode) {
+  if (strcmp(n->name, searchNode->name) || n->type != searchNode->type || n->nAttrs != searchNode->nAttrs) return false;
+  for (int a=0; a<searchNode->nAttrs; a++) {
+    const char* val;
+    xmlGetAttr(n, searchNode->attrs[a].key, &val);
+    if (!val || strcmp(val, searchNode->attrs[a].value)) return false;
+  }
+  return true;
+}
+
+static ncclResult_t xmlTopoFuseXmlIndexedRecursive(struct ncclXml* dst, struct ncclXmlNode* dstParent, struct ncclXmlNode* srcParent, struct ncclTopoXmlIndex* index) {
+  for (int i = 0; i < srcParent->nSubs; i++) {
+    struct ncclXmlNode* srcNode = srcParent->subs[i];
+    struct ncclXmlNode* dstNode = NULL;
+    struct ncclTopoXmlSubIndex* subIndex = xmlGetSubIndex(index, dstParent);
+    uint64_t hash = xmlHashNode(srcNode);
+    if (xmlHasDuplicateKeys(srcNode)) {
+      NCCLCHECK(xmlFindNode(dstParent, srcNode, &dstNode));
+    } else {
+      auto it = subIndex->buckets.find(hash);
+      if (it != subIndex->buckets.end()) {
+        for (struct ncclXmlNode* n : it->second) {
+          if (xmlNodeMatches(n, srcNode)) { dstNode = n; break; }
+        }
+      }
+    }
+    if (dstNode == NULL) {
+      NCCLCHECK(xmlAddTree(dst, dstParent, srcNode));
+      // Appended last, so it also goes last in its bucket
+      subIndex->buckets[hash].push_back(dstParent->subs[dstParent->nSubs-1]);
+      subIndex->nSubs = dstParent->nSubs;
+    } else {
+      NCCLCHECK(xmlTopoFuseXmlIndexedRecursive(dst, dstNode, srcNode, index));
+    }
+  }
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoXmlIndexCreate(struct ncclTopoXmlIndex** index) {
+  *index = new ncclTopoXmlIndex();
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoXmlIndexFree(struct ncclTopoXmlIndex* index) {
+  delete index;
+  return ncclSuccess;
+}
+
+ncclResult_t ncclTopoFuseXmlIndexed(struct ncclXml* dst, struct ncclXml* src, struct ncclTopoXmlIndex* index) {
+  struct ncclXmlNode* topNodeDst;
+  NCCLCHECK(xmlFindTag(dst, "system", &topNodeDst));
+
+  if (topNodeDst == NULL) {
+    NCCLCHECK(xmlAddTree(dst, NULL, src->nodes));
+    return ncclSuccess;
+  }
+
+  struct ncclXmlNode* topNodeSrc;
+  NCCLCHECK(xmlFindTag(src, "system", &topNodeSrc));
+
+  NCCLCHECK(xmlTopoFuseXmlIndexedRecursive(dst, topNodeDst, topNodeSrc, index));
+
+  return ncclSuccess;
+}
+
 
 /****************************************/
 /* Parser rules for our specific format */
@@ -60,6 +60,20 @@ ncclResult_t ncclTopoFuseXml(struct ncclXml* dst, struct ncclXml* src);
 /* Relocate pointers in XML to (de-)serialize the structure */
 ncclResult_t ncclTopoConvertXml(struct ncclXml* xml, uintptr_t base, int exp);
 
+/* NCCLX: compact serialization of the nodes reachable from the roots, to
+ * exchange topologies without sending NCCL_TOPO_XML_MAX_NODES nodes per rank.
+ * With buf == NULL, ncclTopoPackXml only returns the size. */
+ncclResult_t ncclTopoPackXml(struct ncclXml* xml, char* buf, size_t* size);
+ncclResult_t ncclTopoPackedXmlNodes(const char* buf, size_t size, int* nNodes);
+ncclResult_t ncclTopoUnpackXml(const char* buf, size_t size, struct ncclXml* xml);
+/* NCCLX: same result as ncclTopoFuseXml, with the subnodes of dst indexed
+ * across calls instead of searched linearly. An index is only valid for one
+ * dst, which must not be modified by anything else while it is in use. */
+struct ncclTopoXmlIndex;
+ncclResult_t ncclTopoXmlIndexCreate(struct ncclTopoXmlIndex** index);
+ncclResult_t ncclTopoXmlIndexFree(struct ncclTopoXmlIndex* index);
+ncclResult_t ncclTopoFuseXmlIndexed(struct ncclXml* dst, struct ncclXml* src, struct ncclTopoXmlIndex* index);
+
 /**************/
 /* XML Struct */
 /* Functions  */
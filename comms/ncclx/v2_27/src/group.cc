@@ -19,6 +19,7 @@
 #include "comms/utils/logger/EventsScubaUtil.h"
 #include "comms/ctran/utils/Utils.h"
 #include "meta/wrapper/MetaFactory.h"
+#include "meta/group/AsyncJobPool.h"
 
 #define GROUP_MAX_RECLAIM_STEPS 10
 
@@ -426,6 +427,11 @@ static ncclResult_t asyncJobLaunch(struct ncclIntruQueue<struct ncclAsyncJob, &n
   bool jobsDone = false;
   bool errorJobAbortFlag = false;
 
+  if (ncclx::group::asyncJobPoolEnabled()) {
+    return ncclx::group::asyncJobPoolLaunch(
+        ncclx::group::AsyncJobPool::getInstance(), asyncJobsMain, groupAbortFlag);
+  }
+
   if (!ncclIntruQueueEmpty(asyncJobsMain)) {
     struct ncclAsyncJob* job = ncclIntruQueueHead(asyncJobsMain);
     do {
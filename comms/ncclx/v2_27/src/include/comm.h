@@ -38,6 +38,9 @@ class CommStateX;
 namespace ncclx::transport {
 class TransportProxy;
 } // namespace ncclx::transport
+namespace ncclx::tuning {
+class AlgoInfoCache;
+} // namespace ncclx::tuning
 
 #if CUDART_VERSION < 9000
 struct cudaLaunchParams {
@@ -698,6 +701,8 @@ struct ncclComm {
   std::shared_ptr<ncclx::memory::memCacheAllocator> memCache{nullptr};
   std::vector<std::string> connSetupBufKeys;
   std::shared_ptr<ncclx::transport::TransportProxy> transportProxy_;
+  // Memoized getAlgoInfo() decisions, created on first use
+  std::shared_ptr<ncclx::tuning::AlgoInfoCache> algoInfoCache{nullptr};
 
   // This is the only bridge between ctran and baseline code
   bool useCtran_{false}; // Ctran per-communicator control; set at init entry functions
@@ -19,6 +19,10 @@
 
 #include "meta/colltrace/ProxyTrace.h"
 
+namespace ncclx::proxy {
+class ExpectedResponseMap;
+} // namespace ncclx::proxy
+
 enum ncclProxyOpState { ncclProxyOpNone, ncclProxyOpReady, ncclProxyOpProgress };
 
 struct ncclProxyArgs;
@@ -192,6 +196,8 @@ struct ncclProxyOpsPool {
   volatile int nextOps;
   volatile int nextOpsEnd;
   volatile int freeOps[NCCL_MAX_LOCAL_RANKS];
+  // NCCLX: number of threads sleeping until freeOps[i] is refilled
+  volatile int freeOpsWaiters[NCCL_MAX_LOCAL_RANKS];
   pthread_mutex_t mutex;
   pthread_cond_t cond;
 };
@@ -246,16 +252,6 @@ struct ncclProxyProgressState {
   int nextOps;
 };
 
-// Expected proxy response fifo
-struct ncclExpectedProxyResponse {
-  void*                             opId;
-  int                               respSize;
-  bool                              done;
-  void*                             respBuff;
-  ncclResult_t                      res;
-  struct ncclExpectedProxyResponse* next;
-};
-
 struct ncclProxyAsyncOp {
   int type;
   struct ncclProxyConnection* connection;
@@ -263,6 +259,8 @@ struct ncclProxyAsyncOp {
   char *reqBuff, *respBuff;
   void* opId;
   ncclProxyAsyncOp* next;
+  // NCCLX: back link for O(1) dequeue
+  ncclProxyAsyncOp* prev;
 };
 
 struct ncclProxyLocalPeer {
@@ -270,6 +268,8 @@ struct ncclProxyLocalPeer {
   int tpRank;
   int tpLocalRank;
   ncclProxyAsyncOp* asyncOps;
+  // NCCLX: tail of asyncOps for O(1) enqueue
+  ncclProxyAsyncOp* asyncOpsTail;
   int asyncOpCounter;
 };
 
@@ -312,6 +312,8 @@ struct ncclProxyState {
   pthread_t threadUDS;
   struct ncclSocket* listenSock;
   struct ncclIpcSocket ipcSock;
+  // NCCLX: eventfd to wake the service thread up from other threads
+  int serviceWakeupFd;
   int stop;
   CUcontext cudaCtx;
   ncclResult_t asyncResult;
@@ -332,8 +334,8 @@ struct ncclProxyState {
   // Profiler plugin
   void* profilerContext;
 
-  // Queue of expected responses from the proxy
-  struct ncclExpectedProxyResponse* expectedResponses;
+  // NCCLX: expected responses from the proxy, indexed by opId
+  ncclx::proxy::ExpectedResponseMap* expectedResponses;
 
   // reference back to communicator used for logging purpose
   ncclComm* owner{nullptr};
@@ -377,6 +379,21 @@ enum proxyMode {
   proxyTo = 2
 };
 
+// Request and response of ncclProxyMsgInit. NCCLX: in the header so that
+// tests can act as a proxy client.
+struct ncclProxyInitReq {
+  int transport;
+  int send;
+  int tpLocalRank;
+  int tpRank;
+  int sameProcess;
+};
+
+struct ncclProxyInitResp {
+  ncclProxyConnection* connection;
+  char devShmPath[6]; // "XXXXXX" - May or may not be set
+};
+
 ncclResult_t ncclProxySaveOp(struct ncclComm* comm, struct ncclProxyOp* proxyOp, bool *justInquire);
 ncclResult_t ncclProxyStart(struct ncclComm* comm);
 ncclResult_t ncclProxyInit(struct ncclComm* comm, struct ncclSocket* sock, union ncclSocketAddress* peerAddresses, uint64_t *peerAddressesUDS);
@@ -413,6 +430,10 @@ ncclResult_t ncclProxyClientGetFdBlocking(struct ncclComm* comm, int rank, void
 ncclResult_t ncclProxyClientQueryFdBlocking(struct ncclComm* comm, struct ncclProxyConnector* proxyConn, int localFd, int* rmtFd);
 
 ncclResult_t ncclProxyStop(struct ncclComm* comm);
+// NCCLX: service thread entry point, and a thread-safe way to end its wait for
+// events, e.g. when an async op is queued or completes
+void* ncclProxyService(void* _args);
+void ncclProxyServiceWakeup(struct ncclProxyState* proxyState);
 ncclResult_t ncclProxyShmUnlink(struct ncclComm* comm);
 ncclResult_t ncclProxyDestroy(struct ncclComm* comm);
 #endif
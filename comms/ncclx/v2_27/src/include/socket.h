@@ -66,6 +66,7 @@ struct ncclSocket {
   int customRetry;
   int finalizeCounter; // Used to keep track of initial handshake for async sockets.
   char finalizeBuffer[sizeof(uint64_t)]; // Used to keep track of initial handshake for async sockets.
+  uint64_t retryDeadline; // NCCLX: clockNano() before which a failed connect is not retried, 0 if none
 };
 
 const char *ncclSocketToString(const union ncclSocketAddress *addr, char *buf, const int numericHostForm = 1);
@@ -197,6 +197,7 @@ static void ncclxCommFree(ncclComm_t comm) {
     comm->memCache.reset();
     ncclx::transport::tranportProxyShutdown(comm);
   }
+  comm->algoInfoCache.reset();
 }
 
 static ncclResult_t commFree(ncclComm_t comm) {
@@ -594,6 +594,25 @@ cleanup:
   goto exit;
 }
 
+// NCCLX: exponential backoff from NCCL_SOCKET_RETRY_SLEEP_MSEC up to
+// NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC, with +/-50% jitter so that ranks which
+// started together don't retry in lock-step.
+static unsigned int socketRetrySleepMsec(int retries) {
+  static thread_local uint64_t seed = 0;
+  if (seed == 0) seed = (clockNano() ^ ((uint64_t)getpid() << 32)) | 1;
+  // xorshift64
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+
+  int64_t maxSleepTime = std::max(NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC, NCCL_SOCKET_RETRY_SLEEP_MSEC);
+  int64_t sleepTime = NCCL_SOCKET_RETRY_SLEEP_MSEC;
+  for (int i=1; i<retries && sleepTime < maxSleepTime; i++) sleepTime *= 2;
+  sleepTime = std::min(sleepTime, maxSleepTime);
+  // Uniform in [sleepTime/2, 3*sleepTime/2]
+  return sleepTime/2 + seed % (sleepTime+1);
+}
+
 static ncclResult_t socketConnectCheck(struct ncclSocket* sock, int errCode, const char funcName[]) {
   char line[SOCKET_NAME_MAXLEN+1];
   if (errCode == 0) {
@@ -609,11 +628,12 @@ static ncclResult_t socketConnectCheck(struct ncclSocket* sock, int errCode, con
              funcName, ncclSocketToString(&sock->addr, line), strerror(errCode), sock->errorRetries);
         return ncclRemoteError;
       }
-      unsigned int sleepTime = sock->errorRetries * NCCL_SOCKET_RETRY_SLEEP_MSEC;
+      unsigned int sleepTime = socketRetrySleepMsec(sock->errorRetries);
       INFO(NCCL_NET|NCCL_INIT, "%s: connect to %s returned %s, retrying (%d/%ld) after sleep for %u msec",
            funcName, ncclSocketToString(&sock->addr, line), strerror(errCode),
            sock->errorRetries, NCCL_SOCKET_RETRY_CNT, sleepTime);
-      msleep(sleepTime);
+      // NCCLX: the connect is retried by socketProgressState() once the delay is over
+      sock->retryDeadline = clockNano() + sleepTime * 1000000ULL;
     }
     NCCLCHECK(socketResetFd(sock)); /* in case of failure in connect, socket state is unspecified */
     sock->state = ncclSocketStateConnecting;
@@ -693,6 +713,16 @@ static ncclResult_t socketProgressState(struct ncclSocket* sock) {
   if (sock->state == ncclSocketStateAccepted) {
     NCCLCHECK(socketFinalizeAccept(sock));
   }
+  if (sock->state == ncclSocketStateConnecting && sock->retryDeadline) {
+    // NCCLX: asynchronous sockets come back later instead of sleeping, so
+    // that threads progressing many of them aren't held up by one
+    uint64_t now = clockNano();
+    if (now < sock->retryDeadline) {
+      if (sock->asyncFlag) return ncclSuccess;
+      msleep((sock->retryDeadline - now + 999999) / 1000000);
+    }
+    sock->retryDeadline = 0;
+  }
   if (sock->state == ncclSocketStateConnecting) {
     NCCLCHECK(socketStartConnect(sock));
   }
@@ -837,6 +867,7 @@ ncclResult_t ncclSocketInit(struct ncclSocket* sock, const union ncclSocketAddre
 
   if (sock == NULL) goto exit;
   sock->errorRetries = 0;
+  sock->retryDeadline = 0;
   sock->abortFlag = abortFlag;
   sock->asyncFlag = asyncFlag;
   sock->state = ncclSocketStateInitialized;
@@ -21,6 +21,9 @@
 #include <sched.h>
 
 #include "meta/colltrace/ProxyTraceFunc.h"
+#include "meta/proxy/ExpectedResponseMap.h"
+#include "meta/proxy/ProxyOpsPoolWait.h"
+#include "meta/proxy/ProxyServicePoller.h"
 #include "comms/utils/cvars/nccl_cvars.h"
 #include "comms/utils/logger/EventsScubaUtil.h"
 
@@ -49,155 +52,48 @@ struct ncclProxyPool {
   struct ncclProxyArgs elems[PROXYARGS_ALLOCATE_SIZE];
 };
 
-static void expectedProxyResponseFree(struct ncclProxyState* state) {
-  struct ncclExpectedProxyResponse* elem = state->expectedResponses;
-  struct ncclExpectedProxyResponse* prev = NULL;
-
-  while (elem) {
-    prev = elem;
-    elem = elem->next;
-    free(prev->respBuff);
-    free(prev);
-  }
-}
-
-static ncclResult_t expectedProxyResponseStore(struct ncclProxyState* state, void* opId, void* respBuff, int respSize, ncclResult_t res) {
-  struct ncclExpectedProxyResponse* elem = state->expectedResponses;
-  while (elem) {
-    if (elem->opId == opId) {
-      if (respSize != elem->respSize) {
-        WARN("Mismatched response size for opId=%p", opId);
-        return ncclInternalError;
-      }
-
-      if (elem->done) {
-        WARN("Storing response for already completed opId=%p", opId);
-        return ncclInternalError;
-      }
-
-      if (respSize > 0) {
-        memcpy(elem->respBuff, respBuff, respSize);
-        free(respBuff);
-      }
-      elem->done = true;
-      elem->res  = res;
-      return ncclSuccess;
-    }
-    elem = elem->next;
-  }
-
-  WARN("Proxy response for opId=%p doesn't match any expected response", opId);
-  return ncclInternalError;
-}
-
-static ncclResult_t expectedProxyResponseEnqueue(struct ncclProxyState* state, void* opId, int respSize) {
-  struct ncclExpectedProxyResponse* ex;
-  NCCLCHECK(ncclCalloc(&ex, 1));
-  ex->opId = opId;
-
-  // Pre-alloc response buffer
-  ex->respBuff = malloc(respSize);
-  ex->respSize = respSize;
-  ex->res      = ncclInternalError;
-  ex->done     = false;
-
-  // Enqueue
-  struct ncclExpectedProxyResponse* list = state->expectedResponses;
-  if (list == NULL) {
-    state->expectedResponses = ex;
-    return ncclSuccess;
-  }
-  while (list->next) list = list->next;
-  list->next = ex;
-  return ncclSuccess;
-}
-
-static ncclResult_t expectedProxyResponseDequeue(struct ncclProxyState* state, void* opId, void* respBuff, int* found) {
-  struct ncclExpectedProxyResponse* elem = state->expectedResponses;
-  struct ncclExpectedProxyResponse* prev = NULL;
-  *found = 0;
-  while (elem) {
-    if ((elem->opId == opId) && elem->done) {
-      if (prev == NULL) {
-        state->expectedResponses = elem->next;
-      } else {
-        prev->next = elem->next;
-      }
-      memcpy(respBuff, elem->respBuff, elem->respSize);
-      ncclResult_t res = elem->res;
-      free(elem->respBuff);
-      free(elem);
-      *found = 1;
-      return res;
-    }
-    prev = elem;
-    elem = elem->next;
-  }
-  return ncclSuccess;
-}
-
-static ncclResult_t expectedProxyResponseRemove(struct ncclProxyState* state, void* opId) {
-  struct ncclExpectedProxyResponse* elem = state->expectedResponses;
-  struct ncclExpectedProxyResponse* prev = NULL;
-  while (elem) {
-    if (elem->opId == opId) {
-      if (prev == NULL) {
-        state->expectedResponses = elem->next;
-      } else {
-        prev->next = elem->next;
-      }
-      free(elem->respBuff);
-      free(elem);
-      return ncclSuccess;
-    }
-    prev = elem;
-    elem = elem->next;
-  }
-  WARN("Couldn't find opId=%p", opId);
-  return ncclInternalError;
-}
-
 static ncclResult_t asyncProxyOpEnqueue(struct ncclProxyLocalPeer* peer, ncclProxyAsyncOp* op) {
-  ncclProxyAsyncOp* list = peer->asyncOps;
-  if (list == NULL) {
+  // NCCLX: append at the tracked tail instead of walking the list
+  op->next = NULL;
+  op->prev = peer->asyncOpsTail;
+  if (peer->asyncOpsTail == NULL) {
     peer->asyncOps = op;
-    return ncclSuccess;
+  } else {
+    peer->asyncOpsTail->next = op;
   }
-  while (list->next) list = list->next;
-  list->next = op;
+  peer->asyncOpsTail = op;
   return ncclSuccess;
 }
 
 static ncclResult_t asyncProxyOpDequeue(struct ncclProxyLocalPeer* peer, ncclProxyAsyncOp* op) {
-  struct ncclProxyAsyncOp* elem = peer->asyncOps;
-  struct ncclProxyAsyncOp* prev = NULL;
-  while (elem) {
-    if (elem->opId == op->opId) {
-      if (prev == NULL) {
-        peer->asyncOps = elem->next;
-      } else {
-        prev->next = elem->next;
-      }
-
-      if (elem->reqBuff) {
-        free(elem->reqBuff);
-      }
-      if (elem->respBuff) {
-        free(elem->respBuff);
-      }
-      free(elem);
-
-      return ncclSuccess;
-    }
-    prev = elem;
-    elem = elem->next;
+  if (op == NULL) {
+    WARN("Attempting to dequeue null operation");
+    return ncclInternalError;
   }
-  if (op) {
+  // NCCLX: unlink through the back pointer instead of searching by opId
+  if (op->prev == NULL && peer->asyncOps != op) {
     WARN("Attempting to dequeue nonexistent async opId=%p", op->opId);
+    return ncclInternalError;
+  }
+  if (op->prev == NULL) {
+    peer->asyncOps = op->next;
   } else {
-    WARN("Attempting to dequeue null operation");
+    op->prev->next = op->next;
   }
-  return ncclInternalError;
+  if (op->next == NULL) {
+    peer->asyncOpsTail = op->prev;
+  } else {
+    op->next->prev = op->prev;
+  }
+
+  if (op->reqBuff) {
+    free(op->reqBuff);
+  }
+  if (op->respBuff) {
+    free(op->respBuff);
+  }
+  free(op);
+  return ncclSuccess;
 }
 
 static ncclResult_t allocateArgs(struct ncclProxyProgressState* state, struct ncclProxyArgs** argsptr) {
@@ -491,7 +387,7 @@ static ncclResult_t ncclLocalOpAppend(struct ncclComm* comm, struct ncclProxyCon
     proxyOps->freeOp = op->next;
   } else {
     int freeOp;
-    while ((freeOp = pool->freeOps[tpLocalRank]) == -1) sched_yield();
+    freeOp = ncclx::proxy::waitFreeOps(pool->freeOps+tpLocalRank, pool->freeOpsWaiters+tpLocalRank, NCCL_PROXY_OPS_POOL_SPIN_COUNT);
     int freeOpNew;
     while ((freeOpNew = __sync_val_compare_and_swap(pool->freeOps+tpLocalRank, freeOp, -1)) != freeOp) freeOp = freeOpNew;
     opIndex = freeOp;
@@ -859,6 +755,7 @@ process_nextops:
         pool->freeOps[i] = newFree;
       }
     }
+    ncclx::proxy::wakeFreeOpsWaiters(pool->freeOps+i, pool->freeOpsWaiters+i);
   }
   ncclProfilerRecordProxyCtrlEventState(eHandle, *added, ncclProfilerProxyCtrlAppendEnd);
   ncclProfilerStopProxyCtrlEvent(eHandle);
@@ -1075,19 +972,6 @@ static ncclResult_t ncclProxyFreeConnections(struct ncclProxyConnectionPool* poo
 
 #include "transport.h"
 
-struct ncclProxyInitReq {
-  int transport;
-  int send;
-  int tpLocalRank;
-  int tpRank;
-  int sameProcess;
-};
-
-struct ncclProxyInitResp {
-  ncclProxyConnection* connection;
-  char devShmPath[6]; // "XXXXXX" - May or may not be set
-};
-
 ncclResult_t ncclProxyConnect(struct ncclComm* comm, int transport, int send, int proxyRank, struct ncclProxyConnector* proxyConn) {
   struct ncclSocket* sock;
   int ready;
@@ -1249,7 +1133,7 @@ ncclResult_t ncclProxyCallAsync(struct ncclComm* comm, struct ncclProxyConnector
   NCCLCHECKGOTO(ncclSocketSend(sock, &opId, sizeof(opId)), ret, error);
 
   // Add proxyOp to expected response queue
-  NCCLCHECK(expectedProxyResponseEnqueue(sharedProxyState, opId, respSize));
+  NCCLCHECK(sharedProxyState->expectedResponses->enqueue(opId, respSize));
 
   return ncclSuccess;
 error:
@@ -1267,7 +1151,7 @@ ncclResult_t ncclPollProxyResponse(struct ncclComm* comm, struct ncclProxyConnec
 
   // Check response queue
   int found = 0;
-  ncclResult_t res = expectedProxyResponseDequeue(sharedProxyState, opId, respBuff, &found);
+  ncclResult_t res = sharedProxyState->expectedResponses->dequeue(opId, respBuff, &found);
   if (found == 0) {
     // Attempt to read in a new response header from the proxy thread
     struct ncclSocket* sock = sharedProxyState->peerSocks + proxyConn->tpLocalRank;
@@ -1288,24 +1172,22 @@ ncclResult_t ncclPollProxyResponse(struct ncclComm* comm, struct ncclProxyConnec
 
     INFO(NCCL_PROXY, "ncclPollProxyResponse Received new opId=%p", resp.opId);
 
-    // If there's a respSize to recv
-    if (resp.respSize > 0) {
-      if (resp.opId != opId) {
-        // Unexpected response, need to buffer the socket data
-        respBuff = malloc(resp.respSize);
-      }
-      assert(respBuff != NULL);
-      NCCLCHECK(ncclSocketRecv(sock, respBuff, resp.respSize));
-    }
-
     if (resp.opId == opId) {
       INFO(NCCL_PROXY, "resp.opId=%p matches expected opId=%p", resp.opId, opId);
-      NCCLCHECK(expectedProxyResponseRemove(sharedProxyState, resp.opId));
+      // If there's a respSize to recv
+      if (resp.respSize > 0) {
+        assert(respBuff != NULL);
+        NCCLCHECK(ncclSocketRecv(sock, respBuff, resp.respSize));
+      }
+      NCCLCHECK(sharedProxyState->expectedResponses->remove(resp.opId));
       return resp.res;
     } else {
-      INFO(NCCL_PROXY, "Queuing opId=%p respBuff=%p respSize=%d", resp.opId, respBuff, resp.respSize);
-      // Store the result and mark response as completed
-      NCCLCHECK(expectedProxyResponseStore(sharedProxyState, resp.opId, respBuff, resp.respSize, resp.res));
+      // Unexpected response: store the result, mark the response as completed
+      // and receive the socket data straight into the entry's buffer
+      void* storeBuff = NULL;
+      NCCLCHECK(sharedProxyState->expectedResponses->store(resp.opId, resp.respSize, resp.res, &storeBuff));
+      if (resp.respSize > 0) NCCLCHECK(ncclSocketRecv(sock, storeBuff, resp.respSize));
+      INFO(NCCL_PROXY, "Queuing opId=%p respBuff=%p respSize=%d", resp.opId, storeBuff, resp.respSize);
       return ncclInProgress;
     }
   } else {
@@ -1347,6 +1229,7 @@ static ncclResult_t proxyProgressInit(struct ncclProxyState* proxyState) {
 
     for (int r = 0; r < proxyState->tpLocalnRanks; r++) {
       pool->freeOps[r] = r*MAX_OPS_PER_PEER;
+      pool->freeOpsWaiters[r] = 0;
       for (int i=0; i<MAX_OPS_PER_PEER-1; i++) pool->ops[r*MAX_OPS_PER_PEER+i].next = r*MAX_OPS_PER_PEER+i+1;
       pool->ops[(r+1)*MAX_OPS_PER_PEER-1].next = -1;
     }
@@ -1458,6 +1341,10 @@ error:
 #endif
 }
 
+void ncclProxyServiceWakeup(struct ncclProxyState* proxyState) {
+  ncclx::proxy::ProxyServicePoller::wakeup(proxyState->serviceWakeupFd);
+}
+
 static ncclResult_t proxyProgressAsync(struct ncclProxyAsyncOp* op, struct ncclProxyState* proxyState, int* asyncOpCount, struct ncclProxyLocalPeer* peer, struct ncclProxyConnectionPool* connectionPool) {
   int done = 1;
   ncclResult_t res = ncclInternalError;
@@ -1507,6 +1394,8 @@ static ncclResult_t proxyProgressAsync(struct ncclProxyAsyncOp* op, struct ncclP
 
     asyncProxyOpDequeue(peer, op);
     (*asyncOpCount)--;
+    // NCCLX: let the service loop retry the remaining async ops right away
+    ncclProxyServiceWakeup(proxyState);
     return ncclSuccess;
 
   } else if (__atomic_load_n(proxyState->abortFlag, __ATOMIC_ACQUIRE) != 0) {
@@ -1540,6 +1429,9 @@ static ncclResult_t proxyServiceInitOp(int type, struct ncclProxyLocalPeer* peer
   asyncProxyOpEnqueue(peer, asyncOp);
 
   (*asyncOpCount)++;
+  // NCCLX: retry the new op on the next iteration instead of after the async
+  // timeout
+  ncclProxyServiceWakeup(proxyState);
   NCCLCHECK(proxyProgressAsync(asyncOp, proxyState, asyncOpCount, peer, connectionPool));
 exit:
   return ret;
@@ -1592,43 +1484,39 @@ void* ncclProxyService(void* _args) {
   connectionPool.banks = 0;
   connectionPool.offset = NCCL_PROXY_CONN_POOL_SIZE;
 
-  struct pollfd pollfds[NCCL_MAX_PROXY_CONNECTIONS+1]; // one extra for listenSock fd
   struct ncclProxyLocalPeer peers[NCCL_MAX_PROXY_CONNECTIONS];
   memset(&peers, 0, sizeof(struct ncclProxyLocalPeer)*NCCL_MAX_PROXY_CONNECTIONS);
-  for (int s=0; s<NCCL_MAX_PROXY_CONNECTIONS; s++) {
-    pollfds[s].fd = -1;
-    pollfds[s].events = POLLHUP|POLLIN;
-  }
-  if (ncclSocketGetFd(proxyState->listenSock, &pollfds[NCCL_MAX_PROXY_CONNECTIONS].fd) != ncclSuccess) {
+  // Only connected peers and the listenSock are registered for events; the
+  // loop visits a peer only when it has events or outstanding async ops.
+  ncclx::proxy::ProxyServicePoller poller(
+      NCCL_MAX_PROXY_CONNECTIONS,
+      NCCL_PROXY_SERVICE_SPIN_COUNT,
+      NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS,
+      500 /* never let proxy service thread block long, or it cannot receive abortFlag */);
+  int listenFd = -1;
+  if (ncclSocketGetFd(proxyState->listenSock, &listenFd) != ncclSuccess) {
     WARN("[Proxy Service] Get listenSock fd fails");
     return NULL;
   };
-  pollfds[NCCL_MAX_PROXY_CONNECTIONS].events = POLLIN;
+  if (poller.init(listenFd, proxyState->serviceWakeupFd) != ncclSuccess) {
+    return NULL;
+  }
 
   int maxnpeers = 0;
-  int npeers = 0;
   int stop = PROXY_RUNNING;
   int asyncOpCount = 0;
-  while (stop == PROXY_RUNNING || npeers > 0) {
+  while (stop == PROXY_RUNNING || poller.numPeers() > 0) {
     /* Even if local comm aborts, we cannot let proxy thread exit if we still have peer
      * connections. Need to wait until all other related comms call abort and safely exit
      * together, or we could face segmentation fault. */
     if (__atomic_load_n(proxyState->abortFlag, __ATOMIC_ACQUIRE) != 0) stop = PROXY_ABORT;
-    /* never let proxy service thread blocks in poll, or it cannot receive abortFlag. */
-    int ret;
-    do {
-      // poll all fds including the listenSock
-      ret = poll(pollfds, NCCL_MAX_PROXY_CONNECTIONS+1, asyncOpCount ? 0 : 500);
-    } while (ret < 0 && errno == EINTR);
-    if (ret < 0) {
-      WARN("[Proxy Service] Poll failed: %s", strerror(errno));
+    if (poller.wait(asyncOpCount > 0) != ncclSuccess) {
       return NULL;
     }
-    if (pollfds[NCCL_MAX_PROXY_CONNECTIONS].revents) {
+    if (poller.listenReady()) {
       // We got an event on the listenSock
-      int s = 0;
-      while (s < NCCL_MAX_PROXY_CONNECTIONS && pollfds[s].fd >= 0) s++;
-      if (s == NCCL_MAX_PROXY_CONNECTIONS) {
+      int s = poller.freeSlot();
+      if (s == -1) {
         WARN("[Proxy service] Too many connections (%d max)", NCCL_MAX_PROXY_CONNECTIONS);
         return NULL;
       }
@@ -1640,24 +1528,32 @@ void* ncclProxyService(void* _args) {
       if (ncclSocketAccept(&peers[s].sock, proxyState->listenSock) != ncclSuccess) {
         WARN("[Service thread] Accept failed %s", strerror(errno));
       } else {
-        if (ncclSocketGetFd(&peers[s].sock, &pollfds[s].fd) != ncclSuccess) {
+        int fd = -1;
+        if (ncclSocketGetFd(&peers[s].sock, &fd) != ncclSuccess) {
           WARN("[Service thread] Get peers[%d].sock fd fails", s);
           return NULL;
         }
-        npeers++;
+        if (poller.addPeer(s, fd) != ncclSuccess) {
+          return NULL;
+        }
         peers[s].tpLocalRank = -1;
       }
     }
-    for (int s=0; s<maxnpeers; s++) {
+    // Iterate backwards as closing a connection moves the last active peer
+    // into the current position.
+    const std::vector<int>& activePeers = poller.activePeers();
+    for (int i = (int)activePeers.size()-1; i >= 0; i--) {
+      int s = activePeers[i];
       struct ncclProxyLocalPeer* peer = peers+s;
       struct ncclSocket* sock = &peer->sock;
+      uint32_t revents = poller.peerEvents(s);
       int closeConn = 0;
       int type = 0;
       ncclResult_t res = ncclSuccess;
-      if (pollfds[s].fd == -1) continue;
 
       // Progress all ops for this ncclProxyLocalPeer
       if (stop == PROXY_ABORT && ncclCuMemEnable() && ncclCuMemHostEnable() && !proxyState->directMode && __atomic_load_n(&proxyState->stop, __ATOMIC_ACQUIRE)) closeConn = 1;
+      if (!closeConn && revents == 0 && peer->asyncOps == nullptr) continue;
       ncclProxyAsyncOp* op = peer->asyncOps;
       while (op != nullptr) {
         ncclProxyAsyncOp* opnext = op->next; /* in case op is freed in proxyProgressAsync */
@@ -1677,7 +1573,7 @@ void* ncclProxyService(void* _args) {
       }
 
       // Check for additional ops coming in
-      if (pollfds[s].revents & POLLIN) {
+      if (revents & ncclx::proxy::ProxyServicePoller::kPeerIn) {
         int closed;
         res = ncclSocketTryRecv(sock, &type, sizeof(int), &closed, false /*blocking*/);
         if (res != ncclSuccess && res != ncclInProgress) {
@@ -1702,7 +1598,7 @@ void* ncclProxyService(void* _args) {
 
           INFO(NCCL_PROXY, "Received and initiated operation=%s res=%d", ncclProxyMsgTypeStr[type], res);
         }
-      } else if (pollfds[s].revents & POLLHUP) {
+      } else if (revents & ncclx::proxy::ProxyServicePoller::kPeerHup) {
         closeConn = 1;
       }
       if (res != ncclSuccess && res != ncclInProgress) {
@@ -1712,14 +1608,15 @@ void* ncclProxyService(void* _args) {
       }
 
       if (closeConn) {
+        // Deregister before closing so that a recycled fd number cannot be
+        // removed from the epoll set by mistake.
+        (void)poller.removePeer(s);
         (void)ncclSocketClose(sock);
 
         if (op != nullptr) {
           asyncProxyOpDequeue(peer, op);
           asyncOpCount--;
         }
-        pollfds[s].fd = -1;
-        npeers--;
       }
     }
   }
@@ -1816,6 +1713,8 @@ ncclResult_t ncclProxyInit(struct ncclComm* comm, struct ncclSocket* sock, union
   comm->proxyState = comm->sharedRes->proxyState;
   comm->proxyState->refCount = 1;
   comm->proxyState->listenSock = sock;
+  comm->proxyState->serviceWakeupFd = -1;
+  comm->proxyState->expectedResponses = new ncclx::proxy::ExpectedResponseMap();
   comm->proxyState->peerAddresses = peerAddresses;
   comm->proxyState->peerAddressesUDS = peerAddressesUDS;
   NCCLCHECK(ncclx::colltrace::proxyTraceInit(comm->proxyState, comm));
@@ -1849,6 +1748,7 @@ ncclResult_t ncclProxyCreate(struct ncclComm* comm) {
     proxyState->directMode = comm->directMode;
     proxyState->commHash = comm->commHash;
     memcpy(proxyState->buffSizes, comm->buffSizes, sizeof(comm->buffSizes));
+    NCCLCHECK(ncclx::proxy::ProxyServicePoller::createWakeupFd(&proxyState->serviceWakeupFd));
 
     PTHREADCHECK(pthread_create(&comm->proxyState->thread, NULL, ncclProxyService, comm->proxyState), "pthread_create");
     ncclSetThreadName(comm->proxyState->thread, "NCCL Service %2d", comm->cudaDev);
@@ -1902,6 +1802,8 @@ ncclResult_t ncclProxyStop(struct ncclComm* comm) {
       }
       // Now we notify proxy service and UDS thread to exit.
       __atomic_store_n(&comm->proxyState->stop, 1, __ATOMIC_RELEASE);
+      // Do not wait for the idle timeout of the service thread, e.g. on abort.
+      ncclProxyServiceWakeup(sharedProxyState);
     }
   }
 
@@ -1922,7 +1824,8 @@ ncclResult_t ncclProxyDestroy(struct ncclComm* comm) {
     free(sharedProxyState->peerSocks);
     free(sharedProxyState->proxyOps);
     free(sharedProxyState->sharedDevMems);
-    expectedProxyResponseFree(sharedProxyState);
+    if (sharedProxyState->serviceWakeupFd >= 0) close(sharedProxyState->serviceWakeupFd);
+    delete sharedProxyState->expectedResponses;
     free(sharedProxyState);
   }
   return ncclSuccess;
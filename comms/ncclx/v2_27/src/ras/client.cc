@@ -28,7 +28,9 @@ static const char* hostName = "localhost";
 static const char* port = STR(NCCL_RAS_CLIENT_PORT);
 static int timeout = -1;
 static bool verbose = false;
+static bool binary = false;
 static int sock = -1;
+static long serverProtocol = -1;
 
 static void printUsage(const char* argv0) {
   fprintf(stderr,
@@ -43,6 +45,8 @@ static void printUsage(const char* argv0) {
           "                      responses from other NCCL processes\n"
           "                      (" STR(RAS_COLLECTIVE_LEG_TIMEOUT_SEC) " secs by default; 0 disables the timeout)\n"
           "  -v, --verbose       Increase the verbosity level of the RAS output\n"
+          "  -b, --binary        Write the raw binary status dump to stdout instead of\n"
+          "                      the text report (for consumption by monitoring tools)\n"
           "      --help          Print this help and exit\n"
           "      --version       Print the version number and exit\n", argv0);
 }
@@ -55,12 +59,13 @@ static void parseArgs(int argc, char** argv) {
     {"port",    required_argument, NULL, 'p'},
     {"timeout", required_argument, NULL, 't'},
     {"verbose", no_argument,       NULL, 'v'},
+    {"binary",  no_argument,       NULL, 'b'},
     {"help",    no_argument,       NULL, 'e'},
     {"version", no_argument,       NULL, 'r'},
     {0}
   };
 
-  while ((c = getopt_long(argc, argv, "h:p:t:v", longOpts, &optIdx)) != -1) {
+  while ((c = getopt_long(argc, argv, "h:p:t:vb", longOpts, &optIdx)) != -1) {
     switch (c) {
       case 'h':
         hostName = optarg;
@@ -80,6 +85,9 @@ static void parseArgs(int argc, char** argv) {
       case 'v':
         verbose = true;
         break;
+      case 'b':
+        binary = true;
+        break;
       case 'e':
         printUsage(argv[0]);
         exit(0);
@@ -212,7 +220,8 @@ retry:
     fprintf(stderr, "Unexpected response from NCCL: %s\n", msgBuf);
     goto fail;
   }
-  if (strtol(msgBuf+strlen("SERVER PROTOCOL "), nullptr, 10) != NCCL_RAS_CLIENT_PROTOCOL) {
+  serverProtocol = strtol(msgBuf+strlen("SERVER PROTOCOL "), nullptr, 10);
+  if (serverProtocol != NCCL_RAS_CLIENT_PROTOCOL) {
     fprintf(stderr, "NCCL RAS protocol version mismatch (NCCL: %s; RAS client: %d)!\n"
             "Will try to continue in spite of that...\n", msgBuf+strlen("SERVER PROTOCOL "), NCCL_RAS_CLIENT_PROTOCOL);
   }
@@ -268,7 +277,16 @@ timeout:
 int getNCCLStatus() {
   char msgBuf[4096];
   int bytes;
-  snprintf(msgBuf, sizeof(msgBuf), "%sSTATUS\n", (verbose ? "VERBOSE " : ""));
+  if (binary) {
+    if (serverProtocol < NCCL_RAS_CLIENT_PROTOCOL_DUMP) {
+      fprintf(stderr, "The NCCL job does not support binary status dumps (RAS protocol %ld < %d)!\n",
+              serverProtocol, NCCL_RAS_CLIENT_PROTOCOL_DUMP);
+      return 1;
+    }
+    strcpy(msgBuf, "DUMP\n");
+  } else {
+    snprintf(msgBuf, sizeof(msgBuf), "%sSTATUS\n", (verbose ? "VERBOSE " : ""));
+  }
   if (socketWrite(sock, msgBuf, strlen(msgBuf)) != strlen(msgBuf)) {
     if (errno == EAGAIN || errno == EWOULDBLOCK)
       fprintf(stderr, "Connection timed out\n");
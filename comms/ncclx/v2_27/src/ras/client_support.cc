@@ -96,17 +96,23 @@ struct rasClient* rasClientsTail;
 // Minimum byte count to increment the output buffer size by if it's too small.
 #define RAS_OUT_INCREMENT 4096
 
-// Internal buffer for storing the formatted results.
-static char* rasOutBuffer = nullptr;
-static int nRasOutBuffer = 0; // Does _not_ include the terminating '\0' (which _is_ present in the buffer).
-static int rasOutBufferSize = 0;
+// Internal buffer for storing the formatted results.  Thread-local so that rasReportRender can be invoked from outside
+// of the RAS thread.
+static thread_local char* rasOutBuffer = nullptr;
+// nRasOutBuffer does _not_ include the terminating '\0' (which _is_ present in the buffer).
+static thread_local int nRasOutBuffer = 0;
+static thread_local int rasOutBufferSize = 0;
+
+// Size of the messages that the binary dump records are packed into.  This only bounds the size of each message:
+// the whole dump is enqueued before the client starts reading it (see rasClientDumpAppend).
+#define RAS_DUMP_MSG_SIZE (64*1024)
 
 // We use them all over the place; no point in wasting the stack...
-static char lineBuf[1024]; // Temporary buffer used for printing at most 10 (RAS_CLIENT_DETAIL_THRESHOLD) rank numbers
-                           // or for printing the local GPU devices, which can't be more than 64
-                           // small numbers (times two if the NVML mask is different than the CUDA mask).
-                           // Still, 1024 should normally be plenty (verbose output may make things more difficult,
-                           // but we do check for overflows, so it will just be trimmed).
+// Temporary buffer used for printing at most 10 (RAS_CLIENT_DETAIL_THRESHOLD) rank numbers or for printing the local
+// GPU devices, which can't be more than 64 small numbers (times two if the NVML mask is different than the CUDA mask).
+// Still, 1024 should normally be plenty (verbose output may make things more difficult, but we do check for overflows,
+// so it will just be trimmed).
+static thread_local char lineBuf[1024];
 
 
 static ncclResult_t getNewClientEntry(struct rasClient** pClient);
@@ -117,15 +123,26 @@ static ncclResult_t rasClientRun(struct rasClient* client);
 static ncclResult_t rasClientRunInit(struct rasClient* client);
 static ncclResult_t rasClientRunConns(struct rasClient* client);
 static ncclResult_t rasClientRunComms(struct rasClient* client);
-static void rasClientBreakDownErrors(struct rasClient* client, struct rasCollComms::comm* comm,
+static ncclResult_t rasClientOutFlush(struct rasClient* client);
+static ncclResult_t rasClientDumpAppend(void* arg, const void* record, int length);
+static ncclResult_t rasClientDumpFlush(struct rasClient* client);
+
+static void rasClientReportDataInit(struct rasReportData* data);
+static ncclResult_t rasReportFormatPeers(struct rasClient* client, const struct rasReportData* data, bool verbose);
+static ncclResult_t rasReportFormatComms(struct rasClient* client, struct rasReportData* data, bool verbose);
+static void rasClientBreakDownErrors(const struct rasReportData* data, bool verbose, struct rasCollComms::comm* comm,
                                      const int* peerIdxConv, int ncclErrors[ncclNumResults], bool isAsync = false);
+static int rasReportPeerFind(const struct rasReportData* data, const union ncclSocketAddress* addr);
+static bool rasReportPeerIsDead(const struct rasReportData* data, const union ncclSocketAddress* addr);
 
 static void rasOutAppend(const char* format, ...) __attribute__ ((format(printf, 1, 2)));
 static void rasOutExtract(char* buffer);
 static int rasOutLength();
 static void rasOutReset();
+static void rasOutFree();
 
 static int rasAuxPeersValueCompare(const void* e1, const void* e2);
+static int rasAddrPeerInfoCompare(const void* k, const void* e);
 static int ncclSocketsHostCompare(const void* p1, const void* p2);
 static int rasValCountsCompareRev(const void* p1, const void* p2);
 static int rasAuxCommsCompareRev(const void* p1, const void* p2);
@@ -257,6 +274,8 @@ static void rasClientTerminate(struct rasClient* client) {
   while (struct rasMsgMeta* meta = ncclIntruQueueTryDequeue(&client->sendQ)) {
     free(meta);
   }
+  if (client->dumpMsg)
+    rasClientFreeMsg(client->dumpMsg);
 
   if (client == rasClientsHead)
     rasClientsHead = rasClientsHead->next;
@@ -369,6 +388,10 @@ void rasClientEventLoop(struct rasClient* client, int pollIdx) {
         client->status = RAS_CLIENT_INIT;
         client->verbose = 1;
         (void)rasClientRun(client);
+      } else if (strcasecmp(cmd, "dump") == 0) {
+        client->status = RAS_CLIENT_INIT;
+        client->dump = true;
+        (void)rasClientRun(client);
       } else {
         snprintf(rasLine, sizeof(rasLine), "ERROR: Unknown command %s\n", cmd);
         msgLen = strlen(rasLine);
@@ -481,34 +504,73 @@ exit:
 }
 
 // Sends to the client the initial data that can be obtained locally -- version info, stats on rasPeers,
-// dump of rasDeadPeers.  Initiates the RAS_COLL_CONNS collective operation.
+// dump of rasDeadPeers.  Initiates the RAS_COLL_COMMS collective operation.
 static ncclResult_t rasClientRunInit(struct rasClient* client) {
   ncclResult_t ret = ncclSuccess;
-  char* msg = nullptr;
-  int msgLen;
+  struct rasReportData data;
+
+  TRACE(NCCL_RAS, "RAS: rasClientRunInit: starting");
+
+  rasClientReportDataInit(&data);
+  if (client->dump) {
+    NCCLCHECKGOTO(rasDumpWritePeers(&data, rasClientDumpAppend, client), ret, fail);
+    NCCLCHECKGOTO(rasClientDumpFlush(client), ret, fail);
+  } else {
+    rasOutReset();
+    NCCLCHECKGOTO(rasReportFormatPeers(client, &data, client->verbose), ret, fail);
+  }
+
+#if 0 // Commented out for now to focus the summary status report on the information most relevant to the users.
+      // To be revisited with future extensions to RAS.
+  rasOutAppend("\nGathering data about the RAS network (timeout %lds)...", client->timeout / CLOCK_UNITS_PER_SEC);
+  NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
+  {
+    struct rasCollRequest collReq = {};
+    bool allDone = false;
+    rasCollReqInit(&collReq);
+    collReq.timeout = client->timeout;
+    collReq.type = RAS_COLL_CONNS;
+    NCCLCHECKGOTO(rasNetSendCollReq(&collReq, &allDone, &client->coll), ret, fail);
+    if (!allDone)
+      ret = ncclInProgress; // We need to wait for async. responses.
+  }
+#endif
+  if (!client->dump) {
+    rasOutAppend("\nCommunicators...");
+    NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
+  }
+  {
+    struct rasCollRequest collReq = {};
+    bool allDone = false;
+    rasCollReqInit(&collReq);
+    collReq.timeout = client->timeout;
+    collReq.type = RAS_COLL_COMMS;
+    NCCLCHECKGOTO(rasNetSendCollReq(&collReq, &allDone, &client->coll), ret, fail);
+    if (!allDone)
+      ret = ncclInProgress;
+  }
+  TRACE(NCCL_RAS, "RAS: rasClientRunInit: scheduling RAS_COLL_COMMS and finishing");
+exit:
+  return ret;
+fail:
+  goto exit;
+}
+
+// Formats the data that can be obtained locally -- version info and stats on the peers -- and sends it to the client.
+// Without a client, the text is left in the output buffer.
+static ncclResult_t rasReportFormatPeers(struct rasClient* client, const struct rasReportData* data, bool verbose) {
+  ncclResult_t ret = ncclSuccess;
   struct rasAuxPeerInfo* auxRasPeers = nullptr;
   int totalGpus, totalNodes, firstNGpusNode, firstNGpusGlobal, firstNPeersGlobal;
   bool consistentNGpusNode, consistentNGpusGlobal, consistentNPeersGlobal;
   int firstIdx, nPeers;
   struct rasValCount valCounts[NCCL_MAX_LOCAL_RANKS];
   int nValCounts;
-  static int cudaDriver = -1, cudaRuntime = -1;
-
-  TRACE(NCCL_RAS, "RAS: rasClientRunInit: starting");
 
-  rasOutReset();
-  rasOutAppend("NCCL version " STR(NCCL_MAJOR) "." STR(NCCL_MINOR) "." STR(NCCL_PATCH) NCCL_SUFFIX
-               " compiled with CUDA " STR(CUDA_MAJOR) "." STR(CUDA_MINOR) "\n");
-  if (cudaRuntime == -1)
-    cudaRuntimeGetVersion(&cudaRuntime);
-  if (cudaDriver == -1)
-    cudaDriverGetVersion(&cudaDriver);
-  rasOutAppend("CUDA runtime version %d, driver version %d\n\n", cudaRuntime, cudaDriver);
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
+  rasOutAppend("NCCL version %d.%d.%d%s compiled with CUDA %d.%d\n", data->ncclMajor, data->ncclMinor, data->ncclPatch,
+               data->ncclSuffix, data->cudaMajor, data->cudaMinor);
+  rasOutAppend("CUDA runtime version %d, driver version %d\n\n", data->cudaRuntime, data->cudaDriver);
+  NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
 
   totalGpus = totalNodes = 0;
   firstNGpusNode = 0; // #GPUs on the first peer of a node.
@@ -518,8 +580,8 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
   consistentNPeersGlobal = true; // Whether #peers/node is consistent between all nodes.
   nPeers = 0; // #peers on a node.
   firstNPeersGlobal = 0; // #peers on the first node.
-  for (int peerIdx = 0; peerIdx < nRasPeers; peerIdx++) {
-    int nGpus = __builtin_popcountll(rasPeers[peerIdx].cudaDevs);
+  for (int peerIdx = 0; peerIdx < data->nPeers; peerIdx++) {
+    int nGpus = __builtin_popcountll(data->peers[peerIdx].cudaDevs);
     totalGpus += nGpus;
     if (peerIdx == 0) {
       totalNodes = 1;
@@ -528,7 +590,7 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
     } else { // peerIdx > 0
       if (nGpus != firstNGpusGlobal)
         consistentNGpusGlobal = false;
-      if (!ncclSocketsSameNode(&rasPeers[peerIdx].addr, &rasPeers[peerIdx-1].addr)) {
+      if (!ncclSocketsSameNode(&data->peers[peerIdx].addr, &data->peers[peerIdx-1].addr)) {
         totalNodes++;
         if (firstNPeersGlobal == 0)
           firstNPeersGlobal = nPeers;
@@ -542,7 +604,7 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
         nPeers++;
       } // Same node
     } // peerIdx > 0
-    if (peerIdx == nRasPeers-1) {
+    if (peerIdx == data->nPeers-1) {
       if (firstNPeersGlobal == 0)
         firstNPeersGlobal = nPeers;
       else if (nPeers != firstNPeersGlobal)
@@ -550,7 +612,7 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
     }
   } // for (peerIdx)
 
-  TRACE(NCCL_RAS, "RAS: totalNodes %d, nRasPeers %d, totalGpus %d", totalNodes, nRasPeers, totalGpus);
+  TRACE(NCCL_RAS, "RAS: totalNodes %d, nPeers %d, totalGpus %d", totalNodes, data->nPeers, totalGpus);
   TRACE(NCCL_RAS, "RAS: consistentNPeersGlobal %d, consistentNGpusGlobal %d, consistentNGpusNode %d",
         consistentNPeersGlobal, consistentNGpusGlobal, consistentNGpusNode);
   TRACE(NCCL_RAS, "RAS: firstNPeersGlobal %d, firstNGpusGlobal %d", firstNPeersGlobal, firstNGpusGlobal);
@@ -562,17 +624,17 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
     rasOutAppend("  Nodes  Processes         GPUs  Processes     GPUs\n"
                  "(total)   per node  per process    (total)  (total)\n"
                  "%7d"  "  %9d"    "  %11d"     "  %9d"    "  %7d\n",
-                 totalNodes, firstNPeersGlobal, firstNGpusGlobal, nRasPeers, totalGpus);
+                 totalNodes, firstNPeersGlobal, firstNGpusGlobal, data->nPeers, totalGpus);
   } else {
     // Gather the stats on the number of processes per node.  However, that number is not a property of a peer,
     // but of a group of peers, so calculating it is more involved.  We store the value in a temporary auxRasPeers
     // array.
-    NCCLCHECKGOTO(ncclCalloc(&auxRasPeers, nRasPeers), ret, fail);
+    NCCLCHECKGOTO(ncclCalloc(&auxRasPeers, data->nPeers), ret, fail);
 
     firstIdx = 0;
     nPeers = 0;
-    for (int peerIdx = 0; peerIdx < nRasPeers; peerIdx++) {
-      auxRasPeers[peerIdx].peer = rasPeers+peerIdx;
+    for (int peerIdx = 0; peerIdx < data->nPeers; peerIdx++) {
+      auxRasPeers[peerIdx].peer = data->peers+peerIdx;
       if (peerIdx == 0) {
         nPeers = 1;
         firstIdx = 0;
@@ -590,11 +652,11 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
           nPeers++;
         }
       } // peerIdx > 0
-      if (peerIdx == nRasPeers-1) {
+      if (peerIdx == data->nPeers-1) {
         // Last iteration of the loop.
         TRACE(NCCL_RAS, "RAS: node %s: nPeers %d",
               ncclSocketToHost(&auxRasPeers[peerIdx].peer->addr, rasLine, sizeof(rasLine)), nPeers);
-        for (int i = firstIdx; i < nRasPeers; i++) {
+        for (int i = firstIdx; i < data->nPeers; i++) {
           auxRasPeers[i].value = nPeers;
         }
       }
@@ -602,11 +664,11 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
 
     // Re-sort it now using the number of processes on the node (value) as the primary key, host IP as the
     // secondary, and process id as the tertiary.
-    qsort(auxRasPeers, nRasPeers, sizeof(*auxRasPeers), rasAuxPeersValueCompare);
+    qsort(auxRasPeers, data->nPeers, sizeof(*auxRasPeers), rasAuxPeersValueCompare);
 
     // Calculate the distribution of different numbers of peers per node.
     nValCounts = 0;
-    for (int peerIdx = 0; peerIdx < nRasPeers;) {
+    for (int peerIdx = 0; peerIdx < data->nPeers;) {
       if (peerIdx == 0 || auxRasPeers[peerIdx].value != auxRasPeers[peerIdx-1].value) {
         valCounts[nValCounts].value = auxRasPeers[peerIdx].value;
         valCounts[nValCounts].count = 1;
@@ -646,18 +708,18 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
 
       // Sort peers by the GPU count, to simplify data extraction.  Not sure how fast __builtin_popcountll is so we
       // may just as well cache it...
-      for (int peerIdx = 0; peerIdx < nRasPeers; peerIdx++) {
+      for (int peerIdx = 0; peerIdx < data->nPeers; peerIdx++) {
         auxRasPeers[peerIdx].value = __builtin_popcountll(auxRasPeers[peerIdx].peer->cudaDevs);
         TRACE(NCCL_RAS, "RAS: node %s pid %d: nGpus %d",
               ncclSocketToHost(&auxRasPeers[peerIdx].peer->addr, rasLine, sizeof(rasLine)),
               auxRasPeers[peerIdx].peer->pid, auxRasPeers[peerIdx].value);
       }
       // GPU count is the primary key, host IP is the secondary, and process id is the tertiary.
-      qsort(auxRasPeers, nRasPeers, sizeof(*auxRasPeers), rasAuxPeersValueCompare);
+      qsort(auxRasPeers, data->nPeers, sizeof(*auxRasPeers), rasAuxPeersValueCompare);
 
       // Calculate the distribution of different numbers of GPUs per peer.
       nValCounts = 0;
-      for (int peerIdx = 0; peerIdx < nRasPeers; peerIdx++) {
+      for (int peerIdx = 0; peerIdx < data->nPeers; peerIdx++) {
         if (peerIdx == 0 || auxRasPeers[peerIdx].value != auxRasPeers[peerIdx-1].value) {
           valCounts[nValCounts].value = auxRasPeers[peerIdx].value;
           valCounts[nValCounts].count = 1;
@@ -685,7 +747,7 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
                  "  Nodes  Processes         GPUs\n"
                  "(total)    (total)      (total)\n"
                  "%7d"  "  %9d"    "  %11d\n",
-                 totalNodes, nRasPeers, totalGpus);
+                 totalNodes, data->nPeers, totalGpus);
 
     if (consistentNGpusNode && consistentNGpusGlobal) {
       // In this simpler case, also print the node outliers.
@@ -693,7 +755,7 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
         struct rasValCount* vc = valCounts+i;
         // We assume that the most frequent group is correct; for the remaining ones, we try to provide more info,
         // provided that they meet our definition of an outlier.
-        if (rasCountIsOutlier(vc->count, client->verbose, totalNodes)) {
+        if (rasCountIsOutlier(vc->count, verbose, totalNodes)) {
           rasOutAppend("\nThe outlier node%s:\n", (vc->count > 1 ? "s" : ""));
           // auxRasPeers is sorted by the node IP address (not port!) as the secondary key and the pid as
           // the tertiary, which comes in handy when printing...
@@ -711,43 +773,6 @@ static ncclResult_t rasClientRunInit(struct rasClient* client) {
       } // for (i)
     } // !consistentNPeersGlobal
   } // !consistentNGpusNode || !consistentNGpusGlobal || !consistentNPeersGlobal
-
-#if 0 // Commented out for now to focus the summary status report on the information most relevant to the users.
-      // To be revisited with future extensions to RAS.
-  rasOutAppend("\nGathering data about the RAS network (timeout %lds)...", client->timeout / CLOCK_UNITS_PER_SEC);
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
-  {
-    struct rasCollRequest collReq = {};
-    bool allDone = false;
-    rasCollReqInit(&collReq);
-    collReq.timeout = client->timeout;
-    collReq.type = RAS_COLL_CONNS;
-    NCCLCHECKGOTO(rasNetSendCollReq(&collReq, &allDone, &client->coll), ret, fail);
-    if (!allDone)
-      ret = ncclInProgress; // We need to wait for async. responses.
-  }
-#endif
-  rasOutAppend("\nCommunicators...");
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
-  {
-    struct rasCollRequest collReq = {};
-    bool allDone = false;
-    rasCollReqInit(&collReq);
-    collReq.timeout = client->timeout;
-    collReq.type = RAS_COLL_COMMS;
-    NCCLCHECKGOTO(rasNetSendCollReq(&collReq, &allDone, &client->coll), ret, fail);
-    if (!allDone)
-      ret = ncclInProgress;
-  }
-  TRACE(NCCL_RAS, "RAS: rasClientRunInit: scheduling RAS_COLL_COMMS and finishing");
 exit:
   free(auxRasPeers);
   return ret;
@@ -884,15 +909,133 @@ fail:
 }
 #endif
 
-// Processes the response from the RAS_COLL_COMMS collective operation and sends the data to the client:
-// statistics on the communicators, missing data from ranks, inconsistent collective operation counts,
-// initialization and asynchronous errors, and inconsistent initialization/termination status.
+// Processes the response from the RAS_COLL_COMMS collective operation and sends the data to the client, either as
+// the text report or as binary dump records.
 static ncclResult_t rasClientRunComms(struct rasClient* client) {
   ncclResult_t ret = ncclSuccess;
-  char* msg = nullptr;
-  int msgLen;
   struct rasCollective* coll = client->coll;
-  struct rasCollComms* commsData = (struct rasCollComms*)coll->data;
+  struct rasReportData data;
+
+  TRACE(NCCL_RAS, "RAS: rasClientRunComms: starting");
+
+  if (coll == nullptr || coll->nFwdSent != coll->nFwdRecv) {
+    INFO(NCCL_RAS, "RAS invalid collective operation status; client status %d -- internal error?", client->status);
+    return ncclInternalError;
+  }
+  client->coll = nullptr;
+  TRACE(NCCL_RAS, "RAS: coll nLegTimeouts %d, nPeers %d, nData %d", coll->nLegTimeouts, coll->nPeers, coll->nData);
+
+  rasClientReportDataInit(&data);
+  data.elapsed = clockNano()-coll->startTime;
+  data.nLegTimeouts = coll->nLegTimeouts;
+  data.collPeers = coll->peers;
+  data.nCollPeers = coll->nPeers;
+  data.comms = (struct rasCollComms*)coll->data;
+
+  if (client->dump) {
+    NCCLCHECKGOTO(rasDumpWriteComms(&data, rasClientDumpAppend, client), ret, fail);
+    NCCLCHECKGOTO(rasClientDumpFlush(client), ret, fail);
+  } else {
+    rasOutReset();
+    NCCLCHECKGOTO(rasReportFormatComms(client, &data, client->verbose), ret, fail);
+  }
+
+  TRACE(NCCL_RAS, "RAS: rasClientRunComms: finishing");
+exit:
+  rasCollFree(coll);
+  return ret;
+fail:
+  goto exit;
+}
+
+// Sends the contents of the output buffer to the client.  Without a client, it's a no-op (the text is left in the
+// buffer).
+static ncclResult_t rasClientOutFlush(struct rasClient* client) {
+  char* msg;
+  int msgLen;
+
+  if (client == nullptr)
+    return ncclSuccess;
+  msgLen = rasOutLength();
+  NCCLCHECK(rasClientAllocMsg(&msg, msgLen));
+  rasOutExtract(msg);
+  rasClientEnqueueMsg(client, msg, msgLen);
+  return ncclSuccess;
+}
+
+// rasDumpAppendFn callback that packs the binary dump records into messages of up to RAS_DUMP_MSG_SIZE bytes,
+// enqueuing each one for sending once it's full.  The dump is written in one go on the RAS thread, while the messages
+// only go out from the main loop afterwards, so the send queue ends up holding the whole dump, just like the STATUS
+// text; there is no throttling on how much of it is queued.
+static ncclResult_t rasClientDumpAppend(void* arg, const void* record, int length) {
+  struct rasClient* client = (struct rasClient*)arg;
+
+  if (client->dumpMsg && client->nDumpMsg + length > RAS_DUMP_MSG_SIZE)
+    NCCLCHECK(rasClientDumpFlush(client));
+  if (client->dumpMsg == nullptr) {
+    NCCLCHECK(rasClientAllocMsg(&client->dumpMsg, (length > RAS_DUMP_MSG_SIZE ? length : RAS_DUMP_MSG_SIZE)));
+    client->nDumpMsg = 0;
+  }
+  memcpy(client->dumpMsg+client->nDumpMsg, record, length);
+  client->nDumpMsg += length;
+  return ncclSuccess;
+}
+
+// Enqueues the partially filled dump message (if any) for sending to the client.
+static ncclResult_t rasClientDumpFlush(struct rasClient* client) {
+  if (client->dumpMsg) {
+    rasClientEnqueueMsg(client, client->dumpMsg, client->nDumpMsg);
+    client->dumpMsg = nullptr;
+    client->nDumpMsg = 0;
+  }
+  return ncclSuccess;
+}
+
+// Initializes the report data with the locally available information: the versions and the RAS peers.
+static void rasClientReportDataInit(struct rasReportData* data) {
+  static int cudaDriver = -1, cudaRuntime = -1;
+
+  if (cudaRuntime == -1)
+    cudaRuntimeGetVersion(&cudaRuntime);
+  if (cudaDriver == -1)
+    cudaDriverGetVersion(&cudaDriver);
+
+  memset(data, '\0', sizeof(*data));
+  data->ncclMajor = NCCL_MAJOR;
+  data->ncclMinor = NCCL_MINOR;
+  data->ncclPatch = NCCL_PATCH;
+  data->ncclSuffix = NCCL_SUFFIX;
+  data->cudaMajor = CUDA_MAJOR;
+  data->cudaMinor = CUDA_MINOR;
+  data->cudaRuntime = cudaRuntime;
+  data->cudaDriver = cudaDriver;
+  data->peers = rasPeers;
+  data->nPeers = nRasPeers;
+  data->deadPeers = rasDeadPeers;
+  data->nDeadPeers = nRasDeadPeers;
+}
+
+// Looks up a peer by its address in the report data.  Returns the index of the peer or -1 if not found.
+// Equivalent of rasPeerFind, but works on the provided data rather than on the global rasPeers.
+static int rasReportPeerFind(const struct rasReportData* data, const union ncclSocketAddress* addr) {
+  struct rasPeerInfo* peer = (struct rasPeerInfo*)bsearch(addr, data->peers, data->nPeers, sizeof(*data->peers),
+                                                          rasAddrPeerInfoCompare);
+  return (peer ? peer-data->peers : -1);
+}
+
+// Checks if a peer is on the list of dead peers in the report data.
+static bool rasReportPeerIsDead(const struct rasReportData* data, const union ncclSocketAddress* addr) {
+  return (data->deadPeers != nullptr &&
+          bsearch(addr, data->deadPeers, data->nDeadPeers, sizeof(*data->deadPeers), ncclSocketsCompare) != nullptr);
+}
+
+// Formats the results of the RAS_COLL_COMMS collective operation and sends them to the client: statistics on the
+// communicators, missing data from ranks, inconsistent collective operation counts, initialization and asynchronous
+// errors, and inconsistent initialization/termination status.  Without a client, the text is left in the output
+// buffer.
+static ncclResult_t rasReportFormatComms(struct rasClient* client, struct rasReportData* data, bool verbose) {
+  ncclResult_t ret = ncclSuccess;
+  struct rasCollComms* commsData = data->comms;
   struct rasCollComms::comm* comm;
   struct rasAuxCommRank* auxCommRanks = nullptr;
   struct rasValCount* valCounts = nullptr;
@@ -917,22 +1060,14 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
     "INCOMPLETE,ERROR,MISMATCH"
   };
 
-  TRACE(NCCL_RAS, "RAS: rasClientRunComms: starting");
-  TRACE(NCCL_RAS, "RAS: coll nLegTimeouts %d, nPeers %d, nData %d; commsData nComms %d",
-        coll->nLegTimeouts, coll->nPeers, coll->nData, commsData->nComms);
+  TRACE(NCCL_RAS, "RAS: rasReportFormatComms: nLegTimeouts %d, nCollPeers %d, nComms %d",
+        data->nLegTimeouts, data->nCollPeers, commsData->nComms);
 
-  if (coll == nullptr || coll->nFwdSent != coll->nFwdRecv) {
-    INFO(NCCL_RAS, "RAS invalid collective operation status; client status %d -- internal error?", client->status);
-    return ncclInternalError;
-  }
-  client->coll = nullptr;
-
-  rasOutReset();
-  rasOutAppend(" (%.2fs)\n=============\n\n", (clockNano()-coll->startTime)/1e9);
+  rasOutAppend(" (%.2fs)\n=============\n\n", data->elapsed/1e9);
 
   // Calculate the number of missing peers early as we rely on it for other things.
-  nPeersMissing = nRasPeers - nRasDeadPeers - coll->nPeers;
-  TRACE(NCCL_RAS, "RAS: nRasPeers %d, nRasDeadPeers %d, nPeersMissing %d", nRasPeers, nRasDeadPeers, nPeersMissing);
+  nPeersMissing = data->nPeers - data->nDeadPeers - data->nCollPeers;
+  TRACE(NCCL_RAS, "RAS: nPeers %d, nDeadPeers %d, nPeersMissing %d", data->nPeers, data->nDeadPeers, nPeersMissing);
 
   // Sort the communicators by size.  As the structure is inconvenient to move around due to the elements being
   // of variable length, we create an auxiliary array that includes pointers to individual elements and simply sort
@@ -946,19 +1081,20 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
     if (maxCommSize < comm->commNRanks)
       maxCommSize = comm->commNRanks;
     auxComms[commIdx].comm = comm;
-    comm = (struct rasCollComms::comm*)(((char*)(comm+1)) + comm->nRanks * sizeof(*comm->ranks));
+    comm = (struct rasCollComms::comm*)(((char*)(comm+1)) + comm->nRanks * sizeof(*comm->ranks) +
+                                        comm->nMissingRanks * sizeof(struct rasCollCommsMissingRank));
   }
   NCCLCHECKGOTO(ncclCalloc(&auxCommRanks, maxCommSize), ret, fail);
   TRACE(NCCL_RAS, "RAS: maxCommSize %d", maxCommSize);
 
   // For convenience, create a translation table from rasCollective's peerIdx to rasPeers peerIdx.
-  NCCLCHECKGOTO(ncclCalloc(&peerIdxConv, coll->nPeers), ret, fail);
-  for (int peerIdx = 0; peerIdx < coll->nPeers; peerIdx++) {
-    peerIdxConv[peerIdx] = rasPeerFind(coll->peers+peerIdx);
+  NCCLCHECKGOTO(ncclCalloc(&peerIdxConv, data->nCollPeers), ret, fail);
+  for (int peerIdx = 0; peerIdx < data->nCollPeers; peerIdx++) {
+    peerIdxConv[peerIdx] = rasReportPeerFind(data, data->collPeers+peerIdx);
     TRACE(NCCL_RAS, "RAS: coll peers[%d] -> rasPeers[%d]", peerIdx, peerIdxConv[peerIdx]);
   }
   // Sort coll->peers to match the ordering of rasPeers -- we may need it later...
-  qsort(coll->peers, coll->nPeers, sizeof(*coll->peers), &ncclSocketsCompare);
+  qsort(data->collPeers, data->nCollPeers, sizeof(*data->collPeers), &ncclSocketsCompare);
 
   // Fill in the remaining fields of auxComm's.
   for (int commIdx = 0; commIdx < commsData->nComms; commIdx++) {
@@ -973,7 +1109,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
       // There are two possibilities here.  Either we are missing the data on some ranks because the processes are
       // unreachable, or the processes _are_ reachable but didn't report to be part of this communicator (which
       // could definitely happen if some processes have already called ncclCommDestroy or ncclCommAbort).
-      if (nPeersMissing == 0 && nRasDeadPeers == 0) {
+      if (nPeersMissing == 0 && data->nDeadPeers == 0) {
         // We received data from _all_ processes.  That's an easy case.
         auxComm->errors |= RAS_ACE_MISMATCH;
         auxComm->status |= RAS_ACS_NOCOMM;
@@ -986,7 +1122,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
         for (int rankIdx = 0; rankIdx < comm->nMissingRanks; rankIdx++) {
           struct rasCollCommsMissingRank* missingRank = missingRanks + rankIdx;
           void* found;
-          if ((found = bsearch(&missingRank->addr, coll->peers, coll->nPeers, sizeof(*coll->peers),
+          if ((found = bsearch(&missingRank->addr, data->collPeers, data->nCollPeers, sizeof(*data->collPeers),
                                ncclSocketsCompare)) != nullptr) {
             // We did receive the data from that process, but not about this communicator.
             auxComm->errors |= RAS_ACE_MISMATCH;
@@ -997,8 +1133,8 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
             auxComm->nIncompleteRanks++;
           }
           TRACE(NCCL_RAS, "RAS: comm missingRank[%d] commRank %d, addr %td (-> %d), cudaDev %d, nvmlDev %d",
-                rankIdx, missingRank->commRank, (found ? ((union ncclSocketAddress*)found) - coll->peers: -1),
-                rasPeerFind(&missingRank->addr), missingRank->cudaDev, missingRank->nvmlDev);
+                rankIdx, missingRank->commRank, (found ? ((union ncclSocketAddress*)found) - data->collPeers: -1),
+                rasReportPeerFind(data, &missingRank->addr), missingRank->cudaDev, missingRank->nvmlDev);
         } // for (rankIdx)
       } // nPeersMissing > 0 || nRasDeadPeers > 0
     } // if (comm->nMissingRanks > 0)
@@ -1033,7 +1169,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
       } else { // rankIdx > 0
         if (auxRank->value != auxRank[-1].value) {
           auxComm->nPeers++;
-          if (!ncclSocketsSameNode(&rasPeers[auxRank->value].addr, &rasPeers[auxRank[-1].value].addr)) {
+          if (!ncclSocketsSameNode(&data->peers[auxRank->value].addr, &data->peers[auxRank[-1].value].addr)) {
             auxComm->nNodes++;
             if (auxComm->ranksPerNodeMin > nRanks)
               auxComm->ranksPerNodeMin = nRanks;
@@ -1119,7 +1255,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
   }
 
   // Allocate an auxiliary structure used for counting the number of ranks (unique GPUs) in a group.
-  NCCLCHECKGOTO(ncclCalloc(&peerNvmlDevs, coll->nPeers), ret, fail);
+  NCCLCHECKGOTO(ncclCalloc(&peerNvmlDevs, data->nCollPeers), ret, fail);
 
   // Print it out, the largest communicators first.
   for (int vcIdx = 0; vcIdx < nValCounts; vcIdx++) {
@@ -1130,7 +1266,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
 
     ranksPerNodeMin = NCCL_MAX_LOCAL_RANKS;
     ranksPerNodeMax = 0;
-    memset(peerNvmlDevs, '\0', coll->nPeers * sizeof(*peerNvmlDevs));
+    memset(peerNvmlDevs, '\0', data->nCollPeers * sizeof(*peerNvmlDevs));
     // We don't group comms by ranksPerNodeMin/Max, so the values may differ between comms in one group.
     // Calculate the group's min/max.
     // Also calculate the number of unique ranks in the group.
@@ -1145,7 +1281,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
       }
     }
     ranksTotal = 0;
-    for (int peerIdx = 0; peerIdx < coll->nPeers; peerIdx++)
+    for (int peerIdx = 0; peerIdx < data->nCollPeers; peerIdx++)
       ranksTotal += __builtin_popcountll(peerNvmlDevs[peerIdx]);
     if (ranksPerNodeMin == ranksPerNodeMax)
       snprintf(rasLine, sizeof(rasLine), "%d", ranksPerNodeMin);
@@ -1157,11 +1293,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                  // status (which is a bitmask) into an array index.
                  statusStr[(sizeof(unsigned int)*8-1)-__builtin_clz(auxComm->status)], errorStr[auxComm->errors]);
   }
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
+  NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
 
   rasOutAppend("\nErrors\n"
                "======\n\n");
@@ -1169,7 +1301,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
   if (nPeersMissing > 0) {
     rasOutAppend("INCOMPLETE\n"
                  "  Missing communicator data from %d job process%s\n", nPeersMissing, (nPeersMissing > 1 ? "es" : ""));
-    if (rasCountIsOutlier(nPeersMissing, client->verbose)) {
+    if (rasCountIsOutlier(nPeersMissing, verbose)) {
       // Extract a list of missing peers.  We don't want to print it right away because it would be sorted
       // by address (including port, which isn't meaningful to end users).
       struct rasAuxPeerInfo* auxPeersBuf = nullptr;
@@ -1179,12 +1311,12 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
       // them much easier.
       NCCLCHECKGOTO(ncclCalloc(&auxPeersBuf, nPeersMissing), ret, fail);
       nPeersBuf = 0;
-      for (int rasPeerIdx = 0, collPeerIdx = 0; rasPeerIdx < nRasPeers || collPeerIdx < coll->nPeers;) {
+      for (int rasPeerIdx = 0, collPeerIdx = 0; rasPeerIdx < data->nPeers || collPeerIdx < data->nCollPeers;) {
         int cmp;
-        if (rasPeerIdx < nRasPeers && collPeerIdx < coll->nPeers)
-          cmp = ncclSocketsCompare(&rasPeers[rasPeerIdx].addr, coll->peers+collPeerIdx);
+        if (rasPeerIdx < data->nPeers && collPeerIdx < data->nCollPeers)
+          cmp = ncclSocketsCompare(&data->peers[rasPeerIdx].addr, data->collPeers+collPeerIdx);
         else
-          cmp = (rasPeerIdx < nRasPeers ? -1 : 1);
+          cmp = (rasPeerIdx < data->nPeers ? -1 : 1);
 
         if (cmp == 0) {
           rasPeerIdx++;
@@ -1193,22 +1325,22 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
           // Process missing from coll->peers.  Don't report dead ones though, as they are not included
           // in nPeersMissing and are reported separately below.
           bool dead;
-          if (!(dead = rasPeerIsDead(&rasPeers[rasPeerIdx].addr))) {
+          if (!(dead = rasReportPeerIsDead(data, &data->peers[rasPeerIdx].addr))) {
             if (nPeersBuf < nPeersMissing) {
-              auxPeersBuf[nPeersBuf++].peer = rasPeers+rasPeerIdx;
+              auxPeersBuf[nPeersBuf++].peer = data->peers+rasPeerIdx;
             } else {
               INFO(NCCL_RAS, "RAS overflow of auxPeersBuf: nPeersBuf %d, rasPeerIdx %d (%s), collPeerIdx %d -- "
                    "internal error?",
-                   nPeersBuf, rasPeerIdx, ncclSocketToString(&rasPeers[rasPeerIdx].addr, rasLine), collPeerIdx);
+                   nPeersBuf, rasPeerIdx, ncclSocketToString(&data->peers[rasPeerIdx].addr, rasLine), collPeerIdx);
             }
           }
           TRACE(NCCL_RAS, "RAS rasPeerIdx %d (%s) is missing from coll->peers; dead %d",
-                rasPeerIdx, ncclSocketToString(&rasPeers[rasPeerIdx].addr, rasLine), dead);
+                rasPeerIdx, ncclSocketToString(&data->peers[rasPeerIdx].addr, rasLine), dead);
           rasPeerIdx++;
         } else { // cmp > 0
           // Process not found in rasPeers -- shouldn't happen, unless during a race?
           INFO(NCCL_RAS, "RAS failed to find coll->peer[%d] (%s) in rasPeers -- internal error?",
-               collPeerIdx, ncclSocketToString(coll->peers+collPeerIdx, rasLine));
+               collPeerIdx, ncclSocketToString(data->collPeers+collPeerIdx, rasLine));
           collPeerIdx++;
         } // cmp > 0
       } // for (rasPeerIdx, collPeerIdx)
@@ -1232,19 +1364,19 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
     rasOutAppend("\n");
   }
 
-  if (nRasDeadPeers > 0) {
+  if (data->nDeadPeers > 0) {
     rasOutAppend("DEAD\n"
-                 "  %d job process%s considered dead (unreachable via the RAS network)\n", nRasDeadPeers,
-                 (nRasDeadPeers > 1 ? "es are" : " is"));
-    if (rasCountIsOutlier(nRasDeadPeers, client->verbose)) {
+                 "  %d job process%s considered dead (unreachable via the RAS network)\n", data->nDeadPeers,
+                 (data->nDeadPeers > 1 ? "es are" : " is"));
+    if (rasCountIsOutlier(data->nDeadPeers, verbose)) {
       // rasDeadPeers contains only addresses, whereas we want a complete rasPeerInfo, and sorted differently.
       struct rasAuxPeerInfo* auxPeersBuf = nullptr;
       int nPeersBuf = 0;
-      NCCLCHECKGOTO(ncclCalloc(&auxPeersBuf, nRasDeadPeers), ret, fail);
-      for (int i = 0; i < nRasDeadPeers; i++) {
-        int peerIdx = rasPeerFind(rasDeadPeers+i);
+      NCCLCHECKGOTO(ncclCalloc(&auxPeersBuf, data->nDeadPeers), ret, fail);
+      for (int i = 0; i < data->nDeadPeers; i++) {
+        int peerIdx = rasReportPeerFind(data, data->deadPeers+i);
         if (peerIdx != -1)
-          auxPeersBuf[nPeersBuf++].peer = rasPeers+peerIdx;
+          auxPeersBuf[nPeersBuf++].peer = data->peers+peerIdx;
       }
       // Sort the output by host and pid, not host and port.  rasAuxPeersValueCompare uses value as the primary key,
       // which is 0 for all auxPeersBuf elements here, so it will do.
@@ -1257,9 +1389,9 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                      rasGpuDevsToString(auxPeer->peer->cudaDevs, auxPeer->peer->nvmlDevs, lineBuf,
                                         sizeof(lineBuf)));
       }
-      if (nPeersBuf != nRasDeadPeers)
+      if (nPeersBuf != data->nDeadPeers)
         rasOutAppend("  [could not find information on %d process%s]\n",
-                     nRasDeadPeers-nPeersBuf, (nRasDeadPeers-nPeersBuf > 1 ? "es" : ""));
+                     data->nDeadPeers-nPeersBuf, (data->nDeadPeers-nPeersBuf > 1 ? "es" : ""));
       free(auxPeersBuf);
     } // if (rasCountIsOutlier(nRasDeadPeers)
     rasOutAppend("\n");
@@ -1277,19 +1409,19 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
         rasOutAppend("#%d-%d (%016lx) INCOMPLETE\n"
                      "  Missing communicator data from %d rank%s\n", vcIdx, commIdx - vc->firstIdx,
                      comm->commId.commHash, auxComm->nIncompleteRanks, (auxComm->nIncompleteRanks > 1 ? "s" : ""));
-        if (rasCountIsOutlier(auxComm->nIncompleteRanks, client->verbose)) {
+        if (rasCountIsOutlier(auxComm->nIncompleteRanks, verbose)) {
           struct rasCollCommsMissingRank* missingRanks = (struct rasCollCommsMissingRank*)(comm->ranks+comm->nRanks);
           for (int rankIdx = 0; rankIdx < comm->nMissingRanks; rankIdx++) {
             struct rasCollCommsMissingRank* missingRank = missingRanks + rankIdx;
             // Filter out ranks that provided a response but not for this communicator.
-            if (bsearch(&missingRank->addr, coll->peers, coll->nPeers, sizeof(*coll->peers), ncclSocketsCompare) ==
-                nullptr) {
-              int peerIdx = rasPeerFind(&missingRank->addr);
+            if (bsearch(&missingRank->addr, data->collPeers, data->nCollPeers, sizeof(*data->collPeers),
+                        ncclSocketsCompare) == nullptr) {
+              int peerIdx = rasReportPeerFind(data, &missingRank->addr);
               if (peerIdx != -1) {
                 rasOutAppend("  Rank %d -- GPU %s managed by process %d on node %s\n",
                              missingRank->commRank,
                              rasGpuToString(missingRank->cudaDev, missingRank->nvmlDev, lineBuf, sizeof(lineBuf)),
-                             rasPeers[peerIdx].pid,
+                             data->peers[peerIdx].pid,
                              ncclSocketToHost(&missingRank->addr, rasLine, sizeof(rasLine)));
               } else {
                 rasOutAppend("  Rank %d -- [process information not found]\n", missingRank->commRank);
@@ -1312,7 +1444,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
         if (nErrors > 0) {
           rasOutAppend("  Initialization error%s on %d rank%s\n",
                        (nErrors > 1 ? "s" : ""), nErrors, (nErrors > 1 ? "s" : ""));
-          rasClientBreakDownErrors(client, comm, peerIdxConv, ncclErrors);
+          rasClientBreakDownErrors(data, verbose, comm, peerIdxConv, ncclErrors);
         }
 
         memset(ncclErrors, '\0', sizeof(ncclErrors));
@@ -1322,25 +1454,21 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
         if (nErrors > 0) {
           rasOutAppend("  Asynchronous error%s on %d rank%s\n",
                        (nErrors > 1 ? "s" : ""), nErrors, (nErrors > 1 ? "s" : ""));
-          rasClientBreakDownErrors(client, comm, peerIdxConv, ncclErrors, /*isAsync*/true);
+          rasClientBreakDownErrors(data, verbose, comm, peerIdxConv, ncclErrors, /*isAsync*/true);
         }
         rasOutAppend("\n");
       } // if (auxComm->errors & RAS_ACE_ERROR)
     } // for (commIdx)
   } // for (vcIdx)
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
+  NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
 
   rasOutAppend("Warnings\n"
                "========\n\n");
 
-  if (coll->nLegTimeouts > 0) {
+  if (data->nLegTimeouts > 0) {
     rasOutAppend("TIMEOUT\n"
                  "  Encountered %d communication timeout%s while gathering communicator data\n\n",
-                 coll->nLegTimeouts, (coll->nLegTimeouts > 1 ? "s" : ""));
+                 data->nLegTimeouts, (data->nLegTimeouts > 1 ? "s" : ""));
   }
 
   // Continue printing the largest communicators first, as in the summary table.
@@ -1410,7 +1538,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
             struct rasValCount* vcc = collOpCounts+coc;
             if (vcc->count > 1)
               rasOutAppend("  %d ranks have status %s\n", vcc->count, statusStr[vcc->value]);
-            if (rasCountIsOutlier(vcc->count, client->verbose, comm->commNRanks)) {
+            if (rasCountIsOutlier(vcc->count, verbose, comm->commNRanks)) {
               if (vcc->firstIdx != -1) {
                 // auxCommRanks is sorted by commRank as the secondary key, which comes in handy when printing...
                 for (int rankIdx = vcc->firstIdx; rankIdx < vcc->count+vcc->firstIdx; rankIdx++) {
@@ -1420,14 +1548,14 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                       rasOutAppend("  Rank %d -- GPU %s managed by process %d on node %s\n",
                                    auxCommRanks[rankIdx].rank->commRank,
                                    rasCommRankGpuToString(auxCommRanks[rankIdx].rank, lineBuf, sizeof(lineBuf)),
-                                   rasPeers[peerIdx].pid,
-                                   ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                                   data->peers[peerIdx].pid,
+                                   ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
                     else
                       rasOutAppend("  Rank %d has status %s -- GPU %s managed by process %d on node %s\n",
                                    auxCommRanks[rankIdx].rank->commRank, statusStr[vcc->value],
                                    rasCommRankGpuToString(auxCommRanks[rankIdx].rank, lineBuf, sizeof(lineBuf)),
-                                   rasPeers[peerIdx].pid,
-                                   ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                                   data->peers[peerIdx].pid,
+                                   ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
                   } else { // peerIdx == -1
                     if (vcc->count > 1)
                       rasOutAppend("  Rank %d -- [process information not found]\n",
@@ -1444,21 +1572,21 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                 for (int rankIdx = 0; rankIdx < comm->nMissingRanks; rankIdx++) {
                   struct rasCollCommsMissingRank* missingRank = missingRanks + rankIdx;
                   // Filter out ranks that did not respond at all.
-                  if (bsearch(&missingRank->addr, coll->peers, coll->nPeers, sizeof(*coll->peers),
+                  if (bsearch(&missingRank->addr, data->collPeers, data->nCollPeers, sizeof(*data->collPeers),
                               ncclSocketsCompare)) {
-                    int peerIdx = rasPeerFind(&missingRank->addr);
+                    int peerIdx = rasReportPeerFind(data, &missingRank->addr);
                     if (peerIdx != -1) {
                       if (vcc->count > 1) {
                         rasOutAppend("  Rank %d -- GPU %s managed by process %d on node %s\n",
                                      missingRank->commRank, rasGpuToString(missingRank->cudaDev, missingRank->nvmlDev,
                                                                            lineBuf, sizeof(lineBuf)),
-                                     rasPeers[peerIdx].pid,
+                                     data->peers[peerIdx].pid,
                                      ncclSocketToHost(&missingRank->addr, rasLine, sizeof(rasLine)));
                       } else {
                         rasOutAppend("  Rank %d has status %s -- GPU %s managed by process %d on node %s\n",
                                      missingRank->commRank, statusStr[vcc->value],
                                      rasGpuToString(missingRank->cudaDev, missingRank->nvmlDev,
-                                                    lineBuf, sizeof(lineBuf)), rasPeers[peerIdx].pid,
+                                                    lineBuf, sizeof(lineBuf)), data->peers[peerIdx].pid,
                                      ncclSocketToHost(&missingRank->addr, rasLine, sizeof(rasLine)));
                       }
                     } else { // peerIdx == -1
@@ -1520,7 +1648,7 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                 else
                   rasOutAppend("  %d ranks have not launched any operations\n", vcc->count);
               }
-              if (rasCountIsOutlier(vcc->count, client->verbose, comm->commNRanks)) {
+              if (rasCountIsOutlier(vcc->count, verbose, comm->commNRanks)) {
                 // auxCommRanks is sorted by commRank as the secondary key, which comes in handy when printing...
                 for (int rankIdx = vcc->firstIdx; rankIdx < vcc->count+vcc->firstIdx; rankIdx++) {
                   int peerIdx = peerIdxConv[auxCommRanks[rankIdx].rank->peerIdx];
@@ -1529,21 +1657,21 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
                       rasOutAppend("  Rank %d -- GPU %s managed by process %d on node %s\n",
                                    auxCommRanks[rankIdx].rank->commRank,
                                    rasCommRankGpuToString(auxCommRanks[rankIdx].rank, lineBuf, sizeof(lineBuf)),
-                                   rasPeers[peerIdx].pid,
-                                   ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                                   data->peers[peerIdx].pid,
+                                   ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
                     } else {
                       if (vcc->value > 0) {
                         rasOutAppend("  Rank %d has launched up to operation %ld -- GPU %s managed by process %d "
                                      "on node %s\n", auxCommRanks[rankIdx].rank->commRank, vcc->value,
                                      rasCommRankGpuToString(auxCommRanks[rankIdx].rank, lineBuf, sizeof(lineBuf)),
-                                     rasPeers[peerIdx].pid,
-                                     ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                                     data->peers[peerIdx].pid,
+                                     ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
                       } else {
                         rasOutAppend("  Rank %d has not launched any operations -- GPU %s managed by process %d "
                                      "on node %s\n", auxCommRanks[rankIdx].rank->commRank,
                                      rasCommRankGpuToString(auxCommRanks[rankIdx].rank, lineBuf, sizeof(lineBuf)),
-                                     rasPeers[peerIdx].pid,
-                                     ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                                     data->peers[peerIdx].pid,
+                                     ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
                       }
                     }
                   } else { // peerIdx == -1
@@ -1568,15 +1696,9 @@ static ncclResult_t rasClientRunComms(struct rasClient* client) {
       } // if (auxComm->errors & RAS_ACE_MISMATCH)
     } // for (commIdx)
   } // for (vcIdx)
-  rasCollFree(coll);
+  NCCLCHECKGOTO(rasClientOutFlush(client), ret, fail);
 
-  msgLen = rasOutLength();
-  NCCLCHECKGOTO(rasClientAllocMsg(&msg, msgLen), ret, fail);
-  rasOutExtract(msg);
-  rasClientEnqueueMsg(client, msg, msgLen);
-  msg = nullptr;
-
-  TRACE(NCCL_RAS, "RAS: rasClientRunComms: finishing");
+  TRACE(NCCL_RAS, "RAS: rasReportFormatComms: finishing");
 exit:
   free(peerNvmlDevs);
   free(collOpCounts);
@@ -1590,7 +1712,7 @@ fail:
 }
 
 // Generates detailed info about encountered errors, be it initialization ones or asynchronous ones.
-static void rasClientBreakDownErrors(struct rasClient* client, struct rasCollComms::comm* comm,
+static void rasClientBreakDownErrors(const struct rasReportData* data, bool verbose, struct rasCollComms::comm* comm,
                                      const int* peerIdxConv, int ncclErrors[ncclNumResults], bool isAsync) {
   // Because the number of possible error kinds is finite and small, we don't bother in this case with allocating
   // temporary data structures, counting the errors, sorting arrays, etc.  Instead, in each iteration we pick the most
@@ -1608,7 +1730,7 @@ static void rasClientBreakDownErrors(struct rasClient* client, struct rasCollCom
       break;
     if (maxCount > 1)
       rasOutAppend("  %d ranks reported %s\n", maxCount, ncclErrorToString(maxCountIdx));
-    if (rasCountIsOutlier(maxCount, client->verbose)) {
+    if (rasCountIsOutlier(maxCount, verbose)) {
       for (int rankIdx = 0; rankIdx < comm->nRanks; rankIdx++) {
         if ((isAsync ? comm->ranks[rankIdx].status.asyncError : comm->ranks[rankIdx].status.initState) == maxCountIdx) {
           int peerIdx = peerIdxConv[comm->ranks[rankIdx].peerIdx];
@@ -1617,14 +1739,14 @@ static void rasClientBreakDownErrors(struct rasClient* client, struct rasCollCom
               rasOutAppend("  Rank %d -- GPU %s managed by process %d on node %s\n",
                            comm->ranks[rankIdx].commRank,
                            rasCommRankGpuToString(comm->ranks+rankIdx, lineBuf, sizeof(lineBuf)),
-                           rasPeers[peerIdx].pid,
-                           ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                           data->peers[peerIdx].pid,
+                           ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
             else
               rasOutAppend("  Rank %d reported %s -- GPU %s managed by process %d on node %s\n",
                            comm->ranks[rankIdx].commRank, ncclErrorToString(maxCountIdx),
                            rasCommRankGpuToString(comm->ranks+rankIdx, lineBuf, sizeof(lineBuf)),
-                           rasPeers[peerIdx].pid,
-                           ncclSocketToHost(&rasPeers[peerIdx].addr, rasLine, sizeof(rasLine)));
+                           data->peers[peerIdx].pid,
+                           ncclSocketToHost(&data->peers[peerIdx].addr, rasLine, sizeof(rasLine)));
           } else { // peerIdx == -1
             if (maxCount > 1)
               rasOutAppend("  Rank %d -- [process information not found]\n", comm->ranks[rankIdx].commRank);
@@ -1705,11 +1827,26 @@ exit:
   ;
 }
 
+// Releases the output buffer.
+static void rasOutFree() {
+  free(rasOutBuffer);
+  rasOutBuffer = nullptr;
+  nRasOutBuffer = rasOutBufferSize = 0;
+}
+
 
 ///////////////////////////////////////////////////////////////////
 // Various sorting callbacks used when grouping/formatting data. //
 ///////////////////////////////////////////////////////////////////
 
+// Searching callback for struct rasPeerInfo.  Compares an ncclSocketAddress key against a rasPeerInfo element.
+static int rasAddrPeerInfoCompare(const void* k, const void* e) {
+  const union ncclSocketAddress* key = (const union ncclSocketAddress*)k;
+  const struct rasPeerInfo* elem = (const struct rasPeerInfo*)e;
+
+  return ncclSocketsCompare(key, &elem->addr);
+}
+
 // Sorting callback for rasAuxPeerInfo elements.  Sorts by value, with the peers host IP as the secondary key and
 // the process id as the tertiary key.
 static int rasAuxPeersValueCompare(const void* e1, const void* e2) {
@@ -1904,14 +2041,35 @@ static bool rasCountIsOutlier(int count, bool verbose, int totalCount) {
   }
 }
 
+// Renders the text of the status report from the provided data; the text is identical to what the STATUS
+// (or VERBOSE STATUS) command would have sent to the client.  Does not depend on the state of the RAS thread, so it
+// can be invoked from any thread (e.g., by rasDumpRender).  Note that data->collPeers gets sorted in the process.
+// The caller is responsible for freeing the returned text.
+ncclResult_t rasReportRender(struct rasReportData* data, bool verbose, char** text, int* textLen) {
+  ncclResult_t ret = ncclSuccess;
+
+  *text = nullptr;
+  *textLen = 0;
+  rasOutReset();
+  NCCLCHECKGOTO(rasReportFormatPeers(nullptr, data, verbose), ret, fail);
+  rasOutAppend("\nCommunicators...");
+  NCCLCHECKGOTO(rasReportFormatComms(nullptr, data, verbose), ret, fail);
+  *textLen = rasOutLength();
+  NCCLCHECKGOTO(ncclCalloc(text, *textLen+1), ret, fail);
+  rasOutExtract(*text);
+exit:
+  rasOutFree();
+  return ret;
+fail:
+  goto exit;
+}
+
 // Invoked during RAS termination to release all the allocated resources.
 void rasClientSupportTerminate() {
   (void)close(rasClientListeningSocket);
   rasClientListeningSocket = -1;
 
-  free(rasOutBuffer);
-  rasOutBuffer = nullptr;
-  nRasOutBuffer = rasOutBufferSize = 0;
+  rasOutFree();
 
   for (struct rasClient* client = rasClientsHead; client;) {
     struct rasClient* clientNext = client->next;
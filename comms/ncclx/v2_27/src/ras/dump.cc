@@ -0,0 +1,407 @@
+/*************************************************************************
+ * Copyright (c) 2016-2024, NVIDIA CORPORATION. All rights reserved.
+ *
+ * See LICENSE.txt for license information
+ ************************************************************************/
+
+#include <algorithm>
+
+#include "alloc.h"
+#include "checks.h"
+#include "nccl.h"
+#include "ras_internal.h"
+
+static_assert(NCCL_NUM_FUNCTIONS <= RAS_DUMP_MAX_COLL_FUNCS, "RAS_DUMP_MAX_COLL_FUNCS too small");
+static_assert(sizeof(union ncclSocketAddress) <= RAS_DUMP_ADDR_LEN, "RAS_DUMP_ADDR_LEN too small");
+
+static void rasDumpRecordInit(struct rasDumpRecordHeader* hdr, rasDumpRecordType type, size_t length);
+static void rasDumpAddrPack(uint8_t* dst, const union ncclSocketAddress* addr);
+static void rasDumpAddrUnpack(union ncclSocketAddress* addr, const uint8_t* src);
+static ncclResult_t rasDumpNextRecord(const char* dump, size_t dumpLen, size_t* offset, rasDumpRecordType type,
+                                      void* record, size_t size);
+static ncclResult_t rasDumpDecodeComms(const char* dump, size_t dumpLen, size_t* offset, int nComms, int nCollFuncs,
+                                       int nCollPeers, struct rasCollComms* comms, size_t* nData);
+
+
+///////////////////////////////////////////////////
+// Functions generating the binary status dump. //
+///////////////////////////////////////////////////
+
+// Writes the records describing the data available locally: the header (with the version info) and the RAS peers,
+// both live and dead.  These are the first records of the dump.
+ncclResult_t rasDumpWritePeers(const struct rasReportData* data, rasDumpAppendFn append, void* arg) {
+  struct rasDumpHeader header;
+  struct rasDumpPeer peer;
+  struct rasDumpAddr deadPeer;
+
+  memset(&header, '\0', sizeof(header));
+  rasDumpRecordInit(&header.hdr, RAS_DUMP_HEADER, sizeof(header));
+  header.magic = RAS_DUMP_MAGIC;
+  header.version = RAS_DUMP_VERSION;
+  header.ncclMajor = data->ncclMajor;
+  header.ncclMinor = data->ncclMinor;
+  header.ncclPatch = data->ncclPatch;
+  strncpy(header.ncclSuffix, data->ncclSuffix, sizeof(header.ncclSuffix)-1);
+  header.cudaMajor = data->cudaMajor;
+  header.cudaMinor = data->cudaMinor;
+  header.cudaRuntime = data->cudaRuntime;
+  header.cudaDriver = data->cudaDriver;
+  header.nCollFuncs = NCCL_NUM_FUNCTIONS;
+  header.nPeers = data->nPeers;
+  header.nDeadPeers = data->nDeadPeers;
+  NCCLCHECK(append(arg, &header, sizeof(header)));
+
+  memset(&peer, '\0', sizeof(peer));
+  rasDumpRecordInit(&peer.hdr, RAS_DUMP_PEER, sizeof(peer));
+  for (int peerIdx = 0; peerIdx < data->nPeers; peerIdx++) {
+    const struct rasPeerInfo* peerInfo = data->peers+peerIdx;
+    rasDumpAddrPack(peer.addr, &peerInfo->addr);
+    peer.pid = peerInfo->pid;
+    peer.cudaDevs = peerInfo->cudaDevs;
+    peer.nvmlDevs = peerInfo->nvmlDevs;
+    peer.hostHash = peerInfo->hostHash;
+    peer.pidHash = peerInfo->pidHash;
+    NCCLCHECK(append(arg, &peer, sizeof(peer)));
+  }
+
+  memset(&deadPeer, '\0', sizeof(deadPeer));
+  rasDumpRecordInit(&deadPeer.hdr, RAS_DUMP_DEAD_PEER, sizeof(deadPeer));
+  for (int i = 0; i < data->nDeadPeers; i++) {
+    rasDumpAddrPack(deadPeer.addr, data->deadPeers+i);
+    NCCLCHECK(append(arg, &deadPeer, sizeof(deadPeer)));
+  }
+
+  return ncclSuccess;
+}
+
+// Writes the records describing the results of the RAS_COLL_COMMS collective operation, followed by the end record.
+// The communicators are written straight from the (merged) collective response, in its order.
+ncclResult_t rasDumpWriteComms(const struct rasReportData* data, rasDumpAppendFn append, void* arg) {
+  struct rasDumpComms comms;
+  struct rasDumpAddr collPeer;
+  struct rasDumpComm dumpComm;
+  struct rasDumpRank dumpRank;
+  struct rasDumpMissingRank dumpMissingRank;
+  struct rasDumpRecordHeader end;
+  int nComms = (data->comms ? data->comms->nComms : 0);
+  const struct rasCollComms::comm* comm;
+
+  memset(&comms, '\0', sizeof(comms));
+  rasDumpRecordInit(&comms.hdr, RAS_DUMP_COMMS, sizeof(comms));
+  comms.elapsed = data->elapsed;
+  comms.nLegTimeouts = data->nLegTimeouts;
+  comms.nCollPeers = data->nCollPeers;
+  comms.nComms = nComms;
+  NCCLCHECK(append(arg, &comms, sizeof(comms)));
+
+  memset(&collPeer, '\0', sizeof(collPeer));
+  rasDumpRecordInit(&collPeer.hdr, RAS_DUMP_COLL_PEER, sizeof(collPeer));
+  for (int peerIdx = 0; peerIdx < data->nCollPeers; peerIdx++) {
+    rasDumpAddrPack(collPeer.addr, data->collPeers+peerIdx);
+    NCCLCHECK(append(arg, &collPeer, sizeof(collPeer)));
+  }
+
+  memset(&dumpComm, '\0', sizeof(dumpComm));
+  rasDumpRecordInit(&dumpComm.hdr, RAS_DUMP_COMM, sizeof(dumpComm));
+  memset(&dumpRank, '\0', sizeof(dumpRank));
+  rasDumpRecordInit(&dumpRank.hdr, RAS_DUMP_RANK, sizeof(dumpRank));
+  memset(&dumpMissingRank, '\0', sizeof(dumpMissingRank));
+  rasDumpRecordInit(&dumpMissingRank.hdr, RAS_DUMP_MISSING_RANK, sizeof(dumpMissingRank));
+  comm = (nComms > 0 ? data->comms->comms : nullptr);
+  for (int commIdx = 0; commIdx < nComms; commIdx++) {
+    const struct rasCollCommsMissingRank* missingRanks =
+      (const struct rasCollCommsMissingRank*)(comm->ranks+comm->nRanks);
+
+    dumpComm.commHash = comm->commId.commHash;
+    dumpComm.hostHash = comm->commId.hostHash;
+    dumpComm.pidHash = comm->commId.pidHash;
+    dumpComm.commNRanks = comm->commNRanks;
+    dumpComm.nRanks = comm->nRanks;
+    dumpComm.nMissingRanks = comm->nMissingRanks;
+    NCCLCHECK(append(arg, &dumpComm, sizeof(dumpComm)));
+
+    for (int rankIdx = 0; rankIdx < comm->nRanks; rankIdx++) {
+      const struct rasCollComms::comm::rank* rank = comm->ranks+rankIdx;
+      dumpRank.commRank = rank->commRank;
+      dumpRank.collPeerIdx = rank->peerIdx;
+      memcpy(dumpRank.collOpCounts, rank->collOpCounts, sizeof(rank->collOpCounts));
+      dumpRank.initState = rank->status.initState;
+      dumpRank.asyncError = rank->status.asyncError;
+      dumpRank.flags = (rank->status.finalizeCalled ? RAS_DUMP_RANK_FINALIZE_CALLED : 0) |
+        (rank->status.destroyFlag ? RAS_DUMP_RANK_DESTROY_FLAG : 0) |
+        (rank->status.abortFlag ? RAS_DUMP_RANK_ABORT_FLAG : 0);
+      dumpRank.cudaDev = rank->cudaDev;
+      dumpRank.nvmlDev = rank->nvmlDev;
+      NCCLCHECK(append(arg, &dumpRank, sizeof(dumpRank)));
+    }
+
+    for (int rankIdx = 0; rankIdx < comm->nMissingRanks; rankIdx++) {
+      const struct rasCollCommsMissingRank* missingRank = missingRanks+rankIdx;
+      rasDumpAddrPack(dumpMissingRank.addr, &missingRank->addr);
+      dumpMissingRank.commRank = missingRank->commRank;
+      dumpMissingRank.cudaDev = missingRank->cudaDev;
+      dumpMissingRank.nvmlDev = missingRank->nvmlDev;
+      NCCLCHECK(append(arg, &dumpMissingRank, sizeof(dumpMissingRank)));
+    }
+
+    comm = (const struct rasCollComms::comm*)(missingRanks+comm->nMissingRanks);
+  } // for (commIdx)
+
+  rasDumpRecordInit(&end, RAS_DUMP_END, sizeof(end));
+  NCCLCHECK(append(arg, &end, sizeof(end)));
+
+  return ncclSuccess;
+}
+
+
+/////////////////////////////////////////////////////
+// Functions interpreting the binary status dump. //
+/////////////////////////////////////////////////////
+
+// Reconstructs the report data from a complete binary dump.  The resulting data can be passed to rasReportRender
+// and must be released using rasDumpDataFree.  Returns ncclInvalidArgument if the dump is malformed or incomplete.
+ncclResult_t rasDumpDecode(const char* dump, size_t dumpLen, struct rasReportData* data) {
+  ncclResult_t ret = ncclSuccess;
+  struct rasDumpHeader header;
+  struct rasDumpPeer peer;
+  struct rasDumpAddr addr;
+  struct rasDumpComms comms;
+  struct rasDumpRecordHeader end;
+  char* suffix = nullptr;
+  size_t offset = 0, commsOffset, nData = 0;
+
+  memset(data, '\0', sizeof(*data));
+
+  NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_HEADER, &header, sizeof(header)), ret, fail);
+  if (header.magic != RAS_DUMP_MAGIC || header.version != RAS_DUMP_VERSION || header.nCollFuncs < 0 ||
+      header.nCollFuncs > RAS_DUMP_MAX_COLL_FUNCS || header.nPeers < 0 || header.nDeadPeers < 0) {
+    INFO(NCCL_RAS, "RAS dump: invalid header (magic 0x%x, version %u, nCollFuncs %d, nPeers %d, nDeadPeers %d)",
+         header.magic, header.version, header.nCollFuncs, header.nPeers, header.nDeadPeers);
+    ret = ncclInvalidArgument;
+    goto fail;
+  }
+  data->ncclMajor = header.ncclMajor;
+  data->ncclMinor = header.ncclMinor;
+  data->ncclPatch = header.ncclPatch;
+  NCCLCHECKGOTO(ncclCalloc(&suffix, sizeof(header.ncclSuffix)+1), ret, fail);
+  memcpy(suffix, header.ncclSuffix, sizeof(header.ncclSuffix));
+  data->ncclSuffix = suffix;
+  data->cudaMajor = header.cudaMajor;
+  data->cudaMinor = header.cudaMinor;
+  data->cudaRuntime = header.cudaRuntime;
+  data->cudaDriver = header.cudaDriver;
+
+  if (header.nPeers > 0)
+    NCCLCHECKGOTO(ncclCalloc(&data->peers, header.nPeers), ret, fail);
+  for (data->nPeers = 0; data->nPeers < header.nPeers; data->nPeers++) {
+    struct rasPeerInfo* peerInfo = data->peers+data->nPeers;
+    NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_PEER, &peer, sizeof(peer)), ret, fail);
+    rasDumpAddrUnpack(&peerInfo->addr, peer.addr);
+    peerInfo->pid = peer.pid;
+    peerInfo->cudaDevs = peer.cudaDevs;
+    peerInfo->nvmlDevs = peer.nvmlDevs;
+    peerInfo->hostHash = peer.hostHash;
+    peerInfo->pidHash = peer.pidHash;
+  }
+
+  if (header.nDeadPeers > 0)
+    NCCLCHECKGOTO(ncclCalloc(&data->deadPeers, header.nDeadPeers), ret, fail);
+  for (data->nDeadPeers = 0; data->nDeadPeers < header.nDeadPeers; data->nDeadPeers++) {
+    NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_DEAD_PEER, &addr, sizeof(addr)), ret, fail);
+    rasDumpAddrUnpack(data->deadPeers+data->nDeadPeers, addr.addr);
+  }
+
+  NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_COMMS, &comms, sizeof(comms)), ret, fail);
+  if (comms.nCollPeers < 0 || comms.nComms < 0) {
+    INFO(NCCL_RAS, "RAS dump: invalid communicators record (nCollPeers %d, nComms %d)",
+         comms.nCollPeers, comms.nComms);
+    ret = ncclInvalidArgument;
+    goto fail;
+  }
+  data->elapsed = comms.elapsed;
+  data->nLegTimeouts = comms.nLegTimeouts;
+
+  if (comms.nCollPeers > 0)
+    NCCLCHECKGOTO(ncclCalloc(&data->collPeers, comms.nCollPeers), ret, fail);
+  for (data->nCollPeers = 0; data->nCollPeers < comms.nCollPeers; data->nCollPeers++) {
+    NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_COLL_PEER, &addr, sizeof(addr)), ret, fail);
+    rasDumpAddrUnpack(data->collPeers+data->nCollPeers, addr.addr);
+  }
+
+  // rasCollComms is of variable length, so the first pass only calculates its size; the second one fills it in.
+  commsOffset = offset;
+  NCCLCHECKGOTO(rasDumpDecodeComms(dump, dumpLen, &commsOffset, comms.nComms, header.nCollFuncs, data->nCollPeers,
+                                   nullptr, &nData), ret, fail);
+  NCCLCHECKGOTO(ncclCalloc((char**)&data->comms, nData), ret, fail);
+  NCCLCHECKGOTO(rasDumpDecodeComms(dump, dumpLen, &offset, comms.nComms, header.nCollFuncs, data->nCollPeers,
+                                   data->comms, &nData), ret, fail);
+
+  NCCLCHECKGOTO(rasDumpNextRecord(dump, dumpLen, &offset, RAS_DUMP_END, &end, sizeof(end)), ret, fail);
+exit:
+  return ret;
+fail:
+  rasDumpDataFree(data);
+  goto exit;
+}
+
+// Releases the report data allocated by rasDumpDecode.
+void rasDumpDataFree(struct rasReportData* data) {
+  free((char*)data->ncclSuffix);
+  free(data->peers);
+  free(data->deadPeers);
+  free(data->collPeers);
+  free(data->comms);
+  memset(data, '\0', sizeof(*data));
+}
+
+// Turns a complete binary dump back into the text of the STATUS (or VERBOSE STATUS) report.  The caller is
+// responsible for freeing the returned text.
+ncclResult_t rasDumpRender(const char* dump, size_t dumpLen, bool verbose, char** text, int* textLen) {
+  ncclResult_t ret = ncclSuccess;
+  struct rasReportData data;
+
+  NCCLCHECK(rasDumpDecode(dump, dumpLen, &data));
+  NCCLCHECKGOTO(rasReportRender(&data, verbose, text, textLen), ret, exit);
+exit:
+  rasDumpDataFree(&data);
+  return ret;
+}
+
+
+///////////////////////
+// Helper functions. //
+///////////////////////
+
+static void rasDumpRecordInit(struct rasDumpRecordHeader* hdr, rasDumpRecordType type, size_t length) {
+  hdr->type = type;
+  hdr->length = length;
+}
+
+static void rasDumpAddrPack(uint8_t* dst, const union ncclSocketAddress* addr) {
+  memset(dst, '\0', RAS_DUMP_ADDR_LEN);
+  memcpy(dst, addr, sizeof(*addr));
+}
+
+static void rasDumpAddrUnpack(union ncclSocketAddress* addr, const uint8_t* src) {
+  memcpy(addr, src, sizeof(*addr));
+}
+
+// Extracts the next record of the dump, which must be of the given type; records of unknown types are skipped.
+// The record is copied to the caller's buffer of the given size, which takes care of alignment.  Records longer than
+// expected (from a future minor extension) are truncated, while shorter ones are rejected.
+static ncclResult_t rasDumpNextRecord(const char* dump, size_t dumpLen, size_t* offset, rasDumpRecordType type,
+                                      void* record, size_t size) {
+  struct rasDumpRecordHeader hdr;
+
+  for (;;) {
+    if (dumpLen - *offset < sizeof(hdr)) {
+      INFO(NCCL_RAS, "RAS dump: truncated at offset %zu, expected record type %d", *offset, type);
+      return ncclInvalidArgument;
+    }
+    memcpy(&hdr, dump + *offset, sizeof(hdr));
+    if (hdr.length < sizeof(hdr) || hdr.length % 8 != 0 || hdr.length > dumpLen - *offset) {
+      INFO(NCCL_RAS, "RAS dump: invalid record length %u at offset %zu", hdr.length, *offset);
+      return ncclInvalidArgument;
+    }
+    if (hdr.type == type)
+      break;
+    if (hdr.type >= RAS_DUMP_HEADER && hdr.type <= RAS_DUMP_END) {
+      INFO(NCCL_RAS, "RAS dump: unexpected record type %u at offset %zu, expected %d", hdr.type, *offset, type);
+      return ncclInvalidArgument;
+    }
+    *offset += hdr.length;
+  }
+  if (hdr.length < size) {
+    INFO(NCCL_RAS, "RAS dump: record type %u at offset %zu too short (%u < %zu)", hdr.type, *offset, hdr.length, size);
+    return ncclInvalidArgument;
+  }
+  memcpy(record, dump + *offset, size);
+  *offset += hdr.length;
+  return ncclSuccess;
+}
+
+// Decodes the communicator records of the dump into rasCollComms.  If comms is nullptr, only calculates the size
+// of the data (in nData) without storing anything.
+static ncclResult_t rasDumpDecodeComms(const char* dump, size_t dumpLen, size_t* offset, int nComms, int nCollFuncs,
+                                       int nCollPeers, struct rasCollComms* comms, size_t* nData) {
+  struct rasDumpComm dumpComm;
+  struct rasDumpRank dumpRank;
+  struct rasDumpMissingRank dumpMissingRank;
+  struct rasCollComms::comm* comm = (comms ? comms->comms : nullptr);
+  size_t size = sizeof(*comms);
+
+  if (comms)
+    comms->nComms = nComms;
+  for (int commIdx = 0; commIdx < nComms; commIdx++) {
+    struct rasCollCommsMissingRank* missingRanks = nullptr;
+
+    NCCLCHECK(rasDumpNextRecord(dump, dumpLen, offset, RAS_DUMP_COMM, &dumpComm, sizeof(dumpComm)));
+    if (dumpComm.nRanks < 0 || dumpComm.nMissingRanks < 0 ||
+        dumpComm.commNRanks < dumpComm.nRanks + dumpComm.nMissingRanks) {
+      INFO(NCCL_RAS, "RAS dump: invalid communicator record (commNRanks %d, nRanks %d, nMissingRanks %d)",
+           dumpComm.commNRanks, dumpComm.nRanks, dumpComm.nMissingRanks);
+      return ncclInvalidArgument;
+    }
+    size += sizeof(*comm) + dumpComm.nRanks * sizeof(*comm->ranks) +
+      dumpComm.nMissingRanks * sizeof(struct rasCollCommsMissingRank);
+    if (comm) {
+      comm->commId.commHash = dumpComm.commHash;
+      comm->commId.hostHash = dumpComm.hostHash;
+      comm->commId.pidHash = dumpComm.pidHash;
+      comm->commNRanks = dumpComm.commNRanks;
+      comm->nRanks = dumpComm.nRanks;
+      comm->nMissingRanks = dumpComm.nMissingRanks;
+      missingRanks = (struct rasCollCommsMissingRank*)(comm->ranks+comm->nRanks);
+    }
+
+    for (int rankIdx = 0; rankIdx < dumpComm.nRanks; rankIdx++) {
+      NCCLCHECK(rasDumpNextRecord(dump, dumpLen, offset, RAS_DUMP_RANK, &dumpRank, sizeof(dumpRank)));
+      if (dumpRank.commRank < 0 || dumpRank.commRank >= dumpComm.commNRanks || dumpRank.collPeerIdx < 0 ||
+          dumpRank.collPeerIdx >= nCollPeers) {
+        INFO(NCCL_RAS, "RAS dump: invalid rank record (commRank %d, collPeerIdx %d)",
+             dumpRank.commRank, dumpRank.collPeerIdx);
+        return ncclInvalidArgument;
+      }
+      if (comm) {
+        struct rasCollComms::comm::rank* rank = comm->ranks+rankIdx;
+        rank->commRank = dumpRank.commRank;
+        rank->peerIdx = dumpRank.collPeerIdx;
+        memcpy(rank->collOpCounts, dumpRank.collOpCounts,
+               std::min(nCollFuncs, NCCL_NUM_FUNCTIONS) * sizeof(*rank->collOpCounts));
+        rank->status.initState = (ncclResult_t)dumpRank.initState;
+        rank->status.asyncError = (ncclResult_t)dumpRank.asyncError;
+        rank->status.finalizeCalled = (dumpRank.flags & RAS_DUMP_RANK_FINALIZE_CALLED);
+        rank->status.destroyFlag = (dumpRank.flags & RAS_DUMP_RANK_DESTROY_FLAG);
+        rank->status.abortFlag = (dumpRank.flags & RAS_DUMP_RANK_ABORT_FLAG);
+        rank->cudaDev = dumpRank.cudaDev;
+        rank->nvmlDev = dumpRank.nvmlDev;
+      }
+    } // for (rankIdx)
+
+    for (int rankIdx = 0; rankIdx < dumpComm.nMissingRanks; rankIdx++) {
+      NCCLCHECK(rasDumpNextRecord(dump, dumpLen, offset, RAS_DUMP_MISSING_RANK, &dumpMissingRank,
+                                  sizeof(dumpMissingRank)));
+      if (dumpMissingRank.commRank < 0 || dumpMissingRank.commRank >= dumpComm.commNRanks) {
+        INFO(NCCL_RAS, "RAS dump: invalid missing rank record (commRank %d)", dumpMissingRank.commRank);
+        return ncclInvalidArgument;
+      }
+      if (comm) {
+        struct rasCollCommsMissingRank* missingRank = missingRanks+rankIdx;
+        missingRank->commRank = dumpMissingRank.commRank;
+        rasDumpAddrUnpack(&missingRank->addr, dumpMissingRank.addr);
+        missingRank->cudaDev = dumpMissingRank.cudaDev;
+        missingRank->nvmlDev = dumpMissingRank.nvmlDev;
+      }
+    } // for (rankIdx)
+
+    if (comm)
+      comm = (struct rasCollComms::comm*)(missingRanks+comm->nMissingRanks);
+  } // for (commIdx)
+
+  if (comms && size != *nData) {
+    INFO(NCCL_RAS, "RAS dump: communicators size mismatch (%zu != %zu) -- internal error?", size, *nData);
+    return ncclInternalError;
+  }
+  *nData = size;
+  return ncclSuccess;
+}
@@ -57,7 +57,7 @@ struct pollfd* rasPfds;
 static int nRasPfds;
 
 // We use it all over the place; no point in wasting the stack...
-char rasLine[SOCKET_NAME_MAXLEN+1];
+thread_local char rasLine[SOCKET_NAME_MAXLEN+1];
 
 // An array holding the addresses of all NCCL communicators.  Modified by the NCCL threads (hence the mutex), read by
 // the RAS thread.
@@ -7,12 +7,144 @@
 #ifndef NCCL_RAS_INTERNAL_H_
 #define NCCL_RAS_INTERNAL_H_
 
+#include <cstdint>
+
 #define NCCL_RAS_CLIENT_PORT 28028
-#define NCCL_RAS_CLIENT_PROTOCOL 2
+#define NCCL_RAS_CLIENT_PROTOCOL 3
+// First protocol version supporting the DUMP command.
+#define NCCL_RAS_CLIENT_PROTOCOL_DUMP 3
 
 #define RAS_COLLECTIVE_LEG_TIMEOUT_SEC 5
 #define RAS_COLLECTIVE_EXTRA_TIMEOUT_SEC RAS_COLLECTIVE_LEG_TIMEOUT_SEC
 
+// Binary status dump, sent in response to the DUMP client command.  It carries the same data that the STATUS report
+// is computed from, but in fixed-layout records written as the data becomes available, without any of the sorting
+// and formatting.  Monitoring tools can consume it directly; rasDumpRender turns it back into the STATUS text.
+//
+// The dump is a sequence of records, each starting with a rasDumpRecordHeader.  The record length includes the
+// header and is always a multiple of 8, so that readers can skip record types they don't know about.  The records
+// come in the following order:
+//   RAS_DUMP_HEADER
+//   RAS_DUMP_PEER (rasDumpHeader::nPeers times, sorted by address)
+//   RAS_DUMP_DEAD_PEER (rasDumpHeader::nDeadPeers times, sorted by address)
+//   RAS_DUMP_COMMS (once the data about the communicators has been collected)
+//   RAS_DUMP_COLL_PEER (rasDumpComms::nCollPeers times)
+//   for each of the rasDumpComms::nComms communicators:
+//     RAS_DUMP_COMM
+//     RAS_DUMP_RANK (rasDumpComm::nRanks times)
+//     RAS_DUMP_MISSING_RANK (rasDumpComm::nMissingRanks times)
+//   RAS_DUMP_END
+// A dump that does not finish with RAS_DUMP_END is incomplete (e.g., the connection was interrupted).
+// All data is in the host byte order of the NCCL process.  Socket addresses are the raw bytes of struct sockaddr_in
+// or struct sockaddr_in6, zero-padded.
+
+#define RAS_DUMP_MAGIC 0x504d5552 // "RUMP" as a little-endian string; also identifies the byte order.
+#define RAS_DUMP_VERSION 1
+// Capacity of rasDumpRank::collOpCounts; rasDumpHeader::nCollFuncs says how many are in use.
+#define RAS_DUMP_MAX_COLL_FUNCS 8
+#define RAS_DUMP_ADDR_LEN 28
+
+typedef enum {
+  RAS_DUMP_HEADER = 1,
+  RAS_DUMP_PEER = 2,
+  RAS_DUMP_DEAD_PEER = 3,
+  RAS_DUMP_COMMS = 4,
+  RAS_DUMP_COLL_PEER = 5,
+  RAS_DUMP_COMM = 6,
+  RAS_DUMP_RANK = 7,
+  RAS_DUMP_MISSING_RANK = 8,
+  RAS_DUMP_END = 9,
+} rasDumpRecordType;
+
+struct rasDumpRecordHeader {
+  uint32_t type; // rasDumpRecordType.
+  uint32_t length; // Of the whole record, including this header.
+};
+
+struct rasDumpHeader {
+  struct rasDumpRecordHeader hdr;
+  uint32_t magic;
+  uint32_t version;
+  int32_t ncclMajor, ncclMinor, ncclPatch;
+  char ncclSuffix[20]; // '\0'-terminated.
+  int32_t cudaMajor, cudaMinor; // CUDA version NCCL was compiled with.
+  int32_t cudaRuntime, cudaDriver;
+  int32_t nCollFuncs;
+  int32_t nPeers;
+  int32_t nDeadPeers;
+  int32_t reserved;
+};
+
+// A NCCL process of the job (an element of rasPeers).
+struct rasDumpPeer {
+  struct rasDumpRecordHeader hdr;
+  uint8_t addr[RAS_DUMP_ADDR_LEN];
+  int32_t pid;
+  uint64_t cudaDevs, nvmlDevs; // Bitmasks.
+  uint64_t hostHash, pidHash;
+};
+
+// A process address; used by RAS_DUMP_DEAD_PEER and RAS_DUMP_COLL_PEER (a process that the data on the
+// communicators was received from).
+struct rasDumpAddr {
+  struct rasDumpRecordHeader hdr;
+  uint8_t addr[RAS_DUMP_ADDR_LEN];
+  int32_t reserved;
+};
+
+struct rasDumpComms {
+  struct rasDumpRecordHeader hdr;
+  int64_t elapsed; // Time it took to collect the data, in ns.
+  int32_t nLegTimeouts; // If >0, the data is incomplete.
+  int32_t nCollPeers;
+  int32_t nComms;
+  int32_t reserved;
+};
+
+struct rasDumpComm {
+  struct rasDumpRecordHeader hdr;
+  uint64_t commHash, hostHash, pidHash;
+  int32_t commNRanks; // >= nRanks + nMissingRanks
+  int32_t nRanks; // Number of RAS_DUMP_RANK records following.
+  int32_t nMissingRanks; // Number of RAS_DUMP_MISSING_RANK records following the ranks.
+  int32_t reserved;
+};
+
+// Flags of rasDumpRank.
+#define RAS_DUMP_RANK_FINALIZE_CALLED 0x1
+#define RAS_DUMP_RANK_DESTROY_FLAG 0x2
+#define RAS_DUMP_RANK_ABORT_FLAG 0x4
+
+// A rank of the preceding communicator.  Ranks come sorted by commRank.
+struct rasDumpRank {
+  struct rasDumpRecordHeader hdr;
+  int32_t commRank;
+  int32_t collPeerIdx; // Index of the RAS_DUMP_COLL_PEER record of the process managing this rank.
+  uint64_t collOpCounts[RAS_DUMP_MAX_COLL_FUNCS];
+  int8_t initState, asyncError; // ncclResult_t.
+  uint8_t flags;
+  int8_t cudaDev, nvmlDev;
+  uint8_t reserved[3];
+};
+
+// A rank of the preceding communicator that we have no data on, either because its process did not respond or
+// because the process did not report this communicator.  Sorted by commRank.
+struct rasDumpMissingRank {
+  struct rasDumpRecordHeader hdr;
+  uint8_t addr[RAS_DUMP_ADDR_LEN];
+  int32_t commRank;
+  int8_t cudaDev, nvmlDev;
+  uint8_t reserved[6];
+};
+
+static_assert(sizeof(struct rasDumpHeader) % 8 == 0, "rasDumpHeader size must be a multiple of 8");
+static_assert(sizeof(struct rasDumpPeer) == 72, "Unexpected rasDumpPeer layout");
+static_assert(sizeof(struct rasDumpAddr) == 40, "Unexpected rasDumpAddr layout");
+static_assert(sizeof(struct rasDumpComms) == 32, "Unexpected rasDumpComms layout");
+static_assert(sizeof(struct rasDumpComm) == 48, "Unexpected rasDumpComm layout");
+static_assert(sizeof(struct rasDumpRank) == 88, "Unexpected rasDumpRank layout");
+static_assert(sizeof(struct rasDumpMissingRank) == 48, "Unexpected rasDumpMissingRank layout");
+
 // End of the client section; everything below is meant for the NCCL threads only.
 #ifndef NCCL_RAS_CLIENT
 
@@ -457,9 +589,35 @@ struct rasClient {
 
   int verbose;
   int64_t timeout;
+  bool dump; // Send a binary dump rather than the STATUS text.
 
   // State stored during asynchronous operations such as collectives.
   struct rasCollective* coll;
+
+  // Message that binary dump records are being added to, before it's enqueued for sending.
+  char* dumpMsg;
+  int nDumpMsg;
+};
+
+// Data that the status report is computed from.  For the STATUS command it points to the local RAS state and the
+// results of the RAS_COLL_COMMS collective; rasDumpDecode fills it from a binary dump.
+struct rasReportData {
+  int ncclMajor, ncclMinor, ncclPatch;
+  const char* ncclSuffix;
+  int cudaMajor, cudaMinor; // CUDA version NCCL was compiled with.
+  int cudaRuntime, cudaDriver;
+
+  struct rasPeerInfo* peers; // Sorted by addr, like rasPeers.
+  int nPeers;
+  union ncclSocketAddress* deadPeers; // Sorted, like rasDeadPeers.
+  int nDeadPeers;
+
+  // Results of the RAS_COLL_COMMS collective.
+  int64_t elapsed; // In ns.
+  int nLegTimeouts;
+  union ncclSocketAddress* collPeers; // rasCollComms::comm::rank::peerIdx indexes it.
+  int nCollPeers;
+  struct rasCollComms* comms;
 };
 
 
@@ -470,7 +628,7 @@ extern std::mutex ncclCommsMutex;
 extern struct ncclComm** ncclComms;
 extern int nNcclComms;
 extern  bool ncclCommsSorted;
-extern char rasLine[SOCKET_NAME_MAXLEN+1];
+extern thread_local char rasLine[SOCKET_NAME_MAXLEN+1];
 
 ncclResult_t rasMsgAlloc(struct rasMsg** msg, size_t msgLen);
 void rasMsgFree(struct rasMsg* msg);
@@ -551,8 +709,20 @@ ncclResult_t rasClientAcceptNewSocket();
 ncclResult_t rasClientResume(struct rasCollective* coll);
 void rasClientEventLoop(struct rasClient* client, int pollIdx);
 const char* rasGpuDevsToString(uint64_t cudaDevs, uint64_t nvmlDevs, char* buf, size_t size);
+ncclResult_t rasReportRender(struct rasReportData* data, bool verbose, char** text, int* textLen);
 void rasClientSupportTerminate();
 
+
+// dump.cc
+// Invoked with each record of a binary dump, in order.
+typedef ncclResult_t (*rasDumpAppendFn)(void* arg, const void* record, int length);
+
+ncclResult_t rasDumpWritePeers(const struct rasReportData* data, rasDumpAppendFn append, void* arg);
+ncclResult_t rasDumpWriteComms(const struct rasReportData* data, rasDumpAppendFn append, void* arg);
+ncclResult_t rasDumpDecode(const char* dump, size_t dumpLen, struct rasReportData* data);
+void rasDumpDataFree(struct rasReportData* data);
+ncclResult_t rasDumpRender(const char* dump, size_t dumpLen, bool verbose, char** text, int* textLen);
+
 #endif // !NCCL_RAS_CLIENT
 
 #endif // !NCCL_RAS_INTERNAL_H_
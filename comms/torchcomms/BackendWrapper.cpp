@@ -1,6 +1,9 @@
 // Copyright (c) Meta Platforms, Inc. and affiliates.
 
 #include "comms/torchcomms/BackendWrapper.hpp"
+
+#include <optional>
+
 #include "comms/torchcomms/TorchComm.hpp"
 
 namespace torch {
@@ -40,13 +43,30 @@ ReduceOp toReduceOp(const c10d::ReduceOp& op) {
   }
 }
 
-std::vector<uint64_t> toVecUint64(const std::vector<int64_t>& vec) {
-  std::vector<uint64_t> vecUint64;
-  vecUint64.reserve(vec.size());
-  for (auto i : vec) {
-    vecUint64.push_back(i);
+// Returns defaults if c10d left the timeout unset, else a copy of them with
+// the timeout, kept in custom. The defaults are shared by concurrent calls,
+// so they are never written.
+template <typename T>
+const T& withTimeout(
+    const T& defaults,
+    std::chrono::milliseconds timeout,
+    std::optional<T>& custom) {
+  if (timeout == kUnsetTimeout) {
+    return defaults;
   }
-  return vecUint64;
+  custom.emplace(defaults);
+  custom->timeout = timeout;
+  return *custom;
+}
+
+// Converts split sizes into out, a buffer of the calling thread reused
+// across calls instead of a new vector per call. Backends only read the
+// split sizes during the call, so the next call may overwrite them.
+const std::vector<uint64_t>& toVecUint64(
+    const std::vector<int64_t>& vec,
+    std::vector<uint64_t>& out) {
+  out.assign(vec.begin(), vec.end());
+  return out;
 }
 
 } // namespace
@@ -87,10 +107,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::broadcast(
     std::vector<at::Tensor>& tensors,
     const c10d::BroadcastOptions& opts) {
   TORCH_INTERNAL_ASSERT(tensors.size() == 1, "Only single tensor supported");
-  BroadcastOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<BroadcastOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.broadcast, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(
       backend_->broadcast(tensors.at(0), opts.rootRank, opts.asyncOp, bopts));
 }
@@ -99,10 +118,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::allreduce(
     std::vector<at::Tensor>& tensors,
     const c10d::AllreduceOptions& opts) {
   TORCH_INTERNAL_ASSERT(tensors.size() == 1, "Only single tensor supported");
-  AllReduceOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllReduceOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allReduce, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_reduce(
       tensors.at(0), toReduceOp(opts.reduceOp), opts.asyncOp, bopts));
 }
@@ -111,10 +129,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const c10d::AllreduceCoalescedOptions& opts) {
   TORCH_INTERNAL_ASSERT(tensors.size() == 1, "Only single tensor supported");
-  AllReduceOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllReduceOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allReduce, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_reduce(
       tensors.at(0), toReduceOp(opts.reduceOp), opts.asyncOp, bopts));
 }
@@ -123,10 +140,8 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::reduce(
     std::vector<at::Tensor>& tensors,
     const c10d::ReduceOptions& opts) {
   TORCH_INTERNAL_ASSERT(tensors.size() == 1, "Only single tensor supported");
-  ReduceOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<ReduceOptions> custom;
+  const auto& bopts = withTimeout(defaultOptions_.reduce, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->reduce(
       tensors.at(0),
       opts.rootRank,
@@ -143,10 +158,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::allgather(
       outputTensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  AllGatherOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllGatherOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allGather, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_gather(
       outputTensors.at(0), inputTensors.at(0), opts.asyncOp, bopts));
 }
@@ -159,10 +173,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::allgather_coalesced(
       outputTensorLists.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  AllGatherOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllGatherOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allGather, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_gather(
       outputTensorLists.at(0), inputTensors.at(0), opts.asyncOp, bopts));
 }
@@ -178,10 +191,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::allgather_into_tensor_coalesced(
       output_tensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  AllGatherSingleOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllGatherSingleOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allGatherSingle, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_gather_single(
       output_tensors.at(0), inputTensors.at(0), opts.asyncOp, bopts));
 }
@@ -190,10 +202,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::_allgather_base(
     at::Tensor& outputTensor,
     at::Tensor& inputTensor,
     const c10d::AllgatherOptions& opts) {
-  AllGatherSingleOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllGatherSingleOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allGatherSingle, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->all_gather_single(
       outputTensor, inputTensor, opts.asyncOp, bopts));
 }
@@ -206,12 +217,14 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::gather(
       outputTensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  GatherOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<GatherOptions> custom;
+  const auto& bopts = withTimeout(defaultOptions_.gather, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->gather(
-      outputTensors.at(0), inputTensors.at(0), opts.rootRank, opts.asyncOp));
+      outputTensors.at(0),
+      inputTensors.at(0),
+      opts.rootRank,
+      opts.asyncOp,
+      bopts));
 }
 
 c10::intrusive_ptr<c10d::Work> BackendWrapper::scatter(
@@ -220,8 +233,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::scatter(
     const c10d::ScatterOptions& opts) {
   TORCH_INTERNAL_ASSERT(
       outputTensors.size() == 1, "Only single tensor supported");
-  ScatterOptions bopts;
-  bopts.timeout = opts.timeout;
+  std::optional<ScatterOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.scatter, opts.timeout, custom);
   if (getRank() == opts.rootRank) {
     TORCH_INTERNAL_ASSERT(
         inputTensors.size() == 1, "Only single tensor supported");
@@ -232,7 +246,11 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::scatter(
     inputTensors.emplace_back();
   }
   return c10::make_intrusive<WorkWrapper>(backend_->scatter(
-      outputTensors.at(0), inputTensors.at(0), opts.rootRank, opts.asyncOp));
+      outputTensors.at(0),
+      inputTensors.at(0),
+      opts.rootRank,
+      opts.asyncOp,
+      bopts));
 }
 
 c10::intrusive_ptr<c10d::Work> BackendWrapper::reduce_scatter(
@@ -243,10 +261,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::reduce_scatter(
       outputTensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  ReduceScatterOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<ReduceScatterOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.reduceScatter, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->reduce_scatter(
       outputTensors.at(0),
       inputTensors.at(0),
@@ -266,10 +283,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::reduce_scatter_tensor_coalesced(
       outputTensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  ReduceScatterSingleOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<ReduceScatterSingleOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.reduceScatterSingle, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->reduce_scatter_single(
       outputTensors.at(0),
       inputTensors.at(0),
@@ -282,10 +298,9 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::_reduce_scatter_base(
     at::Tensor& outputTensor,
     at::Tensor& inputTensor,
     const c10d::ReduceScatterOptions& opts) {
-  ReduceScatterSingleOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<ReduceScatterSingleOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.reduceScatterSingle, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(backend_->reduce_scatter_single(
       outputTensor,
       inputTensor,
@@ -300,15 +315,16 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::alltoall_base(
     std::vector<int64_t>& outputSplitSizes,
     std::vector<int64_t>& inputSplitSizes,
     const c10d::AllToAllOptions& opts) {
-  AllToAllvSingleOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllToAllvSingleOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allToAllvSingle, opts.timeout, custom);
+  thread_local std::vector<uint64_t> outputSplits;
+  thread_local std::vector<uint64_t> inputSplits;
   return c10::make_intrusive<WorkWrapper>(backend_->all_to_all_v_single(
       outputTensor,
       inputTensor,
-      toVecUint64(outputSplitSizes),
-      toVecUint64(inputSplitSizes),
+      toVecUint64(outputSplitSizes, outputSplits),
+      toVecUint64(inputSplitSizes, inputSplits),
       opts.asyncOp,
       bopts));
 }
@@ -321,20 +337,18 @@ c10::intrusive_ptr<c10d::Work> BackendWrapper::alltoall(
       outputTensors.size() == 1, "Only single tensor supported");
   TORCH_INTERNAL_ASSERT(
       inputTensors.size() == 1, "Only single tensor supported");
-  AllToAllOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<AllToAllOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.allToAll, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(
       backend_->all_to_all(outputTensors, inputTensors, opts.asyncOp, bopts));
 }
 
 c10::intrusive_ptr<c10d::Work> BackendWrapper::barrier(
     const c10d::BarrierOptions& opts) {
-  BarrierOptions bopts;
-  if (opts.timeout != kUnsetTimeout) {
-    bopts.timeout = opts.timeout;
-  }
+  std::optional<BarrierOptions> custom;
+  const auto& bopts =
+      withTimeout(defaultOptions_.barrier, opts.timeout, custom);
   return c10::make_intrusive<WorkWrapper>(
       backend_->barrier(opts.asyncOp, bopts));
 }
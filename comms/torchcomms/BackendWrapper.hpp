@@ -103,7 +103,26 @@ class BackendWrapper : public c10d::Backend {
   recv(std::vector<at::Tensor>& tensors, int srcRank, int tag) override;
 
  private:
+  // Backend options of the calls that leave the timeout unset, i.e. nearly
+  // all of them. Built once and only read afterwards, so concurrent calls
+  // share them instead of each constructing its own.
+  struct DefaultOptions {
+    BroadcastOptions broadcast;
+    AllReduceOptions allReduce;
+    ReduceOptions reduce;
+    AllGatherOptions allGather;
+    AllGatherSingleOptions allGatherSingle;
+    GatherOptions gather;
+    ScatterOptions scatter;
+    ReduceScatterOptions reduceScatter;
+    ReduceScatterSingleOptions reduceScatterSingle;
+    AllToAllvSingleOptions allToAllvSingle;
+    AllToAllOptions allToAll;
+    BarrierOptions barrier;
+  };
+
   std::shared_ptr<TorchCommBackend> backend_;
+  const DefaultOptions defaultOptions_{};
 };
 
 } // namespace comms
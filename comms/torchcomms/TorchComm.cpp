@@ -22,6 +22,21 @@ std::shared_ptr<TorchComm> new_comm(
       new TorchComm(backend_name, std::move(backend_impl)));
 }
 
+std::vector<std::shared_ptr<TorchComm>> new_comms(
+    const std::vector<CommSpec>& specs,
+    size_t max_concurrency) {
+  auto backend_impls =
+      TorchCommFactory::get().create_backends(specs, max_concurrency);
+  std::vector<std::shared_ptr<TorchComm>> comms;
+  comms.reserve(specs.size());
+  for (size_t i = 0; i < specs.size(); i++) {
+    comms.push_back(
+        std::shared_ptr<TorchComm>(
+            new TorchComm(specs[i].backend, std::move(backend_impls[i]))));
+  }
+  return comms;
+}
+
 void TorchComm::finalize() {
   impl_->finalize();
 }
@@ -72,6 +87,18 @@ c10::intrusive_ptr<TorchWork> TorchComm::all_reduce(
   return impl_->all_reduce(tensor, op, async_op, options);
 }
 
+c10::intrusive_ptr<TorchWork> TorchComm::all_reduce_sparse_block(
+    at::Tensor& output,
+    const at::Tensor& input,
+    const at::Tensor& indices,
+    int64_t block_length,
+    const ReduceOp& op,
+    bool async_op,
+    const AllReduceSparseBlockOptions& options) {
+  return impl_->all_reduce_sparse_block(
+      output, input, indices, block_length, op, async_op, options);
+}
+
 c10::intrusive_ptr<TorchWork> TorchComm::reduce(
     const at::Tensor& tensor,
     int root,
@@ -207,6 +234,20 @@ std::shared_ptr<TorchComm> TorchComm::split(
       new TorchComm(backend_, std::move(new_impl)));
 }
 
+std::vector<std::shared_ptr<TorchComm>> TorchComm::split_mesh(
+    const std::vector<int>& shape,
+    const std::vector<std::string>& dim_names,
+    const CommOptions& options) {
+  auto new_impls = impl_->split_mesh(shape, dim_names, options);
+  std::vector<std::shared_ptr<TorchComm>> comms;
+  comms.reserve(new_impls.size());
+  for (auto& new_impl : new_impls) {
+    comms.push_back(std::shared_ptr<TorchComm>(
+        new TorchComm(backend_, std::move(new_impl))));
+  }
+  return comms;
+}
+
 const CommOptions& TorchComm::getOptions() const {
   return impl_->getOptions();
 }
@@ -13,6 +13,7 @@
 #include <torch/csrc/distributed/c10d/Store.hpp> // @manual=//caffe2:torch-cpp-cpu
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace torch {
 namespace comms {
@@ -54,6 +55,14 @@ class TorchComm {
       const ReduceOp& op,
       bool async_op,
       const AllReduceOptions& options = {});
+  c10::intrusive_ptr<TorchWork> all_reduce_sparse_block(
+      at::Tensor& output,
+      const at::Tensor& input,
+      const at::Tensor& indices,
+      int64_t block_length,
+      const ReduceOp& op,
+      bool async_op,
+      const AllReduceSparseBlockOptions& options = {});
   c10::intrusive_ptr<TorchWork> reduce(
       const at::Tensor& tensor,
       int root,
@@ -133,6 +142,10 @@ class TorchComm {
       const std::vector<int>& ranks,
       const std::string& name,
       const CommOptions& options = {});
+  std::vector<std::shared_ptr<TorchComm>> split_mesh(
+      const std::vector<int>& shape,
+      const std::vector<std::string>& dim_names,
+      const CommOptions& options = {});
 
   // Batch Operations
   BatchSendRecv batch_op_create();
@@ -167,6 +180,9 @@ class TorchComm {
       at::Device device,
       const std::string& name,
       const CommOptions& options);
+  friend std::vector<std::shared_ptr<TorchComm>> new_comms(
+      const std::vector<CommSpec>& specs,
+      size_t max_concurrency);
 
  protected:
   std::shared_ptr<TorchCommBackend> getBackendImpl() const {
@@ -192,5 +208,13 @@ std::shared_ptr<TorchComm> new_comm(
     const std::string& name,
     const CommOptions& options = {});
 
+// Creates a batch of communicators, initializing them concurrently, up to
+// max_concurrency at a time (all of them if 0). Like new_comm(), all ranks of
+// each communicator must call this function simultaneously, with the same
+// communicators in the same order.
+std::vector<std::shared_ptr<TorchComm>> new_comms(
+    const std::vector<CommSpec>& specs,
+    size_t max_concurrency = 0);
+
 } // namespace comms
 } // namespace torch
@@ -111,6 +111,7 @@ class TorchCommBackend {
       const at::Tensor& input,
       bool async_op,
       const AllToAllSingleOptions& options = {}) = 0;
+  // The split sizes are only read during the call, also when async.
   virtual c10::intrusive_ptr<TorchWork> all_to_all_v_single(
       at::Tensor& output,
       const at::Tensor& input,
@@ -147,6 +148,23 @@ class TorchCommBackend {
       const std::string& name,
       const CommOptions& options = {}) = 0;
 
+  // Create one communicator per dimension of a row-major mesh of the given
+  // shape over this communicator's ranks, named after dim_names. All ranks
+  // must call it with the same arguments. The default implementation splits
+  // every dimension in turn; backends may create them all at once.
+  virtual std::vector<std::shared_ptr<TorchCommBackend>> split_mesh(
+      const std::vector<int>& shape,
+      const std::vector<std::string>& dim_names,
+      const CommOptions& options = {}) {
+    auto groups = mesh_group_ranks(shape, dim_names, getRank(), getSize());
+    std::vector<std::shared_ptr<TorchCommBackend>> comms;
+    comms.reserve(groups.size());
+    for (size_t d = 0; d < groups.size(); d++) {
+      comms.push_back(split(groups[d], dim_names[d], options));
+    }
+    return comms;
+  }
+
   virtual const CommOptions& getOptions() const = 0;
 
   virtual const at::Device& getDevice() const = 0;
@@ -164,6 +182,31 @@ class TorchCommBackend {
         std::string(getCommName()));
     return nullptr;
   }
+
+  // Block-sparse all_reduce, not required for all backends. Each rank
+  // contributes the blocks of block_length elements of input at the block
+  // indices given by indices (int64, unique per rank); output is the dense
+  // reduction where blocks absent on a rank count as zeros.
+  virtual c10::intrusive_ptr<TorchWork> all_reduce_sparse_block(
+      at::Tensor& output,
+      const at::Tensor& input,
+      const at::Tensor& indices,
+      int64_t block_length,
+      const ReduceOp& op,
+      bool async_op,
+      const AllReduceSparseBlockOptions& options = {}) {
+    (void)(output);
+    (void)(input);
+    (void)(indices);
+    (void)(block_length);
+    (void)(op);
+    (void)(async_op);
+    (void)(options);
+    throw std::logic_error(
+        "[TorchCommBackend]: all_reduce_sparse_block not implemented for communicator:" +
+        std::string(getCommName()));
+    return nullptr;
+  }
 };
 
 /**
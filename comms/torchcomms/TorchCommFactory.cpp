@@ -4,6 +4,10 @@
 
 #include <comms/torchcomms/TorchCommLogging.hpp>
 #include <dlfcn.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include "comms/torchcomms/TorchComm.hpp"
 
 namespace torch {
@@ -110,7 +114,8 @@ BackendLib getBackendLib(const std::string& backend) {
 BackendRegistry is a singleton class that manages the loading and unloading of
 backend libraries. It maintains a map of backend names to backend libraries'
 handle. In order to save resources, it loads libraries permanently, until the
-handle get destroyed.
+handle get destroyed. Communicators may be created from several threads, so it
+is locked.
 */
 struct BackendRegistry {
  public:
@@ -118,6 +123,7 @@ struct BackendRegistry {
   ~BackendRegistry() = default;
 
   DynamicLoaderInterface getBackend(const std::string& backend) {
+    std::lock_guard<std::mutex> guard(mutex_);
     auto it = libs_.find(backend);
     if (it == libs_.end()) {
       auto res = libs_.emplace(backend, getBackendLib(backend));
@@ -130,6 +136,7 @@ struct BackendRegistry {
   }
 
   void eraseBackend(const std::string& backend) {
+    std::lock_guard<std::mutex> guard(mutex_);
     if (auto it = libs_.find(backend); it != libs_.end()) {
       libs_.erase(it);
     }
@@ -141,6 +148,7 @@ struct BackendRegistry {
   }
 
  private:
+  std::mutex mutex_;
   std::unordered_map<std::string, BackendLib> libs_;
 };
 
@@ -151,23 +159,84 @@ std::shared_ptr<TorchCommBackend> TorchCommFactory::create_backend(
     at::Device device,
     const std::string& name,
     const CommOptions& options) {
-  std::shared_ptr<TorchCommBackend> impl;
+  std::shared_ptr<TorchCommBackend> impl = new_backend(backend);
 
-  for (const auto& [key, _] : backends_) {
-    TC_LOG(INFO) << "Backend " << key << " is registered";
+  if (impl) {
+    impl->init(device, name, options);
   }
 
-  if (auto it = backends_.find(backend); it != backends_.end()) {
-    impl = it->second();
-  } else {
-    impl = create_generic_backend(backend);
+  return impl;
+}
+
+std::vector<std::shared_ptr<TorchCommBackend>>
+TorchCommFactory::create_backends(
+    const std::vector<CommSpec>& specs,
+    size_t max_concurrency) {
+  // Instances first, on this thread, so that each backend library is loaded
+  // once and not by the threads below
+  std::vector<std::shared_ptr<TorchCommBackend>> impls;
+  impls.reserve(specs.size());
+  for (const auto& spec : specs) {
+    impls.push_back(new_backend(spec.backend));
   }
 
-  if (impl) {
-    impl->init(device, name, options);
+  // Initializing is mostly waiting for the other ranks at rendezvous, on the
+  // store prefix of each communicator, so they are initialized concurrently.
+  // Communicators are taken in order: one is only started once all before it
+  // are, on every rank, so the first unfinished one is always in progress
+  // everywhere and the batch cannot deadlock.
+  const size_t num_threads = std::min(
+      max_concurrency == 0 ? specs.size() : max_concurrency, specs.size());
+  std::atomic<size_t> next{0};
+  std::vector<std::exception_ptr> errors(specs.size());
+  auto init_next = [&]() {
+    for (size_t i = next++; i < specs.size(); i = next++) {
+      if (impls[i] == nullptr) {
+        continue;
+      }
+      try {
+        impls[i]->init(specs[i].device, specs[i].name, specs[i].options);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < num_threads; t++) {
+    threads.emplace_back(init_next);
+  }
+  init_next();
+  for (auto& thread : threads) {
+    thread.join();
   }
 
-  return impl;
+  for (size_t i = 0; i < specs.size(); i++) {
+    if (errors[i]) {
+      TC_LOG(ERROR) << "Failed to initialize communicator " << specs[i].name
+                    << " in a batch of " << specs.size();
+      std::rethrow_exception(errors[i]);
+    }
+  }
+  return impls;
+}
+
+std::shared_ptr<TorchCommBackend> TorchCommFactory::new_backend(
+    const std::string& backend) {
+  std::function<std::shared_ptr<TorchCommBackend>()> factory;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (const auto& [key, _] : backends_) {
+      TC_LOG(INFO) << "Backend " << key << " is registered";
+    }
+    if (auto it = backends_.find(backend); it != backends_.end()) {
+      factory = it->second;
+    }
+  }
+
+  if (factory) {
+    return factory();
+  }
+  return create_generic_backend(backend);
 }
 
 std::shared_ptr<TorchCommBackend> TorchCommFactory::create_generic_backend(
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <c10/core/Device.h>
@@ -26,15 +27,27 @@ class TorchCommFactory {
       const std::string& name,
       const CommOptions& options = CommOptions());
 
+  // Creates the backends of a batch of communicators and initializes them
+  // concurrently, up to max_concurrency at a time (all of them if 0). Each
+  // backend library is loaded once, before any initialization starts. Every
+  // rank must pass the same communicators in the same order. Throws the
+  // error of the first communicator that failed, once all have returned.
+  std::vector<std::shared_ptr<TorchCommBackend>> create_backends(
+      const std::vector<CommSpec>& specs,
+      size_t max_concurrency = 0);
+
   void register_backend(
       const std::string& backend,
       const std::function<std::shared_ptr<TorchCommBackend>()>& factory);
 
  private:
+  // Backend instance, not initialized yet
+  std::shared_ptr<TorchCommBackend> new_backend(const std::string& backend);
   std::shared_ptr<TorchCommBackend> create_generic_backend(
       const std::string& backend);
 
  private:
+  // Guards backends_ only; backends are initialized without it
   std::mutex mutex_;
   std::unordered_map<
       std::string,
@@ -56,6 +56,21 @@ class AllReduceOptions {
   AllReduceOptions() : timeout(kNoTimeout) {}
 };
 
+class AllReduceSparseBlockOptions {
+ public:
+  // Fraction of the output blocks that, once exceeded by the number of blocks
+  // contributed across all ranks, makes the backend reduce a dense tensor
+  // instead of exchanging (index, block) pairs.
+  static constexpr double kDefaultDenseThreshold = 0.5;
+
+  std::unordered_map<std::string, std::string> hints;
+  std::chrono::milliseconds timeout;
+  double dense_threshold;
+
+  AllReduceSparseBlockOptions()
+      : timeout(kNoTimeout), dense_threshold(kDefaultDenseThreshold) {}
+};
+
 class ReduceOptions {
  public:
   std::unordered_map<std::string, std::string> hints;
@@ -158,5 +173,14 @@ class CommOptions {
   bool operator==(const CommOptions& other) const;
 };
 
+// One communicator of a batch created with new_comms()
+class CommSpec {
+ public:
+  std::string backend;
+  at::Device device{at::kCPU};
+  std::string name;
+  CommOptions options;
+};
+
 } // namespace comms
 } // namespace torch
@@ -379,6 +379,80 @@ Args:
       py::arg("store") = nullptr,
       py::arg("hints") = std::nullopt);
 
+  m.def(
+      "new_comms",
+      [](const std::string& backend,
+         const c10::Device& device,
+         const std::vector<std::string>& names,
+         std::optional<bool> abort_process_on_timeout_or_error,
+         std::optional<std::chrono::milliseconds> timeout,
+         std::optional<bool> high_priority_stream,
+         std::optional<std::unordered_map<std::string, std::string>> hints,
+         size_t max_concurrency) {
+        py::module_ torchcomms = py::module_::import("torchcomms");
+        torchcomms.attr("_load_backend")(backend);
+
+        {
+          py::gil_scoped_release release{};
+
+          CommOptions opts;
+          if (abort_process_on_timeout_or_error) {
+            opts.abort_process_on_timeout_or_error =
+                *abort_process_on_timeout_or_error;
+          }
+          if (timeout) {
+            opts.timeout = *timeout;
+          }
+          if (high_priority_stream) {
+            opts.high_priority_stream = *high_priority_stream;
+          }
+          if (hints) {
+            opts.hints = *hints;
+          }
+
+          std::vector<CommSpec> specs;
+          specs.reserve(names.size());
+          for (const auto& name : names) {
+            specs.push_back(
+                CommSpec{
+                    .backend = backend,
+                    .device = device,
+                    .name = name,
+                    .options = opts});
+          }
+          return new_comms(specs, max_concurrency);
+        }
+      },
+      R"(
+Create a batch of communicators, one per name, on the same backend and device.
+
+This is equivalent to calling ``new_comm`` for each name, but the communicators
+are initialized concurrently, so startup code creating many communicators does
+not wait for each rendezvous in turn. All ranks must call this function
+simultaneously with the same names in the same order.
+
+Each communicator initializes on its own store, automatically instantiated from
+environment variables such as ``MASTER_ADDR`` and ``MASTER_PORT``.
+
+Args:
+  backend (str): The backend to use for the communicators.
+  device (torch.device): The device to use for the communicators.
+  names (list[str]): The names of the communicators. These must be unique within the process.
+  abort_process_on_timeout_or_error (bool): Whether to abort process on timeout or error.
+  timeout (timedelta): Timeout for initialization.
+  high_priority_stream (bool): Whether to use high priority stream.
+  hints (dict): Dictionary of string hints for backend-specific options.
+  max_concurrency (int): Most communicators initialized at once, 0 for all of them.
+      )",
+      py::arg("backend"),
+      py::arg("device"),
+      py::arg("names"),
+      py::arg("abort_process_on_timeout_or_error") = std::nullopt,
+      py::arg("timeout") = std::nullopt,
+      py::arg("high_priority_stream") = std::nullopt,
+      py::arg("hints") = std::nullopt,
+      py::arg("max_concurrency") = 0);
+
   py::class_<TorchCommBackend, std::shared_ptr<TorchCommBackend>>(
       m,
       "TorchCommBackend",
@@ -575,6 +649,60 @@ Args:
           py::arg("hints") = std::nullopt,
           py::arg("timeout") = std::nullopt,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "all_reduce_sparse_block",
+          [](TorchComm& self,
+             at::Tensor& output,
+             const at::Tensor& input,
+             const at::Tensor& indices,
+             int64_t block_length,
+             ReduceOp op,
+             bool async_op,
+             std::optional<double> dense_threshold,
+             std::optional<std::unordered_map<std::string, std::string>> hints,
+             std::optional<std::chrono::milliseconds> timeout) {
+            AllReduceSparseBlockOptions opts;
+            if (dense_threshold) {
+              opts.dense_threshold = *dense_threshold;
+            }
+            if (hints) {
+              opts.hints = *hints;
+            }
+            if (timeout) {
+              opts.timeout = *timeout;
+            }
+            return self.all_reduce_sparse_block(
+                output, input, indices, block_length, op, async_op, opts);
+          },
+          R"(
+Reduce a block-sparse tensor across all ranks in the communicator.
+
+Each rank contributes the blocks of ``input`` at the block indices
+``indices``; the dense result is written to ``output``. Blocks a rank does not
+contribute count as zeros.
+
+Args:
+    output: the dense output tensor, a multiple of block_length elements
+    input: the contributed blocks, len(indices) * block_length elements
+    indices: int64 block indices into output, unique per rank
+    block_length: number of elements per block
+    op: the reduction operation
+    async_op: whether to perform the operation asynchronously
+    dense_threshold: density of contributed blocks across all ranks above
+        which the backend reduces a dense tensor instead
+    hints: dictionary of string hints for backend-specific options
+    timeout: timeout for the operation
+          )",
+          py::arg("output"),
+          py::arg("input"),
+          py::arg("indices"),
+          py::arg("block_length"),
+          py::arg("op"),
+          py::arg("async_op"),
+          py::arg("dense_threshold") = std::nullopt,
+          py::arg("hints") = std::nullopt,
+          py::arg("timeout") = std::nullopt,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "reduce",
           [](TorchComm& self,
@@ -1111,6 +1239,45 @@ Raises: RuntimeError if the ranks list is non-empty and the current rank is not
           py::arg("hints") = std::nullopt,
           py::arg("timeout") = std::nullopt,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "split_mesh",
+          [](TorchComm& self,
+             const std::vector<int>& shape,
+             const std::vector<std::string>& dim_names,
+             std::optional<std::unordered_map<std::string, std::string>> hints,
+             std::optional<std::chrono::milliseconds> timeout) {
+            CommOptions opts;
+            if (hints) {
+              opts.hints = *hints;
+            }
+            if (timeout) {
+              opts.timeout = *timeout;
+            }
+            return self.split_mesh(shape, dim_names, opts);
+          },
+          R"(
+Split communicator into one subgroup per dimension of a device mesh.
+
+The ranks of this communicator are laid out as a row-major mesh of the given
+shape, i.e. ``torch.arange(size).view(shape)``. For every dimension a
+communicator over the ranks sharing all other coordinates with the current
+rank is created, as ``init_device_mesh`` expects. Backends may initialize the
+dimension communicators concurrently.
+
+Args:
+    shape: Size of every mesh dimension; their product must equal the size of
+        this communicator.
+    dim_names: Name of every mesh dimension, also used as communicator names.
+    hints: Dictionary of string hints for backend-specific options.
+    timeout: Timeout for the operation.
+
+Returns: A list with the communicator of every mesh dimension.
+          )",
+          py::arg("shape"),
+          py::arg("dim_names"),
+          py::arg("hints") = std::nullopt,
+          py::arg("timeout") = std::nullopt,
+          py::call_guard<py::gil_scoped_release>())
 
       // Batch Operations
       .def(
@@ -2,6 +2,7 @@
 
 #include "comms/torchcomms/TorchCommUtils.hpp"
 #include <algorithm>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -73,6 +74,7 @@ T env_to_value(const std::string& env_key, const T& default_value) {
 // Explicit instantiations for common types
 template bool env_to_value<bool>(const std::string&, const bool&);
 template int env_to_value<int>(const std::string&, const int&);
+template size_t env_to_value<size_t>(const std::string&, const size_t&);
 template float env_to_value<float>(const std::string&, const float&);
 template double env_to_value<double>(const std::string&, const double&);
 template std::string env_to_value<std::string>(
@@ -153,5 +155,49 @@ std::pair<int, int> query_ranksize() {
   return std::make_pair(rank, comm_size);
 }
 
+std::vector<std::vector<int>> mesh_group_ranks(
+    const std::vector<int>& shape,
+    const std::vector<std::string>& dim_names,
+    int rank,
+    int size) {
+  if (shape.empty() || shape.size() != dim_names.size()) {
+    throw std::runtime_error(
+        "Mesh shape and dim_names must be non-empty and of the same length");
+  }
+  std::set<std::string> unique_names(dim_names.begin(), dim_names.end());
+  if (unique_names.size() != dim_names.size()) {
+    throw std::runtime_error("Duplicate names found in mesh dim_names");
+  }
+  int64_t numel = 1;
+  for (int dim : shape) {
+    if (dim <= 0) {
+      throw std::runtime_error("Mesh dimensions must be positive");
+    }
+    numel *= dim;
+  }
+  if (numel != size) {
+    throw std::runtime_error(
+        "Mesh of " + std::to_string(numel) +
+        " ranks does not match communicator size " + std::to_string(size));
+  }
+
+  // Row-major strides, i.e. the last dimension is contiguous
+  const size_t ndims = shape.size();
+  std::vector<int> strides(ndims, 1);
+  for (size_t d = ndims - 1; d > 0; d--) {
+    strides[d - 1] = strides[d] * shape[d];
+  }
+
+  std::vector<std::vector<int>> groups(ndims);
+  for (size_t d = 0; d < ndims; d++) {
+    const int coord = (rank / strides[d]) % shape[d];
+    const int base = rank - coord * strides[d];
+    for (int i = 0; i < shape[d]; i++) {
+      groups[d].push_back(base + i * strides[d]);
+    }
+  }
+  return groups;
+}
+
 } // namespace comms
 } // namespace torch
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <torch/csrc/distributed/c10d/Store.hpp> // @manual=//caffe2:torch-cpp-cpu
 
@@ -18,5 +19,14 @@ T env_to_value(const std::string& env_key, const T& default_value);
 // Query rank and size based on TORCHCOMM_BOOTSTRAP_RANKSIZE_QUERY_METHOD
 std::pair<int, int> query_ranksize();
 
+// Ranks of the groups containing rank along every dimension of a row-major
+// mesh of the given shape over ranks [0, size). Throws if the shape does not
+// match size or the dimension names.
+std::vector<std::vector<int>> mesh_group_ranks(
+    const std::vector<int>& shape,
+    const std::vector<std::string>& dim_names,
+    int rank,
+    int size);
+
 } // namespace comms
 } // namespace torch
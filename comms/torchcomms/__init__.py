@@ -25,6 +25,7 @@ import torchcomms.objcol as objcol  # noqa: F401, F403
 # order.
 __all__ = [  # noqa: F405
     "new_comm",
+    "new_comms",
     "TorchComm",
     "ReduceOp",
     "TorchWork",
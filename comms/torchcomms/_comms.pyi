@@ -219,6 +219,18 @@ class TorchComm:
         hints: Dict[str, str] | None = None,
         timeout: timedelta | None = None,
     ) -> TorchWork: ...
+    def all_reduce_sparse_block(
+        self,
+        output: Any,
+        input: Any,
+        indices: Any,
+        block_length: int,
+        op: ReduceOp,
+        async_op: bool,
+        dense_threshold: float | None = None,
+        hints: Dict[str, str] | None = None,
+        timeout: timedelta | None = None,
+    ) -> TorchWork: ...
     def reduce(
         self,
         tensor: Any,
@@ -336,6 +348,13 @@ class TorchComm:
         hints: Dict[str, str] | None = None,
         timeout: timedelta | None = None,
     ) -> TorchComm: ...
+    def split_mesh(
+        self,
+        shape: List[int],
+        dim_names: List[str],
+        hints: Dict[str, str] | None = None,
+        timeout: timedelta | None = None,
+    ) -> List[TorchComm]: ...
     def batch_op_create(self) -> BatchSendRecv: ...
     def window_allocate(
         self,
@@ -354,6 +373,17 @@ def new_comm(
     hints: Dict[str, str] | None = ...,
 ) -> TorchComm: ...
 
+def new_comms(
+    backend: str,
+    device: Any,
+    names: List[str],
+    abort_process_on_timeout_or_error: bool | None = ...,
+    timeout: timedelta | None = ...,
+    high_priority_stream: bool | None = ...,
+    hints: Dict[str, str] | None = ...,
+    max_concurrency: int = ...,
+) -> List[TorchComm]: ...
+
 class _BackendWrapper:
     def __init__(self, comm: TorchComm) -> None: ...
 
@@ -0,0 +1,143 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// Pairwise-scheduled all-to-all(v) for TorchCommGloo. Instead of posting the
+// sends and receives of all peers at once, the exchange runs in size - 1
+// pairwise rounds: rank ^ round when size is a power of two, otherwise
+// rank + round / rank - round. Large messages are split into chunks, and
+// consecutive rounds are grouped so that their chunks interleave, which keeps
+// one slow or large peer from blocking the others.
+//
+// Every rank orders its steps by the same (group, chunk, round) key, and both
+// ends of a transfer see it at the same key, so retiring steps oldest first
+// with any window of at least one step cannot deadlock.
+
+struct AlltoallvSchedulePolicy {
+  // Rounds interleaved per group, and steps in flight once bounded. Must be
+  // the same on all ranks.
+  size_t maxInflight{8};
+  // Messages are exchanged in chunks of at most this many bytes. Must be the
+  // same on all ranks.
+  size_t chunkBytes{4 << 20};
+  // Exchanges receiving fewer bytes are posted all at once, since they are
+  // latency bound. Skewed exchanges, whose largest message is at least
+  // skewThreshold times the mean, are bounded from minBytes / skewThreshold.
+  size_t minBytes{1 << 20};
+  double skewThreshold{4.0};
+};
+
+// One chunk of a message; peer is -1 if there is none.
+struct AlltoallvTransfer {
+  int peer{-1};
+  size_t offset{0};
+  size_t nbytes{0};
+};
+
+// Send and receive of one round and chunk.
+struct AlltoallvStep {
+  AlltoallvTransfer send;
+  AlltoallvTransfer recv;
+};
+
+inline int pairwiseSendPeer(int rank, int size, int round) {
+  return (size & (size - 1)) == 0 ? rank ^ round : (rank + round) % size;
+}
+
+inline int pairwiseRecvPeer(int rank, int size, int round) {
+  return (size & (size - 1)) == 0 ? rank ^ round
+                                  : (rank - round + size) % size;
+}
+
+// Steps of rank in posting order. Messages to and from rank itself are not
+// part of the plan, and peers without any bytes are skipped entirely.
+inline std::vector<AlltoallvStep> planPairwiseAlltoallv(
+    int rank,
+    int size,
+    const std::vector<size_t>& sendOffsets,
+    const std::vector<size_t>& sendBytes,
+    const std::vector<size_t>& recvOffsets,
+    const std::vector<size_t>& recvBytes,
+    const AlltoallvSchedulePolicy& policy) {
+  const size_t chunkBytes = std::max<size_t>(policy.chunkBytes, 1);
+  const size_t group = std::max<size_t>(policy.maxInflight, 1);
+  auto numChunks = [chunkBytes](size_t bytes) {
+    return (bytes + chunkBytes - 1) / chunkBytes;
+  };
+  auto chunk = [chunkBytes](int peer, size_t offset, size_t bytes, size_t c) {
+    AlltoallvTransfer t;
+    if (c * chunkBytes < bytes) {
+      t.peer = peer;
+      t.offset = offset + c * chunkBytes;
+      t.nbytes = std::min(chunkBytes, bytes - c * chunkBytes);
+    }
+    return t;
+  };
+
+  using Key = std::tuple<size_t, size_t, int>; // (group, chunk, round)
+  std::vector<std::pair<Key, AlltoallvStep>> keyed;
+  for (int round = 1; round < size; round++) {
+    const int sendPeer = pairwiseSendPeer(rank, size, round);
+    const int recvPeer = pairwiseRecvPeer(rank, size, round);
+    const size_t chunks = std::max(
+        numChunks(sendBytes[sendPeer]), numChunks(recvBytes[recvPeer]));
+    for (size_t c = 0; c < chunks; c++) {
+      AlltoallvStep step;
+      step.send =
+          chunk(sendPeer, sendOffsets[sendPeer], sendBytes[sendPeer], c);
+      step.recv =
+          chunk(recvPeer, recvOffsets[recvPeer], recvBytes[recvPeer], c);
+      keyed.emplace_back(Key((round - 1) / group, c, round), step);
+    }
+  }
+  std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  std::vector<AlltoallvStep> steps;
+  steps.reserve(keyed.size());
+  for (auto& [key, step] : keyed) {
+    steps.push_back(step);
+  }
+  return steps;
+}
+
+// Number of steps rank keeps in flight: all of them for small exchanges,
+// policy.maxInflight otherwise. Depends only on what rank receives, so ranks
+// may pick different windows.
+inline size_t alltoallvWindow(
+    int rank,
+    const std::vector<size_t>& recvBytes,
+    size_t numSteps,
+    const AlltoallvSchedulePolicy& policy) {
+  size_t total = 0;
+  size_t largest = 0;
+  for (size_t p = 0; p < recvBytes.size(); p++) {
+    if (static_cast<int>(p) != rank) {
+      total += recvBytes[p];
+      largest = std::max(largest, recvBytes[p]);
+    }
+  }
+  const size_t numPeers = std::max<size_t>(recvBytes.size(), 2) - 1;
+  const double mean = static_cast<double>(total) / numPeers;
+  const bool skewed = total > 0 && largest >= policy.skewThreshold * mean;
+  const double minBytes = skewed
+      ? policy.minBytes / std::max(policy.skewThreshold, 1.0)
+      : policy.minBytes;
+
+  if (total < minBytes) {
+    return std::max<size_t>(numSteps, 1);
+  }
+  return std::max<size_t>(policy.maxInflight, 1);
+}
+
+} // namespace comms
+} // namespace torch
@@ -0,0 +1,112 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// Store-free rendezvous for TorchCommGloo. Connecting a full mesh needs, for
+// every pair of ranks, the address each one created for the other. Instead of
+// publishing all addresses through the store, a communicator with an already
+// connected context to bootstrap from (its parent, or its first stripe)
+// exchanges them with Bruck's all-to-all: log2(size) steps, each with one
+// peer, and every rank only receives the addresses meant for it.
+//
+// Each rank starts with one block per position p, addressed to rank
+// (rank + p) mod size. In step k it forwards the blocks whose position has
+// bit k set to rank + 2^k and replaces them with the ones from rank - 2^k.
+
+struct BruckStep {
+  int sendTo;
+  int recvFrom;
+  // Block positions sent, and then overwritten by those received
+  std::vector<size_t> positions;
+};
+
+inline std::vector<BruckStep> bruckAlltoallSteps(int rank, int size) {
+  std::vector<BruckStep> steps;
+  for (int dist = 1; dist < size; dist <<= 1) {
+    BruckStep step;
+    step.sendTo = (rank + dist) % size;
+    step.recvFrom = (rank - dist + size) % size;
+    for (int p = 1; p < size; p++) {
+      if (p & dist) {
+        step.positions.push_back(p);
+      }
+    }
+    steps.push_back(std::move(step));
+  }
+  return steps;
+}
+
+// Position of the block from rank `from` once all steps have run
+inline size_t bruckAlltoallPosition(int rank, int from, int size) {
+  return (rank - from + size) % size;
+}
+
+// Rendezvous of split_mesh: each rank publishes, under a single store key,
+// the addresses of the pairs it created for all of its mesh dimensions, and
+// reads the keys of its peers. addresses[d][p] is the one for rank p of the
+// dimension d group, empty for the rank itself.
+using MeshAddresses = std::vector<std::vector<std::vector<char>>>;
+
+inline std::vector<uint8_t> encodeMeshAddresses(
+    const MeshAddresses& addresses) {
+  std::vector<uint8_t> bytes;
+  auto put = [&](const void* data, size_t len) {
+    const auto* begin = static_cast<const uint8_t*>(data);
+    bytes.insert(bytes.end(), begin, begin + len);
+  };
+  auto putSize = [&](size_t n) {
+    const auto n32 = static_cast<uint32_t>(n);
+    put(&n32, sizeof(n32));
+  };
+  putSize(addresses.size());
+  for (const auto& group : addresses) {
+    putSize(group.size());
+    for (const auto& address : group) {
+      putSize(address.size());
+      put(address.data(), address.size());
+    }
+  }
+  return bytes;
+}
+
+inline MeshAddresses decodeMeshAddresses(const std::vector<uint8_t>& bytes) {
+  size_t offset = 0;
+  auto take = [&](void* data, size_t len) {
+    if (len > bytes.size() - offset) {
+      throw std::runtime_error("Truncated split_mesh addresses");
+    }
+    std::memcpy(data, bytes.data() + offset, len);
+    offset += len;
+  };
+  // Every entry counted takes at least a byte, so a corrupt count fails
+  // before allocating for it
+  auto takeSize = [&]() {
+    uint32_t n;
+    take(&n, sizeof(n));
+    if (n > bytes.size() - offset) {
+      throw std::runtime_error("Truncated split_mesh addresses");
+    }
+    return static_cast<size_t>(n);
+  };
+  MeshAddresses addresses(takeSize());
+  for (auto& group : addresses) {
+    group.resize(takeSize());
+    for (auto& address : group) {
+      address.resize(takeSize());
+      take(address.data(), address.size());
+    }
+  }
+  return addresses;
+}
+
+} // namespace comms
+} // namespace torch
@@ -0,0 +1,165 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include "comms/torchcomms/gloo/GlooCudaStaging.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace torch {
+namespace comms {
+
+CudaStagingCopyEngine::CudaStagingCopyEngine(
+    CudaApi* cudaApi,
+    int device,
+    size_t numSlots,
+    size_t slotBytes)
+    : cudaApi_(cudaApi),
+      device_(device),
+      slotBytes_(slotBytes),
+      slotDone_(numSlots, nullptr),
+      slotUsed_(numSlots, false) {
+  pinned_ = at::empty(
+      {static_cast<int64_t>(numSlots * slotBytes)},
+      at::TensorOptions().dtype(at::kByte).pinned_memory(true));
+
+  CUDA_CHECK(cudaApi_, cudaApi_->setDevice(device_), "Failed to set device");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamCreateWithPriority(
+          &toHostStream_, cudaStreamNonBlocking, 0),
+      "Failed to create staging stream");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamCreateWithPriority(
+          &toDeviceStream_, cudaStreamNonBlocking, 0),
+      "Failed to create staging stream");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->eventCreateWithFlags(&ready_, cudaEventDisableTiming),
+      "Failed to create staging event");
+  for (auto& event : slotDone_) {
+    CUDA_CHECK(
+        cudaApi_,
+        cudaApi_->eventCreateWithFlags(&event, cudaEventDisableTiming),
+        "Failed to create staging event");
+  }
+}
+
+void CudaStagingCopyEngine::begin() {
+  CUDA_CHECK(cudaApi_, cudaApi_->setDevice(device_), "Failed to set device");
+  // Called on the issuing thread: copies see what is queued on its stream
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->eventRecord(ready_, cudaApi_->getCurrentCUDAStream(device_)),
+      "Failed to record staging event");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamWaitEvent(toHostStream_, ready_, 0),
+      "Failed to wait for staging event");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamWaitEvent(toDeviceStream_, ready_, 0),
+      "Failed to wait for staging event");
+}
+
+CudaStagingCopyEngine::~CudaStagingCopyEngine() {
+  // Best effort: the pinned slots must outlive any copy still in flight
+  if (toHostStream_) {
+    cudaApi_->streamSynchronize(toHostStream_);
+    cudaApi_->streamDestroy(toHostStream_);
+  }
+  if (toDeviceStream_) {
+    cudaApi_->streamSynchronize(toDeviceStream_);
+    cudaApi_->streamDestroy(toDeviceStream_);
+  }
+  if (ready_) {
+    cudaApi_->eventDestroy(ready_);
+  }
+  for (auto event : slotDone_) {
+    if (event) {
+      cudaApi_->eventDestroy(event);
+    }
+  }
+}
+
+void* CudaStagingCopyEngine::slot(size_t i) {
+  return static_cast<uint8_t*>(pinned_.data_ptr()) + i * slotBytes_;
+}
+
+void CudaStagingCopyEngine::copyToHost(
+    size_t slot,
+    const void* src,
+    size_t bytes) {
+  CUDA_CHECK(cudaApi_, cudaApi_->setDevice(device_), "Failed to set device");
+  if (slotUsed_[slot]) {
+    // The copy back of the slot's previous chunk may still be reading it
+    CUDA_CHECK(
+        cudaApi_,
+        cudaApi_->streamWaitEvent(toHostStream_, slotDone_[slot], 0),
+        "Failed to wait for staging event");
+  }
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->memcpyAsync(
+          this->slot(slot),
+          src,
+          bytes,
+          cudaMemcpyDeviceToHost,
+          toHostStream_),
+      "Failed to copy to staging slot");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->eventRecord(slotDone_[slot], toHostStream_),
+      "Failed to record staging event");
+  slotUsed_[slot] = true;
+}
+
+void CudaStagingCopyEngine::copyToDevice(
+    void* dst,
+    size_t slot,
+    size_t bytes) {
+  // Copies into the slot were waited for before it was filled on the host
+  CUDA_CHECK(cudaApi_, cudaApi_->setDevice(device_), "Failed to set device");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->memcpyAsync(
+          dst,
+          this->slot(slot),
+          bytes,
+          cudaMemcpyHostToDevice,
+          toDeviceStream_),
+      "Failed to copy from staging slot");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->eventRecord(slotDone_[slot], toDeviceStream_),
+      "Failed to record staging event");
+  slotUsed_[slot] = true;
+}
+
+void CudaStagingCopyEngine::wait(size_t slot) {
+  if (!slotUsed_[slot]) {
+    return;
+  }
+  // Polled like work completion: the slot is needed back soon
+  cudaError_t result;
+  while ((result = cudaApi_->eventQuery(slotDone_[slot])) ==
+         cudaErrorNotReady) {
+    std::this_thread::yield();
+  }
+  CUDA_CHECK(cudaApi_, result, "Failed to wait for staging copy");
+}
+
+void CudaStagingCopyEngine::synchronize() {
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamSynchronize(toHostStream_),
+      "Failed to synchronize staging stream");
+  CUDA_CHECK(
+      cudaApi_,
+      cudaApi_->streamSynchronize(toDeviceStream_),
+      "Failed to synchronize staging stream");
+}
+
+} // namespace comms
+} // namespace torch
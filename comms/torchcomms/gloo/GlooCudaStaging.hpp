@@ -0,0 +1,57 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <vector>
+
+#include <ATen/ATen.h>
+#include "comms/torchcomms/device/CudaApi.hpp"
+#include "comms/torchcomms/gloo/GlooStaging.hpp"
+
+namespace torch {
+namespace comms {
+
+// Stages a CUDA tensor through pinned host slots, with one stream copying to
+// the host and one copying back. Both start behind the work queued on the
+// device's current stream when begin() is called.
+class CudaStagingCopyEngine : public StagingCopyEngine {
+ public:
+  CudaStagingCopyEngine(
+      CudaApi* cudaApi,
+      int device,
+      size_t numSlots,
+      size_t slotBytes);
+  ~CudaStagingCopyEngine() override;
+
+  CudaStagingCopyEngine(const CudaStagingCopyEngine&) = delete;
+  CudaStagingCopyEngine& operator=(const CudaStagingCopyEngine&) = delete;
+
+  size_t numSlots() const override {
+    return slotDone_.size();
+  }
+  size_t slotBytes() const override {
+    return slotBytes_;
+  }
+  void* slot(size_t i) override;
+
+  void begin() override;
+  void copyToHost(size_t slot, const void* src, size_t bytes) override;
+  void copyToDevice(void* dst, size_t slot, size_t bytes) override;
+  void wait(size_t slot) override;
+  void synchronize() override;
+
+ private:
+  CudaApi* cudaApi_;
+  int device_;
+  size_t slotBytes_;
+  at::Tensor pinned_;
+  cudaStream_t toHostStream_{nullptr};
+  cudaStream_t toDeviceStream_{nullptr};
+  cudaEvent_t ready_{nullptr};
+  // Recorded after the last copy into or out of each slot
+  std::vector<cudaEvent_t> slotDone_;
+  std::vector<bool> slotUsed_;
+};
+
+} // namespace comms
+} // namespace torch
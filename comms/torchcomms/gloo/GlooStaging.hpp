@@ -0,0 +1,152 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// Pipelined staging of device tensors through host memory for TorchCommGloo.
+// Instead of copying a whole tensor to the host, running the Gloo op and then
+// copying it back, the tensor is split into chunks that rotate through a few
+// host slots: while chunk k is on the network, chunk k + 1 is being copied to
+// the host and chunk k - 1 back to the device.
+
+// Device tensors are staged from this many bytes, in chunks of this size,
+// through this many slots: one per stage of the pipeline.
+constexpr size_t kDefaultGlooStagingChunkBytes = 4 << 20;
+constexpr size_t kDefaultGlooStagingDepth = 3;
+
+// Asynchronous copies between device memory and host slots. Copies into and
+// out of the same slot take effect in the order they are issued.
+class StagingCopyEngine {
+ public:
+  virtual ~StagingCopyEngine() = default;
+
+  virtual size_t numSlots() const = 0;
+  virtual size_t slotBytes() const = 0;
+  virtual void* slot(size_t i) = 0;
+
+  // Called on the issuing thread before each collective the engine stages:
+  // its copies see the work queued so far by the caller, e.g. on the
+  // device's current stream.
+  virtual void begin() = 0;
+
+  virtual void copyToHost(size_t slot, const void* src, size_t bytes) = 0;
+  virtual void copyToDevice(void* dst, size_t slot, size_t bytes) = 0;
+
+  // Blocks until all copies issued so far into or out of slot are done
+  virtual void wait(size_t slot) = 0;
+  // Blocks until all copies issued so far are done
+  virtual void synchronize() = 0;
+};
+
+// Runs fn(host, offset, bytes) on consecutive chunks of the nbytes at device,
+// each staged in one of engine's slots. Chunks are a multiple of elementSize;
+// they are copied to the host before fn if copyIn, and back after it if
+// copyOut. Returns once all copies are done.
+template <typename Fn>
+void runStagingPipeline(
+    StagingCopyEngine& engine,
+    void* device,
+    size_t nbytes,
+    size_t elementSize,
+    bool copyIn,
+    bool copyOut,
+    Fn&& fn) {
+  const size_t chunkBytes =
+      std::max(engine.slotBytes() / elementSize, size_t{1}) * elementSize;
+  const size_t numChunks = (nbytes + chunkBytes - 1) / chunkBytes;
+  const size_t numSlots = engine.numSlots();
+  auto* base = static_cast<uint8_t*>(device);
+  auto chunkSize = [&](size_t k) {
+    return std::min(chunkBytes, nbytes - k * chunkBytes);
+  };
+
+  if (copyIn && numChunks > 0) {
+    engine.copyToHost(0, base, chunkSize(0));
+  }
+  for (size_t k = 0; k < numChunks; k++) {
+    const size_t slot = k % numSlots;
+    // Prefetch the next chunk, unless it would go into this chunk's slot
+    if (copyIn && k + 1 < numChunks && numSlots > 1) {
+      engine.copyToHost(
+          (k + 1) % numSlots, base + (k + 1) * chunkBytes, chunkSize(k + 1));
+    }
+    // The chunk's copy in, and the copy out of the slot's previous chunk
+    engine.wait(slot);
+    fn(engine.slot(slot), k * chunkBytes, chunkSize(k));
+    if (copyOut) {
+      engine.copyToDevice(base + k * chunkBytes, slot, chunkSize(k));
+    }
+    if (copyIn && k + 1 < numChunks && numSlots == 1) {
+      engine.copyToHost(0, base + (k + 1) * chunkBytes, chunkSize(k + 1));
+    }
+  }
+  engine.synchronize();
+}
+
+// Copy engines of a communicator, kept across collectives so that they do
+// not each set up and tear down streams, events and pinned slots. Every
+// collective in flight has an engine of its own; async ones run
+// concurrently, so more are created while all are in use.
+class StagingEnginePool
+    : public std::enable_shared_from_this<StagingEnginePool> {
+ public:
+  using Factory = std::function<std::unique_ptr<StagingCopyEngine>()>;
+
+  // A free engine of device, or one made with create if there is none,
+  // begun. It goes back to the pool once released, or is destroyed if the
+  // pool is gone by then.
+  std::shared_ptr<StagingCopyEngine> acquire(
+      int device,
+      const Factory& create) {
+    std::unique_ptr<StagingCopyEngine> engine;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& free = free_[device];
+      if (!free.empty()) {
+        engine = std::move(free.back());
+        free.pop_back();
+      }
+    }
+    if (!engine) {
+      engine = create();
+    }
+    engine->begin();
+    return std::shared_ptr<StagingCopyEngine>(
+        engine.release(),
+        [pool = weak_from_this(), device](StagingCopyEngine* released) {
+          std::unique_ptr<StagingCopyEngine> owned(released);
+          if (auto locked = pool.lock()) {
+            locked->release(device, std::move(owned));
+          }
+        });
+  }
+
+  size_t numFree(int device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = free_.find(device);
+    return it == free_.end() ? 0 : it->second.size();
+  }
+
+ private:
+  void release(int device, std::unique_ptr<StagingCopyEngine> engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_[device].push_back(std::move(engine));
+  }
+
+  std::mutex mutex_;
+  std::map<int, std::vector<std::unique_ptr<StagingCopyEngine>>> free_;
+};
+
+} // namespace comms
+} // namespace torch
@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// A single TCP stream per peer cannot saturate a 100/200 Gbit NIC, so
+// TorchCommGloo can keep several gloo contexts, each with its own device and
+// connections, and stripe large collectives across them.
+
+// Default number of contexts (stripes) per communicator
+constexpr size_t kDefaultGlooStripes = 1;
+// Default minimum number of bytes per stripe; smaller collectives use fewer
+// stripes, down to the single main context.
+constexpr size_t kDefaultGlooStripeMinBytes = 1 << 20;
+
+// Contiguous range of elements exchanged over one stripe
+struct StripeRange {
+  size_t offset;
+  size_t count;
+};
+
+// Split count elements of elementSize bytes into up to maxStripes contiguous,
+// near-equal ranges of at least minStripeBytes each. Always returns at least
+// one range. All ranks must use the same arguments so that they agree on the
+// stripes.
+inline std::vector<StripeRange> planStripes(
+    size_t count,
+    size_t elementSize,
+    size_t maxStripes,
+    size_t minStripeBytes) {
+  const size_t bytes = count * elementSize;
+  size_t numStripes = bytes / std::max<size_t>(minStripeBytes, 1);
+  numStripes =
+      std::clamp<size_t>(numStripes, 1, std::max<size_t>(maxStripes, 1));
+  numStripes = std::min(numStripes, std::max<size_t>(count, 1));
+
+  std::vector<StripeRange> stripes(numStripes);
+  const size_t base = count / numStripes;
+  const size_t rem = count % numStripes;
+  size_t offset = 0;
+  for (size_t s = 0; s < numStripes; s++) {
+    stripes[s].offset = offset;
+    stripes[s].count = base + (s < rem ? 1 : 0);
+    offset += stripes[s].count;
+  }
+  return stripes;
+}
+
+// Threads running the stripes of a communicator's collectives, kept across
+// collectives instead of started for each. A stripe never waits for a
+// thread: collectives issued concurrently, e.g. async ones, each need all of
+// their stripes running at once, and ranks may reach them in different
+// orders, so a worker is started whenever none is idle.
+class StripeWorkers {
+ public:
+  StripeWorkers() = default;
+  ~StripeWorkers() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  StripeWorkers(const StripeWorkers&) = delete;
+  StripeWorkers& operator=(const StripeWorkers&) = delete;
+
+  // Run fn(s) for every stripe s in parallel, the first one on the calling
+  // thread. Returns once all stripes finished, rethrowing the first failure.
+  template <typename Fn>
+  void run(size_t numStripes, Fn&& fn) {
+    if (numStripes == 1) {
+      fn(0);
+      return;
+    }
+
+    std::vector<std::exception_ptr> errors(numStripes);
+    size_t remaining = numStripes - 1;
+    for (size_t s = 1; s < numStripes; s++) {
+      post(
+          [&, s]() {
+            try {
+              fn(s);
+            } catch (...) {
+              errors[s] = std::current_exception();
+            }
+          },
+          &remaining);
+    }
+    try {
+      fn(0);
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      doneCv_.wait(lock, [&]() { return remaining == 0; });
+    }
+    for (auto& e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+  }
+
+  size_t numThreads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return threads_.size();
+  }
+
+ private:
+  struct Task {
+    std::function<void()> fn;
+    // Stripes of the run still going, decremented once fn returned
+    size_t* remaining;
+  };
+
+  void post(std::function<void()> fn, size_t* remaining) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(Task{std::move(fn), remaining});
+    if (tasks_.size() <= idle_) {
+      cv_.notify_one();
+    } else {
+      idle_++;
+      threads_.emplace_back([this]() { loop(); });
+    }
+  }
+
+  void loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (!tasks_.empty()) {
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        idle_--;
+        lock.unlock();
+        task.fn();
+        lock.lock();
+        // Idle again before the run can return, so the next one finds this
+        // worker rather than starting another
+        idle_++;
+        if (--*task.remaining == 0) {
+          doneCv_.notify_all();
+        }
+        continue;
+      }
+      if (stop_) {
+        return;
+      }
+      cv_.wait(lock, [this]() { return !tasks_.empty() || stop_; });
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // Signaled when the last stripe of a run finishes
+  std::condition_variable doneCv_;
+  std::deque<Task> tasks_;
+  // Workers not running a task, including those still starting
+  size_t idle_{0};
+  bool stop_{false};
+  std::vector<std::thread> threads_;
+};
+
+} // namespace comms
+} // namespace torch
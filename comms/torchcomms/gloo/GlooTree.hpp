@@ -0,0 +1,83 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// Binomial trees for TorchCommGloo's scatter and gather. Instead of the root
+// exchanging a block with every rank, blocks are forwarded through
+// intermediate ranks, so the root handles log2(size) messages. Ranks are
+// renumbered relative to the root (virtual rank = (rank - root) mod size);
+// the subtree of a virtual rank v spans virtual ranks [v, v + lowbit(v)), and
+// stages their blocks contiguously in virtual rank order.
+
+// Trees are used from this many ranks, for blocks of at most this many bytes.
+// Larger blocks are bandwidth bound at the root either way, and forwarding
+// only adds hops.
+constexpr size_t kDefaultGlooTreeMinRanks = 8;
+constexpr size_t kDefaultGlooTreeMaxBlockBytes = 256 << 10;
+
+struct BinomialTreeChild {
+  int rank;
+  // Range of the child's subtree within the parent's staged blocks
+  size_t blockOffset;
+  size_t numBlocks;
+};
+
+struct BinomialTreeNode {
+  // -1 for the root
+  int parent{-1};
+  // Blocks of this rank's subtree, its own block first
+  size_t numBlocks{0};
+  // Largest subtree first
+  std::vector<BinomialTreeChild> children;
+};
+
+inline BinomialTreeNode binomialTreeNode(int rank, int size, int root) {
+  BinomialTreeNode node;
+  const int vrank = (rank - root + size) % size;
+  int span = 1;
+  if (vrank == 0) {
+    while (span < size) {
+      span <<= 1;
+    }
+  } else {
+    span = vrank & -vrank;
+    node.parent = (vrank - span + root) % size;
+  }
+  node.numBlocks = std::min(span, size - vrank);
+  for (int mask = span >> 1; mask > 0; mask >>= 1) {
+    const int child = vrank + mask;
+    if (child < size) {
+      node.children.push_back(
+          {(child + root) % size,
+           static_cast<size_t>(mask),
+           static_cast<size_t>(std::min(mask, size - child))});
+    }
+  }
+  // Subtrees cut off at the last rank may be smaller than later ones
+  std::stable_sort(
+      node.children.begin(),
+      node.children.end(),
+      [](const BinomialTreeChild& a, const BinomialTreeChild& b) {
+        return a.numBlocks > b.numBlocks;
+      });
+  return node;
+}
+
+inline bool useBinomialTree(
+    int size,
+    size_t blockBytes,
+    size_t minRanks,
+    size_t maxBlockBytes) {
+  return blockBytes > 0 && static_cast<size_t>(size) >= minRanks &&
+      blockBytes <= maxBlockBytes;
+}
+
+} // namespace comms
+} // namespace torch
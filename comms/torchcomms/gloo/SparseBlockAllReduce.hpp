@@ -0,0 +1,132 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <gloo/allgather.h>
+#include <gloo/allgatherv.h>
+#include <gloo/allreduce.h>
+#include <gloo/context.h>
+
+#include "comms/torchcomms/TorchCommTypes.hpp"
+#include "comms/torchcomms/gloo/SparseBlockMerge.hpp"
+
+namespace torch {
+namespace comms {
+
+// Block-sparse all_reduce over a gloo context; see
+// TorchCommBackend::all_reduce_sparse_block for the semantics.
+//
+// Ranks first all-gather their block counts. All ranks thus agree on the
+// density, i.e. the number of blocks contributed across all ranks over
+// numBlocks:
+//   - above denseThreshold, every rank scatters its blocks into a zeroed
+//     output and the dense output is all-reduced;
+//   - otherwise the (indices, blocks) pairs are all-gathered and merged
+//     locally with mergeSparseBlocks.
+//
+// Indices must have passed checkSparseBlockIndices. Returns true if the dense
+// path was taken.
+template <typename T>
+bool sparseBlockAllreduce(
+    const std::shared_ptr<gloo::Context>& context,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    gloo::AllreduceOptions::Func reduce,
+    bool reduceAbsent,
+    const int64_t* indices,
+    size_t count,
+    const T* blocks,
+    size_t blockLength,
+    size_t numBlocks,
+    double denseThreshold,
+    T* output) {
+  const size_t nRanks = context->size;
+
+  std::vector<int64_t> counts(nRanks);
+  {
+    int64_t myCount = count;
+    gloo::AllgatherOptions opts(context);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setInput(&myCount, 1);
+    opts.setOutput(counts.data(), nRanks);
+    gloo::allgather(opts);
+  }
+  const int64_t total =
+      std::accumulate(counts.begin(), counts.end(), int64_t{0});
+
+  if (total == 0) {
+    std::fill(output, output + numBlocks * blockLength, T(0));
+    return false;
+  }
+
+  if (static_cast<double>(total) > denseThreshold * numBlocks) {
+    scatterSparseBlocks(indices, count, blocks, blockLength, numBlocks, output);
+    gloo::AllreduceOptions opts(context);
+    opts.setReduceFunction(reduce);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setOutput(output, numBlocks * blockLength);
+    gloo::allreduce(opts);
+    return true;
+  }
+
+  // gloo needs a valid buffer even for a rank contributing no blocks
+  int64_t emptyIndex = 0;
+  T emptyBlock = T(0);
+  auto* myIndices = count ? const_cast<int64_t*>(indices) : &emptyIndex;
+  auto* myBlocks = count ? const_cast<T*>(blocks) : &emptyBlock;
+
+  std::vector<int64_t> allIndices(total);
+  {
+    std::vector<size_t> elements(counts.begin(), counts.end());
+    gloo::AllgathervOptions opts(context);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setInput(myIndices, count);
+    opts.setOutput(allIndices.data(), std::move(elements));
+    gloo::allgatherv(opts);
+  }
+
+  std::vector<T> allBlocks(total * blockLength);
+  {
+    std::vector<size_t> elements(nRanks);
+    for (size_t r = 0; r < nRanks; r++) {
+      elements[r] = counts[r] * blockLength;
+    }
+    gloo::AllgathervOptions opts(context);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setInput(myBlocks, count * blockLength);
+    opts.setOutput(allBlocks.data(), std::move(elements));
+    gloo::allgatherv(opts);
+  }
+
+  mergeSparseBlocks(
+      counts,
+      allIndices.data(),
+      allBlocks.data(),
+      blockLength,
+      numBlocks,
+      reduce,
+      reduceAbsent,
+      output);
+  return false;
+}
+
+} // namespace comms
+} // namespace torch
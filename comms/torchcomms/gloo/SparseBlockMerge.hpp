@@ -0,0 +1,179 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace comms {
+
+// Host-side helpers of the block-sparse all_reduce. A block-sparse tensor is a
+// list of block indices and the matching blocks of blockLength elements; the
+// dense tensor it represents has numBlocks blocks, absent ones being zeros.
+
+namespace detail {
+
+inline void checkBlockIndex(int64_t idx, size_t numBlocks) {
+  if (idx < 0 || static_cast<uint64_t>(idx) >= numBlocks) {
+    throw std::runtime_error(
+        "Block index " + std::to_string(idx) + " out of range for " +
+        std::to_string(numBlocks) + " blocks");
+  }
+}
+
+inline void throwDuplicateBlockIndex(int64_t idx) {
+  throw std::runtime_error(
+      "Duplicate block index " + std::to_string(idx) +
+      " in block-sparse input");
+}
+
+} // namespace detail
+
+// Check that indices are valid and unique block indices, so that a bad input
+// is reported on the calling thread rather than after the exchange started.
+inline void checkSparseBlockIndices(
+    const int64_t* indices,
+    size_t count,
+    size_t numBlocks) {
+  std::vector<bool> seen(numBlocks, false);
+  for (size_t i = 0; i < count; i++) {
+    const int64_t idx = indices[i];
+    detail::checkBlockIndex(idx, numBlocks);
+    if (seen[idx]) {
+      detail::throwDuplicateBlockIndex(idx);
+    }
+    seen[idx] = true;
+  }
+}
+
+// Write the dense form of one rank's block-sparse tensor to output. Indices
+// must have passed checkSparseBlockIndices.
+template <typename T>
+void scatterSparseBlocks(
+    const int64_t* indices,
+    size_t count,
+    const T* blocks,
+    size_t blockLength,
+    size_t numBlocks,
+    T* output) {
+  std::fill(output, output + numBlocks * blockLength, T(0));
+  for (size_t i = 0; i < count; i++) {
+    std::copy(
+        blocks + i * blockLength,
+        blocks + (i + 1) * blockLength,
+        output + indices[i] * blockLength);
+  }
+}
+
+// Reduce the block-sparse tensors gathered from all ranks into the dense
+// output. counts[r] blocks of rank r are stored back to back in indices and
+// blocks, in rank order.
+//
+// Each rank's indices are sorted (a no-op for the common already-sorted input)
+// and the ranks are k-way merged by index, so that every output block is
+// written exactly once and in order: the first contribution is copied, the
+// others are reduced into it, and the gaps between contributed indices are
+// zero-filled. When reduceAbsent is set, blocks with fewer than counts.size()
+// contributions are also reduced with a zero block, which is required for
+// every op but SUM for the result to match a dense all_reduce.
+//
+// reduce has the gloo reduction signature (void* c, const void* a,
+// const void* b, size_t n).
+template <typename T, typename ReduceFn>
+void mergeSparseBlocks(
+    const std::vector<int64_t>& counts,
+    const int64_t* indices,
+    const T* blocks,
+    size_t blockLength,
+    size_t numBlocks,
+    ReduceFn&& reduce,
+    bool reduceAbsent,
+    T* output) {
+  const size_t nRanks = counts.size();
+  std::vector<size_t> begin(nRanks + 1, 0);
+  for (size_t r = 0; r < nRanks; r++) {
+    begin[r + 1] = begin[r] + counts[r];
+  }
+
+  // Positions of the gathered blocks, sorted by index within each rank
+  std::vector<size_t> order(begin[nRanks]);
+  std::iota(order.begin(), order.end(), 0);
+  auto byIndex = [indices](size_t a, size_t b) {
+    return indices[a] < indices[b];
+  };
+  for (size_t r = 0; r < nRanks; r++) {
+    auto first = order.begin() + begin[r];
+    auto last = order.begin() + begin[r + 1];
+    if (!std::is_sorted(indices + begin[r], indices + begin[r + 1])) {
+      std::sort(first, last, byIndex);
+    }
+    auto dup = std::adjacent_find(first, last, [indices](size_t a, size_t b) {
+      return indices[a] == indices[b];
+    });
+    if (dup != last) {
+      detail::throwDuplicateBlockIndex(indices[*dup]);
+    }
+  }
+
+  // Min-heap of (index, rank) over the next unmerged block of every rank
+  using Head = std::pair<int64_t, size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  std::vector<size_t> cursor(begin.begin(), begin.end() - 1);
+  for (size_t r = 0; r < nRanks; r++) {
+    if (cursor[r] < begin[r + 1]) {
+      heads.emplace(indices[order[cursor[r]]], r);
+    }
+  }
+
+  const std::vector<T> zeros(reduceAbsent ? blockLength : 0, T(0));
+  size_t filled = 0; // output blocks [0, filled) are final
+  int64_t cur = -1;
+  size_t contributions = 0;
+  auto finish = [&]() {
+    if (reduceAbsent && contributions < nRanks) {
+      T* out = output + cur * blockLength;
+      reduce(out, out, zeros.data(), blockLength);
+    }
+    filled = cur + 1;
+  };
+
+  while (!heads.empty()) {
+    const auto [idx, r] = heads.top();
+    heads.pop();
+    const T* block = blocks + order[cursor[r]] * blockLength;
+    if (++cursor[r] < begin[r + 1]) {
+      heads.emplace(indices[order[cursor[r]]], r);
+    }
+
+    detail::checkBlockIndex(idx, numBlocks);
+    T* out = output + idx * blockLength;
+    if (idx == cur) {
+      reduce(out, out, block, blockLength);
+      contributions++;
+      continue;
+    }
+    if (cur >= 0) {
+      finish();
+    }
+    std::fill(output + filled * blockLength, out, T(0));
+    std::copy(block, block + blockLength, out);
+    cur = idx;
+    contributions = 1;
+  }
+  if (cur >= 0) {
+    finish();
+  }
+  std::fill(
+      output + filled * blockLength, output + numBlocks * blockLength, T(0));
+}
+
+} // namespace comms
+} // namespace torch
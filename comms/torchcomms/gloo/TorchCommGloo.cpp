@@ -2,6 +2,9 @@
 
 #include "comms/torchcomms/gloo/TorchCommGloo.hpp"
 
+#include <cstring>
+#include <functional>
+#include <future>
 #include <set>
 #include <string>
 
@@ -11,7 +14,6 @@
 #include <gloo/allgather.h>
 #include <gloo/allreduce.h>
 #include <gloo/alltoall.h>
-#include <gloo/alltoallv.h>
 #include <gloo/barrier.h>
 #include <gloo/broadcast.h>
 #include <gloo/context.h>
@@ -24,12 +26,18 @@
 #include <gloo/transport/device.h>
 #include <gloo/transport/tcp/device.h>
 #include <gloo/transport/unbound_buffer.h>
+#include <gloo/types.h>
 
 #include "comms/torchcomms/StoreManager.hpp"
 #include "comms/torchcomms/TorchCommFactory.hpp"
 #include "comms/torchcomms/TorchCommLogging.hpp"
 #include "comms/torchcomms/TorchCommUtils.hpp"
+#include "comms/torchcomms/gloo/GlooBootstrap.hpp"
+#ifdef TORCHCOMMS_GLOO_CUDA
+#include "comms/torchcomms/gloo/GlooCudaStaging.hpp"
+#endif
 #include "comms/torchcomms/gloo/GlooStore.hpp"
+#include "comms/torchcomms/gloo/SparseBlockAllReduce.hpp"
 
 namespace torch {
 namespace comms {
@@ -226,22 +234,482 @@ void setScatterInputs(O& opts, std::vector<at::Tensor>& inputTensors) {
   opts.setInputs(ptrs, inputTensors.at(0).numel());
 }
 
-template <typename T, typename O>
-void setAlltoallvInput(
-    O& opts,
-    at::Tensor& inputTensor,
-    std::vector<int64_t>& elementsPerRank) {
-  opts.template setInput<T>(getDataPointer<T>(inputTensor), elementsPerRank);
+template <typename T>
+void runSparseBlockAllreduce(
+    const std::shared_ptr<gloo::Context>& context,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    const ReduceOp& op,
+    const at::Tensor& indices,
+    const at::Tensor& input,
+    int64_t blockLength,
+    double denseThreshold,
+    at::Tensor& output) {
+  sparseBlockAllreduce<T>(
+      context,
+      tag,
+      timeout,
+      toFunction<T>(op),
+      op.type() != ReduceOp::RedOpType::SUM,
+      getDataPointer<int64_t>(indices),
+      indices.numel(),
+      getDataPointer<T>(input),
+      blockLength,
+      output.numel() / blockLength,
+      denseThreshold,
+      getDataPointer<T>(output));
 }
 
-template <typename T, typename O>
-void setAlltoallvOutput(
-    O& opts,
-    at::Tensor& outputTensor,
-    std::vector<int64_t>& elementsPerRank) {
-  opts.template setOutput<T>(getDataPointer<T>(outputTensor), elementsPerRank);
+// Striped counterparts of gloo::allreduce, allgather and alltoall. The
+// elements are split into one contiguous range per stripe, and each range is
+// exchanged over the stripe's own context, i.e. its own TCP connections.
+
+constexpr uint8_t kStripedSlotPrefix = 0x5f;
+
+template <typename T>
+void stripedAllreduce(
+    StripeWorkers& workers,
+    const std::vector<std::shared_ptr<gloo::Context>>& contexts,
+    const std::vector<StripeRange>& stripes,
+    gloo::AllreduceOptions::Func fn,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    at::Tensor& tensor) {
+  T* data = getDataPointer<T>(tensor);
+  workers.run(stripes.size(), [&](size_t s) {
+    gloo::AllreduceOptions opts(contexts[s]);
+    opts.setReduceFunction(fn);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setOutput(data + stripes[s].offset, stripes[s].count);
+    gloo::allreduce(opts);
+  });
 }
 
+template <typename T>
+void stripedBroadcast(
+    StripeWorkers& workers,
+    const std::vector<std::shared_ptr<gloo::Context>>& contexts,
+    const std::vector<StripeRange>& stripes,
+    int root,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    at::Tensor& tensor) {
+  T* data = getDataPointer<T>(tensor);
+  workers.run(stripes.size(), [&](size_t s) {
+    gloo::BroadcastOptions opts(contexts[s]);
+    opts.setRoot(root);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    opts.setOutput(data + stripes[s].offset, stripes[s].count);
+    gloo::broadcast(opts);
+  });
+}
+
+// Reduce a CPU tensor in place over contexts[0], or striped across contexts
+// if there is more than one stripe. workers is only used then.
+void allreduceTensor(
+    StripeWorkers* workers,
+    const std::vector<std::shared_ptr<gloo::Context>>& contexts,
+    const std::vector<StripeRange>& stripes,
+    const ReduceOp& op,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    at::Tensor& tensor) {
+  const auto& scalarType = tensor.scalar_type();
+  preReduce(tensor, op);
+  if (stripes.size() > 1) {
+    GENERATE_ALL_TYPES(
+        scalarType,
+        stripedAllreduce,
+        *workers,
+        contexts,
+        stripes,
+        getFunction(scalarType, op),
+        tag,
+        timeout,
+        tensor);
+  } else {
+    gloo::AllreduceOptions opts(contexts[0]);
+    opts.setReduceFunction(getFunction(scalarType, op));
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensor);
+    gloo::allreduce(opts);
+  }
+  postReduce(tensor, op);
+}
+
+// Broadcast a CPU tensor in place, like allreduceTensor
+void broadcastTensor(
+    StripeWorkers* workers,
+    const std::vector<std::shared_ptr<gloo::Context>>& contexts,
+    const std::vector<StripeRange>& stripes,
+    int root,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    at::Tensor& tensor) {
+  const auto& scalarType = tensor.scalar_type();
+  if (stripes.size() > 1) {
+    GENERATE_ALL_TYPES(
+        scalarType,
+        stripedBroadcast,
+        *workers,
+        contexts,
+        stripes,
+        root,
+        tag,
+        timeout,
+        tensor);
+  } else {
+    gloo::BroadcastOptions opts(contexts[0]);
+    opts.setRoot(root);
+    opts.setTag(tag);
+    if (timeout != kNoTimeout) {
+      opts.setTimeout(timeout);
+    }
+    GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensor);
+    gloo::broadcast(opts);
+  }
+}
+
+// Send block p of input to every rank p and receive block p of output from
+// it, striping every block. A sendStride of 0 sends the same block to all
+// ranks, i.e. an allgather.
+void stripedExchange(
+    const std::vector<std::shared_ptr<gloo::Context>>& contexts,
+    const std::vector<StripeRange>& stripes,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    const at::Tensor& input,
+    size_t sendStride,
+    at::Tensor& output,
+    size_t recvStride) {
+  const int rank = contexts[0]->rank;
+  const int size = contexts[0]->size;
+  const size_t elementSize = input.element_size();
+  auto* sendPtr = static_cast<char*>(input.data_ptr());
+  auto* recvPtr = static_cast<char*>(output.data_ptr());
+  const auto slot = gloo::Slot::build(kStripedSlotPrefix, tag);
+
+  // Post all transfers of all stripes first; every stripe is progressed by
+  // its own device thread.
+  std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> sendBufs;
+  std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> recvBufs;
+  for (size_t s = 0; s < stripes.size(); s++) {
+    const size_t offset = stripes[s].offset * elementSize;
+    const size_t nbytes = stripes[s].count * elementSize;
+    auto sendBuf = contexts[s]->createUnboundBuffer(sendPtr, input.nbytes());
+    auto recvBuf = contexts[s]->createUnboundBuffer(recvPtr, output.nbytes());
+    for (int p = 0; p < size; p++) {
+      if (p == rank) {
+        memcpy(
+            recvPtr + p * recvStride + offset,
+            sendPtr + p * sendStride + offset,
+            nbytes);
+        continue;
+      }
+      recvBuf->recv(p, slot, p * recvStride + offset, nbytes);
+      sendBuf->send(p, slot, p * sendStride + offset, nbytes);
+    }
+    sendBufs.push_back(std::move(sendBuf));
+    recvBufs.push_back(std::move(recvBuf));
+  }
+
+  for (size_t s = 0; s < stripes.size(); s++) {
+    for (int p = 0; p < size - 1; p++) {
+      if (timeout == kNoTimeout) {
+        recvBufs[s]->waitRecv();
+        sendBufs[s]->waitSend();
+      } else {
+        recvBufs[s]->waitRecv(timeout);
+        sendBufs[s]->waitSend(timeout);
+      }
+    }
+  }
+}
+
+// Pairwise-scheduled alltoallv, see GlooAlltoallvSchedule.hpp. Offsets and
+// sizes are in bytes; sendBytes[p] on this rank must match recvBytes[rank] on
+// rank p.
+
+constexpr uint8_t kScheduledAlltoallvSlotPrefix = 0x60;
+
+void scheduledAlltoallv(
+    const std::shared_ptr<gloo::Context>& context,
+    const AlltoallvSchedulePolicy& policy,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    const at::Tensor& input,
+    const std::vector<size_t>& sendOffsets,
+    const std::vector<size_t>& sendBytes,
+    at::Tensor& output,
+    const std::vector<size_t>& recvOffsets,
+    const std::vector<size_t>& recvBytes) {
+  const int rank = context->rank;
+  const int size = context->size;
+  auto* sendPtr = static_cast<char*>(input.data_ptr());
+  auto* recvPtr = static_cast<char*>(output.data_ptr());
+  const auto slot = gloo::Slot::build(kScheduledAlltoallvSlotPrefix, tag);
+
+  if (sendBytes[rank] != recvBytes[rank]) {
+    throw std::runtime_error(
+        "Split sizes to and from own rank must match for all_to_all");
+  }
+  if (recvBytes[rank] > 0) {
+    memcpy(
+        recvPtr + recvOffsets[rank],
+        sendPtr + sendOffsets[rank],
+        recvBytes[rank]);
+  }
+
+  const auto steps = planPairwiseAlltoallv(
+      rank, size, sendOffsets, sendBytes, recvOffsets, recvBytes, policy);
+  const size_t window = alltoallvWindow(rank, recvBytes, steps.size(), policy);
+
+  // One buffer per peer and direction: transfers with the same peer complete
+  // in order, so waiting on the peer's buffer waits for the oldest step.
+  std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> sendBufs(size);
+  std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> recvBufs(size);
+  auto post = [&](const AlltoallvStep& step) {
+    if (step.recv.peer >= 0) {
+      auto& buf = recvBufs[step.recv.peer];
+      if (!buf) {
+        buf = context->createUnboundBuffer(recvPtr, output.nbytes());
+      }
+      buf->recv(step.recv.peer, slot, step.recv.offset, step.recv.nbytes);
+    }
+    if (step.send.peer >= 0) {
+      auto& buf = sendBufs[step.send.peer];
+      if (!buf) {
+        buf = context->createUnboundBuffer(sendPtr, input.nbytes());
+      }
+      buf->send(step.send.peer, slot, step.send.offset, step.send.nbytes);
+    }
+  };
+  auto wait = [&](const AlltoallvStep& step) {
+    if (step.recv.peer >= 0) {
+      if (timeout == kNoTimeout) {
+        recvBufs[step.recv.peer]->waitRecv();
+      } else {
+        recvBufs[step.recv.peer]->waitRecv(timeout);
+      }
+    }
+    if (step.send.peer >= 0) {
+      if (timeout == kNoTimeout) {
+        sendBufs[step.send.peer]->waitSend();
+      } else {
+        sendBufs[step.send.peer]->waitSend(timeout);
+      }
+    }
+  };
+
+  size_t posted = 0;
+  for (size_t done = 0; done < steps.size(); done++) {
+    while (posted < steps.size() && posted < done + window) {
+      post(steps[posted++]);
+    }
+    wait(steps[done]);
+  }
+}
+
+// Scheduled counterpart of gloo::alltoall: block p of input goes to rank p.
+void scheduledAlltoall(
+    const std::shared_ptr<gloo::Context>& context,
+    const AlltoallvSchedulePolicy& policy,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    const at::Tensor& input,
+    at::Tensor& output) {
+  const size_t blockBytes = input.nbytes() / context->size;
+  std::vector<size_t> offsets(context->size);
+  for (int p = 0; p < context->size; p++) {
+    offsets[p] = p * blockBytes;
+  }
+  const std::vector<size_t> bytes(context->size, blockBytes);
+  scheduledAlltoallv(
+      context,
+      policy,
+      tag,
+      timeout,
+      input,
+      offsets,
+      bytes,
+      output,
+      offsets,
+      bytes);
+}
+
+// Binomial tree counterparts of gloo::scatter and gather, see GlooTree.hpp.
+// Blocks are blockBytes each; the root's input or output holds one tensor
+// per rank.
+
+constexpr uint8_t kTreeSlotPrefix = 0x61;
+
+void treeScatter(
+    const std::shared_ptr<gloo::Context>& context,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    int root,
+    size_t blockBytes,
+    const std::vector<at::Tensor>& inputs,
+    at::Tensor& output) {
+  const int rank = context->rank;
+  const int size = context->size;
+  const auto node = binomialTreeNode(rank, size, root);
+  const auto slot = gloo::Slot::build(kTreeSlotPrefix, tag);
+
+  std::vector<char> staging(node.numBlocks * blockBytes);
+  if (rank == root) {
+    for (int v = 0; v < size; v++) {
+      memcpy(
+          staging.data() + v * blockBytes,
+          inputs[(v + root) % size].data_ptr(),
+          blockBytes);
+    }
+  }
+  auto buf = context->createUnboundBuffer(staging.data(), staging.size());
+  if (node.parent >= 0) {
+    buf->recv(node.parent, slot, 0, staging.size());
+    if (timeout == kNoTimeout) {
+      buf->waitRecv();
+    } else {
+      buf->waitRecv(timeout);
+    }
+  }
+
+  // Largest subtree first, as it has the most forwarding left to do
+  for (const auto& child : node.children) {
+    buf->send(
+        child.rank,
+        slot,
+        child.blockOffset * blockBytes,
+        child.numBlocks * blockBytes);
+  }
+  memcpy(output.data_ptr(), staging.data(), blockBytes);
+  for (size_t i = 0; i < node.children.size(); i++) {
+    if (timeout == kNoTimeout) {
+      buf->waitSend();
+    } else {
+      buf->waitSend(timeout);
+    }
+  }
+}
+
+void treeGather(
+    const std::shared_ptr<gloo::Context>& context,
+    uint32_t tag,
+    std::chrono::milliseconds timeout,
+    int root,
+    size_t blockBytes,
+    const at::Tensor& input,
+    std::vector<at::Tensor>& outputs) {
+  const int rank = context->rank;
+  const int size = context->size;
+  const auto node = binomialTreeNode(rank, size, root);
+  const auto slot = gloo::Slot::build(kTreeSlotPrefix, tag);
+
+  std::vector<char> staging(node.numBlocks * blockBytes);
+  auto buf = context->createUnboundBuffer(staging.data(), staging.size());
+  for (const auto& child : node.children) {
+    buf->recv(
+        child.rank,
+        slot,
+        child.blockOffset * blockBytes,
+        child.numBlocks * blockBytes);
+  }
+  memcpy(staging.data(), input.data_ptr(), blockBytes);
+  for (size_t i = 0; i < node.children.size(); i++) {
+    if (timeout == kNoTimeout) {
+      buf->waitRecv();
+    } else {
+      buf->waitRecv(timeout);
+    }
+  }
+
+  if (node.parent >= 0) {
+    buf->send(node.parent, slot, 0, staging.size());
+    if (timeout == kNoTimeout) {
+      buf->waitSend();
+    } else {
+      buf->waitSend(timeout);
+    }
+    return;
+  }
+  for (int v = 0; v < size; v++) {
+    memcpy(
+        outputs[(v + root) % size].data_ptr(),
+        staging.data() + v * blockBytes,
+        blockBytes);
+  }
+}
+
+// gloo::Context whose full mesh is connected from addresses exchanged over
+// an already connected context instead of a store, see GlooBootstrap.hpp.
+
+constexpr uint8_t kBootstrapSlotPrefix = 0x62;
+
+class BootstrapContext : public ::gloo::Context {
+ public:
+  using ::gloo::Context::Context;
+
+  // Rank r of this context is rank ranks[r] of bootstrap. All ranks must use
+  // the same tag, which no other bootstrap over the same pairs may be using.
+  void connectFullMesh(
+      std::shared_ptr<::gloo::transport::Device> device,
+      const std::shared_ptr<::gloo::Context>& bootstrap,
+      const std::vector<int>& ranks,
+      uint32_t tag) {
+    auto transportContext = device->createContext(rank, size);
+    transportContext->setTimeout(getTimeout());
+
+    // Addresses are the same length for all pairs of a transport
+    std::vector<std::vector<char>> blocks(size);
+    for (int p = 1; p < size; p++) {
+      auto& pair = transportContext->createPair((rank + p) % size);
+      blocks[p] = pair->address().bytes();
+    }
+    const size_t addrBytes = size > 1 ? blocks[1].size() : 0;
+
+    const auto slot = gloo::Slot::build(kBootstrapSlotPrefix, tag);
+    for (const auto& step : bruckAlltoallSteps(rank, size)) {
+      std::vector<char> sendBytes;
+      sendBytes.reserve(step.positions.size() * addrBytes);
+      for (auto p : step.positions) {
+        sendBytes.insert(sendBytes.end(), blocks[p].begin(), blocks[p].end());
+      }
+      std::vector<char> recvBytes(step.positions.size() * addrBytes);
+      auto sendBuf =
+          bootstrap->createUnboundBuffer(sendBytes.data(), sendBytes.size());
+      auto recvBuf =
+          bootstrap->createUnboundBuffer(recvBytes.data(), recvBytes.size());
+      recvBuf->recv(ranks[step.recvFrom], slot, 0, recvBytes.size());
+      sendBuf->send(ranks[step.sendTo], slot, 0, sendBytes.size());
+      recvBuf->waitRecv(getTimeout());
+      sendBuf->waitSend(getTimeout());
+      for (size_t i = 0; i < step.positions.size(); i++) {
+        auto begin = recvBytes.begin() + i * addrBytes;
+        blocks[step.positions[i]].assign(begin, begin + addrBytes);
+      }
+    }
+
+    for (int peer = 0; peer < size; peer++) {
+      if (peer != rank) {
+        transportContext->getPair(peer)->connect(
+            blocks[bruckAlltoallPosition(rank, peer, size)]);
+      }
+    }
+    device_ = std::move(device);
+    transportContext_ = std::move(transportContext);
+  }
+};
+
 template <typename T>
 void sendTensor(
     std::shared_ptr<gloo::Context> context,
@@ -278,9 +746,173 @@ void recvTensor(
   }
 }
 
+// Runs fn on consecutive chunks of tensor, staged through engine's host
+// slots as CPU tensors; see runStagingPipeline. The chunks run one after
+// another on all ranks, so their Gloo ops can share a tag.
+void stageTensor(
+    StagingCopyEngine& engine,
+    const at::Tensor& tensor,
+    bool copyIn,
+    bool copyOut,
+    const std::function<void(at::Tensor&)>& fn) {
+  const size_t elementSize = tensor.element_size();
+  const auto options = tensor.options().device(at::kCPU);
+  runStagingPipeline(
+      engine,
+      tensor.data_ptr(),
+      tensor.nbytes(),
+      elementSize,
+      copyIn,
+      copyOut,
+      [&](void* host, size_t /*offset*/, size_t bytes) {
+        auto chunk = at::from_blob(
+            host, {static_cast<int64_t>(bytes / elementSize)}, options);
+        fn(chunk);
+      });
+}
+
 } // namespace
 
-TorchCommGloo::TorchCommGloo() : device_(at::kCPU) {}
+// Rendezvous of the communicators split_mesh creates, one per dimension and
+// initialized concurrently. Instead of one exchange per dimension over the
+// parent, every rank publishes the addresses of all of its dimensions under
+// a single store key, once each dimension's init has created its pairs, and
+// each dimension then reads the keys of its own peers.
+class MeshRendezvous {
+ public:
+  MeshRendezvous(
+      c10::intrusive_ptr<c10d::Store> store,
+      int rank,
+      std::vector<std::vector<int>> groups,
+      std::chrono::milliseconds timeout)
+      : store_(std::move(store)),
+        rank_(rank),
+        groups_(std::move(groups)),
+        timeout_(timeout),
+        addresses_(groups_.size()) {}
+
+  // Called by the init of dimension dim with the addresses of its pairs, by
+  // rank in the dimension's group. Returns those the peers created for this
+  // rank, once every dimension has called it.
+  std::vector<std::vector<char>> exchange(
+      size_t dim,
+      std::vector<std::vector<char>> addresses) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      addresses_[dim] = std::move(addresses);
+      if (++arrived_ == groups_.size()) {
+        try {
+          store_->set(key(rank_), encodeMeshAddresses(addresses_));
+        } catch (...) {
+          failed_ = true;
+          cv_.notify_all();
+          throw;
+        }
+        published_ = true;
+        cv_.notify_all();
+      } else if (!cv_.wait_for(lock, timeout_, [this]() {
+                   return published_ || failed_;
+                 })) {
+        throw std::runtime_error(
+            "Timed out waiting for the other dimensions of split_mesh");
+      }
+      if (failed_) {
+        throw std::runtime_error("Another dimension of split_mesh failed");
+      }
+    }
+
+    const auto& group = groups_[dim];
+    const size_t self =
+        std::find(group.begin(), group.end(), rank_) - group.begin();
+    std::vector<std::string> keys;
+    for (size_t p = 0; p < group.size(); p++) {
+      if (p != self) {
+        keys.push_back(key(group[p]));
+      }
+    }
+    store_->wait(keys, timeout_);
+    std::vector<std::vector<char>> remote(group.size());
+    size_t next = 0;
+    for (size_t p = 0; p < group.size(); p++) {
+      if (p == self) {
+        continue;
+      }
+      auto peer = decodeMeshAddresses(store_->get(keys[next++]));
+      if (dim >= peer.size() || self >= peer[dim].size()) {
+        throw std::runtime_error(
+            "split_mesh called with a different shape on rank " +
+            std::to_string(group[p]));
+      }
+      remote[p] = std::move(peer[dim][self]);
+    }
+    return remote;
+  }
+
+  // Releases the other dimensions when one fails before its exchange
+  void abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  static std::string key(int rank) {
+    return fmt::format("addresses_{}", rank);
+  }
+
+  c10::intrusive_ptr<c10d::Store> store_;
+  const int rank_;
+  // Ranks of the group of every dimension, from mesh_group_ranks
+  const std::vector<std::vector<int>> groups_;
+  const std::chrono::milliseconds timeout_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  MeshAddresses addresses_;
+  size_t arrived_{0};
+  bool published_{false};
+  bool failed_{false};
+};
+
+namespace {
+
+// Context of one dimension of a split_mesh, connected through the
+// dimensions' shared MeshRendezvous
+class MeshContext : public ::gloo::Context {
+ public:
+  using ::gloo::Context::Context;
+
+  void connectFullMesh(
+      std::shared_ptr<::gloo::transport::Device> device,
+      MeshRendezvous& mesh,
+      size_t dim) {
+    auto transportContext = device->createContext(rank, size);
+    transportContext->setTimeout(getTimeout());
+
+    std::vector<std::vector<char>> addresses(size);
+    for (int peer = 0; peer < size; peer++) {
+      if (peer != rank) {
+        addresses[peer] = transportContext->createPair(peer)->address().bytes();
+      }
+    }
+    const auto remote = mesh.exchange(dim, std::move(addresses));
+    for (int peer = 0; peer < size; peer++) {
+      if (peer != rank) {
+        transportContext->getPair(peer)->connect(remote[peer]);
+      }
+    }
+    device_ = std::move(device);
+    transportContext_ = std::move(transportContext);
+  }
+};
+
+} // namespace
+
+TorchCommGloo::TorchCommGloo() : device_(at::kCPU) {
+#ifdef TORCHCOMMS_GLOO_CUDA
+  cuda_api_ = std::make_shared<DefaultCudaApi>();
+#endif
+}
 
 TorchCommGloo::~TorchCommGloo() {}
 
@@ -318,12 +950,91 @@ void TorchCommGloo::init(
   if (hints.contains("interface")) {
     attr.iface = hints.at("interface");
   }
-  auto gloo_device = hints.contains("lazy")
-      ? ::gloo::transport::tcp::CreateLazyDevice(attr)
-      : ::gloo::transport::tcp::CreateDevice(attr);
-  auto context =
-      std::make_shared<::gloo::rendezvous::Context>(rank_, comm_size_);
-  context->setTimeout(options.timeout);
+  auto createDevice = [&]() {
+    return hints.contains("lazy")
+        ? ::gloo::transport::tcp::CreateLazyDevice(attr)
+        : ::gloo::transport::tcp::CreateDevice(attr);
+  };
+  auto rendezvous =
+      env_to_value<std::string>("TORCHCOMM_GLOO_RENDEZVOUS", "bootstrap");
+  if (hints.contains("rendezvous")) {
+    rendezvous = hints.at("rendezvous");
+  }
+  if (rendezvous != "bootstrap" && rendezvous != "store") {
+    throw std::runtime_error(
+        "rendezvous must be \"bootstrap\" or \"store\" for TorchCommGloo");
+  }
+
+  size_t numStripes = env_to_value<int>(
+      "TORCHCOMM_GLOO_STRIPES", static_cast<int>(kDefaultGlooStripes));
+  stripeMinBytes_ = env_to_value<size_t>(
+      "TORCHCOMM_GLOO_STRIPE_MIN_BYTES", kDefaultGlooStripeMinBytes);
+  if (hints.contains("stripes")) {
+    numStripes = std::stoul(hints.at("stripes"));
+  }
+  if (hints.contains("stripe_min_bytes")) {
+    stripeMinBytes_ = std::stoull(hints.at("stripe_min_bytes"));
+  }
+  if (numStripes < 1) {
+    throw std::runtime_error("stripes must be at least 1 for TorchCommGloo");
+  }
+
+  // The chunk size and the number of rounds interleaved decide how messages
+  // are matched, so they must be configured identically on all ranks.
+  const AlltoallvSchedulePolicy defaultPolicy;
+  alltoallvPolicy_.maxInflight = env_to_value<int>(
+      "TORCHCOMM_GLOO_ALLTOALLV_MAX_INFLIGHT",
+      static_cast<int>(defaultPolicy.maxInflight));
+  alltoallvPolicy_.chunkBytes = env_to_value<int>(
+      "TORCHCOMM_GLOO_ALLTOALLV_CHUNK_BYTES",
+      static_cast<int>(defaultPolicy.chunkBytes));
+  alltoallvPolicy_.minBytes = env_to_value<int>(
+      "TORCHCOMM_GLOO_ALLTOALLV_MIN_BYTES",
+      static_cast<int>(defaultPolicy.minBytes));
+  if (hints.contains("alltoallv_max_inflight")) {
+    alltoallvPolicy_.maxInflight =
+        std::stoul(hints.at("alltoallv_max_inflight"));
+  }
+  if (hints.contains("alltoallv_chunk_bytes")) {
+    alltoallvPolicy_.chunkBytes = std::stoull(hints.at("alltoallv_chunk_bytes"));
+  }
+  if (hints.contains("alltoallv_min_bytes")) {
+    alltoallvPolicy_.minBytes = std::stoull(hints.at("alltoallv_min_bytes"));
+  }
+  if (alltoallvPolicy_.maxInflight < 1 || alltoallvPolicy_.chunkBytes < 1) {
+    throw std::runtime_error(
+        "alltoallv_max_inflight and alltoallv_chunk_bytes must be at least 1 for TorchCommGloo");
+  }
+
+  treeMinRanks_ = env_to_value<int>(
+      "TORCHCOMM_GLOO_TREE_MIN_RANKS",
+      static_cast<int>(kDefaultGlooTreeMinRanks));
+  treeMaxBlockBytes_ = env_to_value<int>(
+      "TORCHCOMM_GLOO_TREE_MAX_BLOCK_BYTES",
+      static_cast<int>(kDefaultGlooTreeMaxBlockBytes));
+  if (hints.contains("tree_min_ranks")) {
+    treeMinRanks_ = std::stoul(hints.at("tree_min_ranks"));
+  }
+  if (hints.contains("tree_max_block_bytes")) {
+    treeMaxBlockBytes_ = std::stoull(hints.at("tree_max_block_bytes"));
+  }
+
+  stagingChunkBytes_ = env_to_value<size_t>(
+      "TORCHCOMM_GLOO_STAGING_CHUNK_BYTES", kDefaultGlooStagingChunkBytes);
+  stagingDepth_ = env_to_value<int>(
+      "TORCHCOMM_GLOO_STAGING_DEPTH",
+      static_cast<int>(kDefaultGlooStagingDepth));
+  if (hints.contains("staging_chunk_bytes")) {
+    stagingChunkBytes_ = std::stoull(hints.at("staging_chunk_bytes"));
+  }
+  if (hints.contains("staging_depth")) {
+    stagingDepth_ = std::stoul(hints.at("staging_depth"));
+  }
+  if (stagingDepth_ == 0) {
+    throw std::runtime_error(
+        "staging_depth must be at least 1 for TorchCommGloo");
+  }
+  stagingEngines_ = std::make_shared<StagingEnginePool>();
 
   auto store = options.store;
   if (!store) {
@@ -337,8 +1048,64 @@ void TorchCommGloo::init(
         initCount == 1, "detected multiple communicators on same store!");
   }
 
-  auto connectStore = std::make_shared<GlooStore>(store);
-  context->connectFullMesh(connectStore, gloo_device);
+  // Contexts connect over a bootstrap context when there is one, unless the
+  // "rendezvous" hint is "store". Then the store is only the seed of the
+  // first communicator; tag is unique among the bootstraps over bootstrap.
+  auto connect = [&](const std::shared_ptr<gloo::Context>& bootstrap,
+                     const std::vector<int>& bootstrapRanks,
+                     uint32_t tag,
+                     c10::intrusive_ptr<c10d::Store> connectStore) {
+    std::shared_ptr<gloo::Context> context;
+    if (bootstrap && rendezvous == "bootstrap") {
+      auto bootstrapContext =
+          std::make_shared<BootstrapContext>(rank_, comm_size_);
+      bootstrapContext->setTimeout(options.timeout);
+      bootstrapContext->connectFullMesh(
+          createDevice(), bootstrap, bootstrapRanks, tag);
+      context = std::move(bootstrapContext);
+    } else {
+      auto storeContext =
+          std::make_shared<::gloo::rendezvous::Context>(rank_, comm_size_);
+      storeContext->setTimeout(options.timeout);
+      storeContext->connectFullMesh(
+          std::make_shared<GlooStore>(std::move(connectStore)),
+          createDevice());
+      context = std::move(storeContext);
+    }
+    return context;
+  };
+
+  std::shared_ptr<gloo::Context> context;
+  if (meshRendezvous_) {
+    auto meshContext = std::make_shared<MeshContext>(rank_, comm_size_);
+    meshContext->setTimeout(options.timeout);
+    meshContext->connectFullMesh(createDevice(), *meshRendezvous_, meshDim_);
+    context = std::move(meshContext);
+    meshRendezvous_.reset();
+  } else {
+    context = connect(bootstrapContext_, bootstrapRanks_, bootstrapTag_, store);
+  }
+  bootstrapContext_.reset();
+  bootstrapRanks_.clear();
+
+  // Each extra stripe gets its own device, i.e. its own event loop, and its
+  // own connections to every peer. They bootstrap over the first one.
+  std::vector<int> identity(comm_size_);
+  for (int r = 0; r < comm_size_; r++) {
+    identity[r] = r;
+  }
+  stripeContexts_ = {context};
+  for (size_t i = 1; i < numStripes; i++) {
+    auto stripeName = fmt::format("stripe_{}", i);
+    stripeContexts_.push_back(connect(
+        context,
+        identity,
+        nextBootstrapTag(),
+        c10::make_intrusive<c10d::PrefixStore>(stripeName, store)));
+  }
+  if (numStripes > 1) {
+    stripeWorkers_ = std::make_shared<StripeWorkers>();
+  }
 
   context_ = std::move(context);
   store_ = std::move(store);
@@ -346,7 +1113,8 @@ void TorchCommGloo::init(
   tracing_ = std::make_shared<TorchCommTracing>(name, comm_size_, rank_);
   tracing_->recordEvent("init");
 
-  TC_LOG(INFO) << "TorchCommGloo initialized for rank: " << rank_;
+  TC_LOG(INFO) << "TorchCommGloo initialized for rank: " << rank_
+               << " with " << numStripes << " stripes";
 }
 
 void TorchCommGloo::finalize() {
@@ -381,7 +1149,26 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::createWork(
   }
 
   fn();
-  return c10::make_intrusive<TorchWorkCompleted>();
+  // Completed work has no state, so all synchronous ops share one.
+  static const c10::intrusive_ptr<TorchWork> completed =
+      c10::make_intrusive<TorchWorkCompleted>();
+  return completed;
+}
+
+std::shared_ptr<StagingCopyEngine> TorchCommGloo::acquireStagingEngine(
+    const at::Tensor& tensor) {
+#ifdef TORCHCOMMS_GLOO_CUDA
+  // A chunk size of 0 disables staging
+  if (tensor.is_cuda() && stagingChunkBytes_ > 0 &&
+      tensor.nbytes() > stagingChunkBytes_) {
+    const int device = tensor.device().index();
+    return stagingEngines_->acquire(device, [&]() {
+      return std::make_unique<CudaStagingCopyEngine>(
+          cuda_api_.get(), device, stagingDepth_, stagingChunkBytes_);
+    });
+  }
+#endif
+  return nullptr;
 }
 
 // Point-to-Point Operations
@@ -521,6 +1308,37 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::broadcast(
 
   tracing_->recordEventWithInputOutput("broadcast", root, {tensor}, {tensor});
 
+  if (auto staging = acquireStagingEngine(tensor)) {
+    return createWork(
+        [tensor,
+         staging,
+         root,
+         isRoot = root == rank_,
+         options,
+         workers = stripeWorkers_,
+         contexts = stripeContexts_,
+         stripeMinBytes = stripeMinBytes_,
+         tag = nextTag()]() mutable {
+          // Only the root's chunks go to the host, and only the others' back
+          stageTensor(
+              *staging, tensor, isRoot, !isRoot, [&](at::Tensor& chunk) {
+                broadcastTensor(
+                    workers.get(),
+                    contexts,
+                    planStripes(
+                        chunk.numel(),
+                        chunk.element_size(),
+                        contexts.size(),
+                        stripeMinBytes),
+                    root,
+                    tag,
+                    options.timeout,
+                    chunk);
+              });
+        },
+        async_op);
+  }
+
   // This will synchronize the stream.
   auto tensorCPU = tensor.to(at::kCPU);
 
@@ -529,18 +1347,18 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::broadcast(
        tensorCPU,
        root,
        options,
-       context = context_,
+       workers = stripeWorkers_,
+       contexts = stripeContexts_,
+       stripes = getStripes(tensorCPU.numel(), tensorCPU),
        tag = nextTag()]() mutable {
-        gloo::BroadcastOptions opts(context);
-        const auto& scalarType = tensor.scalar_type();
-        opts.setRoot(root);
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensorCPU);
-
-        gloo::broadcast(opts);
+        broadcastTensor(
+            workers.get(),
+            contexts,
+            stripes,
+            root,
+            tag,
+            options.timeout,
+            tensorCPU);
 
         if (tensorCPU.device() != tensor.device()) {
           // This will block the CPU thread so we don't need to synchronize the
@@ -562,6 +1380,36 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_reduce(
 
   tracing_->recordEventWithInputOutput("all_reduce", rank_, {tensor}, {tensor});
 
+  if (auto staging = acquireStagingEngine(tensor)) {
+    return createWork(
+        [tensor,
+         staging,
+         op,
+         options,
+         workers = stripeWorkers_,
+         contexts = stripeContexts_,
+         stripeMinBytes = stripeMinBytes_,
+         tag = nextTag()]() mutable {
+          // Chunks are striped like whole tensors. All ranks stage the same
+          // chunks, so they agree on the stripes of each.
+          stageTensor(*staging, tensor, true, true, [&](at::Tensor& chunk) {
+            allreduceTensor(
+                workers.get(),
+                contexts,
+                planStripes(
+                    chunk.numel(),
+                    chunk.element_size(),
+                    contexts.size(),
+                    stripeMinBytes),
+                op,
+                tag,
+                options.timeout,
+                chunk);
+          });
+        },
+        async_op);
+  }
+
   // This will synchronize the stream.
   auto tensorCPU = tensor.to(at::kCPU);
 
@@ -570,20 +1418,18 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_reduce(
        tensorCPU,
        op,
        options,
-       context = context_,
+       workers = stripeWorkers_,
+       contexts = stripeContexts_,
+       stripes = getStripes(tensorCPU.numel(), tensorCPU),
        tag = nextTag()]() mutable {
-        gloo::AllreduceOptions opts(context);
-        const auto& scalarType = tensor.scalar_type();
-        opts.setReduceFunction(getFunction(scalarType, op));
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensorCPU);
-
-        preReduce(tensorCPU, op);
-        gloo::allreduce(opts);
-        postReduce(tensorCPU, op);
+        allreduceTensor(
+            workers.get(),
+            contexts,
+            stripes,
+            op,
+            tag,
+            options.timeout,
+            tensorCPU);
 
         if (tensorCPU.device() != tensor.device()) {
           // This will block the CPU thread so we don't need to synchronize the
@@ -594,6 +1440,88 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_reduce(
       async_op);
 }
 
+c10::intrusive_ptr<TorchWork> TorchCommGloo::all_reduce_sparse_block(
+    at::Tensor& output,
+    const at::Tensor& input,
+    const at::Tensor& indices,
+    int64_t block_length,
+    const ReduceOp& op,
+    bool async_op,
+    const AllReduceSparseBlockOptions& options) {
+  checkInitialized();
+  checkAndAbortIfTimedOutOrError();
+  ensureTensorContiguous(output);
+  ensureTensorContiguous(input);
+  ensureTensorContiguous(indices);
+
+  if (block_length <= 0 || output.numel() % block_length != 0) {
+    throw std::runtime_error(
+        "Output tensor size must be a multiple of block_length for all_reduce_sparse_block");
+  }
+  if (indices.scalar_type() != at::kLong || indices.dim() != 1) {
+    throw std::runtime_error(
+        "indices must be a 1-D int64 tensor for all_reduce_sparse_block");
+  }
+  if (input.numel() != indices.numel() * block_length) {
+    throw std::runtime_error(
+        "Input tensor size must be indices size * block_length for all_reduce_sparse_block");
+  }
+  if (input.scalar_type() != output.scalar_type()) {
+    throw std::runtime_error(
+        "Input and output tensors must have the same dtype for all_reduce_sparse_block");
+  }
+  if (op.type() == ReduceOp::RedOpType::AVG ||
+      op.type() == ReduceOp::RedOpType::PREMUL_SUM) {
+    throw std::runtime_error(
+        "AVG and PREMUL_SUM are not supported for all_reduce_sparse_block");
+  }
+
+  tracing_->recordEventWithInputOutput(
+      "all_reduce_sparse_block", rank_, {input}, {output});
+
+  // This will synchronize the stream.
+  auto indicesCPU = indices.to(at::kCPU);
+  auto inputCPU = input.to(at::kCPU);
+  auto outputCPU = output.to(at::kCPU);
+
+  checkSparseBlockIndices(
+      getDataPointer<int64_t>(indicesCPU),
+      indicesCPU.numel(),
+      output.numel() / block_length);
+
+  return createWork(
+      [output,
+       inputCPU,
+       indicesCPU,
+       outputCPU,
+       block_length,
+       op,
+       options,
+       context = context_,
+       tag = nextTag()]() mutable {
+        const auto& scalarType = output.scalar_type();
+        GENERATE_ALL_TYPES(
+            scalarType,
+            runSparseBlockAllreduce,
+            context,
+            tag,
+            options.timeout,
+            op,
+            indicesCPU,
+            inputCPU,
+            block_length,
+            options.dense_threshold,
+            outputCPU);
+
+        if (outputCPU.device() != output.device()) {
+          // This will block the CPU thread so we don't need to synchronize the
+          // streams.
+          output.copy_(outputCPU);
+        }
+      },
+      async_op);
+}
+
 c10::intrusive_ptr<TorchWork> TorchCommGloo::reduce(
     const at::Tensor& tensor,
     int root,
@@ -683,23 +1611,37 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_gather(
        options,
        size = comm_size_,
        context = context_,
+       contexts = stripeContexts_,
+       stripes = getStripes(tensorCPU.numel(), tensorCPU),
        tag = nextTag()]() mutable {
-        gloo::AllgatherOptions opts(context);
-        const auto& scalarType = tensor.scalar_type();
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
-
         // Create concatenated output buffer
         auto totalElements = tensorCPU.numel() * size;
         auto concatOutput = at::empty({totalElements}, tensorCPU.options());
 
-        // Use type dispatch to set input and output
-        GENERATE_ALL_TYPES(scalarType, setInput, opts, tensorCPU);
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, concatOutput);
+        if (stripes.size() > 1) {
+          stripedExchange(
+              contexts,
+              stripes,
+              tag,
+              options.timeout,
+              tensorCPU,
+              0,
+              concatOutput,
+              tensorCPU.nbytes());
+        } else {
+          gloo::AllgatherOptions opts(context);
+          const auto& scalarType = tensor.scalar_type();
+          opts.setTag(tag);
+          if (options.timeout != kNoTimeout) {
+            opts.setTimeout(options.timeout);
+          }
 
-        gloo::allgather(opts);
+          // Use type dispatch to set input and output
+          GENERATE_ALL_TYPES(scalarType, setInput, opts, tensorCPU);
+          GENERATE_ALL_TYPES(scalarType, setOutput, opts, concatOutput);
+
+          gloo::allgather(opts);
+        }
 
         // Split concatenated output back to individual tensors
         auto chunkSize = tensorCPU.numel();
@@ -756,19 +1698,33 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_gather_single(
        outputCPU,
        options,
        context = context_,
+       contexts = stripeContexts_,
+       stripes = getStripes(inputCPU.numel(), inputCPU),
        tag = nextTag()]() mutable {
-        gloo::AllgatherOptions opts(context);
-        const auto& scalarType = input.scalar_type();
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
+        if (stripes.size() > 1) {
+          stripedExchange(
+              contexts,
+              stripes,
+              tag,
+              options.timeout,
+              inputCPU,
+              0,
+              outputCPU,
+              inputCPU.nbytes());
+        } else {
+          gloo::AllgatherOptions opts(context);
+          const auto& scalarType = input.scalar_type();
+          opts.setTag(tag);
+          if (options.timeout != kNoTimeout) {
+            opts.setTimeout(options.timeout);
+          }
 
-        // Use type dispatch to set input and output
-        GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputCPU);
+          // Use type dispatch to set input and output
+          GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
+          GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputCPU);
 
-        gloo::allgather(opts);
+          gloo::allgather(opts);
+        }
 
         if (outputCPU.device() != output.device()) {
           // This will block the CPU thread so we don't need to synchronize the
@@ -919,19 +1875,38 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_to_all_single(
        outputCPU,
        options,
        context = context_,
+       contexts = stripeContexts_,
+       stripes = getStripes(inputCPU.numel() / comm_size_, inputCPU),
+       policy = alltoallvPolicy_,
        tag = nextTag()]() mutable {
-        gloo::AlltoallOptions opts(context);
-        const auto& scalarType = input.scalar_type();
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
+        if (stripes.size() > 1) {
+          stripedExchange(
+              contexts,
+              stripes,
+              tag,
+              options.timeout,
+              inputCPU,
+              inputCPU.nbytes() / context->size,
+              outputCPU,
+              outputCPU.nbytes() / context->size);
+        } else if (inputCPU.nbytes() >= policy.minBytes) {
+          // Equal sizes on all ranks, so all ranks take the same branch
+          scheduledAlltoall(
+              context, policy, tag, options.timeout, inputCPU, outputCPU);
+        } else {
+          gloo::AlltoallOptions opts(context);
+          const auto& scalarType = input.scalar_type();
+          opts.setTag(tag);
+          if (options.timeout != kNoTimeout) {
+            opts.setTimeout(options.timeout);
+          }
 
-        // Use type dispatch to set input and output
-        GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputCPU);
+          // Use type dispatch to set input and output
+          GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
+          GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputCPU);
 
-        gloo::alltoall(opts);
+          gloo::alltoall(opts);
+        }
 
         if (outputCPU.device() != output.device()) {
           // This will block the CPU thread so we don't need to synchronize the
@@ -990,45 +1965,47 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_to_all_v_single(
   auto inputCPU = input.to(at::kCPU);
   auto outputCPU = output.to(at::kCPU);
 
+  // Byte offsets and sizes of the dim 0 splits
+  const size_t rowBytes = input.size(0) > 0
+      ? input.nbytes() / input.size(0)
+      : (output.size(0) > 0 ? output.nbytes() / output.size(0) : 0);
+  std::vector<size_t> sendOffsets(comm_size_), sendBytes(comm_size_);
+  std::vector<size_t> recvOffsets(comm_size_), recvBytes(comm_size_);
+  size_t sendOffset = 0, recvOffset = 0;
+  for (int i = 0; i < comm_size_; ++i) {
+    sendOffsets[i] = sendOffset;
+    sendBytes[i] = input_split_sizes[i] * rowBytes;
+    sendOffset += sendBytes[i];
+    recvOffsets[i] = recvOffset;
+    recvBytes[i] = output_split_sizes[i] * rowBytes;
+    recvOffset += recvBytes[i];
+  }
+
   return createWork(
-      [input,
-       output,
+      [output,
        inputCPU,
        outputCPU,
-       input_split_sizes,
-       output_split_sizes,
+       sendOffsets = std::move(sendOffsets),
+       sendBytes = std::move(sendBytes),
+       recvOffsets = std::move(recvOffsets),
+       recvBytes = std::move(recvBytes),
        options,
        context = context_,
+       policy = alltoallvPolicy_,
        tag = nextTag()]() mutable {
-        gloo::AlltoallvOptions opts(context);
-        const auto& scalarType = input.scalar_type();
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
-
-        // Convert split sizes to int64_t vectors for Gloo API
-        std::vector<int64_t> inputElements, outputElements;
-        inputElements.reserve(input_split_sizes.size());
-        outputElements.reserve(output_split_sizes.size());
-
-        // Calculate number of elements in each dim 0 chunk.
-        auto dim0Numel =
-            input.numel() / std::max(input.size(0), static_cast<int64_t>(1));
-        for (auto size : input_split_sizes) {
-          inputElements.push_back(static_cast<int64_t>(size) * dim0Numel);
-        }
-        for (auto size : output_split_sizes) {
-          outputElements.push_back(static_cast<int64_t>(size) * dim0Numel);
-        }
-
-        // Use type dispatch to set input and output with split sizes
-        GENERATE_ALL_TYPES(
-            scalarType, setAlltoallvInput, opts, inputCPU, inputElements);
-        GENERATE_ALL_TYPES(
-            scalarType, setAlltoallvOutput, opts, outputCPU, outputElements);
-
-        gloo::alltoallv(opts);
+        // Always scheduled: whether a rank bounds its window depends on its
+        // own splits only, and either way the transfers match its peers'.
+        scheduledAlltoallv(
+            context,
+            policy,
+            tag,
+            options.timeout,
+            inputCPU,
+            sendOffsets,
+            sendBytes,
+            outputCPU,
+            recvOffsets,
+            recvBytes);
 
         if (outputCPU.device() != output.device()) {
           // This will block the CPU thread so we don't need to synchronize the
@@ -1098,19 +2075,43 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::all_to_all(
        comm_size = comm_size_,
        options,
        context = context_,
+       contexts = stripeContexts_,
+       stripes = getStripes(tensorSize, inputConcatCPU),
+       policy = alltoallvPolicy_,
        tag = nextTag()]() mutable {
-        gloo::AlltoallOptions opts(context);
-        const auto& scalarType = inputConcatCPU.scalar_type();
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
+        if (stripes.size() > 1) {
+          const size_t blockBytes = tensorSize * inputConcatCPU.element_size();
+          stripedExchange(
+              contexts,
+              stripes,
+              tag,
+              options.timeout,
+              inputConcatCPU,
+              blockBytes,
+              outputConcatCPU,
+              blockBytes);
+        } else if (inputConcatCPU.nbytes() >= policy.minBytes) {
+          scheduledAlltoall(
+              context,
+              policy,
+              tag,
+              options.timeout,
+              inputConcatCPU,
+              outputConcatCPU);
+        } else {
+          gloo::AlltoallOptions opts(context);
+          const auto& scalarType = inputConcatCPU.scalar_type();
+          opts.setTag(tag);
+          if (options.timeout != kNoTimeout) {
+            opts.setTimeout(options.timeout);
+          }
 
-        // Use type dispatch to set input and output
-        GENERATE_ALL_TYPES(scalarType, setInput, opts, inputConcatCPU);
-        GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputConcatCPU);
+          // Use type dispatch to set input and output
+          GENERATE_ALL_TYPES(scalarType, setInput, opts, inputConcatCPU);
+          GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputConcatCPU);
 
-        gloo::alltoall(opts);
+          gloo::alltoall(opts);
+        }
 
         // Copy results back to individual output tensors
         for (int i = 0; i < comm_size; ++i) {
@@ -1191,7 +2192,23 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::scatter(
        options,
        rank = rank_,
        context = context_,
+       tree = useTree(outputCPU),
        tag = nextTag()]() mutable {
+        if (tree) {
+          treeScatter(
+              context,
+              tag,
+              options.timeout,
+              root,
+              outputCPU.nbytes(),
+              inputListCPU,
+              outputCPU);
+          if (outputCPU.device() != output_tensor.device()) {
+            output_tensor.copy_(outputCPU);
+          }
+          return;
+        }
+
         gloo::ScatterOptions opts(context);
         const auto& scalarType = output_tensor.scalar_type();
         opts.setRoot(root);
@@ -1251,13 +2268,17 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::gather(
   // Convert tensors to CPU
   auto inputCPU = input_tensor.to(at::kCPU);
 
+  const bool tree = useTree(inputCPU);
+
   // Only root rank needs to prepare output
   at::Tensor outputConcatCPU;
   std::vector<at::Tensor> outputListCPU;
   if (rank_ == root) {
-    // Create concatenated output buffer
-    auto totalElements = input_tensor.numel() * comm_size_;
-    outputConcatCPU = at::empty({totalElements}, inputCPU.options());
+    // Create concatenated output buffer; the tree stages its own
+    if (!tree) {
+      auto totalElements = input_tensor.numel() * comm_size_;
+      outputConcatCPU = at::empty({totalElements}, inputCPU.options());
+    }
 
     // Also convert individual output tensors to CPU for final copy
     outputListCPU.reserve(output_tensor_list.size());
@@ -1277,35 +2298,50 @@ c10::intrusive_ptr<TorchWork> TorchCommGloo::gather(
        rank = rank_,
        size = comm_size_,
        context = context_,
+       tree,
        tag = nextTag()]() mutable {
-        gloo::GatherOptions opts(context);
-        const auto& scalarType = input_tensor.scalar_type();
-        opts.setRoot(root);
-        opts.setTag(tag);
-        if (options.timeout != kNoTimeout) {
-          opts.setTimeout(options.timeout);
-        }
+        if (tree) {
+          // Writes the root's output tensors directly
+          treeGather(
+              context,
+              tag,
+              options.timeout,
+              root,
+              inputCPU.nbytes(),
+              inputCPU,
+              outputListCPU);
+        } else {
+          gloo::GatherOptions opts(context);
+          const auto& scalarType = input_tensor.scalar_type();
+          opts.setRoot(root);
+          opts.setTag(tag);
+          if (options.timeout != kNoTimeout) {
+            opts.setTimeout(options.timeout);
+          }
 
-        // All ranks set input
-        GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
+          // All ranks set input
+          GENERATE_ALL_TYPES(scalarType, setInput, opts, inputCPU);
 
-        // Only root sets output
-        if (rank == root) {
-          GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputConcatCPU);
-        }
+          // Only root sets output
+          if (rank == root) {
+            GENERATE_ALL_TYPES(scalarType, setOutput, opts, outputConcatCPU);
+          }
 
-        gloo::gather(opts);
+          gloo::gather(opts);
 
-        // Root rank splits concatenated output back to individual tensors
-        if (rank == root) {
-          auto chunkSize = inputCPU.numel();
-          for (int i = 0; i < size; ++i) {
-            auto start = i * chunkSize;
-            auto chunk = outputConcatCPU.narrow(0, start, chunkSize);
-            outputListCPU[i].copy_(chunk);
+          // Root rank splits concatenated output back to individual tensors
+          if (rank == root) {
+            auto chunkSize = inputCPU.numel();
+            for (int i = 0; i < size; ++i) {
+              auto start = i * chunkSize;
+              auto chunk = outputConcatCPU.narrow(0, start, chunkSize);
+              outputListCPU[i].copy_(chunk);
+            }
           }
+        }
 
-          // Copy results back to original device if needed
+        // Copy results back to original device if needed
+        if (rank == root) {
           for (size_t i = 0; i < outputListCPU.size(); ++i) {
             if (outputListCPU[i].device() != output_tensor_list[i].device()) {
               output_tensor_list[i].copy_(outputListCPU[i]);
@@ -1320,6 +2356,10 @@ std::shared_ptr<TorchCommBackend> TorchCommGloo::split(
     const std::vector<int>& ranks,
     const std::string& name,
     const CommOptions& options) {
+  // Every rank takes the next tag, including ranks left out of the split, so
+  // the parent's counter stays in step on all of them.
+  const uint32_t tag = nextBootstrapTag();
+
   // Validate that all ranks are valid
   for (int rank : ranks) {
     if (rank < 0 || rank >= comm_size_) {
@@ -1349,6 +2389,64 @@ std::shared_ptr<TorchCommBackend> TorchCommGloo::split(
         " is not included in the provided ranks list");
   }
 
+  return createSubComm(ranks, name, options, tag);
+}
+
+std::vector<std::shared_ptr<TorchCommBackend>> TorchCommGloo::split_mesh(
+    const std::vector<int>& shape,
+    const std::vector<std::string>& dim_names,
+    const CommOptions& options) {
+  checkInitialized();
+  auto groups = mesh_group_ranks(shape, dim_names, rank_, comm_size_);
+  auto mesh = std::make_shared<MeshRendezvous>(
+      c10::make_intrusive<c10d::PrefixStore>(
+          fmt::format("split_mesh_{}", nextBootstrapTag()), store_),
+      rank_,
+      groups,
+      options.timeout);
+
+  // The dimensions only share the rendezvous, which runs no I/O over this
+  // communicator's context, so they connect and initialize concurrently.
+  std::vector<std::future<std::shared_ptr<TorchCommBackend>>> futures;
+  futures.reserve(groups.size());
+  for (size_t d = 0; d < groups.size(); d++) {
+    futures.push_back(std::async(std::launch::async, [&, d]() {
+      try {
+        return std::shared_ptr<TorchCommBackend>(
+            createSubComm(groups[d], dim_names[d], options, 0, mesh, d));
+      } catch (...) {
+        mesh->abort();
+        throw;
+      }
+    }));
+  }
+
+  std::vector<std::shared_ptr<TorchCommBackend>> comms;
+  comms.reserve(futures.size());
+  std::exception_ptr error;
+  for (auto& future : futures) {
+    try {
+      comms.push_back(future.get());
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return comms;
+}
+
+std::shared_ptr<TorchCommGloo> TorchCommGloo::createSubComm(
+    const std::vector<int>& ranks,
+    const std::string& name,
+    const CommOptions& options,
+    uint32_t bootstrapTag,
+    std::shared_ptr<MeshRendezvous> mesh,
+    size_t meshDim) {
+  auto it = std::find(ranks.begin(), ranks.end(), rank_);
   auto new_torchcomm = std::make_shared<TorchCommGloo>();
 
   // Set color to the lowest rank in the group and calculate new rank
@@ -1364,6 +2462,14 @@ std::shared_ptr<TorchCommBackend> TorchCommGloo::split(
 
   CommOptions new_options = options;
   new_options.store = new_store;
+  if (mesh) {
+    new_torchcomm->meshRendezvous_ = std::move(mesh);
+    new_torchcomm->meshDim_ = meshDim;
+  } else {
+    new_torchcomm->bootstrapContext_ = context_;
+    new_torchcomm->bootstrapRanks_ = ranks;
+    new_torchcomm->bootstrapTag_ = bootstrapTag;
+  }
 
   new_torchcomm->init(device_, new_name, new_options);
 
@@ -21,11 +21,21 @@
 #include "comms/torchcomms/TorchCommBackend.hpp"
 #include "comms/torchcomms/TorchCommBatch.hpp"
 #include "comms/torchcomms/TorchCommTracing.hpp"
+#include "comms/torchcomms/gloo/GlooAlltoallvSchedule.hpp"
+#include "comms/torchcomms/gloo/GlooStaging.hpp"
+#include "comms/torchcomms/gloo/GlooStriping.hpp"
+#include "comms/torchcomms/gloo/GlooTree.hpp"
 #include "comms/torchcomms/gloo/TorchWorkGloo.hpp"
 
+#ifdef TORCHCOMMS_GLOO_CUDA
+#include "comms/torchcomms/device/CudaApi.hpp"
+#endif
+
 namespace torch {
 namespace comms {
 
+class MeshRendezvous;
+
 class TorchCommGloo : public TorchCommBackend,
                       public std::enable_shared_from_this<TorchCommGloo> {
  public:
@@ -79,6 +89,14 @@ class TorchCommGloo : public TorchCommBackend,
       const ReduceOp& op,
       bool async_op,
       const AllReduceOptions& options = {}) override;
+  c10::intrusive_ptr<TorchWork> all_reduce_sparse_block(
+      at::Tensor& output,
+      const at::Tensor& input,
+      const at::Tensor& indices,
+      int64_t block_length,
+      const ReduceOp& op,
+      bool async_op,
+      const AllReduceSparseBlockOptions& options = {}) override;
   c10::intrusive_ptr<TorchWork> reduce(
       const at::Tensor& tensor,
       int root,
@@ -158,10 +176,21 @@ class TorchCommGloo : public TorchCommBackend,
       const std::vector<int>& ranks,
       const std::string& name,
       const CommOptions& options = {}) override;
+  std::vector<std::shared_ptr<TorchCommBackend>> split_mesh(
+      const std::vector<int>& shape,
+      const std::vector<std::string>& dim_names,
+      const CommOptions& options = {}) override;
 
   // Friend access for TorchWorkGloo
   friend class TorchWorkGloo;
 
+#ifdef TORCHCOMMS_GLOO_CUDA
+  // Method to override the CUDA API implementation for testing
+  void setCudaApi(std::shared_ptr<CudaApi> api) {
+    cuda_api_ = std::move(api);
+  }
+#endif
+
   const CommOptions& getOptions() const override {
     return options_;
   }
@@ -186,6 +215,17 @@ class TorchCommGloo : public TorchCommBackend,
       std::function<void()> fn,
       bool async_op);
 
+  // Create the communicator of ranks, which must contain this rank. It
+  // bootstraps over this communicator's context with bootstrapTag, or, with
+  // mesh, connects as dimension meshDim of a split_mesh.
+  std::shared_ptr<TorchCommGloo> createSubComm(
+      const std::vector<int>& ranks,
+      const std::string& name,
+      const CommOptions& options,
+      uint32_t bootstrapTag,
+      std::shared_ptr<MeshRendezvous> mesh = nullptr,
+      size_t meshDim = 0);
+
   void checkInitialized();
   void checkAndAbortIfTimedOutOrError();
 
@@ -193,6 +233,32 @@ class TorchCommGloo : public TorchCommBackend,
     return collectiveCounter_++;
   }
 
+  // Tag of the next bootstrap over this communicator's first context: one
+  // per extra stripe in init(), then one per split() or split_mesh() call.
+  // Every rank calls them in the same order, so all ranks agree on each tag.
+  uint32_t nextBootstrapTag() {
+    return bootstrapCounter_++;
+  }
+
+  // Whether scatter and gather of tensor sized blocks use a binomial tree
+  bool useTree(const at::Tensor& tensor) const {
+    return useBinomialTree(
+        comm_size_, tensor.nbytes(), treeMinRanks_, treeMaxBlockBytes_);
+  }
+
+  // Copy engine staging tensor through host memory in chunks, or nullptr if
+  // it is copied to the CPU in one go. Taken from stagingEngines_ and begun
+  // on the calling thread; the collective owns it until released.
+  std::shared_ptr<StagingCopyEngine> acquireStagingEngine(
+      const at::Tensor& tensor);
+
+  // Stripes of a collective exchanging count elements of tensor's dtype
+  std::vector<StripeRange> getStripes(size_t count, const at::Tensor& tensor)
+      const {
+    return planStripes(
+        count, tensor.element_size(), stripeContexts_.size(), stripeMinBytes_);
+  }
+
  private:
   // Member variables
   at::Device device_;
@@ -211,6 +277,44 @@ class TorchCommGloo : public TorchCommBackend,
   c10::intrusive_ptr<c10d::Store> store_;
   std::shared_ptr<gloo::Context> context_;
 
+  // Contexts large collectives are striped across; the first one is context_.
+  // Configured with the "stripes" and "stripe_min_bytes" hints.
+  std::vector<std::shared_ptr<gloo::Context>> stripeContexts_;
+  size_t stripeMinBytes_{0};
+  // Threads running all but the first stripe of striped collectives, shared
+  // with their works. Only set with more than one stripe.
+  std::shared_ptr<StripeWorkers> stripeWorkers_;
+
+  // Schedule of all_to_all_v_single, and of all_to_all(_single) above
+  // minBytes. Configured with the "alltoallv_*" hints.
+  AlltoallvSchedulePolicy alltoallvPolicy_;
+
+  // scatter and gather use binomial trees from treeMinRanks_ ranks, for
+  // blocks of at most treeMaxBlockBytes_. Configured with the "tree_*" hints.
+  size_t treeMinRanks_{0};
+  size_t treeMaxBlockBytes_{0};
+
+  // CUDA tensors above stagingChunkBytes_ are pipelined through
+  // stagingDepth_ pinned host chunks. Configured with the "staging_*" hints.
+  size_t stagingChunkBytes_{0};
+  size_t stagingDepth_{0};
+  std::shared_ptr<StagingEnginePool> stagingEngines_;
+#ifdef TORCHCOMMS_GLOO_CUDA
+  std::shared_ptr<CudaApi> cuda_api_;
+#endif
+
+  // Set by createSubComm: the parent's context, over which init connects
+  // instead of through the store, the parent rank of each rank, and the tag
+  // the parent allocated for that exchange.
+  std::shared_ptr<gloo::Context> bootstrapContext_;
+  std::vector<int> bootstrapRanks_;
+  uint32_t bootstrapTag_{0};
+  uint32_t bootstrapCounter_{0};
+  // Set by split_mesh instead: the rendezvous of all of its dimensions, of
+  // which this communicator is dimension meshDim_.
+  std::shared_ptr<MeshRendezvous> meshRendezvous_;
+  size_t meshDim_{0};
+
   uint32_t collectiveCounter_{0};
 };
 
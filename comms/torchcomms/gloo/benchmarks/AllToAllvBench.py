@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Throughput of all_to_all_v_single on the Gloo backend for uniform and skewed
+split distributions, across pairwise schedule settings (rounds in flight and
+chunk size, see GlooAlltoallvSchedule.hpp).
+
+Run with one process per rank, e.g.:
+
+    torchrun --nnodes 1 --nproc_per_node 8 AllToAllvBench.py
+
+The splits are generated from a seed shared by all ranks, so every rank's
+output splits match its peers' input splits.
+"""
+
+import argparse
+import time
+
+import torch
+from torchcomms import new_comm
+
+
+def split_matrix(dist, world_size, total_rows, seed):
+    """rows[src][dst] for a distribution of total_rows rows per source rank."""
+    gen = torch.Generator().manual_seed(seed)
+    if dist == "uniform":
+        weights = torch.ones(world_size, world_size)
+    elif dist == "zipf":
+        # Every source favours a different destination, MoE style
+        ranks = torch.arange(1, world_size + 1, dtype=torch.float64)
+        weights = torch.stack(
+            [
+                (1.0 / ranks[torch.randperm(world_size, generator=gen)]) ** 1.2
+                for _ in range(world_size)
+            ]
+        )
+    elif dist == "hotspot":
+        # All sources send half their rows to rank 0
+        weights = torch.ones(world_size, world_size)
+        weights[:, 0] = world_size - 1
+    else:
+        # Half of the pairs exchange nothing
+        weights = (torch.rand(world_size, world_size, generator=gen) > 0.5).double()
+        weights += torch.eye(world_size)
+    weights = weights / weights.sum(dim=1, keepdim=True)
+    rows = (weights * total_rows).floor().long()
+    rows[:, 0] += total_rows - rows.sum(dim=1)
+    return rows
+
+
+def bench(comm, rows, row_numel, warmup, iters):
+    rank = comm.get_rank()
+    input_splits = rows[rank].tolist()
+    output_splits = rows[:, rank].tolist()
+    input = torch.ones(sum(input_splits), row_numel, dtype=torch.float32)
+    output = torch.empty(sum(output_splits), row_numel, dtype=torch.float32)
+
+    def run():
+        comm.all_to_all_v_single(output, input, output_splits, input_splits, False)
+
+    for _ in range(warmup):
+        run()
+    comm.barrier(False)
+    start = time.perf_counter()
+    for _ in range(iters):
+        run()
+    comm.barrier(False)
+    elapsed = (time.perf_counter() - start) / iters
+    # Bus bandwidth of the slowest rank: the one receiving the most
+    busiest = int(rows.sum(dim=0).max()) * row_numel * 4
+    return elapsed, busiest / elapsed / 1e9
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--dists",
+        nargs="+",
+        default=["uniform", "zipf", "hotspot", "sparse"],
+    )
+    parser.add_argument("--sizes-mb", type=int, nargs="+", default=[1, 16, 128])
+    parser.add_argument(
+        "--max-inflight",
+        type=int,
+        nargs="+",
+        default=[1024, 8, 2],
+        help="rounds in flight; a value >= world size posts everything at once",
+    )
+    parser.add_argument("--chunk-kb", type=int, nargs="+", default=[4096, 256])
+    parser.add_argument("--row-numel", type=int, default=1024)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--warmup", type=int, default=3)
+    parser.add_argument("--iters", type=int, default=10)
+    args = parser.parse_args()
+
+    device = torch.device("cpu")
+    for inflight in args.max_inflight:
+        for chunk_kb in args.chunk_kb:
+            comm = new_comm(
+                "gloo",
+                device,
+                name=f"alltoallv_bench_{inflight}_{chunk_kb}",
+                hints={
+                    "alltoallv_max_inflight": str(inflight),
+                    "alltoallv_chunk_bytes": str(chunk_kb << 10),
+                    # Bound the window at every size measured
+                    "alltoallv_min_bytes": "0",
+                },
+            )
+            world_size = comm.get_size()
+            for dist in args.dists:
+                for size_mb in args.sizes_mb:
+                    total_rows = max((size_mb << 20) // (args.row_numel * 4), 1)
+                    rows = split_matrix(dist, world_size, total_rows, args.seed)
+                    elapsed, gbps = bench(
+                        comm, rows, args.row_numel, args.warmup, args.iters
+                    )
+                    if comm.get_rank() == 0:
+                        print(
+                            f"{dist:>8} size={size_mb:>4}MB/rank "
+                            f"inflight={inflight:<4} chunk={chunk_kb:>5}KB "
+                            f"time={elapsed * 1e3:8.2f}ms "
+                            f"busiest_rank={gbps:.2f}GB/s"
+                        )
+            comm.finalize()
+
+
+if __name__ == "__main__":
+    main()
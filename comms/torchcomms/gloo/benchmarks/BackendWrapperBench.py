@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Per-call overhead of the c10d BackendWrapper on the Gloo backend: latency of
+small collectives issued through a torch.distributed process group versus
+the same collectives called on the TorchComm directly.
+
+Run with one process per rank, e.g.:
+
+    torchrun --nnodes 1 --nproc_per_node 2 BackendWrapperBench.py
+"""
+
+import argparse
+import time
+
+import torch
+import torch.distributed as dist
+from torchcomms import new_comm, ReduceOp
+from torchcomms.device_mesh import _create_torchcomm_process_group
+
+
+def timeit(comm, fn, warmup, iters):
+    for _ in range(warmup):
+        fn()
+    comm.barrier(False)
+    start = time.perf_counter()
+    for _ in range(iters):
+        fn()
+    return (time.perf_counter() - start) / iters * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--numel", type=int, default=1)
+    parser.add_argument("--warmup", type=int, default=100)
+    parser.add_argument("--iters", type=int, default=2000)
+    args = parser.parse_args()
+
+    comm = new_comm("gloo", torch.device("cpu"), name="backend_wrapper_bench")
+    pg = _create_torchcomm_process_group(comm, "backend_wrapper_bench")
+    size = comm.get_size()
+
+    tensor = torch.ones(args.numel)
+    input = torch.ones(args.numel * size)
+    output = torch.empty(args.numel * size)
+    splits = [args.numel] * size
+
+    cases = {
+        "all_reduce": (
+            lambda: comm.all_reduce(tensor, ReduceOp.SUM, False),
+            lambda: dist.all_reduce(tensor, group=pg),
+        ),
+        "all_reduce async": (
+            lambda: comm.all_reduce(tensor, ReduceOp.SUM, True).wait(),
+            lambda: dist.all_reduce(tensor, group=pg, async_op=True).wait(),
+        ),
+        "barrier": (
+            lambda: comm.barrier(False),
+            lambda: dist.barrier(group=pg),
+        ),
+        "all_to_all_v_single": (
+            lambda: comm.all_to_all_v_single(output, input, splits, splits, False),
+            lambda: dist.all_to_all_single(output, input, splits, splits, group=pg),
+        ),
+    }
+
+    for name, (direct, wrapped) in cases.items():
+        direct_us = timeit(comm, direct, args.warmup, args.iters)
+        wrapped_us = timeit(comm, wrapped, args.warmup, args.iters)
+        if comm.get_rank() == 0:
+            print(
+                f"{name:>20} numel={args.numel:<6} direct={direct_us:8.2f}us "
+                f"c10d={wrapped_us:8.2f}us "
+                f"overhead={wrapped_us - direct_us:7.2f}us"
+            )
+
+    comm.finalize()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "comms/torchcomms/gloo/GlooStaging.hpp"
+
+using namespace torch::comms;
+
+namespace {
+
+// Simulated link bandwidths, in bytes per microsecond
+constexpr double kCopyBytesPerUs = 12e3; // PCIe, ~12 GB/s
+constexpr double kNetBytesPerUs = 3e3; // ~25 Gbit/s
+
+// Sleeps rather than spins, so that the copy threads do not compete with
+// the issuing one for cores
+void simulateTransfer(size_t bytes, double bytesPerUs) {
+  const auto ns = static_cast<int64_t>(bytes / bytesPerUs * 1e3);
+  std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+}
+
+// One queue of copies running in order on its own thread, like a stream
+class CopyQueue {
+ public:
+  CopyQueue() : thread_([this] { run(); }) {}
+
+  ~CopyQueue() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  // Returns the copy's sequence number
+  uint64_t push(std::function<void()> copy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(copy));
+    cv_.notify_all();
+    return ++issued_;
+  }
+
+  void waitFor(uint64_t seq) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return done_ >= seq; });
+  }
+
+  void drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return done_ >= issued_; });
+  }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      auto copy = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      copy();
+      lock.lock();
+      done_++;
+      cv_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> queue_;
+  uint64_t issued_{0};
+  uint64_t done_{0};
+  bool stop_{false};
+  std::thread thread_;
+};
+
+// Copy engine over host memory whose copies take as long as over PCIe
+class SimulatedCopyEngine : public StagingCopyEngine {
+ public:
+  SimulatedCopyEngine(size_t numSlots, size_t slotBytes)
+      : slots_(numSlots, std::vector<char>(slotBytes)),
+        lastIn_(numSlots, 0),
+        lastOut_(numSlots, 0) {}
+
+  size_t numSlots() const override {
+    return slots_.size();
+  }
+  size_t slotBytes() const override {
+    return slots_[0].size();
+  }
+  void* slot(size_t i) override {
+    return slots_[i].data();
+  }
+
+  // Nothing is queued ahead of the simulated device's copies
+  void begin() override {}
+
+  void copyToHost(size_t slot, const void* src, size_t bytes) override {
+    auto* dst = slots_[slot].data();
+    const uint64_t after = lastOut_[slot];
+    lastIn_[slot] = toHost_.push([=, this] {
+      toDevice_.waitFor(after);
+      std::memcpy(dst, src, bytes);
+      simulateTransfer(bytes, kCopyBytesPerUs);
+    });
+  }
+  void copyToDevice(void* dst, size_t slot, size_t bytes) override {
+    const auto* src = slots_[slot].data();
+    lastOut_[slot] = toDevice_.push([=] {
+      std::memcpy(dst, src, bytes);
+      simulateTransfer(bytes, kCopyBytesPerUs);
+    });
+  }
+
+  void wait(size_t slot) override {
+    toHost_.waitFor(lastIn_[slot]);
+    toDevice_.waitFor(lastOut_[slot]);
+  }
+  void synchronize() override {
+    toHost_.drain();
+    toDevice_.drain();
+  }
+
+ private:
+  std::vector<std::vector<char>> slots_;
+  std::vector<uint64_t> lastIn_;
+  std::vector<uint64_t> lastOut_;
+  CopyQueue toHost_;
+  CopyQueue toDevice_;
+};
+
+// An all_reduce of a "device" tensor: staged in, reduced over the simulated
+// network, staged back out. A single slot as large as the tensor is the
+// serialized copy, reduce, copy of the unstaged path.
+void BM_StagedAllReduce(benchmark::State& state) {
+  const size_t nbytes = state.range(0);
+  const size_t chunkBytes = state.range(1) ? state.range(1) : nbytes;
+  const size_t numSlots = state.range(1) ? kDefaultGlooStagingDepth : 1;
+  std::vector<char> device(nbytes, 1);
+  SimulatedCopyEngine engine(numSlots, chunkBytes);
+
+  for (auto _ : state) {
+    runStagingPipeline(
+        engine,
+        device.data(),
+        nbytes,
+        sizeof(float),
+        true,
+        true,
+        [](void* host, size_t /*offset*/, size_t bytes) {
+          benchmark::DoNotOptimize(host);
+          simulateTransfer(bytes, kNetBytesPerUs);
+        });
+  }
+  state.SetBytesProcessed(state.iterations() * nbytes);
+}
+
+} // namespace
+
+// {tensor bytes, chunk bytes (0 for unstaged)}
+BENCHMARK(BM_StagedAllReduce)
+    ->ArgsProduct(
+        {{4 << 20, 16 << 20, 64 << 20, 256 << 20},
+         {0, 1 << 20, 4 << 20, 16 << 20}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
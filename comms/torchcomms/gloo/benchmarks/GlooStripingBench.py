@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Throughput of Gloo collectives as a function of the number of stripes, i.e.
+parallel contexts with their own TCP connections per communicator.
+
+Run on loopback with one process per rank, e.g.:
+
+    torchrun --nnodes 1 --nproc_per_node 4 GlooStripingBench.py
+
+Each rank pair is then connected over the loopback interface; on a real
+100/200 Gbit NIC run it across hosts instead.
+"""
+
+import argparse
+import time
+
+import torch
+from torchcomms import new_comm, ReduceOp
+
+
+def bench(comm, op, size_bytes, warmup, iters):
+    world_size = comm.get_size()
+    count = size_bytes // 4
+    count -= count % world_size
+
+    if op == "all_reduce":
+        tensor = torch.ones(count, dtype=torch.float32)
+
+        def run():
+            comm.all_reduce(tensor, ReduceOp.SUM, False)
+
+    elif op == "all_gather_single":
+        input = torch.ones(count // world_size, dtype=torch.float32)
+        output = torch.empty(count, dtype=torch.float32)
+
+        def run():
+            comm.all_gather_single(output, input, False)
+
+    else:
+        input = torch.ones(count, dtype=torch.float32)
+        output = torch.empty(count, dtype=torch.float32)
+
+        def run():
+            comm.all_to_all_single(output, input, False)
+
+    for _ in range(warmup):
+        run()
+    comm.barrier(False)
+    start = time.perf_counter()
+    for _ in range(iters):
+        run()
+    elapsed = (time.perf_counter() - start) / iters
+    return count * 4 / elapsed / 1e9
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--stripes", type=int, nargs="+", default=[1, 2, 4, 8])
+    parser.add_argument(
+        "--sizes-mb", type=int, nargs="+", default=[1, 4, 16, 64, 256]
+    )
+    parser.add_argument(
+        "--ops",
+        nargs="+",
+        default=["all_reduce", "all_gather_single", "all_to_all_single"],
+    )
+    parser.add_argument("--warmup", type=int, default=3)
+    parser.add_argument("--iters", type=int, default=10)
+    args = parser.parse_args()
+
+    device = torch.device("cpu")
+    for stripes in args.stripes:
+        comm = new_comm(
+            "gloo",
+            device,
+            name=f"striping_bench_{stripes}",
+            hints={"stripes": str(stripes)},
+        )
+        for op in args.ops:
+            for size_mb in args.sizes_mb:
+                gbps = bench(comm, op, size_mb << 20, args.warmup, args.iters)
+                if comm.get_rank() == 0:
+                    print(
+                        f"{op:>18} stripes={stripes:<2} size={size_mb:>4}MB "
+                        f"algbw={gbps:.2f}GB/s"
+                    )
+        comm.finalize()
+
+
+if __name__ == "__main__":
+    main()
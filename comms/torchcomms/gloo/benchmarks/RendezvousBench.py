@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Init time of Gloo communicators that rendezvous through the store versus over
+a bootstrap context. The world communicator always connects through the store;
+communicators split from it, and extra stripes, then connect either through
+the store or by exchanging addresses over their parent.
+
+Run with a growing number of CPU ranks, e.g. on one host:
+
+    for n in 8 32 128 512; do
+        torchrun --nnodes 1 --nproc_per_node $n RendezvousBench.py
+    done
+"""
+
+import argparse
+import time
+
+import torch
+from torchcomms import new_comm, ReduceOp
+
+
+def timed(comm, fn):
+    """Time fn up to the slowest rank, the time the job waits on."""
+    comm.barrier(False)
+    start = time.perf_counter()
+    result = fn()
+    elapsed = torch.tensor([time.perf_counter() - start], dtype=torch.float64)
+    comm.all_reduce(elapsed, ReduceOp.MAX, False)
+    return result, elapsed.item() * 1e3
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--iters", type=int, default=5)
+    parser.add_argument("--stripes", type=int, default=4)
+    args = parser.parse_args()
+
+    device = torch.device("cpu")
+    start = time.perf_counter()
+    world = new_comm("gloo", device, name="rendezvous_bench")
+    world_ms = (time.perf_counter() - start) * 1e3
+    rank = world.get_rank()
+    size = world.get_size()
+    if rank == 0:
+        print(f"ranks={size:<5} world init (store)={world_ms:10.1f}ms")
+
+    for mode in ["store", "bootstrap"]:
+        hints = {"rendezvous": mode, "stripes": str(args.stripes)}
+        times = []
+        for i in range(args.iters):
+            comm, ms = timed(
+                world,
+                lambda: world.split(
+                    [list(range(size))], f"rendezvous_{mode}_{i}", hints=hints
+                ),
+            )
+            times.append(ms)
+            comm.finalize()
+        if rank == 0:
+            print(
+                f"ranks={size:<5} split stripes={args.stripes} {mode:>9}: "
+                f"min={min(times):10.1f}ms "
+                f"avg={sum(times) / len(times):10.1f}ms"
+            )
+
+    world.finalize()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,130 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gloo/math.h>
+#include <gloo/rendezvous/context.h>
+#include <gloo/rendezvous/hash_store.h>
+#include <gloo/transport/tcp/device.h>
+
+#include "comms/torchcomms/TorchCommOptions.hpp"
+#include "comms/torchcomms/gloo/SparseBlockAllReduce.hpp"
+
+using namespace torch::comms;
+
+// Density sweep of the block-sparse all_reduce over loopback TCP, one thread
+// per rank. For every fraction of blocks contributed per rank it compares
+// always exchanging (indices, blocks), always reducing the dense tensor, and
+// the default threshold, to locate the sparse/dense crossover.
+
+namespace {
+
+constexpr int kRanks = 4;
+constexpr size_t kNumBlocks = 16384;
+constexpr size_t kBlockLength = 64;
+
+enum Mode { kSparse = 0, kDense = 1, kAuto = 2 };
+
+// Connected contexts, created once and shared by all benchmarks
+class Cluster {
+ public:
+  static Cluster& get() {
+    static Cluster cluster;
+    return cluster;
+  }
+
+  std::shared_ptr<gloo::Context> context(int rank) {
+    return contexts_[rank];
+  }
+
+ private:
+  Cluster() : contexts_(kRanks) {
+    gloo::transport::tcp::attr attr;
+    attr.hostname = "localhost";
+    auto device = gloo::transport::tcp::CreateDevice(attr);
+    auto store = std::make_shared<gloo::rendezvous::HashStore>();
+    std::vector<std::thread> threads;
+    for (int r = 0; r < kRanks; r++) {
+      threads.emplace_back([&, r]() {
+        auto context =
+            std::make_shared<gloo::rendezvous::Context>(r, kRanks);
+        context->connectFullMesh(store, device);
+        contexts_[r] = std::move(context);
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  std::vector<std::shared_ptr<gloo::Context>> contexts_;
+};
+
+// Pick blocks per rank so that ranks overlap as little as the density allows,
+// the worst case for the sparse exchange.
+std::vector<int64_t> makeIndices(int rank, double density) {
+  const size_t count = kNumBlocks * density;
+  std::vector<int64_t> indices(count);
+  for (size_t i = 0; i < count; i++) {
+    indices[i] = (rank * count + i) % kNumBlocks;
+  }
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  return indices;
+}
+
+} // namespace
+
+static void BM_SparseBlockAllreduce(benchmark::State& state) {
+  const int rank = state.thread_index();
+  const double density = state.range(0) / 100.0;
+  const auto mode = static_cast<Mode>(state.range(1));
+  const double threshold = mode == kSparse
+      ? std::numeric_limits<double>::infinity()
+      : mode == kDense ? 0.0
+                       : AllReduceSparseBlockOptions::kDefaultDenseThreshold;
+
+  auto context = Cluster::get().context(rank);
+
+  const auto indices = makeIndices(rank, density);
+  std::vector<float> blocks(indices.size() * kBlockLength, 1.0f);
+  std::vector<float> output(kNumBlocks * kBlockLength);
+
+  size_t denseCalls = 0;
+  for (auto _ : state) {
+    denseCalls += sparseBlockAllreduce<float>(
+        context,
+        0,
+        kNoTimeout,
+        gloo::AllreduceOptions::Func(&gloo::sum<float>),
+        false,
+        indices.data(),
+        indices.size(),
+        blocks.data(),
+        kBlockLength,
+        kNumBlocks,
+        threshold,
+        output.data());
+  }
+  state.counters["dense"] =
+      benchmark::Counter(denseCalls, benchmark::Counter::kAvgIterations);
+  state.SetBytesProcessed(state.iterations() * output.size() * sizeof(float));
+}
+
+BENCHMARK(BM_SparseBlockAllreduce)
+    ->ArgsProduct({{1, 2, 5, 10, 15, 25, 50, 100}, {kSparse, kDense, kAuto}})
+    ->ArgNames({"densityPct", "mode"})
+    ->Threads(kRanks)
+    ->UseRealTime();
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Init time of the communicators of an N-dimensional device mesh on the Gloo
+backend: one split() per dimension, one after another, versus a single
+split_mesh(), which exchanges the addresses of all dimensions in one store
+rendezvous and connects them concurrently.
+
+Run on a single host with one process per rank, e.g.:
+
+    torchrun --nnodes 1 --nproc_per_node 8 SplitMeshBench.py --shape 2 2 2
+"""
+
+import argparse
+import time
+
+import torch
+from torchcomms import new_comm
+
+
+def mesh_groups(shape, rank):
+    mesh = torch.arange(torch.Size(shape).numel()).view(shape)
+    coords = [int(c) for c in torch.nonzero(mesh == rank)[0]]
+    groups = []
+    for d in range(len(shape)):
+        index = list(coords)
+        index[d] = slice(None)
+        groups.append(mesh[tuple(index)].tolist())
+    return groups
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--shape", type=int, nargs="+", default=[2, 2, 2])
+    parser.add_argument("--iters", type=int, default=5)
+    args = parser.parse_args()
+
+    comm = new_comm("gloo", torch.device("cpu"), name="split_mesh_bench")
+    rank = comm.get_rank()
+    names = [f"dim{d}" for d in range(len(args.shape))]
+    groups = mesh_groups(args.shape, rank)
+
+    results = {"split": [], "split_mesh": []}
+    for it in range(args.iters):
+        comm.barrier(False)
+        start = time.perf_counter()
+        comms = [
+            comm.split(group, f"split_{it}_{name}")
+            for group, name in zip(groups, names)
+        ]
+        comm.barrier(False)
+        results["split"].append(time.perf_counter() - start)
+        for c in comms:
+            c.finalize()
+
+        comm.barrier(False)
+        start = time.perf_counter()
+        comms = comm.split_mesh(args.shape, [f"mesh_{it}_{n}" for n in names])
+        comm.barrier(False)
+        results["split_mesh"].append(time.perf_counter() - start)
+        for c in comms:
+            c.finalize()
+
+    if rank == 0:
+        for method, times in results.items():
+            times = sorted(times)
+            print(
+                f"{method:>10} shape={args.shape} "
+                f"median={times[len(times) // 2] * 1e3:.1f}ms "
+                f"min={times[0] * 1e3:.1f}ms"
+            )
+    comm.finalize()
+
+
+if __name__ == "__main__":
+    main()
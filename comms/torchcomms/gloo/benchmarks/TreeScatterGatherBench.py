@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+"""
+Latency of scatter and gather on the Gloo backend with binomial trees versus
+gloo's flat versions, where the root exchanges a block with every rank.
+
+Run with many CPU ranks, e.g. on one host:
+
+    torchrun --nnodes 1 --nproc_per_node 64 TreeScatterGatherBench.py
+
+or across hosts, where the root's NIC is shared by all of its transfers.
+"""
+
+import argparse
+import time
+
+import torch
+from torchcomms import new_comm
+
+
+def bench(comm, op, numel, warmup, iters):
+    rank = comm.get_rank()
+    size = comm.get_size()
+    block = torch.ones(numel, dtype=torch.float32)
+    blocks = [torch.ones(numel, dtype=torch.float32) for _ in range(size)]
+    root_blocks = blocks if rank == 0 else []
+
+    def run():
+        if op == "scatter":
+            comm.scatter(block, root_blocks, 0, False)
+        else:
+            comm.gather(root_blocks, block, 0, False)
+
+    for _ in range(warmup):
+        run()
+    comm.barrier(False)
+    start = time.perf_counter()
+    for _ in range(iters):
+        run()
+    # Ends when the last rank is done
+    comm.barrier(False)
+    return (time.perf_counter() - start) / iters * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--block-bytes",
+        type=int,
+        nargs="+",
+        default=[4, 1 << 10, 16 << 10, 256 << 10, 4 << 20],
+    )
+    parser.add_argument("--ops", nargs="+", default=["scatter", "gather"])
+    parser.add_argument("--warmup", type=int, default=5)
+    parser.add_argument("--iters", type=int, default=50)
+    args = parser.parse_args()
+
+    device = torch.device("cpu")
+    # Force either algorithm regardless of the group and block size
+    modes = {
+        "flat": {"tree_min_ranks": str(1 << 30)},
+        "tree": {"tree_min_ranks": "1", "tree_max_block_bytes": str(1 << 40)},
+    }
+    comms = {
+        mode: new_comm("gloo", device, name=f"tree_bench_{mode}", hints=hints)
+        for mode, hints in modes.items()
+    }
+    rank = comms["flat"].get_rank()
+    size = comms["flat"].get_size()
+
+    for op in args.ops:
+        for block_bytes in args.block_bytes:
+            numel = max(block_bytes // 4, 1)
+            times = {
+                mode: bench(comm, op, numel, args.warmup, args.iters)
+                for mode, comm in comms.items()
+            }
+            if rank == 0:
+                print(
+                    f"{op:>8} ranks={size:<4} block={block_bytes:>8}B "
+                    f"flat={times['flat']:10.1f}us tree={times['tree']:10.1f}us "
+                    f"speedup={times['flat'] / times['tree']:.2f}x"
+                )
+
+    for comm in comms.values():
+        comm.finalize()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import itertools
+import os
+import unittest
+
+import torch
+from torchcomms import RedOpType, ReduceOp
+from torchcomms.tests.integration.py.TorchCommTestHelpers import (
+    get_dtype_name,
+    get_op_name,
+    TorchCommTestWrapper,
+)
+
+
+class AllReduceSparseBlockTest(unittest.TestCase):
+    """Test class for all_reduce_sparse_block operations in TorchComm."""
+
+    # Class variables for test parameters
+    num_blocks = 64
+    block_lengths = [1, 32]
+    # Fraction of the blocks contributed by each rank
+    densities = [0.0, 0.05, 0.3, 1.0]
+    dtypes = [torch.float, torch.int]
+    ops = [ReduceOp.SUM, ReduceOp.MAX]
+    # Force the sparse exchange, force the dense reduction, backend default
+    dense_thresholds = [float("inf"), 0.0, None]
+
+    def get_wrapper(self):
+        return TorchCommTestWrapper()
+
+    def setUp(self):
+        """Set up test environment before each test."""
+        self.wrapper = self.get_wrapper()
+        self.torchcomm = self.wrapper.get_torchcomm()
+        self.rank = self.torchcomm.get_rank()
+        self.num_ranks = self.torchcomm.get_size()
+        self.device = self.torchcomm.get_device()
+
+    def tearDown(self):
+        """Clean up after each test."""
+        # Explicitly reset the TorchComm object to ensure proper cleanup
+        self.torchcomm = None
+        self.wrapper = None
+
+    def _create_sparse_input(self, rank, block_length, density, dtype):
+        """Create the (indices, blocks) of a rank, deterministic per rank."""
+        generator = torch.Generator().manual_seed(rank)
+        num = int(self.num_blocks * density)
+        indices = torch.randperm(self.num_blocks, generator=generator)[:num]
+        # Negative values check that absent blocks count as zeros for MAX
+        values = torch.randint(
+            -8, 8, (num * block_length,), generator=generator
+        ).to(dtype)
+        return indices, values
+
+    def _expected(self, block_length, density, dtype, op):
+        """Compute the dense reduction of all ranks' inputs locally."""
+        dense = []
+        for rank in range(self.num_ranks):
+            indices, values = self._create_sparse_input(
+                rank, block_length, density, dtype
+            )
+            t = torch.zeros(self.num_blocks, block_length, dtype=dtype)
+            t[indices] = values.view(-1, block_length)
+            dense.append(t)
+        stacked = torch.stack(dense)
+        if op.type == RedOpType.SUM:
+            return stacked.sum(dim=0).to(dtype).flatten()
+        return stacked.max(dim=0).values.flatten()
+
+    def _sync_all_reduce_sparse_block(
+        self, block_length, density, dtype, op, dense_threshold
+    ):
+        """Test synchronous all_reduce_sparse_block with work object."""
+        print(
+            f"Testing sync all_reduce_sparse_block with block_length={block_length}, "
+            f"density={density}, dtype={get_dtype_name(dtype)}, op={get_op_name(op)} "
+            f"and dense_threshold={dense_threshold}"
+        )
+
+        indices, values = self._create_sparse_input(
+            self.rank, block_length, density, dtype
+        )
+        # Garbage in the output must be overwritten
+        output = torch.full(
+            (self.num_blocks * block_length,), 42, dtype=dtype, device=self.device
+        )
+
+        work = self.torchcomm.all_reduce_sparse_block(
+            output,
+            values.to(self.device),
+            indices.to(self.device),
+            block_length,
+            op,
+            False,
+            dense_threshold=dense_threshold,
+        )
+        work.wait()
+
+        expected = self._expected(block_length, density, dtype, op)
+        self.assertTrue(
+            torch.equal(output.cpu(), expected),
+            "Sparse block all_reduce result differs from the dense reduction",
+        )
+
+    @unittest.skipIf(
+        os.getenv("TEST_BACKEND") != "gloo",
+        "Skipping all_reduce_sparse_block test for non-Gloo backends",
+    )
+    def test_sync_all_reduce_sparse_block(self):
+        """Test synchronous all_reduce_sparse_block with work object."""
+        for block_length, density, dtype, op, dense_threshold in itertools.product(
+            self.block_lengths,
+            self.densities,
+            self.dtypes,
+            self.ops,
+            self.dense_thresholds,
+        ):
+            with self.subTest(
+                block_length=block_length,
+                density=density,
+                dtype=dtype,
+                op=op,
+                dense_threshold=dense_threshold,
+            ):
+                self._sync_all_reduce_sparse_block(
+                    block_length, density, dtype, op, dense_threshold
+                )
+
+    @unittest.skipIf(
+        os.getenv("TEST_BACKEND") != "gloo",
+        "Skipping all_reduce_sparse_block test for non-Gloo backends",
+    )
+    def test_async_all_reduce_sparse_block(self):
+        """Test asynchronous all_reduce_sparse_block with unsorted indices."""
+        block_length = 4
+        indices, values = self._create_sparse_input(
+            self.rank, block_length, 0.3, torch.float
+        )
+        output = torch.zeros(self.num_blocks * block_length, device=self.device)
+
+        work = self.torchcomm.all_reduce_sparse_block(
+            output,
+            values.to(self.device),
+            indices.to(self.device),
+            block_length,
+            ReduceOp.SUM,
+            True,
+        )
+        work.wait()
+
+        expected = self._expected(block_length, 0.3, torch.float, ReduceOp.SUM)
+        self.assertTrue(torch.allclose(output.cpu(), expected))
+
+    @unittest.skipIf(
+        os.getenv("TEST_BACKEND") != "gloo",
+        "Skipping all_reduce_sparse_block test for non-Gloo backends",
+    )
+    def test_invalid_indices(self):
+        """Out-of-range and duplicate indices are rejected before any exchange."""
+        output = torch.zeros(self.num_blocks, device=self.device)
+        for indices in ([0, self.num_blocks], [-1], [3, 3]):
+            with self.subTest(indices=indices):
+                with self.assertRaises(RuntimeError):
+                    self.torchcomm.all_reduce_sparse_block(
+                        output,
+                        torch.ones(len(indices), device=self.device),
+                        torch.tensor(indices, dtype=torch.long, device=self.device),
+                        1,
+                        ReduceOp.SUM,
+                        False,
+                    )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -56,6 +56,82 @@ class DeviceMeshTest(unittest.TestCase):
 
         comm.finalize()
 
+    def test_repeated_collectives(self) -> None:
+        """Many sync and async c10d calls through the wrapper."""
+        backend = os.environ["TEST_BACKEND"]
+        device = torch.device(os.environ.get("TEST_DEVICE", "cuda"))
+
+        comm = torchcomms.new_comm(backend, device, name="comms_test_repeated")
+
+        try:
+            device_mesh = init_device_mesh(
+                mesh_dim_comms=(comm,),
+                mesh_dim_names=("main",),
+            )
+        except TypeError as e:
+            # TODO: remove this once PT 2.10 is released
+            if "_rank" in str(e):
+                comm.finalize()
+                return
+            raise
+
+        group = device_mesh.get_group("main")
+        size = comm.get_size()
+        rank = comm.get_rank()
+
+        # Many outstanding async works at once
+        tensors = [
+            torch.full((4,), i, device=device, dtype=torch.int32) for i in range(100)
+        ]
+        works = [dist.all_reduce(t, group=group, async_op=True) for t in tensors]
+        for i, (t, work) in enumerate(zip(tensors, works)):
+            work.wait()
+            self.assertEqual(t[0].item(), i * size)
+
+        # Sync calls, each with different split sizes
+        for i in range(10):
+            dist.barrier(group=group)
+            splits = [(i + peer) % 3 for peer in range(size)]
+            output_splits = [(i + rank) % 3] * size
+            input = torch.full((sum(splits),), rank, device=device, dtype=torch.int32)
+            output = torch.empty(
+                (sum(output_splits),), device=device, dtype=torch.int32
+            )
+            dist.all_to_all_single(output, input, output_splits, splits, group=group)
+            expected = torch.cat(
+                [
+                    torch.full((n,), peer, dtype=torch.int32)
+                    for peer, n in enumerate(output_splits)
+                ]
+            )
+            self.assertTrue(torch.equal(output.cpu(), expected))
+
+        # Async calls with different split sizes outstanding at once, the
+        # later ones converting theirs while the earlier ones still run
+        pending = []
+        for i in range(10):
+            splits = [(i + peer) % 3 for peer in range(size)]
+            output_splits = [(i + rank) % 3] * size
+            input = torch.full((sum(splits),), rank, device=device, dtype=torch.int32)
+            output = torch.empty(
+                (sum(output_splits),), device=device, dtype=torch.int32
+            )
+            work = dist.all_to_all_single(
+                output, input, output_splits, splits, group=group, async_op=True
+            )
+            pending.append((work, output, output_splits))
+        for work, output, output_splits in pending:
+            work.wait()
+            expected = torch.cat(
+                [
+                    torch.full((n,), peer, dtype=torch.int32)
+                    for peer, n in enumerate(output_splits)
+                ]
+            )
+            self.assertTrue(torch.equal(output.cpu(), expected))
+
+        comm.finalize()
+
     @unittest.skipIf(
         torch.cuda.device_count() < 4, "Skipping non GPU situations for now"
     )
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import os
+import time
+import unittest
+
+import torch
+from torchcomms import new_comm, new_comms, ReduceOp
+from torchcomms.tests.integration.py.TorchCommTestHelpers import (
+    get_rank_and_size,
+    maybe_set_rank_envs,
+    verify_tensor_equality,
+)
+
+
+NUM_COMMS = 16
+
+
+class NewCommsTest(unittest.TestCase):
+    """Test class for creating batches of communicators with new_comms."""
+
+    NEXT_BATCH_ID = 0
+
+    def setUp(self):
+        """Set up test environment before each test."""
+        maybe_set_rank_envs()
+        self.backend = os.getenv("TEST_BACKEND")
+        if self.backend is None:
+            raise RuntimeError("TEST_BACKEND environment variable is not set")
+        self.rank, self.size = get_rank_and_size()
+        if device := os.environ.get("TEST_DEVICE"):
+            self.device = torch.device(device)
+        elif torch.cuda.is_available():
+            self.device = torch.device(
+                f"cuda:{self.rank % torch.cuda.device_count()}"
+            )
+        else:
+            self.device = torch.device("cpu")
+
+    def _names(self, prefix):
+        NewCommsTest.NEXT_BATCH_ID += 1
+        return [
+            f"{prefix}_{NewCommsTest.NEXT_BATCH_ID}_{i}" for i in range(NUM_COMMS)
+        ]
+
+    def _verify_and_finalize(self, comms, names):
+        """Verify every communicator works on its own, then free them."""
+        self.assertEqual(len(comms), len(names))
+        for comm, name in zip(comms, names):
+            self.assertEqual(comm.get_name(), name)
+            self.assertEqual(comm.get_rank(), self.rank)
+            self.assertEqual(comm.get_size(), self.size)
+
+            input_tensor = torch.ones(10, dtype=torch.float, device=self.device) * (
+                self.rank + 1
+            )
+            comm.all_reduce(input_tensor, ReduceOp.SUM, False)
+            verify_tensor_equality(
+                input_tensor.cpu(),
+                self.size * (self.size + 1) / 2,
+                f"{name} all_reduce result",
+            )
+        for comm in comms:
+            comm.finalize()
+
+    def test_new_comms(self):
+        """Test creating a batch of communicators initialized concurrently."""
+        names = self._names("new_comms")
+        comms = new_comms(self.backend, self.device, names)
+        self._verify_and_finalize(comms, names)
+
+    def test_new_comms_bounded_concurrency(self):
+        """Test a batch initialized a few communicators at a time."""
+        names = self._names("new_comms_bounded")
+        comms = new_comms(self.backend, self.device, names, max_concurrency=3)
+        self._verify_and_finalize(comms, names)
+
+    def test_new_comms_vs_serial(self):
+        """Compare the startup time of a batch against serial new_comm calls."""
+        serial_names = self._names("serial")
+        start = time.monotonic()
+        serial_comms = [
+            new_comm(self.backend, self.device, name=name) for name in serial_names
+        ]
+        serial_time = time.monotonic() - start
+
+        batch_names = self._names("batch")
+        start = time.monotonic()
+        batch_comms = new_comms(self.backend, self.device, batch_names)
+        batch_time = time.monotonic() - start
+
+        if self.rank == 0:
+            print(
+                f"{self.backend}: {NUM_COMMS} communicators of {self.size} ranks, "
+                f"serial new_comm {serial_time * 1000:.1f} ms, "
+                f"new_comms {batch_time * 1000:.1f} ms"
+            )
+
+        self._verify_and_finalize(serial_comms, serial_names)
+        self._verify_and_finalize(batch_comms, batch_names)
+
+
+if __name__ == "__main__":
+    unittest.main(failfast=True)
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import unittest
+
+import torch
+from torchcomms import ReduceOp
+from torchcomms.tests.integration.py.TorchCommTestHelpers import TorchCommTestWrapper
+
+
+class SplitMeshTest(unittest.TestCase):
+    """Test class for split_mesh operations in TorchComm."""
+
+    def get_wrapper(self):
+        return TorchCommTestWrapper()
+
+    def setUp(self):
+        """Set up test environment before each test."""
+        self.wrapper = self.get_wrapper()
+        self.torchcomm = self.wrapper.get_torchcomm()
+        self.rank = self.torchcomm.get_rank()
+        self.num_ranks = self.torchcomm.get_size()
+        self.device = self.torchcomm.get_device()
+
+    def tearDown(self):
+        """Clean up after each test."""
+        # Explicitly reset the TorchComm object to ensure proper cleanup
+        self.torchcomm = None
+        self.wrapper = None
+
+    def _verify_mesh(self, shape, dim_names):
+        """Check every dimension communicator against torch.arange(n).view(shape)."""
+        comms = self.torchcomm.split_mesh(shape, dim_names)
+        self.assertEqual(len(comms), len(shape))
+
+        mesh = torch.arange(self.num_ranks).view(shape)
+        coords = [int(c) for c in torch.nonzero(mesh == self.rank)[0]]
+        for d, comm in enumerate(comms):
+            self.assertEqual(comm.get_size(), shape[d])
+            self.assertEqual(comm.get_rank(), coords[d])
+
+            # The group along d holds the ranks sharing all other coordinates;
+            # summing the global ranks identifies it.
+            index = list(coords)
+            index[d] = slice(None)
+            expected = float(mesh[tuple(index)].sum())
+
+            tensor = torch.full((10,), float(self.rank), device=self.device)
+            comm.all_reduce(tensor, ReduceOp.SUM, False)
+            self.assertTrue(
+                torch.equal(tensor.cpu(), torch.full((10,), expected)),
+                f"Unexpected all_reduce result on mesh dimension {dim_names[d]}",
+            )
+
+        for comm in comms:
+            comm.finalize()
+
+    def test_split_mesh_1d(self):
+        """A 1-D mesh spans the whole communicator."""
+        self._verify_mesh([self.num_ranks], ["world"])
+
+    def test_split_mesh_2d(self):
+        """Test a 2-D mesh, if the number of ranks allows one."""
+        if self.num_ranks % 2 != 0:
+            self.skipTest("2-D mesh requires an even number of ranks")
+        self._verify_mesh([2, self.num_ranks // 2], ["dp", "tp"])
+
+    def test_split_mesh_3d(self):
+        """Test a 3-D mesh with a trivial middle dimension."""
+        if self.num_ranks % 2 != 0:
+            self.skipTest("3-D mesh requires an even number of ranks")
+        self._verify_mesh([self.num_ranks // 2, 1, 2], ["pp", "cp", "ep"])
+
+    def test_split_mesh_repeated(self):
+        """Meshes created one after another do not mix up their rendezvous."""
+        if self.num_ranks % 2 != 0:
+            self.skipTest("2-D mesh requires an even number of ranks")
+        for _ in range(3):
+            self._verify_mesh([2, self.num_ranks // 2], ["dp", "tp"])
+
+    def test_split_mesh_invalid_shape(self):
+        """A mesh that does not cover the communicator is rejected."""
+        with self.assertRaises(RuntimeError):
+            self.torchcomm.split_mesh([self.num_ranks + 1], ["world"])
+        with self.assertRaises(RuntimeError):
+            self.torchcomm.split_mesh([self.num_ranks], ["a", "b"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import os
+import unittest
+
+import torch
+from torchcomms import ReduceOp
+from torchcomms.tests.integration.py.TorchCommTestHelpers import (
+    get_dtype_name,
+    TorchCommTestWrapper,
+)
+
+
+@unittest.skipIf(
+    os.getenv("TEST_BACKEND") != "gloo" or not torch.cuda.is_available(),
+    "Pipelined staging of CUDA tensors is Gloo-only",
+)
+class StagingTest(unittest.TestCase):
+    """Test the Gloo backend's pipelined staging of CUDA tensors."""
+
+    # Class variables for test parameters
+    counts = [1, 1000, 4097, 100000]
+    dtypes = [torch.float, torch.int]
+    depths = [1, 2, 3]
+    # Small chunks, so that all but the smallest count are staged
+    chunk_bytes = 4096
+
+    def get_wrapper(self):
+        return TorchCommTestWrapper()
+
+    def setUp(self):
+        """Set up test environment before each test."""
+        self.wrapper = self.get_wrapper()
+        self.torchcomm = self.wrapper.get_torchcomm()
+        self.rank = self.torchcomm.get_rank()
+        self.num_ranks = self.torchcomm.get_size()
+        self.device = self.torchcomm.get_device()
+        if self.device.type != "cuda":
+            self.skipTest("Staging only applies to CUDA tensors")
+
+    def tearDown(self):
+        """Clean up after each test."""
+        # Explicitly reset the TorchComm object to ensure proper cleanup
+        self.torchcomm = None
+        self.wrapper = None
+
+    def _split(self, depth, stripes=1):
+        return self.torchcomm.split(
+            [list(range(self.num_ranks))],
+            f"staging_{depth}_{stripes}",
+            hints={
+                "staging_chunk_bytes": str(self.chunk_bytes),
+                "staging_depth": str(depth),
+                "stripes": str(stripes),
+                # Every staged chunk is split over the stripes
+                "stripe_min_bytes": str(self.chunk_bytes // stripes),
+            },
+        )
+
+    def test_all_reduce(self):
+        """Staged all_reduce, for every depth, sync and async."""
+        for depth in self.depths:
+            comm = self._split(depth)
+            for count in self.counts:
+                for dtype in self.dtypes:
+                    for async_op in [False, True]:
+                        # Filled on the current stream, without synchronizing
+                        tensor = torch.arange(count, device=self.device).to(dtype)
+                        tensor.add_(self.rank + 1)
+                        work = comm.all_reduce(tensor, ReduceOp.SUM, async_op)
+                        if async_op:
+                            work.wait()
+                        expected = (
+                            torch.arange(count).to(dtype) * self.num_ranks
+                            + self.num_ranks * (self.num_ranks + 1) // 2
+                        )
+                        self.assertTrue(
+                            torch.equal(tensor.cpu(), expected),
+                            f"all_reduce depth={depth} count={count} "
+                            f"dtype={get_dtype_name(dtype)} async={async_op}",
+                        )
+            comm.finalize()
+
+    def test_striped_async_all_reduce(self):
+        """Striped chunks, with several staged all_reduces in flight."""
+        comm = self._split(depth=2, stripes=2)
+        for dtype in self.dtypes:
+            tensors = []
+            works = []
+            for i in range(4):
+                tensor = torch.arange(100000, device=self.device).to(dtype)
+                tensor.add_(self.rank + i)
+                tensors.append(tensor)
+                works.append(comm.all_reduce(tensor, ReduceOp.SUM, True))
+            for work in works:
+                work.wait()
+            for i, tensor in enumerate(tensors):
+                expected = (
+                    torch.arange(100000).to(dtype) * self.num_ranks
+                    + self.num_ranks * (self.num_ranks - 1) // 2
+                    + self.num_ranks * i
+                )
+                self.assertTrue(
+                    torch.equal(tensor.cpu(), expected),
+                    f"all_reduce {i} dtype={get_dtype_name(dtype)}",
+                )
+        comm.finalize()
+
+    def test_broadcast(self):
+        """Staged broadcast from every root."""
+        for depth in self.depths:
+            comm = self._split(depth)
+            for root in range(self.num_ranks):
+                for count in self.counts:
+                    for dtype in self.dtypes:
+                        if self.rank == root:
+                            tensor = torch.arange(count, device=self.device)
+                            tensor = tensor.to(dtype)
+                        else:
+                            tensor = torch.zeros(count, dtype=dtype, device=self.device)
+                        comm.broadcast(tensor, root, False)
+                        self.assertTrue(
+                            torch.equal(tensor.cpu(), torch.arange(count).to(dtype)),
+                            f"broadcast depth={depth} root={root} count={count} "
+                            f"dtype={get_dtype_name(dtype)}",
+                        )
+            comm.finalize()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# pyre-unsafe
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+
+import os
+import unittest
+
+import torch
+from torchcomms.tests.integration.py.TorchCommTestHelpers import (
+    get_dtype_name,
+    TorchCommTestWrapper,
+)
+
+
+@unittest.skipIf(
+    os.getenv("TEST_BACKEND") != "gloo", "Binomial tree scatter/gather is Gloo-only"
+)
+class TreeScatterGatherTest(unittest.TestCase):
+    """Test the Gloo backend's binomial tree scatter and gather."""
+
+    # Class variables for test parameters
+    counts = [1, 1000]
+    dtypes = [torch.float, torch.int]
+    # Trees for every group size and the blocks of all counts above
+    tree_hints = {"tree_min_ranks": "1", "tree_max_block_bytes": str(1 << 20)}
+
+    def get_wrapper(self):
+        return TorchCommTestWrapper()
+
+    def setUp(self):
+        """Set up test environment before each test."""
+        self.wrapper = self.get_wrapper()
+        self.torchcomm = self.wrapper.get_torchcomm()
+        self.rank = self.torchcomm.get_rank()
+        self.num_ranks = self.torchcomm.get_size()
+        self.device = self.torchcomm.get_device()
+
+    def tearDown(self):
+        """Clean up after each test."""
+        # Explicitly reset the TorchComm object to ensure proper cleanup
+        self.torchcomm = None
+        self.wrapper = None
+
+    def _split(self, group_size, name):
+        """Split into groups of group_size ranks, the last one possibly smaller."""
+        groups = [
+            list(range(start, min(start + group_size, self.num_ranks)))
+            for start in range(0, self.num_ranks, group_size)
+        ]
+        return self.torchcomm.split(groups, name, hints=self.tree_hints)
+
+    def _check_scatter(self, comm, root, count, dtype):
+        rank = comm.get_rank()
+        size = comm.get_size()
+        output = torch.zeros(count, dtype=dtype, device=self.device)
+        inputs = []
+        if rank == root:
+            inputs = [
+                torch.arange(count, dtype=dtype, device=self.device) + i * count
+                for i in range(size)
+            ]
+        comm.scatter(output, inputs, root, False)
+        expected = torch.arange(count, dtype=dtype) + rank * count
+        self.assertTrue(
+            torch.equal(output.cpu(), expected),
+            f"scatter size={size} root={root} count={count} "
+            f"dtype={get_dtype_name(dtype)}",
+        )
+
+    def _check_gather(self, comm, root, count, dtype):
+        rank = comm.get_rank()
+        size = comm.get_size()
+        input = torch.arange(count, dtype=dtype, device=self.device) + rank * count
+        outputs = []
+        if rank == root:
+            outputs = [
+                torch.zeros(count, dtype=dtype, device=self.device)
+                for _ in range(size)
+            ]
+        comm.gather(outputs, input, root, False)
+        if rank == root:
+            for i, output in enumerate(outputs):
+                expected = torch.arange(count, dtype=dtype) + i * count
+                self.assertTrue(
+                    torch.equal(output.cpu(), expected),
+                    f"gather size={size} root={root} block={i} count={count} "
+                    f"dtype={get_dtype_name(dtype)}",
+                )
+
+    def _check_all_roots(self, comm):
+        for root in range(comm.get_size()):
+            for count in self.counts:
+                for dtype in self.dtypes:
+                    self._check_scatter(comm, root, count, dtype)
+                    self._check_gather(comm, root, count, dtype)
+
+    def test_odd_group_sizes(self):
+        """Trees over groups of 3, 5 and 7 ranks, and the smaller remainders."""
+        for group_size in [3, 5, 7]:
+            comm = self._split(group_size, f"tree_groups_{group_size}")
+            self._check_all_roots(comm)
+            comm.finalize()
+
+    def test_whole_communicator(self):
+        """A tree spanning all ranks."""
+        comm = self._split(self.num_ranks, "tree_world")
+        self._check_all_roots(comm)
+        comm.finalize()
+
+    def test_large_blocks_use_flat(self):
+        """Blocks above tree_max_block_bytes fall back to gloo's scatter/gather."""
+        comm = self.torchcomm.split(
+            [list(range(self.num_ranks))],
+            "tree_flat",
+            hints={"tree_min_ranks": "1", "tree_max_block_bytes": "16"},
+        )
+        self._check_all_roots(comm)
+        comm.finalize()
+
+
+if __name__ == "__main__":
+    unittest.main()
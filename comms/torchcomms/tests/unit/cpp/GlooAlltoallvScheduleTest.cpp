@@ -0,0 +1,318 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "comms/torchcomms/gloo/GlooAlltoallvSchedule.hpp"
+
+namespace torch {
+namespace comms {
+namespace test {
+
+namespace {
+
+// bytes[src][dst] of an all-to-all between size ranks
+using Matrix = std::vector<std::vector<size_t>>;
+
+struct RankPlan {
+  std::vector<AlltoallvStep> steps;
+  size_t window;
+};
+
+std::vector<size_t> prefixOffsets(const std::vector<size_t>& bytes) {
+  std::vector<size_t> offsets(bytes.size());
+  size_t offset = 0;
+  for (size_t p = 0; p < bytes.size(); p++) {
+    offsets[p] = offset;
+    offset += bytes[p];
+  }
+  return offsets;
+}
+
+std::vector<RankPlan> planAll(
+    const Matrix& bytes,
+    const AlltoallvSchedulePolicy& policy) {
+  const int size = bytes.size();
+  std::vector<RankPlan> plans;
+  for (int rank = 0; rank < size; rank++) {
+    std::vector<size_t> recvBytes(size);
+    for (int p = 0; p < size; p++) {
+      recvBytes[p] = bytes[p][rank];
+    }
+    RankPlan plan;
+    plan.steps = planPairwiseAlltoallv(
+        rank,
+        size,
+        prefixOffsets(bytes[rank]),
+        bytes[rank],
+        prefixOffsets(recvBytes),
+        recvBytes,
+        policy);
+    plan.window = alltoallvWindow(rank, recvBytes, plan.steps.size(), policy);
+    plans.push_back(std::move(plan));
+  }
+  return plans;
+}
+
+// Runs the plans the way scheduledAlltoallv does: every rank keeps window
+// steps posted and retires them oldest first, and the n-th send from a to b
+// completes with the n-th receive at b from a once both are posted. Returns
+// whether all steps of all ranks complete.
+bool simulate(const std::vector<RankPlan>& plans) {
+  const int size = plans.size();
+  std::vector<size_t> done(size, 0);
+  // (src, dst) -> sizes of the posted, not yet matched sends and receives
+  std::map<std::pair<int, int>, std::vector<size_t>> sends, recvs;
+  std::map<std::pair<int, int>, size_t> sendsPosted, recvsPosted, matched;
+  std::vector<size_t> posted(size, 0);
+
+  auto transferDone = [&](int src, int dst, size_t n) {
+    return matched[{src, dst}] > n;
+  };
+  // Index of each step's transfers within its (src, dst) pair
+  std::vector<std::vector<std::pair<size_t, size_t>>> index(size);
+
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (int r = 0; r < size; r++) {
+      const auto& steps = plans[r].steps;
+      while (posted[r] < steps.size() &&
+             posted[r] < done[r] + plans[r].window) {
+        const auto& step = steps[posted[r]++];
+        std::pair<size_t, size_t> idx{0, 0};
+        if (step.send.peer >= 0) {
+          idx.first = sendsPosted[{r, step.send.peer}]++;
+          sends[{r, step.send.peer}].push_back(step.send.nbytes);
+        }
+        if (step.recv.peer >= 0) {
+          idx.second = recvsPosted[{step.recv.peer, r}]++;
+          recvs[{step.recv.peer, r}].push_back(step.recv.nbytes);
+        }
+        index[r].push_back(idx);
+        progress = true;
+      }
+    }
+    for (auto& [pair, s] : sends) {
+      auto& m = matched[pair];
+      const auto& rv = recvs[pair];
+      while (m < s.size() && m < rv.size()) {
+        EXPECT_EQ(s[m], rv[m]);
+        m++;
+        progress = true;
+      }
+    }
+    for (int r = 0; r < size; r++) {
+      const auto& steps = plans[r].steps;
+      while (done[r] < posted[r]) {
+        const auto& step = steps[done[r]];
+        const auto& idx = index[r][done[r]];
+        if ((step.send.peer >= 0 &&
+             !transferDone(r, step.send.peer, idx.first)) ||
+            (step.recv.peer >= 0 &&
+             !transferDone(step.recv.peer, r, idx.second))) {
+          break;
+        }
+        done[r]++;
+        progress = true;
+      }
+    }
+  }
+
+  for (int r = 0; r < size; r++) {
+    if (done[r] != plans[r].steps.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sum of the transferred bytes per peer, checking that every peer's chunks
+// are contiguous and at most chunkBytes.
+std::map<int, size_t> coveredBytes(
+    const std::vector<AlltoallvStep>& steps,
+    bool send,
+    const std::vector<size_t>& offsets,
+    size_t chunkBytes) {
+  std::map<int, size_t> covered;
+  for (const auto& step : steps) {
+    const auto& t = send ? step.send : step.recv;
+    if (t.peer < 0) {
+      continue;
+    }
+    EXPECT_GT(t.nbytes, 0);
+    EXPECT_LE(t.nbytes, chunkBytes);
+    EXPECT_EQ(t.offset, offsets[t.peer] + covered[t.peer]);
+    covered[t.peer] += t.nbytes;
+  }
+  return covered;
+}
+
+Matrix skewedMatrix(int size) {
+  Matrix bytes(size, std::vector<size_t>(size, 0));
+  for (int src = 0; src < size; src++) {
+    for (int dst = 0; dst < size; dst++) {
+      // One hot destination per source, some empty pairs, and uneven rest
+      if (dst == (src + 1) % size) {
+        bytes[src][dst] = 1000 + 37 * src;
+      } else if ((src + dst) % 3 != 0) {
+        bytes[src][dst] = 5 * (src + 2 * dst);
+      }
+    }
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST(GlooAlltoallvScheduleTest, PairwiseRoundsVisitEveryPeerOnce) {
+  for (int size : {1, 2, 3, 4, 5, 7, 8, 12, 16}) {
+    for (int rank = 0; rank < size; rank++) {
+      std::set<int> sendPeers, recvPeers;
+      for (int round = 1; round < size; round++) {
+        const int sendPeer = pairwiseSendPeer(rank, size, round);
+        const int recvPeer = pairwiseRecvPeer(rank, size, round);
+        EXPECT_NE(sendPeer, rank);
+        EXPECT_NE(recvPeer, rank);
+        sendPeers.insert(sendPeer);
+        recvPeers.insert(recvPeer);
+        // The peer receives from rank in the same round
+        EXPECT_EQ(pairwiseRecvPeer(sendPeer, size, round), rank);
+      }
+      EXPECT_EQ(sendPeers.size(), size - 1);
+      EXPECT_EQ(recvPeers.size(), size - 1);
+    }
+  }
+}
+
+TEST(GlooAlltoallvScheduleTest, PlanCoversAllBytesInChunks) {
+  const int size = 6;
+  const auto bytes = skewedMatrix(size);
+  AlltoallvSchedulePolicy policy;
+  policy.chunkBytes = 64;
+  policy.maxInflight = 2;
+
+  for (int rank = 0; rank < size; rank++) {
+    std::vector<size_t> recvBytes(size);
+    for (int p = 0; p < size; p++) {
+      recvBytes[p] = bytes[p][rank];
+    }
+    const auto sendOffsets = prefixOffsets(bytes[rank]);
+    const auto recvOffsets = prefixOffsets(recvBytes);
+    const auto steps = planPairwiseAlltoallv(
+        rank,
+        size,
+        sendOffsets,
+        bytes[rank],
+        recvOffsets,
+        recvBytes,
+        policy);
+
+    auto sent = coveredBytes(steps, true, sendOffsets, policy.chunkBytes);
+    auto received = coveredBytes(steps, false, recvOffsets, policy.chunkBytes);
+    for (int p = 0; p < size; p++) {
+      if (p == rank || bytes[rank][p] == 0) {
+        // Own rank and empty peers never appear
+        EXPECT_EQ(sent.count(p), 0);
+      } else {
+        EXPECT_EQ(sent[p], bytes[rank][p]);
+      }
+      if (p == rank || recvBytes[p] == 0) {
+        EXPECT_EQ(received.count(p), 0);
+      } else {
+        EXPECT_EQ(received[p], recvBytes[p]);
+      }
+    }
+    for (const auto& step : steps) {
+      EXPECT_TRUE(step.send.peer >= 0 || step.recv.peer >= 0);
+    }
+  }
+}
+
+TEST(GlooAlltoallvScheduleTest, ChunksOfGroupedRoundsInterleave) {
+  // Rank 0 of 4 sends 3 chunks to every peer; with groups of 2 rounds the
+  // chunks of rounds 1 and 2 alternate before round 3 starts.
+  const std::vector<size_t> bytes = {0, 30, 30, 30};
+  const auto offsets = prefixOffsets(bytes);
+  AlltoallvSchedulePolicy policy;
+  policy.chunkBytes = 10;
+  policy.maxInflight = 2;
+  const auto steps =
+      planPairwiseAlltoallv(0, 4, offsets, bytes, offsets, bytes, policy);
+
+  std::vector<int> peers;
+  for (const auto& step : steps) {
+    peers.push_back(step.send.peer);
+  }
+  EXPECT_EQ(peers, std::vector<int>({1, 2, 1, 2, 1, 2, 3, 3, 3}));
+}
+
+TEST(GlooAlltoallvScheduleTest, EmptyExchange) {
+  const std::vector<size_t> zeros(4, 0);
+  const auto steps = planPairwiseAlltoallv(
+      2, 4, zeros, zeros, zeros, zeros, AlltoallvSchedulePolicy());
+  EXPECT_TRUE(steps.empty());
+  EXPECT_TRUE(simulate(planAll(Matrix(4, zeros), AlltoallvSchedulePolicy())));
+}
+
+TEST(GlooAlltoallvScheduleTest, WindowBySizeAndSkew) {
+  AlltoallvSchedulePolicy policy;
+  policy.maxInflight = 4;
+  policy.minBytes = 1000;
+  policy.skewThreshold = 4.0;
+
+  // Small and even: everything posted at once
+  EXPECT_EQ(alltoallvWindow(0, {0, 100, 100, 100, 100}, 17, policy), 17);
+  // Large: bounded
+  EXPECT_EQ(alltoallvWindow(0, {0, 300, 300, 300, 300}, 17, policy), 4);
+  // Small in total but skewed: bounded from minBytes / skewThreshold
+  EXPECT_EQ(alltoallvWindow(0, {0, 400, 0, 0, 0}, 17, policy), 4);
+  EXPECT_EQ(alltoallvWindow(0, {0, 200, 0, 0, 0}, 17, policy), 17);
+  // Bytes to own rank do not count
+  EXPECT_EQ(alltoallvWindow(0, {5000, 100, 100, 100, 100}, 17, policy), 17);
+  EXPECT_EQ(alltoallvWindow(0, {0, 0, 0, 0, 0}, 0, policy), 1);
+}
+
+TEST(GlooAlltoallvScheduleTest, SchedulesComplete) {
+  for (int size : {2, 3, 4, 5, 8, 9}) {
+    const auto bytes = skewedMatrix(size);
+    for (size_t chunkBytes : {1, 16, 100, 1 << 20}) {
+      for (size_t maxInflight : {1, 2, 3, 16}) {
+        AlltoallvSchedulePolicy policy;
+        policy.chunkBytes = chunkBytes;
+        policy.maxInflight = maxInflight;
+        auto plans = planAll(bytes, policy);
+        EXPECT_TRUE(simulate(plans))
+            << "size " << size << " chunkBytes " << chunkBytes
+            << " maxInflight " << maxInflight;
+
+        // Ranks may pick different windows
+        for (int r = 0; r < size; r++) {
+          plans[r].window = r % 2 == 0 ? 1 : plans[r].steps.size() + 1;
+        }
+        EXPECT_TRUE(simulate(plans))
+            << "size " << size << " chunkBytes " << chunkBytes
+            << " maxInflight " << maxInflight << " mixed windows";
+      }
+    }
+  }
+}
+
+TEST(GlooAlltoallvScheduleTest, OutOfOrderScheduleCanDeadlock) {
+  // Sanity check of the simulation: posting one step at a time in an order
+  // the peers do not share blocks.
+  AlltoallvSchedulePolicy policy;
+  auto plans = planAll(skewedMatrix(5), policy);
+  for (auto& plan : plans) {
+    plan.window = 1;
+  }
+  std::reverse(plans[0].steps.begin(), plans[0].steps.end());
+  EXPECT_FALSE(simulate(plans));
+}
+
+} // namespace test
+} // namespace comms
+} // namespace torch
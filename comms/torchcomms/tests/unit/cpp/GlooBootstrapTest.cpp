@@ -0,0 +1,116 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <utility>
+
+#include "comms/torchcomms/gloo/GlooBootstrap.hpp"
+
+namespace torch {
+namespace comms {
+namespace test {
+
+namespace {
+
+const std::vector<int> kSizes = {1, 2, 3, 5, 7, 8, 9, 16, 31, 33, 100, 257};
+
+// Runs the exchange the way BootstrapContext does, with each block being the
+// (from, to) pair of ranks, and returns every rank's blocks at the end.
+std::vector<std::vector<std::pair<int, int>>> simulateBruck(int size) {
+  std::vector<std::vector<std::pair<int, int>>> blocks(size);
+  for (int rank = 0; rank < size; rank++) {
+    for (int p = 0; p < size; p++) {
+      blocks[rank].emplace_back(rank, (rank + p) % size);
+    }
+  }
+  std::vector<std::vector<BruckStep>> steps(size);
+  for (int rank = 0; rank < size; rank++) {
+    steps[rank] = bruckAlltoallSteps(rank, size);
+  }
+  for (size_t k = 0; k < steps[0].size(); k++) {
+    // All sends of a step happen before any receive is unpacked
+    std::vector<std::vector<std::pair<int, int>>> sent(size);
+    for (int rank = 0; rank < size; rank++) {
+      const auto& step = steps[rank][k];
+      EXPECT_EQ(steps[step.sendTo][k].recvFrom, rank);
+      for (auto p : step.positions) {
+        sent[step.sendTo].push_back(blocks[rank][p]);
+      }
+    }
+    for (int rank = 0; rank < size; rank++) {
+      const auto& step = steps[rank][k];
+      EXPECT_EQ(sent[rank].size(), step.positions.size());
+      for (size_t i = 0; i < step.positions.size(); i++) {
+        blocks[rank][step.positions[i]] = sent[rank][i];
+      }
+    }
+  }
+  return blocks;
+}
+
+} // namespace
+
+TEST(GlooBootstrapTest, LogarithmicSteps) {
+  for (int size : kSizes) {
+    size_t expected = 0;
+    while ((1 << expected) < size) {
+      expected++;
+    }
+    for (int rank = 0; rank < size; rank++) {
+      EXPECT_EQ(bruckAlltoallSteps(rank, size).size(), expected);
+    }
+  }
+}
+
+TEST(GlooBootstrapTest, EveryRankGetsItsAddresses) {
+  for (int size : kSizes) {
+    const auto blocks = simulateBruck(size);
+    for (int rank = 0; rank < size; rank++) {
+      for (int from = 0; from < size; from++) {
+        const auto& block =
+            blocks[rank][bruckAlltoallPosition(rank, from, size)];
+        EXPECT_EQ(block.first, from) << "size " << size << " rank " << rank;
+        EXPECT_EQ(block.second, rank) << "size " << size << " rank " << rank;
+      }
+    }
+  }
+}
+
+TEST(GlooBootstrapTest, BoundedBlocksPerStep) {
+  // Every step moves about half the blocks, so each rank sends and receives
+  // O(size log size) bytes instead of the O(size^2) of an allgather.
+  for (int size : kSizes) {
+    for (const auto& step : bruckAlltoallSteps(0, size)) {
+      EXPECT_LE(step.positions.size(), static_cast<size_t>(size / 2 + 1));
+    }
+  }
+}
+
+TEST(GlooBootstrapTest, MeshAddressesRoundTrip) {
+  // Two dimensions, this rank being rank 1 of the first and 0 of the second
+  const MeshAddresses addresses = {
+      {{'a', 'b'}, {}, {'c'}},
+      {{}, {'d', 'e', 'f'}},
+  };
+  EXPECT_EQ(decodeMeshAddresses(encodeMeshAddresses(addresses)), addresses);
+  EXPECT_TRUE(decodeMeshAddresses(encodeMeshAddresses({})).empty());
+}
+
+TEST(GlooBootstrapTest, TruncatedMeshAddressesThrow) {
+  const auto bytes = encodeMeshAddresses({{{'a', 'b'}, {}}, {{'c'}}});
+  for (size_t len = 0; len < bytes.size(); len++) {
+    EXPECT_THROW(
+        decodeMeshAddresses(
+            std::vector<uint8_t>(bytes.begin(), bytes.begin() + len)),
+        std::runtime_error)
+        << "length " << len;
+  }
+  // A corrupt count must not allocate for it
+  EXPECT_THROW(
+      decodeMeshAddresses({0xff, 0xff, 0xff, 0xff}), std::runtime_error);
+}
+
+} // namespace test
+} // namespace comms
+} // namespace torch
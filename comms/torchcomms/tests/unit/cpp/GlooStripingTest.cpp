@@ -0,0 +1,132 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include "comms/torchcomms/gloo/GlooStriping.hpp"
+
+namespace torch {
+namespace comms {
+namespace test {
+
+namespace {
+
+void expectCovers(const std::vector<StripeRange>& stripes, size_t count) {
+  size_t offset = 0;
+  for (const auto& stripe : stripes) {
+    EXPECT_EQ(stripe.offset, offset);
+    offset += stripe.count;
+  }
+  EXPECT_EQ(offset, count);
+}
+
+} // namespace
+
+TEST(GlooStripingTest, SmallTensorsUseOneStripe) {
+  auto stripes = planStripes(1000, 4, 8, 1 << 20);
+  ASSERT_EQ(stripes.size(), 1);
+  expectCovers(stripes, 1000);
+
+  stripes = planStripes(0, 4, 8, 1 << 20);
+  ASSERT_EQ(stripes.size(), 1);
+  EXPECT_EQ(stripes[0].count, 0);
+}
+
+TEST(GlooStripingTest, StripesBoundedByMinBytes) {
+  // 3 MiB of floats with a 1 MiB minimum
+  const size_t count = 3 * (1 << 20) / 4;
+  auto stripes = planStripes(count, 4, 8, 1 << 20);
+  EXPECT_EQ(stripes.size(), 3);
+  expectCovers(stripes, count);
+}
+
+TEST(GlooStripingTest, StripesBoundedByMaxStripes) {
+  const size_t count = 64 << 20;
+  auto stripes = planStripes(count, 4, 4, 1 << 20);
+  ASSERT_EQ(stripes.size(), 4);
+  expectCovers(stripes, count);
+  for (const auto& stripe : stripes) {
+    EXPECT_EQ(stripe.count, count / 4);
+  }
+
+  EXPECT_EQ(planStripes(count, 4, 1, 1 << 20).size(), 1);
+  EXPECT_EQ(planStripes(count, 4, 0, 1 << 20).size(), 1);
+}
+
+TEST(GlooStripingTest, UnevenSplit) {
+  auto stripes = planStripes(10, 1, 4, 1);
+  ASSERT_EQ(stripes.size(), 4);
+  expectCovers(stripes, 10);
+  EXPECT_EQ(stripes[0].count, 3);
+  EXPECT_EQ(stripes[1].count, 3);
+  EXPECT_EQ(stripes[2].count, 2);
+  EXPECT_EQ(stripes[3].count, 2);
+
+  // Never more stripes than elements
+  EXPECT_EQ(planStripes(2, 1 << 20, 8, 1).size(), 2);
+}
+
+TEST(GlooStripingTest, StripeWorkersRunEveryStripe) {
+  StripeWorkers workers;
+  std::vector<std::atomic<int>> runs(5);
+  workers.run(runs.size(), [&](size_t s) { runs[s]++; });
+  for (auto& r : runs) {
+    EXPECT_EQ(r.load(), 1);
+  }
+}
+
+TEST(GlooStripingTest, StripeWorkersRethrowAfterAllStripes) {
+  StripeWorkers workers;
+  std::atomic<int> finished{0};
+  EXPECT_THROW(
+      workers.run(
+          4,
+          [&](size_t s) {
+            if (s == 2) {
+              throw std::runtime_error("stripe failed");
+            }
+            finished++;
+          }),
+      std::runtime_error);
+  EXPECT_EQ(finished.load(), 3);
+}
+
+TEST(GlooStripingTest, StripeWorkersReuseThreads) {
+  StripeWorkers workers;
+  std::mutex mutex;
+  std::set<std::thread::id> ids;
+  for (int i = 0; i < 10; i++) {
+    workers.run(4, [&](size_t s) {
+      if (s > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ids.insert(std::this_thread::get_id());
+      }
+    });
+  }
+  // Never more workers than one run needs at once
+  EXPECT_LE(workers.numThreads(), 3);
+  EXPECT_LE(ids.size(), workers.numThreads());
+}
+
+TEST(GlooStripingTest, StripeWorkersRunConcurrentCollectives) {
+  // Every stripe of both runs must be running at once to finish, as for
+  // concurrent collectives whose stripes wait on peers
+  StripeWorkers workers;
+  const size_t numStripes = 4;
+  std::latch allRunning(2 * numStripes);
+  auto fn = [&](size_t) { allRunning.arrive_and_wait(); };
+  std::thread other([&]() { workers.run(numStripes, fn); });
+  workers.run(numStripes, fn);
+  other.join();
+  EXPECT_EQ(workers.numThreads(), 2 * (numStripes - 1));
+}
+
+} // namespace test
+} // namespace comms
+} // namespace torch
@@ -0,0 +1,162 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+
+#include "comms/torchcomms/gloo/GlooTree.hpp"
+
+namespace torch {
+namespace comms {
+namespace test {
+
+namespace {
+
+const std::vector<int> kSizes = {1, 2, 3, 5, 6, 7, 8, 9, 13, 16, 31, 33, 100};
+
+// Runs a tree scatter of one int block per rank the way treeScatter does and
+// returns the block each rank ends up with.
+std::vector<int> simulateScatter(int size, int root) {
+  std::vector<std::vector<int>> staging(size);
+  for (int v = 0; v < size; v++) {
+    staging[root].push_back((v + root) % size);
+  }
+  std::vector<int> result(size, -1);
+  std::deque<int> ready = {root};
+  while (!ready.empty()) {
+    const int rank = ready.front();
+    ready.pop_front();
+    const auto node = binomialTreeNode(rank, size, root);
+    EXPECT_EQ(staging[rank].size(), node.numBlocks);
+    for (const auto& child : node.children) {
+      const auto begin = staging[rank].begin() + child.blockOffset;
+      EXPECT_TRUE(staging[child.rank].empty());
+      staging[child.rank].assign(begin, begin + child.numBlocks);
+      ready.push_back(child.rank);
+    }
+    result[rank] = staging[rank].at(0);
+  }
+  return result;
+}
+
+// Runs a tree gather of each rank's number the way treeGather does, leaves
+// first, and returns what the root ends up with for every rank.
+std::vector<int> simulateGather(int size, int root) {
+  std::vector<std::vector<int>> staging(size);
+  std::vector<BinomialTreeNode> nodes;
+  for (int rank = 0; rank < size; rank++) {
+    nodes.push_back(binomialTreeNode(rank, size, root));
+    staging[rank].assign(nodes[rank].numBlocks, -1);
+    staging[rank][0] = rank;
+  }
+  // Deeper subtrees finish first: order ranks by subtree size
+  std::vector<int> order(size);
+  for (int rank = 0; rank < size; rank++) {
+    order[rank] = rank;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return nodes[a].numBlocks < nodes[b].numBlocks;
+  });
+  for (int rank : order) {
+    const auto& node = nodes[rank];
+    if (node.parent < 0) {
+      continue;
+    }
+    const auto& parent = nodes[node.parent];
+    auto it = std::find_if(
+        parent.children.begin(), parent.children.end(), [&](const auto& c) {
+          return c.rank == rank;
+        });
+    EXPECT_NE(it, parent.children.end());
+    std::copy(
+        staging[rank].begin(),
+        staging[rank].end(),
+        staging[node.parent].begin() + it->blockOffset);
+  }
+
+  std::vector<int> result(size);
+  for (int v = 0; v < size; v++) {
+    result[(v + root) % size] = staging[root][v];
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(GlooTreeTest, RootHasLogChildren) {
+  for (int size : kSizes) {
+    for (int root = 0; root < size; root++) {
+      const auto node = binomialTreeNode(root, size, root);
+      EXPECT_EQ(node.parent, -1);
+      EXPECT_EQ(node.numBlocks, size);
+      size_t expected = 0;
+      while ((1 << expected) < size) {
+        expected++;
+      }
+      EXPECT_EQ(node.children.size(), expected);
+    }
+  }
+}
+
+TEST(GlooTreeTest, ParentsAndChildrenAgree) {
+  for (int size : kSizes) {
+    for (int root = 0; root < size; root++) {
+      std::vector<int> timesChild(size, 0);
+      for (int rank = 0; rank < size; rank++) {
+        const auto node = binomialTreeNode(rank, size, root);
+        size_t covered = 1;
+        size_t prevBlocks = node.numBlocks;
+        for (const auto& child : node.children) {
+          timesChild[child.rank]++;
+          const auto childNode = binomialTreeNode(child.rank, size, root);
+          EXPECT_EQ(childNode.parent, rank);
+          EXPECT_EQ(childNode.numBlocks, child.numBlocks);
+          // Children cover the rest of the subtree, largest first
+          EXPECT_LE(child.numBlocks, prevBlocks);
+          EXPECT_LE(child.blockOffset + child.numBlocks, node.numBlocks);
+          prevBlocks = child.numBlocks;
+          covered += child.numBlocks;
+        }
+        EXPECT_EQ(covered, node.numBlocks);
+      }
+      for (int rank = 0; rank < size; rank++) {
+        EXPECT_EQ(timesChild[rank], rank == root ? 0 : 1);
+      }
+    }
+  }
+}
+
+TEST(GlooTreeTest, ScatterDeliversEveryBlock) {
+  for (int size : kSizes) {
+    for (int root = 0; root < size; root++) {
+      const auto result = simulateScatter(size, root);
+      for (int rank = 0; rank < size; rank++) {
+        EXPECT_EQ(result[rank], rank) << "size " << size << " root " << root;
+      }
+    }
+  }
+}
+
+TEST(GlooTreeTest, GatherCollectsEveryBlock) {
+  for (int size : kSizes) {
+    for (int root = 0; root < size; root++) {
+      const auto result = simulateGather(size, root);
+      for (int rank = 0; rank < size; rank++) {
+        EXPECT_EQ(result[rank], rank) << "size " << size << " root " << root;
+      }
+    }
+  }
+}
+
+TEST(GlooTreeTest, SelectionBySizeAndBlockBytes) {
+  EXPECT_TRUE(useBinomialTree(16, 1024, 8, 4096));
+  EXPECT_TRUE(useBinomialTree(8, 4096, 8, 4096));
+  EXPECT_FALSE(useBinomialTree(7, 1024, 8, 4096));
+  EXPECT_FALSE(useBinomialTree(16, 4097, 8, 4096));
+  EXPECT_FALSE(useBinomialTree(16, 0, 8, 4096));
+}
+
+} // namespace test
+} // namespace comms
+} // namespace torch
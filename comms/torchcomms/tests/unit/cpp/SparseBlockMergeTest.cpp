@@ -0,0 +1,205 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "comms/torchcomms/gloo/SparseBlockMerge.hpp"
+
+namespace torch {
+namespace comms {
+namespace test {
+
+namespace {
+
+template <typename T>
+void sum(void* c, const void* a, const void* b, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    static_cast<T*>(c)[i] =
+        static_cast<const T*>(a)[i] + static_cast<const T*>(b)[i];
+  }
+}
+
+template <typename T>
+void max(void* c, const void* a, const void* b, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    static_cast<T*>(c)[i] =
+        std::max(static_cast<const T*>(a)[i], static_cast<const T*>(b)[i]);
+  }
+}
+
+// Block-sparse inputs of all ranks, concatenated as after the all-gather.
+struct Gathered {
+  std::vector<int64_t> counts;
+  std::vector<int64_t> indices;
+  std::vector<float> blocks;
+  // Dense form of every rank's input
+  std::vector<std::vector<float>> dense;
+};
+
+Gathered makeGathered(
+    int nRanks,
+    size_t numBlocks,
+    size_t blockLength,
+    double density,
+    bool sorted) {
+  Gathered g;
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> value(-8, 8);
+  for (int r = 0; r < nRanks; r++) {
+    std::vector<int64_t> all(numBlocks);
+    std::iota(all.begin(), all.end(), 0);
+    std::shuffle(all.begin(), all.end(), gen);
+    all.resize(numBlocks * density);
+    if (sorted) {
+      std::sort(all.begin(), all.end());
+    }
+
+    g.counts.push_back(all.size());
+    g.dense.emplace_back(numBlocks * blockLength, 0.0f);
+    for (auto idx : all) {
+      g.indices.push_back(idx);
+      for (size_t i = 0; i < blockLength; i++) {
+        float v = value(gen);
+        g.blocks.push_back(v);
+        g.dense[r][idx * blockLength + i] = v;
+      }
+    }
+  }
+  return g;
+}
+
+std::vector<float> denseReduce(
+    const Gathered& g,
+    float (*op)(const float&, const float&)) {
+  std::vector<float> out = g.dense[0];
+  for (size_t r = 1; r < g.dense.size(); r++) {
+    for (size_t i = 0; i < out.size(); i++) {
+      out[i] = op(out[i], g.dense[r][i]);
+    }
+  }
+  return out;
+}
+
+float add(const float& a, const float& b) {
+  return a + b;
+}
+
+float maximum(const float& a, const float& b) {
+  return std::max(a, b);
+}
+
+} // namespace
+
+class SparseBlockMergeTest
+    : public ::testing::TestWithParam<std::tuple<double, size_t, bool>> {};
+
+TEST_P(SparseBlockMergeTest, SumMatchesDense) {
+  const auto [density, blockLength, sorted] = GetParam();
+  constexpr size_t kNumBlocks = 100;
+  auto g = makeGathered(4, kNumBlocks, blockLength, density, sorted);
+
+  std::vector<float> out(kNumBlocks * blockLength, 42.0f);
+  mergeSparseBlocks(
+      g.counts,
+      g.indices.data(),
+      g.blocks.data(),
+      blockLength,
+      kNumBlocks,
+      sum<float>,
+      false,
+      out.data());
+  EXPECT_EQ(out, denseReduce(g, add));
+}
+
+TEST_P(SparseBlockMergeTest, MaxMatchesDense) {
+  const auto [density, blockLength, sorted] = GetParam();
+  constexpr size_t kNumBlocks = 100;
+  auto g = makeGathered(4, kNumBlocks, blockLength, density, sorted);
+
+  // Absent blocks are zeros, so they win over negative contributions
+  std::vector<float> out(kNumBlocks * blockLength, 42.0f);
+  mergeSparseBlocks(
+      g.counts,
+      g.indices.data(),
+      g.blocks.data(),
+      blockLength,
+      kNumBlocks,
+      max<float>,
+      true,
+      out.data());
+  EXPECT_EQ(out, denseReduce(g, maximum));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SparseBlockMergeTestInstance,
+    SparseBlockMergeTest,
+    ::testing::Combine(
+        ::testing::Values(0.0, 0.01, 0.3, 1.0),
+        ::testing::Values(1, 7),
+        ::testing::Values(true, false)));
+
+TEST(SparseBlockMergeTest, RanksWithoutBlocks) {
+  const std::vector<int64_t> counts = {0, 2, 0, 1};
+  const std::vector<int64_t> indices = {3, 1, 3};
+  const std::vector<int> blocks = {1, 2, 3, 4, 5, 6};
+  std::vector<int> out(10, -1);
+  mergeSparseBlocks(
+      counts,
+      indices.data(),
+      blocks.data(),
+      2,
+      5,
+      sum<int>,
+      false,
+      out.data());
+  EXPECT_EQ(out, std::vector<int>({0, 0, 3, 4, 0, 0, 6, 8, 0, 0}));
+}
+
+TEST(SparseBlockMergeTest, RejectsBadIndices) {
+  const std::vector<float> blocks = {1, 2};
+  std::vector<float> out(4);
+  for (const auto& indices :
+       {std::vector<int64_t>{0, 4}, std::vector<int64_t>{-1, 0}}) {
+    EXPECT_THROW(
+        mergeSparseBlocks(
+            {2},
+            indices.data(),
+            blocks.data(),
+            1,
+            4,
+            sum<float>,
+            false,
+            out.data()),
+        std::runtime_error);
+    EXPECT_THROW(
+        checkSparseBlockIndices(indices.data(), indices.size(), 4),
+        std::runtime_error);
+  }
+
+  const std::vector<int64_t> dup = {2, 2};
+  EXPECT_THROW(
+      mergeSparseBlocks(
+          {2}, dup.data(), blocks.data(), 1, 4, sum<float>, false, out.data()),
+      std::runtime_error);
+  EXPECT_THROW(checkSparseBlockIndices(dup.data(), 2, 4), std::runtime_error);
+
+  // The same index on different ranks is reduced, not a duplicate
+  EXPECT_NO_THROW(mergeSparseBlocks(
+      {1, 1}, dup.data(), blocks.data(), 1, 4, sum<float>, false, out.data()));
+  EXPECT_EQ(out, std::vector<float>({0, 0, 3, 0}));
+}
+
+TEST(SparseBlockMergeTest, ScatterMatchesDense) {
+  auto g = makeGathered(1, 50, 3, 0.2, false);
+  std::vector<float> out(150, 42.0f);
+  scatterSparseBlocks(
+      g.indices.data(), g.counts[0], g.blocks.data(), 3, 50, out.data());
+  EXPECT_EQ(out, g.dense[0]);
+}
+
+} // namespace test
+} // namespace comms
+} // namespace torch
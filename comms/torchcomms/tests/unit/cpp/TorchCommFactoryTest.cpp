@@ -166,5 +166,59 @@ TEST_F(TorchCommBackendFactoryTest, NewCommIntegration) {
   EXPECT_TRUE(work->isCompleted());
 }
 
+TEST_F(TorchCommBackendFactoryTest, CreateBackendsBatch) {
+  std::vector<CommSpec> specs;
+  for (int i = 0; i < 8; i++) {
+    specs.push_back(
+        CommSpec{
+            .backend = backend_name_,
+            .device = at::Device(at::kCPU),
+            .name = "batch_comm_" + std::to_string(i)});
+  }
+
+  for (size_t max_concurrency : {0, 1, 3}) {
+    auto backends =
+        TorchCommFactory::get().create_backends(specs, max_concurrency);
+    ASSERT_EQ(backends.size(), specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+      ASSERT_NE(backends[i], nullptr);
+      EXPECT_EQ(backends[i]->getCommName(), specs[i].name);
+      EXPECT_EQ(backends[i]->getBackendName(), backend_name_);
+    }
+  }
+}
+
+TEST_F(TorchCommBackendFactoryTest, CreateBackendsUnsupported) {
+  std::vector<CommSpec> specs(2);
+  specs[0].backend = backend_name_;
+  specs[0].name = "batch_comm_ok";
+  specs[1].backend = "unsupported";
+  specs[1].name = "batch_comm_unsupported";
+
+  EXPECT_THROW(
+      TorchCommFactory::get().create_backends(specs), std::runtime_error);
+}
+
+TEST_F(TorchCommBackendFactoryTest, NewCommsIntegration) {
+  std::vector<CommSpec> specs(4);
+  for (size_t i = 0; i < specs.size(); i++) {
+    specs[i].backend = backend_name_;
+    specs[i].name = "new_comms_" + std::to_string(i);
+  }
+  auto torchcomms = new_comms(specs);
+  ASSERT_EQ(torchcomms.size(), specs.size());
+
+  for (size_t i = 0; i < specs.size(); i++) {
+    ASSERT_NE(torchcomms[i], nullptr);
+    EXPECT_EQ(torchcomms[i]->getBackend(), backend_name_);
+    EXPECT_EQ(torchcomms[i]->getCommName(), specs[i].name);
+    auto tensor = at::ones({2, 2}, at::kFloat);
+    auto work = torchcomms[i]->all_reduce(
+        tensor, ReduceOp::SUM, true, AllReduceOptions{});
+    ASSERT_NE(work, nullptr);
+    EXPECT_TRUE(work->isCompleted());
+  }
+}
+
 } // namespace comms
 } // namespace torch
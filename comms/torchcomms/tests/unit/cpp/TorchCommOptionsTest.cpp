@@ -76,6 +76,42 @@ TEST(TorchCommOptionsTest, StringToBool) {
   EXPECT_THROW(torch::comms::string_to_bool("falsey"), std::runtime_error);
 }
 
+TEST(TorchCommOptionsTest, MeshGroupRanks) {
+  // 2x3x2 mesh, i.e. torch.arange(12).view(2, 3, 2)
+  const std::vector<int> shape = {2, 3, 2};
+  const std::vector<std::string> names = {"pp", "dp", "tp"};
+
+  auto groups = torch::comms::mesh_group_ranks(shape, names, 7, 12);
+  ASSERT_EQ(groups.size(), 3);
+  EXPECT_EQ(groups[0], std::vector<int>({1, 7}));
+  EXPECT_EQ(groups[1], std::vector<int>({7, 9, 11}));
+  EXPECT_EQ(groups[2], std::vector<int>({6, 7}));
+
+  // Every rank is in exactly one group per dimension, at its coordinate
+  for (int rank = 0; rank < 12; rank++) {
+    auto rank_groups = torch::comms::mesh_group_ranks(shape, names, rank, 12);
+    for (size_t d = 0; d < shape.size(); d++) {
+      ASSERT_EQ(rank_groups[d].size(), static_cast<size_t>(shape[d]));
+      EXPECT_EQ(
+          std::count(rank_groups[d].begin(), rank_groups[d].end(), rank), 1);
+    }
+  }
+
+  // A 1-D mesh is the whole communicator
+  EXPECT_EQ(
+      torch::comms::mesh_group_ranks({4}, {"world"}, 2, 4)[0],
+      std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(TorchCommOptionsTest, MeshGroupRanksInvalid) {
+  using torch::comms::mesh_group_ranks;
+  EXPECT_THROW(mesh_group_ranks({2, 2}, {"a", "b"}, 0, 8), std::runtime_error);
+  EXPECT_THROW(mesh_group_ranks({2, 4}, {"a"}, 0, 8), std::runtime_error);
+  EXPECT_THROW(mesh_group_ranks({2, 4}, {"a", "a"}, 0, 8), std::runtime_error);
+  EXPECT_THROW(mesh_group_ranks({0, 8}, {"a", "b"}, 0, 0), std::runtime_error);
+  EXPECT_THROW(mesh_group_ranks({}, {}, 0, 1), std::runtime_error);
+}
+
 } // namespace test
 } // namespace comms
 } // namespace torch
@@ -0,0 +1,79 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace torch::comms {
+
+/*
+ * Knobs controlling how RdmaTransport drives its progress loop on the shared
+ * EventBase.
+ */
+struct RdmaProgressPolicy {
+  // Number of consecutive progress slices without any completion during which
+  // the loop keeps polling back to back before it starts backing off.
+  uint32_t spinSlices{64};
+  // First backoff interval once idle; doubled after every further idle slice.
+  std::chrono::microseconds minBackoff{1};
+  // Upper bound of the backoff interval. Zero disables backoff, i.e. poll
+  // continuously while work is pending.
+  std::chrono::microseconds maxBackoff{100};
+  // Maximum number of pending works inspected per progress slice, so that
+  // transports sharing an EventBase get a turn between slices. Hitting it
+  // does not count as progress: the next slice starts where this one stopped
+  // but is delayed like any other.
+  size_t maxWorksPerSlice{256};
+};
+
+/*
+ * Computes when the next progress slice should run: immediately while
+ * completions keep arriving, with exponential backoff once idle.
+ *
+ * Not thread-safe; only used from the EventBase thread.
+ */
+class RdmaProgressScheduler {
+ public:
+  explicit RdmaProgressScheduler(const RdmaProgressPolicy& policy)
+      : policy_(policy) {}
+
+  /*
+   * Report the number of works completed in a progress slice and return the
+   * delay before the next one.
+   */
+  std::chrono::microseconds next(size_t completed) {
+    if (completed > 0) {
+      idleSlices_ = 0;
+      backoff_ = std::chrono::microseconds(0);
+      return backoff_;
+    }
+    if (++idleSlices_ <= policy_.spinSlices) {
+      return std::chrono::microseconds(0);
+    }
+    backoff_ = backoff_.count() == 0 ? policy_.minBackoff : backoff_ * 2;
+    backoff_ = std::min(backoff_, policy_.maxBackoff);
+    return backoff_;
+  }
+
+  /*
+   * New work was submitted; poll eagerly again.
+   */
+  void reset() {
+    idleSlices_ = 0;
+    backoff_ = std::chrono::microseconds(0);
+  }
+
+  size_t maxWorksPerSlice() const {
+    return std::max<size_t>(policy_.maxWorksPerSlice, 1);
+  }
+
+ private:
+  const RdmaProgressPolicy policy_;
+  uint32_t idleSlices_{0};
+  std::chrono::microseconds backoff_{0};
+};
+
+} // namespace torch::comms
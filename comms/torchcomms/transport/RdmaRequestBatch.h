@@ -0,0 +1,74 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "comms/ctran/backends/ib/CtranIbBase.h"
+
+namespace torch::comms {
+
+/*
+ * IB requests of one RdmaTransport operation. A vectored operation
+ * (writev/readv) issues one CtranIb request per buffer but reports a single
+ * completion once all of them have completed.
+ *
+ * Requests are allocated up front and never move, since CtranIb keeps
+ * pointers to them until they complete.
+ */
+class RdmaRequestBatch {
+ public:
+  explicit RdmaRequestBatch(size_t size) : reqs_(size), size_(size) {}
+
+  RdmaRequestBatch(const RdmaRequestBatch&) = delete;
+  RdmaRequestBatch& operator=(const RdmaRequestBatch&) = delete;
+
+  CtranIbRequest* at(size_t idx) {
+    if (idx >= size_) {
+      throw std::out_of_range("RdmaRequestBatch index out of range");
+    }
+    return &reqs_[idx];
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  /*
+   * Post every request with postFn(idx, req), in order. If a post fails, the
+   * batch shrinks to the requests posted before it and the error is
+   * returned. Those requests are in flight and CtranIb still references
+   * them, so the batch must stay alive until complete() returns true.
+   */
+  template <typename PostFn>
+  commResult_t post(PostFn&& postFn) {
+    for (size_t i = 0; i < size_; i++) {
+      const commResult_t res = postFn(i, &reqs_[i]);
+      if (res != commSuccess) {
+        size_ = i;
+        return res;
+      }
+    }
+    return commSuccess;
+  }
+
+  /*
+   * Return true once every request of the batch has completed. Requests may
+   * complete in any order; the already completed prefix is not rechecked.
+   */
+  bool complete() {
+    while (numCompleted_ < size_ && reqs_[numCompleted_].isComplete()) {
+      numCompleted_++;
+    }
+    return numCompleted_ == size_;
+  }
+
+ private:
+  std::vector<CtranIbRequest> reqs_;
+  // Requests of the batch; fewer than reqs_ if posting one failed
+  size_t size_;
+  size_t numCompleted_{0};
+};
+
+} // namespace torch::comms
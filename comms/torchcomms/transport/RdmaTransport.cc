@@ -1,6 +1,9 @@
 // Copyright (c) Meta Platforms, Inc. and affiliates.
 
 #include "RdmaTransport.h"
+#include "RdmaRequestBatch.h"
+
+#include <algorithm>
 
 #include "comms/ctran/backends/ib/CtranIb.h"
 #include "comms/ctran/utils/Checks.h"
@@ -9,7 +12,6 @@
 
 namespace {
 
-constexpr std::chrono::microseconds kProgressInterval{0};
 constexpr int kDummyRank = 0;
 constexpr int kDummyDevice = 0;
 
@@ -22,6 +24,23 @@ void initEnvironment() {
   });
 }
 
+// Buffers of a batch usually belong to the same remote registration; only
+// parse the access key when it differs from the previous buffer's.
+class RemoteKeyParser {
+ public:
+  const CtranIbRemoteAccessKey& parse(const std::string& accessKey) {
+    if (!lastKey_ || *lastKey_ != accessKey) {
+      key_ = CtranIbRemoteAccessKey::fromString(accessKey);
+      lastKey_ = &accessKey;
+    }
+    return key_;
+  }
+
+ private:
+  const std::string* lastKey_{nullptr};
+  CtranIbRemoteAccessKey key_;
+};
+
 } // namespace
 
 namespace torch::comms {
@@ -44,13 +63,27 @@ bool RdmaMemory::contains(const void* buf, size_t len) const {
 }
 
 struct RdmaTransport::Work {
-  bool isWrite{true};
-  CtranIbRequest ibReq;
+  enum class Type { kWrite, kWaitForWrite, kRead };
+
+  explicit Work(Type type, size_t numReqs = 0) : type(type), reqs(numReqs) {}
+
+  const Type type;
+  // One request per buffer; completes the promise once all are complete
+  RdmaRequestBatch reqs;
+  // writev with notify: post a single notification after all writes completed
+  bool notifyOnComplete{false};
+  bool notifyPosted{false};
+  CtranIbRequest notifyReq;
+  // Error posting reqs; reported once the requests posted before completed
+  commResult_t postResult{commSuccess};
   folly::Promise<commResult_t> promise;
 };
 
-RdmaTransport::RdmaTransport(int cudaDev, folly::EventBase* evb)
-    : cudaDev_(cudaDev), evb_(evb) {
+RdmaTransport::RdmaTransport(
+    int cudaDev,
+    folly::EventBase* evb,
+    RdmaProgressPolicy progressPolicy)
+    : cudaDev_(cudaDev), evb_(evb), progressScheduler_(progressPolicy) {
   initEnvironment();
   // Create IB Instance
   ib_ = std::make_unique<CtranIb>(
@@ -129,8 +162,7 @@ folly::SemiFuture<commResult_t> RdmaTransport::write(
   CHECK(cudaDev_ == localBuffer->getDevice());
 
   auto ibRemoteKey = CtranIbRemoteAccessKey::fromString(remoteBuffer.accessKey);
-  auto work = std::make_unique<Work>();
-  work->isWrite = true;
+  auto work = std::make_unique<Work>(Work::Type::kWrite, 1);
   auto sf = work->promise.getSemiFuture();
 
   CtranIbEpochRAII epochRAII(ib_.get());
@@ -143,14 +175,55 @@ folly::SemiFuture<commResult_t> RdmaTransport::write(
       ibRemoteKey,
       notify,
       nullptr,
-      &work->ibReq,
+      work->reqs.at(0),
       false));
 
-  // Add work to pending list and schedule progress
-  auto pendingWorks = pendingWorks_.wlock();
-  pendingWorks->emplace_back(std::move(work));
-  evb_->runInEventBaseThread([this]() { progress(); });
+  enqueueWork(std::move(work));
+  return sf;
+}
+
+folly::SemiFuture<commResult_t> RdmaTransport::writev(
+    const std::vector<RdmaMemory::View>& localBuffers,
+    const std::vector<RdmaRemoteBuffer>& remoteBuffers,
+    bool notify) {
+  CHECK_THROW(connected(), std::runtime_error);
+  CHECK_THROW(evb_, std::runtime_error);
+  CHECK_THROW(
+      localBuffers.size() == remoteBuffers.size(), std::invalid_argument);
+
+  auto work = std::make_unique<Work>(Work::Type::kWrite, localBuffers.size());
+  // Writes may be spread over several QPs, so per-write notifications do not
+  // tell the remote side that the earlier writes have landed. Notify once
+  // after every write has completed instead.
+  work->notifyOnComplete = notify;
+  auto sf = work->promise.getSemiFuture();
 
+  RemoteKeyParser keyParser;
+  CtranIbEpochRAII epochRAII(ib_.get());
+  work->postResult =
+      work->reqs.post([&](size_t i, CtranIbRequest* req) -> commResult_t {
+        const auto& localBuffer = localBuffers[i];
+        const auto& remoteBuffer = remoteBuffers[i];
+        CHECK(cudaDev_ == localBuffer->getDevice());
+        return ib_->iput(
+            localBuffer.data(),
+            remoteBuffer.ptr,
+            localBuffer.size(),
+            kDummyRank,
+            localBuffer->localKey(),
+            keyParser.parse(remoteBuffer.accessKey),
+            false /* notify */,
+            nullptr,
+            req,
+            false);
+      });
+  if (work->postResult != commSuccess) {
+    LOG(ERROR) << "writev failed after posting " << work->reqs.size()
+               << " of " << localBuffers.size() << " writes";
+  }
+
+  // Enqueued even on a failed post, to keep the posted requests alive
+  enqueueWork(std::move(work));
   return sf;
 }
 
@@ -158,18 +231,67 @@ folly::SemiFuture<commResult_t> RdmaTransport::waitForWrite() {
   CHECK_THROW(connected(), std::runtime_error);
   CHECK_THROW(evb_, std::runtime_error);
 
-  auto work = std::make_unique<Work>();
-  work->isWrite = false;
+  auto work = std::make_unique<Work>(Work::Type::kWaitForWrite);
   auto sf = work->promise.getSemiFuture();
 
-  // Add work to pending list and schedule progress
-  auto pendingWorks = pendingWorks_.wlock();
-  pendingWorks->emplace_back(std::move(work));
-  evb_->runInEventBaseThread([this]() { progress(); });
+  enqueueWork(std::move(work));
+  return sf;
+}
+
+folly::SemiFuture<commResult_t> RdmaTransport::read(
+    RdmaMemory::View localBuffer,
+    const RdmaRemoteBuffer& remoteBuffer) {
+  return readv({localBuffer}, {remoteBuffer});
+}
+
+folly::SemiFuture<commResult_t> RdmaTransport::readv(
+    const std::vector<RdmaMemory::View>& localBuffers,
+    const std::vector<RdmaRemoteBuffer>& remoteBuffers) {
+  CHECK_THROW(connected(), std::runtime_error);
+  CHECK_THROW(evb_, std::runtime_error);
+  CHECK_THROW(
+      localBuffers.size() == remoteBuffers.size(), std::invalid_argument);
+
+  auto work = std::make_unique<Work>(Work::Type::kRead, localBuffers.size());
+  auto sf = work->promise.getSemiFuture();
+
+  RemoteKeyParser keyParser;
+  CtranIbEpochRAII epochRAII(ib_.get());
+  work->postResult =
+      work->reqs.post([&](size_t i, CtranIbRequest* req) -> commResult_t {
+        const auto& localBuffer = localBuffers[i];
+        const auto& remoteBuffer = remoteBuffers[i];
+        CHECK(cudaDev_ == localBuffer->getDevice());
+        return ib_->iget(
+            remoteBuffer.ptr,
+            const_cast<void*>(localBuffer.data()),
+            localBuffer.size(),
+            kDummyRank,
+            localBuffer->localKey(),
+            keyParser.parse(remoteBuffer.accessKey),
+            nullptr,
+            req,
+            false);
+      });
+  if (work->postResult != commSuccess) {
+    LOG(ERROR) << "readv failed after posting " << work->reqs.size()
+               << " of " << localBuffers.size() << " reads";
+  }
 
+  // Enqueued even on a failed post, to keep the posted requests alive
+  enqueueWork(std::move(work));
   return sf;
 }
 
+void RdmaTransport::enqueueWork(std::unique_ptr<Work> work) {
+  auto pendingWorks = pendingWorks_.wlock();
+  pendingWorks->emplace_back(std::move(work));
+  evb_->runInEventBaseThread([this]() {
+    progressScheduler_.reset();
+    progress();
+  });
+}
+
 void RdmaTransport::progress() {
   CtranIbEpochRAII epochRAII(ib_.get());
   auto res = ib_->progress();
@@ -179,26 +301,53 @@ void RdmaTransport::progress() {
     LOG(ERROR) << "IB progress failed";
   }
 
+  // Bound the slice so other transports on the EventBase get a turn; an
+  // error fails every pending work regardless.
+  const size_t maxWorks = progressScheduler_.maxWorksPerSlice();
+  size_t inspected = 0;
+  size_t completed = 0;
+
   auto pendingWorks = pendingWorks_.wlock();
-  for (auto it = pendingWorks->begin(); it != pendingWorks->end();) {
+  auto it = pendingWorks->begin();
+  while (it != pendingWorks->end() && (hasError || inspected < maxWorks)) {
+    inspected++;
+    auto& work = **it;
     if (hasError) {
-      (*it)->promise.setValue(res);
+      work.promise.setValue(res);
       it = pendingWorks->erase(it);
       continue;
     }
 
-    if ((*it)->isWrite && (*it)->ibReq.isComplete()) {
-      (*it)->promise.setValue(hasError ? res : commSuccess);
-      it = pendingWorks->erase(it);
-      continue;
-    }
-
-    if (!(*it)->isWrite) {
+    if (work.type == Work::Type::kWaitForWrite) {
       bool done = false;
       auto waitRes = ib_->checkNotify(kDummyRank, &done);
       if (waitRes != commSuccess || done) {
-        (*it)->promise.setValue(waitRes);
+        work.promise.setValue(waitRes);
+        it = pendingWorks->erase(it);
+        completed++;
+        continue;
+      }
+    } else if (work.reqs.complete()) {
+      if (work.postResult != commSuccess) {
+        work.promise.setValue(work.postResult);
         it = pendingWorks->erase(it);
+        completed++;
+        continue;
+      }
+      if (work.notifyOnComplete && !work.notifyPosted) {
+        work.notifyPosted = true;
+        auto notifyRes = ib_->notify(kDummyRank, &work.notifyReq);
+        if (notifyRes != commSuccess) {
+          work.promise.setValue(notifyRes);
+          it = pendingWorks->erase(it);
+          completed++;
+          continue;
+        }
+      }
+      if (!work.notifyPosted || work.notifyReq.isComplete()) {
+        work.promise.setValue(commSuccess);
+        it = pendingWorks->erase(it);
+        completed++;
         continue;
       }
     }
@@ -207,9 +356,15 @@ void RdmaTransport::progress() {
     ++it;
   }
 
+  if (it != pendingWorks->end()) {
+    // Start the next slice with the works this slice did not reach
+    std::rotate(pendingWorks->begin(), it, pendingWorks->end());
+  }
+
   // Schedule progress if there are more pending works
   if (pendingWorks->size()) {
-    progressTimeout_->scheduleTimeoutHighRes(kProgressInterval);
+    progressTimeout_->scheduleTimeoutHighRes(
+        progressScheduler_.next(completed));
   }
 }
 
@@ -5,6 +5,7 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
@@ -13,6 +14,8 @@
 
 #include <comms/utils/commSpecs.h>
 
+#include "comms/torchcomms/transport/RdmaProgressScheduler.h"
+
 // Forward declaration
 class CtranIb;
 
@@ -141,19 +144,21 @@ struct RdmaRemoteBuffer {
  *
  * folly::EventBase is used to drive the underlying RDMA operations. User
  * should have a dedicated EventBase for for transport operations and can
- * be shared across all transport instances. When requests are pending, this
- * will likely keep EventBase thread pretty busy to minimize latency.
+ * be shared across all transport instances. While completions keep arriving
+ * the transport polls back to back to minimize latency; once idle it backs
+ * off exponentially and each progress slice is bounded, so that transports
+ * sharing the EventBase are not starved (see RdmaProgressPolicy).
  *
  * Supported RDMA APIs
  * - `write` -> RDMA write to a remote memory
+ * - `writev` -> Batch of RDMA writes with a single completion
  * - `waitForWrite` -> Wait for a remote write operation
+ * - `read` / `readv` -> RDMA read from a remote memory
  *
  * Future APIs that can be supported as per use-case. Given this framework
  * adding new APIs should be relatively straightforward.
  * - Send - RDMA Send (needs matching Recv on other end)
  * - Recv - RDMA Receive (needs mactching Send on other end)
- * - Read - RDMA Read from a remote memory
- * - waitForRead - Wait for a remote read operation
  * - <Atomic APIs>
  */
 class __attribute__((visibility("default"))) RdmaTransport {
@@ -163,8 +168,12 @@ class __attribute__((visibility("default"))) RdmaTransport {
    * cudaDev - Transport needs to use NIC for I/O. It does so by identifying
    *           the NIC associated with specified cudaDevice.
    * evb - EventLoop to drive the RDMA operations.
+   * progressPolicy - How the progress loop polls and backs off on evb.
    */
-  RdmaTransport(int cudaDev, folly::EventBase* evb = nullptr);
+  RdmaTransport(
+      int cudaDev,
+      folly::EventBase* evb = nullptr,
+      RdmaProgressPolicy progressPolicy = RdmaProgressPolicy());
 
   ~RdmaTransport();
 
@@ -202,12 +211,43 @@ class __attribute__((visibility("default"))) RdmaTransport {
       RdmaRemoteBuffer remoteBuffer,
       bool notify);
 
+  /*
+   * [Remote Op] Batched version of `write`. Transfers localBuffers[i] to
+   * remoteBuffers[i] for every i and completes once all transfers are done.
+   * With notify=true the remote side observes a single notification for the
+   * whole batch, i.e. one `waitForWrite` call, delivered once every write of
+   * the batch has landed. If posting a write fails, the later ones are not
+   * posted, no notification is sent, and the future fails with the error
+   * once the writes already posted have completed.
+   */
+  folly::SemiFuture<commResult_t> writev(
+      const std::vector<RdmaMemory::View>& localBuffers,
+      const std::vector<RdmaRemoteBuffer>& remoteBuffers,
+      bool notify);
+
   /*
    * [Remote Op] Check the arrival of incoming put transfer from the remote
    * rank.
    */
   folly::SemiFuture<commResult_t> waitForWrite();
 
+  /*
+   * [Remote Op] Transfer data from remote buffer on the peer rank into the
+   * local buffer via RDMA read. The remote side is not involved nor notified;
+   * it is up to the user to ensure the remote data is ready.
+   */
+  folly::SemiFuture<commResult_t> read(
+      RdmaMemory::View localBuffer,
+      const RdmaRemoteBuffer& remoteBuffer);
+
+  /*
+   * [Remote Op] Batched version of `read`, completes once all reads are done.
+   * A failed post fails the future like in `writev`.
+   */
+  folly::SemiFuture<commResult_t> readv(
+      const std::vector<RdmaMemory::View>& localBuffers,
+      const std::vector<RdmaRemoteBuffer>& remoteBuffers);
+
  private:
   /*
    * Drive the IB progress loop and drive completion of pending requests.
@@ -219,8 +259,16 @@ class __attribute__((visibility("default"))) RdmaTransport {
   folly::EventBase* evb_{nullptr};
 
   struct Work;
+
+  /*
+   * Add work to the pending list and schedule progress.
+   */
+  void enqueueWork(std::unique_ptr<Work> work);
+
   folly::Synchronized<std::deque<std::unique_ptr<Work>>> pendingWorks_;
   std::unique_ptr<folly::AsyncTimeout> progressTimeout_;
+  // Only accessed from the evb thread
+  RdmaProgressScheduler progressScheduler_;
 };
 
 } // namespace torch::comms
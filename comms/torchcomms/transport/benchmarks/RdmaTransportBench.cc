@@ -2,11 +2,16 @@
 
 #include <benchmark/benchmark.h>
 #include <cuda_runtime.h>
+#include <time.h>
 #include <chrono>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <vector>
 
+#include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
+#include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/io/async/ScopedEventBaseThread.h>
 
@@ -120,6 +125,223 @@ static void BM_RdmaTransport_Write(benchmark::State& state) {
   cudaFree(recvBuffer);
 }
 
+/**
+ * Connected sender/receiver pair with numPages pages registered on each side,
+ * used by the page transfer benchmarks below.
+ */
+struct PagedTransportPair {
+  PagedTransportPair(size_t pageSize, size_t numPages)
+      : evbThread(std::make_unique<folly::ScopedEventBaseThread>()) {
+    auto evb = evbThread->getEventBase();
+    sender = std::make_unique<RdmaTransport>(kSenderDev, evb);
+    receiver = std::make_unique<RdmaTransport>(kReceiverDev, evb);
+    const auto senderUrl = sender->bind();
+    const auto receiverUrl = receiver->bind();
+    sender->connect(receiverUrl);
+    receiver->connect(senderUrl);
+
+    const size_t bufferSize = pageSize * numPages;
+    CHECK_EQ(cudaSetDevice(kSenderDev), cudaSuccess);
+    CHECK_EQ(cudaMalloc(&sendBuffer, bufferSize), cudaSuccess);
+    sendMemory =
+        std::make_unique<RdmaMemory>(sendBuffer, bufferSize, kSenderDev);
+    CHECK_EQ(cudaSetDevice(kReceiverDev), cudaSuccess);
+    CHECK_EQ(cudaMalloc(&recvBuffer, bufferSize), cudaSuccess);
+    recvMemory =
+        std::make_unique<RdmaMemory>(recvBuffer, bufferSize, kReceiverDev);
+
+    for (size_t i = 0; i < numPages; i++) {
+      localPages.push_back(sendMemory->createView(i * pageSize, pageSize));
+      remotePages.push_back(
+          RdmaRemoteBuffer{
+              .ptr = static_cast<uint8_t*>(recvBuffer) + i * pageSize,
+              .accessKey = recvMemory->remoteKey()});
+    }
+  }
+
+  ~PagedTransportPair() {
+    localPages.clear();
+    sendMemory.reset();
+    recvMemory.reset();
+    cudaFree(sendBuffer);
+    cudaFree(recvBuffer);
+  }
+
+  static constexpr int kSenderDev = 0;
+  static constexpr int kReceiverDev = 1;
+
+  std::unique_ptr<folly::ScopedEventBaseThread> evbThread;
+  std::unique_ptr<RdmaTransport> sender;
+  std::unique_ptr<RdmaTransport> receiver;
+  void* sendBuffer{nullptr};
+  void* recvBuffer{nullptr};
+  std::unique_ptr<RdmaMemory> sendMemory;
+  std::unique_ptr<RdmaMemory> recvMemory;
+  std::vector<RdmaMemory::View> localPages;
+  std::vector<RdmaRemoteBuffer> remotePages;
+};
+
+/**
+ * Benchmark moving numPages pages with one write() and future per page
+ */
+static void BM_RdmaTransport_WritePages(benchmark::State& state) {
+  const size_t pageSize = state.range(0);
+  const size_t numPages = state.range(1);
+  PagedTransportPair pair(pageSize, numPages);
+
+  for (auto _ : state) {
+    std::vector<folly::SemiFuture<commResult_t>> futures;
+    futures.reserve(numPages);
+    for (size_t i = 0; i < numPages; i++) {
+      futures.push_back(
+          pair.sender->write(pair.localPages[i], pair.remotePages[i], false));
+    }
+    folly::collectAll(std::move(futures)).get();
+  }
+
+  state.SetBytesProcessed(state.iterations() * pageSize * numPages);
+  state.SetItemsProcessed(state.iterations() * numPages);
+}
+
+/**
+ * Benchmark moving numPages pages with a single writev()
+ */
+static void BM_RdmaTransport_Writev(benchmark::State& state) {
+  const size_t pageSize = state.range(0);
+  const size_t numPages = state.range(1);
+  PagedTransportPair pair(pageSize, numPages);
+
+  for (auto _ : state) {
+    pair.sender->writev(pair.localPages, pair.remotePages, false).get();
+  }
+
+  state.SetBytesProcessed(state.iterations() * pageSize * numPages);
+  state.SetItemsProcessed(state.iterations() * numPages);
+}
+
+/**
+ * Benchmark pulling numPages pages from the peer with a single readv()
+ */
+static void BM_RdmaTransport_Readv(benchmark::State& state) {
+  const size_t pageSize = state.range(0);
+  const size_t numPages = state.range(1);
+  PagedTransportPair pair(pageSize, numPages);
+
+  for (auto _ : state) {
+    pair.sender->readv(pair.localPages, pair.remotePages).get();
+  }
+
+  state.SetBytesProcessed(state.iterations() * pageSize * numPages);
+  state.SetItemsProcessed(state.iterations() * numPages);
+}
+
+//------------------------------------------------------------------------------
+// Progress Policy Benchmarks (mock backend)
+//------------------------------------------------------------------------------
+
+/**
+ * Stand-in for the IB backend: a request completes serviceTime after it was
+ * issued, like a waitForWrite whose peer writes later. Driven by
+ * RdmaProgressScheduler the same way RdmaTransport::progress() drives CtranIb,
+ * so latency and EventBase CPU of a policy can be measured without a NIC.
+ */
+class MockProgressLoop {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  MockProgressLoop(folly::EventBase* evb, RdmaProgressPolicy policy)
+      : evb_(evb), scheduler_(policy) {
+    progressTimeout_ =
+        folly::AsyncTimeout::make(*evb_, [this]() noexcept { progress(); });
+  }
+
+  ~MockProgressLoop() {
+    evb_->runInEventBaseThreadAndWait([this]() { progressTimeout_.reset(); });
+  }
+
+  // Returns the delay between the request becoming complete and its future
+  // being fulfilled.
+  folly::SemiFuture<Clock::duration> issue(Clock::duration serviceTime) {
+    Request req{Clock::now() + serviceTime, {}};
+    auto sf = req.promise.getSemiFuture();
+    pending_.wlock()->push_back(std::move(req));
+    evb_->runInEventBaseThread([this]() {
+      scheduler_.reset();
+      progress();
+    });
+    return sf;
+  }
+
+ private:
+  struct Request {
+    Clock::time_point readyAt;
+    folly::Promise<Clock::duration> promise;
+  };
+
+  void progress() {
+    const auto now = Clock::now();
+    size_t completed = 0;
+    auto pending = pending_.wlock();
+    while (!pending->empty() && pending->front().readyAt <= now) {
+      pending->front().promise.setValue(now - pending->front().readyAt);
+      pending->pop_front();
+      completed++;
+    }
+    if (!pending->empty()) {
+      progressTimeout_->scheduleTimeoutHighRes(scheduler_.next(completed));
+    }
+  }
+
+  folly::EventBase* evb_;
+  RdmaProgressScheduler scheduler_;
+  folly::Synchronized<std::deque<Request>> pending_;
+  std::unique_ptr<folly::AsyncTimeout> progressTimeout_;
+};
+
+std::chrono::nanoseconds threadCpuTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+/**
+ * Benchmark completion latency and EventBase thread CPU usage of a progress
+ * policy while requests wait serviceTime for the remote side.
+ *   range(0): 0 - busy polling (maxBackoff 0), 1 - default adaptive policy
+ *   range(1): service time in microseconds
+ */
+static void BM_RdmaTransport_ProgressPolicy(benchmark::State& state) {
+  RdmaProgressPolicy policy;
+  if (state.range(0) == 0) {
+    policy.maxBackoff = std::chrono::microseconds(0);
+  }
+  const auto serviceTime = std::chrono::microseconds(state.range(1));
+
+  folly::ScopedEventBaseThread evbThread;
+  auto evb = evbThread.getEventBase();
+  auto loop = std::make_unique<MockProgressLoop>(evb, policy);
+
+  std::chrono::nanoseconds cpuStart, cpuEnd;
+  evb->runInEventBaseThreadAndWait([&]() { cpuStart = threadCpuTime(); });
+  const auto wallStart = MockProgressLoop::Clock::now();
+
+  MockProgressLoop::Clock::duration totalLatency{0};
+  for (auto _ : state) {
+    totalLatency += loop->issue(serviceTime).get();
+  }
+
+  evb->runInEventBaseThreadAndWait([&]() { cpuEnd = threadCpuTime(); });
+  const auto wall = MockProgressLoop::Clock::now() - wallStart;
+  loop.reset();
+
+  state.counters["latencyUs"] =
+      std::chrono::duration<double, std::micro>(totalLatency).count() /
+      state.iterations();
+  state.counters["evbCpu"] =
+      std::chrono::duration<double>(cpuEnd - cpuStart).count() /
+      std::chrono::duration<double>(wall).count();
+}
+
 //------------------------------------------------------------------------------
 // Benchmarks
 //------------------------------------------------------------------------------
@@ -144,6 +366,25 @@ BENCHMARK(BM_RdmaTransport_Write)
     ->UseRealTime()
     ->Unit(benchmark::kMicrosecond);
 
+// KV-cache style transfers: many small pages per request
+BENCHMARK(BM_RdmaTransport_WritePages)
+    ->ArgsProduct({{4 * 1024, 64 * 1024}, {16, 256, 2048}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RdmaTransport_Writev)
+    ->ArgsProduct({{4 * 1024, 64 * 1024}, {16, 256, 2048}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RdmaTransport_Readv)
+    ->ArgsProduct({{4 * 1024, 64 * 1024}, {16, 256, 2048}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_RdmaTransport_ProgressPolicy)
+    ->ArgsProduct({{0, 1}, {10, 100, 1000, 10000}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
 // Custom main function to handle initialization
 int main(int argc, char** argv) {
   // Check if we have multiple CUDA devices for transport benchmarks
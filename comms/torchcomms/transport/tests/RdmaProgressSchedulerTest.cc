@@ -0,0 +1,99 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include "comms/torchcomms/transport/RdmaProgressScheduler.h"
+
+using namespace torch::comms;
+using std::chrono::microseconds;
+
+namespace {
+
+RdmaProgressPolicy makePolicy(
+    uint32_t spinSlices,
+    microseconds minBackoff,
+    microseconds maxBackoff) {
+  RdmaProgressPolicy policy;
+  policy.spinSlices = spinSlices;
+  policy.minBackoff = minBackoff;
+  policy.maxBackoff = maxBackoff;
+  return policy;
+}
+
+} // namespace
+
+TEST(RdmaProgressSchedulerTest, SpinWhileCompleting) {
+  RdmaProgressScheduler scheduler(
+      makePolicy(2, microseconds(1), microseconds(100)));
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(scheduler.next(1), microseconds(0));
+  }
+}
+
+TEST(RdmaProgressSchedulerTest, ExponentialBackoffWhenIdle) {
+  RdmaProgressScheduler scheduler(
+      makePolicy(2, microseconds(1), microseconds(16)));
+
+  // Idle slices within the spin budget still poll immediately
+  EXPECT_EQ(scheduler.next(0), microseconds(0));
+  EXPECT_EQ(scheduler.next(0), microseconds(0));
+
+  EXPECT_EQ(scheduler.next(0), microseconds(1));
+  EXPECT_EQ(scheduler.next(0), microseconds(2));
+  EXPECT_EQ(scheduler.next(0), microseconds(4));
+  EXPECT_EQ(scheduler.next(0), microseconds(8));
+  EXPECT_EQ(scheduler.next(0), microseconds(16));
+  // Capped
+  EXPECT_EQ(scheduler.next(0), microseconds(16));
+}
+
+TEST(RdmaProgressSchedulerTest, CompletionResetsBackoff) {
+  RdmaProgressScheduler scheduler(
+      makePolicy(0, microseconds(4), microseconds(64)));
+  EXPECT_EQ(scheduler.next(0), microseconds(4));
+  EXPECT_EQ(scheduler.next(0), microseconds(8));
+
+  EXPECT_EQ(scheduler.next(3), microseconds(0));
+  EXPECT_EQ(scheduler.next(0), microseconds(4));
+}
+
+TEST(RdmaProgressSchedulerTest, TruncatedSlicesWithoutCompletionsBackOff) {
+  // More works pending than maxWorksPerSlice, none of them completing: every
+  // slice is truncated and reports zero completions, and the loop must back
+  // off instead of busy polling
+  RdmaProgressScheduler scheduler(
+      makePolicy(2, microseconds(4), microseconds(64)));
+  EXPECT_EQ(scheduler.next(0), microseconds(0));
+  EXPECT_EQ(scheduler.next(0), microseconds(0));
+  EXPECT_EQ(scheduler.next(0), microseconds(4));
+  for (int slice = 0; slice < 10; slice++) {
+    EXPECT_GT(scheduler.next(0), microseconds(0));
+  }
+}
+
+TEST(RdmaProgressSchedulerTest, ResetOnNewWork) {
+  RdmaProgressScheduler scheduler(
+      makePolicy(1, microseconds(4), microseconds(64)));
+  for (int i = 0; i < 10; i++) {
+    scheduler.next(0);
+  }
+  scheduler.reset();
+  EXPECT_EQ(scheduler.next(0), microseconds(0));
+  EXPECT_EQ(scheduler.next(0), microseconds(4));
+}
+
+TEST(RdmaProgressSchedulerTest, ZeroMaxBackoffBusyPolls) {
+  RdmaProgressScheduler scheduler(
+      makePolicy(0, microseconds(1), microseconds(0)));
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(scheduler.next(0), microseconds(0));
+  }
+}
+
+TEST(RdmaProgressSchedulerTest, MaxWorksPerSliceAtLeastOne) {
+  RdmaProgressPolicy policy;
+  policy.maxWorksPerSlice = 0;
+  EXPECT_EQ(RdmaProgressScheduler(policy).maxWorksPerSlice(), 1);
+  policy.maxWorksPerSlice = 32;
+  EXPECT_EQ(RdmaProgressScheduler(policy).maxWorksPerSlice(), 32);
+}
@@ -0,0 +1,119 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates.
+
+#include <gtest/gtest.h>
+
+#include "comms/torchcomms/transport/RdmaRequestBatch.h"
+
+// Completion tracking of vectored RdmaTransport operations. Requests are
+// completed by hand as the CtranIb progress loop would, so no NIC is needed.
+
+using namespace torch::comms;
+
+TEST(RdmaRequestBatchTest, EmptyBatchIsComplete) {
+  RdmaRequestBatch batch(0);
+  EXPECT_EQ(batch.size(), 0);
+  EXPECT_TRUE(batch.complete());
+}
+
+TEST(RdmaRequestBatchTest, SingleCompletionForBatch) {
+  constexpr size_t kNumReqs = 1024;
+  RdmaRequestBatch batch(kNumReqs);
+  EXPECT_EQ(batch.size(), kNumReqs);
+
+  for (size_t i = 0; i < kNumReqs; i++) {
+    EXPECT_FALSE(batch.complete());
+    EXPECT_EQ(batch.at(i)->complete(), commSuccess);
+  }
+  EXPECT_TRUE(batch.complete());
+}
+
+TEST(RdmaRequestBatchTest, OutOfOrderCompletion) {
+  RdmaRequestBatch batch(4);
+  EXPECT_EQ(batch.at(3)->complete(), commSuccess);
+  EXPECT_EQ(batch.at(1)->complete(), commSuccess);
+  EXPECT_FALSE(batch.complete());
+  EXPECT_EQ(batch.at(0)->complete(), commSuccess);
+  EXPECT_FALSE(batch.complete());
+  EXPECT_EQ(batch.at(2)->complete(), commSuccess);
+  EXPECT_TRUE(batch.complete());
+}
+
+TEST(RdmaRequestBatchTest, MultiReferenceRequest) {
+  // A put chunked over several QPs completes once every QP completed
+  RdmaRequestBatch batch(2);
+  batch.at(0)->setRefCount(3);
+  EXPECT_EQ(batch.at(1)->complete(), commSuccess);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_FALSE(batch.complete());
+    EXPECT_EQ(batch.at(0)->complete(), commSuccess);
+  }
+  EXPECT_TRUE(batch.complete());
+}
+
+TEST(RdmaRequestBatchTest, RequestAddressesAreStable) {
+  RdmaRequestBatch batch(16);
+  std::vector<CtranIbRequest*> addrs;
+  for (size_t i = 0; i < batch.size(); i++) {
+    addrs.push_back(batch.at(i));
+  }
+  batch.complete();
+  for (size_t i = 0; i < batch.size(); i++) {
+    EXPECT_EQ(batch.at(i), addrs[i]);
+  }
+  EXPECT_THROW(batch.at(batch.size()), std::out_of_range);
+}
+
+TEST(RdmaRequestBatchTest, PostAll) {
+  RdmaRequestBatch batch(4);
+  std::vector<CtranIbRequest*> posted;
+  EXPECT_EQ(
+      batch.post([&](size_t idx, CtranIbRequest* req) {
+        EXPECT_EQ(req, batch.at(idx));
+        posted.push_back(req);
+        return commSuccess;
+      }),
+      commSuccess);
+  EXPECT_EQ(posted.size(), 4);
+  EXPECT_EQ(batch.size(), 4);
+}
+
+TEST(RdmaRequestBatchTest, PostFailureInTheMiddle) {
+  constexpr size_t kFailIdx = 3;
+  RdmaRequestBatch batch(8);
+  std::vector<CtranIbRequest*> posted;
+  EXPECT_EQ(
+      batch.post([&](size_t idx, CtranIbRequest* req) {
+        if (idx == kFailIdx) {
+          return commSystemError;
+        }
+        posted.push_back(req);
+        return commSuccess;
+      }),
+      commSystemError);
+
+  // Nothing was posted after the failure, and the batch only tracks the
+  // requests in flight, at their original addresses
+  EXPECT_EQ(posted.size(), kFailIdx);
+  EXPECT_EQ(batch.size(), kFailIdx);
+  for (size_t i = 0; i < kFailIdx; i++) {
+    EXPECT_EQ(batch.at(i), posted[i]);
+  }
+  EXPECT_THROW(batch.at(kFailIdx), std::out_of_range);
+
+  // The batch completes once the posted requests did, as CtranIb completes
+  // them after the failure
+  for (auto req : posted) {
+    EXPECT_FALSE(batch.complete());
+    EXPECT_EQ(req->complete(), commSuccess);
+  }
+  EXPECT_TRUE(batch.complete());
+}
+
+TEST(RdmaRequestBatchTest, PostFailureFirst) {
+  RdmaRequestBatch batch(2);
+  EXPECT_EQ(
+      batch.post([](size_t, CtranIbRequest*) { return commInternalError; }),
+      commInternalError);
+  EXPECT_EQ(batch.size(), 0);
+  EXPECT_TRUE(batch.complete());
+}
@@ -50,6 +50,8 @@ class RdmaTransportTest : public ::testing::Test {
     folly::Promise<RdmaRemoteBuffer> memoryInfoPromise;
     folly::SemiFuture<RdmaRemoteBuffer> memoryInfoFuture;
     folly::Promise<bool> communicationResult;
+    folly::SemiFuture<bool> peerDoneFuture{
+        folly::SemiFuture<bool>::makeEmpty()};
   };
 
   // Common thread function that handles both server and client logic
@@ -146,6 +148,96 @@ class RdmaTransportTest : public ::testing::Test {
     EXPECT_EQ(cudaFree(buffer), cudaSuccess);
   }
 
+  // Server scatters pages into the client buffer with one writev and reads
+  // them back with readv; client waits for the single batch notification.
+  void runBatchedTransferThread(
+      bool isServer,
+      ThreadSyncObjects& syncObjects) {
+    constexpr size_t kPageSize = 4096;
+    constexpr size_t kNumPages = 16;
+    constexpr size_t kRegionSize = kPageSize * kNumPages;
+    const int cudaDev = isServer ? 0 : 1;
+    EXPECT_EQ(cudaSetDevice(cudaDev), cudaSuccess);
+
+    auto transport = std::make_unique<torch::comms::RdmaTransport>(
+        cudaDev, evbThread_->getEventBase());
+    syncObjects.myUrlPromise.setValue(transport->bind());
+    std::string peerUrl = std::move(syncObjects.peerUrlFuture).get();
+    EXPECT_EQ(transport->connect(peerUrl), commSuccess);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // Server: [source pages | read back pages], client: [scattered pages]
+    const size_t bufferSize = isServer ? 2 * kRegionSize : kRegionSize;
+    void* buffer = nullptr;
+    EXPECT_EQ(cudaMalloc(&buffer, bufferSize), cudaSuccess);
+    EXPECT_EQ(cudaMemset(buffer, 0, bufferSize), cudaSuccess);
+    torch::comms::RdmaMemory rdmaMemory(buffer, bufferSize, cudaDev);
+
+    // Page i is written to the client's page (kNumPages - 1 - i)
+    auto remotePage = [&](const RdmaRemoteBuffer& remote, size_t i) {
+      return RdmaRemoteBuffer{
+          .ptr = static_cast<uint8_t*>(remote.ptr) +
+              (kNumPages - 1 - i) * kPageSize,
+          .accessKey = remote.accessKey};
+    };
+
+    if (isServer) {
+      std::vector<uint8_t> pages(kRegionSize);
+      for (size_t i = 0; i < kNumPages; i++) {
+        std::fill_n(pages.begin() + i * kPageSize, kPageSize, i + 1);
+      }
+      EXPECT_EQ(
+          cudaMemcpy(buffer, pages.data(), kRegionSize, cudaMemcpyHostToDevice),
+          cudaSuccess);
+
+      auto clientMemInfo = std::move(syncObjects.memoryInfoFuture).get();
+      std::vector<RdmaMemory::View> srcViews, dstViews;
+      std::vector<RdmaRemoteBuffer> remotes;
+      for (size_t i = 0; i < kNumPages; i++) {
+        srcViews.push_back(rdmaMemory.createView(i * kPageSize, kPageSize));
+        dstViews.push_back(
+            rdmaMemory.createView(kRegionSize + i * kPageSize, kPageSize));
+        remotes.push_back(remotePage(clientMemInfo, i));
+      }
+      EXPECT_EQ(
+          commSuccess,
+          transport->writev(srcViews, remotes, true /* notify */).get());
+      EXPECT_EQ(commSuccess, transport->readv(dstViews, remotes).get());
+      EXPECT_EQ(
+          commSuccess, transport->read(dstViews[0], remotes[0]).get());
+
+      std::vector<uint8_t> readBack(kRegionSize);
+      EXPECT_EQ(
+          cudaMemcpy(
+              readBack.data(),
+              static_cast<uint8_t*>(buffer) + kRegionSize,
+              kRegionSize,
+              cudaMemcpyDeviceToHost),
+          cudaSuccess);
+      EXPECT_EQ(readBack, pages);
+      syncObjects.communicationResult.setValue(true);
+    } else {
+      syncObjects.memoryInfoPromise.setValue(
+          RdmaRemoteBuffer{.ptr = buffer, .accessKey = rdmaMemory.remoteKey()});
+
+      // One notification for the whole batch
+      EXPECT_EQ(commSuccess, transport->waitForWrite().get());
+      std::vector<uint8_t> received(kRegionSize);
+      EXPECT_EQ(
+          cudaMemcpy(
+              received.data(), buffer, kRegionSize, cudaMemcpyDeviceToHost),
+          cudaSuccess);
+      for (size_t i = 0; i < kNumPages; i++) {
+        EXPECT_EQ(received[(kNumPages - 1 - i) * kPageSize], i + 1)
+            << "page " << i;
+      }
+      // Keep the buffer registered until the server has read it back
+      std::move(syncObjects.peerDoneFuture).get();
+    }
+
+    EXPECT_EQ(cudaFree(buffer), cudaSuccess);
+  }
+
  private:
   std::unique_ptr<folly::ScopedEventBaseThread> evbThread_;
 };
@@ -361,3 +453,33 @@ TEST_F(RdmaTransportTest, ServerClientDataTransfer) {
   bool success = std::move(communicationFuture).get();
   EXPECT_TRUE(success);
 }
+
+TEST_F(RdmaTransportTest, BatchedWriteAndRead) {
+  auto [urlPromise0, urlFuture0] = folly::makePromiseContract<std::string>();
+  auto [urlPromise1, urlFuture1] = folly::makePromiseContract<std::string>();
+  auto [memoryInfoPromise, memoryInfoFuture] =
+      folly::makePromiseContract<RdmaRemoteBuffer>();
+  auto [communicationResult, communicationFuture] =
+      folly::makePromiseContract<bool>();
+
+  ThreadSyncObjects serverSyncObjects{
+      std::move(urlPromise0),
+      std::move(urlFuture1),
+      folly::Promise<RdmaRemoteBuffer>(),
+      std::move(memoryInfoFuture),
+      std::move(communicationResult)};
+  ThreadSyncObjects clientSyncObjects{
+      std::move(urlPromise1),
+      std::move(urlFuture0),
+      std::move(memoryInfoPromise),
+      folly::SemiFuture<RdmaRemoteBuffer>::makeEmpty(),
+      folly::Promise<bool>(),
+      std::move(communicationFuture)};
+
+  std::thread serverThread(
+      [&]() { runBatchedTransferThread(true, serverSyncObjects); });
+  std::thread clientThread(
+      [&]() { runBatchedTransferThread(false, clientSyncObjects); });
+  serverThread.join();
+  clientThread.join();
+}
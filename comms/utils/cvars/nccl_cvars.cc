@@ -586,6 +586,10 @@ int NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE;
 int NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE_DEFAULT;
 uint64_t NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE;
 uint64_t NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE_DEFAULT;
+bool NCCL_CTRAN_PRECONNECT_WARMUP;
+bool NCCL_CTRAN_PRECONNECT_WARMUP_DEFAULT;
+int NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT;
+int NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT_DEFAULT;
 enum NCCL_CTRAN_PROFILING NCCL_CTRAN_PROFILING;
 enum NCCL_CTRAN_PROFILING NCCL_CTRAN_PROFILING_DEFAULT;
 int NCCL_CTRAN_PROFILING_REPORT_COUNT;
@@ -618,6 +622,14 @@ bool NCCL_CTRAN_REGISTRATION_SIZE_CHECK;
 bool NCCL_CTRAN_REGISTRATION_SIZE_CHECK_DEFAULT;
 int NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE;
 int NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE_DEFAULT;
+bool NCCL_CTRAN_SHARED_LISTENER;
+bool NCCL_CTRAN_SHARED_LISTENER_DEFAULT;
+int32_t NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT;
+int32_t NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT_DEFAULT;
+bool NCCL_CTRAN_SHARED_TMPBUF_ARENA;
+bool NCCL_CTRAN_SHARED_TMPBUF_ARENA_DEFAULT;
+uint64_t NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE;
+uint64_t NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE_DEFAULT;
 int32_t NCCL_CTRAN_SOCKET_POLL_TIMEOUT;
 int32_t NCCL_CTRAN_SOCKET_POLL_TIMEOUT_DEFAULT;
 std::string NCCL_CTRAN_TRACE_LOGGER_LOCAL_DIR;
@@ -658,6 +670,8 @@ std::string NCCL_DEBUG_TIMESTAMP_LEVELS;
 std::string NCCL_DEBUG_TIMESTAMP_LEVELS_DEFAULT;
 int64_t NCCL_DMABUF_ENABLE;
 int64_t NCCL_DMABUF_ENABLE_DEFAULT;
+int64_t NCCL_ENQUEUE_ALGO_CACHE_SIZE;
+int64_t NCCL_ENQUEUE_ALGO_CACHE_SIZE_DEFAULT;
 int NCCL_ENV_CTA_POLICY;
 int NCCL_ENV_CTA_POLICY_DEFAULT;
 enum NCCL_FASTINIT_MODE NCCL_FASTINIT_MODE;
@@ -694,6 +708,8 @@ int64_t NCCL_GRAPH_MIXING_SUPPORT;
 int64_t NCCL_GRAPH_MIXING_SUPPORT_DEFAULT;
 int64_t NCCL_GRAPH_REGISTER;
 int64_t NCCL_GRAPH_REGISTER_DEFAULT;
+int64_t NCCL_GROUP_ASYNC_JOB_POOL_SIZE;
+int64_t NCCL_GROUP_ASYNC_JOB_POOL_SIZE_DEFAULT;
 int64_t NCCL_GROUP_CUDA_STREAM;
 int64_t NCCL_GROUP_CUDA_STREAM_DEFAULT;
 std::string NCCL_HOSTID;
@@ -944,6 +960,12 @@ std::string NCCL_PROXY_CPUSET;
 std::string NCCL_PROXY_CPUSET_DEFAULT;
 int64_t NCCL_PROXY_DUMP_SIGNAL;
 int64_t NCCL_PROXY_DUMP_SIGNAL_DEFAULT;
+int64_t NCCL_PROXY_OPS_POOL_SPIN_COUNT;
+int64_t NCCL_PROXY_OPS_POOL_SPIN_COUNT_DEFAULT;
+int64_t NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS;
+int64_t NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS_DEFAULT;
+int64_t NCCL_PROXY_SERVICE_SPIN_COUNT;
+int64_t NCCL_PROXY_SERVICE_SPIN_COUNT_DEFAULT;
 bool NCCL_PXN_C2C;
 bool NCCL_PXN_C2C_DEFAULT;
 int64_t NCCL_PXN_DISABLE;
@@ -1020,6 +1042,8 @@ int NCCL_SOCKET_RCVBUF;
 int NCCL_SOCKET_RCVBUF_DEFAULT;
 int64_t NCCL_SOCKET_RETRY_CNT;
 int64_t NCCL_SOCKET_RETRY_CNT_DEFAULT;
+int64_t NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC;
+int64_t NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC_DEFAULT;
 int64_t NCCL_SOCKET_RETRY_SLEEP_MSEC;
 int64_t NCCL_SOCKET_RETRY_SLEEP_MSEC_DEFAULT;
 int NCCL_SOCKET_SNDBUF;
@@ -1052,6 +1076,12 @@ std::string NCCL_TOPO_FILE;
 std::string NCCL_TOPO_FILE_DEFAULT;
 std::string NCCL_TOPO_FILE_PATH;
 std::string NCCL_TOPO_FILE_PATH_DEFAULT;
+bool NCCL_TOPO_PATH_CACHE;
+bool NCCL_TOPO_PATH_CACHE_DEFAULT;
+bool NCCL_TOPO_PLAN_CACHE;
+bool NCCL_TOPO_PLAN_CACHE_DEFAULT;
+bool NCCL_TOPO_XML_COMPACT_EXCHANGE;
+bool NCCL_TOPO_XML_COMPACT_EXCHANGE_DEFAULT;
 int64_t NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT;
 int64_t NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT_DEFAULT;
 uint64_t NCCL_TRANSPORT_RECONNECT_OPCOUNT_LIMIT;
@@ -1170,6 +1200,7 @@ std::unordered_map<std::string, int64_t*> env_int64_values = {
     {"NCCL_CUMEM_ENABLE", &NCCL_CUMEM_ENABLE},
     {"NCCL_CUMEM_HOST_ENABLE", &NCCL_CUMEM_HOST_ENABLE},
     {"NCCL_DMABUF_ENABLE", &NCCL_DMABUF_ENABLE},
+    {"NCCL_ENQUEUE_ALGO_CACHE_SIZE", &NCCL_ENQUEUE_ALGO_CACHE_SIZE},
     {"NCCL_GDRCOPY_ENABLE", &NCCL_GDRCOPY_ENABLE},
     {"NCCL_GDRCOPY_FIFO_ENABLE", &NCCL_GDRCOPY_FIFO_ENABLE},
     {"NCCL_GDRCOPY_FLUSH_ENABLE", &NCCL_GDRCOPY_FLUSH_ENABLE},
@@ -1180,6 +1211,7 @@ std::unordered_map<std::string, int64_t*> env_int64_values = {
     {"NCCL_GRAPH_HELPER_DISABLE", &NCCL_GRAPH_HELPER_DISABLE},
     {"NCCL_GRAPH_MIXING_SUPPORT", &NCCL_GRAPH_MIXING_SUPPORT},
     {"NCCL_GRAPH_REGISTER", &NCCL_GRAPH_REGISTER},
+    {"NCCL_GROUP_ASYNC_JOB_POOL_SIZE", &NCCL_GROUP_ASYNC_JOB_POOL_SIZE},
     {"NCCL_GROUP_CUDA_STREAM", &NCCL_GROUP_CUDA_STREAM},
     {"NCCL_IB_ADAPTIVE_ROUTING", &NCCL_IB_ADAPTIVE_ROUTING},
     {"NCCL_IB_AR_THRESHOLD", &NCCL_IB_AR_THRESHOLD},
@@ -1249,6 +1281,10 @@ std::unordered_map<std::string, int64_t*> env_int64_values = {
     {"NCCL_PROGRESS_APPENDOP_FREQ", &NCCL_PROGRESS_APPENDOP_FREQ},
     {"NCCL_PROXY_APPEND_BATCH_SIZE", &NCCL_PROXY_APPEND_BATCH_SIZE},
     {"NCCL_PROXY_DUMP_SIGNAL", &NCCL_PROXY_DUMP_SIGNAL},
+    {"NCCL_PROXY_OPS_POOL_SPIN_COUNT", &NCCL_PROXY_OPS_POOL_SPIN_COUNT},
+    {"NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS",
+     &NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS},
+    {"NCCL_PROXY_SERVICE_SPIN_COUNT", &NCCL_PROXY_SERVICE_SPIN_COUNT},
     {"NCCL_PXN_DISABLE", &NCCL_PXN_DISABLE},
     {"NCCL_RAS_ENABLE", &NCCL_RAS_ENABLE},
     {"NCCL_RAS_TIMEOUT_FACTOR", &NCCL_RAS_TIMEOUT_FACTOR},
@@ -1263,6 +1299,7 @@ std::unordered_map<std::string, int64_t*> env_int64_values = {
     {"NCCL_SINGLE_PROC_MEM_REG_ENABLE", &NCCL_SINGLE_PROC_MEM_REG_ENABLE},
     {"NCCL_SOCKET_NTHREADS", &NCCL_SOCKET_NTHREADS},
     {"NCCL_SOCKET_RETRY_CNT", &NCCL_SOCKET_RETRY_CNT},
+    {"NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC", &NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC},
     {"NCCL_SOCKET_RETRY_SLEEP_MSEC", &NCCL_SOCKET_RETRY_SLEEP_MSEC},
     {"NCCL_TOPO_DUMP_FILE_RANK", &NCCL_TOPO_DUMP_FILE_RANK},
     {"NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT",
@@ -1378,6 +1415,8 @@ std::unordered_map<std::string, int*> env_int_values = {
      &NCCL_CTRAN_NVL_SENDRECV_MAX_NUM_THREAD_BLOCKS},
     {"NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE",
      &NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE},
+    {"NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT",
+     &NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT},
     {"NCCL_CTRAN_PROFILING_REPORT_COUNT", &NCCL_CTRAN_PROFILING_REPORT_COUNT},
     {"NCCL_CTRAN_QP_PROFILING_SAMPLING_WEIGHT",
      &NCCL_CTRAN_QP_PROFILING_SAMPLING_WEIGHT},
@@ -1472,10 +1511,13 @@ std::unordered_map<std::string, bool*> env_bool_values = {
     {"NCCL_CTRAN_NVL_FABRIC_ENABLE", &NCCL_CTRAN_NVL_FABRIC_ENABLE},
     {"NCCL_CTRAN_NVL_SENDRECV_COPY_ENGINE_ENABLE",
      &NCCL_CTRAN_NVL_SENDRECV_COPY_ENGINE_ENABLE},
+    {"NCCL_CTRAN_PRECONNECT_WARMUP", &NCCL_CTRAN_PRECONNECT_WARMUP},
     {"NCCL_CTRAN_QP_PROFILING_ENABLE", &NCCL_CTRAN_QP_PROFILING_ENABLE},
     {"NCCL_CTRAN_REGISTER_ERROR_ON_DYNAMIC",
      &NCCL_CTRAN_REGISTER_ERROR_ON_DYNAMIC},
     {"NCCL_CTRAN_REGISTRATION_SIZE_CHECK", &NCCL_CTRAN_REGISTRATION_SIZE_CHECK},
+    {"NCCL_CTRAN_SHARED_LISTENER", &NCCL_CTRAN_SHARED_LISTENER},
+    {"NCCL_CTRAN_SHARED_TMPBUF_ARENA", &NCCL_CTRAN_SHARED_TMPBUF_ARENA},
     {"NCCL_CTRAN_TRANSPORT_PROFILER", &NCCL_CTRAN_TRANSPORT_PROFILER},
     {"NCCL_CVARS_LOG_INFO", &NCCL_CVARS_LOG_INFO},
     {"NCCL_DEBUG_LOGGING_ASYNC", &NCCL_DEBUG_LOGGING_ASYNC},
@@ -1507,6 +1549,9 @@ std::unordered_map<std::string, bool*> env_bool_values = {
      &NCCL_SCUBA_STACK_TRACE_ON_ERROR_ENABLED},
     {"NCCL_SKIP_TCPFORM_RING", &NCCL_SKIP_TCPFORM_RING},
     {"NCCL_SLOW_RANK_ENABLE", &NCCL_SLOW_RANK_ENABLE},
+    {"NCCL_TOPO_PATH_CACHE", &NCCL_TOPO_PATH_CACHE},
+    {"NCCL_TOPO_PLAN_CACHE", &NCCL_TOPO_PLAN_CACHE},
+    {"NCCL_TOPO_XML_COMPACT_EXCHANGE", &NCCL_TOPO_XML_COMPACT_EXCHANGE},
     {"NCCL_USE_MEM_CACHE", &NCCL_USE_MEM_CACHE},
     {"NCCL_USE_SHARED_BUFFER_POOL", &NCCL_USE_SHARED_BUFFER_POOL},
     {"NCCL_USE_TRANSPORT_EXT", &NCCL_USE_TRANSPORT_EXT},
@@ -1662,6 +1707,8 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_CTRAN_NVL_SENDRECV_MAX_NUM_THREAD_BLOCKS");
   env.insert("NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE");
   env.insert("NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE");
+  env.insert("NCCL_CTRAN_PRECONNECT_WARMUP");
+  env.insert("NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT");
   env.insert("NCCL_CTRAN_PROFILING");
   env.insert("NCCL_CTRAN_PROFILING_REPORT_COUNT");
   env.insert("NCCL_CTRAN_QP_PROFILING_ENABLE");
@@ -1678,6 +1725,10 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_CTRAN_REGISTER_REPORT_SNAPSHOT_COUNT");
   env.insert("NCCL_CTRAN_REGISTRATION_SIZE_CHECK");
   env.insert("NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE");
+  env.insert("NCCL_CTRAN_SHARED_LISTENER");
+  env.insert("NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT");
+  env.insert("NCCL_CTRAN_SHARED_TMPBUF_ARENA");
+  env.insert("NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE");
   env.insert("NCCL_CTRAN_SOCKET_POLL_TIMEOUT");
   env.insert("NCCL_CTRAN_TRACE_LOGGER_LOCAL_DIR");
   env.insert("NCCL_CTRAN_TRANSPORT_PROFILER");
@@ -1698,6 +1749,7 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_DEBUG_TIMESTAMP_FORMAT");
   env.insert("NCCL_DEBUG_TIMESTAMP_LEVELS");
   env.insert("NCCL_DMABUF_ENABLE");
+  env.insert("NCCL_ENQUEUE_ALGO_CACHE_SIZE");
   env.insert("NCCL_ENV_CTA_POLICY");
   env.insert("NCCL_FASTINIT_MODE");
   env.insert("NCCL_FILTER_ALGO_LOGGING_BY_RANKS");
@@ -1716,6 +1768,7 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_GRAPH_HELPER_DISABLE");
   env.insert("NCCL_GRAPH_MIXING_SUPPORT");
   env.insert("NCCL_GRAPH_REGISTER");
+  env.insert("NCCL_GROUP_ASYNC_JOB_POOL_SIZE");
   env.insert("NCCL_GROUP_CUDA_STREAM");
   env.insert("NCCL_HOSTID");
   env.insert("NCCL_HPC_JOB_IDS");
@@ -1840,6 +1893,9 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_PROXY_APPEND_BATCH_SIZE");
   env.insert("NCCL_PROXY_CPUSET");
   env.insert("NCCL_PROXY_DUMP_SIGNAL");
+  env.insert("NCCL_PROXY_OPS_POOL_SPIN_COUNT");
+  env.insert("NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS");
+  env.insert("NCCL_PROXY_SERVICE_SPIN_COUNT");
   env.insert("NCCL_PXN_C2C");
   env.insert("NCCL_PXN_DISABLE");
   env.insert("NCCL_RAS_ADDR");
@@ -1878,6 +1934,7 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_SOCKET_NTHREADS");
   env.insert("NCCL_SOCKET_RCVBUF");
   env.insert("NCCL_SOCKET_RETRY_CNT");
+  env.insert("NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC");
   env.insert("NCCL_SOCKET_RETRY_SLEEP_MSEC");
   env.insert("NCCL_SOCKET_SNDBUF");
   env.insert("NCCL_SOCKET_TOS_CONFIG");
@@ -1894,6 +1951,9 @@ static void initEnvSet(std::unordered_set<std::string>& env) {
   env.insert("NCCL_TOPO_DUMP_FILE_RANK");
   env.insert("NCCL_TOPO_FILE");
   env.insert("NCCL_TOPO_FILE_PATH");
+  env.insert("NCCL_TOPO_PATH_CACHE");
+  env.insert("NCCL_TOPO_PLAN_CACHE");
+  env.insert("NCCL_TOPO_XML_COMPACT_EXCHANGE");
   env.insert("NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT");
   env.insert("NCCL_TRANSPORT_RECONNECT_OPCOUNT_LIMIT");
   env.insert("NCCL_TUNER_PLUGIN");
@@ -3528,6 +3588,27 @@ static void readCvarEnv() {
         "NCCL Config - CVAR {} has an override",
         "NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE");
   }
+  NCCL_CTRAN_PRECONNECT_WARMUP =
+      env2bool("NCCL_CTRAN_PRECONNECT_WARMUP", "False");
+  NCCL_CTRAN_PRECONNECT_WARMUP_DEFAULT =
+      env2bool("NCCL_ENV_DO_NOT_SET", "False");
+
+  if (NCCL_CTRAN_PRECONNECT_WARMUP_DEFAULT != NCCL_CTRAN_PRECONNECT_WARMUP) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_CTRAN_PRECONNECT_WARMUP");
+  }
+  NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT =
+      env2num<int>("NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT", "8");
+  NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT_DEFAULT =
+      env2num<int>("NCCL_ENV_DO_NOT_SET", "8");
+
+  if (NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT_DEFAULT !=
+      NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT");
+  }
   if (getenv("NCCL_CTRAN_PROFILING") == nullptr) {
     NCCL_CTRAN_PROFILING = NCCL_CTRAN_PROFILING::none;
   } else {
@@ -3723,6 +3804,46 @@ static void readCvarEnv() {
         "NCCL Config - CVAR {} has an override",
         "NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE");
   }
+  NCCL_CTRAN_SHARED_LISTENER = env2bool("NCCL_CTRAN_SHARED_LISTENER", "True");
+  NCCL_CTRAN_SHARED_LISTENER_DEFAULT = env2bool("NCCL_ENV_DO_NOT_SET", "True");
+
+  if (NCCL_CTRAN_SHARED_LISTENER_DEFAULT != NCCL_CTRAN_SHARED_LISTENER) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override", "NCCL_CTRAN_SHARED_LISTENER");
+  }
+  NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT =
+      env2num<int32_t>("NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT", "5000");
+  NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT_DEFAULT =
+      env2num<int32_t>("NCCL_ENV_DO_NOT_SET", "5000");
+
+  if (NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT_DEFAULT !=
+      NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT");
+  }
+  NCCL_CTRAN_SHARED_TMPBUF_ARENA =
+      env2bool("NCCL_CTRAN_SHARED_TMPBUF_ARENA", "True");
+  NCCL_CTRAN_SHARED_TMPBUF_ARENA_DEFAULT =
+      env2bool("NCCL_ENV_DO_NOT_SET", "True");
+
+  if (NCCL_CTRAN_SHARED_TMPBUF_ARENA_DEFAULT !=
+      NCCL_CTRAN_SHARED_TMPBUF_ARENA) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_CTRAN_SHARED_TMPBUF_ARENA");
+  }
+  NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE = env2num<uint64_t>(
+      "NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE", "8388608");
+  NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE_DEFAULT =
+      env2num<uint64_t>("NCCL_ENV_DO_NOT_SET", "8388608");
+
+  if (NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE_DEFAULT !=
+      NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE");
+  }
   NCCL_CTRAN_SOCKET_POLL_TIMEOUT =
       env2num<int32_t>("NCCL_CTRAN_SOCKET_POLL_TIMEOUT", "20");
   NCCL_CTRAN_SOCKET_POLL_TIMEOUT_DEFAULT =
@@ -3891,6 +4012,16 @@ static void readCvarEnv() {
   if (NCCL_DMABUF_ENABLE_DEFAULT != NCCL_DMABUF_ENABLE) {
     CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_DMABUF_ENABLE");
   }
+  NCCL_ENQUEUE_ALGO_CACHE_SIZE =
+      env2num<int64_t>("NCCL_ENQUEUE_ALGO_CACHE_SIZE", "1024");
+  NCCL_ENQUEUE_ALGO_CACHE_SIZE_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "1024");
+
+  if (NCCL_ENQUEUE_ALGO_CACHE_SIZE_DEFAULT != NCCL_ENQUEUE_ALGO_CACHE_SIZE) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_ENQUEUE_ALGO_CACHE_SIZE");
+  }
   NCCL_ENV_CTA_POLICY = env2num<int>("NCCL_ENV_CTA_POLICY", "MIN");
   NCCL_ENV_CTA_POLICY_DEFAULT = env2num<int>("NCCL_ENV_DO_NOT_SET", "MIN");
 
@@ -4049,6 +4180,17 @@ static void readCvarEnv() {
   if (NCCL_GRAPH_REGISTER_DEFAULT != NCCL_GRAPH_REGISTER) {
     CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_GRAPH_REGISTER");
   }
+  NCCL_GROUP_ASYNC_JOB_POOL_SIZE =
+      env2num<int64_t>("NCCL_GROUP_ASYNC_JOB_POOL_SIZE", "16");
+  NCCL_GROUP_ASYNC_JOB_POOL_SIZE_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "16");
+
+  if (NCCL_GROUP_ASYNC_JOB_POOL_SIZE_DEFAULT !=
+      NCCL_GROUP_ASYNC_JOB_POOL_SIZE) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_GROUP_ASYNC_JOB_POOL_SIZE");
+  }
   NCCL_GROUP_CUDA_STREAM = env2num<int64_t>("NCCL_GROUP_CUDA_STREAM", "0");
   NCCL_GROUP_CUDA_STREAM_DEFAULT = env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "0");
 
@@ -4974,6 +5116,38 @@ static void readCvarEnv() {
     CVAR_INFO(
         "NCCL Config - CVAR {} has an override", "NCCL_PROXY_DUMP_SIGNAL");
   }
+  NCCL_PROXY_OPS_POOL_SPIN_COUNT =
+      env2num<int64_t>("NCCL_PROXY_OPS_POOL_SPIN_COUNT", "1024");
+  NCCL_PROXY_OPS_POOL_SPIN_COUNT_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "1024");
+
+  if (NCCL_PROXY_OPS_POOL_SPIN_COUNT_DEFAULT !=
+      NCCL_PROXY_OPS_POOL_SPIN_COUNT) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_PROXY_OPS_POOL_SPIN_COUNT");
+  }
+  NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS =
+      env2num<int64_t>("NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS", "1");
+  NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "1");
+
+  if (NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS_DEFAULT !=
+      NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS");
+  }
+  NCCL_PROXY_SERVICE_SPIN_COUNT =
+      env2num<int64_t>("NCCL_PROXY_SERVICE_SPIN_COUNT", "1024");
+  NCCL_PROXY_SERVICE_SPIN_COUNT_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "1024");
+
+  if (NCCL_PROXY_SERVICE_SPIN_COUNT_DEFAULT != NCCL_PROXY_SERVICE_SPIN_COUNT) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_PROXY_SERVICE_SPIN_COUNT");
+  }
   NCCL_PXN_C2C = env2bool("NCCL_PXN_C2C", "False");
   NCCL_PXN_C2C_DEFAULT = env2bool("NCCL_ENV_DO_NOT_SET", "False");
 
@@ -5293,6 +5467,17 @@ static void readCvarEnv() {
   if (NCCL_SOCKET_RETRY_CNT_DEFAULT != NCCL_SOCKET_RETRY_CNT) {
     CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_SOCKET_RETRY_CNT");
   }
+  NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC =
+      env2num<int64_t>("NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC", "2000");
+  NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC_DEFAULT =
+      env2num<int64_t>("NCCL_ENV_DO_NOT_SET", "2000");
+
+  if (NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC_DEFAULT !=
+      NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC");
+  }
   NCCL_SOCKET_RETRY_SLEEP_MSEC =
       env2num<int64_t>("NCCL_SOCKET_RETRY_SLEEP_MSEC", "100");
   NCCL_SOCKET_RETRY_SLEEP_MSEC_DEFAULT =
@@ -5424,6 +5609,29 @@ static void readCvarEnv() {
   if (NCCL_TOPO_FILE_PATH_DEFAULT != NCCL_TOPO_FILE_PATH) {
     CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_TOPO_FILE_PATH");
   }
+  NCCL_TOPO_PATH_CACHE = env2bool("NCCL_TOPO_PATH_CACHE", "True");
+  NCCL_TOPO_PATH_CACHE_DEFAULT = env2bool("NCCL_ENV_DO_NOT_SET", "True");
+
+  if (NCCL_TOPO_PATH_CACHE_DEFAULT != NCCL_TOPO_PATH_CACHE) {
+    CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_TOPO_PATH_CACHE");
+  }
+  NCCL_TOPO_PLAN_CACHE = env2bool("NCCL_TOPO_PLAN_CACHE", "True");
+  NCCL_TOPO_PLAN_CACHE_DEFAULT = env2bool("NCCL_ENV_DO_NOT_SET", "True");
+
+  if (NCCL_TOPO_PLAN_CACHE_DEFAULT != NCCL_TOPO_PLAN_CACHE) {
+    CVAR_INFO("NCCL Config - CVAR {} has an override", "NCCL_TOPO_PLAN_CACHE");
+  }
+  NCCL_TOPO_XML_COMPACT_EXCHANGE =
+      env2bool("NCCL_TOPO_XML_COMPACT_EXCHANGE", "True");
+  NCCL_TOPO_XML_COMPACT_EXCHANGE_DEFAULT =
+      env2bool("NCCL_ENV_DO_NOT_SET", "True");
+
+  if (NCCL_TOPO_XML_COMPACT_EXCHANGE_DEFAULT !=
+      NCCL_TOPO_XML_COMPACT_EXCHANGE) {
+    CVAR_INFO(
+        "NCCL Config - CVAR {} has an override",
+        "NCCL_TOPO_XML_COMPACT_EXCHANGE");
+  }
   NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT =
       env2num<int64_t>("NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT", "0");
   NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT_DEFAULT =
@@ -520,6 +520,12 @@ extern int NCCL_CTRAN_NVL_SENDRECV_THREAD_BLOCK_SIZE_DEFAULT;
 extern uint64_t NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE;
 extern uint64_t NCCL_CTRAN_P2P_NVL_SHARED_DEVBUF_SIZE_DEFAULT;
 
+extern bool NCCL_CTRAN_PRECONNECT_WARMUP;
+extern bool NCCL_CTRAN_PRECONNECT_WARMUP_DEFAULT;
+
+extern int NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT;
+extern int NCCL_CTRAN_PRECONNECT_WARMUP_INFLIGHT_DEFAULT;
+
 enum class NCCL_CTRAN_PROFILING {
   none,
   stdout,
@@ -580,6 +586,18 @@ extern bool NCCL_CTRAN_REGISTRATION_SIZE_CHECK_DEFAULT;
 extern int NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE;
 extern int NCCL_CTRAN_SENDRECV_CHECKSUM_SAMPLE_RATE_DEFAULT;
 
+extern bool NCCL_CTRAN_SHARED_LISTENER;
+extern bool NCCL_CTRAN_SHARED_LISTENER_DEFAULT;
+
+extern int32_t NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT;
+extern int32_t NCCL_CTRAN_SHARED_LISTENER_PREAMBLE_TIMEOUT_DEFAULT;
+
+extern bool NCCL_CTRAN_SHARED_TMPBUF_ARENA;
+extern bool NCCL_CTRAN_SHARED_TMPBUF_ARENA_DEFAULT;
+
+extern uint64_t NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE;
+extern uint64_t NCCL_CTRAN_SHARED_TMPBUF_ARENA_CHUNK_SIZE_DEFAULT;
+
 extern int32_t NCCL_CTRAN_SOCKET_POLL_TIMEOUT;
 extern int32_t NCCL_CTRAN_SOCKET_POLL_TIMEOUT_DEFAULT;
 
@@ -640,6 +658,9 @@ extern std::string NCCL_DEBUG_TIMESTAMP_LEVELS_DEFAULT;
 extern int64_t NCCL_DMABUF_ENABLE;
 extern int64_t NCCL_DMABUF_ENABLE_DEFAULT;
 
+extern int64_t NCCL_ENQUEUE_ALGO_CACHE_SIZE;
+extern int64_t NCCL_ENQUEUE_ALGO_CACHE_SIZE_DEFAULT;
+
 extern int NCCL_ENV_CTA_POLICY;
 extern int NCCL_ENV_CTA_POLICY_DEFAULT;
 
@@ -698,6 +719,9 @@ extern int64_t NCCL_GRAPH_MIXING_SUPPORT_DEFAULT;
 extern int64_t NCCL_GRAPH_REGISTER;
 extern int64_t NCCL_GRAPH_REGISTER_DEFAULT;
 
+extern int64_t NCCL_GROUP_ASYNC_JOB_POOL_SIZE;
+extern int64_t NCCL_GROUP_ASYNC_JOB_POOL_SIZE_DEFAULT;
+
 extern int64_t NCCL_GROUP_CUDA_STREAM;
 extern int64_t NCCL_GROUP_CUDA_STREAM_DEFAULT;
 
@@ -1080,6 +1104,15 @@ extern std::string NCCL_PROXY_CPUSET_DEFAULT;
 extern int64_t NCCL_PROXY_DUMP_SIGNAL;
 extern int64_t NCCL_PROXY_DUMP_SIGNAL_DEFAULT;
 
+extern int64_t NCCL_PROXY_OPS_POOL_SPIN_COUNT;
+extern int64_t NCCL_PROXY_OPS_POOL_SPIN_COUNT_DEFAULT;
+
+extern int64_t NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS;
+extern int64_t NCCL_PROXY_SERVICE_ASYNC_TIMEOUT_MS_DEFAULT;
+
+extern int64_t NCCL_PROXY_SERVICE_SPIN_COUNT;
+extern int64_t NCCL_PROXY_SERVICE_SPIN_COUNT_DEFAULT;
+
 extern bool NCCL_PXN_C2C;
 extern bool NCCL_PXN_C2C_DEFAULT;
 
@@ -1205,6 +1238,9 @@ extern int NCCL_SOCKET_RCVBUF_DEFAULT;
 extern int64_t NCCL_SOCKET_RETRY_CNT;
 extern int64_t NCCL_SOCKET_RETRY_CNT_DEFAULT;
 
+extern int64_t NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC;
+extern int64_t NCCL_SOCKET_RETRY_MAX_SLEEP_MSEC_DEFAULT;
+
 extern int64_t NCCL_SOCKET_RETRY_SLEEP_MSEC;
 extern int64_t NCCL_SOCKET_RETRY_SLEEP_MSEC_DEFAULT;
 
@@ -1253,6 +1289,13 @@ extern std::string NCCL_TOPO_FILE_DEFAULT;
 extern std::string NCCL_TOPO_FILE_PATH;
 extern std::string NCCL_TOPO_FILE_PATH_DEFAULT;
 
+extern bool NCCL_TOPO_PATH_CACHE;
+extern bool NCCL_TOPO_PATH_CACHE_DEFAULT;
+extern bool NCCL_TOPO_PLAN_CACHE;
+extern bool NCCL_TOPO_PLAN_CACHE_DEFAULT;
+extern bool NCCL_TOPO_XML_COMPACT_EXCHANGE;
+extern bool NCCL_TOPO_XML_COMPACT_EXCHANGE_DEFAULT;
+
 extern int64_t NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT;
 extern int64_t NCCL_TRANSPORT_PREP_TRAINER_ITERATION_LIMIT_DEFAULT;
 